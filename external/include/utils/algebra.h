@@ -40,6 +40,41 @@ construct an appropriate projection matrix for a particular graphics API.
 #define GRAPHICS_API_D3D		0
 #define GRAPHICS_API_METAL		0
 
+ksMatrix4x4f_Multiply, ksMatrix4x4f_Invert, ksMatrix4x4f_InvertHomogeneous,
+ksMatrix4x4f_TransformVector3f, ksMatrix4x4f_TransformVector4f and
+ksMatrix4x4f_TransformBounds use SSE on x86 and NEON on ARM, unless
+ALGEBRA_SIMD_DISABLED is defined. The vector code performs the same operations
+in the same order as the scalar code and gives bit-identical results, except
+for ksMatrix4x4f_Invert on SSE, which uses a block-wise inverse that is only
+equal to the scalar inverse within floating-point epsilon. The NEON build uses
+the scalar ksMatrix4x4f_Invert.
+
+ksMatrix4x4f_InvertAffine and ksMatrix4x4f_InvertRigid are cheaper than
+ksMatrix4x4f_Invert but only work for matrices with a bottom row of
+( 0, 0, 0, 1 ). ksMatrix4x4f_InvertRigid additionally requires that the matrix
+has no scale other than a uniform scale, as is the case for a hierarchy of
+translation, rotation and uniform scale transforms. Both use SSE on x86.
+ksMatrix4x4f_InvertRigid also uses NEON on ARM. The results are only equal to
+the scalar results within floating-point epsilon.
+
+ksBounds3fArray stores many axis-aligned bounds as a structure of arrays, with
+one array per component. ksMatrix4x4f_TransformBoundsArray and
+ksMatrix4x4f_CullBoundsArray process such arrays 4 bounds at a time with SSE
+or NEON, and 8 bounds at a time when the code is compiled with AVX enabled.
+ksMatrix4x4f_CullBoundsArray outputs one visibility bit per bounds. When
+multiple view-projection matrices are passed, for instance one per eye, the
+bounds are only culled if they are culled by every view.
+
+ksQuatf_Lerp is a normalized linear interpolation that does not rotate at a
+constant speed. ksQuatf_Slerp rotates at a constant speed, and
+ksQuatf_FastSlerp approximates ksQuatf_Slerp to within 0.001 radians at about
+twice the cost of a normalized linear interpolation. ksTransformArray stores
+many translation, rotation and scale transforms as a structure of arrays.
+ksTransformArray_Blend interpolates such arrays with ksQuatf_FastSlerp for the
+rotations, and ksMatrix4x4f_CreateTranslationRotationScaleArray creates a
+matrix for each transform. Both process 4 transforms at a time with SSE. On
+NEON, only ksMatrix4x4f_CreateTranslationRotationScaleArray is vectorized.
+
 
 INTERFACE
 =========
@@ -60,6 +95,8 @@ ksMatrix3x4f
 ksMatrix4x2f
 ksMatrix4x3f
 ksMatrix4x4f
+ksBounds3fArray
+ksTransformArray
 
 static void ksVector3f_Set( ksVector3f * v, const float value );
 static void ksVector3f_Add( ksVector3f * result, const ksVector3f * a, const ksVector3f * b );
@@ -72,6 +109,8 @@ static void ksVector3f_Normalize( ksVector3f * v );
 static float ksVector3f_Length( const ksVector3f * v );
 
 static void ksQuatf_Lerp( ksQuatf * result, const ksQuatf * a, const ksQuatf * b, const float fraction );
+static void ksQuatf_Slerp( ksQuatf * result, const ksQuatf * a, const ksQuatf * b, const float fraction );
+static void ksQuatf_FastSlerp( ksQuatf * result, const ksQuatf * a, const ksQuatf * b, const float fraction );
 
 static void ksMatrix3x3f_CreateTransposeFromMatrix4x4f( ksMatrix3x3f * result, const ksMatrix4x4f * src );
 static void ksMatrix3x4f_CreateFromMatrix4x4f( ksMatrix3x4f * result, const ksMatrix4x4f * src );
@@ -101,6 +140,8 @@ static void ksMatrix4x4f_Multiply( ksMatrix4x4f * result, const ksMatrix4x4f * a
 static void ksMatrix4x4f_Transpose( ksMatrix4x4f * result, const ksMatrix4x4f * src );
 static void ksMatrix4x4f_Invert( ksMatrix4x4f * result, const ksMatrix4x4f * src );
 static void ksMatrix4x4f_InvertHomogeneous( ksMatrix4x4f * result, const ksMatrix4x4f * src );
+static void ksMatrix4x4f_InvertAffine( ksMatrix4x4f * result, const ksMatrix4x4f * src );
+static void ksMatrix4x4f_InvertRigid( ksMatrix4x4f * result, const ksMatrix4x4f * src );
 
 static void ksMatrix4x4f_TransformVector3f( ksVector3f * result, const ksMatrix4x4f * m, const ksVector3f * v );
 static void ksMatrix4x4f_TransformVector4f( ksVector4f * result, const ksMatrix4x4f * m, const ksVector4f * v );
@@ -108,20 +149,45 @@ static void ksMatrix4x4f_TransformVector4f( ksVector4f * result, const ksMatrix4
 static void ksMatrix4x4f_TransformBounds( ksVector3f * resultMins, ksVector3f * resultMaxs, const ksMatrix4x4f * matrix, const ksVector3f * mins, const ksVector3f * maxs );
 static bool ksMatrix4x4f_CullBounds( const ksMatrix4x4f * mvp, const ksVector3f * mins, const ksVector3f * maxs );
 
+static void ksBounds3fArray_GetBounds( ksVector3f * resultMins, ksVector3f * resultMaxs, const ksBounds3fArray * bounds, const int count );
+static void ksMatrix4x4f_TransformBoundsArray( ksBounds3fArray * result, const ksMatrix4x4f * matrices, const ksBounds3fArray * bounds, const int count );
+static void ksMatrix4x4f_CullBoundsArray( uint32_t * visibleBits, const ksMatrix4x4f * mvps, const int mvpCount, const ksBounds3fArray * bounds, const int first, const int count );
+
+static void ksTransformArray_Blend( ksTransformArray * result, const ksTransformArray * a, const ksTransformArray * b, const float * fractions, const int count );
+static void ksMatrix4x4f_CreateTranslationRotationScaleArray( ksMatrix4x4f * result, const ksTransformArray * transforms, const int count );
+
 ================================================================================================
 */
 
 #if !defined( KSALGEBRA_H )
 #define KSALGEBRA_H
 
+#include <float.h>
 #include <math.h>
 #include <stdbool.h>
+#include <stdint.h>
+
+#if !defined( ALGEBRA_SIMD_DISABLED )
+	#if defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 )
+		#include <xmmintrin.h>
+		#define ALGEBRA_SIMD_SSE
+		#if defined( __AVX__ )
+			#include <immintrin.h>
+			#define ALGEBRA_SIMD_AVX
+		#endif
+	#elif defined( __ARM_NEON ) || defined( __ARM_NEON__ ) || defined( _M_ARM64 )
+		#include <arm_neon.h>
+		#define ALGEBRA_SIMD_NEON
+	#endif
+#endif
 
 #define MATH_PI				3.14159265358979323846f
 
 #define DEFAULT_NEAR_Z		0.015625f		// exact floating point representation
 #define INFINITE_FAR_Z		0.0f
 
+#define ALGEBRA_CULL_MAX_VIEWS	2
+
 // 2D integer vector
 typedef struct
 {
@@ -233,6 +299,21 @@ typedef struct
 	float m[4][4];
 } ksMatrix4x4f;
 
+// Axis-aligned bounds stored as a structure of arrays with one array per component.
+typedef struct
+{
+	float *	mins[3];
+	float *	maxs[3];
+} ksBounds3fArray;
+
+// Translation, rotation and scale transforms stored as a structure of arrays with one array per component.
+typedef struct
+{
+	float *	translation[3];
+	float *	rotation[4];
+	float *	scale[3];
+} ksTransformArray;
+
 static const ksVector4f colorRed		= { 1.0f, 0.0f, 0.0f, 1.0f };
 static const ksVector4f colorGreen		= { 0.0f, 1.0f, 0.0f, 1.0f };
 static const ksVector4f colorBlue		= { 0.0f, 0.0f, 1.0f, 1.0f };
@@ -327,6 +408,52 @@ static void ksQuatf_Lerp( ksQuatf * result, const ksQuatf * a, const ksQuatf * b
 	result->w = w * lengthRcp;
 }
 
+// Spherical linear interpolation along the shortest arc at a constant angular velocity.
+static void ksQuatf_Slerp( ksQuatf * result, const ksQuatf * a, const ksQuatf * b, const float fraction )
+{
+	const float s = a->x * b->x + a->y * b->y + a->z * b->z + a->w * b->w;
+	const float cosAngle = fabsf( s );
+	float fa = 1.0f - fraction;
+	float fb = fraction;
+	// Fall back to a normalized lerp for small angles where the sine ratios are poorly conditioned.
+	if ( cosAngle < 0.9995f )
+	{
+		const float angle = acosf( cosAngle );
+		const float rcpSinAngle = 1.0f / sinf( angle );
+		fa = sinf( fa * angle ) * rcpSinAngle;
+		fb = sinf( fb * angle ) * rcpSinAngle;
+	}
+	fb = ( s < 0.0f ) ? -fb : fb;
+	const float x = a->x * fa + b->x * fb;
+	const float y = a->y * fa + b->y * fb;
+	const float z = a->z * fa + b->z * fb;
+	const float w = a->w * fa + b->w * fb;
+	const float lengthRcp = RcpSqrt( x * x + y * y + z * z + w * w );
+	result->x = x * lengthRcp;
+	result->y = y * lengthRcp;
+	result->z = z * lengthRcp;
+	result->w = w * lengthRcp;
+}
+
+// Adjusts the fraction of a normalized lerp such that the result approximates a slerp.
+//		"Approximating slerp"
+//		Arseny Kapoulkine, 2015
+static float ksQuatf_FastSlerpFraction( const float cosAngle, const float fraction )
+{
+	const float A = 1.0904f + cosAngle * ( -3.2452f + cosAngle * ( 3.55645f - cosAngle * 1.43519f ) );
+	const float B = 0.848013f + cosAngle * ( -1.06021f + cosAngle * 0.215638f );
+	const float centered = fraction - 0.5f;
+	const float k = A * centered * centered + B;
+	return fraction + fraction * centered * ( fraction - 1.0f ) * k;
+}
+
+// Approximates ksQuatf_Slerp at the cost of ksQuatf_Lerp.
+static void ksQuatf_FastSlerp( ksQuatf * result, const ksQuatf * a, const ksQuatf * b, const float fraction )
+{
+	const float s = a->x * b->x + a->y * b->y + a->z * b->z + a->w * b->w;
+	ksQuatf_Lerp( result, a, b, ksQuatf_FastSlerpFraction( fabsf( s ), fraction ) );
+}
+
 static void ksMatrix3x3f_CreateTransposeFromMatrix4x4f( ksMatrix3x3f * result, const ksMatrix4x4f * src )
 {
 	result->m[0][0] = src->m[0][0];
@@ -361,6 +488,30 @@ static void ksMatrix3x4f_CreateFromMatrix4x4f( ksMatrix3x4f * result, const ksMa
 // Use left-multiplication to accumulate transformations.
 static void ksMatrix4x4f_Multiply( ksMatrix4x4f * result, const ksMatrix4x4f * a, const ksMatrix4x4f * b )
 {
+#if defined( ALGEBRA_SIMD_SSE )
+	const __m128 a0 = _mm_loadu_ps( a->m[0] );
+	const __m128 a1 = _mm_loadu_ps( a->m[1] );
+	const __m128 a2 = _mm_loadu_ps( a->m[2] );
+	const __m128 a3 = _mm_loadu_ps( a->m[3] );
+	for ( int i = 0; i < 4; i++ )
+	{
+		const __m128 r01 = _mm_add_ps( _mm_mul_ps( a0, _mm_set1_ps( b->m[i][0] ) ), _mm_mul_ps( a1, _mm_set1_ps( b->m[i][1] ) ) );
+		const __m128 r012 = _mm_add_ps( r01, _mm_mul_ps( a2, _mm_set1_ps( b->m[i][2] ) ) );
+		_mm_storeu_ps( result->m[i], _mm_add_ps( r012, _mm_mul_ps( a3, _mm_set1_ps( b->m[i][3] ) ) ) );
+	}
+#elif defined( ALGEBRA_SIMD_NEON )
+	const float32x4_t a0 = vld1q_f32( a->m[0] );
+	const float32x4_t a1 = vld1q_f32( a->m[1] );
+	const float32x4_t a2 = vld1q_f32( a->m[2] );
+	const float32x4_t a3 = vld1q_f32( a->m[3] );
+	for ( int i = 0; i < 4; i++ )
+	{
+		// Separate multiplies and adds instead of fused multiply-adds to match the scalar code.
+		const float32x4_t r01 = vaddq_f32( vmulq_n_f32( a0, b->m[i][0] ), vmulq_n_f32( a1, b->m[i][1] ) );
+		const float32x4_t r012 = vaddq_f32( r01, vmulq_n_f32( a2, b->m[i][2] ) );
+		vst1q_f32( result->m[i], vaddq_f32( r012, vmulq_n_f32( a3, b->m[i][3] ) ) );
+	}
+#else
 	result->m[0][0] = a->m[0][0] * b->m[0][0] + a->m[1][0] * b->m[0][1] + a->m[2][0] * b->m[0][2] + a->m[3][0] * b->m[0][3];
 	result->m[0][1] = a->m[0][1] * b->m[0][0] + a->m[1][1] * b->m[0][1] + a->m[2][1] * b->m[0][2] + a->m[3][1] * b->m[0][3];
 	result->m[0][2] = a->m[0][2] * b->m[0][0] + a->m[1][2] * b->m[0][1] + a->m[2][2] * b->m[0][2] + a->m[3][2] * b->m[0][3];
@@ -380,6 +531,7 @@ static void ksMatrix4x4f_Multiply( ksMatrix4x4f * result, const ksMatrix4x4f * a
 	result->m[3][1] = a->m[0][1] * b->m[3][0] + a->m[1][1] * b->m[3][1] + a->m[2][1] * b->m[3][2] + a->m[3][1] * b->m[3][3];
 	result->m[3][2] = a->m[0][2] * b->m[3][0] + a->m[1][2] * b->m[3][1] + a->m[2][2] * b->m[3][2] + a->m[3][2] * b->m[3][3];
 	result->m[3][3] = a->m[0][3] * b->m[3][0] + a->m[1][3] * b->m[3][1] + a->m[2][3] * b->m[3][2] + a->m[3][3] * b->m[3][3];
+#endif
 }
 
 // Creates the transpose of the given matrix.
@@ -414,9 +566,85 @@ static float ksMatrix4x4f_Minor( const ksMatrix4x4f * matrix, int r0, int r1, in
 			matrix->m[r0][c2] * ( matrix->m[r1][c0] * matrix->m[r2][c1] - matrix->m[r2][c0] * matrix->m[r1][c1] );
 }
  
+#if defined( ALGEBRA_SIMD_SSE )
+
+#define ALGEBRA_SHUFFLE( a, b, x, y, z, w )		_mm_shuffle_ps( a, b, _MM_SHUFFLE( w, z, y, x ) )
+#define ALGEBRA_SWIZZLE( a, x, y, z, w )		_mm_shuffle_ps( a, a, _MM_SHUFFLE( w, z, y, x ) )
+
+// Multiplies two 2x2 matrices that are each stored in a single vector: a * b
+static __m128 ksMatrix2x2f_MultiplySSE( const __m128 a, const __m128 b )
+{
+	return _mm_add_ps( _mm_mul_ps( a, ALGEBRA_SWIZZLE( b, 0, 3, 0, 3 ) ), _mm_mul_ps( ALGEBRA_SWIZZLE( a, 1, 0, 3, 2 ), ALGEBRA_SWIZZLE( b, 2, 1, 2, 1 ) ) );
+}
+
+// Multiplies the adjugate of 2x2 matrix 'a' with 2x2 matrix 'b': adj( a ) * b
+static __m128 ksMatrix2x2f_AdjugateMultiplySSE( const __m128 a, const __m128 b )
+{
+	return _mm_sub_ps( _mm_mul_ps( ALGEBRA_SWIZZLE( a, 3, 3, 0, 0 ), b ), _mm_mul_ps( ALGEBRA_SWIZZLE( a, 1, 1, 2, 2 ), ALGEBRA_SWIZZLE( b, 2, 3, 0, 1 ) ) );
+}
+
+// Multiplies 2x2 matrix 'a' with the adjugate of 2x2 matrix 'b': a * adj( b )
+static __m128 ksMatrix2x2f_MultiplyAdjugateSSE( const __m128 a, const __m128 b )
+{
+	return _mm_sub_ps( _mm_mul_ps( a, ALGEBRA_SWIZZLE( b, 3, 0, 3, 0 ) ), _mm_mul_ps( ALGEBRA_SWIZZLE( a, 1, 0, 3, 2 ), ALGEBRA_SWIZZLE( b, 2, 1, 2, 1 ) ) );
+}
+
+#endif
+
 // Calculates the inverse of a 4x4 matrix.
 static void ksMatrix4x4f_Invert( ksMatrix4x4f * result, const ksMatrix4x4f * src )
 {
+#if defined( ALGEBRA_SIMD_SSE )
+	// The matrix is split into four 2x2 blocks that are inverted with the block-wise inversion formula:
+	//
+	//   | A B |-1           | adj(X) adj(Y) |
+	//   | C D |   = 1/det * | adj(Z) adj(W) |
+	//
+	// with X = |D| A - B adj(D) C, W = |A| D - C adj(A) B, Y = |B| C - D adj(adj(A) B), Z = |C| B - A adj(adj(D) C)
+	// and det = |A| |D| + |B| |C| - trace( adj(A) B adj(D) C ). The columns are treated as rows, which inverts
+	// the transpose and results in the transpose of the inverse, which is the inverse in column-major layout.
+	const __m128 c0 = _mm_loadu_ps( src->m[0] );
+	const __m128 c1 = _mm_loadu_ps( src->m[1] );
+	const __m128 c2 = _mm_loadu_ps( src->m[2] );
+	const __m128 c3 = _mm_loadu_ps( src->m[3] );
+
+	const __m128 A = _mm_movelh_ps( c0, c1 );
+	const __m128 B = _mm_movehl_ps( c1, c0 );
+	const __m128 C = _mm_movelh_ps( c2, c3 );
+	const __m128 D = _mm_movehl_ps( c3, c2 );
+
+	// ( |A|, |B|, |C|, |D| )
+	const __m128 detSub = _mm_sub_ps(	_mm_mul_ps( ALGEBRA_SHUFFLE( c0, c2, 0, 2, 0, 2 ), ALGEBRA_SHUFFLE( c1, c3, 1, 3, 1, 3 ) ),
+										_mm_mul_ps( ALGEBRA_SHUFFLE( c0, c2, 1, 3, 1, 3 ), ALGEBRA_SHUFFLE( c1, c3, 0, 2, 0, 2 ) ) );
+	const __m128 detA = ALGEBRA_SWIZZLE( detSub, 0, 0, 0, 0 );
+	const __m128 detB = ALGEBRA_SWIZZLE( detSub, 1, 1, 1, 1 );
+	const __m128 detC = ALGEBRA_SWIZZLE( detSub, 2, 2, 2, 2 );
+	const __m128 detD = ALGEBRA_SWIZZLE( detSub, 3, 3, 3, 3 );
+
+	const __m128 adjDC = ksMatrix2x2f_AdjugateMultiplySSE( D, C );
+	const __m128 adjAB = ksMatrix2x2f_AdjugateMultiplySSE( A, B );
+	__m128 X = _mm_sub_ps( _mm_mul_ps( detD, A ), ksMatrix2x2f_MultiplySSE( B, adjDC ) );
+	__m128 W = _mm_sub_ps( _mm_mul_ps( detA, D ), ksMatrix2x2f_MultiplySSE( C, adjAB ) );
+	__m128 Y = _mm_sub_ps( _mm_mul_ps( detB, C ), ksMatrix2x2f_MultiplyAdjugateSSE( D, adjAB ) );
+	__m128 Z = _mm_sub_ps( _mm_mul_ps( detC, B ), ksMatrix2x2f_MultiplyAdjugateSSE( A, adjDC ) );
+
+	__m128 trace = _mm_mul_ps( adjAB, ALGEBRA_SWIZZLE( adjDC, 0, 2, 1, 3 ) );
+	trace = _mm_add_ps( trace, ALGEBRA_SWIZZLE( trace, 2, 3, 0, 1 ) );
+	trace = _mm_add_ps( trace, ALGEBRA_SWIZZLE( trace, 1, 0, 3, 2 ) );
+	const __m128 det = _mm_sub_ps( _mm_add_ps( _mm_mul_ps( detA, detD ), _mm_mul_ps( detB, detC ) ), trace );
+
+	// The signs of the adjugates are folded into the reciprocal determinant.
+	const __m128 rcpDet = _mm_div_ps( _mm_setr_ps( 1.0f, -1.0f, -1.0f, 1.0f ), det );
+	X = _mm_mul_ps( X, rcpDet );
+	Y = _mm_mul_ps( Y, rcpDet );
+	Z = _mm_mul_ps( Z, rcpDet );
+	W = _mm_mul_ps( W, rcpDet );
+
+	_mm_storeu_ps( result->m[0], ALGEBRA_SHUFFLE( X, Y, 3, 1, 3, 1 ) );
+	_mm_storeu_ps( result->m[1], ALGEBRA_SHUFFLE( X, Y, 2, 0, 2, 0 ) );
+	_mm_storeu_ps( result->m[2], ALGEBRA_SHUFFLE( Z, W, 3, 1, 3, 1 ) );
+	_mm_storeu_ps( result->m[3], ALGEBRA_SHUFFLE( Z, W, 2, 0, 2, 0 ) );
+#else
 	const float rcpDet = 1.0f / (	src->m[0][0] * ksMatrix4x4f_Minor( src, 1, 2, 3, 1, 2, 3 ) -
 									src->m[0][1] * ksMatrix4x4f_Minor( src, 1, 2, 3, 0, 2, 3 ) +
 									src->m[0][2] * ksMatrix4x4f_Minor( src, 1, 2, 3, 0, 1, 3 ) -
@@ -438,11 +666,40 @@ static void ksMatrix4x4f_Invert( ksMatrix4x4f * result, const ksMatrix4x4f * src
 	result->m[3][1] =  ksMatrix4x4f_Minor( src, 0, 2, 3, 0, 1, 2 ) * rcpDet;
 	result->m[3][2] = -ksMatrix4x4f_Minor( src, 0, 1, 3, 0, 1, 2 ) * rcpDet;
 	result->m[3][3] =  ksMatrix4x4f_Minor( src, 0, 1, 2, 0, 1, 2 ) * rcpDet;
+#endif
 }
 
 // Calculates the inverse of a 4x4 homogeneous matrix.
 static void ksMatrix4x4f_InvertHomogeneous( ksMatrix4x4f * result, const ksMatrix4x4f * src )
 {
+#if defined( ALGEBRA_SIMD_SSE )
+	// Transposing the rotation with a zero fourth column also clears the fourth row of the result.
+	__m128 r0 = _mm_loadu_ps( src->m[0] );
+	__m128 r1 = _mm_loadu_ps( src->m[1] );
+	__m128 r2 = _mm_loadu_ps( src->m[2] );
+	__m128 r3 = _mm_setzero_ps();
+	_MM_TRANSPOSE4_PS( r0, r1, r2, r3 );
+	const __m128 t01 = _mm_add_ps( _mm_mul_ps( r0, _mm_set1_ps( src->m[3][0] ) ), _mm_mul_ps( r1, _mm_set1_ps( src->m[3][1] ) ) );
+	const __m128 t = _mm_add_ps( t01, _mm_mul_ps( r2, _mm_set1_ps( src->m[3][2] ) ) );
+	_mm_storeu_ps( result->m[0], r0 );
+	_mm_storeu_ps( result->m[1], r1 );
+	_mm_storeu_ps( result->m[2], r2 );
+	_mm_storeu_ps( result->m[3], _mm_sub_ps( _mm_setzero_ps(), t ) );
+	result->m[3][3] = 1.0f;
+#elif defined( ALGEBRA_SIMD_NEON )
+	// Transposing the rotation with a zero fourth column also clears the fourth row of the result.
+	const float32x4x2_t t01 = vtrnq_f32( vld1q_f32( src->m[0] ), vld1q_f32( src->m[1] ) );
+	const float32x4x2_t t23 = vtrnq_f32( vld1q_f32( src->m[2] ), vdupq_n_f32( 0.0f ) );
+	const float32x4_t r0 = vcombine_f32( vget_low_f32( t01.val[0] ), vget_low_f32( t23.val[0] ) );
+	const float32x4_t r1 = vcombine_f32( vget_low_f32( t01.val[1] ), vget_low_f32( t23.val[1] ) );
+	const float32x4_t r2 = vcombine_f32( vget_high_f32( t01.val[0] ), vget_high_f32( t23.val[0] ) );
+	const float32x4_t t = vaddq_f32( vaddq_f32( vmulq_n_f32( r0, src->m[3][0] ), vmulq_n_f32( r1, src->m[3][1] ) ), vmulq_n_f32( r2, src->m[3][2] ) );
+	vst1q_f32( result->m[0], r0 );
+	vst1q_f32( result->m[1], r1 );
+	vst1q_f32( result->m[2], r2 );
+	vst1q_f32( result->m[3], vnegq_f32( t ) );
+	result->m[3][3] = 1.0f;
+#else
 	result->m[0][0] = src->m[0][0];
 	result->m[0][1] = src->m[1][0];
 	result->m[0][2] = src->m[2][0];
@@ -459,6 +716,7 @@ static void ksMatrix4x4f_InvertHomogeneous( ksMatrix4x4f * result, const ksMatri
 	result->m[3][1] = -( src->m[1][0] * src->m[3][0] + src->m[1][1] * src->m[3][1] + src->m[1][2] * src->m[3][2] );
 	result->m[3][2] = -( src->m[2][0] * src->m[3][0] + src->m[2][1] * src->m[3][1] + src->m[2][2] * src->m[3][2] );
 	result->m[3][3] = 1.0f;
+#endif
 }
 
 // Creates an identity matrix.
@@ -564,20 +822,43 @@ static void ksMatrix4x4f_CreateFromQuaternion( ksMatrix4x4f * result, const ksQu
 }
 
 // Creates a combined translation(rotation(scale(object))) matrix.
+// This is the same as translation * rotation * scale but without the matrix multiplications.
 static void ksMatrix4x4f_CreateTranslationRotationScale( ksMatrix4x4f * result, const ksVector3f * translation, const ksQuatf * rotation, const ksVector3f * scale )
 {
-	ksMatrix4x4f scaleMatrix;
-	ksMatrix4x4f_CreateScale( &scaleMatrix, scale->x, scale->y, scale->z );
+	const float x2 = rotation->x + rotation->x;
+	const float y2 = rotation->y + rotation->y;
+	const float z2 = rotation->z + rotation->z;
+
+	const float xx2 = rotation->x * x2;
+	const float yy2 = rotation->y * y2;
+	const float zz2 = rotation->z * z2;
+
+	const float yz2 = rotation->y * z2;
+	const float wx2 = rotation->w * x2;
+	const float xy2 = rotation->x * y2;
+	const float wz2 = rotation->w * z2;
+	const float xz2 = rotation->x * z2;
+	const float wy2 = rotation->w * y2;
+
+	result->m[0][0] = ( 1.0f - yy2 - zz2 ) * scale->x;
+	result->m[0][1] = ( xy2 + wz2 ) * scale->x;
+	result->m[0][2] = ( xz2 - wy2 ) * scale->x;
+	result->m[0][3] = 0.0f;
 
-	ksMatrix4x4f rotationMatrix;
-	ksMatrix4x4f_CreateFromQuaternion( &rotationMatrix, rotation );
+	result->m[1][0] = ( xy2 - wz2 ) * scale->y;
+	result->m[1][1] = ( 1.0f - xx2 - zz2 ) * scale->y;
+	result->m[1][2] = ( yz2 + wx2 ) * scale->y;
+	result->m[1][3] = 0.0f;
 
-	ksMatrix4x4f translationMatrix;
-	ksMatrix4x4f_CreateTranslation( &translationMatrix, translation->x, translation->y, translation->z );
+	result->m[2][0] = ( xz2 + wy2 ) * scale->z;
+	result->m[2][1] = ( yz2 - wx2 ) * scale->z;
+	result->m[2][2] = ( 1.0f - xx2 - yy2 ) * scale->z;
+	result->m[2][3] = 0.0f;
 
-	ksMatrix4x4f combinedMatrix;
-	ksMatrix4x4f_Multiply( &combinedMatrix, &rotationMatrix, &scaleMatrix );
-	ksMatrix4x4f_Multiply( result, &translationMatrix, &combinedMatrix );
+	result->m[3][0] = translation->x;
+	result->m[3][1] = translation->y;
+	result->m[3][2] = translation->z;
+	result->m[3][3] = 1.0f;
 }
 
 // Creates a projection matrix based on the specified dimensions.
@@ -831,23 +1112,207 @@ static void ksMatrix4x4f_GetScale( ksVector3f * result, const ksMatrix4x4f * src
 	result->z = sqrtf( src->m[2][0] * src->m[2][0] + src->m[2][1] * src->m[2][1] + src->m[2][2] * src->m[2][2] );
 }
 
+// Calculates the inverse of an affine matrix, which is a matrix with a bottom row of ( 0, 0, 0, 1 ).
+static void ksMatrix4x4f_InvertAffine( ksMatrix4x4f * result, const ksMatrix4x4f * src )
+{
+	assert( ksMatrix4x4f_IsAffine( src, 1e-4f ) );
+
+#if defined( ALGEBRA_SIMD_SSE )
+	// The rows of the adjugate of the upper 3x3 are the cross products of its columns.
+	// With a zero fourth component the cross product is ( a * b.yzx - a.yzx * b ).yzx
+	const __m128 c0 = _mm_loadu_ps( src->m[0] );
+	const __m128 c1 = _mm_loadu_ps( src->m[1] );
+	const __m128 c2 = _mm_loadu_ps( src->m[2] );
+	const __m128 c0yzx = _mm_shuffle_ps( c0, c0, _MM_SHUFFLE( 3, 0, 2, 1 ) );
+	const __m128 c1yzx = _mm_shuffle_ps( c1, c1, _MM_SHUFFLE( 3, 0, 2, 1 ) );
+	const __m128 c2yzx = _mm_shuffle_ps( c2, c2, _MM_SHUFFLE( 3, 0, 2, 1 ) );
+	const __m128 a0 = _mm_sub_ps( _mm_mul_ps( c1, c2yzx ), _mm_mul_ps( c1yzx, c2 ) );
+	const __m128 a1 = _mm_sub_ps( _mm_mul_ps( c2, c0yzx ), _mm_mul_ps( c2yzx, c0 ) );
+	const __m128 a2 = _mm_sub_ps( _mm_mul_ps( c0, c1yzx ), _mm_mul_ps( c0yzx, c1 ) );
+	__m128 r0 = _mm_shuffle_ps( a0, a0, _MM_SHUFFLE( 3, 0, 2, 1 ) );
+	__m128 r1 = _mm_shuffle_ps( a1, a1, _MM_SHUFFLE( 3, 0, 2, 1 ) );
+	__m128 r2 = _mm_shuffle_ps( a2, a2, _MM_SHUFFLE( 3, 0, 2, 1 ) );
+	__m128 r3 = _mm_setzero_ps();
+	const __m128 d0 = _mm_mul_ps( c0, r0 );
+	const __m128 d1 = _mm_add_ps( d0, _mm_shuffle_ps( d0, d0, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+	const __m128 det = _mm_add_ps( d1, _mm_shuffle_ps( d1, d1, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+	const __m128 rcpDet = _mm_div_ps( _mm_set1_ps( 1.0f ), det );
+	// Transposing the adjugate with a zero fourth row also clears the fourth row of the result.
+	_MM_TRANSPOSE4_PS( r0, r1, r2, r3 );
+	r0 = _mm_mul_ps( r0, rcpDet );
+	r1 = _mm_mul_ps( r1, rcpDet );
+	r2 = _mm_mul_ps( r2, rcpDet );
+	const __m128 t01 = _mm_add_ps( _mm_mul_ps( r0, _mm_set1_ps( src->m[3][0] ) ), _mm_mul_ps( r1, _mm_set1_ps( src->m[3][1] ) ) );
+	const __m128 t = _mm_add_ps( t01, _mm_mul_ps( r2, _mm_set1_ps( src->m[3][2] ) ) );
+	_mm_storeu_ps( result->m[0], r0 );
+	_mm_storeu_ps( result->m[1], r1 );
+	_mm_storeu_ps( result->m[2], r2 );
+	_mm_storeu_ps( result->m[3], _mm_sub_ps( _mm_setzero_ps(), t ) );
+	result->m[3][3] = 1.0f;
+#else
+	// The rows of the adjugate of the upper 3x3 are the cross products of its columns.
+	const float a00 = src->m[1][1] * src->m[2][2] - src->m[1][2] * src->m[2][1];
+	const float a01 = src->m[1][2] * src->m[2][0] - src->m[1][0] * src->m[2][2];
+	const float a02 = src->m[1][0] * src->m[2][1] - src->m[1][1] * src->m[2][0];
+	const float a10 = src->m[2][1] * src->m[0][2] - src->m[2][2] * src->m[0][1];
+	const float a11 = src->m[2][2] * src->m[0][0] - src->m[2][0] * src->m[0][2];
+	const float a12 = src->m[2][0] * src->m[0][1] - src->m[2][1] * src->m[0][0];
+	const float a20 = src->m[0][1] * src->m[1][2] - src->m[0][2] * src->m[1][1];
+	const float a21 = src->m[0][2] * src->m[1][0] - src->m[0][0] * src->m[1][2];
+	const float a22 = src->m[0][0] * src->m[1][1] - src->m[0][1] * src->m[1][0];
+	const float rcpDet = 1.0f / ( src->m[0][0] * a00 + src->m[0][1] * a01 + src->m[0][2] * a02 );
+	const float tx = src->m[3][0];
+	const float ty = src->m[3][1];
+	const float tz = src->m[3][2];
+
+	result->m[0][0] = a00 * rcpDet;
+	result->m[0][1] = a10 * rcpDet;
+	result->m[0][2] = a20 * rcpDet;
+	result->m[0][3] = 0.0f;
+	result->m[1][0] = a01 * rcpDet;
+	result->m[1][1] = a11 * rcpDet;
+	result->m[1][2] = a21 * rcpDet;
+	result->m[1][3] = 0.0f;
+	result->m[2][0] = a02 * rcpDet;
+	result->m[2][1] = a12 * rcpDet;
+	result->m[2][2] = a22 * rcpDet;
+	result->m[2][3] = 0.0f;
+	result->m[3][0] = -( a00 * tx + a01 * ty + a02 * tz ) * rcpDet;
+	result->m[3][1] = -( a10 * tx + a11 * ty + a12 * tz ) * rcpDet;
+	result->m[3][2] = -( a20 * tx + a21 * ty + a22 * tz ) * rcpDet;
+	result->m[3][3] = 1.0f;
+#endif
+}
+
+// Calculates the inverse of a matrix with only a rotation, a uniform scale and a translation.
+static void ksMatrix4x4f_InvertRigid( ksMatrix4x4f * result, const ksMatrix4x4f * src )
+{
+	assert( ksMatrix4x4f_IsAffine( src, 1e-4f ) );
+
+	// The inverse of the upper 3x3 is its transpose divided by the squared scale.
+	const float rcpScaleSquared = 1.0f / ( src->m[0][0] * src->m[0][0] + src->m[0][1] * src->m[0][1] + src->m[0][2] * src->m[0][2] );
+
+#if defined( ALGEBRA_SIMD_SSE )
+	// Transposing the rotation with a zero fourth column also clears the fourth row of the result.
+	const __m128 s = _mm_set1_ps( rcpScaleSquared );
+	__m128 r0 = _mm_mul_ps( _mm_loadu_ps( src->m[0] ), s );
+	__m128 r1 = _mm_mul_ps( _mm_loadu_ps( src->m[1] ), s );
+	__m128 r2 = _mm_mul_ps( _mm_loadu_ps( src->m[2] ), s );
+	__m128 r3 = _mm_setzero_ps();
+	_MM_TRANSPOSE4_PS( r0, r1, r2, r3 );
+	const __m128 t01 = _mm_add_ps( _mm_mul_ps( r0, _mm_set1_ps( src->m[3][0] ) ), _mm_mul_ps( r1, _mm_set1_ps( src->m[3][1] ) ) );
+	const __m128 t = _mm_add_ps( t01, _mm_mul_ps( r2, _mm_set1_ps( src->m[3][2] ) ) );
+	_mm_storeu_ps( result->m[0], r0 );
+	_mm_storeu_ps( result->m[1], r1 );
+	_mm_storeu_ps( result->m[2], r2 );
+	_mm_storeu_ps( result->m[3], _mm_sub_ps( _mm_setzero_ps(), t ) );
+	result->m[3][3] = 1.0f;
+#elif defined( ALGEBRA_SIMD_NEON )
+	// Transposing the rotation with a zero fourth column also clears the fourth row of the result.
+	const float32x4x2_t t01 = vtrnq_f32( vmulq_n_f32( vld1q_f32( src->m[0] ), rcpScaleSquared ), vmulq_n_f32( vld1q_f32( src->m[1] ), rcpScaleSquared ) );
+	const float32x4x2_t t23 = vtrnq_f32( vmulq_n_f32( vld1q_f32( src->m[2] ), rcpScaleSquared ), vdupq_n_f32( 0.0f ) );
+	const float32x4_t r0 = vcombine_f32( vget_low_f32( t01.val[0] ), vget_low_f32( t23.val[0] ) );
+	const float32x4_t r1 = vcombine_f32( vget_low_f32( t01.val[1] ), vget_low_f32( t23.val[1] ) );
+	const float32x4_t r2 = vcombine_f32( vget_high_f32( t01.val[0] ), vget_high_f32( t23.val[0] ) );
+	const float32x4_t t = vaddq_f32( vaddq_f32( vmulq_n_f32( r0, src->m[3][0] ), vmulq_n_f32( r1, src->m[3][1] ) ), vmulq_n_f32( r2, src->m[3][2] ) );
+	vst1q_f32( result->m[0], r0 );
+	vst1q_f32( result->m[1], r1 );
+	vst1q_f32( result->m[2], r2 );
+	vst1q_f32( result->m[3], vnegq_f32( t ) );
+	result->m[3][3] = 1.0f;
+#else
+	const float tx = src->m[3][0];
+	const float ty = src->m[3][1];
+	const float tz = src->m[3][2];
+
+	result->m[0][0] = src->m[0][0] * rcpScaleSquared;
+	result->m[0][1] = src->m[1][0] * rcpScaleSquared;
+	result->m[0][2] = src->m[2][0] * rcpScaleSquared;
+	result->m[0][3] = 0.0f;
+	result->m[1][0] = src->m[0][1] * rcpScaleSquared;
+	result->m[1][1] = src->m[1][1] * rcpScaleSquared;
+	result->m[1][2] = src->m[2][1] * rcpScaleSquared;
+	result->m[1][3] = 0.0f;
+	result->m[2][0] = src->m[0][2] * rcpScaleSquared;
+	result->m[2][1] = src->m[1][2] * rcpScaleSquared;
+	result->m[2][2] = src->m[2][2] * rcpScaleSquared;
+	result->m[2][3] = 0.0f;
+	result->m[3][0] = -( src->m[0][0] * tx + src->m[0][1] * ty + src->m[0][2] * tz ) * rcpScaleSquared;
+	result->m[3][1] = -( src->m[1][0] * tx + src->m[1][1] * ty + src->m[1][2] * tz ) * rcpScaleSquared;
+	result->m[3][2] = -( src->m[2][0] * tx + src->m[2][1] * ty + src->m[2][2] * tz ) * rcpScaleSquared;
+	result->m[3][3] = 1.0f;
+#endif
+}
+
+#if defined( ALGEBRA_SIMD_SSE )
+
+// Returns column0 * x + column1 * y + column2 * z + column3.
+static __m128 ksMatrix4x4f_TransformPointSSE( const ksMatrix4x4f * m, const float x, const float y, const float z )
+{
+	const __m128 r01 = _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( m->m[0] ), _mm_set1_ps( x ) ), _mm_mul_ps( _mm_loadu_ps( m->m[1] ), _mm_set1_ps( y ) ) );
+	const __m128 r012 = _mm_add_ps( r01, _mm_mul_ps( _mm_loadu_ps( m->m[2] ), _mm_set1_ps( z ) ) );
+	return _mm_add_ps( r012, _mm_loadu_ps( m->m[3] ) );
+}
+
+static void ksVector3f_StoreSSE( ksVector3f * result, const __m128 v )
+{
+	_mm_store_ss( &result->x, v );
+	_mm_store_ss( &result->y, _mm_shuffle_ps( v, v, _MM_SHUFFLE( 1, 1, 1, 1 ) ) );
+	_mm_store_ss( &result->z, _mm_shuffle_ps( v, v, _MM_SHUFFLE( 2, 2, 2, 2 ) ) );
+}
+
+#elif defined( ALGEBRA_SIMD_NEON )
+
+// Returns column0 * x + column1 * y + column2 * z + column3.
+static float32x4_t ksMatrix4x4f_TransformPointNEON( const ksMatrix4x4f * m, const float x, const float y, const float z )
+{
+	const float32x4_t r01 = vaddq_f32( vmulq_n_f32( vld1q_f32( m->m[0] ), x ), vmulq_n_f32( vld1q_f32( m->m[1] ), y ) );
+	const float32x4_t r012 = vaddq_f32( r01, vmulq_n_f32( vld1q_f32( m->m[2] ), z ) );
+	return vaddq_f32( r012, vld1q_f32( m->m[3] ) );
+}
+
+static void ksVector3f_StoreNEON( ksVector3f * result, const float32x4_t v )
+{
+	result->x = vgetq_lane_f32( v, 0 );
+	result->y = vgetq_lane_f32( v, 1 );
+	result->z = vgetq_lane_f32( v, 2 );
+}
+
+#endif
+
 // Transforms a 3D vector.
 static void ksMatrix4x4f_TransformVector3f( ksVector3f * result, const ksMatrix4x4f * m, const ksVector3f * v )
 {
+#if defined( ALGEBRA_SIMD_SSE )
+	const __m128 r = ksMatrix4x4f_TransformPointSSE( m, v->x, v->y, v->z );
+	const float rcpW = 1.0f / _mm_cvtss_f32( _mm_shuffle_ps( r, r, _MM_SHUFFLE( 3, 3, 3, 3 ) ) );
+	ksVector3f_StoreSSE( result, _mm_mul_ps( r, _mm_set1_ps( rcpW ) ) );
+#elif defined( ALGEBRA_SIMD_NEON )
+	const float32x4_t r = ksMatrix4x4f_TransformPointNEON( m, v->x, v->y, v->z );
+	const float rcpW = 1.0f / vgetq_lane_f32( r, 3 );
+	ksVector3f_StoreNEON( result, vmulq_n_f32( r, rcpW ) );
+#else
 	const float w = m->m[0][3] * v->x + m->m[1][3] * v->y + m->m[2][3] * v->z + m->m[3][3];
 	const float rcpW = 1.0f / w;
 	result->x = ( m->m[0][0] * v->x + m->m[1][0] * v->y + m->m[2][0] * v->z + m->m[3][0] ) * rcpW;
 	result->y = ( m->m[0][1] * v->x + m->m[1][1] * v->y + m->m[2][1] * v->z + m->m[3][1] ) * rcpW;
 	result->z = ( m->m[0][2] * v->x + m->m[1][2] * v->y + m->m[2][2] * v->z + m->m[3][2] ) * rcpW;
+#endif
 }
 
 // Transforms a 4D vector.
 static void ksMatrix4x4f_TransformVector4f( ksVector4f * result, const ksMatrix4x4f * m, const ksVector4f * v )
 {
+#if defined( ALGEBRA_SIMD_SSE )
+	_mm_storeu_ps( &result->x, ksMatrix4x4f_TransformPointSSE( m, v->x, v->y, v->z ) );
+#elif defined( ALGEBRA_SIMD_NEON )
+	vst1q_f32( &result->x, ksMatrix4x4f_TransformPointNEON( m, v->x, v->y, v->z ) );
+#else
 	result->x = m->m[0][0] * v->x + m->m[1][0] * v->y + m->m[2][0] * v->z + m->m[3][0];
 	result->y = m->m[0][1] * v->x + m->m[1][1] * v->y + m->m[2][1] * v->z + m->m[3][1];
 	result->z = m->m[0][2] * v->x + m->m[1][2] * v->y + m->m[2][2] * v->z + m->m[3][2];
 	result->w = m->m[0][3] * v->x + m->m[1][3] * v->y + m->m[2][3] * v->z + m->m[3][3];
+#endif
 }
 
 // Transforms the 'mins' and 'maxs' bounds with the given 'matrix'.
@@ -857,6 +1322,24 @@ static void ksMatrix4x4f_TransformBounds( ksVector3f * resultMins, ksVector3f *
 
 	const ksVector3f center = { ( mins->x + maxs->x ) * 0.5f, ( mins->y + maxs->y ) * 0.5f, ( mins->z + maxs->z ) * 0.5f };
 	const ksVector3f extents = { maxs->x - center.x, maxs->y - center.y, maxs->z - center.z };
+#if defined( ALGEBRA_SIMD_SSE )
+	const __m128 signMask = _mm_set1_ps( -0.0f );
+	const __m128 newCenter = ksMatrix4x4f_TransformPointSSE( matrix, center.x, center.y, center.z );
+	const __m128 ex = _mm_andnot_ps( signMask, _mm_mul_ps( _mm_set1_ps( extents.x ), _mm_loadu_ps( matrix->m[0] ) ) );
+	const __m128 ey = _mm_andnot_ps( signMask, _mm_mul_ps( _mm_set1_ps( extents.y ), _mm_loadu_ps( matrix->m[1] ) ) );
+	const __m128 ez = _mm_andnot_ps( signMask, _mm_mul_ps( _mm_set1_ps( extents.z ), _mm_loadu_ps( matrix->m[2] ) ) );
+	const __m128 newExtents = _mm_add_ps( _mm_add_ps( ex, ey ), ez );
+	ksVector3f_StoreSSE( resultMins, _mm_sub_ps( newCenter, newExtents ) );
+	ksVector3f_StoreSSE( resultMaxs, _mm_add_ps( newCenter, newExtents ) );
+#elif defined( ALGEBRA_SIMD_NEON )
+	const float32x4_t newCenter = ksMatrix4x4f_TransformPointNEON( matrix, center.x, center.y, center.z );
+	const float32x4_t ex = vabsq_f32( vmulq_n_f32( vld1q_f32( matrix->m[0] ), extents.x ) );
+	const float32x4_t ey = vabsq_f32( vmulq_n_f32( vld1q_f32( matrix->m[1] ), extents.y ) );
+	const float32x4_t ez = vabsq_f32( vmulq_n_f32( vld1q_f32( matrix->m[2] ), extents.z ) );
+	const float32x4_t newExtents = vaddq_f32( vaddq_f32( ex, ey ), ez );
+	ksVector3f_StoreNEON( resultMins, vsubq_f32( newCenter, newExtents ) );
+	ksVector3f_StoreNEON( resultMaxs, vaddq_f32( newCenter, newExtents ) );
+#else
 	const ksVector3f newCenter =
 	{
 		matrix->m[0][0] * center.x + matrix->m[1][0] * center.y + matrix->m[2][0] * center.z + matrix->m[3][0],
@@ -871,6 +1354,7 @@ static void ksMatrix4x4f_TransformBounds( ksVector3f * resultMins, ksVector3f *
 	};
 	ksVector3f_Sub( resultMins, &newCenter, &newExtents );
 	ksVector3f_Add( resultMaxs, &newCenter, &newExtents );
+#endif
 }
 
 // Returns true if the 'mins' and 'maxs' bounds is completely off to one side of the projection matrix.
@@ -966,4 +1450,521 @@ static bool ksMatrix4x4f_CullBounds( const ksMatrix4x4f * mvp, const ksVector3f
 	return false;
 }
 
+/*
+================================================================================================================================
+
+Batched bounds.
+
+================================================================================================================================
+*/
+
+// Calculates the bounds that enclose all 'count' bounds.
+static void ksBounds3fArray_GetBounds( ksVector3f * resultMins, ksVector3f * resultMaxs, const ksBounds3fArray * bounds, const int count )
+{
+	float mins[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+	float maxs[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+	for ( int axis = 0; axis < 3; axis++ )
+	{
+		const float * boundsMins = bounds->mins[axis];
+		const float * boundsMaxs = bounds->maxs[axis];
+		for ( int i = 0; i < count; i++ )
+		{
+			mins[axis] = ( boundsMins[i] < mins[axis] ) ? boundsMins[i] : mins[axis];
+			maxs[axis] = ( boundsMaxs[i] > maxs[axis] ) ? boundsMaxs[i] : maxs[axis];
+		}
+	}
+	resultMins->x = mins[0];
+	resultMins->y = mins[1];
+	resultMins->z = mins[2];
+	resultMaxs->x = maxs[0];
+	resultMaxs->y = maxs[1];
+	resultMaxs->z = maxs[2];
+}
+
+#if defined( ALGEBRA_SIMD_SSE )
+
+// Loads the same column of four matrices and transposes them such that result[r] holds row 'r' of all four matrices.
+static void ksMatrix4x4f_LoadColumnTransposedSSE( __m128 result[4], const ksMatrix4x4f * matrices, const int column )
+{
+	result[0] = _mm_loadu_ps( matrices[0].m[column] );
+	result[1] = _mm_loadu_ps( matrices[1].m[column] );
+	result[2] = _mm_loadu_ps( matrices[2].m[column] );
+	result[3] = _mm_loadu_ps( matrices[3].m[column] );
+	_MM_TRANSPOSE4_PS( result[0], result[1], result[2], result[3] );
+}
+
+#elif defined( ALGEBRA_SIMD_NEON )
+
+// Loads the same column of four matrices and transposes them such that result[r] holds row 'r' of all four matrices.
+static void ksMatrix4x4f_LoadColumnTransposedNEON( float32x4_t result[4], const ksMatrix4x4f * matrices, const int column )
+{
+	const float32x4x2_t t01 = vtrnq_f32( vld1q_f32( matrices[0].m[column] ), vld1q_f32( matrices[1].m[column] ) );
+	const float32x4x2_t t23 = vtrnq_f32( vld1q_f32( matrices[2].m[column] ), vld1q_f32( matrices[3].m[column] ) );
+	result[0] = vcombine_f32( vget_low_f32( t01.val[0] ), vget_low_f32( t23.val[0] ) );
+	result[1] = vcombine_f32( vget_low_f32( t01.val[1] ), vget_low_f32( t23.val[1] ) );
+	result[2] = vcombine_f32( vget_high_f32( t01.val[0] ), vget_high_f32( t23.val[0] ) );
+	result[3] = vcombine_f32( vget_high_f32( t01.val[1] ), vget_high_f32( t23.val[1] ) );
+}
+
+#endif
+
+// Transforms the bounds at index 'i' with matrices[i] for all 'count' bounds. The matrices must be affine.
+// The results are the same as calling ksMatrix4x4f_TransformBounds for each bounds.
+static void ksMatrix4x4f_TransformBoundsArray( ksBounds3fArray * result, const ksMatrix4x4f * matrices, const ksBounds3fArray * bounds, const int count )
+{
+	int i = 0;
+#if defined( ALGEBRA_SIMD_SSE )
+	const __m128 half = _mm_set1_ps( 0.5f );
+	const __m128 signMask = _mm_set1_ps( -0.0f );
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		__m128 m[4][4];
+		ksMatrix4x4f_LoadColumnTransposedSSE( m[0], matrices + i, 0 );
+		ksMatrix4x4f_LoadColumnTransposedSSE( m[1], matrices + i, 1 );
+		ksMatrix4x4f_LoadColumnTransposedSSE( m[2], matrices + i, 2 );
+		ksMatrix4x4f_LoadColumnTransposedSSE( m[3], matrices + i, 3 );
+
+		__m128 center[3];
+		__m128 extents[3];
+		for ( int axis = 0; axis < 3; axis++ )
+		{
+			const __m128 mins = _mm_loadu_ps( bounds->mins[axis] + i );
+			const __m128 maxs = _mm_loadu_ps( bounds->maxs[axis] + i );
+			center[axis] = _mm_mul_ps( _mm_add_ps( mins, maxs ), half );
+			extents[axis] = _mm_sub_ps( maxs, center[axis] );
+		}
+
+		for ( int axis = 0; axis < 3; axis++ )
+		{
+			const __m128 c01 = _mm_add_ps( _mm_mul_ps( m[0][axis], center[0] ), _mm_mul_ps( m[1][axis], center[1] ) );
+			const __m128 newCenter = _mm_add_ps( _mm_add_ps( c01, _mm_mul_ps( m[2][axis], center[2] ) ), m[3][axis] );
+			const __m128 e0 = _mm_andnot_ps( signMask, _mm_mul_ps( extents[0], m[0][axis] ) );
+			const __m128 e1 = _mm_andnot_ps( signMask, _mm_mul_ps( extents[1], m[1][axis] ) );
+			const __m128 e2 = _mm_andnot_ps( signMask, _mm_mul_ps( extents[2], m[2][axis] ) );
+			const __m128 newExtents = _mm_add_ps( _mm_add_ps( e0, e1 ), e2 );
+			_mm_storeu_ps( result->mins[axis] + i, _mm_sub_ps( newCenter, newExtents ) );
+			_mm_storeu_ps( result->maxs[axis] + i, _mm_add_ps( newCenter, newExtents ) );
+		}
+	}
+#elif defined( ALGEBRA_SIMD_NEON )
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		float32x4_t m[4][4];
+		ksMatrix4x4f_LoadColumnTransposedNEON( m[0], matrices + i, 0 );
+		ksMatrix4x4f_LoadColumnTransposedNEON( m[1], matrices + i, 1 );
+		ksMatrix4x4f_LoadColumnTransposedNEON( m[2], matrices + i, 2 );
+		ksMatrix4x4f_LoadColumnTransposedNEON( m[3], matrices + i, 3 );
+
+		float32x4_t center[3];
+		float32x4_t extents[3];
+		for ( int axis = 0; axis < 3; axis++ )
+		{
+			const float32x4_t mins = vld1q_f32( bounds->mins[axis] + i );
+			const float32x4_t maxs = vld1q_f32( bounds->maxs[axis] + i );
+			center[axis] = vmulq_n_f32( vaddq_f32( mins, maxs ), 0.5f );
+			extents[axis] = vsubq_f32( maxs, center[axis] );
+		}
+
+		for ( int axis = 0; axis < 3; axis++ )
+		{
+			const float32x4_t c01 = vaddq_f32( vmulq_f32( m[0][axis], center[0] ), vmulq_f32( m[1][axis], center[1] ) );
+			const float32x4_t newCenter = vaddq_f32( vaddq_f32( c01, vmulq_f32( m[2][axis], center[2] ) ), m[3][axis] );
+			const float32x4_t e0 = vabsq_f32( vmulq_f32( extents[0], m[0][axis] ) );
+			const float32x4_t e1 = vabsq_f32( vmulq_f32( extents[1], m[1][axis] ) );
+			const float32x4_t e2 = vabsq_f32( vmulq_f32( extents[2], m[2][axis] ) );
+			const float32x4_t newExtents = vaddq_f32( vaddq_f32( e0, e1 ), e2 );
+			vst1q_f32( result->mins[axis] + i, vsubq_f32( newCenter, newExtents ) );
+			vst1q_f32( result->maxs[axis] + i, vaddq_f32( newCenter, newExtents ) );
+		}
+	}
+#endif
+	for ( ; i < count; i++ )
+	{
+		const ksVector3f mins = { bounds->mins[0][i], bounds->mins[1][i], bounds->mins[2][i] };
+		const ksVector3f maxs = { bounds->maxs[0][i], bounds->maxs[1][i], bounds->maxs[2][i] };
+		ksVector3f resultMins;
+		ksVector3f resultMaxs;
+		ksMatrix4x4f_TransformBounds( &resultMins, &resultMaxs, &matrices[i], &mins, &maxs );
+		result->mins[0][i] = resultMins.x;
+		result->mins[1][i] = resultMins.y;
+		result->mins[2][i] = resultMins.z;
+		result->maxs[0][i] = resultMaxs.x;
+		result->maxs[1][i] = resultMaxs.y;
+		result->maxs[2][i] = resultMaxs.z;
+	}
+}
+
+// Clip plane with, per axis, the bounds component that is furthest along the plane normal.
+typedef struct
+{
+	float			plane[4];
+	const float *	farthest[3];
+} ksCullPlane;
+
+// Sets the visibility bit of each of the 'count' bounds starting at 'first'. A bit is cleared if the
+// bounds is completely off to one side of the projection for every one of the 'mvpCount' matrices.
+// The 'visibleBits' array must have room for ( count + 31 ) / 32 words.
+static void ksMatrix4x4f_CullBoundsArray( uint32_t * visibleBits, const ksMatrix4x4f * mvps, const int mvpCount, const ksBounds3fArray * bounds, const int first, const int count )
+{
+	assert( mvpCount >= 1 && mvpCount <= ALGEBRA_CULL_MAX_VIEWS );
+
+	// The bounds are off to one side of a clip plane if the corner furthest along the plane normal is on the outside.
+	ksCullPlane planes[ALGEBRA_CULL_MAX_VIEWS][6];
+	for ( int view = 0; view < mvpCount; view++ )
+	{
+		const ksMatrix4x4f * mvp = &mvps[view];
+		for ( int p = 0; p < 6; p++ )
+		{
+			const int row = p >> 1;
+			const float sign = ( p & 1 ) ? -1.0f : 1.0f;
+			ksCullPlane * plane = &planes[view][p];
+			for ( int column = 0; column < 4; column++ )
+			{
+				plane->plane[column] = mvp->m[column][3] + sign * mvp->m[column][row];
+			}
+			for ( int axis = 0; axis < 3; axis++ )
+			{
+				plane->farthest[axis] = ( ( plane->plane[axis] > 0.0f ) ? bounds->maxs[axis] : bounds->mins[axis] ) + first;
+			}
+		}
+	}
+
+	const float * mins[3] = { bounds->mins[0] + first, bounds->mins[1] + first, bounds->mins[2] + first };
+	const float * maxs[3] = { bounds->maxs[0] + first, bounds->maxs[1] + first, bounds->maxs[2] + first };
+
+	for ( int i = 0; i < ( count + 31 ) / 32; i++ )
+	{
+		visibleBits[i] = 0;
+	}
+
+	int i = 0;
+#if defined( ALGEBRA_SIMD_AVX )
+	for ( ; i + 8 <= count; i += 8 )
+	{
+		__m256 culled = _mm256_castsi256_ps( _mm256_set1_epi32( -1 ) );
+		for ( int view = 0; view < mvpCount; view++ )
+		{
+			__m256 outside = _mm256_setzero_ps();
+			for ( int p = 0; p < 6; p++ )
+			{
+				const ksCullPlane * plane = &planes[view][p];
+				const __m256 d01 = _mm256_add_ps(	_mm256_mul_ps( _mm256_set1_ps( plane->plane[0] ), _mm256_loadu_ps( plane->farthest[0] + i ) ),
+													_mm256_mul_ps( _mm256_set1_ps( plane->plane[1] ), _mm256_loadu_ps( plane->farthest[1] + i ) ) );
+				const __m256 d012 = _mm256_add_ps( d01, _mm256_mul_ps( _mm256_set1_ps( plane->plane[2] ), _mm256_loadu_ps( plane->farthest[2] + i ) ) );
+				const __m256 d = _mm256_add_ps( d012, _mm256_set1_ps( plane->plane[3] ) );
+				outside = _mm256_or_ps( outside, _mm256_cmp_ps( d, _mm256_setzero_ps(), _CMP_LE_OQ ) );
+			}
+			culled = _mm256_and_ps( culled, outside );
+		}
+		// Empty bounds are never culled.
+		const __m256 emptyX = _mm256_cmp_ps( _mm256_loadu_ps( maxs[0] + i ), _mm256_loadu_ps( mins[0] + i ), _CMP_LE_OQ );
+		const __m256 emptyY = _mm256_cmp_ps( _mm256_loadu_ps( maxs[1] + i ), _mm256_loadu_ps( mins[1] + i ), _CMP_LE_OQ );
+		const __m256 emptyZ = _mm256_cmp_ps( _mm256_loadu_ps( maxs[2] + i ), _mm256_loadu_ps( mins[2] + i ), _CMP_LE_OQ );
+		culled = _mm256_andnot_ps( _mm256_and_ps( _mm256_and_ps( emptyX, emptyY ), emptyZ ), culled );
+		const uint32_t visible = ~(uint32_t)_mm256_movemask_ps( culled ) & 0xFF;
+		visibleBits[i >> 5] |= visible << ( i & 31 );
+	}
+#endif
+#if defined( ALGEBRA_SIMD_SSE )
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		__m128 culled = _mm_cmpeq_ps( _mm_setzero_ps(), _mm_setzero_ps() );
+		for ( int view = 0; view < mvpCount; view++ )
+		{
+			__m128 outside = _mm_setzero_ps();
+			for ( int p = 0; p < 6; p++ )
+			{
+				const ksCullPlane * plane = &planes[view][p];
+				const __m128 d01 = _mm_add_ps(	_mm_mul_ps( _mm_set1_ps( plane->plane[0] ), _mm_loadu_ps( plane->farthest[0] + i ) ),
+												_mm_mul_ps( _mm_set1_ps( plane->plane[1] ), _mm_loadu_ps( plane->farthest[1] + i ) ) );
+				const __m128 d012 = _mm_add_ps( d01, _mm_mul_ps( _mm_set1_ps( plane->plane[2] ), _mm_loadu_ps( plane->farthest[2] + i ) ) );
+				const __m128 d = _mm_add_ps( d012, _mm_set1_ps( plane->plane[3] ) );
+				outside = _mm_or_ps( outside, _mm_cmple_ps( d, _mm_setzero_ps() ) );
+			}
+			culled = _mm_and_ps( culled, outside );
+		}
+		// Empty bounds are never culled.
+		const __m128 emptyX = _mm_cmple_ps( _mm_loadu_ps( maxs[0] + i ), _mm_loadu_ps( mins[0] + i ) );
+		const __m128 emptyY = _mm_cmple_ps( _mm_loadu_ps( maxs[1] + i ), _mm_loadu_ps( mins[1] + i ) );
+		const __m128 emptyZ = _mm_cmple_ps( _mm_loadu_ps( maxs[2] + i ), _mm_loadu_ps( mins[2] + i ) );
+		culled = _mm_andnot_ps( _mm_and_ps( _mm_and_ps( emptyX, emptyY ), emptyZ ), culled );
+		const uint32_t visible = ~(uint32_t)_mm_movemask_ps( culled ) & 0xF;
+		visibleBits[i >> 5] |= visible << ( i & 31 );
+	}
+#elif defined( ALGEBRA_SIMD_NEON )
+	const uint32_t bitValues[4] = { 1, 2, 4, 8 };
+	const uint32x4_t bitMask = vld1q_u32( bitValues );
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		uint32x4_t culled = vdupq_n_u32( 0xFFFFFFFF );
+		for ( int view = 0; view < mvpCount; view++ )
+		{
+			uint32x4_t outside = vdupq_n_u32( 0 );
+			for ( int p = 0; p < 6; p++ )
+			{
+				const ksCullPlane * plane = &planes[view][p];
+				const float32x4_t d01 = vaddq_f32( vmulq_n_f32( vld1q_f32( plane->farthest[0] + i ), plane->plane[0] ), vmulq_n_f32( vld1q_f32( plane->farthest[1] + i ), plane->plane[1] ) );
+				const float32x4_t d012 = vaddq_f32( d01, vmulq_n_f32( vld1q_f32( plane->farthest[2] + i ), plane->plane[2] ) );
+				const float32x4_t d = vaddq_f32( d012, vdupq_n_f32( plane->plane[3] ) );
+				outside = vorrq_u32( outside, vcleq_f32( d, vdupq_n_f32( 0.0f ) ) );
+			}
+			culled = vandq_u32( culled, outside );
+		}
+		// Empty bounds are never culled.
+		const uint32x4_t emptyX = vcleq_f32( vld1q_f32( maxs[0] + i ), vld1q_f32( mins[0] + i ) );
+		const uint32x4_t emptyY = vcleq_f32( vld1q_f32( maxs[1] + i ), vld1q_f32( mins[1] + i ) );
+		const uint32x4_t emptyZ = vcleq_f32( vld1q_f32( maxs[2] + i ), vld1q_f32( mins[2] + i ) );
+		const uint32x4_t visibleLanes = vandq_u32( vorrq_u32( vmvnq_u32( culled ), vandq_u32( vandq_u32( emptyX, emptyY ), emptyZ ) ), bitMask );
+		const uint32x2_t visiblePairs = vadd_u32( vget_low_u32( visibleLanes ), vget_high_u32( visibleLanes ) );
+		const uint32_t visible = vget_lane_u32( vpadd_u32( visiblePairs, visiblePairs ), 0 );
+		visibleBits[i >> 5] |= visible << ( i & 31 );
+	}
+#endif
+	for ( ; i < count; i++ )
+	{
+		if ( maxs[0][i] <= mins[0][i] && maxs[1][i] <= mins[1][i] && maxs[2][i] <= mins[2][i] )
+		{
+			visibleBits[i >> 5] |= 1u << ( i & 31 );
+			continue;
+		}
+		bool culled = true;
+		for ( int view = 0; view < mvpCount && culled; view++ )
+		{
+			bool outside = false;
+			for ( int p = 0; p < 6; p++ )
+			{
+				const ksCullPlane * plane = &planes[view][p];
+				const float d = plane->plane[0] * plane->farthest[0][i] + plane->plane[1] * plane->farthest[1][i] + plane->plane[2] * plane->farthest[2][i] + plane->plane[3];
+				outside |= ( d <= 0.0f );
+			}
+			culled = outside;
+		}
+		if ( !culled )
+		{
+			visibleBits[i >> 5] |= 1u << ( i & 31 );
+		}
+	}
+}
+
+/*
+================================================================================================================================
+
+Batched transforms.
+
+================================================================================================================================
+*/
+
+// Interpolates the translations and scales linearly and the rotations with ksQuatf_FastSlerp,
+// where transform 'i' is interpolated from 'a' to 'b' by fractions[i].
+static void ksTransformArray_Blend( ksTransformArray * result, const ksTransformArray * a, const ksTransformArray * b, const float * fractions, const int count )
+{
+	int i = 0;
+#if defined( ALGEBRA_SIMD_SSE )
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps( 1.0f );
+	const __m128 half = _mm_set1_ps( 0.5f );
+	const __m128 signMask = _mm_set1_ps( -0.0f );
+	const __m128 smallestNonDenormal = _mm_set1_ps( 1.1754943508222875e-038f );
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		const __m128 fraction = _mm_loadu_ps( fractions + i );
+		for ( int c = 0; c < 3; c++ )
+		{
+			const __m128 ta = _mm_loadu_ps( a->translation[c] + i );
+			const __m128 tb = _mm_loadu_ps( b->translation[c] + i );
+			_mm_storeu_ps( result->translation[c] + i, _mm_add_ps( ta, _mm_mul_ps( fraction, _mm_sub_ps( tb, ta ) ) ) );
+			const __m128 sa = _mm_loadu_ps( a->scale[c] + i );
+			const __m128 sb = _mm_loadu_ps( b->scale[c] + i );
+			_mm_storeu_ps( result->scale[c] + i, _mm_add_ps( sa, _mm_mul_ps( fraction, _mm_sub_ps( sb, sa ) ) ) );
+		}
+
+		__m128 qa[4];
+		__m128 qb[4];
+		for ( int c = 0; c < 4; c++ )
+		{
+			qa[c] = _mm_loadu_ps( a->rotation[c] + i );
+			qb[c] = _mm_loadu_ps( b->rotation[c] + i );
+		}
+		const __m128 s = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( qa[0], qb[0] ), _mm_mul_ps( qa[1], qb[1] ) ), _mm_mul_ps( qa[2], qb[2] ) ), _mm_mul_ps( qa[3], qb[3] ) );
+
+		// Same as ksQuatf_FastSlerpFraction.
+		const __m128 cosAngle = _mm_andnot_ps( signMask, s );
+		const __m128 A0 = _mm_sub_ps( _mm_set1_ps( 3.55645f ), _mm_mul_ps( cosAngle, _mm_set1_ps( 1.43519f ) ) );
+		const __m128 A1 = _mm_add_ps( _mm_set1_ps( -3.2452f ), _mm_mul_ps( cosAngle, A0 ) );
+		const __m128 A = _mm_add_ps( _mm_set1_ps( 1.0904f ), _mm_mul_ps( cosAngle, A1 ) );
+		const __m128 B0 = _mm_add_ps( _mm_set1_ps( -1.06021f ), _mm_mul_ps( cosAngle, _mm_set1_ps( 0.215638f ) ) );
+		const __m128 B = _mm_add_ps( _mm_set1_ps( 0.848013f ), _mm_mul_ps( cosAngle, B0 ) );
+		const __m128 centered = _mm_sub_ps( fraction, half );
+		const __m128 k = _mm_add_ps( _mm_mul_ps( _mm_mul_ps( A, centered ), centered ), B );
+		const __m128 t = _mm_add_ps( fraction, _mm_mul_ps( _mm_mul_ps( _mm_mul_ps( fraction, centered ), _mm_sub_ps( fraction, one ) ), k ) );
+
+		// Same as ksQuatf_Lerp.
+		const __m128 fa = _mm_sub_ps( one, t );
+		const __m128 fb = _mm_xor_ps( t, _mm_and_ps( _mm_cmplt_ps( s, zero ), signMask ) );
+		__m128 q[4];
+		for ( int c = 0; c < 4; c++ )
+		{
+			q[c] = _mm_add_ps( _mm_mul_ps( qa[c], fa ), _mm_mul_ps( qb[c], fb ) );
+		}
+		const __m128 lengthSquared = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( q[0], q[0] ), _mm_mul_ps( q[1], q[1] ) ), _mm_mul_ps( q[2], q[2] ) ), _mm_mul_ps( q[3], q[3] ) );
+		const __m128 notDenormal = _mm_cmpge_ps( lengthSquared, smallestNonDenormal );
+		const __m128 lengthRcp = _mm_or_ps( _mm_and_ps( notDenormal, _mm_div_ps( one, _mm_sqrt_ps( lengthSquared ) ) ), _mm_andnot_ps( notDenormal, one ) );
+		for ( int c = 0; c < 4; c++ )
+		{
+			_mm_storeu_ps( result->rotation[c] + i, _mm_mul_ps( q[c], lengthRcp ) );
+		}
+	}
+#endif
+	for ( ; i < count; i++ )
+	{
+		const float fraction = fractions[i];
+		for ( int c = 0; c < 3; c++ )
+		{
+			result->translation[c][i] = a->translation[c][i] + fraction * ( b->translation[c][i] - a->translation[c][i] );
+			result->scale[c][i] = a->scale[c][i] + fraction * ( b->scale[c][i] - a->scale[c][i] );
+		}
+		const ksQuatf qa = { a->rotation[0][i], a->rotation[1][i], a->rotation[2][i], a->rotation[3][i] };
+		const ksQuatf qb = { b->rotation[0][i], b->rotation[1][i], b->rotation[2][i], b->rotation[3][i] };
+		ksQuatf q;
+		ksQuatf_FastSlerp( &q, &qa, &qb, fraction );
+		result->rotation[0][i] = q.x;
+		result->rotation[1][i] = q.y;
+		result->rotation[2][i] = q.z;
+		result->rotation[3][i] = q.w;
+	}
+}
+
+// Creates the matrix for each transform, where the results are the same as ksMatrix4x4f_CreateTranslationRotationScale.
+static void ksMatrix4x4f_CreateTranslationRotationScaleArray( ksMatrix4x4f * result, const ksTransformArray * transforms, const int count )
+{
+	int i = 0;
+#if defined( ALGEBRA_SIMD_SSE )
+	const __m128 one = _mm_set1_ps( 1.0f );
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		const __m128 x = _mm_loadu_ps( transforms->rotation[0] + i );
+		const __m128 y = _mm_loadu_ps( transforms->rotation[1] + i );
+		const __m128 z = _mm_loadu_ps( transforms->rotation[2] + i );
+		const __m128 w = _mm_loadu_ps( transforms->rotation[3] + i );
+
+		const __m128 x2 = _mm_add_ps( x, x );
+		const __m128 y2 = _mm_add_ps( y, y );
+		const __m128 z2 = _mm_add_ps( z, z );
+
+		const __m128 xx2 = _mm_mul_ps( x, x2 );
+		const __m128 yy2 = _mm_mul_ps( y, y2 );
+		const __m128 zz2 = _mm_mul_ps( z, z2 );
+
+		const __m128 yz2 = _mm_mul_ps( y, z2 );
+		const __m128 wx2 = _mm_mul_ps( w, x2 );
+		const __m128 xy2 = _mm_mul_ps( x, y2 );
+		const __m128 wz2 = _mm_mul_ps( w, z2 );
+		const __m128 xz2 = _mm_mul_ps( x, z2 );
+		const __m128 wy2 = _mm_mul_ps( w, y2 );
+
+		const __m128 sx = _mm_loadu_ps( transforms->scale[0] + i );
+		const __m128 sy = _mm_loadu_ps( transforms->scale[1] + i );
+		const __m128 sz = _mm_loadu_ps( transforms->scale[2] + i );
+
+		// Each vector holds one matrix element for four transforms and is transposed to the matrix columns.
+		__m128 c[4][4];
+		c[0][0] = _mm_mul_ps( _mm_sub_ps( _mm_sub_ps( one, yy2 ), zz2 ), sx );
+		c[0][1] = _mm_mul_ps( _mm_add_ps( xy2, wz2 ), sx );
+		c[0][2] = _mm_mul_ps( _mm_sub_ps( xz2, wy2 ), sx );
+		c[0][3] = _mm_setzero_ps();
+
+		c[1][0] = _mm_mul_ps( _mm_sub_ps( xy2, wz2 ), sy );
+		c[1][1] = _mm_mul_ps( _mm_sub_ps( _mm_sub_ps( one, xx2 ), zz2 ), sy );
+		c[1][2] = _mm_mul_ps( _mm_add_ps( yz2, wx2 ), sy );
+		c[1][3] = _mm_setzero_ps();
+
+		c[2][0] = _mm_mul_ps( _mm_add_ps( xz2, wy2 ), sz );
+		c[2][1] = _mm_mul_ps( _mm_sub_ps( yz2, wx2 ), sz );
+		c[2][2] = _mm_mul_ps( _mm_sub_ps( _mm_sub_ps( one, xx2 ), yy2 ), sz );
+		c[2][3] = _mm_setzero_ps();
+
+		c[3][0] = _mm_loadu_ps( transforms->translation[0] + i );
+		c[3][1] = _mm_loadu_ps( transforms->translation[1] + i );
+		c[3][2] = _mm_loadu_ps( transforms->translation[2] + i );
+		c[3][3] = one;
+
+		for ( int column = 0; column < 4; column++ )
+		{
+			_MM_TRANSPOSE4_PS( c[column][0], c[column][1], c[column][2], c[column][3] );
+			_mm_storeu_ps( result[i + 0].m[column], c[column][0] );
+			_mm_storeu_ps( result[i + 1].m[column], c[column][1] );
+			_mm_storeu_ps( result[i + 2].m[column], c[column][2] );
+			_mm_storeu_ps( result[i + 3].m[column], c[column][3] );
+		}
+	}
+#elif defined( ALGEBRA_SIMD_NEON )
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		const float32x4_t one = vdupq_n_f32( 1.0f );
+		const float32x4_t x = vld1q_f32( transforms->rotation[0] + i );
+		const float32x4_t y = vld1q_f32( transforms->rotation[1] + i );
+		const float32x4_t z = vld1q_f32( transforms->rotation[2] + i );
+		const float32x4_t w = vld1q_f32( transforms->rotation[3] + i );
+
+		const float32x4_t x2 = vaddq_f32( x, x );
+		const float32x4_t y2 = vaddq_f32( y, y );
+		const float32x4_t z2 = vaddq_f32( z, z );
+
+		const float32x4_t xx2 = vmulq_f32( x, x2 );
+		const float32x4_t yy2 = vmulq_f32( y, y2 );
+		const float32x4_t zz2 = vmulq_f32( z, z2 );
+
+		const float32x4_t yz2 = vmulq_f32( y, z2 );
+		const float32x4_t wx2 = vmulq_f32( w, x2 );
+		const float32x4_t xy2 = vmulq_f32( x, y2 );
+		const float32x4_t wz2 = vmulq_f32( w, z2 );
+		const float32x4_t xz2 = vmulq_f32( x, z2 );
+		const float32x4_t wy2 = vmulq_f32( w, y2 );
+
+		const float32x4_t sx = vld1q_f32( transforms->scale[0] + i );
+		const float32x4_t sy = vld1q_f32( transforms->scale[1] + i );
+		const float32x4_t sz = vld1q_f32( transforms->scale[2] + i );
+
+		// Each column is interleaved with vst4q such that every transform gets its own column.
+		float32x4x4_t c[4];
+		c[0].val[0] = vmulq_f32( vsubq_f32( vsubq_f32( one, yy2 ), zz2 ), sx );
+		c[0].val[1] = vmulq_f32( vaddq_f32( xy2, wz2 ), sx );
+		c[0].val[2] = vmulq_f32( vsubq_f32( xz2, wy2 ), sx );
+		c[0].val[3] = vdupq_n_f32( 0.0f );
+
+		c[1].val[0] = vmulq_f32( vsubq_f32( xy2, wz2 ), sy );
+		c[1].val[1] = vmulq_f32( vsubq_f32( vsubq_f32( one, xx2 ), zz2 ), sy );
+		c[1].val[2] = vmulq_f32( vaddq_f32( yz2, wx2 ), sy );
+		c[1].val[3] = vdupq_n_f32( 0.0f );
+
+		c[2].val[0] = vmulq_f32( vaddq_f32( xz2, wy2 ), sz );
+		c[2].val[1] = vmulq_f32( vsubq_f32( yz2, wx2 ), sz );
+		c[2].val[2] = vmulq_f32( vsubq_f32( vsubq_f32( one, xx2 ), yy2 ), sz );
+		c[2].val[3] = vdupq_n_f32( 0.0f );
+
+		c[3].val[0] = vld1q_f32( transforms->translation[0] + i );
+		c[3].val[1] = vld1q_f32( transforms->translation[1] + i );
+		c[3].val[2] = vld1q_f32( transforms->translation[2] + i );
+		c[3].val[3] = one;
+
+		for ( int column = 0; column < 4; column++ )
+		{
+			float columns[4][4];
+			vst4q_f32( columns[0], c[column] );
+			for ( int j = 0; j < 4; j++ )
+			{
+				vst1q_f32( result[i + j].m[column], vld1q_f32( columns[j] ) );
+			}
+		}
+	}
+#endif
+	for ( ; i < count; i++ )
+	{
+		const ksVector3f translation = { transforms->translation[0][i], transforms->translation[1][i], transforms->translation[2][i] };
+		const ksQuatf rotation = { transforms->rotation[0][i], transforms->rotation[1][i], transforms->rotation[2][i], transforms->rotation[3][i] };
+		const ksVector3f scale = { transforms->scale[0][i], transforms->scale[1][i], transforms->scale[2][i] };
+		ksMatrix4x4f_CreateTranslationRotationScale( &result[i], &translation, &rotation, &scale );
+	}
+}
+
 #endif // !KSALGEBRA_H
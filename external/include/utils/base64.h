@@ -45,6 +45,17 @@ and canonical encodings.
 
 https://www.ietf.org/rfc/rfc4648.txt
 
+The bulk of the data is encoded and decoded with SSSE3, AVX2 or AArch64 NEON
+when available, 12 to 48 bytes at a time, based on the algorithms by Wojciech
+Muła and Daniel Lemire. The remainder is handled by scalar code.
+
+https://arxiv.org/abs/1704.00605
+
+ksBase64_Decode() maps characters that are not in the alphabet to zero.
+ksBase64_DecodeStrict() only accepts canonical RFC 4648 base64 text and fails
+without an intermediate allocation if the data does not fit in the caller
+provided memory, for instance mapped staging memory.
+
 
 INTERFACE
 =========
@@ -53,6 +64,7 @@ size_t ksBase64_EncodeSizeInBytes( size_t dataSizeInBytes );
 size_t ksBase64_DecodeSizeInBytes( const char * base64, const size_t base64SizeInBytes );
 size_t ksBase64_Encode( char * base64, const unsigned char * data, const size_t dataSizeInBytes );
 size_t ksBase64_Decode( unsigned char * data, const char * base64, const size_t base64SizeInBytes, const size_t maxDecodeSizeInBytes );
+bool ksBase64_DecodeStrict( unsigned char * data, const char * base64, const size_t base64SizeInBytes, const size_t maxDecodeSizeInBytes, size_t * decodeSizeInBytes );
 
 ================================================================================================================================
 */
@@ -60,6 +72,25 @@ size_t ksBase64_Decode( unsigned char * data, const char * base64, const size_t
 #if !defined( KSBASE64_H )
 #define KSBASE64_H
 
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if !defined( BASE64_SIMD_DISABLED )
+	#if defined( __AVX2__ )
+		#include <immintrin.h>
+		#define BASE64_SIMD_AVX2
+		#define BASE64_SIMD_SSSE3
+	#elif defined( __SSSE3__ )
+		#include <tmmintrin.h>
+		#define BASE64_SIMD_SSSE3
+	#elif defined( __aarch64__ ) || defined( _M_ARM64 )
+		#include <arm_neon.h>
+		#define BASE64_SIMD_NEON
+	#endif
+#endif
+
 // alphabet character for a radix-64 number
 static const char base64_alphabet[] =
 	"ABCDEFGHIJKLMNOPQRSTUVWXYZ"	// [ 0, 25]
@@ -88,6 +119,271 @@ static const char base64_radix64[] =
 	 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
 };
 
+// radix-64 number for an alphabet character, 0xFF for characters that are not in the alphabet
+static const unsigned char base64_decode[] =
+{
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,   62, 0xFF, 0xFF, 0xFF,   63,
+	  52,   53,   54,   55,   56,   57,   58,   59,   60,   61, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF,    0,    1,    2,    3,    4,    5,    6,    7,    8,    9,   10,   11,   12,   13,   14,
+	  15,   16,   17,   18,   19,   20,   21,   22,   23,   24,   25, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF,   26,   27,   28,   29,   30,   31,   32,   33,   34,   35,   36,   37,   38,   39,   40,
+	  41,   42,   43,   44,   45,   46,   47,   48,   49,   50,   51, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+
+#if defined( BASE64_SIMD_SSSE3 )
+
+// Converts 12 bytes to 16 alphabet characters.
+static inline __m128i ksBase64_EncodeSSSE3( __m128i in )
+{
+	// Split each group of three bytes into four radix-64 numbers, one per byte.
+	in = _mm_shuffle_epi8( in, _mm_setr_epi8( 1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10 ) );
+	const __m128i t0 = _mm_mulhi_epu16( _mm_and_si128( in, _mm_set1_epi32( 0x0FC0FC00 ) ), _mm_set1_epi32( 0x04000040 ) );
+	const __m128i t1 = _mm_mullo_epi16( _mm_and_si128( in, _mm_set1_epi32( 0x003F03F0 ) ), _mm_set1_epi32( 0x01000010 ) );
+	const __m128i radix64 = _mm_or_si128( t0, t1 );
+
+	// Convert from radix-64 to the base64 alphabet by adding an offset per alphabet range.
+	const __m128i offsets = _mm_setr_epi8( 'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+											'0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0 );
+	__m128i range = _mm_subs_epu8( radix64, _mm_set1_epi8( 51 ) );
+	range = _mm_or_si128( range, _mm_and_si128( _mm_cmpgt_epi8( _mm_set1_epi8( 26 ), radix64 ), _mm_set1_epi8( 13 ) ) );
+	return _mm_add_epi8( radix64, _mm_shuffle_epi8( offsets, range ) );
+}
+
+// Converts 16 alphabet characters to radix-64 numbers. Returns false if any character is not in the alphabet.
+static inline bool ksBase64_TranslateSSSE3( __m128i * radix64, const __m128i in )
+{
+	// Each character is classified by its low and high nibble. A character is in the alphabet
+	// if the bits for its low nibble and the bits for its high nibble do not overlap.
+	const __m128i lowBits = _mm_setr_epi8( 0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A );
+	const __m128i highBits = _mm_setr_epi8( 0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10 );
+	const __m128i offsets = _mm_setr_epi8( 0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0 );
+	const __m128i nibbleMask = _mm_set1_epi8( 0x0F );
+	const __m128i highNibbles = _mm_and_si128( _mm_srli_epi32( in, 4 ), nibbleMask );
+	const __m128i lowNibbles = _mm_and_si128( in, nibbleMask );
+	const __m128i bits = _mm_and_si128( _mm_shuffle_epi8( lowBits, lowNibbles ), _mm_shuffle_epi8( highBits, highNibbles ) );
+	if ( _mm_movemask_epi8( _mm_cmpeq_epi8( bits, _mm_setzero_si128() ) ) != 0xFFFF )
+	{
+		return false;
+	}
+	// '/' shares the high nibble with '+' but needs a different offset.
+	const __m128i isSlash = _mm_cmpeq_epi8( in, _mm_set1_epi8( '/' ) );
+	*radix64 = _mm_add_epi8( in, _mm_shuffle_epi8( offsets, _mm_add_epi8( isSlash, highNibbles ) ) );
+	return true;
+}
+
+// Packs 16 radix-64 numbers into the first 12 bytes.
+static inline __m128i ksBase64_PackSSSE3( const __m128i radix64 )
+{
+	const __m128i merged = _mm_madd_epi16( _mm_maddubs_epi16( radix64, _mm_set1_epi32( 0x01400140 ) ), _mm_set1_epi32( 0x00011000 ) );
+	return _mm_shuffle_epi8( merged, _mm_setr_epi8( 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1 ) );
+}
+
+#endif
+
+#if defined( BASE64_SIMD_AVX2 )
+
+// Converts 2 x 12 bytes, one group per 128-bit lane, to 32 alphabet characters.
+static inline __m256i ksBase64_EncodeAVX2( __m256i in )
+{
+	in = _mm256_shuffle_epi8( in, _mm256_setr_epi8( 1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+													1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10 ) );
+	const __m256i t0 = _mm256_mulhi_epu16( _mm256_and_si256( in, _mm256_set1_epi32( 0x0FC0FC00 ) ), _mm256_set1_epi32( 0x04000040 ) );
+	const __m256i t1 = _mm256_mullo_epi16( _mm256_and_si256( in, _mm256_set1_epi32( 0x003F03F0 ) ), _mm256_set1_epi32( 0x01000010 ) );
+	const __m256i radix64 = _mm256_or_si256( t0, t1 );
+
+	const __m256i offsets = _mm256_setr_epi8( 'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+												'0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+												'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+												'0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0 );
+	__m256i range = _mm256_subs_epu8( radix64, _mm256_set1_epi8( 51 ) );
+	range = _mm256_or_si256( range, _mm256_and_si256( _mm256_cmpgt_epi8( _mm256_set1_epi8( 26 ), radix64 ), _mm256_set1_epi8( 13 ) ) );
+	return _mm256_add_epi8( radix64, _mm256_shuffle_epi8( offsets, range ) );
+}
+
+// Converts 32 alphabet characters to radix-64 numbers. Returns false if any character is not in the alphabet.
+static inline bool ksBase64_TranslateAVX2( __m256i * radix64, const __m256i in )
+{
+	const __m256i lowBits = _mm256_setr_epi8( 0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+												0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A );
+	const __m256i highBits = _mm256_setr_epi8( 0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+												0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10 );
+	const __m256i offsets = _mm256_setr_epi8( 0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+												0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0 );
+	const __m256i nibbleMask = _mm256_set1_epi8( 0x0F );
+	const __m256i highNibbles = _mm256_and_si256( _mm256_srli_epi32( in, 4 ), nibbleMask );
+	const __m256i lowNibbles = _mm256_and_si256( in, nibbleMask );
+	const __m256i bits = _mm256_and_si256( _mm256_shuffle_epi8( lowBits, lowNibbles ), _mm256_shuffle_epi8( highBits, highNibbles ) );
+	if ( _mm256_movemask_epi8( _mm256_cmpeq_epi8( bits, _mm256_setzero_si256() ) ) != -1 )
+	{
+		return false;
+	}
+	const __m256i isSlash = _mm256_cmpeq_epi8( in, _mm256_set1_epi8( '/' ) );
+	*radix64 = _mm256_add_epi8( in, _mm256_shuffle_epi8( offsets, _mm256_add_epi8( isSlash, highNibbles ) ) );
+	return true;
+}
+
+// Packs 32 radix-64 numbers into the first 24 bytes.
+static inline __m256i ksBase64_PackAVX2( const __m256i radix64 )
+{
+	const __m256i merged = _mm256_madd_epi16( _mm256_maddubs_epi16( radix64, _mm256_set1_epi32( 0x01400140 ) ), _mm256_set1_epi32( 0x00011000 ) );
+	const __m256i packed = _mm256_shuffle_epi8( merged, _mm256_setr_epi8( 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+																		2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1 ) );
+	return _mm256_permutevar8x32_epi32( packed, _mm256_setr_epi32( 0, 1, 2, 4, 5, 6, 3, 7 ) );
+}
+
+#endif
+
+#if defined( BASE64_SIMD_NEON )
+
+static inline uint8x16x4_t ksBase64_LoadTableNEON( const unsigned char * table )
+{
+	uint8x16x4_t result;
+	result.val[0] = vld1q_u8( table +  0 );
+	result.val[1] = vld1q_u8( table + 16 );
+	result.val[2] = vld1q_u8( table + 32 );
+	result.val[3] = vld1q_u8( table + 48 );
+	return result;
+}
+
+// Converts 16 alphabet characters to radix-64 numbers, 0xFF for characters that are not in the alphabet.
+static inline uint8x16_t ksBase64_TranslateNEON( const uint8x16x4_t table0, const uint8x16x4_t table1, const uint8x16_t in )
+{
+	// Characters >= 128 are out of range for both tables and result in zero, so they are flagged separately.
+	const uint8x16_t radix64 = vqtbx4q_u8( vqtbl4q_u8( table0, in ), table1, vsubq_u8( in, vdupq_n_u8( 64 ) ) );
+	return vorrq_u8( radix64, vcgeq_u8( in, vdupq_n_u8( 128 ) ) );
+}
+
+#endif
+
+// Encodes all complete groups of three bytes for which vector code is available, and
+// as many of the remaining groups as possible with scalar code. Returns the number of
+// bytes consumed, which is a multiple of three.
+static inline size_t ksBase64_EncodeBlocks( char * base64, const unsigned char * data, const size_t dataSizeInBytes )
+{
+	size_t i = 0;
+	size_t o = 0;
+#if defined( BASE64_SIMD_AVX2 )
+	for ( ; i + 28 <= dataSizeInBytes; i += 24, o += 32 )
+	{
+		const __m256i in = _mm256_inserti128_si256( _mm256_castsi128_si256( _mm_loadu_si128( (const __m128i *)( data + i ) ) ),
+													_mm_loadu_si128( (const __m128i *)( data + i + 12 ) ), 1 );
+		_mm256_storeu_si256( (__m256i *)( base64 + o ), ksBase64_EncodeAVX2( in ) );
+	}
+#endif
+#if defined( BASE64_SIMD_SSSE3 )
+	for ( ; i + 16 <= dataSizeInBytes; i += 12, o += 16 )
+	{
+		_mm_storeu_si128( (__m128i *)( base64 + o ), ksBase64_EncodeSSSE3( _mm_loadu_si128( (const __m128i *)( data + i ) ) ) );
+	}
+#endif
+#if defined( BASE64_SIMD_NEON )
+	const uint8x16x4_t alphabet = ksBase64_LoadTableNEON( (const unsigned char *)base64_alphabet );
+	const uint8x16_t mask = vdupq_n_u8( 0x3F );
+	for ( ; i + 48 <= dataSizeInBytes; i += 48, o += 64 )
+	{
+		const uint8x16x3_t in = vld3q_u8( data + i );
+		uint8x16x4_t out;
+		out.val[0] = vshrq_n_u8( in.val[0], 2 );
+		out.val[1] = vandq_u8( vorrq_u8( vshlq_n_u8( in.val[0], 4 ), vshrq_n_u8( in.val[1], 4 ) ), mask );
+		out.val[2] = vandq_u8( vorrq_u8( vshlq_n_u8( in.val[1], 2 ), vshrq_n_u8( in.val[2], 6 ) ), mask );
+		out.val[3] = vandq_u8( in.val[2], mask );
+		out.val[0] = vqtbl4q_u8( alphabet, out.val[0] );
+		out.val[1] = vqtbl4q_u8( alphabet, out.val[1] );
+		out.val[2] = vqtbl4q_u8( alphabet, out.val[2] );
+		out.val[3] = vqtbl4q_u8( alphabet, out.val[3] );
+		vst4q_u8( (uint8_t *)base64 + o, out );
+	}
+#endif
+	for ( ; i + 3 <= dataSizeInBytes; i += 3, o += 4 )
+	{
+		const uint32_t bits = ( (uint32_t)data[i + 0] << 16 ) | ( (uint32_t)data[i + 1] << 8 ) | data[i + 2];
+		base64[o + 0] = base64_alphabet[( bits >> 18 ) & 0x3F];
+		base64[o + 1] = base64_alphabet[( bits >> 12 ) & 0x3F];
+		base64[o + 2] = base64_alphabet[( bits >>  6 ) & 0x3F];
+		base64[o + 3] = base64_alphabet[( bits >>  0 ) & 0x3F];
+	}
+	return i;
+}
+
+// Decodes complete groups of four alphabet characters, without padding, until a group with a character
+// that is not in the alphabet is found, or until the next group does not fit in 'maxDecodeSizeInBytes'.
+// Returns the number of characters consumed, which is a multiple of four.
+static inline size_t ksBase64_DecodeBlocks( unsigned char * data, const char * base64, const size_t base64SizeInBytes, const size_t maxDecodeSizeInBytes )
+{
+	size_t i = 0;
+	size_t o = 0;
+#if defined( BASE64_SIMD_AVX2 )
+	// The stores write a full vector, so there must be room for the unused bytes as well.
+	for ( ; i + 32 <= base64SizeInBytes && o + 32 <= maxDecodeSizeInBytes; i += 32, o += 24 )
+	{
+		__m256i radix64;
+		if ( !ksBase64_TranslateAVX2( &radix64, _mm256_loadu_si256( (const __m256i *)( base64 + i ) ) ) )
+		{
+			break;
+		}
+		_mm256_storeu_si256( (__m256i *)( data + o ), ksBase64_PackAVX2( radix64 ) );
+	}
+#endif
+#if defined( BASE64_SIMD_SSSE3 )
+	for ( ; i + 16 <= base64SizeInBytes && o + 16 <= maxDecodeSizeInBytes; i += 16, o += 12 )
+	{
+		__m128i radix64;
+		if ( !ksBase64_TranslateSSSE3( &radix64, _mm_loadu_si128( (const __m128i *)( base64 + i ) ) ) )
+		{
+			break;
+		}
+		_mm_storeu_si128( (__m128i *)( data + o ), ksBase64_PackSSSE3( radix64 ) );
+	}
+#endif
+#if defined( BASE64_SIMD_NEON )
+	const uint8x16x4_t table0 = ksBase64_LoadTableNEON( base64_decode +  0 );
+	const uint8x16x4_t table1 = ksBase64_LoadTableNEON( base64_decode + 64 );
+	for ( ; i + 64 <= base64SizeInBytes && o + 48 <= maxDecodeSizeInBytes; i += 64, o += 48 )
+	{
+		const uint8x16x4_t in = vld4q_u8( (const uint8_t *)base64 + i );
+		const uint8x16_t a = ksBase64_TranslateNEON( table0, table1, in.val[0] );
+		const uint8x16_t b = ksBase64_TranslateNEON( table0, table1, in.val[1] );
+		const uint8x16_t c = ksBase64_TranslateNEON( table0, table1, in.val[2] );
+		const uint8x16_t d = ksBase64_TranslateNEON( table0, table1, in.val[3] );
+		if ( vmaxvq_u8( vorrq_u8( vorrq_u8( a, b ), vorrq_u8( c, d ) ) ) >= 64 )
+		{
+			break;
+		}
+		uint8x16x3_t out;
+		out.val[0] = vorrq_u8( vshlq_n_u8( a, 2 ), vshrq_n_u8( b, 4 ) );
+		out.val[1] = vorrq_u8( vshlq_n_u8( b, 4 ), vshrq_n_u8( c, 2 ) );
+		out.val[2] = vorrq_u8( vshlq_n_u8( c, 6 ), d );
+		vst3q_u8( data + o, out );
+	}
+#endif
+	for ( ; i + 4 <= base64SizeInBytes && o + 3 <= maxDecodeSizeInBytes; i += 4, o += 3 )
+	{
+		const uint32_t a = base64_decode[(unsigned char)base64[i + 0]];
+		const uint32_t b = base64_decode[(unsigned char)base64[i + 1]];
+		const uint32_t c = base64_decode[(unsigned char)base64[i + 2]];
+		const uint32_t d = base64_decode[(unsigned char)base64[i + 3]];
+		if ( ( a | b | c | d ) > 63 )
+		{
+			break;
+		}
+		const uint32_t bits = ( a << 18 ) | ( b << 12 ) | ( c << 6 ) | d;
+		data[o + 0] = (unsigned char)( bits >> 16 );
+		data[o + 1] = (unsigned char)( bits >>  8 );
+		data[o + 2] = (unsigned char)( bits >>  0 );
+	}
+	return i;
+}
+
 static inline size_t ksBase64_EncodeSizeInBytes( size_t dataSizeInBytes )
 {
 	return ( dataSizeInBytes + 2 ) / 3 * 4;
@@ -96,20 +392,22 @@ static inline size_t ksBase64_EncodeSizeInBytes( size_t dataSizeInBytes )
 static inline size_t ksBase64_DecodeSizeInBytes( const char * base64, const size_t base64SizeInBytes )
 {
 	int padding = 0;
-	for ( size_t i = base64SizeInBytes - 1; i > 0 && base64[i] == '='; i-- )
+	for ( size_t i = base64SizeInBytes; i > 1 && base64[i - 1] == '='; i-- )
 	{
 		padding++;
 	}
-	return ( ( 3 * base64SizeInBytes + 3 ) / 4 ) - padding;
+	// Two characters without padding decode to one byte and three characters to two bytes.
+	return ( ( 3 * base64SizeInBytes ) / 4 ) - padding;
 }
 
 static inline size_t ksBase64_Encode( char * base64, const unsigned char * data, const size_t dataSizeInBytes )
 {
-	size_t base64SizeInBytes = 0;
+	const size_t blockSizeInBytes = ksBase64_EncodeBlocks( base64, data, dataSizeInBytes );
+	size_t base64SizeInBytes = blockSizeInBytes / 3 * 4;
 	size_t byteCount = 0;
 	unsigned char bytes[3];
 
-	for ( size_t i = 0; i < dataSizeInBytes; i++ )
+	for ( size_t i = blockSizeInBytes; i < dataSizeInBytes; i++ )
 	{
 		bytes[byteCount++] = data[i];
 		if ( byteCount == 3 || i == dataSizeInBytes - 1 )
@@ -146,12 +444,15 @@ static inline size_t ksBase64_Encode( char * base64, const unsigned char * data,
 
 static inline size_t ksBase64_Decode( unsigned char * data, const char * base64, const size_t base64SizeInBytes, const size_t maxDecodeSizeInBytes )
 {
-	size_t maxDecodeBytes = ( maxDecodeSizeInBytes > 0 ) ? maxDecodeSizeInBytes : SIZE_MAX;
-	size_t dataSizeInBytes = 0;
+	// Without a limit the output is assumed to be ksBase64_DecodeSizeInBytes() large, which also bounds
+	// the full vector stores of the block decoder.
+	const size_t maxDecodeBytes = ( maxDecodeSizeInBytes > 0 ) ? maxDecodeSizeInBytes : ksBase64_DecodeSizeInBytes( base64, base64SizeInBytes );
+	const size_t blockSizeInBytes = ksBase64_DecodeBlocks( data, base64, base64SizeInBytes, maxDecodeBytes );
+	size_t dataSizeInBytes = blockSizeInBytes / 4 * 3;
 	size_t alphabetCount = 0;
 	unsigned char alphabet[4];
 
-	for ( size_t i = 0; i < base64SizeInBytes && dataSizeInBytes < maxDecodeBytes; i++ )
+	for ( size_t i = blockSizeInBytes; i < base64SizeInBytes && dataSizeInBytes < maxDecodeBytes; i++ )
 	{
 		alphabet[alphabetCount++] = base64[i];
 		if ( alphabetCount == 4 || i == base64SizeInBytes - 1 )
@@ -192,4 +493,61 @@ static inline size_t ksBase64_Decode( unsigned char * data, const char * base64,
 	return dataSizeInBytes;
 }
 
+// Decodes canonical RFC 4648 base64 text into 'data', which may be mapped staging memory.
+// The padding is optional, but any other character that is not in the alphabet, unused
+// bits that are not zero, or data that does not fit in 'maxDecodeSizeInBytes' fail the
+// decode, in which case the contents of 'data' are undefined.
+static inline bool ksBase64_DecodeStrict( unsigned char * data, const char * base64, const size_t base64SizeInBytes, const size_t maxDecodeSizeInBytes, size_t * decodeSizeInBytes )
+{
+	if ( decodeSizeInBytes != NULL )
+	{
+		*decodeSizeInBytes = 0;
+	}
+
+	size_t length = base64SizeInBytes;
+	if ( length > 0 && ( length & 3 ) == 0 )
+	{
+		for ( int padding = 0; padding < 2 && base64[length - 1] == '='; padding++ )
+		{
+			length--;
+		}
+	}
+	const size_t remainder = length & 3;
+	const size_t blockLength = length - remainder;
+	const size_t dataSizeInBytes = blockLength / 4 * 3 + ( ( remainder > 0 ) ? remainder - 1 : 0 );
+	if ( remainder == 1 || dataSizeInBytes > maxDecodeSizeInBytes )
+	{
+		return false;
+	}
+
+	if ( ksBase64_DecodeBlocks( data, base64, blockLength, dataSizeInBytes ) != blockLength )
+	{
+		return false;
+	}
+
+	if ( remainder > 0 )
+	{
+		const uint32_t a = base64_decode[(unsigned char)base64[blockLength + 0]];
+		const uint32_t b = base64_decode[(unsigned char)base64[blockLength + 1]];
+		const uint32_t c = ( remainder == 3 ) ? base64_decode[(unsigned char)base64[blockLength + 2]] : 0;
+		const uint32_t unusedBits = ( remainder == 3 ) ? ( c & 0x03 ) : ( b & 0x0F );
+		if ( ( a | b | c ) > 63 || unusedBits != 0 )
+		{
+			return false;
+		}
+		unsigned char * out = data + blockLength / 4 * 3;
+		out[0] = (unsigned char)( ( a << 2 ) | ( b >> 4 ) );
+		if ( remainder == 3 )
+		{
+			out[1] = (unsigned char)( ( b << 4 ) | ( c >> 2 ) );
+		}
+	}
+
+	if ( decodeSizeInBytes != NULL )
+	{
+		*decodeSizeInBytes = dataSizeInBytes;
+	}
+	return true;
+}
+
 #endif // !KSBASE64_H
@@ -65,6 +65,15 @@ If the DOM is traversed in the order it is stored, then this results
 in only a single string comparison per lookup. This implementation keeps
 objects in the same order in the DOM as they appear in the JSON text.
 
+Some JSON files do use objects as dictionaries with thousands of members,
+and looking up those members out of order degrades to a full scan per
+lookup. An object with at least JSON_HASH_MIN_MEMBERS members therefore
+lazily builds an open addressing hash index on the first lookup by name
+that does not hit the next member in order. The index is discarded when
+a member is added to the object. When an object has multiple members with
+the same name, the first one is found, just like with the linear scan.
+Similar to the member index, building the hash index is not thread-safe.
+
 This implementation stores the members of an object, or the elements
 of an array, in an exponentially growing mapped array per object or
 array. The mapping may need to be re-allocated but this is very rare
@@ -88,9 +97,10 @@ The JSON specification allows an implementation to set limits on the
 range and precision of numbers. This implementation can accurately
 represent the full 8-bit, 16-bit, 32-bit and 64-bit, signed and
 unsigned integer ranges. This implementation can also accurately
-represent all 32-bit and 64-bit floating-point values. The minimum
-and maximum floating-point numbers are parsed with full precision
-and all other floating-point numbers are represented within 4 ulps.
+represent all 32-bit and 64-bit floating-point values. All
+floating-point numbers are correctly rounded to the nearest double
+using the Eisel-Lemire algorithm, with a fallback to the C library
+for the rare cases that cannot be decided with 128-bit precision.
 For instance, this implementation parses the following numbers with
 full precision.
 
@@ -116,6 +126,11 @@ stored as floating-point. JSON does not support floating-point values
 like infinity and NaN. Therefore floating-point values are clamped
 to the range [-DBL_MAX, DBL_MAX].
 
+Floating-point values are written with the shortest number of digits
+that parse back to exactly the same double using the Grisu2 algorithm.
+Floating-point values are always written with a fraction or exponent
+such that they are read back as floating-point values.
+
 The JSON specification allows an implementation to set limits on the
 length and character contents of strings. This implementation supports
 both UTF8 and UTF16 with surrogate pairs. UTF32 is not supported.
@@ -141,12 +156,17 @@ INTERFACE
 struct ksJson;
 
 ksJson *		ksJson_Create();
+ksJson *		ksJson_CreateArena();
 void			ksJson_Destroy( ksJson * rootNode );
 
 bool			ksJson_ReadFromBuffer( ksJson * rootNode, const char * buffer, const char ** errorStringOut );
 bool			ksJson_ReadFromFile( ksJson * rootNode, const char * fileName, const char ** errorStringOut );
 bool			ksJson_WriteToBuffer( const ksJson * rootNode, char ** bufferOut, int * lengthOut );	// Buffer is allocated with malloc.
 bool			ksJson_WriteToFile( const ksJson * rootNode, const char * fileName );
+bool			ksJson_WriteToBufferEx( const ksJson * rootNode, char ** bufferOut, int * lengthOut, const bool compact );
+bool			ksJson_WriteToFileEx( const ksJson * rootNode, const char * fileName, const bool compact );
+bool			ksJson_WriteBinary( const ksJson * rootNode, const char * fileName );
+bool			ksJson_ReadBinary( ksJson * rootNode, const char * fileName, const char ** errorStringOut );
 
 //
 // query
@@ -204,6 +224,21 @@ ksJson *		ksJson_SetFloat( ksJson * node, const float value );					// Turns the
 ksJson *		ksJson_SetDouble( ksJson * node, const double value );					// Turns the node into a 64-bit floating-point number with the given value.
 ksJson *		ksJson_SetString( ksJson * node, const char * value );					// Turns the node into a string with the given value.
 
+//
+// streaming
+//
+
+struct ksJsonSax;
+struct ksJsonSaxCallbacks;
+
+void			ksJsonSax_Create( ksJsonSax * sax, const ksJsonSaxCallbacks * callbacks, void * userData );
+void			ksJsonSax_Destroy( ksJsonSax * sax );
+bool			ksJsonSax_Parse( ksJsonSax * sax, const char * chunk, const size_t length );		// Parses the next chunk of text.
+bool			ksJsonSax_Finish( ksJsonSax * sax, const char ** errorStringOut );					// Completes parsing after the last chunk.
+
+bool			ksJsonSax_ParseBuffer( const ksJsonSaxCallbacks * callbacks, void * userData, const char * buffer, const char ** errorStringOut );
+bool			ksJsonSax_ParseFile( const ksJsonSaxCallbacks * callbacks, void * userData, const char * fileName, const char ** errorStringOut );
+
 
 USAGE
 =====
@@ -217,8 +252,34 @@ The ksJson_Read* functions can be used to initialize the DOM from JSON text.
 The ksJson_Is* and ksJson_Get* functions can be used to query the DOM from code.
 The ksJson_Set* and ksJson_Add* functions can be used to create/modify the DOM.
 The ksJson_Write* functions can be used to write the DOM to JSON text.
+The ksJson_Write*Ex functions can write compact JSON text without any white space.
 The ksJson_Destroy() function is used to destroy the complete DOM.
 
+The ksJson_CreateArena() function creates an empty DOM for which all nodes,
+member mappings and strings are allocated linearly from large blocks of memory
+instead of being separately allocated with malloc. This makes parsing faster
+and allows ksJson_Destroy() to release the complete DOM without walking the
+tree. The trade-off is that memory of values that are replaced by one of the
+ksJson_Set* functions is not released until the complete DOM is destroyed.
+An arena DOM is therefore best used for DOMs that are read once and then
+only queried, like most JSON files that are loaded from disk.
+
+The ksJson_ReadFromFile() function memory maps the file where possible.
+When reading into an arena DOM, the file is kept in memory until the DOM
+is destroyed and the strings are parsed in-situ: all string values and
+member names are decoded in place and point directly into the private
+copy-on-write mapping of the file instead of being separately allocated.
+
+The ksJson_WriteBinary() function writes a binary snapshot of the DOM that
+the ksJson_ReadBinary() function can load without parsing. The snapshot is
+memory mapped and the nodes are relocated in place, so all nodes and strings
+point directly into the private mapping of the file. The root node becomes
+an arena root. All ksJson_Is* and ksJson_Get* functions work on the loaded
+DOM, and values can be changed with the ksJson_Set* functions, but the DOM
+is otherwise read-only: ksJson_AddObjectMember() and ksJson_AddArrayElement()
+return NULL. The snapshot is tied to little-endian hosts and to the layout
+of the ksJson node, so it is best used as a cache of JSON text.
+
 The functions ksJson_GetMemberByIndex() and ksJson_GetMemberByName() are used
 to access the elements of an array and/or members of an object. These functions
 may return NULL if the node is not an object or array, the index is out of range,
@@ -246,6 +307,23 @@ The object members and array elements are kept in the order they are added.
 A JSON object or array can be cleared by calling ksJson_SetObject() or
 ksJson_SetArray() respectively.
 
+JSON text that only needs to be walked once does not need to be turned into
+a DOM. The ksJsonSax_* functions parse JSON text and report each value through
+a set of callbacks in the order the values appear in the text:
+
+    beginObject, endObject, beginArray, endArray, key, string, number, boolean, null
+
+A NULL callback is skipped. If a callback returns false then parsing stops
+with the error "aborted by callback". The text can be passed in as a single
+zero terminated buffer, read from a file, or fed in chunks of arbitrary size
+with ksJsonSax_Parse() followed by a single call to ksJsonSax_Finish(). Tokens
+may be split across chunks. The streaming parser does not recurse. Apart from
+a fixed nesting stack of JSON_MAX_RECURSION levels, the only memory used is a
+single token buffer that grows to the size of the longest string in the text.
+Member names and string values are passed to the callbacks zero terminated
+with all escaped characters decoded. The pointers are only valid for the
+duration of the callback.
+
 
 EXAMPLES
 ========
@@ -428,6 +506,44 @@ Traverse DOM    2.6 GHz        2.6 GHz        2.1 GHz        2.1 GHz        2.1
 #if defined( _MSC_VER )
 #include <intrin.h>
 #endif
+#if defined( __linux__ ) || defined( __APPLE__ )
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define JSON_MMAP
+#endif
+
+// White space and string bodies are scanned 16 or 32 bytes at a time when SIMD is available.
+// Zero terminated text is scanned with aligned loads that never cross a page boundary and
+// may therefore read past the terminating zero. The address sanitizer flags these reads,
+// so the scalar code is used when the address sanitizer is enabled.
+#if defined( __SANITIZE_ADDRESS__ )
+	#define JSON_SIMD_DISABLED
+#elif defined( __has_feature )
+	#if __has_feature( address_sanitizer )
+		#define JSON_SIMD_DISABLED
+	#endif
+#endif
+
+#if !defined( JSON_SIMD_DISABLED )
+	#if defined( __AVX2__ )
+		#include <immintrin.h>
+		#define JSON_SIMD_AVX2
+		#define JSON_SIMD_WIDTH			32
+		#define JSON_SIMD_MASK_BITS		1	// number of mask bits per byte
+	#elif defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+		#include <emmintrin.h>
+		#define JSON_SIMD_SSE2
+		#define JSON_SIMD_WIDTH			16
+		#define JSON_SIMD_MASK_BITS		1
+	#elif defined( __ARM_NEON ) || defined( __ARM_NEON__ ) || defined( _M_ARM64 )
+		#include <arm_neon.h>
+		#define JSON_SIMD_NEON
+		#define JSON_SIMD_WIDTH			16
+		#define JSON_SIMD_MASK_BITS		4
+	#endif
+#endif
 
 #define JSON_MIN( x, y )			( ( x <= y ) ? x : y )
 #define JSON_MAX( x, y )			( ( x >= y ) ? x : y )
@@ -435,6 +551,10 @@ Traverse DOM    2.6 GHz        2.6 GHz        2.1 GHz        2.1 GHz        2.1
 #define JSON_MAX_RECURSION			128
 #define JSON_MAP_GRANULARITY		4	// 128, 2048 etc. members
 #define JSON_BASE_ALLOC_PWR			4	// [16, 32, 64, 128], [256, 512, 1024, 2048] etc. members
+#define JSON_ARENA_BLOCK_SIZE		( 256 * 1024 )
+#define JSON_ARENA_ALIGNMENT		8
+#define JSON_MAX_DOUBLE_LENGTH		32	// maximum number of characters of a formatted double
+#define JSON_HASH_MIN_MEMBERS		64	// objects with at least this many members get a hash index for lookups by name
 
 // JSON value type
 typedef enum
@@ -451,8 +571,30 @@ typedef enum
 	JSON_MAX_ENUM	= 0x7FFFFFFF	// Make sure this enum is 32 bits.
 } JsonType_t;
 
+// Block of memory from which arena allocations are made.
+typedef struct ksJsonArenaBlock
+{
+	struct ksJsonArenaBlock *	next;
+	size_t						size;		// size of the block excluding the header
+	size_t						used;		// number of bytes used excluding the header
+} ksJsonArenaBlock;
+
+#define JSON_ARENA_HEADER_SIZE		( ( sizeof( ksJsonArenaBlock ) + 15 ) & ~15 )
+
+// Arena from which all nodes, member maps and strings of a DOM are allocated.
+typedef struct ksJsonArena
+{
+	ksJsonArenaBlock *	blocks;				// the first block is the one that small allocations are made from
+	size_t				bytesAllocated;		// total size of all blocks
+	char *				source;				// JSON text that strings point into when the DOM was read in-situ
+	size_t				sourceSize;
+	bool				sourceMapped;		// true if the source is a memory mapped file
+	bool				inSitu;				// true while parsing with strings decoded in place
+	bool				readOnly;			// true if the DOM is a view of a binary snapshot in the source
+} ksJsonArena;
+
 // JSON node
-// 32-bit sizeof( ksJson ) = 64-bit sizeof( ksJson ) = 32
+// 32-bit sizeof( ksJson ) = 64-bit sizeof( ksJson ) = 40
 typedef struct ksJson
 {
 	union
@@ -461,6 +603,11 @@ typedef struct ksJson
 		uint64_t		pad;				// make the structure size the same between 32-bit and 64-bit
 	};
 	union
+	{
+		ksJsonArena *	arena;				// arena this node is allocated from, NULL if allocated with malloc
+		uint64_t		pad2;				// make the structure size the same between 32-bit and 64-bit
+	};
+	union
 	{
 		int64_t				valueInt64;		// 64-bit signed integer value
 		uint64_t			valueUint64;	// 64-bit unsigned integer value
@@ -482,6 +629,147 @@ static ksJson * ksJson_Create()
 	return json;
 }
 
+// Creates an empty DOM for which all nodes and strings are allocated from large blocks.
+// Destroying such a DOM only frees the blocks instead of walking the tree.
+// Memory of nodes and strings that are replaced or cleared is only released when the DOM is destroyed.
+static ksJson * ksJson_CreateArena()
+{
+	ksJson * json = ksJson_Create();
+	json->arena = (ksJsonArena *) calloc( 1, sizeof( ksJsonArena ) );
+	return json;
+}
+
+static void * ksJson_Alloc( ksJsonArena * arena, const size_t size )
+{
+	if ( arena == NULL )
+	{
+		return malloc( size );
+	}
+	const size_t alignedSize = ( size + JSON_ARENA_ALIGNMENT - 1 ) & ~( JSON_ARENA_ALIGNMENT - 1 );
+	ksJsonArenaBlock * block = arena->blocks;
+	if ( block == NULL || block->used + alignedSize > block->size )
+	{
+		// Large allocations get their own block so the current block can still be used for small allocations.
+		const bool dedicated = ( alignedSize > JSON_ARENA_BLOCK_SIZE / 4 );
+		const size_t blockSize = dedicated ? alignedSize : JSON_ARENA_BLOCK_SIZE;
+		ksJsonArenaBlock * newBlock = (ksJsonArenaBlock *) malloc( JSON_ARENA_HEADER_SIZE + blockSize );
+		newBlock->size = blockSize;
+		newBlock->used = 0;
+		if ( dedicated && block != NULL )
+		{
+			newBlock->next = block->next;
+			block->next = newBlock;
+		}
+		else
+		{
+			newBlock->next = block;
+			arena->blocks = newBlock;
+		}
+		arena->bytesAllocated += JSON_ARENA_HEADER_SIZE + blockSize;
+		block = newBlock;
+	}
+	void * ptr = (char *)block + JSON_ARENA_HEADER_SIZE + block->used;
+	block->used += alignedSize;
+	return ptr;
+}
+
+static void ksJson_Free( ksJsonArena * arena, void * ptr )
+{
+	if ( arena == NULL )
+	{
+		free( ptr );
+	}
+}
+
+// Loads a file into a zero terminated buffer. If possible the file is memory mapped, in which case any changes
+// to the buffer are private. A file can only be mapped if its size is not a multiple of the page size, because
+// the zero terminator is the zero fill of the last page. Any non-empty file is mapped if 'zeroTerminated' is false.
+// Returns NULL if the file cannot be opened or read.
+static char * ksJson_LoadFile( const char * fileName, const bool zeroTerminated, size_t * sizeOut, bool * mappedOut, const char ** errorStringOut )
+{
+	*sizeOut = 0;
+	*mappedOut = false;
+
+#if defined( JSON_MMAP )
+	const int fd = open( fileName, O_RDONLY );
+	if ( fd < 0 )
+	{
+		*errorStringOut = "failed to open file";
+		return NULL;
+	}
+	struct stat st;
+	const long pageSize = sysconf( _SC_PAGESIZE );
+	if ( fstat( fd, &st ) == 0 && st.st_size > 0 && pageSize > 0 && ( !zeroTerminated || ( st.st_size % pageSize ) != 0 ) )
+	{
+		void * mapped = mmap( NULL, (size_t) st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0 );
+		if ( mapped != MAP_FAILED )
+		{
+			close( fd );
+			posix_madvise( mapped, (size_t) st.st_size, POSIX_MADV_SEQUENTIAL );
+			*sizeOut = (size_t) st.st_size;
+			*mappedOut = true;
+			return (char *) mapped;
+		}
+	}
+	close( fd );
+#endif
+
+	FILE * file = fopen( fileName, "rb" );
+	if ( file == NULL )
+	{
+		*errorStringOut = "failed to open file";
+		return NULL;
+	}
+
+	fseek( file, 0L, SEEK_END );
+	size_t bufferSize = ftell( file );
+	fseek( file, 0L, SEEK_SET );
+
+	char * buffer = (char *) malloc( bufferSize + 1 );
+	if ( fread( buffer, 1, bufferSize, file ) != bufferSize )
+	{
+		*errorStringOut = "failed to read file";
+		free( buffer );
+		fclose( file );
+		return NULL;
+	}
+	buffer[bufferSize] = '\0';	// make sure the buffer is zero terminated
+	fclose( file );
+
+	*sizeOut = bufferSize;
+	return buffer;
+}
+
+static void ksJson_UnloadFile( char * buffer, const size_t size, const bool mapped )
+{
+#if defined( JSON_MMAP )
+	if ( mapped )
+	{
+		munmap( buffer, size );
+		return;
+	}
+#else
+	(void)size;
+	(void)mapped;
+#endif
+	free( buffer );
+}
+
+static void ksJson_FreeArena( ksJsonArena * arena )
+{
+	if ( arena->source != NULL )
+	{
+		ksJson_UnloadFile( arena->source, arena->sourceSize, arena->sourceMapped );
+	}
+	for ( ksJsonArenaBlock * block = arena->blocks; block != NULL; )
+	{
+		ksJsonArenaBlock * next = block->next;
+		free( block );
+		block = next;
+	}
+	free( arena );
+}
+
 static int MemberIndexToMapIndex( int index )
 {
 	index >>= JSON_BASE_ALLOC_PWR;
@@ -493,7 +781,8 @@ static int MemberIndexToMapIndex( int index )
 	}
 	return 0;
 #elif defined( __GNUC__ ) || defined( __clang__ )
-	return 32 - __builtin_clz( (unsigned int) index );
+	// __builtin_clz is undefined for zero.
+	return ( index != 0 ) ? 32 - __builtin_clz( (unsigned int) index ) : 0;
 #else
 	int r = 0;
 	int t;
@@ -508,9 +797,8 @@ static int MemberIndexToMapIndex( int index )
 
 static int MapMemberOffset( int mapIndex )
 {
-	const int offset = ( 1 << ( mapIndex - 1 ) ) << JSON_BASE_ALLOC_PWR;
-	assert( mapIndex >= 1 || offset == 0 );	// Protect againt negative shift not producing zero.
-	return offset;
+	// A negative shift is undefined behavior so the first chunk is handled explicitly.
+	return ( mapIndex >= 1 ) ? ( 1 << ( mapIndex - 1 ) ) << JSON_BASE_ALLOC_PWR : 0;
 }
 
 static int MapMemberCount( int mapIndex, int memberCount )
@@ -518,28 +806,61 @@ static int MapMemberCount( int mapIndex, int memberCount )
 	return JSON_MIN( ( 1 << ( JSON_BASE_ALLOC_PWR + mapIndex ) ), memberCount ) - MapMemberOffset( mapIndex );
 }
 
+// Open addressing hash index of the members of an object.
+typedef struct ksJsonHashEntry
+{
+	uint32_t	hash;
+	int			index;			// member index, or -1 if the entry is empty
+} ksJsonHashEntry;
+
+typedef struct ksJsonHashIndex
+{
+	uint32_t		mask;		// number of entries minus one, the number of entries is a power of two
+	ksJsonHashEntry	entries[1];
+} ksJsonHashIndex;
+
+// The member map has one hidden entry in front of it that stores the hash index of an object.
+// The hash index is built lazily by ksJson_GetMemberByName() and invalidated when a member is added.
+static ksJsonHashIndex * ksJson_GetHashIndex( const ksJson * node )
+{
+	return ( node->membersAllocated > 0 ) ? (ksJsonHashIndex *)(void *)node->memberMap[-1] : NULL;
+}
+
+static void ksJson_FreeHashIndex( const ksJson * node )
+{
+	ksJsonHashIndex * hashIndex = ksJson_GetHashIndex( node );
+	if ( hashIndex != NULL )
+	{
+		ksJson_Free( node->arena, hashIndex );
+		node->memberMap[-1] = NULL;
+	}
+}
+
 static ksJson * ksJson_AllocMember( ksJson * node )
 {
+	ksJson_FreeHashIndex( node );
 	const int mapIndex = MemberIndexToMapIndex( node->memberCount );
 	if ( node->memberCount >= node->membersAllocated )
 	{
 		if ( ( mapIndex & ( JSON_MAP_GRANULARITY - 1 ) ) == 0 )
 		{
-			ksJson ** newMemberMap = (ksJson **) malloc( ( mapIndex + JSON_MAP_GRANULARITY ) * sizeof( ksJson * ) );
+			ksJson ** newMemberMap = (ksJson **) ksJson_Alloc( node->arena, ( 1 + mapIndex + JSON_MAP_GRANULARITY ) * sizeof( ksJson * ) ) + 1;
+			newMemberMap[-1] = NULL;
 			if ( mapIndex > 0 )
 			{
 				memcpy( newMemberMap, node->memberMap, mapIndex * sizeof( ksJson * ) );
-				free( node->memberMap );
+				ksJson_Free( node->arena, node->memberMap - 1 );
 			}
 			node->memberMap = newMemberMap;
 		}
 		const int mapSize = JSON_MAX( MapMemberOffset( mapIndex ), ( 1 << JSON_BASE_ALLOC_PWR ) );
-		node->memberMap[mapIndex] = (ksJson *) malloc( mapSize * sizeof( ksJson ) );
+		node->memberMap[mapIndex] = (ksJson *) ksJson_Alloc( node->arena, mapSize * sizeof( ksJson ) );
 		node->membersAllocated += mapSize;
 	}
 	const int memberOffset = MapMemberOffset( mapIndex );
 	ksJson * member = &node->memberMap[mapIndex][node->memberCount++ - memberOffset];
 	member->name = NULL;
+	member->arena = node->arena;
 	member->valueInt64 = 0;
 	member->valueString = (char *)"null";
 	member->type = JSON_NULL;
@@ -554,10 +875,11 @@ static void ksJson_FreeNode( ksJson * node, const bool freeName )
 	assert( node->type >= JSON_NULL && node->type <= JSON_ARRAY );		// stale ksJson pointer?
 	if ( freeName )
 	{
-		free( node->name );
+		ksJson_Free( node->arena, node->name );
 		node->name = NULL;
 	}
-	if ( node->type == JSON_OBJECT || node->type == JSON_ARRAY )
+	// Arena memory is only released when the whole DOM is destroyed.
+	if ( node->arena == NULL && ( node->type == JSON_OBJECT || node->type == JSON_ARRAY ) )
 	{
 		if ( node->memberCount > 0 )
 		{
@@ -572,10 +894,11 @@ static void ksJson_FreeNode( ksJson * node, const bool freeName )
 				}
 				free( members );
 			}
-			free( node->memberMap );
+			ksJson_FreeHashIndex( node );
+			free( node->memberMap - 1 );
 		}
 	}
-	else if ( node->type == JSON_STRING )
+	else if ( node->arena == NULL && node->type == JSON_STRING )
 	{
 		free( node->valueString );
 	}
@@ -591,20 +914,184 @@ static void ksJson_Destroy( ksJson * rootNode )
 {
 	if ( rootNode != NULL /* && is an actual root */ )
 	{
-		ksJson_FreeNode( rootNode, true );
+		if ( rootNode->arena != NULL )
+		{
+			ksJson_FreeArena( rootNode->arena );
+		}
+		else
+		{
+			ksJson_FreeNode( rootNode, true );
+		}
 		free( rootNode );
 	}
 }
 
+#if defined( JSON_SIMD_WIDTH )
+
+static int ksJson_CountTrailingZeros( uint64_t value )
+{
+	assert( value != 0 );
+#if defined( _MSC_VER ) && ( defined( _M_X64 ) || defined( _M_ARM64 ) )
+	unsigned long index;
+	_BitScanForward64( &index, value );
+	return (int) index;
+#elif defined( __GNUC__ ) || defined( __clang__ )
+	return __builtin_ctzll( value );
+#else
+	int count = 0;
+	for ( ; ( value & 1 ) == 0; value >>= 1 )
+	{
+		count++;
+	}
+	return count;
+#endif
+}
+
+// Returns a mask with JSON_SIMD_MASK_BITS bits set for each byte that is not white space, including the terminating zero.
+static uint64_t ksJson_SimdWhiteSpaceEndMask( const char * buffer )
+{
+#if defined( JSON_SIMD_AVX2 )
+	const __m256i v = _mm256_loadu_si256( (const __m256i *) buffer );
+	const __m256i white = _mm256_cmpeq_epi8( _mm256_subs_epu8( v, _mm256_set1_epi8( ' ' ) ), _mm256_setzero_si256() );
+	const __m256i zero = _mm256_cmpeq_epi8( v, _mm256_setzero_si256() );
+	return (uint32_t)( ~_mm256_movemask_epi8( white ) | _mm256_movemask_epi8( zero ) );
+#elif defined( JSON_SIMD_SSE2 )
+	const __m128i v = _mm_loadu_si128( (const __m128i *) buffer );
+	const __m128i white = _mm_cmpeq_epi8( _mm_subs_epu8( v, _mm_set1_epi8( ' ' ) ), _mm_setzero_si128() );
+	const __m128i zero = _mm_cmpeq_epi8( v, _mm_setzero_si128() );
+	return (uint32_t)( ~_mm_movemask_epi8( white ) | _mm_movemask_epi8( zero ) ) & 0xFFFF;
+#elif defined( JSON_SIMD_NEON )
+	const uint8x16_t v = vld1q_u8( (const uint8_t *) buffer );
+	const uint8x16_t m = vorrq_u8( vcgtq_u8( v, vdupq_n_u8( ' ' ) ), vceqq_u8( v, vdupq_n_u8( 0 ) ) );
+	return vget_lane_u64( vreinterpret_u64_u8( vshrn_n_u16( vreinterpretq_u16_u8( m ), 4 ) ), 0 );
+#endif
+}
+
+// Returns a mask with JSON_SIMD_MASK_BITS bits set for each byte that is a quote, a backslash or a zero.
+static uint64_t ksJson_SimdStringEndMask( const char * buffer )
+{
+#if defined( JSON_SIMD_AVX2 )
+	const __m256i v = _mm256_loadu_si256( (const __m256i *) buffer );
+	const __m256i m = _mm256_or_si256( _mm256_or_si256(
+							_mm256_cmpeq_epi8( v, _mm256_set1_epi8( '\"' ) ),
+							_mm256_cmpeq_epi8( v, _mm256_set1_epi8( '\\' ) ) ),
+							_mm256_cmpeq_epi8( v, _mm256_setzero_si256() ) );
+	return (uint32_t) _mm256_movemask_epi8( m );
+#elif defined( JSON_SIMD_SSE2 )
+	const __m128i v = _mm_loadu_si128( (const __m128i *) buffer );
+	const __m128i m = _mm_or_si128( _mm_or_si128(
+							_mm_cmpeq_epi8( v, _mm_set1_epi8( '\"' ) ),
+							_mm_cmpeq_epi8( v, _mm_set1_epi8( '\\' ) ) ),
+							_mm_cmpeq_epi8( v, _mm_setzero_si128() ) );
+	return (uint32_t) _mm_movemask_epi8( m );
+#elif defined( JSON_SIMD_NEON )
+	const uint8x16_t v = vld1q_u8( (const uint8_t *) buffer );
+	const uint8x16_t m = vorrq_u8( vorrq_u8(
+							vceqq_u8( v, vdupq_n_u8( '\"' ) ),
+							vceqq_u8( v, vdupq_n_u8( '\\' ) ) ),
+							vceqq_u8( v, vdupq_n_u8( 0 ) ) );
+	return vget_lane_u64( vreinterpret_u64_u8( vshrn_n_u16( vreinterpretq_u16_u8( m ), 4 ) ), 0 );
+#endif
+}
+
+#endif // JSON_SIMD_WIDTH
+
 // Parses white space.
 // Returns a pointer to the first character after the white space.
 static const char * ksJson_ParseWhiteSpace( const char * buffer )
 {
+#if defined( JSON_SIMD_WIDTH )
+	// Most white space is a single character, so only use SIMD for longer runs like indentation.
+	if ( buffer[0] == '\0' || (unsigned char)buffer[0] > ' ' )
+	{
+		return buffer;
+	}
+	if ( buffer[1] == '\0' || (unsigned char)buffer[1] > ' ' )
+	{
+		return buffer + 1;
+	}
+	buffer += 2;
+	const size_t misalignment = (uintptr_t)buffer & ( JSON_SIMD_WIDTH - 1 );
+	const char * block = buffer - misalignment;
+	uint64_t mask = ksJson_SimdWhiteSpaceEndMask( block ) & ( ~0ULL << ( misalignment * JSON_SIMD_MASK_BITS ) );
+	while ( mask == 0 )
+	{
+		block += JSON_SIMD_WIDTH;
+		mask = ksJson_SimdWhiteSpaceEndMask( block );
+	}
+	return block + ksJson_CountTrailingZeros( mask ) / JSON_SIMD_MASK_BITS;
+#else
 	while ( buffer[0] != '\0' && (unsigned char)buffer[0] <= ' ' )
 	{
 		buffer++;
 	}
 	return buffer;
+#endif
+}
+
+// Parses white space in the range [buffer, end) which does not need to be zero terminated.
+// Returns a pointer to the first character after the white space.
+static const char * ksJson_ParseWhiteSpaceRange( const char * buffer, const char * end )
+{
+#if defined( JSON_SIMD_WIDTH )
+	while ( end - buffer >= JSON_SIMD_WIDTH )
+	{
+		const uint64_t mask = ksJson_SimdWhiteSpaceEndMask( buffer );
+		if ( mask != 0 )
+		{
+			return buffer + ksJson_CountTrailingZeros( mask ) / JSON_SIMD_MASK_BITS;
+		}
+		buffer += JSON_SIMD_WIDTH;
+	}
+#endif
+	while ( buffer < end && buffer[0] != '\0' && (unsigned char)buffer[0] <= ' ' )
+	{
+		buffer++;
+	}
+	return buffer;
+}
+
+// Skips string characters up to the first quote, backslash or terminating zero.
+static const char * ksJson_SkipStringCharacters( const char * buffer )
+{
+#if defined( JSON_SIMD_WIDTH )
+	const size_t misalignment = (uintptr_t)buffer & ( JSON_SIMD_WIDTH - 1 );
+	const char * block = buffer - misalignment;
+	uint64_t mask = ksJson_SimdStringEndMask( block ) & ( ~0ULL << ( misalignment * JSON_SIMD_MASK_BITS ) );
+	while ( mask == 0 )
+	{
+		block += JSON_SIMD_WIDTH;
+		mask = ksJson_SimdStringEndMask( block );
+	}
+	return block + ksJson_CountTrailingZeros( mask ) / JSON_SIMD_MASK_BITS;
+#else
+	while ( buffer[0] != '\"' && buffer[0] != '\\' && buffer[0] != '\0' )
+	{
+		buffer++;
+	}
+	return buffer;
+#endif
+}
+
+// Skips string characters in the range [buffer, end) up to the first quote, backslash or zero.
+static const char * ksJson_SkipStringCharactersRange( const char * buffer, const char * end )
+{
+#if defined( JSON_SIMD_WIDTH )
+	while ( end - buffer >= JSON_SIMD_WIDTH )
+	{
+		const uint64_t mask = ksJson_SimdStringEndMask( buffer );
+		if ( mask != 0 )
+		{
+			return buffer + ksJson_CountTrailingZeros( mask ) / JSON_SIMD_MASK_BITS;
+		}
+		buffer += JSON_SIMD_WIDTH;
+	}
+#endif
+	while ( buffer < end && buffer[0] != '\"' && buffer[0] != '\\' && buffer[0] != '\0' )
+	{
+		buffer++;
+	}
+	return buffer;
 }
 
 // Parses a hexadecimal string up to four digits and stores the integer result in 'value'.
@@ -652,29 +1139,26 @@ static const unsigned char json_firstByteMark[7] =
 	0x00, 0x00, 0xC0, 0xE0, 0xF0, 0xF8, 0xFC
 };
 
-// Parses a string and stores the result in 'value'.
-// Returns a pointer to the first character after the string.
-static const char * ksJson_ParseString( char ** value, const char * buffer, const char ** errorStringOut )
+// Decodes the escaped string characters in the range [buffer, end) and stores the zero terminated result in 'out'.
+// The decoded string is never longer than the escaped string, so 'out' may point to the same memory as 'buffer'.
+// Returns a pointer to the terminating zero in 'out', or NULL if the string contains invalid unicode.
+static char * ksJson_DecodeString( char * out, const char * buffer, const char * end, const char ** errorStringOut )
 {
-	assert( buffer[0] == '\"' );
-	buffer++;
-
-	int length = 0;
-	for ( const char * str = buffer; *str != '\"' && *str != '\0'; length++ )
-	{
-		// Collapse escaped characters and skip escaped quotes.
-		if ( str[0] == '\\' && str[1] != '\0' ) str++;
-		str++;
-	}
-
-	char * out = (char *) malloc( length + 1 );
 	char * outPtr = out;
 
-	while ( buffer[0] != '\"' && buffer[0] != '\0' )
+	while ( buffer < end )
 	{
 		if ( buffer[0] != '\\' )
 		{
-			*outPtr++ = *buffer++;
+			// Copy everything up to the next escaped character at once.
+			const char * escape = (const char *) memchr( buffer, '\\', end - buffer );
+			const size_t length = ( ( escape != NULL ) ? escape : end ) - buffer;
+			if ( outPtr != buffer )
+			{
+				memmove( outPtr, buffer, length );
+			}
+			outPtr += length;
+			buffer += length;
 		}
 		else if ( json_escape[(unsigned char)buffer[1]] )
 		{
@@ -690,15 +1174,14 @@ static const char * ksJson_ParseString( char ** value, const char * buffer, cons
 			if ( uc >= 0xD800 && uc <= 0xDBFF )
 			{
 				// Second-half of surrogate.
-				if ( buffer[0] == '\\' && buffer[1] == 'u' )
+				if ( buffer + 1 < end && buffer[0] == '\\' && buffer[1] == 'u' )
 				{
 					unsigned int uc2 = 0;
 					buffer = ksJson_ParseHex4( &uc2, buffer + 2 );
 					if ( uc2 < 0xDC00 || uc2 > 0xDFFF )
 					{
-						free( out );
 						*errorStringOut = "invalid unicode";
-						return buffer;
+						return NULL;
 					}
 					uc = ( ( ( uc - 0xD800 ) << 10 ) | ( uc2 - 0xDC00 ) ) + 0x10000;
 				}
@@ -723,182 +1206,1016 @@ static const char * ksJson_ParseString( char ** value, const char * buffer, cons
 		}
 	}
 
-	*outPtr = 0;
-	if ( *buffer != '\"' )
+	*outPtr = '\0';
+	return outPtr;
+}
+
+// Parses a string and stores the result in 'value'.
+// Returns a pointer to the first character after the string.
+static const char * ksJson_ParseString( ksJsonArena * arena, char ** value, const char * buffer, const char ** errorStringOut )
+{
+	assert( buffer[0] == '\"' );
+	buffer++;
+
+	int length = 0;
+	const char * end = buffer;
+	for ( ; ; )
+	{
+		const char * next = ksJson_SkipStringCharacters( end );
+		length += (int)( next - end );
+		end = next;
+		if ( end[0] != '\\' )
+		{
+			break;
+		}
+		// Collapse escaped characters and skip escaped quotes.
+		if ( end[1] != '\0' ) end++;
+		end++;
+		length++;
+	}
+
+	if ( *end != '\"' )
 	{
-		free( out );
 		*errorStringOut = "missing trailing quote";
-		return buffer;
+		return end;
+	}
+
+	// When parsing in-situ the string is decoded in place and the zero terminator overwrites the trailing quote or earlier.
+	char * out = ( arena != NULL && arena->inSitu ) ? (char *) buffer : (char *) ksJson_Alloc( arena, length + 1 );
+	if ( ksJson_DecodeString( out, buffer, end, errorStringOut ) == NULL )
+	{
+		ksJson_Free( arena, out );
+		return end;
 	}
-	buffer++;
 
 	*value = out;
 
-	return buffer;
+	return end + 1;
 }
 
-// from 10^-308 to 10^+308
-static const double json_pow10[] =
-{
-	1e-308,1e-307,1e-306,1e-305,
-	1e-304,1e-303,1e-302,1e-301,1e-300,1e-299,1e-298,1e-297,1e-296,1e-295,1e-294,1e-293,1e-292,1e-291,1e-290,1e-289,
-	1e-288,1e-287,1e-286,1e-285,1e-284,1e-283,1e-282,1e-281,1e-280,1e-279,1e-278,1e-277,1e-276,1e-275,1e-274,1e-273,
-	1e-272,1e-271,1e-270,1e-269,1e-268,1e-267,1e-266,1e-265,1e-264,1e-263,1e-262,1e-261,1e-260,1e-259,1e-258,1e-257,
-	1e-256,1e-255,1e-254,1e-253,1e-252,1e-251,1e-250,1e-249,1e-248,1e-247,1e-246,1e-245,1e-244,1e-243,1e-242,1e-241,
-	1e-240,1e-239,1e-238,1e-237,1e-236,1e-235,1e-234,1e-233,1e-232,1e-231,1e-230,1e-229,1e-228,1e-227,1e-226,1e-225,
-	1e-224,1e-223,1e-222,1e-221,1e-220,1e-219,1e-218,1e-217,1e-216,1e-215,1e-214,1e-213,1e-212,1e-211,1e-210,1e-209,
-	1e-208,1e-207,1e-206,1e-205,1e-204,1e-203,1e-202,1e-201,1e-200,1e-199,1e-198,1e-197,1e-196,1e-195,1e-194,1e-193,
-	1e-192,1e-191,1e-190,1e-189,1e-188,1e-187,1e-186,1e-185,1e-184,1e-183,1e-182,1e-181,1e-180,1e-179,1e-178,1e-177,
-	1e-176,1e-175,1e-174,1e-173,1e-172,1e-171,1e-170,1e-169,1e-168,1e-167,1e-166,1e-165,1e-164,1e-163,1e-162,1e-161,
-	1e-160,1e-159,1e-158,1e-157,1e-156,1e-155,1e-154,1e-153,1e-152,1e-151,1e-150,1e-149,1e-148,1e-147,1e-146,1e-145,
-	1e-144,1e-143,1e-142,1e-141,1e-140,1e-139,1e-138,1e-137,1e-136,1e-135,1e-134,1e-133,1e-132,1e-131,1e-130,1e-129,
-	1e-128,1e-127,1e-126,1e-125,1e-124,1e-123,1e-122,1e-121,1e-120,1e-119,1e-118,1e-117,1e-116,1e-115,1e-114,1e-113,
-	1e-112,1e-111,1e-110,1e-109,1e-108,1e-107,1e-106,1e-105,1e-104,1e-103,1e-102,1e-101,1e-100, 1e-99, 1e-98, 1e-97,
-	 1e-96, 1e-95, 1e-94, 1e-93, 1e-92, 1e-91, 1e-90, 1e-89, 1e-88, 1e-87, 1e-86, 1e-85, 1e-84, 1e-83, 1e-82, 1e-81,
-	 1e-80, 1e-79, 1e-78, 1e-77, 1e-76, 1e-75, 1e-74, 1e-73, 1e-72, 1e-71, 1e-70, 1e-69, 1e-68, 1e-67, 1e-66, 1e-65,
-	 1e-64, 1e-63, 1e-62, 1e-61, 1e-60, 1e-59, 1e-58, 1e-57, 1e-56, 1e-55, 1e-54, 1e-53, 1e-52, 1e-51, 1e-50, 1e-49,
-	 1e-48, 1e-47, 1e-46, 1e-45, 1e-44, 1e-43, 1e-42, 1e-41, 1e-40, 1e-39, 1e-38, 1e-37, 1e-36, 1e-35, 1e-34, 1e-33,
-	 1e-32, 1e-31, 1e-30, 1e-29, 1e-28, 1e-27, 1e-26, 1e-25, 1e-24, 1e-23, 1e-22, 1e-21, 1e-20, 1e-19, 1e-18, 1e-17,
-	 1e-16, 1e-15, 1e-14, 1e-13, 1e-12, 1e-11, 1e-10,  1e-9,  1e-8,  1e-7,  1e-6,  1e-5,  1e-4,  1e-3,  1e-2,  1e-1,
-	  1e+0,  1e+1,  1e+2,  1e+3,  1e+4,  1e+5,  1e+6,  1e+7,  1e+8,  1e+9, 1e+10, 1e+11, 1e+12, 1e+13, 1e+14, 1e+15,
-	 1e+16, 1e+17, 1e+18, 1e+19, 1e+20, 1e+21, 1e+22, 1e+23, 1e+24, 1e+25, 1e+26, 1e+27, 1e+28, 1e+29, 1e+30, 1e+31,
-	 1e+32, 1e+33, 1e+34, 1e+35, 1e+36, 1e+37, 1e+38, 1e+39, 1e+40, 1e+41, 1e+42, 1e+43, 1e+44, 1e+45, 1e+46, 1e+47,
-	 1e+48, 1e+49, 1e+50, 1e+51, 1e+52, 1e+53, 1e+54, 1e+55, 1e+56, 1e+57, 1e+58, 1e+59, 1e+60, 1e+61, 1e+62, 1e+63,
-	 1e+64, 1e+65, 1e+66, 1e+67, 1e+68, 1e+69, 1e+70, 1e+71, 1e+72, 1e+73, 1e+74, 1e+75, 1e+76, 1e+77, 1e+78, 1e+79,
-	 1e+80, 1e+81, 1e+82, 1e+83, 1e+84, 1e+85, 1e+86, 1e+87, 1e+88, 1e+89, 1e+90, 1e+91, 1e+92, 1e+93, 1e+94, 1e+95,
-	 1e+96, 1e+97, 1e+98, 1e+99,1e+100,1e+101,1e+102,1e+103,1e+104,1e+105,1e+106,1e+107,1e+108,1e+109,1e+110,1e+111,
-	1e+112,1e+113,1e+114,1e+115,1e+116,1e+117,1e+118,1e+119,1e+120,1e+121,1e+122,1e+123,1e+124,1e+125,1e+126,1e+127,
-	1e+128,1e+129,1e+130,1e+131,1e+132,1e+133,1e+134,1e+135,1e+136,1e+137,1e+138,1e+139,1e+140,1e+141,1e+142,1e+143,
-	1e+144,1e+145,1e+146,1e+147,1e+148,1e+149,1e+150,1e+151,1e+152,1e+153,1e+154,1e+155,1e+156,1e+157,1e+158,1e+159,
-	1e+160,1e+161,1e+162,1e+163,1e+164,1e+165,1e+166,1e+167,1e+168,1e+169,1e+170,1e+171,1e+172,1e+173,1e+174,1e+175,
-	1e+176,1e+177,1e+178,1e+179,1e+180,1e+181,1e+182,1e+183,1e+184,1e+185,1e+186,1e+187,1e+188,1e+189,1e+190,1e+191,
-	1e+192,1e+193,1e+194,1e+195,1e+196,1e+197,1e+198,1e+199,1e+200,1e+201,1e+202,1e+203,1e+204,1e+205,1e+206,1e+207,
-	1e+208,1e+209,1e+210,1e+211,1e+212,1e+213,1e+214,1e+215,1e+216,1e+217,1e+218,1e+219,1e+220,1e+221,1e+222,1e+223,
-	1e+224,1e+225,1e+226,1e+227,1e+228,1e+229,1e+230,1e+231,1e+232,1e+233,1e+234,1e+235,1e+236,1e+237,1e+238,1e+239,
-	1e+240,1e+241,1e+242,1e+243,1e+244,1e+245,1e+246,1e+247,1e+248,1e+249,1e+250,1e+251,1e+252,1e+253,1e+254,1e+255,
-	1e+256,1e+257,1e+258,1e+259,1e+260,1e+261,1e+262,1e+263,1e+264,1e+265,1e+266,1e+267,1e+268,1e+269,1e+270,1e+271,
-	1e+272,1e+273,1e+274,1e+275,1e+276,1e+277,1e+278,1e+279,1e+280,1e+281,1e+282,1e+283,1e+284,1e+285,1e+286,1e+287,
-	1e+288,1e+289,1e+290,1e+291,1e+292,1e+293,1e+294,1e+295,1e+296,1e+297,1e+298,1e+299,1e+300,1e+301,1e+302,1e+303,
-	1e+304,1e+305,1e+306,1e+307,1e+308
+// Exactly representable powers of ten.
+static const double json_exactPow10[] =
+{
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
 };
 
-// Parses a number and stores the result in 'valueInt64', 'valueUint64' or 'valueDouble'.
-// Returns a pointer to the first character after the number.
-static const char * ksJson_ParseNumber( JsonType_t * type, int64_t * valueInt64, uint64_t * valueUint64, double * valueDouble,
-										const char * buffer, const char ** errorStringOut )
+// The 128 most significant bits of 5^q for q in the range [-325, 308], rounded up for negative q and truncated for positive q.
+static const uint64_t json_pow5_128[][2] =
 {
-	(void)errorStringOut;
+	{ 0xa5ced43b7e3e9188ULL, 0x419ea3bd35385e2dULL },	// 5^-325
+	{ 0xcf42894a5dce35eaULL, 0x52064cac828675b9ULL },	// 5^-324
+	{ 0x818995ce7aa0e1b2ULL, 0x7343efebd1940993ULL },	// 5^-323
+	{ 0xa1ebfb4219491a1fULL, 0x1014ebe6c5f90bf8ULL },	// 5^-322
+	{ 0xca66fa129f9b60a6ULL, 0xd41a26e077774ef6ULL },	// 5^-321
+	{ 0xfd00b897478238d0ULL, 0x8920b098955522b4ULL },	// 5^-320
+	{ 0x9e20735e8cb16382ULL, 0x55b46e5f5d5535b0ULL },	// 5^-319
+	{ 0xc5a890362fddbc62ULL, 0xeb2189f734aa831dULL },	// 5^-318
+	{ 0xf712b443bbd52b7bULL, 0xa5e9ec7501d523e4ULL },	// 5^-317
+	{ 0x9a6bb0aa55653b2dULL, 0x47b233c92125366eULL },	// 5^-316
+	{ 0xc1069cd4eabe89f8ULL, 0x999ec0bb696e840aULL },	// 5^-315
+	{ 0xf148440a256e2c76ULL, 0xc00670ea43ca250dULL },	// 5^-314
+	{ 0x96cd2a865764dbcaULL, 0x380406926a5e5728ULL },	// 5^-313
+	{ 0xbc807527ed3e12bcULL, 0xc605083704f5ecf2ULL },	// 5^-312
+	{ 0xeba09271e88d976bULL, 0xf7864a44c633682eULL },	// 5^-311
+	{ 0x93445b8731587ea3ULL, 0x7ab3ee6afbe0211dULL },	// 5^-310
+	{ 0xb8157268fdae9e4cULL, 0x5960ea05bad82964ULL },	// 5^-309
+	{ 0xe61acf033d1a45dfULL, 0x6fb92487298e33bdULL },	// 5^-308
+	{ 0x8fd0c16206306babULL, 0xa5d3b6d479f8e056ULL },	// 5^-307
+	{ 0xb3c4f1ba87bc8696ULL, 0x8f48a4899877186cULL },	// 5^-306
+	{ 0xe0b62e2929aba83cULL, 0x331acdabfe94de87ULL },	// 5^-305
+	{ 0x8c71dcd9ba0b4925ULL, 0x9ff0c08b7f1d0b14ULL },	// 5^-304
+	{ 0xaf8e5410288e1b6fULL, 0x07ecf0ae5ee44dd9ULL },	// 5^-303
+	{ 0xdb71e91432b1a24aULL, 0xc9e82cd9f69d6150ULL },	// 5^-302
+	{ 0x892731ac9faf056eULL, 0xbe311c083a225cd2ULL },	// 5^-301
+	{ 0xab70fe17c79ac6caULL, 0x6dbd630a48aaf406ULL },	// 5^-300
+	{ 0xd64d3d9db981787dULL, 0x092cbbccdad5b108ULL },	// 5^-299
+	{ 0x85f0468293f0eb4eULL, 0x25bbf56008c58ea5ULL },	// 5^-298
+	{ 0xa76c582338ed2621ULL, 0xaf2af2b80af6f24eULL },	// 5^-297
+	{ 0xd1476e2c07286faaULL, 0x1af5af660db4aee1ULL },	// 5^-296
+	{ 0x82cca4db847945caULL, 0x50d98d9fc890ed4dULL },	// 5^-295
+	{ 0xa37fce126597973cULL, 0xe50ff107bab528a0ULL },	// 5^-294
+	{ 0xcc5fc196fefd7d0cULL, 0x1e53ed49a96272c8ULL },	// 5^-293
+	{ 0xff77b1fcbebcdc4fULL, 0x25e8e89c13bb0f7aULL },	// 5^-292
+	{ 0x9faacf3df73609b1ULL, 0x77b191618c54e9acULL },	// 5^-291
+	{ 0xc795830d75038c1dULL, 0xd59df5b9ef6a2417ULL },	// 5^-290
+	{ 0xf97ae3d0d2446f25ULL, 0x4b0573286b44ad1dULL },	// 5^-289
+	{ 0x9becce62836ac577ULL, 0x4ee367f9430aec32ULL },	// 5^-288
+	{ 0xc2e801fb244576d5ULL, 0x229c41f793cda73fULL },	// 5^-287
+	{ 0xf3a20279ed56d48aULL, 0x6b43527578c1110fULL },	// 5^-286
+	{ 0x9845418c345644d6ULL, 0x830a13896b78aaa9ULL },	// 5^-285
+	{ 0xbe5691ef416bd60cULL, 0x23cc986bc656d553ULL },	// 5^-284
+	{ 0xedec366b11c6cb8fULL, 0x2cbfbe86b7ec8aa8ULL },	// 5^-283
+	{ 0x94b3a202eb1c3f39ULL, 0x7bf7d71432f3d6a9ULL },	// 5^-282
+	{ 0xb9e08a83a5e34f07ULL, 0xdaf5ccd93fb0cc53ULL },	// 5^-281
+	{ 0xe858ad248f5c22c9ULL, 0xd1b3400f8f9cff68ULL },	// 5^-280
+	{ 0x91376c36d99995beULL, 0x23100809b9c21fa1ULL },	// 5^-279
+	{ 0xb58547448ffffb2dULL, 0xabd40a0c2832a78aULL },	// 5^-278
+	{ 0xe2e69915b3fff9f9ULL, 0x16c90c8f323f516cULL },	// 5^-277
+	{ 0x8dd01fad907ffc3bULL, 0xae3da7d97f6792e3ULL },	// 5^-276
+	{ 0xb1442798f49ffb4aULL, 0x99cd11cfdf41779cULL },	// 5^-275
+	{ 0xdd95317f31c7fa1dULL, 0x40405643d711d583ULL },	// 5^-274
+	{ 0x8a7d3eef7f1cfc52ULL, 0x482835ea666b2572ULL },	// 5^-273
+	{ 0xad1c8eab5ee43b66ULL, 0xda3243650005eecfULL },	// 5^-272
+	{ 0xd863b256369d4a40ULL, 0x90bed43e40076a82ULL },	// 5^-271
+	{ 0x873e4f75e2224e68ULL, 0x5a7744a6e804a291ULL },	// 5^-270
+	{ 0xa90de3535aaae202ULL, 0x711515d0a205cb36ULL },	// 5^-269
+	{ 0xd3515c2831559a83ULL, 0x0d5a5b44ca873e03ULL },	// 5^-268
+	{ 0x8412d9991ed58091ULL, 0xe858790afe9486c2ULL },	// 5^-267
+	{ 0xa5178fff668ae0b6ULL, 0x626e974dbe39a872ULL },	// 5^-266
+	{ 0xce5d73ff402d98e3ULL, 0xfb0a3d212dc8128fULL },	// 5^-265
+	{ 0x80fa687f881c7f8eULL, 0x7ce66634bc9d0b99ULL },	// 5^-264
+	{ 0xa139029f6a239f72ULL, 0x1c1fffc1ebc44e80ULL },	// 5^-263
+	{ 0xc987434744ac874eULL, 0xa327ffb266b56220ULL },	// 5^-262
+	{ 0xfbe9141915d7a922ULL, 0x4bf1ff9f0062baa8ULL },	// 5^-261
+	{ 0x9d71ac8fada6c9b5ULL, 0x6f773fc3603db4a9ULL },	// 5^-260
+	{ 0xc4ce17b399107c22ULL, 0xcb550fb4384d21d3ULL },	// 5^-259
+	{ 0xf6019da07f549b2bULL, 0x7e2a53a146606a48ULL },	// 5^-258
+	{ 0x99c102844f94e0fbULL, 0x2eda7444cbfc426dULL },	// 5^-257
+	{ 0xc0314325637a1939ULL, 0xfa911155fefb5308ULL },	// 5^-256
+	{ 0xf03d93eebc589f88ULL, 0x793555ab7eba27caULL },	// 5^-255
+	{ 0x96267c7535b763b5ULL, 0x4bc1558b2f3458deULL },	// 5^-254
+	{ 0xbbb01b9283253ca2ULL, 0x9eb1aaedfb016f16ULL },	// 5^-253
+	{ 0xea9c227723ee8bcbULL, 0x465e15a979c1cadcULL },	// 5^-252
+	{ 0x92a1958a7675175fULL, 0x0bfacd89ec191ec9ULL },	// 5^-251
+	{ 0xb749faed14125d36ULL, 0xcef980ec671f667bULL },	// 5^-250
+	{ 0xe51c79a85916f484ULL, 0x82b7e12780e7401aULL },	// 5^-249
+	{ 0x8f31cc0937ae58d2ULL, 0xd1b2ecb8b0908810ULL },	// 5^-248
+	{ 0xb2fe3f0b8599ef07ULL, 0x861fa7e6dcb4aa15ULL },	// 5^-247
+	{ 0xdfbdcece67006ac9ULL, 0x67a791e093e1d49aULL },	// 5^-246
+	{ 0x8bd6a141006042bdULL, 0xe0c8bb2c5c6d24e0ULL },	// 5^-245
+	{ 0xaecc49914078536dULL, 0x58fae9f773886e18ULL },	// 5^-244
+	{ 0xda7f5bf590966848ULL, 0xaf39a475506a899eULL },	// 5^-243
+	{ 0x888f99797a5e012dULL, 0x6d8406c952429603ULL },	// 5^-242
+	{ 0xaab37fd7d8f58178ULL, 0xc8e5087ba6d33b83ULL },	// 5^-241
+	{ 0xd5605fcdcf32e1d6ULL, 0xfb1e4a9a90880a64ULL },	// 5^-240
+	{ 0x855c3be0a17fcd26ULL, 0x5cf2eea09a55067fULL },	// 5^-239
+	{ 0xa6b34ad8c9dfc06fULL, 0xf42faa48c0ea481eULL },	// 5^-238
+	{ 0xd0601d8efc57b08bULL, 0xf13b94daf124da26ULL },	// 5^-237
+	{ 0x823c12795db6ce57ULL, 0x76c53d08d6b70858ULL },	// 5^-236
+	{ 0xa2cb1717b52481edULL, 0x54768c4b0c64ca6eULL },	// 5^-235
+	{ 0xcb7ddcdda26da268ULL, 0xa9942f5dcf7dfd09ULL },	// 5^-234
+	{ 0xfe5d54150b090b02ULL, 0xd3f93b35435d7c4cULL },	// 5^-233
+	{ 0x9efa548d26e5a6e1ULL, 0xc47bc5014a1a6dafULL },	// 5^-232
+	{ 0xc6b8e9b0709f109aULL, 0x359ab6419ca1091bULL },	// 5^-231
+	{ 0xf867241c8cc6d4c0ULL, 0xc30163d203c94b62ULL },	// 5^-230
+	{ 0x9b407691d7fc44f8ULL, 0x79e0de63425dcf1dULL },	// 5^-229
+	{ 0xc21094364dfb5636ULL, 0x985915fc12f542e4ULL },	// 5^-228
+	{ 0xf294b943e17a2bc4ULL, 0x3e6f5b7b17b2939dULL },	// 5^-227
+	{ 0x979cf3ca6cec5b5aULL, 0xa705992ceecf9c42ULL },	// 5^-226
+	{ 0xbd8430bd08277231ULL, 0x50c6ff782a838353ULL },	// 5^-225
+	{ 0xece53cec4a314ebdULL, 0xa4f8bf5635246428ULL },	// 5^-224
+	{ 0x940f4613ae5ed136ULL, 0x871b7795e136be99ULL },	// 5^-223
+	{ 0xb913179899f68584ULL, 0x28e2557b59846e3fULL },	// 5^-222
+	{ 0xe757dd7ec07426e5ULL, 0x331aeada2fe589cfULL },	// 5^-221
+	{ 0x9096ea6f3848984fULL, 0x3ff0d2c85def7621ULL },	// 5^-220
+	{ 0xb4bca50b065abe63ULL, 0x0fed077a756b53a9ULL },	// 5^-219
+	{ 0xe1ebce4dc7f16dfbULL, 0xd3e8495912c62894ULL },	// 5^-218
+	{ 0x8d3360f09cf6e4bdULL, 0x64712dd7abbbd95cULL },	// 5^-217
+	{ 0xb080392cc4349decULL, 0xbd8d794d96aacfb3ULL },	// 5^-216
+	{ 0xdca04777f541c567ULL, 0xecf0d7a0fc5583a0ULL },	// 5^-215
+	{ 0x89e42caaf9491b60ULL, 0xf41686c49db57244ULL },	// 5^-214
+	{ 0xac5d37d5b79b6239ULL, 0x311c2875c522ced5ULL },	// 5^-213
+	{ 0xd77485cb25823ac7ULL, 0x7d633293366b828bULL },	// 5^-212
+	{ 0x86a8d39ef77164bcULL, 0xae5dff9c02033197ULL },	// 5^-211
+	{ 0xa8530886b54dbdebULL, 0xd9f57f830283fdfcULL },	// 5^-210
+	{ 0xd267caa862a12d66ULL, 0xd072df63c324fd7bULL },	// 5^-209
+	{ 0x8380dea93da4bc60ULL, 0x4247cb9e59f71e6dULL },	// 5^-208
+	{ 0xa46116538d0deb78ULL, 0x52d9be85f074e608ULL },	// 5^-207
+	{ 0xcd795be870516656ULL, 0x67902e276c921f8bULL },	// 5^-206
+	{ 0x806bd9714632dff6ULL, 0x00ba1cd8a3db53b6ULL },	// 5^-205
+	{ 0xa086cfcd97bf97f3ULL, 0x80e8a40eccd228a4ULL },	// 5^-204
+	{ 0xc8a883c0fdaf7df0ULL, 0x6122cd128006b2cdULL },	// 5^-203
+	{ 0xfad2a4b13d1b5d6cULL, 0x796b805720085f81ULL },	// 5^-202
+	{ 0x9cc3a6eec6311a63ULL, 0xcbe3303674053bb0ULL },	// 5^-201
+	{ 0xc3f490aa77bd60fcULL, 0xbedbfc4411068a9cULL },	// 5^-200
+	{ 0xf4f1b4d515acb93bULL, 0xee92fb5515482d44ULL },	// 5^-199
+	{ 0x991711052d8bf3c5ULL, 0x751bdd152d4d1c4aULL },	// 5^-198
+	{ 0xbf5cd54678eef0b6ULL, 0xd262d45a78a0635dULL },	// 5^-197
+	{ 0xef340a98172aace4ULL, 0x86fb897116c87c34ULL },	// 5^-196
+	{ 0x9580869f0e7aac0eULL, 0xd45d35e6ae3d4da0ULL },	// 5^-195
+	{ 0xbae0a846d2195712ULL, 0x8974836059cca109ULL },	// 5^-194
+	{ 0xe998d258869facd7ULL, 0x2bd1a438703fc94bULL },	// 5^-193
+	{ 0x91ff83775423cc06ULL, 0x7b6306a34627ddcfULL },	// 5^-192
+	{ 0xb67f6455292cbf08ULL, 0x1a3bc84c17b1d542ULL },	// 5^-191
+	{ 0xe41f3d6a7377eecaULL, 0x20caba5f1d9e4a93ULL },	// 5^-190
+	{ 0x8e938662882af53eULL, 0x547eb47b7282ee9cULL },	// 5^-189
+	{ 0xb23867fb2a35b28dULL, 0xe99e619a4f23aa43ULL },	// 5^-188
+	{ 0xdec681f9f4c31f31ULL, 0x6405fa00e2ec94d4ULL },	// 5^-187
+	{ 0x8b3c113c38f9f37eULL, 0xde83bc408dd3dd04ULL },	// 5^-186
+	{ 0xae0b158b4738705eULL, 0x9624ab50b148d445ULL },	// 5^-185
+	{ 0xd98ddaee19068c76ULL, 0x3badd624dd9b0957ULL },	// 5^-184
+	{ 0x87f8a8d4cfa417c9ULL, 0xe54ca5d70a80e5d6ULL },	// 5^-183
+	{ 0xa9f6d30a038d1dbcULL, 0x5e9fcf4ccd211f4cULL },	// 5^-182
+	{ 0xd47487cc8470652bULL, 0x7647c3200069671fULL },	// 5^-181
+	{ 0x84c8d4dfd2c63f3bULL, 0x29ecd9f40041e073ULL },	// 5^-180
+	{ 0xa5fb0a17c777cf09ULL, 0xf468107100525890ULL },	// 5^-179
+	{ 0xcf79cc9db955c2ccULL, 0x7182148d4066eeb4ULL },	// 5^-178
+	{ 0x81ac1fe293d599bfULL, 0xc6f14cd848405530ULL },	// 5^-177
+	{ 0xa21727db38cb002fULL, 0xb8ada00e5a506a7cULL },	// 5^-176
+	{ 0xca9cf1d206fdc03bULL, 0xa6d90811f0e4851cULL },	// 5^-175
+	{ 0xfd442e4688bd304aULL, 0x908f4a166d1da663ULL },	// 5^-174
+	{ 0x9e4a9cec15763e2eULL, 0x9a598e4e043287feULL },	// 5^-173
+	{ 0xc5dd44271ad3cdbaULL, 0x40eff1e1853f29fdULL },	// 5^-172
+	{ 0xf7549530e188c128ULL, 0xd12bee59e68ef47cULL },	// 5^-171
+	{ 0x9a94dd3e8cf578b9ULL, 0x82bb74f8301958ceULL },	// 5^-170
+	{ 0xc13a148e3032d6e7ULL, 0xe36a52363c1faf01ULL },	// 5^-169
+	{ 0xf18899b1bc3f8ca1ULL, 0xdc44e6c3cb279ac1ULL },	// 5^-168
+	{ 0x96f5600f15a7b7e5ULL, 0x29ab103a5ef8c0b9ULL },	// 5^-167
+	{ 0xbcb2b812db11a5deULL, 0x7415d448f6b6f0e7ULL },	// 5^-166
+	{ 0xebdf661791d60f56ULL, 0x111b495b3464ad21ULL },	// 5^-165
+	{ 0x936b9fcebb25c995ULL, 0xcab10dd900beec34ULL },	// 5^-164
+	{ 0xb84687c269ef3bfbULL, 0x3d5d514f40eea742ULL },	// 5^-163
+	{ 0xe65829b3046b0afaULL, 0x0cb4a5a3112a5112ULL },	// 5^-162
+	{ 0x8ff71a0fe2c2e6dcULL, 0x47f0e785eaba72abULL },	// 5^-161
+	{ 0xb3f4e093db73a093ULL, 0x59ed216765690f56ULL },	// 5^-160
+	{ 0xe0f218b8d25088b8ULL, 0x306869c13ec3532cULL },	// 5^-159
+	{ 0x8c974f7383725573ULL, 0x1e414218c73a13fbULL },	// 5^-158
+	{ 0xafbd2350644eeacfULL, 0xe5d1929ef90898faULL },	// 5^-157
+	{ 0xdbac6c247d62a583ULL, 0xdf45f746b74abf39ULL },	// 5^-156
+	{ 0x894bc396ce5da772ULL, 0x6b8bba8c328eb783ULL },	// 5^-155
+	{ 0xab9eb47c81f5114fULL, 0x066ea92f3f326564ULL },	// 5^-154
+	{ 0xd686619ba27255a2ULL, 0xc80a537b0efefebdULL },	// 5^-153
+	{ 0x8613fd0145877585ULL, 0xbd06742ce95f5f36ULL },	// 5^-152
+	{ 0xa798fc4196e952e7ULL, 0x2c48113823b73704ULL },	// 5^-151
+	{ 0xd17f3b51fca3a7a0ULL, 0xf75a15862ca504c5ULL },	// 5^-150
+	{ 0x82ef85133de648c4ULL, 0x9a984d73dbe722fbULL },	// 5^-149
+	{ 0xa3ab66580d5fdaf5ULL, 0xc13e60d0d2e0ebbaULL },	// 5^-148
+	{ 0xcc963fee10b7d1b3ULL, 0x318df905079926a8ULL },	// 5^-147
+	{ 0xffbbcfe994e5c61fULL, 0xfdf17746497f7052ULL },	// 5^-146
+	{ 0x9fd561f1fd0f9bd3ULL, 0xfeb6ea8bedefa633ULL },	// 5^-145
+	{ 0xc7caba6e7c5382c8ULL, 0xfe64a52ee96b8fc0ULL },	// 5^-144
+	{ 0xf9bd690a1b68637bULL, 0x3dfdce7aa3c673b0ULL },	// 5^-143
+	{ 0x9c1661a651213e2dULL, 0x06bea10ca65c084eULL },	// 5^-142
+	{ 0xc31bfa0fe5698db8ULL, 0x486e494fcff30a62ULL },	// 5^-141
+	{ 0xf3e2f893dec3f126ULL, 0x5a89dba3c3efccfaULL },	// 5^-140
+	{ 0x986ddb5c6b3a76b7ULL, 0xf89629465a75e01cULL },	// 5^-139
+	{ 0xbe89523386091465ULL, 0xf6bbb397f1135823ULL },	// 5^-138
+	{ 0xee2ba6c0678b597fULL, 0x746aa07ded582e2cULL },	// 5^-137
+	{ 0x94db483840b717efULL, 0xa8c2a44eb4571cdcULL },	// 5^-136
+	{ 0xba121a4650e4ddebULL, 0x92f34d62616ce413ULL },	// 5^-135
+	{ 0xe896a0d7e51e1566ULL, 0x77b020baf9c81d17ULL },	// 5^-134
+	{ 0x915e2486ef32cd60ULL, 0x0ace1474dc1d122eULL },	// 5^-133
+	{ 0xb5b5ada8aaff80b8ULL, 0x0d819992132456baULL },	// 5^-132
+	{ 0xe3231912d5bf60e6ULL, 0x10e1fff697ed6c69ULL },	// 5^-131
+	{ 0x8df5efabc5979c8fULL, 0xca8d3ffa1ef463c1ULL },	// 5^-130
+	{ 0xb1736b96b6fd83b3ULL, 0xbd308ff8a6b17cb2ULL },	// 5^-129
+	{ 0xddd0467c64bce4a0ULL, 0xac7cb3f6d05ddbdeULL },	// 5^-128
+	{ 0x8aa22c0dbef60ee4ULL, 0x6bcdf07a423aa96bULL },	// 5^-127
+	{ 0xad4ab7112eb3929dULL, 0x86c16c98d2c953c6ULL },	// 5^-126
+	{ 0xd89d64d57a607744ULL, 0xe871c7bf077ba8b7ULL },	// 5^-125
+	{ 0x87625f056c7c4a8bULL, 0x11471cd764ad4972ULL },	// 5^-124
+	{ 0xa93af6c6c79b5d2dULL, 0xd598e40d3dd89bcfULL },	// 5^-123
+	{ 0xd389b47879823479ULL, 0x4aff1d108d4ec2c3ULL },	// 5^-122
+	{ 0x843610cb4bf160cbULL, 0xcedf722a585139baULL },	// 5^-121
+	{ 0xa54394fe1eedb8feULL, 0xc2974eb4ee658828ULL },	// 5^-120
+	{ 0xce947a3da6a9273eULL, 0x733d226229feea32ULL },	// 5^-119
+	{ 0x811ccc668829b887ULL, 0x0806357d5a3f525fULL },	// 5^-118
+	{ 0xa163ff802a3426a8ULL, 0xca07c2dcb0cf26f7ULL },	// 5^-117
+	{ 0xc9bcff6034c13052ULL, 0xfc89b393dd02f0b5ULL },	// 5^-116
+	{ 0xfc2c3f3841f17c67ULL, 0xbbac2078d443ace2ULL },	// 5^-115
+	{ 0x9d9ba7832936edc0ULL, 0xd54b944b84aa4c0dULL },	// 5^-114
+	{ 0xc5029163f384a931ULL, 0x0a9e795e65d4df11ULL },	// 5^-113
+	{ 0xf64335bcf065d37dULL, 0x4d4617b5ff4a16d5ULL },	// 5^-112
+	{ 0x99ea0196163fa42eULL, 0x504bced1bf8e4e45ULL },	// 5^-111
+	{ 0xc06481fb9bcf8d39ULL, 0xe45ec2862f71e1d6ULL },	// 5^-110
+	{ 0xf07da27a82c37088ULL, 0x5d767327bb4e5a4cULL },	// 5^-109
+	{ 0x964e858c91ba2655ULL, 0x3a6a07f8d510f86fULL },	// 5^-108
+	{ 0xbbe226efb628afeaULL, 0x890489f70a55368bULL },	// 5^-107
+	{ 0xeadab0aba3b2dbe5ULL, 0x2b45ac74ccea842eULL },	// 5^-106
+	{ 0x92c8ae6b464fc96fULL, 0x3b0b8bc90012929dULL },	// 5^-105
+	{ 0xb77ada0617e3bbcbULL, 0x09ce6ebb40173744ULL },	// 5^-104
+	{ 0xe55990879ddcaabdULL, 0xcc420a6a101d0515ULL },	// 5^-103
+	{ 0x8f57fa54c2a9eab6ULL, 0x9fa946824a12232dULL },	// 5^-102
+	{ 0xb32df8e9f3546564ULL, 0x47939822dc96abf9ULL },	// 5^-101
+	{ 0xdff9772470297ebdULL, 0x59787e2b93bc56f7ULL },	// 5^-100
+	{ 0x8bfbea76c619ef36ULL, 0x57eb4edb3c55b65aULL },	// 5^-99
+	{ 0xaefae51477a06b03ULL, 0xede622920b6b23f1ULL },	// 5^-98
+	{ 0xdab99e59958885c4ULL, 0xe95fab368e45ecedULL },	// 5^-97
+	{ 0x88b402f7fd75539bULL, 0x11dbcb0218ebb414ULL },	// 5^-96
+	{ 0xaae103b5fcd2a881ULL, 0xd652bdc29f26a119ULL },	// 5^-95
+	{ 0xd59944a37c0752a2ULL, 0x4be76d3346f0495fULL },	// 5^-94
+	{ 0x857fcae62d8493a5ULL, 0x6f70a4400c562ddbULL },	// 5^-93
+	{ 0xa6dfbd9fb8e5b88eULL, 0xcb4ccd500f6bb952ULL },	// 5^-92
+	{ 0xd097ad07a71f26b2ULL, 0x7e2000a41346a7a7ULL },	// 5^-91
+	{ 0x825ecc24c873782fULL, 0x8ed400668c0c28c8ULL },	// 5^-90
+	{ 0xa2f67f2dfa90563bULL, 0x728900802f0f32faULL },	// 5^-89
+	{ 0xcbb41ef979346bcaULL, 0x4f2b40a03ad2ffb9ULL },	// 5^-88
+	{ 0xfea126b7d78186bcULL, 0xe2f610c84987bfa8ULL },	// 5^-87
+	{ 0x9f24b832e6b0f436ULL, 0x0dd9ca7d2df4d7c9ULL },	// 5^-86
+	{ 0xc6ede63fa05d3143ULL, 0x91503d1c79720dbbULL },	// 5^-85
+	{ 0xf8a95fcf88747d94ULL, 0x75a44c6397ce912aULL },	// 5^-84
+	{ 0x9b69dbe1b548ce7cULL, 0xc986afbe3ee11abaULL },	// 5^-83
+	{ 0xc24452da229b021bULL, 0xfbe85badce996168ULL },	// 5^-82
+	{ 0xf2d56790ab41c2a2ULL, 0xfae27299423fb9c3ULL },	// 5^-81
+	{ 0x97c560ba6b0919a5ULL, 0xdccd879fc967d41aULL },	// 5^-80
+	{ 0xbdb6b8e905cb600fULL, 0x5400e987bbc1c920ULL },	// 5^-79
+	{ 0xed246723473e3813ULL, 0x290123e9aab23b68ULL },	// 5^-78
+	{ 0x9436c0760c86e30bULL, 0xf9a0b6720aaf6521ULL },	// 5^-77
+	{ 0xb94470938fa89bceULL, 0xf808e40e8d5b3e69ULL },	// 5^-76
+	{ 0xe7958cb87392c2c2ULL, 0xb60b1d1230b20e04ULL },	// 5^-75
+	{ 0x90bd77f3483bb9b9ULL, 0xb1c6f22b5e6f48c2ULL },	// 5^-74
+	{ 0xb4ecd5f01a4aa828ULL, 0x1e38aeb6360b1af3ULL },	// 5^-73
+	{ 0xe2280b6c20dd5232ULL, 0x25c6da63c38de1b0ULL },	// 5^-72
+	{ 0x8d590723948a535fULL, 0x579c487e5a38ad0eULL },	// 5^-71
+	{ 0xb0af48ec79ace837ULL, 0x2d835a9df0c6d851ULL },	// 5^-70
+	{ 0xdcdb1b2798182244ULL, 0xf8e431456cf88e65ULL },	// 5^-69
+	{ 0x8a08f0f8bf0f156bULL, 0x1b8e9ecb641b58ffULL },	// 5^-68
+	{ 0xac8b2d36eed2dac5ULL, 0xe272467e3d222f3fULL },	// 5^-67
+	{ 0xd7adf884aa879177ULL, 0x5b0ed81dcc6abb0fULL },	// 5^-66
+	{ 0x86ccbb52ea94baeaULL, 0x98e947129fc2b4e9ULL },	// 5^-65
+	{ 0xa87fea27a539e9a5ULL, 0x3f2398d747b36224ULL },	// 5^-64
+	{ 0xd29fe4b18e88640eULL, 0x8eec7f0d19a03aadULL },	// 5^-63
+	{ 0x83a3eeeef9153e89ULL, 0x1953cf68300424acULL },	// 5^-62
+	{ 0xa48ceaaab75a8e2bULL, 0x5fa8c3423c052dd7ULL },	// 5^-61
+	{ 0xcdb02555653131b6ULL, 0x3792f412cb06794dULL },	// 5^-60
+	{ 0x808e17555f3ebf11ULL, 0xe2bbd88bbee40bd0ULL },	// 5^-59
+	{ 0xa0b19d2ab70e6ed6ULL, 0x5b6aceaeae9d0ec4ULL },	// 5^-58
+	{ 0xc8de047564d20a8bULL, 0xf245825a5a445275ULL },	// 5^-57
+	{ 0xfb158592be068d2eULL, 0xeed6e2f0f0d56712ULL },	// 5^-56
+	{ 0x9ced737bb6c4183dULL, 0x55464dd69685606bULL },	// 5^-55
+	{ 0xc428d05aa4751e4cULL, 0xaa97e14c3c26b886ULL },	// 5^-54
+	{ 0xf53304714d9265dfULL, 0xd53dd99f4b3066a8ULL },	// 5^-53
+	{ 0x993fe2c6d07b7fabULL, 0xe546a8038efe4029ULL },	// 5^-52
+	{ 0xbf8fdb78849a5f96ULL, 0xde98520472bdd033ULL },	// 5^-51
+	{ 0xef73d256a5c0f77cULL, 0x963e66858f6d4440ULL },	// 5^-50
+	{ 0x95a8637627989aadULL, 0xdde7001379a44aa8ULL },	// 5^-49
+	{ 0xbb127c53b17ec159ULL, 0x5560c018580d5d52ULL },	// 5^-48
+	{ 0xe9d71b689dde71afULL, 0xaab8f01e6e10b4a6ULL },	// 5^-47
+	{ 0x9226712162ab070dULL, 0xcab3961304ca70e8ULL },	// 5^-46
+	{ 0xb6b00d69bb55c8d1ULL, 0x3d607b97c5fd0d22ULL },	// 5^-45
+	{ 0xe45c10c42a2b3b05ULL, 0x8cb89a7db77c506aULL },	// 5^-44
+	{ 0x8eb98a7a9a5b04e3ULL, 0x77f3608e92adb242ULL },	// 5^-43
+	{ 0xb267ed1940f1c61cULL, 0x55f038b237591ed3ULL },	// 5^-42
+	{ 0xdf01e85f912e37a3ULL, 0x6b6c46dec52f6688ULL },	// 5^-41
+	{ 0x8b61313bbabce2c6ULL, 0x2323ac4b3b3da015ULL },	// 5^-40
+	{ 0xae397d8aa96c1b77ULL, 0xabec975e0a0d081aULL },	// 5^-39
+	{ 0xd9c7dced53c72255ULL, 0x96e7bd358c904a21ULL },	// 5^-38
+	{ 0x881cea14545c7575ULL, 0x7e50d64177da2e54ULL },	// 5^-37
+	{ 0xaa242499697392d2ULL, 0xdde50bd1d5d0b9e9ULL },	// 5^-36
+	{ 0xd4ad2dbfc3d07787ULL, 0x955e4ec64b44e864ULL },	// 5^-35
+	{ 0x84ec3c97da624ab4ULL, 0xbd5af13bef0b113eULL },	// 5^-34
+	{ 0xa6274bbdd0fadd61ULL, 0xecb1ad8aeacdd58eULL },	// 5^-33
+	{ 0xcfb11ead453994baULL, 0x67de18eda5814af2ULL },	// 5^-32
+	{ 0x81ceb32c4b43fcf4ULL, 0x80eacf948770ced7ULL },	// 5^-31
+	{ 0xa2425ff75e14fc31ULL, 0xa1258379a94d028dULL },	// 5^-30
+	{ 0xcad2f7f5359a3b3eULL, 0x096ee45813a04330ULL },	// 5^-29
+	{ 0xfd87b5f28300ca0dULL, 0x8bca9d6e188853fcULL },	// 5^-28
+	{ 0x9e74d1b791e07e48ULL, 0x775ea264cf55347eULL },	// 5^-27
+	{ 0xc612062576589ddaULL, 0x95364afe032a819eULL },	// 5^-26
+	{ 0xf79687aed3eec551ULL, 0x3a83ddbd83f52205ULL },	// 5^-25
+	{ 0x9abe14cd44753b52ULL, 0xc4926a9672793543ULL },	// 5^-24
+	{ 0xc16d9a0095928a27ULL, 0x75b7053c0f178294ULL },	// 5^-23
+	{ 0xf1c90080baf72cb1ULL, 0x5324c68b12dd6339ULL },	// 5^-22
+	{ 0x971da05074da7beeULL, 0xd3f6fc16ebca5e04ULL },	// 5^-21
+	{ 0xbce5086492111aeaULL, 0x88f4bb1ca6bcf585ULL },	// 5^-20
+	{ 0xec1e4a7db69561a5ULL, 0x2b31e9e3d06c32e6ULL },	// 5^-19
+	{ 0x9392ee8e921d5d07ULL, 0x3aff322e62439fd0ULL },	// 5^-18
+	{ 0xb877aa3236a4b449ULL, 0x09befeb9fad487c3ULL },	// 5^-17
+	{ 0xe69594bec44de15bULL, 0x4c2ebe687989a9b4ULL },	// 5^-16
+	{ 0x901d7cf73ab0acd9ULL, 0x0f9d37014bf60a11ULL },	// 5^-15
+	{ 0xb424dc35095cd80fULL, 0x538484c19ef38c95ULL },	// 5^-14
+	{ 0xe12e13424bb40e13ULL, 0x2865a5f206b06fbaULL },	// 5^-13
+	{ 0x8cbccc096f5088cbULL, 0xf93f87b7442e45d4ULL },	// 5^-12
+	{ 0xafebff0bcb24aafeULL, 0xf78f69a51539d749ULL },	// 5^-11
+	{ 0xdbe6fecebdedd5beULL, 0xb573440e5a884d1cULL },	// 5^-10
+	{ 0x89705f4136b4a597ULL, 0x31680a88f8953031ULL },	// 5^-9
+	{ 0xabcc77118461cefcULL, 0xfdc20d2b36ba7c3eULL },	// 5^-8
+	{ 0xd6bf94d5e57a42bcULL, 0x3d32907604691b4dULL },	// 5^-7
+	{ 0x8637bd05af6c69b5ULL, 0xa63f9a49c2c1b110ULL },	// 5^-6
+	{ 0xa7c5ac471b478423ULL, 0x0fcf80dc33721d54ULL },	// 5^-5
+	{ 0xd1b71758e219652bULL, 0xd3c36113404ea4a9ULL },	// 5^-4
+	{ 0x83126e978d4fdf3bULL, 0x645a1cac083126eaULL },	// 5^-3
+	{ 0xa3d70a3d70a3d70aULL, 0x3d70a3d70a3d70a4ULL },	// 5^-2
+	{ 0xccccccccccccccccULL, 0xcccccccccccccccdULL },	// 5^-1
+	{ 0x8000000000000000ULL, 0x0000000000000000ULL },	// 5^0
+	{ 0xa000000000000000ULL, 0x0000000000000000ULL },	// 5^1
+	{ 0xc800000000000000ULL, 0x0000000000000000ULL },	// 5^2
+	{ 0xfa00000000000000ULL, 0x0000000000000000ULL },	// 5^3
+	{ 0x9c40000000000000ULL, 0x0000000000000000ULL },	// 5^4
+	{ 0xc350000000000000ULL, 0x0000000000000000ULL },	// 5^5
+	{ 0xf424000000000000ULL, 0x0000000000000000ULL },	// 5^6
+	{ 0x9896800000000000ULL, 0x0000000000000000ULL },	// 5^7
+	{ 0xbebc200000000000ULL, 0x0000000000000000ULL },	// 5^8
+	{ 0xee6b280000000000ULL, 0x0000000000000000ULL },	// 5^9
+	{ 0x9502f90000000000ULL, 0x0000000000000000ULL },	// 5^10
+	{ 0xba43b74000000000ULL, 0x0000000000000000ULL },	// 5^11
+	{ 0xe8d4a51000000000ULL, 0x0000000000000000ULL },	// 5^12
+	{ 0x9184e72a00000000ULL, 0x0000000000000000ULL },	// 5^13
+	{ 0xb5e620f480000000ULL, 0x0000000000000000ULL },	// 5^14
+	{ 0xe35fa931a0000000ULL, 0x0000000000000000ULL },	// 5^15
+	{ 0x8e1bc9bf04000000ULL, 0x0000000000000000ULL },	// 5^16
+	{ 0xb1a2bc2ec5000000ULL, 0x0000000000000000ULL },	// 5^17
+	{ 0xde0b6b3a76400000ULL, 0x0000000000000000ULL },	// 5^18
+	{ 0x8ac7230489e80000ULL, 0x0000000000000000ULL },	// 5^19
+	{ 0xad78ebc5ac620000ULL, 0x0000000000000000ULL },	// 5^20
+	{ 0xd8d726b7177a8000ULL, 0x0000000000000000ULL },	// 5^21
+	{ 0x878678326eac9000ULL, 0x0000000000000000ULL },	// 5^22
+	{ 0xa968163f0a57b400ULL, 0x0000000000000000ULL },	// 5^23
+	{ 0xd3c21bcecceda100ULL, 0x0000000000000000ULL },	// 5^24
+	{ 0x84595161401484a0ULL, 0x0000000000000000ULL },	// 5^25
+	{ 0xa56fa5b99019a5c8ULL, 0x0000000000000000ULL },	// 5^26
+	{ 0xcecb8f27f4200f3aULL, 0x0000000000000000ULL },	// 5^27
+	{ 0x813f3978f8940984ULL, 0x4000000000000000ULL },	// 5^28
+	{ 0xa18f07d736b90be5ULL, 0x5000000000000000ULL },	// 5^29
+	{ 0xc9f2c9cd04674edeULL, 0xa400000000000000ULL },	// 5^30
+	{ 0xfc6f7c4045812296ULL, 0x4d00000000000000ULL },	// 5^31
+	{ 0x9dc5ada82b70b59dULL, 0xf020000000000000ULL },	// 5^32
+	{ 0xc5371912364ce305ULL, 0x6c28000000000000ULL },	// 5^33
+	{ 0xf684df56c3e01bc6ULL, 0xc732000000000000ULL },	// 5^34
+	{ 0x9a130b963a6c115cULL, 0x3c7f400000000000ULL },	// 5^35
+	{ 0xc097ce7bc90715b3ULL, 0x4b9f100000000000ULL },	// 5^36
+	{ 0xf0bdc21abb48db20ULL, 0x1e86d40000000000ULL },	// 5^37
+	{ 0x96769950b50d88f4ULL, 0x1314448000000000ULL },	// 5^38
+	{ 0xbc143fa4e250eb31ULL, 0x17d955a000000000ULL },	// 5^39
+	{ 0xeb194f8e1ae525fdULL, 0x5dcfab0800000000ULL },	// 5^40
+	{ 0x92efd1b8d0cf37beULL, 0x5aa1cae500000000ULL },	// 5^41
+	{ 0xb7abc627050305adULL, 0xf14a3d9e40000000ULL },	// 5^42
+	{ 0xe596b7b0c643c719ULL, 0x6d9ccd05d0000000ULL },	// 5^43
+	{ 0x8f7e32ce7bea5c6fULL, 0xe4820023a2000000ULL },	// 5^44
+	{ 0xb35dbf821ae4f38bULL, 0xdda2802c8a800000ULL },	// 5^45
+	{ 0xe0352f62a19e306eULL, 0xd50b2037ad200000ULL },	// 5^46
+	{ 0x8c213d9da502de45ULL, 0x4526f422cc340000ULL },	// 5^47
+	{ 0xaf298d050e4395d6ULL, 0x9670b12b7f410000ULL },	// 5^48
+	{ 0xdaf3f04651d47b4cULL, 0x3c0cdd765f114000ULL },	// 5^49
+	{ 0x88d8762bf324cd0fULL, 0xa5880a69fb6ac800ULL },	// 5^50
+	{ 0xab0e93b6efee0053ULL, 0x8eea0d047a457a00ULL },	// 5^51
+	{ 0xd5d238a4abe98068ULL, 0x72a4904598d6d880ULL },	// 5^52
+	{ 0x85a36366eb71f041ULL, 0x47a6da2b7f864750ULL },	// 5^53
+	{ 0xa70c3c40a64e6c51ULL, 0x999090b65f67d924ULL },	// 5^54
+	{ 0xd0cf4b50cfe20765ULL, 0xfff4b4e3f741cf6dULL },	// 5^55
+	{ 0x82818f1281ed449fULL, 0xbff8f10e7a8921a4ULL },	// 5^56
+	{ 0xa321f2d7226895c7ULL, 0xaff72d52192b6a0dULL },	// 5^57
+	{ 0xcbea6f8ceb02bb39ULL, 0x9bf4f8a69f764490ULL },	// 5^58
+	{ 0xfee50b7025c36a08ULL, 0x02f236d04753d5b4ULL },	// 5^59
+	{ 0x9f4f2726179a2245ULL, 0x01d762422c946590ULL },	// 5^60
+	{ 0xc722f0ef9d80aad6ULL, 0x424d3ad2b7b97ef5ULL },	// 5^61
+	{ 0xf8ebad2b84e0d58bULL, 0xd2e0898765a7deb2ULL },	// 5^62
+	{ 0x9b934c3b330c8577ULL, 0x63cc55f49f88eb2fULL },	// 5^63
+	{ 0xc2781f49ffcfa6d5ULL, 0x3cbf6b71c76b25fbULL },	// 5^64
+	{ 0xf316271c7fc3908aULL, 0x8bef464e3945ef7aULL },	// 5^65
+	{ 0x97edd871cfda3a56ULL, 0x97758bf0e3cbb5acULL },	// 5^66
+	{ 0xbde94e8e43d0c8ecULL, 0x3d52eeed1cbea317ULL },	// 5^67
+	{ 0xed63a231d4c4fb27ULL, 0x4ca7aaa863ee4bddULL },	// 5^68
+	{ 0x945e455f24fb1cf8ULL, 0x8fe8caa93e74ef6aULL },	// 5^69
+	{ 0xb975d6b6ee39e436ULL, 0xb3e2fd538e122b44ULL },	// 5^70
+	{ 0xe7d34c64a9c85d44ULL, 0x60dbbca87196b616ULL },	// 5^71
+	{ 0x90e40fbeea1d3a4aULL, 0xbc8955e946fe31cdULL },	// 5^72
+	{ 0xb51d13aea4a488ddULL, 0x6babab6398bdbe41ULL },	// 5^73
+	{ 0xe264589a4dcdab14ULL, 0xc696963c7eed2dd1ULL },	// 5^74
+	{ 0x8d7eb76070a08aecULL, 0xfc1e1de5cf543ca2ULL },	// 5^75
+	{ 0xb0de65388cc8ada8ULL, 0x3b25a55f43294bcbULL },	// 5^76
+	{ 0xdd15fe86affad912ULL, 0x49ef0eb713f39ebeULL },	// 5^77
+	{ 0x8a2dbf142dfcc7abULL, 0x6e3569326c784337ULL },	// 5^78
+	{ 0xacb92ed9397bf996ULL, 0x49c2c37f07965404ULL },	// 5^79
+	{ 0xd7e77a8f87daf7fbULL, 0xdc33745ec97be906ULL },	// 5^80
+	{ 0x86f0ac99b4e8dafdULL, 0x69a028bb3ded71a3ULL },	// 5^81
+	{ 0xa8acd7c0222311bcULL, 0xc40832ea0d68ce0cULL },	// 5^82
+	{ 0xd2d80db02aabd62bULL, 0xf50a3fa490c30190ULL },	// 5^83
+	{ 0x83c7088e1aab65dbULL, 0x792667c6da79e0faULL },	// 5^84
+	{ 0xa4b8cab1a1563f52ULL, 0x577001b891185938ULL },	// 5^85
+	{ 0xcde6fd5e09abcf26ULL, 0xed4c0226b55e6f86ULL },	// 5^86
+	{ 0x80b05e5ac60b6178ULL, 0x544f8158315b05b4ULL },	// 5^87
+	{ 0xa0dc75f1778e39d6ULL, 0x696361ae3db1c721ULL },	// 5^88
+	{ 0xc913936dd571c84cULL, 0x03bc3a19cd1e38e9ULL },	// 5^89
+	{ 0xfb5878494ace3a5fULL, 0x04ab48a04065c723ULL },	// 5^90
+	{ 0x9d174b2dcec0e47bULL, 0x62eb0d64283f9c76ULL },	// 5^91
+	{ 0xc45d1df942711d9aULL, 0x3ba5d0bd324f8394ULL },	// 5^92
+	{ 0xf5746577930d6500ULL, 0xca8f44ec7ee36479ULL },	// 5^93
+	{ 0x9968bf6abbe85f20ULL, 0x7e998b13cf4e1ecbULL },	// 5^94
+	{ 0xbfc2ef456ae276e8ULL, 0x9e3fedd8c321a67eULL },	// 5^95
+	{ 0xefb3ab16c59b14a2ULL, 0xc5cfe94ef3ea101eULL },	// 5^96
+	{ 0x95d04aee3b80ece5ULL, 0xbba1f1d158724a12ULL },	// 5^97
+	{ 0xbb445da9ca61281fULL, 0x2a8a6e45ae8edc97ULL },	// 5^98
+	{ 0xea1575143cf97226ULL, 0xf52d09d71a3293bdULL },	// 5^99
+	{ 0x924d692ca61be758ULL, 0x593c2626705f9c56ULL },	// 5^100
+	{ 0xb6e0c377cfa2e12eULL, 0x6f8b2fb00c77836cULL },	// 5^101
+	{ 0xe498f455c38b997aULL, 0x0b6dfb9c0f956447ULL },	// 5^102
+	{ 0x8edf98b59a373fecULL, 0x4724bd4189bd5eacULL },	// 5^103
+	{ 0xb2977ee300c50fe7ULL, 0x58edec91ec2cb657ULL },	// 5^104
+	{ 0xdf3d5e9bc0f653e1ULL, 0x2f2967b66737e3edULL },	// 5^105
+	{ 0x8b865b215899f46cULL, 0xbd79e0d20082ee74ULL },	// 5^106
+	{ 0xae67f1e9aec07187ULL, 0xecd8590680a3aa11ULL },	// 5^107
+	{ 0xda01ee641a708de9ULL, 0xe80e6f4820cc9495ULL },	// 5^108
+	{ 0x884134fe908658b2ULL, 0x3109058d147fdcddULL },	// 5^109
+	{ 0xaa51823e34a7eedeULL, 0xbd4b46f0599fd415ULL },	// 5^110
+	{ 0xd4e5e2cdc1d1ea96ULL, 0x6c9e18ac7007c91aULL },	// 5^111
+	{ 0x850fadc09923329eULL, 0x03e2cf6bc604ddb0ULL },	// 5^112
+	{ 0xa6539930bf6bff45ULL, 0x84db8346b786151cULL },	// 5^113
+	{ 0xcfe87f7cef46ff16ULL, 0xe612641865679a63ULL },	// 5^114
+	{ 0x81f14fae158c5f6eULL, 0x4fcb7e8f3f60c07eULL },	// 5^115
+	{ 0xa26da3999aef7749ULL, 0xe3be5e330f38f09dULL },	// 5^116
+	{ 0xcb090c8001ab551cULL, 0x5cadf5bfd3072cc5ULL },	// 5^117
+	{ 0xfdcb4fa002162a63ULL, 0x73d9732fc7c8f7f6ULL },	// 5^118
+	{ 0x9e9f11c4014dda7eULL, 0x2867e7fddcdd9afaULL },	// 5^119
+	{ 0xc646d63501a1511dULL, 0xb281e1fd541501b8ULL },	// 5^120
+	{ 0xf7d88bc24209a565ULL, 0x1f225a7ca91a4226ULL },	// 5^121
+	{ 0x9ae757596946075fULL, 0x3375788de9b06958ULL },	// 5^122
+	{ 0xc1a12d2fc3978937ULL, 0x0052d6b1641c83aeULL },	// 5^123
+	{ 0xf209787bb47d6b84ULL, 0xc0678c5dbd23a49aULL },	// 5^124
+	{ 0x9745eb4d50ce6332ULL, 0xf840b7ba963646e0ULL },	// 5^125
+	{ 0xbd176620a501fbffULL, 0xb650e5a93bc3d898ULL },	// 5^126
+	{ 0xec5d3fa8ce427affULL, 0xa3e51f138ab4cebeULL },	// 5^127
+	{ 0x93ba47c980e98cdfULL, 0xc66f336c36b10137ULL },	// 5^128
+	{ 0xb8a8d9bbe123f017ULL, 0xb80b0047445d4184ULL },	// 5^129
+	{ 0xe6d3102ad96cec1dULL, 0xa60dc059157491e5ULL },	// 5^130
+	{ 0x9043ea1ac7e41392ULL, 0x87c89837ad68db2fULL },	// 5^131
+	{ 0xb454e4a179dd1877ULL, 0x29babe4598c311fbULL },	// 5^132
+	{ 0xe16a1dc9d8545e94ULL, 0xf4296dd6fef3d67aULL },	// 5^133
+	{ 0x8ce2529e2734bb1dULL, 0x1899e4a65f58660cULL },	// 5^134
+	{ 0xb01ae745b101e9e4ULL, 0x5ec05dcff72e7f8fULL },	// 5^135
+	{ 0xdc21a1171d42645dULL, 0x76707543f4fa1f73ULL },	// 5^136
+	{ 0x899504ae72497ebaULL, 0x6a06494a791c53a8ULL },	// 5^137
+	{ 0xabfa45da0edbde69ULL, 0x0487db9d17636892ULL },	// 5^138
+	{ 0xd6f8d7509292d603ULL, 0x45a9d2845d3c42b6ULL },	// 5^139
+	{ 0x865b86925b9bc5c2ULL, 0x0b8a2392ba45a9b2ULL },	// 5^140
+	{ 0xa7f26836f282b732ULL, 0x8e6cac7768d7141eULL },	// 5^141
+	{ 0xd1ef0244af2364ffULL, 0x3207d795430cd926ULL },	// 5^142
+	{ 0x8335616aed761f1fULL, 0x7f44e6bd49e807b8ULL },	// 5^143
+	{ 0xa402b9c5a8d3a6e7ULL, 0x5f16206c9c6209a6ULL },	// 5^144
+	{ 0xcd036837130890a1ULL, 0x36dba887c37a8c0fULL },	// 5^145
+	{ 0x802221226be55a64ULL, 0xc2494954da2c9789ULL },	// 5^146
+	{ 0xa02aa96b06deb0fdULL, 0xf2db9baa10b7bd6cULL },	// 5^147
+	{ 0xc83553c5c8965d3dULL, 0x6f92829494e5acc7ULL },	// 5^148
+	{ 0xfa42a8b73abbf48cULL, 0xcb772339ba1f17f9ULL },	// 5^149
+	{ 0x9c69a97284b578d7ULL, 0xff2a760414536efbULL },	// 5^150
+	{ 0xc38413cf25e2d70dULL, 0xfef5138519684abaULL },	// 5^151
+	{ 0xf46518c2ef5b8cd1ULL, 0x7eb258665fc25d69ULL },	// 5^152
+	{ 0x98bf2f79d5993802ULL, 0xef2f773ffbd97a61ULL },	// 5^153
+	{ 0xbeeefb584aff8603ULL, 0xaafb550ffacfd8faULL },	// 5^154
+	{ 0xeeaaba2e5dbf6784ULL, 0x95ba2a53f983cf38ULL },	// 5^155
+	{ 0x952ab45cfa97a0b2ULL, 0xdd945a747bf26183ULL },	// 5^156
+	{ 0xba756174393d88dfULL, 0x94f971119aeef9e4ULL },	// 5^157
+	{ 0xe912b9d1478ceb17ULL, 0x7a37cd5601aab85dULL },	// 5^158
+	{ 0x91abb422ccb812eeULL, 0xac62e055c10ab33aULL },	// 5^159
+	{ 0xb616a12b7fe617aaULL, 0x577b986b314d6009ULL },	// 5^160
+	{ 0xe39c49765fdf9d94ULL, 0xed5a7e85fda0b80bULL },	// 5^161
+	{ 0x8e41ade9fbebc27dULL, 0x14588f13be847307ULL },	// 5^162
+	{ 0xb1d219647ae6b31cULL, 0x596eb2d8ae258fc8ULL },	// 5^163
+	{ 0xde469fbd99a05fe3ULL, 0x6fca5f8ed9aef3bbULL },	// 5^164
+	{ 0x8aec23d680043beeULL, 0x25de7bb9480d5854ULL },	// 5^165
+	{ 0xada72ccc20054ae9ULL, 0xaf561aa79a10ae6aULL },	// 5^166
+	{ 0xd910f7ff28069da4ULL, 0x1b2ba1518094da04ULL },	// 5^167
+	{ 0x87aa9aff79042286ULL, 0x90fb44d2f05d0842ULL },	// 5^168
+	{ 0xa99541bf57452b28ULL, 0x353a1607ac744a53ULL },	// 5^169
+	{ 0xd3fa922f2d1675f2ULL, 0x42889b8997915ce8ULL },	// 5^170
+	{ 0x847c9b5d7c2e09b7ULL, 0x69956135febada11ULL },	// 5^171
+	{ 0xa59bc234db398c25ULL, 0x43fab9837e699095ULL },	// 5^172
+	{ 0xcf02b2c21207ef2eULL, 0x94f967e45e03f4bbULL },	// 5^173
+	{ 0x8161afb94b44f57dULL, 0x1d1be0eebac278f5ULL },	// 5^174
+	{ 0xa1ba1ba79e1632dcULL, 0x6462d92a69731732ULL },	// 5^175
+	{ 0xca28a291859bbf93ULL, 0x7d7b8f7503cfdcfeULL },	// 5^176
+	{ 0xfcb2cb35e702af78ULL, 0x5cda735244c3d43eULL },	// 5^177
+	{ 0x9defbf01b061adabULL, 0x3a0888136afa64a7ULL },	// 5^178
+	{ 0xc56baec21c7a1916ULL, 0x088aaa1845b8fdd0ULL },	// 5^179
+	{ 0xf6c69a72a3989f5bULL, 0x8aad549e57273d45ULL },	// 5^180
+	{ 0x9a3c2087a63f6399ULL, 0x36ac54e2f678864bULL },	// 5^181
+	{ 0xc0cb28a98fcf3c7fULL, 0x84576a1bb416a7ddULL },	// 5^182
+	{ 0xf0fdf2d3f3c30b9fULL, 0x656d44a2a11c51d5ULL },	// 5^183
+	{ 0x969eb7c47859e743ULL, 0x9f644ae5a4b1b325ULL },	// 5^184
+	{ 0xbc4665b596706114ULL, 0x873d5d9f0dde1feeULL },	// 5^185
+	{ 0xeb57ff22fc0c7959ULL, 0xa90cb506d155a7eaULL },	// 5^186
+	{ 0x9316ff75dd87cbd8ULL, 0x09a7f12442d588f2ULL },	// 5^187
+	{ 0xb7dcbf5354e9beceULL, 0x0c11ed6d538aeb2fULL },	// 5^188
+	{ 0xe5d3ef282a242e81ULL, 0x8f1668c8a86da5faULL },	// 5^189
+	{ 0x8fa475791a569d10ULL, 0xf96e017d694487bcULL },	// 5^190
+	{ 0xb38d92d760ec4455ULL, 0x37c981dcc395a9acULL },	// 5^191
+	{ 0xe070f78d3927556aULL, 0x85bbe253f47b1417ULL },	// 5^192
+	{ 0x8c469ab843b89562ULL, 0x93956d7478ccec8eULL },	// 5^193
+	{ 0xaf58416654a6babbULL, 0x387ac8d1970027b2ULL },	// 5^194
+	{ 0xdb2e51bfe9d0696aULL, 0x06997b05fcc0319eULL },	// 5^195
+	{ 0x88fcf317f22241e2ULL, 0x441fece3bdf81f03ULL },	// 5^196
+	{ 0xab3c2fddeeaad25aULL, 0xd527e81cad7626c3ULL },	// 5^197
+	{ 0xd60b3bd56a5586f1ULL, 0x8a71e223d8d3b074ULL },	// 5^198
+	{ 0x85c7056562757456ULL, 0xf6872d5667844e49ULL },	// 5^199
+	{ 0xa738c6bebb12d16cULL, 0xb428f8ac016561dbULL },	// 5^200
+	{ 0xd106f86e69d785c7ULL, 0xe13336d701beba52ULL },	// 5^201
+	{ 0x82a45b450226b39cULL, 0xecc0024661173473ULL },	// 5^202
+	{ 0xa34d721642b06084ULL, 0x27f002d7f95d0190ULL },	// 5^203
+	{ 0xcc20ce9bd35c78a5ULL, 0x31ec038df7b441f4ULL },	// 5^204
+	{ 0xff290242c83396ceULL, 0x7e67047175a15271ULL },	// 5^205
+	{ 0x9f79a169bd203e41ULL, 0x0f0062c6e984d386ULL },	// 5^206
+	{ 0xc75809c42c684dd1ULL, 0x52c07b78a3e60868ULL },	// 5^207
+	{ 0xf92e0c3537826145ULL, 0xa7709a56ccdf8a82ULL },	// 5^208
+	{ 0x9bbcc7a142b17ccbULL, 0x88a66076400bb691ULL },	// 5^209
+	{ 0xc2abf989935ddbfeULL, 0x6acff893d00ea435ULL },	// 5^210
+	{ 0xf356f7ebf83552feULL, 0x0583f6b8c4124d43ULL },	// 5^211
+	{ 0x98165af37b2153deULL, 0xc3727a337a8b704aULL },	// 5^212
+	{ 0xbe1bf1b059e9a8d6ULL, 0x744f18c0592e4c5cULL },	// 5^213
+	{ 0xeda2ee1c7064130cULL, 0x1162def06f79df73ULL },	// 5^214
+	{ 0x9485d4d1c63e8be7ULL, 0x8addcb5645ac2ba8ULL },	// 5^215
+	{ 0xb9a74a0637ce2ee1ULL, 0x6d953e2bd7173692ULL },	// 5^216
+	{ 0xe8111c87c5c1ba99ULL, 0xc8fa8db6ccdd0437ULL },	// 5^217
+	{ 0x910ab1d4db9914a0ULL, 0x1d9c9892400a22a2ULL },	// 5^218
+	{ 0xb54d5e4a127f59c8ULL, 0x2503beb6d00cab4bULL },	// 5^219
+	{ 0xe2a0b5dc971f303aULL, 0x2e44ae64840fd61dULL },	// 5^220
+	{ 0x8da471a9de737e24ULL, 0x5ceaecfed289e5d2ULL },	// 5^221
+	{ 0xb10d8e1456105dadULL, 0x7425a83e872c5f47ULL },	// 5^222
+	{ 0xdd50f1996b947518ULL, 0xd12f124e28f77719ULL },	// 5^223
+	{ 0x8a5296ffe33cc92fULL, 0x82bd6b70d99aaa6fULL },	// 5^224
+	{ 0xace73cbfdc0bfb7bULL, 0x636cc64d1001550bULL },	// 5^225
+	{ 0xd8210befd30efa5aULL, 0x3c47f7e05401aa4eULL },	// 5^226
+	{ 0x8714a775e3e95c78ULL, 0x65acfaec34810a71ULL },	// 5^227
+	{ 0xa8d9d1535ce3b396ULL, 0x7f1839a741a14d0dULL },	// 5^228
+	{ 0xd31045a8341ca07cULL, 0x1ede48111209a050ULL },	// 5^229
+	{ 0x83ea2b892091e44dULL, 0x934aed0aab460432ULL },	// 5^230
+	{ 0xa4e4b66b68b65d60ULL, 0xf81da84d5617853fULL },	// 5^231
+	{ 0xce1de40642e3f4b9ULL, 0x36251260ab9d668eULL },	// 5^232
+	{ 0x80d2ae83e9ce78f3ULL, 0xc1d72b7c6b426019ULL },	// 5^233
+	{ 0xa1075a24e4421730ULL, 0xb24cf65b8612f81fULL },	// 5^234
+	{ 0xc94930ae1d529cfcULL, 0xdee033f26797b627ULL },	// 5^235
+	{ 0xfb9b7cd9a4a7443cULL, 0x169840ef017da3b1ULL },	// 5^236
+	{ 0x9d412e0806e88aa5ULL, 0x8e1f289560ee864eULL },	// 5^237
+	{ 0xc491798a08a2ad4eULL, 0xf1a6f2bab92a27e2ULL },	// 5^238
+	{ 0xf5b5d7ec8acb58a2ULL, 0xae10af696774b1dbULL },	// 5^239
+	{ 0x9991a6f3d6bf1765ULL, 0xacca6da1e0a8ef29ULL },	// 5^240
+	{ 0xbff610b0cc6edd3fULL, 0x17fd090a58d32af3ULL },	// 5^241
+	{ 0xeff394dcff8a948eULL, 0xddfc4b4cef07f5b0ULL },	// 5^242
+	{ 0x95f83d0a1fb69cd9ULL, 0x4abdaf101564f98eULL },	// 5^243
+	{ 0xbb764c4ca7a4440fULL, 0x9d6d1ad41abe37f1ULL },	// 5^244
+	{ 0xea53df5fd18d5513ULL, 0x84c86189216dc5edULL },	// 5^245
+	{ 0x92746b9be2f8552cULL, 0x32fd3cf5b4e49bb4ULL },	// 5^246
+	{ 0xb7118682dbb66a77ULL, 0x3fbc8c33221dc2a1ULL },	// 5^247
+	{ 0xe4d5e82392a40515ULL, 0x0fabaf3feaa5334aULL },	// 5^248
+	{ 0x8f05b1163ba6832dULL, 0x29cb4d87f2a7400eULL },	// 5^249
+	{ 0xb2c71d5bca9023f8ULL, 0x743e20e9ef511012ULL },	// 5^250
+	{ 0xdf78e4b2bd342cf6ULL, 0x914da9246b255416ULL },	// 5^251
+	{ 0x8bab8eefb6409c1aULL, 0x1ad089b6c2f7548eULL },	// 5^252
+	{ 0xae9672aba3d0c320ULL, 0xa184ac2473b529b1ULL },	// 5^253
+	{ 0xda3c0f568cc4f3e8ULL, 0xc9e5d72d90a2741eULL },	// 5^254
+	{ 0x8865899617fb1871ULL, 0x7e2fa67c7a658892ULL },	// 5^255
+	{ 0xaa7eebfb9df9de8dULL, 0xddbb901b98feeab7ULL },	// 5^256
+	{ 0xd51ea6fa85785631ULL, 0x552a74227f3ea565ULL },	// 5^257
+	{ 0x8533285c936b35deULL, 0xd53a88958f87275fULL },	// 5^258
+	{ 0xa67ff273b8460356ULL, 0x8a892abaf368f137ULL },	// 5^259
+	{ 0xd01fef10a657842cULL, 0x2d2b7569b0432d85ULL },	// 5^260
+	{ 0x8213f56a67f6b29bULL, 0x9c3b29620e29fc73ULL },	// 5^261
+	{ 0xa298f2c501f45f42ULL, 0x8349f3ba91b47b8fULL },	// 5^262
+	{ 0xcb3f2f7642717713ULL, 0x241c70a936219a73ULL },	// 5^263
+	{ 0xfe0efb53d30dd4d7ULL, 0xed238cd383aa0110ULL },	// 5^264
+	{ 0x9ec95d1463e8a506ULL, 0xf4363804324a40aaULL },	// 5^265
+	{ 0xc67bb4597ce2ce48ULL, 0xb143c6053edcd0d5ULL },	// 5^266
+	{ 0xf81aa16fdc1b81daULL, 0xdd94b7868e94050aULL },	// 5^267
+	{ 0x9b10a4e5e9913128ULL, 0xca7cf2b4191c8326ULL },	// 5^268
+	{ 0xc1d4ce1f63f57d72ULL, 0xfd1c2f611f63a3f0ULL },	// 5^269
+	{ 0xf24a01a73cf2dccfULL, 0xbc633b39673c8cecULL },	// 5^270
+	{ 0x976e41088617ca01ULL, 0xd5be0503e085d813ULL },	// 5^271
+	{ 0xbd49d14aa79dbc82ULL, 0x4b2d8644d8a74e18ULL },	// 5^272
+	{ 0xec9c459d51852ba2ULL, 0xddf8e7d60ed1219eULL },	// 5^273
+	{ 0x93e1ab8252f33b45ULL, 0xcabb90e5c942b503ULL },	// 5^274
+	{ 0xb8da1662e7b00a17ULL, 0x3d6a751f3b936243ULL },	// 5^275
+	{ 0xe7109bfba19c0c9dULL, 0x0cc512670a783ad4ULL },	// 5^276
+	{ 0x906a617d450187e2ULL, 0x27fb2b80668b24c5ULL },	// 5^277
+	{ 0xb484f9dc9641e9daULL, 0xb1f9f660802dedf6ULL },	// 5^278
+	{ 0xe1a63853bbd26451ULL, 0x5e7873f8a0396973ULL },	// 5^279
+	{ 0x8d07e33455637eb2ULL, 0xdb0b487b6423e1e8ULL },	// 5^280
+	{ 0xb049dc016abc5e5fULL, 0x91ce1a9a3d2cda62ULL },	// 5^281
+	{ 0xdc5c5301c56b75f7ULL, 0x7641a140cc7810fbULL },	// 5^282
+	{ 0x89b9b3e11b6329baULL, 0xa9e904c87fcb0a9dULL },	// 5^283
+	{ 0xac2820d9623bf429ULL, 0x546345fa9fbdcd44ULL },	// 5^284
+	{ 0xd732290fbacaf133ULL, 0xa97c177947ad4095ULL },	// 5^285
+	{ 0x867f59a9d4bed6c0ULL, 0x49ed8eabcccc485dULL },	// 5^286
+	{ 0xa81f301449ee8c70ULL, 0x5c68f256bfff5a74ULL },	// 5^287
+	{ 0xd226fc195c6a2f8cULL, 0x73832eec6fff3111ULL },	// 5^288
+	{ 0x83585d8fd9c25db7ULL, 0xc831fd53c5ff7eabULL },	// 5^289
+	{ 0xa42e74f3d032f525ULL, 0xba3e7ca8b77f5e55ULL },	// 5^290
+	{ 0xcd3a1230c43fb26fULL, 0x28ce1bd2e55f35ebULL },	// 5^291
+	{ 0x80444b5e7aa7cf85ULL, 0x7980d163cf5b81b3ULL },	// 5^292
+	{ 0xa0555e361951c366ULL, 0xd7e105bcc332621fULL },	// 5^293
+	{ 0xc86ab5c39fa63440ULL, 0x8dd9472bf3fefaa7ULL },	// 5^294
+	{ 0xfa856334878fc150ULL, 0xb14f98f6f0feb951ULL },	// 5^295
+	{ 0x9c935e00d4b9d8d2ULL, 0x6ed1bf9a569f33d3ULL },	// 5^296
+	{ 0xc3b8358109e84f07ULL, 0x0a862f80ec4700c8ULL },	// 5^297
+	{ 0xf4a642e14c6262c8ULL, 0xcd27bb612758c0faULL },	// 5^298
+	{ 0x98e7e9cccfbd7dbdULL, 0x8038d51cb897789cULL },	// 5^299
+	{ 0xbf21e44003acdd2cULL, 0xe0470a63e6bd56c3ULL },	// 5^300
+	{ 0xeeea5d5004981478ULL, 0x1858ccfce06cac74ULL },	// 5^301
+	{ 0x95527a5202df0ccbULL, 0x0f37801e0c43ebc8ULL },	// 5^302
+	{ 0xbaa718e68396cffdULL, 0xd30560258f54e6baULL },	// 5^303
+	{ 0xe950df20247c83fdULL, 0x47c6b82ef32a2069ULL },	// 5^304
+	{ 0x91d28b7416cdd27eULL, 0x4cdc331d57fa5441ULL },	// 5^305
+	{ 0xb6472e511c81471dULL, 0xe0133fe4adf8e952ULL },	// 5^306
+	{ 0xe3d8f9e563a198e5ULL, 0x58180fddd97723a6ULL },	// 5^307
+	{ 0x8e679c2f5e44ff8fULL, 0x570f09eaa7ea7648ULL } 	// 5^308
+};
+#define JSON_POW5_MIN_EXPONENT		-325
+#define JSON_POW5_MAX_EXPONENT		308
 
-	int sign = 1;
-	int nonZeroDigits = 0;
-	int fractionalDigits = 0;
-	int exponentSign = 1;
-	int exponentValue = 0;
-	uint64_t uint64Value = 0;
-	double doubleValue = 0.0;
-	bool uint64Overflowed = false;
+// Eight digits are parsed at once with 64-bit integer arithmetic on little-endian targets.
+#if !defined( JSON_SIMD_DISABLED ) && !( defined( __BYTE_ORDER__ ) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__ )
+	#define JSON_SWAR_DIGITS
+#endif
 
-	if ( buffer[0] == '-' )
+// Parses eight decimal digits at once. Returns false if not all eight characters are decimal digits.
+static bool ksJson_ParseEightDigits( const char * buffer, uint64_t * value )
+{
+#if defined( JSON_SWAR_DIGITS )
+	// The eight characters may extend past the terminating zero, so never read across a page boundary.
+	if ( ( (uintptr_t)buffer & 4095 ) > 4096 - 8 )
 	{
-		sign = -1;
-		buffer++;
+		return false;
 	}
-	else if ( buffer[0] == '+' )
+	uint64_t v;
+	memcpy( &v, buffer, sizeof( v ) );
+	if ( ( ( v + 0x4646464646464646ULL ) | ( v - 0x3030303030303030ULL ) ) & 0x8080808080808080ULL )
 	{
-		sign = 1;
-		buffer++;
+		return false;
 	}
+	v -= 0x3030303030303030ULL;
+	v = ( v * 10 ) + ( v >> 8 );
+	v = ( ( ( v & 0x000000FF000000FFULL ) * 0x000F424000000064ULL ) +
+			( ( ( v >> 16 ) & 0x000000FF000000FFULL ) * 0x0000271000000001ULL ) ) >> 32;
+	*value = (uint32_t)v;
+	return true;
+#else
+	(void)buffer;
+	(void)value;
+	return false;
+#endif
+}
 
-	// Skip leading zeros and parse integer digits.
-	while ( buffer[0] >= '0' && buffer[0] <= '9' )
+// Parses decimal digits and accumulates them in 'value' which silently overflows.
+// Returns a pointer to the first character after the digits.
+static const char * ksJson_ParseDigits( const char * buffer, uint64_t * value )
+{
+	uint64_t v = *value;
+	uint64_t eight;
+	while ( ksJson_ParseEightDigits( buffer, &eight ) )
 	{
-		const char d = ( buffer[0] - '0' );
-		uint64Overflowed |= ( uint64Value > ( UINT64_MAX / 10 ) ) | ( ( uint64Value * 10 ) > UINT64_MAX - d );
-		uint64Value = ( uint64Value * 10 ) + d;
-		doubleValue = ( doubleValue * 10.0 ) + d;
-		nonZeroDigits += ( uint64Value != 0 );
-		buffer++;
+		v = v * 100000000 + eight;
+		buffer += 8;
 	}
-	// Parse fractional digits.
-	if ( buffer[0] == '.' )
+	while ( buffer[0] >= '0' && buffer[0] <= '9' )
 	{
+		v = v * 10 + ( buffer[0] - '0' );
 		buffer++;
-		while ( buffer[0] >= '0' && buffer[0] <= '9' && nonZeroDigits < 17 )
-		{
-			doubleValue = ( doubleValue * 10.0 ) + ( buffer[0] - '0' );
-			nonZeroDigits += ( doubleValue != 0.0 );
-			fractionalDigits++;
-			buffer++;
-		}
-		// Skip the remaining digits.
-		while ( buffer[0] >= '0' && buffer[0] <= '9' )
-		{
-			buffer++;
-		}
 	}
-	// Parse exponent.
-	if ( buffer[0] == 'e' || buffer[0] == 'E' )
-	{
-		buffer++;
-		exponentSign = 1;
-		if ( buffer[0] == '+' )
-		{
-			exponentSign = 1;
-			buffer++;
-		}
-		else if ( buffer[0] == '-' )
-		{
-			exponentSign = -1;
+	*value = v;
+	return buffer;
+}
+
+static uint64_t ksJson_Multiply128( const uint64_t a, const uint64_t b, uint64_t * high )
+{
+#if defined( __SIZEOF_INT128__ )
+	const unsigned __int128 r = (unsigned __int128)a * b;
+	*high = (uint64_t)( r >> 64 );
+	return (uint64_t)r;
+#elif defined( _MSC_VER ) && defined( _M_X64 )
+	return _umul128( a, b, high );
+#elif defined( _MSC_VER ) && defined( _M_ARM64 )
+	*high = __umulh( a, b );
+	return a * b;
+#else
+	const uint64_t a0 = a & 0xFFFFFFFF;
+	const uint64_t a1 = a >> 32;
+	const uint64_t b0 = b & 0xFFFFFFFF;
+	const uint64_t b1 = b >> 32;
+	const uint64_t p00 = a0 * b0;
+	const uint64_t p01 = a0 * b1;
+	const uint64_t p10 = a1 * b0;
+	const uint64_t p11 = a1 * b1;
+	const uint64_t middle = p10 + ( p00 >> 32 ) + ( p01 & 0xFFFFFFFF );
+	*high = p11 + ( middle >> 32 ) + ( p01 >> 32 );
+	return ( middle << 32 ) | ( p00 & 0xFFFFFFFF );
+#endif
+}
+
+static int ksJson_CountLeadingZeros64( const uint64_t value )
+{
+	assert( value != 0 );
+#if defined( _MSC_VER ) && ( defined( _M_X64 ) || defined( _M_ARM64 ) )
+	unsigned long index;
+	_BitScanReverse64( &index, value );
+	return 63 - (int) index;
+#elif defined( __GNUC__ ) || defined( __clang__ )
+	return __builtin_clzll( value );
+#else
+	int count = 0;
+	for ( uint64_t bit = 1ULL << 63; ( value & bit ) == 0; bit >>= 1 )
+	{
+		count++;
+	}
+	return count;
+#endif
+}
+
+// Eisel-Lemire algorithm: "Number Parsing at a Gigabyte per Second" by Daniel Lemire.
+// Computes the correctly rounded double closest to 'mantissa' * 10^'exponent' with 'mantissa' != 0
+// and 'exponent' in the range [JSON_POW5_MIN_EXPONENT, JSON_POW5_MAX_EXPONENT].
+// Returns false in the rare cases where the result cannot be determined with 128-bit precision,
+// when the result is subnormal, or when the result overflows.
+static bool ksJson_EiselLemire( uint64_t mantissa, const int exponent, double * value )
+{
+	assert( mantissa != 0 );
+	assert( exponent >= JSON_POW5_MIN_EXPONENT && exponent <= JSON_POW5_MAX_EXPONENT );
+
+	const uint64_t * pow5 = json_pow5_128[exponent - JSON_POW5_MIN_EXPONENT];
+	const int64_t binaryExponent = ( ( ( 152170 + 65536 ) * (int64_t)exponent ) >> 16 ) + 1024 + 63;
+	int leadingZeros = ksJson_CountLeadingZeros64( mantissa );
+	mantissa <<= leadingZeros;
+
+	uint64_t upper;
+	uint64_t lower = ksJson_Multiply128( mantissa, pow5[0], &upper );
+	if ( ( upper & 0x1FF ) == 0x1FF && lower + mantissa < lower )
+	{
+		// The 64-bit product is not precise enough so also use the lower 64 bits of the power of five.
+		uint64_t middle2;
+		const uint64_t productLow = ksJson_Multiply128( mantissa, pow5[1], &middle2 );
+		const uint64_t middle = lower + middle2;
+		if ( middle < lower )
+		{
+			upper++;
+		}
+		if ( middle + 1 == 0 && ( upper & 0x1FF ) == 0x1FF && productLow + mantissa < productLow )
+		{
+			return false;
+		}
+		lower = middle;
+	}
+
+	const uint64_t upperBit = upper >> 63;
+	uint64_t significand = upper >> ( upperBit + 9 );
+	leadingZeros += (int)( 1 ^ upperBit );
+
+	// Exactly halfway between two doubles, leave the round-to-even decision to the fallback.
+	if ( lower == 0 && ( upper & 0x1FF ) == 0 && ( significand & 3 ) == 1 )
+	{
+		return false;
+	}
+
+	significand += significand & 1;
+	significand >>= 1;
+	if ( significand >= ( 1ULL << 53 ) )
+	{
+		significand = 1ULL << 52;
+		leadingZeros--;
+	}
+	significand &= ~( 1ULL << 52 );
+	const int64_t realExponent = binaryExponent - leadingZeros;
+	if ( realExponent < 1 || realExponent > 2046 )
+	{
+		return false;
+	}
+	const uint64_t bits = significand | ( (uint64_t)realExponent << 52 );
+	memcpy( value, &bits, sizeof( bits ) );
+	return true;
+}
+
+// Parses a number and stores the result in 'valueInt64', 'valueUint64' or 'valueDouble'.
+// Floating-point numbers are correctly rounded to the nearest double.
+// Returns a pointer to the first character after the number.
+static const char * ksJson_ParseNumber( JsonType_t * type, int64_t * valueInt64, uint64_t * valueUint64, double * valueDouble,
+										const char * buffer, const char ** errorStringOut )
+{
+	(void)errorStringOut;
+
+	bool negative = false;
+	int exponentSign = 1;
+	int exponentValue = 0;
+
+	if ( buffer[0] == '-' )
+	{
+		negative = true;
+		buffer++;
+	}
+	else if ( buffer[0] == '+' )
+	{
+		buffer++;
+	}
+
+	// Parse integer digits.
+	const char * digitsStart = buffer;
+	uint64_t mantissa = 0;
+	buffer = ksJson_ParseDigits( buffer, &mantissa );
+	const int integerDigits = (int)( buffer - digitsStart );
+
+	// Parse fractional digits.
+	int fractionalDigits = 0;
+	if ( buffer[0] == '.' )
+	{
+		buffer++;
+		const char * fractionStart = buffer;
+		buffer = ksJson_ParseDigits( buffer, &mantissa );
+		fractionalDigits = (int)( buffer - fractionStart );
+	}
+
+	// Parse exponent.
+	if ( buffer[0] == 'e' || buffer[0] == 'E' )
+	{
+		buffer++;
+		if ( buffer[0] == '+' )
+		{
+			buffer++;
+		}
+		else if ( buffer[0] == '-' )
+		{
+			exponentSign = -1;
 			buffer++;
 		}
 		while ( buffer[0] >= '0' && buffer[0] <= '9' )
 		{
-			exponentValue = ( exponentValue * 10 ) + ( buffer[0] - '0' );
+			// Any exponent this large results in zero or infinity.
+			if ( exponentValue < 100000 )
+			{
+				exponentValue = ( exponentValue * 10 ) + ( buffer[0] - '0' );
+			}
 			buffer++;
 		}
 	}
 
-	if ( fractionalDigits != 0 || exponentValue != 0 || uint64Overflowed || ( sign < 0 && uint64Value > (uint64_t)INT64_MAX + 1 ) )
+	if ( fractionalDigits == 0 && exponentValue == 0 )
 	{
-		*type = JSON_FLOAT;
-		const int exp = exponentSign * exponentValue - fractionalDigits;
-		if ( exp > 308 )
+		bool overflowed = false;
+		if ( integerDigits > 19 )
 		{
-			*valueDouble = sign * DBL_MAX;
+			// The mantissa may have overflowed so parse the integer again with overflow checks.
+			mantissa = 0;
+			for ( const char * ptr = digitsStart; ptr < digitsStart + integerDigits; ptr++ )
+			{
+				const uint64_t d = (uint64_t)( ptr[0] - '0' );
+				overflowed |= ( mantissa > ( UINT64_MAX - d ) / 10 );
+				mantissa = ( mantissa * 10 ) + d;
+			}
 		}
-		else if ( exp >= -284 )
+		if ( !overflowed && negative && mantissa <= (uint64_t)INT64_MAX + 1 )
 		{
-			const int pow0 = 308 + 16;
-			const int pow1 = 308 * 2 + exp - pow0;
-			assert( pow0 >= 0 && pow0 < sizeof( json_pow10 ) / sizeof( json_pow10[0] ) );
-			assert( pow1 >= 0 && pow1 < sizeof( json_pow10 ) / sizeof( json_pow10[0] ) );
-			const double v = doubleValue * json_pow10[pow0] * json_pow10[pow1];
-			*valueDouble = sign * ( v <= DBL_MAX ? v : DBL_MAX );
+			*type = JSON_INT;
+			*valueInt64 = (int64_t)( (uint64_t)0 - mantissa );
+			return buffer;
 		}
-		else if ( exp >= -324 )
+		if ( !overflowed && !negative )
 		{
-			const int pow0 = 16;
-			const int pow1 = 308 * 2 + exp - pow0;
-			assert( pow0 >= 0 && pow0 < sizeof( json_pow10 ) / sizeof( json_pow10[0] ) );
-			assert( pow1 >= 0 && pow1 < sizeof( json_pow10 ) / sizeof( json_pow10[0] ) );
-			*valueDouble = sign * doubleValue * json_pow10[pow0] * json_pow10[pow1];
+			*type = JSON_UINT;
+			*valueUint64 = mantissa;
+			return buffer;
 		}
-		else
+	}
+
+	*type = JSON_FLOAT;
+
+	int exponent = exponentSign * exponentValue - fractionalDigits;
+	bool truncated = false;
+	if ( integerDigits + fractionalDigits > 19 )
+	{
+		// Skip leading zeros and count the significant digits.
+		const char * ptr = digitsStart;
+		int significantDigits = integerDigits + fractionalDigits;
+		for ( ; ptr[0] == '0' || ptr[0] == '.'; ptr++ )
 		{
-			*valueDouble = 0.0;
+			significantDigits -= ( ptr[0] == '0' );
 		}
+		if ( significantDigits > 19 )
+		{
+			// Only use the first 19 significant digits which always fit in 64 bits.
+			mantissa = 0;
+			for ( int digits = 0; digits < 19; ptr++ )
+			{
+				if ( ptr[0] != '.' )
+				{
+					mantissa = ( mantissa * 10 ) + ( ptr[0] - '0' );
+					digits++;
+				}
+			}
+			exponent += significantDigits - 19;
+			truncated = true;
+		}
+	}
+
+	double value = 0.0;
+	bool exact = false;
+	if ( mantissa == 0 )
+	{
+		exact = true;
 	}
-	else if ( sign < 0 )
+#if !defined( FLT_EVAL_METHOD ) || FLT_EVAL_METHOD == 0
+	else if ( !truncated && exponent >= -22 && exponent <= 22 && mantissa <= ( 1ULL << 53 ) )
 	{
-		*type = JSON_INT;
-		*valueInt64 = -(int64_t)uint64Value;
+		// Both the mantissa and the power of ten are exact, so a single multiply or divide is correctly rounded.
+		value = ( exponent >= 0 ) ? (double)mantissa * json_exactPow10[exponent] : (double)mantissa / json_exactPow10[-exponent];
+		exact = true;
 	}
-	else
+#endif
+	else if ( exponent >= JSON_POW5_MIN_EXPONENT && exponent <= JSON_POW5_MAX_EXPONENT )
+	{
+		exact = ksJson_EiselLemire( mantissa, exponent, &value );
+		if ( exact && truncated )
+		{
+			// The dropped digits only matter if rounding up the mantissa results in a different double.
+			double valueUp = 0.0;
+			exact = ( mantissa < UINT64_MAX && ksJson_EiselLemire( mantissa + 1, exponent, &valueUp ) && valueUp == value );
+		}
+	}
+	if ( !exact )
 	{
-		*type = JSON_UINT;
-		*valueUint64 = uint64Value;
+		// Rare cases like subnormals, values exactly halfway between two doubles and values out of range
+		// are left to the correctly rounded C library. The JSON number syntax is a subset of the strtod syntax.
+		value = strtod( digitsStart, NULL );
 	}
 
+	// JSON does not support infinity, so clamp to the maximum double.
+	value = ( value <= DBL_MAX ) ? value : DBL_MAX;
+	*valueDouble = negative ? -value : value;
+
 	return buffer;
 }
 
@@ -937,7 +2254,7 @@ static const char * ksJson_ParseValue( ksJson * json, const int recursion, const
 	else if ( buffer[0] == '\"' )
 	{
 		json->type = JSON_STRING;
-		return ksJson_ParseString( &json->valueString, buffer, errorStringOut );
+		return ksJson_ParseString( json->arena, &json->valueString, buffer, errorStringOut );
 	}
 	else if ( buffer[0] == '{' )
 	{
@@ -964,7 +2281,7 @@ static const char * ksJson_ParseValue( ksJson * json, const int recursion, const
 			}
 			ksJson * member = ksJson_AllocMember( json );
 			buffer = ksJson_ParseWhiteSpace( buffer );
-			buffer = ksJson_ParseString( &member->name, buffer, errorStringOut );
+			buffer = ksJson_ParseString( member->arena, &member->name, buffer, errorStringOut );
 			buffer = ksJson_ParseWhiteSpace( buffer );
 			if ( buffer[0] != ':' )
 			{
@@ -1021,6 +2338,10 @@ static bool ksJson_ReadFromBuffer( ksJson * rootNode, const char * buffer, const
 		*errorStringOut = NULL;
 	}
 	ksJson_FreeNode( rootNode, true );
+	if ( rootNode->arena != NULL )
+	{
+		rootNode->arena->readOnly = false;
+	}
 
 	const char * error = NULL;
 	ksJson_ParseValue( rootNode, 0, buffer, &error );
@@ -1048,36 +2369,45 @@ static bool ksJson_ReadFromFile( ksJson * rootNode, const char * fileName, const
 	}
 	ksJson_FreeNode( rootNode, true );
 
-	FILE * file = fopen( fileName, "rb" );
-	if ( file == NULL )
+	const char * error = NULL;
+	size_t bufferSize = 0;
+	bool mapped = false;
+	char * buffer = ksJson_LoadFile( fileName, true, &bufferSize, &mapped, &error );
+	if ( buffer == NULL )
 	{
 		if ( errorStringOut != NULL )
 		{
-			*errorStringOut = "failed to open file";
+			*errorStringOut = error;
 		}
 		return false;
 	}
 
-	fseek( file, 0L, SEEK_END );
-	size_t bufferSize = ftell( file );
-	fseek( file, 0L, SEEK_SET );
-
-	char * buffer = (char *) malloc( bufferSize + 1 );
-	if ( fread( buffer, 1, bufferSize, file ) != bufferSize )
+	// An arena DOM keeps the file in memory and parses in-situ with the strings pointing into the file.
+	ksJsonArena * arena = rootNode->arena;
+	if ( arena != NULL )
 	{
-		if ( errorStringOut != NULL )
+		if ( arena->source != NULL )
 		{
-			*errorStringOut = "failed to read file";
+			ksJson_UnloadFile( arena->source, arena->sourceSize, arena->sourceMapped );
 		}
-		free( buffer );
-		fclose( file );
-		return false;
+		arena->source = buffer;
+		arena->sourceSize = bufferSize;
+		arena->sourceMapped = mapped;
+		arena->inSitu = true;
+		arena->readOnly = false;
 	}
-	buffer[bufferSize] = '\0';	// make sure the buffer is zero terminated
-	fclose( file );
 
-	const char * error = NULL;
 	ksJson_ParseValue( rootNode, 0, buffer, &error );
+
+	if ( arena != NULL )
+	{
+		arena->inSitu = false;
+	}
+	else
+	{
+		ksJson_UnloadFile( buffer, bufferSize, mapped );
+	}
+
 	if ( error != NULL )
 	{
 		if ( errorStringOut != NULL )
@@ -1085,117 +2415,1021 @@ static bool ksJson_ReadFromFile( ksJson * rootNode, const char * fileName, const
 			*errorStringOut = error;
 		}
 		ksJson_FreeNode( rootNode, true );
-		free( buffer );
 		return false;
 	}
+	return true;
+}
+
+/*
+================================================================================================================================
+
+SAX-style streaming parser.
+
+================================================================================================================================
+*/
+
+#define JSON_SAX_INITIAL_TOKEN_SIZE		256
+#define JSON_SAX_FILE_CHUNK_SIZE		( 64 * 1024 )
+
+typedef struct
+{
+	bool	(*beginObject)( void * userData );
+	bool	(*endObject)( void * userData );
+	bool	(*beginArray)( void * userData );
+	bool	(*endArray)( void * userData );
+	bool	(*key)( void * userData, const char * name, const int length );
+	bool	(*string)( void * userData, const char * value, const int length );
+	bool	(*number)( void * userData, const JsonType_t type, const int64_t valueInt64, const uint64_t valueUint64, const double valueDouble );
+	bool	(*boolean)( void * userData, const bool value );
+	bool	(*null)( void * userData );
+} ksJsonSaxCallbacks;
+
+typedef enum
+{
+	JSON_SAX_STATE_VALUE,					// expecting a value
+	JSON_SAX_STATE_VALUE_OR_END,			// expecting a value or the end of an array
+	JSON_SAX_STATE_KEY,						// expecting a member name
+	JSON_SAX_STATE_KEY_OR_END,				// expecting a member name or the end of an object
+	JSON_SAX_STATE_COLON,					// expecting a colon after a member name
+	JSON_SAX_STATE_COMMA_OR_END,			// expecting a comma or the end of an object or array
+	JSON_SAX_STATE_DONE						// the root value has been parsed
+} ksJsonSaxState;
+
+typedef enum
+{
+	JSON_SAX_TOKEN_NONE,
+	JSON_SAX_TOKEN_KEY,						// member name, without the quotes
+	JSON_SAX_TOKEN_STRING,					// string value, without the quotes
+	JSON_SAX_TOKEN_NUMBER,
+	JSON_SAX_TOKEN_LITERAL					// true, false or null
+} ksJsonSaxToken;
+
+typedef struct
+{
+	const ksJsonSaxCallbacks *	callbacks;
+	void *						userData;
+	const char *				error;
+	ksJsonSaxState				state;
+	ksJsonSaxToken				tokenType;
+	bool						tokenEscape;						// the last character of the token is an escape character
+	char *						token;								// token that is being parsed, possibly across chunks
+	int							tokenLength;
+	int							tokenAllocated;
+	int							depth;
+	unsigned char				stack[JSON_MAX_RECURSION + 1];		// JSON_OBJECT or JSON_ARRAY per nesting level
+} ksJsonSax;
+
+static void ksJsonSax_Create( ksJsonSax * sax, const ksJsonSaxCallbacks * callbacks, void * userData )
+{
+	memset( sax, 0, sizeof( ksJsonSax ) );
+	sax->callbacks = callbacks;
+	sax->userData = userData;
+	sax->error = NULL;
+	sax->state = JSON_SAX_STATE_VALUE;
+	sax->tokenType = JSON_SAX_TOKEN_NONE;
+	sax->token = (char *) malloc( JSON_SAX_INITIAL_TOKEN_SIZE );
+	sax->tokenAllocated = JSON_SAX_INITIAL_TOKEN_SIZE;
+}
+
+static void ksJsonSax_Destroy( ksJsonSax * sax )
+{
+	free( sax->token );
+	memset( sax, 0, sizeof( ksJsonSax ) );
+}
+
+static void ksJsonSax_AppendToken( ksJsonSax * sax, const char * data, const int length )
+{
+	if ( sax->tokenLength + length + 1 > sax->tokenAllocated )
+	{
+		int newAllocated = sax->tokenAllocated * 2;
+		while ( newAllocated < sax->tokenLength + length + 1 )
+		{
+			newAllocated *= 2;
+		}
+		char * newToken = (char *) malloc( newAllocated );
+		memcpy( newToken, sax->token, sax->tokenLength );
+		free( sax->token );
+		sax->token = newToken;
+		sax->tokenAllocated = newAllocated;
+	}
+	memcpy( sax->token + sax->tokenLength, data, length );
+	sax->tokenLength += length;
+	sax->token[sax->tokenLength] = '\0';
+}
+
+static void ksJsonSax_Callback( ksJsonSax * sax, const bool result )
+{
+	if ( !result && sax->error == NULL )
+	{
+		sax->error = "aborted by callback";
+	}
+}
+
+// Called after a complete value has been parsed.
+static void ksJsonSax_EndValue( ksJsonSax * sax )
+{
+	sax->state = ( sax->depth == 0 ) ? JSON_SAX_STATE_DONE : JSON_SAX_STATE_COMMA_OR_END;
+}
+
+static void ksJsonSax_BeginContainer( ksJsonSax * sax, const JsonType_t type )
+{
+	if ( sax->depth >= JSON_MAX_RECURSION )
+	{
+		sax->error = "maximum recursion";
+		return;
+	}
+	sax->stack[sax->depth++] = (unsigned char)type;
+	if ( type == JSON_OBJECT )
+	{
+		sax->state = JSON_SAX_STATE_KEY_OR_END;
+		if ( sax->callbacks->beginObject != NULL )
+		{
+			ksJsonSax_Callback( sax, sax->callbacks->beginObject( sax->userData ) );
+		}
+	}
+	else
+	{
+		sax->state = JSON_SAX_STATE_VALUE_OR_END;
+		if ( sax->callbacks->beginArray != NULL )
+		{
+			ksJsonSax_Callback( sax, sax->callbacks->beginArray( sax->userData ) );
+		}
+	}
+}
+
+static void ksJsonSax_EndContainer( ksJsonSax * sax )
+{
+	const JsonType_t type = (JsonType_t)sax->stack[--sax->depth];
+	if ( type == JSON_OBJECT )
+	{
+		if ( sax->callbacks->endObject != NULL )
+		{
+			ksJsonSax_Callback( sax, sax->callbacks->endObject( sax->userData ) );
+		}
+	}
+	else
+	{
+		if ( sax->callbacks->endArray != NULL )
+		{
+			ksJsonSax_Callback( sax, sax->callbacks->endArray( sax->userData ) );
+		}
+	}
+	ksJsonSax_EndValue( sax );
+}
+
+static void ksJsonSax_EndToken( ksJsonSax * sax )
+{
+	if ( sax->tokenType == JSON_SAX_TOKEN_KEY || sax->tokenType == JSON_SAX_TOKEN_STRING )
+	{
+		// The escaped characters are decoded in place.
+		const char * end = ksJson_DecodeString( sax->token, sax->token, sax->token + sax->tokenLength, &sax->error );
+		if ( end != NULL )
+		{
+			const int length = (int)( end - sax->token );
+			if ( sax->tokenType == JSON_SAX_TOKEN_KEY )
+			{
+				sax->state = JSON_SAX_STATE_COLON;
+				if ( sax->callbacks->key != NULL )
+				{
+					ksJsonSax_Callback( sax, sax->callbacks->key( sax->userData, sax->token, length ) );
+				}
+			}
+			else
+			{
+				ksJsonSax_EndValue( sax );
+				if ( sax->callbacks->string != NULL )
+				{
+					ksJsonSax_Callback( sax, sax->callbacks->string( sax->userData, sax->token, length ) );
+				}
+			}
+		}
+	}
+	else if ( sax->tokenType == JSON_SAX_TOKEN_NUMBER )
+	{
+		JsonType_t type = JSON_NONE;
+		int64_t valueInt64 = 0;
+		uint64_t valueUint64 = 0;
+		double valueDouble = 0.0;
+		const char * end = ksJson_ParseNumber( &type, &valueInt64, &valueUint64, &valueDouble, sax->token, &sax->error );
+		if ( end != sax->token + sax->tokenLength )
+		{
+			sax->error = "invalid number";
+		}
+		else
+		{
+			ksJsonSax_EndValue( sax );
+			if ( sax->callbacks->number != NULL )
+			{
+				ksJsonSax_Callback( sax, sax->callbacks->number( sax->userData, type, valueInt64, valueUint64, valueDouble ) );
+			}
+		}
+	}
+	else if ( sax->tokenType == JSON_SAX_TOKEN_LITERAL )
+	{
+		if ( strcmp( sax->token, "null" ) == 0 )
+		{
+			ksJsonSax_EndValue( sax );
+			if ( sax->callbacks->null != NULL )
+			{
+				ksJsonSax_Callback( sax, sax->callbacks->null( sax->userData ) );
+			}
+		}
+		else if ( strcmp( sax->token, "true" ) == 0 || strcmp( sax->token, "false" ) == 0 )
+		{
+			ksJsonSax_EndValue( sax );
+			if ( sax->callbacks->boolean != NULL )
+			{
+				ksJsonSax_Callback( sax, sax->callbacks->boolean( sax->userData, sax->token[0] == 't' ) );
+			}
+		}
+		else
+		{
+			sax->error = "invalid literal";
+		}
+	}
+	sax->tokenType = JSON_SAX_TOKEN_NONE;
+	sax->tokenLength = 0;
+	sax->tokenEscape = false;
+}
+
+static void ksJsonSax_BeginToken( ksJsonSax * sax, const ksJsonSaxToken tokenType )
+{
+	sax->tokenType = tokenType;
+	sax->tokenLength = 0;
+	sax->tokenEscape = false;
+	sax->token[0] = '\0';
+}
+
+// Continues parsing the current token.
+// Returns a pointer to the first character after the part of the token that is in the range [buffer, end).
+static const char * ksJsonSax_ContinueToken( ksJsonSax * sax, const char * buffer, const char * end )
+{
+	const char * start = buffer;
+	if ( sax->tokenType == JSON_SAX_TOKEN_KEY || sax->tokenType == JSON_SAX_TOKEN_STRING )
+	{
+		bool escape = sax->tokenEscape;
+		while ( buffer < end )
+		{
+			if ( escape )
+			{
+				escape = false;
+			}
+			else
+			{
+				buffer = ksJson_SkipStringCharactersRange( buffer, end );
+				if ( buffer >= end )
+				{
+					break;
+				}
+				if ( buffer[0] == '\\' )
+				{
+					escape = true;
+				}
+				else if ( buffer[0] == '\"' )
+				{
+					break;
+				}
+			}
+			buffer++;
+		}
+		ksJsonSax_AppendToken( sax, start, (int)( buffer - start ) );
+		sax->tokenEscape = escape;
+		if ( buffer < end )
+		{
+			ksJsonSax_EndToken( sax );
+			buffer++;	// skip the trailing quote
+		}
+		return buffer;
+	}
+	if ( sax->tokenType == JSON_SAX_TOKEN_NUMBER )
+	{
+		while ( buffer < end && ( ( buffer[0] >= '0' && buffer[0] <= '9' ) ||
+					buffer[0] == '-' || buffer[0] == '+' || buffer[0] == '.' || buffer[0] == 'e' || buffer[0] == 'E' ) )
+		{
+			buffer++;
+		}
+	}
+	else
+	{
+		while ( buffer < end && buffer[0] >= 'a' && buffer[0] <= 'z' )
+		{
+			buffer++;
+		}
+	}
+	ksJsonSax_AppendToken( sax, start, (int)( buffer - start ) );
+	if ( buffer < end )
+	{
+		ksJsonSax_EndToken( sax );
+	}
+	return buffer;
+}
+
+// Parses the next chunk of JSON text. The chunk does not need to be zero terminated and
+// tokens may be split across chunks. Returns false as soon as an error is encountered.
+static bool ksJsonSax_Parse( ksJsonSax * sax, const char * chunk, const size_t length )
+{
+	const char * buffer = chunk;
+	const char * end = chunk + length;
+
+	while ( buffer < end && sax->error == NULL && sax->state != JSON_SAX_STATE_DONE )
+	{
+		if ( sax->tokenType != JSON_SAX_TOKEN_NONE )
+		{
+			buffer = ksJsonSax_ContinueToken( sax, buffer, end );
+			continue;
+		}
+
+		const char c = buffer[0];
+		if ( c != '\0' && (unsigned char)c <= ' ' )
+		{
+			buffer = ksJson_ParseWhiteSpaceRange( buffer + 1, end );
+			continue;
+		}
+
+		switch ( sax->state )
+		{
+			case JSON_SAX_STATE_VALUE:
+			case JSON_SAX_STATE_VALUE_OR_END:
+			{
+				if ( c == ']' && sax->state == JSON_SAX_STATE_VALUE_OR_END )
+				{
+					ksJsonSax_EndContainer( sax );
+					buffer++;
+				}
+				else if ( c == '{' )
+				{
+					ksJsonSax_BeginContainer( sax, JSON_OBJECT );
+					buffer++;
+				}
+				else if ( c == '[' )
+				{
+					ksJsonSax_BeginContainer( sax, JSON_ARRAY );
+					buffer++;
+				}
+				else if ( c == '\"' )
+				{
+					ksJsonSax_BeginToken( sax, JSON_SAX_TOKEN_STRING );
+					buffer++;
+				}
+				else if ( ( c >= '0' && c <= '9' ) || c == '-' || c == '+' )
+				{
+					ksJsonSax_BeginToken( sax, JSON_SAX_TOKEN_NUMBER );
+				}
+				else if ( c == 't' || c == 'f' || c == 'n' )
+				{
+					ksJsonSax_BeginToken( sax, JSON_SAX_TOKEN_LITERAL );
+				}
+				else
+				{
+					sax->error = "unexpected character";
+				}
+				break;
+			}
+			case JSON_SAX_STATE_KEY:
+			case JSON_SAX_STATE_KEY_OR_END:
+			{
+				if ( c == '}' && sax->state == JSON_SAX_STATE_KEY_OR_END )
+				{
+					ksJsonSax_EndContainer( sax );
+					buffer++;
+				}
+				else if ( c == '\"' )
+				{
+					ksJsonSax_BeginToken( sax, JSON_SAX_TOKEN_KEY );
+					buffer++;
+				}
+				else
+				{
+					sax->error = "missing member name";
+				}
+				break;
+			}
+			case JSON_SAX_STATE_COLON:
+			{
+				if ( c == ':' )
+				{
+					sax->state = JSON_SAX_STATE_VALUE;
+					buffer++;
+				}
+				else
+				{
+					sax->error = "missing colon";
+				}
+				break;
+			}
+			case JSON_SAX_STATE_COMMA_OR_END:
+			{
+				const JsonType_t type = (JsonType_t)sax->stack[sax->depth - 1];
+				if ( c == ',' )
+				{
+					sax->state = ( type == JSON_OBJECT ) ? JSON_SAX_STATE_KEY : JSON_SAX_STATE_VALUE;
+					buffer++;
+				}
+				else if ( ( c == '}' && type == JSON_OBJECT ) || ( c == ']' && type == JSON_ARRAY ) )
+				{
+					ksJsonSax_EndContainer( sax );
+					buffer++;
+				}
+				else
+				{
+					sax->error = "missing comma";
+				}
+				break;
+			}
+			case JSON_SAX_STATE_DONE:
+			{
+				break;
+			}
+		}
+	}
+
+	return ( sax->error == NULL );
+}
+
+// Completes parsing after the last chunk. Returns true if a complete JSON value was parsed without errors.
+static bool ksJsonSax_Finish( ksJsonSax * sax, const char ** errorStringOut )
+{
+	if ( sax->error == NULL && sax->tokenType != JSON_SAX_TOKEN_NONE )
+	{
+		if ( sax->tokenType == JSON_SAX_TOKEN_KEY || sax->tokenType == JSON_SAX_TOKEN_STRING )
+		{
+			sax->error = "missing trailing quote";
+		}
+		else
+		{
+			ksJsonSax_EndToken( sax );
+		}
+	}
+	if ( sax->error == NULL && sax->state != JSON_SAX_STATE_DONE )
+	{
+		sax->error = "unexpected end of text";
+	}
+	if ( errorStringOut != NULL )
+	{
+		*errorStringOut = sax->error;
+	}
+	return ( sax->error == NULL );
+}
+
+static bool ksJsonSax_ParseBuffer( const ksJsonSaxCallbacks * callbacks, void * userData, const char * buffer, const char ** errorStringOut )
+{
+	if ( callbacks == NULL || buffer == NULL )
+	{
+		return false;
+	}
+	ksJsonSax sax;
+	ksJsonSax_Create( &sax, callbacks, userData );
+	ksJsonSax_Parse( &sax, buffer, strlen( buffer ) );
+	const bool result = ksJsonSax_Finish( &sax, errorStringOut );
+	ksJsonSax_Destroy( &sax );
+	return result;
+}
+
+static bool ksJsonSax_ParseFile( const ksJsonSaxCallbacks * callbacks, void * userData, const char * fileName, const char ** errorStringOut )
+{
+	if ( errorStringOut != NULL )
+	{
+		*errorStringOut = NULL;
+	}
+	if ( callbacks == NULL || fileName == NULL )
+	{
+		return false;
+	}
+
+	FILE * file = fopen( fileName, "rb" );
+	if ( file == NULL )
+	{
+		if ( errorStringOut != NULL )
+		{
+			*errorStringOut = "failed to open file";
+		}
+		return false;
+	}
+
+	ksJsonSax sax;
+	ksJsonSax_Create( &sax, callbacks, userData );
+
+	char * chunk = (char *) malloc( JSON_SAX_FILE_CHUNK_SIZE );
+	for ( ; ; )
+	{
+		const size_t length = fread( chunk, 1, JSON_SAX_FILE_CHUNK_SIZE, file );
+		if ( length == 0 || !ksJsonSax_Parse( &sax, chunk, length ) || sax.state == JSON_SAX_STATE_DONE )
+		{
+			break;
+		}
+	}
+	if ( sax.error == NULL && ferror( file ) )
+	{
+		sax.error = "failed to read file";
+	}
+	free( chunk );
+	fclose( file );
+
+	const bool result = ksJsonSax_Finish( &sax, errorStringOut );
+	ksJsonSax_Destroy( &sax );
+	return result;
+}
+
+// Buffer the JSON text is written to.
+typedef struct ksJsonWriter
+{
+	char *	buffer;
+	int		length;			// allocated length of the buffer
+	int		offset;			// current write offset, the text in the buffer is always followed by a zero
+	bool	compact;		// no white space between tokens
+} ksJsonWriter;
+
+// Makes sure the buffer has room for at least 'extraLength' more characters plus a trailing zero.
+// Returns a pointer to the current write position.
+static char * ksJsonWriter_Reserve( ksJsonWriter * writer, const int extraLength )
+{
+	if ( writer->offset + extraLength + 1 > writer->length )
+	{
+		int newLength = ( writer->length <= 0 ) ? 4096 : writer->length * 2;
+		while ( newLength < writer->offset + extraLength + 1 )
+		{
+			newLength *= 2;
+		}
+		writer->buffer = (char *) realloc( writer->buffer, newLength );
+		writer->length = newLength;
+	}
+	return writer->buffer + writer->offset;
+}
+
+static void ksJsonWriter_Append( ksJsonWriter * writer, const char * text, const int length )
+{
+	char * out = ksJsonWriter_Reserve( writer, length );
+	memcpy( out, text, length );
+	writer->offset += length;
+}
+
+static void ksJsonWriter_AppendChar( ksJsonWriter * writer, const char c )
+{
+	char * out = ksJsonWriter_Reserve( writer, 1 );
+	out[0] = c;
+	writer->offset++;
+}
+
+static void ksJsonWriter_AppendIndent( ksJsonWriter * writer, const int indent )
+{
+	if ( !writer->compact )
+	{
+		char * out = ksJsonWriter_Reserve( writer, indent );
+		memset( out, '\t', indent );
+		writer->offset += indent;
+	}
+}
+
+static const char json_digitPairs[201] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+// Formats an unsigned integer without trailing zero. Returns the number of characters written to 'out'.
+static int ksJson_FormatUint64( char * out, uint64_t value )
+{
+	char temp[20];
+	char * ptr = temp + sizeof( temp );
+	while ( value >= 100 )
+	{
+		const int pair = (int)( value % 100 ) * 2;
+		value /= 100;
+		*--ptr = json_digitPairs[pair + 1];
+		*--ptr = json_digitPairs[pair + 0];
+	}
+	if ( value >= 10 )
+	{
+		const int pair = (int)value * 2;
+		*--ptr = json_digitPairs[pair + 1];
+		*--ptr = json_digitPairs[pair + 0];
+	}
+	else
+	{
+		*--ptr = (char)( '0' + value );
+	}
+	const int length = (int)( temp + sizeof( temp ) - ptr );
+	memcpy( out, ptr, length );
+	return length;
+}
+
+// Formats a signed integer without trailing zero. Returns the number of characters written to 'out'.
+static int ksJson_FormatInt64( char * out, const int64_t value )
+{
+	if ( value < 0 )
+	{
+		out[0] = '-';
+		return 1 + ksJson_FormatUint64( out + 1, (uint64_t)0 - (uint64_t)value );
+	}
+	return ksJson_FormatUint64( out, (uint64_t)value );
+}
+
+// Normalized 64-bit significands and binary exponents of the powers of ten from 10^-348 to 10^+340 in steps of 8.
+static const uint64_t json_cachedPowersF[] =
+{
+	0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL, 0xcf42894a5dce35eaULL,
+	0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL, 0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL,
+	0xbe5691ef416bd60cULL, 0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+	0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL, 0xc21094364dfb5637ULL,
+	0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL, 0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL,
+	0xb23867fb2a35b28eULL, 0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+	0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL, 0xb5b5ada8aaff80b8ULL,
+	0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL, 0x964e858c91ba2655ULL, 0xdff9772470297ebdULL,
+	0xa6dfbd9fb8e5b88fULL, 0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+	0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL, 0xaa242499697392d3ULL,
+	0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL, 0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL,
+	0x9c40000000000000ULL, 0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+	0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL, 0x9f4f2726179a2245ULL,
+	0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL, 0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL,
+	0x924d692ca61be758ULL, 0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+	0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL, 0x952ab45cfa97a0b3ULL,
+	0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL, 0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL,
+	0x88fcf317f22241e2ULL, 0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+	0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL, 0x8bab8eefb6409c1aULL,
+	0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL, 0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL,
+	0x80444b5e7aa7cf85ULL, 0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+	0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL
+};
+
+static const int16_t json_cachedPowersE[] =
+{
+	-1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927,
+	-901, -874, -847, -821, -794, -768, -741, -715, -688, -661, -635, -608,
+	-582, -555, -529, -502, -475, -449, -422, -396, -369, -343, -316, -289,
+	-263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30,
+	56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+	375, 402, 428, 455, 481, 508, 534, 561, 588, 614, 641, 667,
+	694, 720, 747, 774, 800, 827, 853, 880, 907, 933, 960, 986,
+	1013, 1039, 1066
+};
+
+static const uint64_t json_pow10Uint64[20] =
+{
+	1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+	10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+	1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+};
+
+// Floating-point number with a 64-bit significand and a binary exponent.
+typedef struct ksJsonDiyFp
+{
+	uint64_t	f;
+	int			e;
+} ksJsonDiyFp;
+
+static ksJsonDiyFp ksJsonDiyFp_Multiply( const ksJsonDiyFp x, const ksJsonDiyFp y )
+{
+	const uint64_t M32 = 0xFFFFFFFFULL;
+	const uint64_t a = x.f >> 32;
+	const uint64_t b = x.f & M32;
+	const uint64_t c = y.f >> 32;
+	const uint64_t d = y.f & M32;
+	const uint64_t ac = a * c;
+	const uint64_t bc = b * c;
+	const uint64_t ad = a * d;
+	const uint64_t bd = b * d;
+	uint64_t tmp = ( bd >> 32 ) + ( ad & M32 ) + ( bc & M32 );
+	tmp += 1ULL << 31;	// round
+	ksJsonDiyFp r;
+	r.f = ac + ( ad >> 32 ) + ( bc >> 32 ) + ( tmp >> 32 );
+	r.e = x.e + y.e + 64;
+	return r;
+}
+
+static ksJsonDiyFp ksJsonDiyFp_Normalize( ksJsonDiyFp x )
+{
+	while ( ( x.f & ( 1ULL << 63 ) ) == 0 )
+	{
+		x.f <<= 1;
+		x.e--;
+	}
+	return x;
+}
+
+static void ksJson_GrisuRound( char * buffer, const int length, const uint64_t delta, uint64_t rest, const uint64_t tenKappa, const uint64_t distance )
+{
+	// Move the last digit closer to the real value as long as the result stays within the rounding interval.
+	while (	rest < distance && delta - rest >= tenKappa &&
+			( rest + tenKappa < distance || distance - rest > rest + tenKappa - distance ) )
+	{
+		buffer[length - 1]--;
+		rest += tenKappa;
+	}
+}
+
+static int ksJson_CountDecimalDigits( const uint32_t n )
+{
+	int count = 1;
+	for ( uint32_t p = 10; count < 10 && n >= p; p *= 10 )
+	{
+		count++;
+	}
+	return count;
+}
+
+// Generates the shortest digits of 'W' that are within 'delta' of the upper boundary 'Mp'.
+static void ksJson_GrisuDigitGen( const ksJsonDiyFp W, const ksJsonDiyFp Mp, uint64_t delta, char * buffer, int * length, int * K )
+{
+	const ksJsonDiyFp one = { 1ULL << -Mp.e, Mp.e };
+	const uint64_t distance = Mp.f - W.f;
+	uint32_t p1 = (uint32_t)( Mp.f >> -one.e );
+	uint64_t p2 = Mp.f & ( one.f - 1 );
+	int kappa = ksJson_CountDecimalDigits( p1 );
+	*length = 0;
+
+	while ( kappa > 0 )
+	{
+		const uint32_t div = (uint32_t) json_pow10Uint64[kappa - 1];
+		const uint32_t d = p1 / div;
+		p1 %= div;
+		if ( d != 0 || *length != 0 )
+		{
+			buffer[(*length)++] = (char)( '0' + d );
+		}
+		kappa--;
+		const uint64_t rest = ( (uint64_t)p1 << -one.e ) + p2;
+		if ( rest <= delta )
+		{
+			*K += kappa;
+			ksJson_GrisuRound( buffer, *length, delta, rest, json_pow10Uint64[kappa] << -one.e, distance );
+			return;
+		}
+	}
+
+	for ( ; ; )
+	{
+		p2 *= 10;
+		delta *= 10;
+		const char d = (char)( p2 >> -one.e );
+		if ( d != 0 || *length != 0 )
+		{
+			buffer[(*length)++] = (char)( '0' + d );
+		}
+		p2 &= one.f - 1;
+		kappa--;
+		if ( p2 < delta )
+		{
+			*K += kappa;
+			const int index = -kappa;
+			ksJson_GrisuRound( buffer, *length, delta, p2, one.f, distance * ( index < 20 ? json_pow10Uint64[index] : 0 ) );
+			return;
+		}
+	}
+}
+
+// Grisu2 algorithm by Florian Loitsch: "Printing Floating-Point Numbers Quickly and Accurately with Integers".
+// Generates the shortest digits that uniquely identify the given positive double in all but very rare cases,
+// and digits that always parse back to exactly the same double. The value is 'buffer' * 10^'K'.
+static void ksJson_Grisu2( const double value, char * buffer, int * length, int * K )
+{
+	uint64_t bits;
+	memcpy( &bits, &value, sizeof( bits ) );
+	const uint64_t hiddenBit = 1ULL << 52;
+	const int biasedExponent = (int)( ( bits >> 52 ) & 0x7FF );
+	ksJsonDiyFp v;
+	v.f = bits & ( hiddenBit - 1 );
+	v.e = -1074;
+	if ( biasedExponent != 0 )
+	{
+		v.f += hiddenBit;
+		v.e = biasedExponent - 1075;
+	}
+
+	// Boundaries halfway between the value and its neighbors.
+	ksJsonDiyFp plus = { ( v.f << 1 ) + 1, v.e - 1 };
+	while ( ( plus.f & ( hiddenBit << 1 ) ) == 0 )
+	{
+		plus.f <<= 1;
+		plus.e--;
+	}
+	plus.f <<= 64 - 52 - 2;
+	plus.e -= 64 - 52 - 2;
+	// The lower boundary is closer when the significand is a power of two.
+	const int minusShift = ( v.f == hiddenBit ) ? 2 : 1;
+	ksJsonDiyFp minus = { ( v.f << minusShift ) - 1, v.e - minusShift };
+	minus.f <<= minus.e - plus.e;
+	minus.e = plus.e;
+
+	// Find a cached power of ten such that the scaled exponent is in the range [-60, -32].
+	const double dk = ( -61 - plus.e ) * 0.30102999566398114 + 347;
+	int k = (int)dk;
+	if ( dk - k > 0.0 )
+	{
+		k++;
+	}
+	const int index = ( k >> 3 ) + 1;
+	*K = -( -348 + index * 8 );
+	const ksJsonDiyFp c_mk = { json_cachedPowersF[index], json_cachedPowersE[index] };
+
+	const ksJsonDiyFp W = ksJsonDiyFp_Multiply( ksJsonDiyFp_Normalize( v ), c_mk );
+	ksJsonDiyFp Wp = ksJsonDiyFp_Multiply( plus, c_mk );
+	ksJsonDiyFp Wm = ksJsonDiyFp_Multiply( minus, c_mk );
+	Wm.f++;
+	Wp.f--;
+	ksJson_GrisuDigitGen( W, Wp, Wp.f - Wm.f, buffer, length, K );
+}
+
+static int ksJson_FormatExponent( char * out, int exponent )
+{
+	char * ptr = out;
+	*ptr++ = 'e';
+	if ( exponent < 0 )
+	{
+		*ptr++ = '-';
+		exponent = -exponent;
+	}
+	if ( exponent >= 100 )
+	{
+		*ptr++ = (char)( '0' + exponent / 100 );
+		exponent %= 100;
+		*ptr++ = json_digitPairs[exponent * 2 + 0];
+		*ptr++ = json_digitPairs[exponent * 2 + 1];
+	}
+	else if ( exponent >= 10 )
+	{
+		*ptr++ = json_digitPairs[exponent * 2 + 0];
+		*ptr++ = json_digitPairs[exponent * 2 + 1];
+	}
+	else
+	{
+		*ptr++ = (char)( '0' + exponent );
+	}
+	return (int)( ptr - out );
+}
+
+// Formats a double with the shortest number of digits that parse back to exactly the same double.
+// The number always has a fraction or exponent so it is read back as a floating-point value.
+// JSON does not support infinity and NaN, so infinities are clamped to [-DBL_MAX, DBL_MAX] and NaN is written as zero.
+// The 'out' buffer must be able to hold at least JSON_MAX_DOUBLE_LENGTH characters.
+static int ksJson_FormatDouble( char * out, double value )
+{
+	uint64_t bits;
+	memcpy( &bits, &value, sizeof( bits ) );
+	char * ptr = out;
+	if ( ( bits & 0x7FF0000000000000ULL ) == 0x7FF0000000000000ULL )
+	{
+		if ( ( bits & 0x000FFFFFFFFFFFFFULL ) != 0 )
+		{
+			value = 0.0;
+			bits = 0;
+		}
+		else
+		{
+			value = ( value < 0.0 ) ? -DBL_MAX : DBL_MAX;
+		}
+	}
+	if ( ( bits >> 63 ) != 0 )
+	{
+		*ptr++ = '-';
+		value = -value;
+	}
+	if ( value == 0.0 )
+	{
+		memcpy( ptr, "0.0", 3 );
+		return (int)( ptr - out ) + 3;
+	}
 
-	free( buffer );
-	return true;
+	int length = 0;
+	int K = 0;
+	ksJson_Grisu2( value, ptr, &length, &K );
+
+	// The value is in the range [10^(kk-1), 10^kk).
+	const int kk = length + K;
+	if ( K >= 0 && kk <= 21 )
+	{
+		// 1234e7 -> 12340000000.0
+		memset( ptr + length, '0', kk - length );
+		ptr[kk + 0] = '.';
+		ptr[kk + 1] = '0';
+		ptr += kk + 2;
+	}
+	else if ( kk > 0 && kk <= 21 )
+	{
+		// 1234e-2 -> 12.34
+		memmove( ptr + kk + 1, ptr + kk, length - kk );
+		ptr[kk] = '.';
+		ptr += length + 1;
+	}
+	else if ( kk > -6 && kk <= 0 )
+	{
+		// 1234e-6 -> 0.001234
+		const int offset = 2 - kk;
+		memmove( ptr + offset, ptr, length );
+		ptr[0] = '0';
+		ptr[1] = '.';
+		memset( ptr + 2, '0', offset - 2 );
+		ptr += length + offset;
+	}
+	else if ( length == 1 )
+	{
+		// 1e30
+		ptr += 1;
+		ptr += ksJson_FormatExponent( ptr, kk - 1 );
+	}
+	else
+	{
+		// 1234e30 -> 1.234e33
+		memmove( ptr + 2, ptr + 1, length - 1 );
+		ptr[1] = '.';
+		ptr += length + 1;
+		ptr += ksJson_FormatExponent( ptr, kk - 1 );
+	}
+	assert( ptr - out <= JSON_MAX_DOUBLE_LENGTH );
+	return (int)( ptr - out );
 }
 
-static void ksJson_Printf( char ** bufferInOut, int * lengthInOut, int * offsetInOut, const int extraLength, const char * format, ... )
+static void ksJsonWriter_AppendString( ksJsonWriter * writer, const char * string )
 {
-	if ( *offsetInOut + extraLength + 1 > *lengthInOut )
+	static const char hexDigits[] = "0123456789abcdef";
+
+	ksJsonWriter_AppendChar( writer, '\"' );
+	for ( const char * ptr = string; ; )
 	{
-		int newLength = ( *lengthInOut <= 0 ) ? 128 : *lengthInOut * 2;
-		while ( newLength < *offsetInOut + extraLength + 1 )
+		// Copy everything up to the next character that needs to be escaped at once.
+		const char * start = ptr;
+		while ( (unsigned char)ptr[0] >= ' ' && ptr[0] != '\"' && ptr[0] != '\\' )
 		{
-			newLength *= 2;
+			ptr++;
+		}
+		if ( ptr > start )
+		{
+			ksJsonWriter_Append( writer, start, (int)( ptr - start ) );
+		}
+		if ( ptr[0] == '\0' )
+		{
+			break;
+		}
+		char escaped[6] = { '\\', 0, 0, 0, 0, 0 };
+		int length = 2;
+		switch ( ptr[0] )
+		{
+			case '\\': escaped[1] = '\\'; break;
+			case '\"': escaped[1] = '\"'; break;
+			case '\b': escaped[1] = 'b'; break;
+			case '\f': escaped[1] = 'f'; break;
+			case '\n': escaped[1] = 'n'; break;
+			case '\r': escaped[1] = 'r'; break;
+			case '\t': escaped[1] = 't'; break;
+			default:
+			{
+				escaped[1] = 'u';
+				escaped[2] = '0';
+				escaped[3] = '0';
+				escaped[4] = hexDigits[( (unsigned char)ptr[0] >> 4 ) & 15];
+				escaped[5] = hexDigits[( (unsigned char)ptr[0] >> 0 ) & 15];
+				length = 6;
+				break;
+			}
 		}
-		char * newBuffer = (char *) malloc( newLength );
-		memcpy( newBuffer, *bufferInOut, *offsetInOut );
-		free( *bufferInOut );
-		*bufferInOut = newBuffer;
-		*lengthInOut = newLength;
+		ksJsonWriter_Append( writer, escaped, length );
+		ptr++;
 	}
-	va_list args;
-	va_start( args, format );
-	*offsetInOut += vsprintf( &(*bufferInOut)[*offsetInOut], format, args );
-	va_end( args );
-	assert( *offsetInOut <= *lengthInOut );
+	ksJsonWriter_AppendChar( writer, '\"' );
 }
 
-static void ksJson_WriteValue( const ksJson * node, int recursion, char ** bufferInOut, int * lengthInOut, int * offsetInOut, const int indent, const bool lastChild )
+static void ksJson_WriteValue( ksJsonWriter * writer, const ksJson * node, int recursion, const int indent, const bool lastChild )
 {
 	if ( recursion > JSON_MAX_RECURSION )
 	{
 		return;
 	}
 
-	const int maxIndent = 32;
-	const char * indentTable = "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t";
-	assert( indent <= maxIndent );
-
 	if ( node->type == JSON_NULL || node->type == JSON_BOOLEAN )
 	{
-		ksJson_Printf( bufferInOut, lengthInOut, offsetInOut, (int)strlen( node->valueString ) + 2, "%s%s\n", node->valueString, lastChild ? "" : "," );
+		ksJsonWriter_Append( writer, node->valueString, (int)strlen( node->valueString ) );
 	}
 	else if ( node->type == JSON_INT )
 	{
-		char temp[1024];
-		const int length = sprintf( temp, "%lld", (long long int)node->valueInt64 );
-		ksJson_Printf( bufferInOut, lengthInOut, offsetInOut, length + 2, "%s%s\n", temp, lastChild ? "" : "," );
+		char * out = ksJsonWriter_Reserve( writer, 20 );
+		writer->offset += ksJson_FormatInt64( out, node->valueInt64 );
 	}
 	else if ( node->type == JSON_UINT )
 	{
-		char temp[1024];
-		const int length = sprintf( temp, "%llu", (unsigned long long int)node->valueUint64 );
-		ksJson_Printf( bufferInOut, lengthInOut, offsetInOut, length + 2, "%s%s\n", temp, lastChild ? "" : "," );
+		char * out = ksJsonWriter_Reserve( writer, 20 );
+		writer->offset += ksJson_FormatUint64( out, node->valueUint64 );
 	}
 	else if ( node->type == JSON_FLOAT )
 	{
-		char temp[1024];
-		int length = sprintf( temp, "%g", node->valueDouble );
-		ksJson_Printf( bufferInOut, lengthInOut, offsetInOut, length + 2, "%s%s\n", temp, lastChild ? "" : "," );
+		char * out = ksJsonWriter_Reserve( writer, JSON_MAX_DOUBLE_LENGTH );
+		writer->offset += ksJson_FormatDouble( out, node->valueDouble );
 	}
 	else if ( node->type == JSON_STRING )
 	{
-		for ( const char * ptr = node->valueString; ptr[0] != '\0'; ptr++ )
-		{
-			if ( (unsigned char)ptr[0] < ' ' || ptr[0] == '\"' || ptr[0] == '\\' )
-			{
-				switch ( ptr[0] )
-				{
-					case '\\': ksJson_Printf( bufferInOut, lengthInOut, offsetInOut, 2, "\\\\" ); break;
-					case '\"': ksJson_Printf( bufferInOut, lengthInOut, offsetInOut, 2, "\\\"" ); break;
-					case '\b': ksJson_Printf( bufferInOut, lengthInOut, offsetInOut, 2, "\\b" ); break;
-					case '\f': ksJson_Printf( bufferInOut, lengthInOut, offsetInOut, 2, "\\f" ); break;
-					case '\n': ksJson_Printf( bufferInOut, lengthInOut, offsetInOut, 2, "\\n" ); break;
-					case '\r': ksJson_Printf( bufferInOut, lengthInOut, offsetInOut, 2, "\\r" ); break;
-					case '\t': ksJson_Printf( bufferInOut, lengthInOut, offsetInOut, 2, "\\t" ); break;
-					default: ksJson_Printf( bufferInOut, lengthInOut, offsetInOut, 6, "\\u%04x", ptr[0] ); break;
-				}
-			}
-			else
-			{
-				ksJson_Printf( bufferInOut, lengthInOut, offsetInOut, 1, "%c", ptr[0] );
-			}
-		}
-		ksJson_Printf( bufferInOut, lengthInOut, offsetInOut, 2, "%s\n", lastChild ? "" : "," );
+		ksJsonWriter_AppendString( writer, node->valueString );
 	}
-	else if ( node->type == JSON_OBJECT )
+	else if ( node->type == JSON_OBJECT || node->type == JSON_ARRAY )
 	{
-		ksJson_Printf( bufferInOut, lengthInOut, offsetInOut, 2, "{\n" );
-		if ( node->memberCount > 0 )
+		ksJsonWriter_AppendChar( writer, ( node->type == JSON_OBJECT ) ? '{' : '[' );
+		if ( !writer->compact )
 		{
-			const int endMapIndex = MemberIndexToMapIndex( node->memberCount - 1 );
-			for ( int mapIndex = 0; mapIndex <= endMapIndex; mapIndex++ )
-			{
-				const ksJson * members = node->memberMap[mapIndex];
-				const int mapMemberCount = MapMemberCount( mapIndex, node->memberCount ); 
-				for ( int i = 0; i < mapMemberCount; i++ )
-				{
-					const ksJson * member = &members[i];
-					ksJson_Printf( bufferInOut, lengthInOut, offsetInOut, indent + 1 + (int)strlen( member->name ) + 5, "%s\"%s\" : ", &indentTable[maxIndent - ( indent + 1 )], member->name );
-					ksJson_WriteValue( member, recursion + 1, bufferInOut, lengthInOut, offsetInOut, indent + 1, ( mapIndex == endMapIndex && i == mapMemberCount - 1 ) );
-				}
-			}
+			ksJsonWriter_AppendChar( writer, '\n' );
 		}
-		ksJson_Printf( bufferInOut, lengthInOut, offsetInOut, indent + 2, "%s}%s\n", &indentTable[maxIndent - indent], lastChild ? "" : "," );
-	}
-	else if ( node->type == JSON_ARRAY )
-	{
-		ksJson_Printf( bufferInOut, lengthInOut, offsetInOut, 2, "[\n" );
 		if ( node->memberCount > 0 )
 		{
 			const int endMapIndex = MemberIndexToMapIndex( node->memberCount - 1 );
@@ -1206,31 +3440,58 @@ static void ksJson_WriteValue( const ksJson * node, int recursion, char ** buffe
 				for ( int i = 0; i < mapMemberCount; i++ )
 				{
 					const ksJson * member = &members[i];
-					ksJson_Printf( bufferInOut, lengthInOut, offsetInOut, indent + 1, "%s", &indentTable[maxIndent - ( indent + 1 )] );
-					ksJson_WriteValue( member, recursion + 1, bufferInOut, lengthInOut, offsetInOut, indent + 1, ( mapIndex == endMapIndex && i == mapMemberCount - 1 ) );
+					ksJsonWriter_AppendIndent( writer, indent + 1 );
+					if ( node->type == JSON_OBJECT )
+					{
+						ksJsonWriter_AppendString( writer, member->name );
+						ksJsonWriter_Append( writer, writer->compact ? ":" : " : ", writer->compact ? 1 : 3 );
+					}
+					ksJson_WriteValue( writer, member, recursion + 1, indent + 1, ( mapIndex == endMapIndex && i == mapMemberCount - 1 ) );
 				}
 			}
 		}
-		ksJson_Printf( bufferInOut, lengthInOut, offsetInOut, indent + 2, "%s]%s\n", &indentTable[maxIndent - indent], lastChild ? "" : "," );
+		ksJsonWriter_AppendIndent( writer, indent );
+		ksJsonWriter_AppendChar( writer, ( node->type == JSON_OBJECT ) ? '}' : ']' );
+	}
+
+	if ( !lastChild )
+	{
+		ksJsonWriter_AppendChar( writer, ',' );
+	}
+	if ( !writer->compact )
+	{
+		ksJsonWriter_AppendChar( writer, '\n' );
 	}
+	writer->buffer[writer->offset] = '\0';
 }
 
+// Writes the DOM to a zero terminated buffer that is allocated with malloc.
 // 'lengthOut' is the length of 'bufferOut' without trailing zero.
-static bool ksJson_WriteToBuffer( const ksJson * rootNode, char ** bufferOut, int * lengthOut )
+// If 'compact' is true, then no white space is written between tokens.
+static bool ksJson_WriteToBufferEx( const ksJson * rootNode, char ** bufferOut, int * lengthOut, const bool compact )
 {
 	if ( rootNode == NULL || bufferOut == NULL || lengthOut == NULL )
 	{
 		return false;
 	}
-	*bufferOut = NULL;
-	*lengthOut = 0;
-	int offset = 0;
-	ksJson_WriteValue( rootNode, 0, bufferOut, lengthOut, &offset, 0, true );
-	*lengthOut = offset;
+	ksJsonWriter writer;
+	writer.buffer = NULL;
+	writer.length = 0;
+	writer.offset = 0;
+	writer.compact = compact;
+	ksJson_WriteValue( &writer, rootNode, 0, 0, true );
+	*bufferOut = writer.buffer;
+	*lengthOut = writer.offset;
 	return true;
 }
 
-static bool ksJson_WriteToFile( const ksJson * rootNode, const char * fileName )
+// 'lengthOut' is the length of 'bufferOut' without trailing zero.
+static bool ksJson_WriteToBuffer( const ksJson * rootNode, char ** bufferOut, int * lengthOut )
+{
+	return ksJson_WriteToBufferEx( rootNode, bufferOut, lengthOut, false );
+}
+
+static bool ksJson_WriteToFileEx( const ksJson * rootNode, const char * fileName, const bool compact )
 {
 	if ( rootNode == NULL || fileName == NULL )
 	{
@@ -1238,8 +3499,7 @@ static bool ksJson_WriteToFile( const ksJson * rootNode, const char * fileName )
 	}
 	char * buffer = NULL;
 	int length = 0;
-	int offset = 0;
-	ksJson_WriteValue( rootNode, 0, &buffer, &length, &offset, 0, true );
+	ksJson_WriteToBufferEx( rootNode, &buffer, &length, compact );
 
 	FILE * file = fopen( fileName, "wb" );
 	if ( file == NULL )
@@ -1247,7 +3507,7 @@ static bool ksJson_WriteToFile( const ksJson * rootNode, const char * fileName )
 		free( buffer );
 		return false;
 	}
-	if ( fwrite( buffer, 1, offset, file ) != (size_t) offset )
+	if ( fwrite( buffer, 1, length, file ) != (size_t) length )
 	{
 		free( buffer );
 		fclose( file );
@@ -1258,6 +3518,11 @@ static bool ksJson_WriteToFile( const ksJson * rootNode, const char * fileName )
 	return true;
 }
 
+static bool ksJson_WriteToFile( const ksJson * rootNode, const char * fileName )
+{
+	return ksJson_WriteToFileEx( rootNode, fileName, false );
+}
+
 static int ksJson_GetMemberCount( const ksJson * node )
 {
 	if ( node != NULL )
@@ -1286,11 +3551,103 @@ static ksJson * ksJson_GetMemberByIndex( const ksJson * node, const int index )
 	return NULL;
 }
 
+static uint32_t ksJson_HashName( const char * name )
+{
+	// FNV-1a
+	uint32_t hash = 2166136261U;
+	for ( const unsigned char * ptr = (const unsigned char *)name; ptr[0] != '\0'; ptr++ )
+	{
+		hash = ( hash ^ ptr[0] ) * 16777619U;
+	}
+	return hash;
+}
+
+static ksJsonHashIndex * ksJson_BuildHashIndex( const ksJson * node )
+{
+	uint32_t entryCount = 1;
+	while ( entryCount < (uint32_t)node->memberCount * 2 )
+	{
+		entryCount *= 2;
+	}
+	ksJsonHashIndex * hashIndex = (ksJsonHashIndex *) ksJson_Alloc( node->arena, sizeof( ksJsonHashIndex ) + ( entryCount - 1 ) * sizeof( ksJsonHashEntry ) );
+	hashIndex->mask = entryCount - 1;
+	for ( uint32_t i = 0; i < entryCount; i++ )
+	{
+		hashIndex->entries[i].index = -1;
+	}
+
+	int index = 0;
+	const int endMapIndex = MemberIndexToMapIndex( node->memberCount - 1 );
+	for ( int mapIndex = 0; mapIndex <= endMapIndex; mapIndex++ )
+	{
+		const ksJson * members = node->memberMap[mapIndex];
+		const int mapMemberCount = MapMemberCount( mapIndex, node->memberCount ); 
+		for ( int i = 0; i < mapMemberCount; i++, index++ )
+		{
+			if ( members[i].name == NULL )
+			{
+				continue;
+			}
+			const uint32_t hash = ksJson_HashName( members[i].name );
+			for ( uint32_t slot = hash & hashIndex->mask; ; slot = ( slot + 1 ) & hashIndex->mask )
+			{
+				ksJsonHashEntry * entry = &hashIndex->entries[slot];
+				if ( entry->index < 0 )
+				{
+					entry->hash = hash;
+					entry->index = index;
+					break;
+				}
+				// Only the first of multiple members with the same name is indexed.
+				if ( entry->hash == hash && strcmp( ksJson_GetMemberByIndex( node, entry->index )->name, members[i].name ) == 0 )
+				{
+					break;
+				}
+			}
+		}
+	}
+
+	node->memberMap[-1] = (ksJson *)(void *)hashIndex;	// mutable
+	return hashIndex;
+}
+
+// Objects are often traversed in the order in which the members are stored, so the member after the
+// last found member is always tried first. Small objects are then searched linearly, while large
+// objects use a lazily built hash index. Building the hash index is not thread-safe.
 static ksJson * ksJson_GetMemberByName( const ksJson * node, const char * name )
 {
 	if ( node != NULL && node->type == JSON_OBJECT && node->memberCount > 0 )
 	{
 		assert( name != NULL );
+		if ( node->memberCount >= JSON_HASH_MIN_MEMBERS )
+		{
+			ksJson * next = ksJson_GetMemberByIndex( node, node->memberIndex );
+			if ( strcmp( next->name, name ) == 0 )
+			{
+				*(int *)&node->memberIndex = ( node->memberIndex + 1 < node->memberCount ) ? node->memberIndex + 1 : 0;	// mutable
+				return next;
+			}
+			ksJsonHashIndex * hashIndex = ksJson_GetHashIndex( node );
+			if ( hashIndex == NULL )
+			{
+				hashIndex = ksJson_BuildHashIndex( node );
+			}
+			const uint32_t hash = ksJson_HashName( name );
+			for ( uint32_t slot = hash & hashIndex->mask; hashIndex->entries[slot].index >= 0; slot = ( slot + 1 ) & hashIndex->mask )
+			{
+				const ksJsonHashEntry * entry = &hashIndex->entries[slot];
+				if ( entry->hash == hash )
+				{
+					ksJson * member = ksJson_GetMemberByIndex( node, entry->index );
+					if ( strcmp( member->name, name ) == 0 )
+					{
+						*(int *)&node->memberIndex = ( entry->index + 1 < node->memberCount ) ? entry->index + 1 : 0;	// mutable
+						return member;
+					}
+				}
+			}
+			return NULL;
+		}
 		const int startMapIndex = MemberIndexToMapIndex( node->memberIndex );
 		const int endMapIndex = MemberIndexToMapIndex( node->memberCount - 1 );
 		int firstMemberOffset = node->memberIndex - MapMemberOffset( startMapIndex );
@@ -1474,12 +3831,12 @@ static inline const char * ksJson_GetString( const ksJson * node, const char * d
 
 static ksJson * ksJson_AddObjectMember( ksJson * node, const char * name )
 {
-	if ( node != NULL && node->type == JSON_OBJECT )
+	if ( node != NULL && node->type == JSON_OBJECT && ( node->arena == NULL || !node->arena->readOnly ) )
 	{
 		assert( name != NULL );
 		ksJson * member = ksJson_AllocMember( node );
 		const size_t length = strlen( name );
-		member->name = (char *) malloc( length + 1 );
+		member->name = (char *) ksJson_Alloc( member->arena, length + 1 );
 		strcpy( member->name, name );
 		member->name[length] = '\0';
 		return member;
@@ -1489,7 +3846,7 @@ static ksJson * ksJson_AddObjectMember( ksJson * node, const char * name )
 
 static ksJson * ksJson_AddArrayElement( ksJson * node )
 {
-	if ( node != NULL && node->type == JSON_ARRAY )
+	if ( node != NULL && node->type == JSON_ARRAY && ( node->arena == NULL || !node->arena->readOnly ) )
 	{
 		ksJson * element = ksJson_AllocMember( node );
 		return element;
@@ -1657,10 +4014,392 @@ static inline ksJson * ksJson_SetString( ksJson * node, const char * value )
 		ksJson_FreeNode( node, false );
 		node->type = JSON_STRING;
 		const int length = (int)strlen( value );
-		node->valueString = (char *) malloc( length + 1 );
+		node->valueString = (char *) ksJson_Alloc( node->arena, length + 1 );
 		strcpy( node->valueString, value );
 	}
 	return node;
 }
 
+/*
+================================================================================================================================
+
+Binary DOM snapshot.
+
+A binary snapshot stores the DOM as a little-endian image of the ksJson nodes in which all pointers are
+replaced by file offsets. The members of each object or array are stored contiguously after their parent.
+
+	ksJsonBinaryHeader		header
+	ksJson					nodes[nodeCount]		// breadth-first, the root is the first node
+	uint64_t				mapSlots[mapSlotCount]	// zero, the member maps are filled in when the snapshot is read
+	char					strings[stringSize]		// zero terminated strings, each string is only stored once
+
+In the stored nodes, 'name' and 'valueString' are file offsets, booleans store zero or one, and objects and
+arrays store the file offset of their first member. Reading a snapshot maps the file and relocates the nodes
+in place with a single pass over the node table. Nothing is parsed and nothing is allocated.
+
+================================================================================================================================
+*/
+
+#define JSON_BINARY_MAGIC		"KSJSONB"
+#define JSON_BINARY_VERSION		1
+
+typedef struct ksJsonBinaryHeader
+{
+	char		magic[8];
+	uint32_t	version;
+	uint32_t	nodeSize;		// sizeof( ksJson )
+	uint64_t	nodeCount;
+	uint64_t	mapSlotCount;
+	uint64_t	stringSize;
+} ksJsonBinaryHeader;
+
+typedef struct ksJsonBinaryStringEntry
+{
+	uint32_t	hash;
+	uint64_t	offset;			// offset + 1 in the string pool, or zero if the entry is empty
+} ksJsonBinaryStringEntry;
+
+// String pool with an open addressing hash table to store each unique string only once.
+typedef struct ksJsonBinaryStrings
+{
+	char *						pool;
+	size_t						size;
+	size_t						allocated;
+	ksJsonBinaryStringEntry *	entries;
+	uint32_t					mask;
+} ksJsonBinaryStrings;
+
+static bool ksJson_IsLittleEndian()
+{
+	const uint32_t one = 1;
+	return ( *(const uint8_t *)&one == 1 );
+}
+
+// Returns the number of pointer sized slots of the member map of an object or array with the given number of members.
+static uint64_t ksJson_BinaryMapSlotCount( const int memberCount )
+{
+	// The extra slot is the hidden hash index slot in front of the member map.
+	return ( memberCount > 0 ) ? (uint64_t)( MemberIndexToMapIndex( memberCount - 1 ) + 2 ) : 0;
+}
+
+// Returns the offset of the string in the pool.
+static uint64_t ksJson_BinaryAddString( ksJsonBinaryStrings * strings, const char * string )
+{
+	const uint32_t hash = ksJson_HashName( string );
+	uint32_t slot = hash & strings->mask;
+	for ( ; strings->entries[slot].offset != 0; slot = ( slot + 1 ) & strings->mask )
+	{
+		const ksJsonBinaryStringEntry * entry = &strings->entries[slot];
+		if ( entry->hash == hash && strcmp( strings->pool + entry->offset - 1, string ) == 0 )
+		{
+			return entry->offset - 1;
+		}
+	}
+
+	const size_t length = strlen( string ) + 1;
+	if ( strings->size + length > strings->allocated )
+	{
+		strings->allocated = JSON_MAX( strings->allocated * 2, strings->size + length );
+		strings->pool = (char *) realloc( strings->pool, strings->allocated );
+	}
+	const uint64_t offset = strings->size;
+	memcpy( strings->pool + offset, string, length );
+	strings->size += length;
+
+	strings->entries[slot].hash = hash;
+	strings->entries[slot].offset = offset + 1;
+	return offset;
+}
+
+// Writes a binary snapshot of the DOM that can be read back with ksJson_ReadBinary().
+static bool ksJson_WriteBinary( const ksJson * rootNode, const char * fileName )
+{
+	if ( rootNode == NULL || fileName == NULL || !ksJson_IsLittleEndian() )
+	{
+		return false;
+	}
+
+	// Gather the nodes breadth first so the members of each object or array end up contiguous.
+	size_t nodeCount = 1;
+	size_t nodesAllocated = 1024;
+	const ksJson ** nodes = (const ksJson **) malloc( nodesAllocated * sizeof( ksJson * ) );
+	nodes[0] = rootNode;
+	uint64_t mapSlotCount = 0;
+	size_t stringCount = 0;
+	for ( size_t i = 0; i < nodeCount; i++ )
+	{
+		const ksJson * node = nodes[i];
+		stringCount += ( node->name != NULL ) + ( node->type == JSON_STRING );
+		if ( ( node->type != JSON_OBJECT && node->type != JSON_ARRAY ) || node->memberCount <= 0 )
+		{
+			continue;
+		}
+		mapSlotCount += ksJson_BinaryMapSlotCount( node->memberCount );
+		if ( nodeCount + node->memberCount > nodesAllocated )
+		{
+			nodesAllocated = JSON_MAX( nodesAllocated * 2, nodeCount + node->memberCount );
+			nodes = (const ksJson **) realloc( nodes, nodesAllocated * sizeof( ksJson * ) );
+		}
+		const int endMapIndex = MemberIndexToMapIndex( node->memberCount - 1 );
+		for ( int mapIndex = 0; mapIndex <= endMapIndex; mapIndex++ )
+		{
+			const ksJson * members = node->memberMap[mapIndex];
+			const int mapMemberCount = MapMemberCount( mapIndex, node->memberCount ); 
+			for ( int j = 0; j < mapMemberCount; j++ )
+			{
+				nodes[nodeCount++] = &members[j];
+			}
+		}
+	}
+
+	ksJsonBinaryStrings strings;
+	uint32_t entryCount = 16;
+	while ( entryCount < stringCount * 2 )
+	{
+		entryCount *= 2;
+	}
+	strings.pool = NULL;
+	strings.size = 0;
+	strings.allocated = 0;
+	strings.entries = (ksJsonBinaryStringEntry *) calloc( entryCount, sizeof( ksJsonBinaryStringEntry ) );
+	strings.mask = entryCount - 1;
+
+	const uint64_t nodeOffset = sizeof( ksJsonBinaryHeader );
+	const uint64_t stringOffset = nodeOffset + nodeCount * sizeof( ksJson ) + mapSlotCount * sizeof( uint64_t );
+
+	// The zeroed map slots are stored right after the nodes.
+	const size_t nodesSize = nodeCount * sizeof( ksJson ) + mapSlotCount * sizeof( uint64_t );
+	ksJson * outNodes = (ksJson *) calloc( 1, nodesSize );
+	size_t firstMember = 1;
+	for ( size_t i = 0; i < nodeCount; i++ )
+	{
+		const ksJson * node = nodes[i];
+		ksJson * out = &outNodes[i];
+		out->pad = ( node->name != NULL ) ? stringOffset + ksJson_BinaryAddString( &strings, node->name ) : 0;
+		out->type = node->type;
+		if ( node->type == JSON_BOOLEAN )
+		{
+			out->valueUint64 = ( node->valueString[0] == 't' );
+		}
+		else if ( node->type == JSON_INT || node->type == JSON_UINT || node->type == JSON_FLOAT )
+		{
+			out->valueUint64 = node->valueUint64;
+		}
+		else if ( node->type == JSON_STRING )
+		{
+			out->valueUint64 = stringOffset + ksJson_BinaryAddString( &strings, node->valueString );
+		}
+		else if ( ( node->type == JSON_OBJECT || node->type == JSON_ARRAY ) && node->memberCount > 0 )
+		{
+			out->valueUint64 = nodeOffset + firstMember * sizeof( ksJson );
+			out->membersAllocated = node->memberCount;
+			out->memberCount = node->memberCount;
+			firstMember += node->memberCount;
+		}
+	}
+	free( nodes );
+	free( strings.entries );
+
+	ksJsonBinaryHeader header;
+	memset( &header, 0, sizeof( header ) );
+	memcpy( header.magic, JSON_BINARY_MAGIC, sizeof( JSON_BINARY_MAGIC ) );
+	header.version = JSON_BINARY_VERSION;
+	header.nodeSize = sizeof( ksJson );
+	header.nodeCount = nodeCount;
+	header.mapSlotCount = mapSlotCount;
+	header.stringSize = strings.size;
+
+	bool result = false;
+	FILE * file = fopen( fileName, "wb" );
+	if ( file != NULL )
+	{
+		result = ( fwrite( &header, sizeof( header ), 1, file ) == 1 );
+		result = result && ( fwrite( outNodes, 1, nodesSize, file ) == nodesSize );
+		result = result && ( strings.size == 0 || fwrite( strings.pool, 1, strings.size, file ) == strings.size );
+		result = ( fclose( file ) == 0 ) && result;
+	}
+	free( outNodes );
+	free( strings.pool );
+	return result;
+}
+
+// Validates and relocates the nodes of a binary snapshot in place. Returns an error string or NULL.
+static const char * ksJson_RelocateBinary( char * buffer, const size_t bufferSize, ksJsonArena * arena )
+{
+	if ( bufferSize < sizeof( ksJsonBinaryHeader ) )
+	{
+		return "binary file too small";
+	}
+	const ksJsonBinaryHeader * header = (const ksJsonBinaryHeader *) buffer;
+	if ( memcmp( header->magic, JSON_BINARY_MAGIC, sizeof( JSON_BINARY_MAGIC ) ) != 0 )
+	{
+		return "not a binary JSON file";
+	}
+	if ( header->version != JSON_BINARY_VERSION || header->nodeSize != sizeof( ksJson ) )
+	{
+		return "unsupported binary JSON version";
+	}
+	const uint64_t available = bufferSize - sizeof( ksJsonBinaryHeader );
+	if ( header->nodeCount < 1 || header->nodeCount > available / sizeof( ksJson ) ||
+			header->mapSlotCount > ( available - header->nodeCount * sizeof( ksJson ) ) / sizeof( uint64_t ) ||
+			header->stringSize != available - header->nodeCount * sizeof( ksJson ) - header->mapSlotCount * sizeof( uint64_t ) ||
+			( header->stringSize > 0 && buffer[bufferSize - 1] != '\0' ) )
+	{
+		return "corrupt binary JSON file";
+	}
+
+	const uint64_t nodeCount = header->nodeCount;
+	const uint64_t stringOffset = bufferSize - header->stringSize;
+	ksJson * nodes = (ksJson *)( buffer + sizeof( ksJsonBinaryHeader ) );
+	char * mapSlots = (char *)( nodes + nodeCount );
+	uint64_t mapSlot = 0;
+
+	for ( uint64_t i = 0; i < nodeCount; i++ )
+	{
+		ksJson * node = &nodes[i];
+		if ( node->type < JSON_NULL || node->type > JSON_ARRAY )
+		{
+			return "corrupt binary JSON node";
+		}
+		const uint64_t nameOffset = node->pad;
+		node->pad = 0;
+		if ( nameOffset != 0 )
+		{
+			if ( nameOffset < stringOffset || nameOffset >= bufferSize )
+			{
+				return "corrupt binary JSON name";
+			}
+			node->name = buffer + nameOffset;
+		}
+		node->pad2 = 0;
+		node->arena = arena;
+		node->memberIndex = 0;
+
+		const uint64_t value = node->valueUint64;
+		if ( node->type == JSON_NULL )
+		{
+			node->valueString = (char *)"null";
+		}
+		else if ( node->type == JSON_BOOLEAN )
+		{
+			node->valueString = ( value != 0 ) ? (char *)"true" : (char *)"false";
+		}
+		else if ( node->type == JSON_STRING )
+		{
+			if ( value < stringOffset || value >= bufferSize )
+			{
+				return "corrupt binary JSON string";
+			}
+			node->valueUint64 = 0;
+			node->valueString = buffer + value;
+		}
+		else if ( node->type == JSON_OBJECT || node->type == JSON_ARRAY )
+		{
+			const int memberCount = node->memberCount;
+			if ( memberCount <= 0 )
+			{
+				node->valueUint64 = 0;
+				node->memberMap = NULL;
+				node->membersAllocated = 0;
+				node->memberCount = 0;
+				continue;
+			}
+			// Members must follow their parent so the DOM cannot contain cycles.
+			const uint64_t memberOffset = value - sizeof( ksJsonBinaryHeader );
+			const uint64_t firstMember = memberOffset / sizeof( ksJson );
+			const uint64_t slotCount = ksJson_BinaryMapSlotCount( memberCount );
+			if ( value < sizeof( ksJsonBinaryHeader ) || ( memberOffset % sizeof( ksJson ) ) != 0 ||
+					firstMember <= i || firstMember > nodeCount || (uint64_t)memberCount > nodeCount - firstMember ||
+					slotCount > header->mapSlotCount - mapSlot )
+			{
+				return "corrupt binary JSON members";
+			}
+			// The members are not relocated yet, so a zero name offset is a missing name.
+			for ( int j = 0; j < memberCount && node->type == JSON_OBJECT; j++ )
+			{
+				if ( nodes[firstMember + j].pad == 0 )
+				{
+					return "corrupt binary JSON member name";
+				}
+			}
+			ksJson ** memberMap = (ksJson **)( mapSlots + mapSlot * sizeof( uint64_t ) ) + 1;
+			memberMap[-1] = NULL;
+			for ( int mapIndex = 0; mapIndex < (int)slotCount - 1; mapIndex++ )
+			{
+				memberMap[mapIndex] = &nodes[firstMember + MapMemberOffset( mapIndex )];
+			}
+			mapSlot += slotCount;
+			node->valueUint64 = 0;
+			node->memberMap = memberMap;
+			node->membersAllocated = memberCount;
+		}
+	}
+	return NULL;
+}
+
+// Reads a binary snapshot that was written with ksJson_WriteBinary(). The root node becomes an arena root
+// that keeps the file mapped and all nodes and strings point directly into the file. Such a DOM can be
+// queried and values can be changed, but no members or elements can be added to it.
+static bool ksJson_ReadBinary( ksJson * rootNode, const char * fileName, const char ** errorStringOut )
+{
+	if ( rootNode == NULL || fileName == NULL )
+	{
+		return false;
+	}
+	if ( errorStringOut != NULL )
+	{
+		*errorStringOut = NULL;
+	}
+	ksJson_FreeNode( rootNode, true );
+
+	const char * error = NULL;
+	size_t bufferSize = 0;
+	bool mapped = false;
+	char * buffer = ksJson_IsLittleEndian() ? ksJson_LoadFile( fileName, false, &bufferSize, &mapped, &error ) : NULL;
+	if ( buffer == NULL )
+	{
+		if ( errorStringOut != NULL )
+		{
+			*errorStringOut = ( error != NULL ) ? error : "binary JSON requires a little-endian host";
+		}
+		return false;
+	}
+
+	const bool allocatedArena = ( rootNode->arena == NULL );
+	if ( allocatedArena )
+	{
+		rootNode->arena = (ksJsonArena *) calloc( 1, sizeof( ksJsonArena ) );
+	}
+	ksJsonArena * arena = rootNode->arena;
+
+	error = ksJson_RelocateBinary( buffer, bufferSize, arena );
+	if ( error != NULL )
+	{
+		ksJson_UnloadFile( buffer, bufferSize, mapped );
+		if ( allocatedArena )
+		{
+			ksJson_FreeArena( arena );
+			rootNode->arena = NULL;
+		}
+		if ( errorStringOut != NULL )
+		{
+			*errorStringOut = error;
+		}
+		return false;
+	}
+
+	if ( arena->source != NULL )
+	{
+		ksJson_UnloadFile( arena->source, arena->sourceSize, arena->sourceMapped );
+	}
+	arena->source = buffer;
+	arena->sourceSize = bufferSize;
+	arena->sourceMapped = mapped;
+	arena->readOnly = true;
+
+	*rootNode = *(const ksJson *)( buffer + sizeof( ksJsonBinaryHeader ) );
+	rootNode->name = NULL;
+	return true;
+}
+
 #endif // !KSJSON_H
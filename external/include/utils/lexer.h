@@ -56,6 +56,37 @@ static bool ksLexer_CaseSensitiveCompareToken( const unsigned char * tokenStart,
 #if !defined( KSLEXER_H )
 #define KSLEXER_H
 
+// White space, comments and strings are scanned 16 or 32 bytes at a time when SIMD is available.
+// The text is scanned with aligned loads that never cross a page boundary and may therefore
+// read past the terminating zero. The address sanitizer flags these reads, so the scalar
+// code is used when the address sanitizer is enabled.
+#if defined( __SANITIZE_ADDRESS__ )
+	#define LEXER_SIMD_DISABLED
+#elif defined( __has_feature )
+	#if __has_feature( address_sanitizer )
+		#define LEXER_SIMD_DISABLED
+	#endif
+#endif
+
+#if !defined( LEXER_SIMD_DISABLED )
+	#if defined( __AVX2__ )
+		#include <immintrin.h>
+		#define LEXER_SIMD_AVX2
+		#define LEXER_SIMD_WIDTH		32
+		#define LEXER_SIMD_MASK_BITS	1	// number of mask bits per byte
+	#elif defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+		#include <emmintrin.h>
+		#define LEXER_SIMD_SSE2
+		#define LEXER_SIMD_WIDTH		16
+		#define LEXER_SIMD_MASK_BITS	1
+	#elif defined( __ARM_NEON ) || defined( __ARM_NEON__ ) || defined( _M_ARM64 )
+		#include <arm_neon.h>
+		#define LEXER_SIMD_NEON
+		#define LEXER_SIMD_WIDTH		16
+		#define LEXER_SIMD_MASK_BITS	4
+	#endif
+#endif
+
 typedef enum
 {
 	KS_TOKEN_TYPE_NONE,
@@ -86,6 +117,146 @@ typedef struct ksTokenInfo
 	int					linesCrossed;	// Number of lines crossed before the token.
 } ksTokenInfo;
 
+#if defined( LEXER_SIMD_WIDTH )
+
+static int ksLexer_CountTrailingZeros( uint64_t value )
+{
+	assert( value != 0 );
+#if defined( _MSC_VER ) && ( defined( _M_X64 ) || defined( _M_ARM64 ) )
+	unsigned long index;
+	_BitScanForward64( &index, value );
+	return (int) index;
+#elif defined( __GNUC__ ) || defined( __clang__ )
+	return __builtin_ctzll( value );
+#else
+	int count = 0;
+	for ( ; ( value & 1 ) == 0; value >>= 1 )
+	{
+		count++;
+	}
+	return count;
+#endif
+}
+
+static int ksLexer_PopCount( uint64_t value )
+{
+#if defined( __GNUC__ ) || defined( __clang__ )
+	return __builtin_popcountll( value );
+#else
+	value = value - ( ( value >> 1 ) & 0x5555555555555555ULL );
+	value = ( value & 0x3333333333333333ULL ) + ( ( value >> 2 ) & 0x3333333333333333ULL );
+	value = ( value + ( value >> 4 ) ) & 0x0F0F0F0F0F0F0F0FULL;
+	return (int)( ( value * 0x0101010101010101ULL ) >> 56 );
+#endif
+}
+
+// Returns a mask with LEXER_SIMD_MASK_BITS bits set for each byte that is equal to one of the given characters or zero.
+static uint64_t ksLexer_SimdCharacterMask( const unsigned char * ptr, const unsigned char c0, const unsigned char c1, const unsigned char c2 )
+{
+#if defined( LEXER_SIMD_AVX2 )
+	const __m256i v = _mm256_loadu_si256( (const __m256i *) ptr );
+	const __m256i m = _mm256_or_si256( _mm256_or_si256(
+							_mm256_cmpeq_epi8( v, _mm256_set1_epi8( (char) c0 ) ),
+							_mm256_cmpeq_epi8( v, _mm256_set1_epi8( (char) c1 ) ) ), _mm256_or_si256(
+							_mm256_cmpeq_epi8( v, _mm256_set1_epi8( (char) c2 ) ),
+							_mm256_cmpeq_epi8( v, _mm256_setzero_si256() ) ) );
+	return (uint32_t) _mm256_movemask_epi8( m );
+#elif defined( LEXER_SIMD_SSE2 )
+	const __m128i v = _mm_loadu_si128( (const __m128i *) ptr );
+	const __m128i m = _mm_or_si128( _mm_or_si128(
+							_mm_cmpeq_epi8( v, _mm_set1_epi8( (char) c0 ) ),
+							_mm_cmpeq_epi8( v, _mm_set1_epi8( (char) c1 ) ) ), _mm_or_si128(
+							_mm_cmpeq_epi8( v, _mm_set1_epi8( (char) c2 ) ),
+							_mm_cmpeq_epi8( v, _mm_setzero_si128() ) ) );
+	return (uint32_t) _mm_movemask_epi8( m );
+#elif defined( LEXER_SIMD_NEON )
+	const uint8x16_t v = vld1q_u8( ptr );
+	const uint8x16_t m = vorrq_u8( vorrq_u8(
+							vceqq_u8( v, vdupq_n_u8( c0 ) ),
+							vceqq_u8( v, vdupq_n_u8( c1 ) ) ), vorrq_u8(
+							vceqq_u8( v, vdupq_n_u8( c2 ) ),
+							vceqq_u8( v, vdupq_n_u8( 0 ) ) ) );
+	return vget_lane_u64( vreinterpret_u64_u8( vshrn_n_u16( vreinterpretq_u16_u8( m ), 4 ) ), 0 );
+#endif
+}
+
+// Returns a mask with LEXER_SIMD_MASK_BITS bits set for each byte that is not white space, including the terminating zero.
+static uint64_t ksLexer_SimdWhiteSpaceEndMask( const unsigned char * ptr )
+{
+#if defined( LEXER_SIMD_AVX2 )
+	const __m256i v = _mm256_loadu_si256( (const __m256i *) ptr );
+	const __m256i white = _mm256_cmpeq_epi8( _mm256_subs_epu8( v, _mm256_set1_epi8( ' ' ) ), _mm256_setzero_si256() );
+	const __m256i zero = _mm256_cmpeq_epi8( v, _mm256_setzero_si256() );
+	return (uint32_t)( ~_mm256_movemask_epi8( white ) | _mm256_movemask_epi8( zero ) );
+#elif defined( LEXER_SIMD_SSE2 )
+	const __m128i v = _mm_loadu_si128( (const __m128i *) ptr );
+	const __m128i white = _mm_cmpeq_epi8( _mm_subs_epu8( v, _mm_set1_epi8( ' ' ) ), _mm_setzero_si128() );
+	const __m128i zero = _mm_cmpeq_epi8( v, _mm_setzero_si128() );
+	return (uint32_t)( ~_mm_movemask_epi8( white ) | _mm_movemask_epi8( zero ) ) & 0xFFFF;
+#elif defined( LEXER_SIMD_NEON )
+	const uint8x16_t v = vld1q_u8( ptr );
+	const uint8x16_t m = vorrq_u8( vcgtq_u8( v, vdupq_n_u8( ' ' ) ), vceqq_u8( v, vdupq_n_u8( 0 ) ) );
+	return vget_lane_u64( vreinterpret_u64_u8( vshrn_n_u16( vreinterpretq_u16_u8( m ), 4 ) ), 0 );
+#endif
+}
+
+#endif // LEXER_SIMD_WIDTH
+
+// Skips characters up to the first character that is zero or, if 'whiteSpace' is true, the first character
+// that is not white space, or, if 'whiteSpace' is false, the first character that is equal to 'c0', 'c1' or 'c2'.
+// If 'linesCrossed' is not NULL, then the number of skipped new lines is added to 'linesCrossed'.
+static const unsigned char * ksLexer_SkipCharacters( const unsigned char * ptr, const bool whiteSpace,
+													const unsigned char c0, const unsigned char c1, const unsigned char c2,
+													int * linesCrossed )
+{
+	// Short runs are common, so only use SIMD after the first couple of characters.
+	for ( int i = 0; i < 2; i++ )
+	{
+		if ( ptr[0] == '\0' || ( whiteSpace ? ( ptr[0] > ' ' ) : ( ptr[0] == c0 || ptr[0] == c1 || ptr[0] == c2 ) ) )
+		{
+			return ptr;
+		}
+		if ( linesCrossed != NULL )
+		{
+			*linesCrossed += ( ptr[0] == '\n' );
+		}
+		ptr++;
+	}
+#if defined( LEXER_SIMD_WIDTH )
+	const size_t misalignment = (uintptr_t)ptr & ( LEXER_SIMD_WIDTH - 1 );
+	const unsigned char * block = ptr - misalignment;
+	uint64_t valid = ~0ULL << ( misalignment * LEXER_SIMD_MASK_BITS );
+	int newLineBits = 0;
+	for ( ; ; block += LEXER_SIMD_WIDTH, valid = ~0ULL )
+	{
+		const uint64_t stop = valid & ( whiteSpace ? ksLexer_SimdWhiteSpaceEndMask( block ) : ksLexer_SimdCharacterMask( block, c0, c1, c2 ) );
+		const uint64_t newLines = ( linesCrossed != NULL ) ? valid & ksLexer_SimdCharacterMask( block, '\n', '\n', '\n' ) : 0;
+		if ( stop != 0 )
+		{
+			const uint64_t before = ( stop & ( ~stop + 1 ) ) - 1;	// all bits below the lowest set bit
+			if ( linesCrossed != NULL )
+			{
+				// The new line mask also flags zero bytes, but a zero byte is never skipped.
+				newLineBits += ksLexer_PopCount( newLines & before );
+				*linesCrossed += newLineBits / LEXER_SIMD_MASK_BITS;
+			}
+			return block + ksLexer_CountTrailingZeros( stop ) / LEXER_SIMD_MASK_BITS;
+		}
+		newLineBits += ksLexer_PopCount( newLines );
+	}
+#else
+	while ( ptr[0] != '\0' && ( whiteSpace ? ( ptr[0] <= ' ' ) : ( ptr[0] != c0 && ptr[0] != c1 && ptr[0] != c2 ) ) )
+	{
+		if ( linesCrossed != NULL )
+		{
+			*linesCrossed += ( ptr[0] == '\n' );
+		}
+		ptr++;
+	}
+	return ptr;
+#endif
+}
+
 // Gets the next C99-style token from a zero-terminated buffer.
 // 'buffer' is the base pointer of the buffer and 'ptr' is the current pointer into the buffer.
 // A pointer to the next token is returned in 'token' and if 'tokenInfo' is not NULL, then additional information is returned in 'tokenInfo'.
@@ -100,29 +271,25 @@ static const unsigned char * ksLexer_NextToken( const unsigned char * buffer, co
 	while ( ptr[0] != '\0' )
 	{
 		// Parse white space
-		while ( ptr[0] != '\0' && ptr[0] <= ' ' )
-		{
-			linesCrossed += ( ptr[0] == '\n' );
-			ptr++;
-		}
+		ptr = ksLexer_SkipCharacters( ptr, true, 0, 0, 0, &linesCrossed );
 		// Parse comment.
 		if ( ptr[0] == '/' )
 		{
 			if ( ptr[1] == '/' )
 			{
-				ptr += 2;
-				while ( ptr[0] != '\0' && ptr[0] != '\n' )
-				{
-					ptr++;
-				}
+				ptr = ksLexer_SkipCharacters( ptr + 2, false, '\n', '\n', '\n', NULL );
 				continue;
 			}
 			else if ( ptr[1] == '*' )
 			{
 				ptr += 2;
-				while ( ptr[0] != '\0' && ( ptr[0] != '*' || ptr[1] != '/' ) )
+				for ( ; ; )
 				{
-					linesCrossed += ( ptr[0] == '\n' );
+					ptr = ksLexer_SkipCharacters( ptr, false, '*', '*', '*', &linesCrossed );
+					if ( ptr[0] == '\0' || ptr[1] == '/' )
+					{
+						break;
+					}
 					ptr++;
 				}
 				ptr += 2 * ( ptr[0] != '\0' );
@@ -194,7 +361,7 @@ static const unsigned char * ksLexer_NextToken( const unsigned char * buffer, co
 			}
 			else
 			{
-				ptr++;
+				ptr = ksLexer_SkipCharacters( ptr + 1, false, firstChar, '\\', '\n', NULL );
 			}
 		}
 		ptr++;
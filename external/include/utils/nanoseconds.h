@@ -65,8 +65,13 @@ limitations under the License.
 #if defined( OS_WINDOWS )
 	#include <windows.h>
 #elif defined( OS_LINUX )
-	#include <time.h>							// for timespec
-	#include <sys/time.h>						// for gettimeofday()
+	#include <time.h>							// for clock_gettime()
+	#include <stdio.h>							// for fopen()
+	#include <string.h>							// for strncmp()
+	#if defined( __x86_64__ ) || defined( __i386__ )
+		#include <x86intrin.h>					// for __rdtsc()
+		#include <cpuid.h>						// for __get_cpuid()
+	#endif
 #elif defined( OS_APPLE )
 	#include <sys/time.h>
 #elif defined( OS_ANDROID )
@@ -76,9 +81,149 @@ limitations under the License.
 #endif
 
 #include <stdint.h>
+#include <stdbool.h>
 
 typedef uint64_t ksNanoseconds;
 
+#if defined( OS_LINUX )
+
+/*
+================================================================================================================================
+
+On Linux the time is read from a CPU cycle counter when the counter is known to be stable.
+This avoids a system call or vDSO clock read for every time query. On x86 the time stamp counter
+is used when the CPU reports an invariant TSC and the kernel also uses the TSC as its clock source.
+On ARM64 the virtual counter (cntvct_el0) is used, which runs at a constant frequency. The counter
+frequency is calibrated against CLOCK_MONOTONIC_RAW on the first call, which takes about 10 milliseconds.
+Counter ticks are converted to nanoseconds with a 32-bit fixed-point multiplier. If no suitable
+counter is available, the time is read from CLOCK_MONOTONIC.
+
+================================================================================================================================
+*/
+
+#if defined( CLOCK_MONOTONIC_RAW )
+	#define NANOSECONDS_CALIBRATION_CLOCK		CLOCK_MONOTONIC_RAW
+#else
+	#define NANOSECONDS_CALIBRATION_CLOCK		CLOCK_MONOTONIC
+#endif
+
+#define NANOSECONDS_CALIBRATION_TIME		( 10ULL * 1000ULL * 1000ULL )
+
+typedef struct
+{
+	bool			useCounter;		// true if the cycle counter is used, false if CLOCK_MONOTONIC is used
+	uint64_t		counterBase;	// counter value at time zero
+	uint64_t		multiplier;		// nanoseconds per tick in fixed-point with 'shift' fractional bits
+	int				shift;
+	ksNanoseconds	timeBase;		// CLOCK_MONOTONIC value at time zero
+} ksNanosecondsClock;
+
+static ksNanoseconds ksNanosecondsClock_ReadClock( const clockid_t clock )
+{
+	struct timespec ts;
+	clock_gettime( clock, &ts );
+	return (ksNanoseconds) ts.tv_sec * 1000ULL * 1000ULL * 1000ULL + ts.tv_nsec;
+}
+
+static inline uint64_t ksNanosecondsClock_ReadCounter()
+{
+#if defined( __x86_64__ ) || defined( __i386__ )
+	return __rdtsc();
+#elif defined( __aarch64__ )
+	uint64_t counter;
+	__asm__ volatile( "isb; mrs %0, cntvct_el0" : "=r" ( counter ) :: "memory" );
+	return counter;
+#else
+	return 0;
+#endif
+}
+
+// Returns true if the cycle counter runs at a constant rate and is synchronized across cores.
+static bool ksNanosecondsClock_HasStableCounter()
+{
+#if defined( __x86_64__ ) || defined( __i386__ )
+	unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+	if ( __get_cpuid( 0x80000000, &eax, &ebx, &ecx, &edx ) == 0 || eax < 0x80000007 )
+	{
+		return false;
+	}
+	if ( __get_cpuid( 0x80000007, &eax, &ebx, &ecx, &edx ) == 0 || ( edx & ( 1 << 8 ) ) == 0 )
+	{
+		return false;
+	}
+	// The kernel switches away from the TSC when it detects that the TSC is not synchronized across cores.
+	bool kernelUsesTsc = false;
+	FILE * fp = fopen( "/sys/devices/system/clocksource/clocksource0/current_clocksource", "r" );
+	if ( fp != NULL )
+	{
+		char buffer[64];
+		kernelUsesTsc = ( fgets( buffer, sizeof( buffer ), fp ) != NULL && strncmp( buffer, "tsc", 3 ) == 0 );
+		fclose( fp );
+	}
+	return kernelUsesTsc;
+#elif defined( __aarch64__ )
+	return true;
+#else
+	return false;
+#endif
+}
+
+static void ksNanosecondsClock_Create( ksNanosecondsClock * clock )
+{
+	clock->useCounter = false;
+	clock->counterBase = 0;
+	clock->multiplier = 0;
+	clock->shift = 0;
+	clock->timeBase = ksNanosecondsClock_ReadClock( CLOCK_MONOTONIC );
+
+	if ( !ksNanosecondsClock_HasStableCounter() )
+	{
+		return;
+	}
+
+	// Measure the counter frequency against the raw monotonic clock, which is not slewed by NTP.
+	const ksNanoseconds time0 = ksNanosecondsClock_ReadClock( NANOSECONDS_CALIBRATION_CLOCK );
+	const uint64_t counter0 = ksNanosecondsClock_ReadCounter();
+	ksNanoseconds time1 = time0;
+	uint64_t counter1 = counter0;
+	while ( time1 - time0 < NANOSECONDS_CALIBRATION_TIME )
+	{
+		time1 = ksNanosecondsClock_ReadClock( NANOSECONDS_CALIBRATION_CLOCK );
+		counter1 = ksNanosecondsClock_ReadCounter();
+	}
+	const double ticksPerSecond = (double)( counter1 - counter0 ) * 1e9 / (double)( time1 - time0 );
+	if ( ticksPerSecond < 1e6 )
+	{
+		return;
+	}
+
+	// Use the largest shift that keeps the multiplier below 2^32 such that the 32x32-bit products cannot overflow.
+	const double nanosecondsPerTick = 1e9 / ticksPerSecond;
+	int shift = 32;
+	while ( shift > 0 && nanosecondsPerTick * (double)( 1ULL << shift ) >= 4294967296.0 )
+	{
+		shift--;
+	}
+	clock->multiplier = (uint64_t)( nanosecondsPerTick * (double)( 1ULL << shift ) + 0.5 );
+	clock->shift = shift;
+	clock->counterBase = counter1;
+	clock->useCounter = true;
+}
+
+static ksNanoseconds ksNanosecondsClock_GetTime( const ksNanosecondsClock * clock )
+{
+	if ( clock->useCounter )
+	{
+		const uint64_t delta = ksNanosecondsClock_ReadCounter() - clock->counterBase;
+		const uint64_t high = ( delta >> 32 ) * clock->multiplier;
+		const uint64_t low = ( delta & 0xFFFFFFFFULL ) * clock->multiplier;
+		return ( high << ( 32 - clock->shift ) ) + ( low >> clock->shift );
+	}
+	return ksNanosecondsClock_ReadClock( CLOCK_MONOTONIC ) - clock->timeBase;
+}
+
+#endif
+
 static ksNanoseconds GetTimeNanoseconds()
 {
 #if defined( OS_WINDOWS )
@@ -112,6 +257,18 @@ static ksNanoseconds GetTimeNanoseconds()
 	return (ksNanoseconds) ts.tv_sec * 1000ULL * 1000ULL * 1000ULL + ts.tv_nsec - timeBase;
 #elif defined( OS_HEXAGON )
 	return QURT_TIMER_TIMETICK_TO_US( qurt_timer_get_ticks() ) * 1000;
+#elif defined( OS_LINUX )
+	// The clock is created on the first call, which should be made before any additional threads are created.
+	static ksNanosecondsClock clock;
+	static bool initialized = false;
+
+	if ( !initialized )
+	{
+		ksNanosecondsClock_Create( &clock );
+		initialized = true;
+	}
+
+	return ksNanosecondsClock_GetTime( &clock );
 #else
 	static ksNanoseconds timeBase = 0;
 
@@ -72,6 +72,10 @@ limitations under the License.
 #endif
 
 #include <stdio.h>
+#include <stdlib.h>								// for strtoul()
+#include <string.h>								// for strlen(), strncmp()
+#include <stdint.h>								// for uint64_t
+#include <stdbool.h>							// for bool
 
 static const char * GetOSVersion()
 {
@@ -241,4 +245,439 @@ static const char * GetCPUVersion()
 #endif
 }
 
+/*
+================================================================================================================================
+
+CPU topology.
+
+On Linux and Android the topology is read from sysfs. Every logical core (hardware thread) is mapped
+to a physical core, a group of cores that share an L2 cache, a group of cores that share an L3 cache
+and a NUMA node. The maximum frequency and the relative compute capacity of each core are used to
+identify the clusters of a heterogeneous (big.LITTLE) CPU. The topology can also be read from a
+fixture tree that mirrors /sys/devices/system, which allows the detection to be verified for CPUs
+that are not physically present. On other platforms the topology is empty and all queries return 0.
+
+The 'fast core' is a single logical core on the fastest cluster that is best suited for a latency
+critical thread like the time warp thread. A core that is isolated from the scheduler (isolcpus)
+is preferred. Otherwise the last physical core of the fastest cluster is used, because the first
+core usually services most interrupts. The physical cores are ordered such that worker threads
+are spread over the fastest physical cores first, with the physical core of the fast core last.
+
+ksCpuTopology
+
+static bool ksCpuTopology_Create( ksCpuTopology * topology );
+static bool ksCpuTopology_CreateFromPath( ksCpuTopology * topology, const char * sysfsPath );
+static const ksCpuTopology * ksCpuTopology_Get();
+
+static uint64_t ksCpuTopology_GetBigCoreMask( const ksCpuTopology * topology );
+static int ksCpuTopology_GetFastCore( const ksCpuTopology * topology );
+static uint64_t ksCpuTopology_GetPhysicalCoreMask( const ksCpuTopology * topology, const int index );
+
+================================================================================================================================
+*/
+
+#define MAX_CPU_CORES		64
+#define CPU_CORE_MASK( x )	( 1ULL << (x) )
+
+typedef struct
+{
+	int				physicalCore;					// index of the physical core
+	int				package;						// physical package (socket)
+	int				l2Group;						// index of the group of cores that share an L2 cache, -1 if unknown
+	int				l3Group;						// index of the group of cores that share an L3 cache, -1 if unknown
+	int				numaNode;						// index of the NUMA node
+	unsigned int	maxFrequency;					// maximum frequency in kHz, 0 if unknown
+	unsigned int	capacity;						// relative compute capacity in the range [1, 1024]
+} ksCpuCore;
+
+typedef struct
+{
+	ksCpuCore		cores[MAX_CPU_CORES];			// logical cores
+	uint64_t		presentMask;					// logical cores that are present
+	uint64_t		onlineMask;						// logical cores that are online
+	uint64_t		isolatedMask;					// logical cores that are isolated from the scheduler
+	uint64_t		bigCoreMask;					// logical cores of the cluster with the highest capacity
+	uint64_t		physicalCoreMasks[MAX_CPU_CORES];	// logical cores per physical core
+	uint64_t		l2GroupMasks[MAX_CPU_CORES];	// logical cores per shared L2 cache
+	uint64_t		l3GroupMasks[MAX_CPU_CORES];	// logical cores per shared L3 cache
+	uint64_t		numaNodeMasks[MAX_CPU_CORES];	// logical cores per NUMA node
+	int				physicalCoreOrder[MAX_CPU_CORES];	// physical cores in the order workers should use them
+	int				logicalCoreCount;
+	int				physicalCoreCount;
+	int				l2GroupCount;
+	int				l3GroupCount;
+	int				numaNodeCount;
+	int				fastCore;						// logical core for a latency critical thread, -1 if unknown
+} ksCpuTopology;
+
+// Returns false if the path does not fit in the buffer.
+static bool ksCpuTopology_MakePath( char * path, const size_t pathSize, const char * directory, const char * name )
+{
+	const int length = snprintf( path, pathSize, "%s/%s", directory, name );
+	return ( length >= 0 && (size_t)length < pathSize );
+}
+
+static bool ksCpuTopology_ReadString( const char * sysfsPath, const char * fileName, char * buffer, const size_t bufferSize )
+{
+	char path[1024];
+	if ( !ksCpuTopology_MakePath( path, sizeof( path ), sysfsPath, fileName ) )
+	{
+		return false;
+	}
+	FILE * fp = fopen( path, "r" );
+	if ( fp == NULL )
+	{
+		return false;
+	}
+	const bool result = ( fgets( buffer, (int)bufferSize, fp ) != NULL );
+	fclose( fp );
+	return result;
+}
+
+// Returns the largest of a white-space separated list of numbers.
+static bool ksCpuTopology_ReadMaxUint( const char * sysfsPath, const char * fileName, unsigned int * value )
+{
+	char buffer[1024];
+	if ( !ksCpuTopology_ReadString( sysfsPath, fileName, buffer, sizeof( buffer ) ) )
+	{
+		return false;
+	}
+	bool found = false;
+	*value = 0;
+	for ( const char * ptr = buffer; *ptr != '\0'; )
+	{
+		char * end = NULL;
+		const unsigned long number = strtoul( ptr, &end, 10 );
+		if ( end == ptr )
+		{
+			break;
+		}
+		*value = ( (unsigned int)number > *value ) ? (unsigned int)number : *value;
+		found = true;
+		ptr = end;
+	}
+	return found;
+}
+
+// Parses a CPU list like "0-3,8,10-11" into a mask.
+static bool ksCpuTopology_ReadCpuList( const char * sysfsPath, const char * fileName, uint64_t * mask )
+{
+	char buffer[1024];
+	if ( !ksCpuTopology_ReadString( sysfsPath, fileName, buffer, sizeof( buffer ) ) )
+	{
+		return false;
+	}
+	*mask = 0;
+	for ( const char * ptr = buffer; *ptr != '\0' && *ptr != '\n'; )
+	{
+		char * end = NULL;
+		const unsigned long first = strtoul( ptr, &end, 10 );
+		if ( end == ptr )
+		{
+			break;
+		}
+		unsigned long last = first;
+		ptr = end;
+		if ( *ptr == '-' )
+		{
+			last = strtoul( ptr + 1, &end, 10 );
+			ptr = end;
+		}
+		for ( unsigned long cpu = first; cpu <= last && cpu < MAX_CPU_CORES; cpu++ )
+		{
+			*mask |= CPU_CORE_MASK( cpu );
+		}
+		if ( *ptr == ',' )
+		{
+			ptr++;
+		}
+	}
+	return true;
+}
+
+static int ksCpuTopology_FirstCore( const uint64_t mask )
+{
+	for ( int cpu = 0; cpu < MAX_CPU_CORES; cpu++ )
+	{
+		if ( ( mask & CPU_CORE_MASK( cpu ) ) != 0 )
+		{
+			return cpu;
+		}
+	}
+	return -1;
+}
+
+// Returns the index of the group with the given mask, adding the group if it does not exist yet.
+static int ksCpuTopology_FindOrAddGroup( uint64_t * groupMasks, int * groupCount, const uint64_t mask )
+{
+	for ( int i = 0; i < *groupCount; i++ )
+	{
+		if ( groupMasks[i] == mask )
+		{
+			return i;
+		}
+	}
+	groupMasks[*groupCount] = mask;
+	return (*groupCount)++;
+}
+
+static bool ksCpuTopology_CreateFromPath( ksCpuTopology * topology, const char * sysfsPath )
+{
+	memset( topology, 0, sizeof( ksCpuTopology ) );
+	topology->fastCore = -1;
+
+	char cpuPath[1024];
+	if ( !ksCpuTopology_MakePath( cpuPath, sizeof( cpuPath ), sysfsPath, "cpu" ) )
+	{
+		return false;
+	}
+
+	if ( !ksCpuTopology_ReadCpuList( cpuPath, "present", &topology->presentMask ) &&
+			!ksCpuTopology_ReadCpuList( cpuPath, "possible", &topology->presentMask ) )
+	{
+		return false;
+	}
+	if ( !ksCpuTopology_ReadCpuList( cpuPath, "online", &topology->onlineMask ) )
+	{
+		topology->onlineMask = topology->presentMask;
+	}
+	if ( !ksCpuTopology_ReadCpuList( cpuPath, "isolated", &topology->isolatedMask ) )
+	{
+		topology->isolatedMask = 0;
+	}
+
+	unsigned int highestFrequency = 0;
+	bool hasCapacity = false;
+
+	for ( int cpu = 0; cpu < MAX_CPU_CORES; cpu++ )
+	{
+		if ( ( topology->presentMask & CPU_CORE_MASK( cpu ) ) == 0 )
+		{
+			continue;
+		}
+		topology->logicalCoreCount = cpu + 1;
+
+		ksCpuCore * core = &topology->cores[cpu];
+		char coreName[16];
+		char corePath[1024];
+		snprintf( coreName, sizeof( coreName ), "cpu%d", cpu );
+		if ( !ksCpuTopology_MakePath( corePath, sizeof( corePath ), cpuPath, coreName ) )
+		{
+			return false;
+		}
+
+		uint64_t siblingsMask = 0;
+		if ( !ksCpuTopology_ReadCpuList( corePath, "topology/core_cpus_list", &siblingsMask ) &&
+				!ksCpuTopology_ReadCpuList( corePath, "topology/thread_siblings_list", &siblingsMask ) )
+		{
+			siblingsMask = CPU_CORE_MASK( cpu );
+		}
+		core->physicalCore = ksCpuTopology_FindOrAddGroup( topology->physicalCoreMasks, &topology->physicalCoreCount, siblingsMask | CPU_CORE_MASK( cpu ) );
+
+		unsigned int package = 0;
+		ksCpuTopology_ReadMaxUint( corePath, "topology/physical_package_id", &package );
+		core->package = (int)package;
+
+		core->l2Group = -1;
+		core->l3Group = -1;
+		for ( int index = 0; index < 16; index++ )
+		{
+			char cacheFile[128];
+			unsigned int level = 0;
+			snprintf( cacheFile, sizeof( cacheFile ), "cache/index%d/level", index );
+			if ( !ksCpuTopology_ReadMaxUint( corePath, cacheFile, &level ) )
+			{
+				break;
+			}
+			char type[128];
+			snprintf( cacheFile, sizeof( cacheFile ), "cache/index%d/type", index );
+			if ( ksCpuTopology_ReadString( corePath, cacheFile, type, sizeof( type ) ) && strncmp( type, "Instruction", 11 ) == 0 )
+			{
+				continue;
+			}
+			uint64_t sharedMask = 0;
+			snprintf( cacheFile, sizeof( cacheFile ), "cache/index%d/shared_cpu_list", index );
+			if ( !ksCpuTopology_ReadCpuList( corePath, cacheFile, &sharedMask ) )
+			{
+				continue;
+			}
+			if ( level == 2 )
+			{
+				core->l2Group = ksCpuTopology_FindOrAddGroup( topology->l2GroupMasks, &topology->l2GroupCount, sharedMask | CPU_CORE_MASK( cpu ) );
+			}
+			else if ( level == 3 )
+			{
+				core->l3Group = ksCpuTopology_FindOrAddGroup( topology->l3GroupMasks, &topology->l3GroupCount, sharedMask | CPU_CORE_MASK( cpu ) );
+			}
+		}
+
+		const char * frequencyFiles[] =
+		{
+			"cpufreq/scaling_available_frequencies",	// not available on all devices
+			"cpufreq/scaling_max_freq",					// no user read permission on all devices
+			"cpufreq/cpuinfo_max_freq",					// could be set lower than the actual max, but better than nothing
+		};
+		for ( int i = 0; i < (int)( sizeof( frequencyFiles ) / sizeof( frequencyFiles[0] ) ); i++ )
+		{
+			if ( ksCpuTopology_ReadMaxUint( corePath, frequencyFiles[i], &core->maxFrequency ) && core->maxFrequency != 0 )
+			{
+				break;
+			}
+		}
+		highestFrequency = ( core->maxFrequency > highestFrequency ) ? core->maxFrequency : highestFrequency;
+
+		// The capacity is only available on heterogeneous CPUs with energy aware scheduling.
+		if ( ksCpuTopology_ReadMaxUint( corePath, "cpu_capacity", &core->capacity ) && core->capacity != 0 )
+		{
+			hasCapacity = true;
+		}
+	}
+
+	// Derive the capacity from the maximum frequency if the kernel does not expose it.
+	for ( int cpu = 0; cpu < topology->logicalCoreCount; cpu++ )
+	{
+		ksCpuCore * core = &topology->cores[cpu];
+		if ( !hasCapacity || core->capacity == 0 )
+		{
+			core->capacity = ( highestFrequency != 0 ) ? (unsigned int)( ( 1024ULL * core->maxFrequency ) / highestFrequency ) : 1024;
+			core->capacity = ( core->capacity != 0 ) ? core->capacity : 1;
+		}
+	}
+
+	// Assign the NUMA nodes. Without NUMA support all cores are on a single node.
+	char nodePath[1024];
+	if ( !ksCpuTopology_MakePath( nodePath, sizeof( nodePath ), sysfsPath, "node" ) )
+	{
+		return false;
+	}
+	for ( int node = 0; node < MAX_CPU_CORES; node++ )
+	{
+		char nodeFile[128];
+		uint64_t nodeMask = 0;
+		snprintf( nodeFile, sizeof( nodeFile ), "node%d/cpulist", node );
+		if ( !ksCpuTopology_ReadCpuList( nodePath, nodeFile, &nodeMask ) || ( nodeMask & topology->presentMask ) == 0 )
+		{
+			continue;
+		}
+		const int index = topology->numaNodeCount++;
+		topology->numaNodeMasks[index] = nodeMask & topology->presentMask;
+		for ( int cpu = 0; cpu < topology->logicalCoreCount; cpu++ )
+		{
+			if ( ( nodeMask & CPU_CORE_MASK( cpu ) ) != 0 )
+			{
+				topology->cores[cpu].numaNode = index;
+			}
+		}
+	}
+	if ( topology->numaNodeCount == 0 )
+	{
+		topology->numaNodeMasks[0] = topology->presentMask;
+		topology->numaNodeCount = 1;
+	}
+
+	// Find the cluster with the highest capacity among the online cores.
+	unsigned int highestCapacity = 0;
+	for ( int cpu = 0; cpu < topology->logicalCoreCount; cpu++ )
+	{
+		if ( ( topology->onlineMask & CPU_CORE_MASK( cpu ) ) != 0 && topology->cores[cpu].capacity > highestCapacity )
+		{
+			highestCapacity = topology->cores[cpu].capacity;
+		}
+	}
+	for ( int cpu = 0; cpu < topology->logicalCoreCount; cpu++ )
+	{
+		if ( ( topology->onlineMask & CPU_CORE_MASK( cpu ) ) != 0 && topology->cores[cpu].capacity == highestCapacity )
+		{
+			topology->bigCoreMask |= CPU_CORE_MASK( cpu );
+		}
+	}
+
+	// Select the fast core: the first isolated big core, otherwise the first thread of the last big physical core.
+	for ( int cpu = 0; cpu < topology->logicalCoreCount && topology->fastCore < 0; cpu++ )
+	{
+		if ( ( topology->bigCoreMask & topology->isolatedMask & CPU_CORE_MASK( cpu ) ) != 0 )
+		{
+			topology->fastCore = cpu;
+		}
+	}
+	for ( int cpu = topology->logicalCoreCount - 1; cpu >= 0 && topology->fastCore < 0; cpu-- )
+	{
+		if ( ( topology->bigCoreMask & CPU_CORE_MASK( cpu ) ) != 0 )
+		{
+			topology->fastCore = ksCpuTopology_FirstCore( topology->physicalCoreMasks[topology->cores[cpu].physicalCore] & topology->bigCoreMask );
+		}
+	}
+
+	// Order the physical cores by descending capacity with the physical core of the fast core last.
+	for ( int i = 0; i < topology->physicalCoreCount; i++ )
+	{
+		topology->physicalCoreOrder[i] = i;
+	}
+	const int fastPhysicalCore = ( topology->fastCore >= 0 ) ? topology->cores[topology->fastCore].physicalCore : -1;
+	for ( int i = 1; i < topology->physicalCoreCount; i++ )
+	{
+		for ( int j = i; j > 0; j-- )
+		{
+			const int a = topology->physicalCoreOrder[j - 1];
+			const int b = topology->physicalCoreOrder[j];
+			const unsigned int capacityA = ( a == fastPhysicalCore ) ? 0 : topology->cores[ksCpuTopology_FirstCore( topology->physicalCoreMasks[a] )].capacity;
+			const unsigned int capacityB = ( b == fastPhysicalCore ) ? 0 : topology->cores[ksCpuTopology_FirstCore( topology->physicalCoreMasks[b] )].capacity;
+			if ( capacityA >= capacityB )
+			{
+				break;
+			}
+			topology->physicalCoreOrder[j - 1] = b;
+			topology->physicalCoreOrder[j] = a;
+		}
+	}
+
+	return true;
+}
+
+static bool ksCpuTopology_Create( ksCpuTopology * topology )
+{
+#if defined( OS_LINUX ) || defined( OS_ANDROID )
+	return ksCpuTopology_CreateFromPath( topology, "/sys/devices/system" );
+#else
+	memset( topology, 0, sizeof( ksCpuTopology ) );
+	topology->fastCore = -1;
+	return false;
+#endif
+}
+
+// Returns the topology of the CPU this process is running on.
+// The topology is detected on the first call which should be made before any additional threads are created.
+static const ksCpuTopology * ksCpuTopology_Get()
+{
+	static ksCpuTopology topology;
+	static bool initialized = false;
+	if ( !initialized )
+	{
+		ksCpuTopology_Create( &topology );
+		initialized = true;
+	}
+	return &topology;
+}
+
+static uint64_t ksCpuTopology_GetBigCoreMask( const ksCpuTopology * topology )
+{
+	return topology->bigCoreMask;
+}
+
+static int ksCpuTopology_GetFastCore( const ksCpuTopology * topology )
+{
+	return topology->fastCore;
+}
+
+// Returns the logical cores of the physical core that should be used by the worker with the given index.
+static uint64_t ksCpuTopology_GetPhysicalCoreMask( const ksCpuTopology * topology, const int index )
+{
+	if ( topology->physicalCoreCount == 0 )
+	{
+		return 0;
+	}
+	const int physicalCore = topology->physicalCoreOrder[index % topology->physicalCoreCount];
+	return topology->physicalCoreMasks[physicalCore] & topology->onlineMask;
+}
+
 #endif // !KSSYSINFO_H
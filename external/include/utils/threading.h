@@ -85,6 +85,9 @@ limitations under the License.
 
 #include <stdbool.h>
 #include "nanoseconds.h"
+#if !defined( OS_HEXAGON )
+#include "sysinfo.h"
+#endif
 
 #if !defined( UNUSED_PARM )
 #define UNUSED_PARM( x )				{ (void)(x); }
@@ -99,6 +102,8 @@ limitations under the License.
 
 Atomic 32-bit unsigned integer
 
+The increment and decrement return the new value.
+
 ================================================================================================================================
 */
 
@@ -111,7 +116,7 @@ static ksAtomicUint32 ksAtomicUint32_Increment( ksAtomicUint32 * atomicUint32 )
 #elif defined( OS_HEXAGON )
 	return qurt_atomic_inc_return( atomicUint32 );
 #else
-	return __sync_fetch_and_add( atomicUint32, 1 );
+	return __sync_add_and_fetch( atomicUint32, 1 );
 #endif
 }
 
@@ -122,7 +127,7 @@ static ksAtomicUint32 ksAtomicUint32_Decrement( ksAtomicUint32 * atomicUint32 )
 #elif defined( OS_HEXAGON )
 	return qurt_atomic_dec_return( atomicUint32 );
 #else
-	return __sync_fetch_and_add( atomicUint32, -1 );
+	return __sync_sub_and_fetch( atomicUint32, 1 );
 #endif
 }
 
@@ -496,6 +501,7 @@ static void ksThread_Submit( ksThread * thread, ksThreadFunction threadFunction,
 
 static void ksThread_SetName( const char * name );
 static void ksThread_SetAffinity( int mask );
+static void ksThread_SetAffinityMask( const uint64_t mask );
 static void ksThread_SetRealTimePriority( int priority );
 
 ================================================================================================================================
@@ -517,7 +523,8 @@ typedef void (*ksThreadFunction)( void * data );
 #define THREAD_RETURN_VALUE		0
 #endif
 
-#define THREAD_AFFINITY_BIG_CORES		-1
+#define THREAD_AFFINITY_BIG_CORES		-1		// all cores of the fastest cluster
+#define THREAD_AFFINITY_FAST_CORE		-2		// a single fast, preferably isolated core for a latency critical thread
 
 typedef struct
 {
@@ -571,15 +578,12 @@ static void ksThread_SetName( const char * name )
 #endif
 }
 
-static void ksThread_SetAffinity( int mask )
+// Sets the affinity of the calling thread to the logical cores in the 64-bit mask.
+static void ksThread_SetAffinityMask( const uint64_t mask )
 {
 #if defined( OS_WINDOWS )
-	if ( mask == THREAD_AFFINITY_BIG_CORES )
-	{
-		return;
-	}
 	HANDLE thread = GetCurrentThread();
-	if ( !SetThreadAffinityMask( thread, mask ) )
+	if ( !SetThreadAffinityMask( thread, (DWORD_PTR)mask ) )
 	{
 		char buffer[1024];
 		DWORD error = GetLastError();
@@ -588,20 +592,17 @@ static void ksThread_SetAffinity( int mask )
 	}
 	else
 	{
-		printf( "Thread %p affinity set to 0x%02X\n", thread, mask );
+		printf( "Thread %p affinity set to 0x%02llX\n", thread, (unsigned long long)mask );
 	}
 #elif defined( OS_LINUX )
-	if ( mask == THREAD_AFFINITY_BIG_CORES )
-	{
-		return;
-	}
 	cpu_set_t set;
 	memset( &set, 0, sizeof( cpu_set_t ) );
-	for ( int bit = 0; bit < 32; bit++ )
+	const int bitsPerWord = 8 * sizeof( set.__bits[0] );
+	for ( int bit = 0; bit < 64; bit++ )
 	{
-		if ( ( mask & ( 1 << bit ) ) != 0 )
+		if ( ( mask & ( 1ULL << bit ) ) != 0 )
 		{
-			set.__bits[bit / sizeof( set.__bits[0] )] |= 1 << ( bit & ( sizeof( set.__bits[0] ) - 1 ) );
+			set.__bits[bit / bitsPerWord] |= (__cpu_mask)1 << ( bit % bitsPerWord );
 		}
 	}
 	const int result = pthread_setaffinity_np( pthread_self(), sizeof( cpu_set_t ), &set );
@@ -611,90 +612,52 @@ static void ksThread_SetAffinity( int mask )
 	}
 	else
 	{
-		printf( "Thread %d affinity set to 0x%02X\n", (unsigned int)pthread_self(), mask );
+		printf( "Thread %d affinity set to 0x%02llX\n", (unsigned int)pthread_self(), (unsigned long long)mask );
 	}
 #elif defined( OS_APPLE )
 	// macOS and iOS do not export interfaces that identify processors or control thread placement.
 	UNUSED_PARM( mask );
 #elif defined( OS_ANDROID )
-	// Optionally use the faster cores of a heterogeneous CPU.
-	if ( mask == THREAD_AFFINITY_BIG_CORES )
-	{
-		mask = 0;
-		unsigned int bestFrequency = 0;
-		for ( int i = 0; i < 16; i++ )
-		{
-			int maxFrequency = 0;
-			const char * files[] =
-			{
-				"scaling_available_frequencies",	// not available on all devices
-				"scaling_max_freq",					// no user read permission on all devices
-				"cpuinfo_max_freq",					// could be set lower than the actual max, but better than nothing
-			};
-			for ( int j = 0; j < ARRAY_SIZE( files ); j++ )
-			{
-				char fileName[1024];
-				sprintf( fileName, "/sys/devices/system/cpu/cpu%d/cpufreq/%s", i, files[j] );
-				FILE * fp = fopen( fileName, "r" );
-				if ( fp == NULL )
-				{
-					continue;
-				}
-				char buffer[1024];
-				if ( fgets( buffer, sizeof( buffer ), fp ) == NULL )
-				{
-					fclose( fp );
-					continue;
-				}
-				for ( int index = 0; buffer[index] != '\0'; )
-				{
-					const unsigned int frequency = atoi( buffer + index );
-					maxFrequency = ( frequency > maxFrequency ) ? frequency : maxFrequency;
-					while ( isspace( buffer[index] ) ) { index++; }
-					while ( isdigit( buffer[index] ) ) { index++; }
-				}
-				fclose( fp );
-				break;
-			}
-			if ( maxFrequency == 0 )
-			{
-				break;
-			}
-
-			if ( maxFrequency == bestFrequency )
-			{
-				mask |= ( 1 << i );
-			}
-			else if ( maxFrequency > bestFrequency )
-			{
-				mask = ( 1 << i );
-				bestFrequency = maxFrequency;
-			}
-		}
-
-		if ( mask == 0 )
-		{
-			return;
-		}
-	}
-
-	// Set the thread affinity.
 	pid_t pid = gettid();
 	int syscallres = syscall( __NR_sched_setaffinity, pid, sizeof( mask ), &mask );
 	if ( syscallres )
 	{
 		int err = errno;
-		printf( "    Error sched_setaffinity(%d): thread=(%d) mask=0x%X err=%s(%d)\n", __NR_sched_setaffinity, pid, mask, strerror( err ), err );
+		printf( "    Error sched_setaffinity(%d): thread=(%d) mask=0x%llX err=%s(%d)\n", __NR_sched_setaffinity, pid, (unsigned long long)mask, strerror( err ), err );
 	}
 	else
 	{
-		printf( "    Thread %d affinity 0x%02X\n", pid, mask );
+		printf( "    Thread %d affinity 0x%02llX\n", pid, (unsigned long long)mask );
 	}
 #else
 	UNUSED_PARM( mask );
 #endif
 }
 
+// Sets the affinity of the calling thread to the logical cores in the 32-bit mask.
+// THREAD_AFFINITY_BIG_CORES selects all cores of the fastest cluster of a heterogeneous CPU.
+// THREAD_AFFINITY_FAST_CORE selects a single fast core, preferably one that is isolated from the scheduler.
+// These special values are ignored on platforms where the CPU topology is unknown.
+static void ksThread_SetAffinity( int mask )
+{
+	if ( mask == THREAD_AFFINITY_BIG_CORES || mask == THREAD_AFFINITY_FAST_CORE )
+	{
+#if defined( OS_LINUX ) || defined( OS_ANDROID )
+		const ksCpuTopology * topology = ksCpuTopology_Get();
+		const int fastCore = ksCpuTopology_GetFastCore( topology );
+		const uint64_t cores = ( mask == THREAD_AFFINITY_FAST_CORE && fastCore >= 0 ) ?
+								CPU_CORE_MASK( fastCore ) :
+								ksCpuTopology_GetBigCoreMask( topology );
+		if ( cores != 0 )
+		{
+			ksThread_SetAffinityMask( cores );
+		}
+#endif
+		return;
+	}
+	ksThread_SetAffinityMask( (unsigned int)mask );
+}
+
 static void ksThread_SetRealTimePriority( int priority )
 {
 #if defined( OS_WINDOWS )
@@ -924,11 +887,23 @@ typedef struct
 	int			threadCount;
 } ksThreadPool;
 
+// Spread the workers over the physical cores, fastest cores first.
 void PoolStartThread( void * data )
 {
+#if !defined( OS_HEXAGON )
+	const uint64_t cores = ksCpuTopology_GetPhysicalCoreMask( ksCpuTopology_Get(), (int)(size_t)data );
+	if ( cores != 0 )
+	{
+		ksThread_SetAffinityMask( cores );
+	}
+	else
+	{
+		ksThread_SetAffinity( THREAD_AFFINITY_BIG_CORES );
+	}
+#else
 	UNUSED_PARM( data );
-
 	ksThread_SetAffinity( THREAD_AFFINITY_BIG_CORES );
+#endif
 	ksThread_SetRealTimePriority( 1 );
 }
 
@@ -941,11 +916,14 @@ static void ksThreadPool_Create( ksThreadPool * pool, const int numWorkers )
 	{
 		pool->threadCount = num_threads.max_hthreads;
 	}
+#else
+	// Detect the CPU topology before any of the workers query it.
+	ksCpuTopology_Get();
 #endif
 
 	for ( int i = 0; i < pool->threadCount; i++ )
 	{
-		ksThread_Create( &pool->threads[i], "worker", PoolStartThread, NULL );
+		ksThread_Create( &pool->threads[i], "worker", PoolStartThread, (void *)(size_t)i );
 		ksThread_Signal( &pool->threads[i] );
 		ksThread_Join( &pool->threads[i] );
 	}
@@ -175,6 +175,7 @@ COMMAND-LINE INPUT
 The following command-line options can be used to change various settings.
 
 	-a <.json>	load glTF scene
+	-k <file>	baked glTF scene cache, written if missing or out of date
 	-f			start fullscreen
 	-v <s>		start with V-Sync disabled for this many seconds
 	-h			start with head rotation disabled
@@ -781,23 +782,28 @@ Frame logging.
 Each thread that calls ksFrameLog_Open will open its own log.
 A frame log is always opened for a specified number of frames, and will
 automatically close after the specified number of frames have been recorded.
-The CPU and GPU times for the recorded frames will be listed at the end of the log.
+The CPU and GPU times for the recorded frames will be listed at the end of the log,
+together with any stats that were set for the frame.
 
 ksFrameLog
 
 static void ksFrameLog_Open( const char * fileName, const int frameCount );
 static void ksFrameLog_Write( const char * fileName, const int lineNumber, const char * function );
 static void ksFrameLog_BeginFrame();
+static void ksFrameLog_SetFrameStats( const char * format, ... );
 static void ksFrameLog_EndFrame( const ksNanoseconds cpuTimeNanoseconds, const ksNanoseconds gpuTimeNanoseconds, const int gpuTimeFramesDelayed );
 
 ================================================================================================================================
 */
 
+#define FRAME_LOG_STATS_LENGTH		256
+
 typedef struct
 {
 	FILE *			fp;
 	ksNanoseconds *	frameCpuTimes;
 	ksNanoseconds *	frameGpuTimes;
+	char			( * frameStats )[FRAME_LOG_STATS_LENGTH];
 	int				frameCount;
 	int				frame;
 } ksFrameLog;
@@ -833,6 +839,7 @@ static void ksFrameLog_Open( const char * fileName, const int frameCount )
 			l->frameGpuTimes = (ksNanoseconds *) malloc( frameCount * sizeof( l->frameGpuTimes[0] ) );
 			memset( l->frameCpuTimes, 0, frameCount * sizeof( l->frameCpuTimes[0] ) );
 			memset( l->frameGpuTimes, 0, frameCount * sizeof( l->frameGpuTimes[0] ) );
+			l->frameStats = (char (*)[FRAME_LOG_STATS_LENGTH]) calloc( frameCount, sizeof( l->frameStats[0] ) );
 			l->frameCount = frameCount;
 			l->frame = 0;
 		}
@@ -865,6 +872,21 @@ static void ksFrameLog_BeginFrame()
 	}
 }
 
+static void ksFrameLog_SetFrameStats( const char * format, ... )
+{
+	ksFrameLog * l = ksFrameLog_Get();
+	if ( l != NULL && l->fp != NULL )
+	{
+		if ( l->frame < l->frameCount )
+		{
+			va_list args;
+			va_start( args, format );
+			vsnprintf( l->frameStats[l->frame], sizeof( l->frameStats[0] ), format, args );
+			va_end( args );
+		}
+	}
+}
+
 static void ksFrameLog_EndFrame( const ksNanoseconds cpuTimeNanoseconds, const ksNanoseconds gpuTimeNanoseconds, const int gpuTimeFramesDelayed )
 {
 	ksFrameLog * l = ksFrameLog_Get();
@@ -888,13 +910,15 @@ static void ksFrameLog_EndFrame( const ksNanoseconds cpuTimeNanoseconds, const k
 		{
 			for ( int i = 0; i < l->frameCount; i++ )
 			{
-				fprintf( l->fp, "frame %d: CPU = %1.1f ms, GPU = %1.1f ms\r\n", i, l->frameCpuTimes[i] * 1e-6f, l->frameGpuTimes[i] * 1e-6f );
+				fprintf( l->fp, "frame %d: CPU = %1.1f ms, GPU = %1.1f ms%s%s\r\n", i, l->frameCpuTimes[i] * 1e-6f, l->frameGpuTimes[i] * 1e-6f,
+							( l->frameStats[i][0] != '\0' ) ? ", " : "", l->frameStats[i] );
 			}
 
 			Print( "Closing frame log file (%d frames).\n", l->frameCount );
 			fclose( l->fp );
 			free( l->frameCpuTimes );
 			free( l->frameGpuTimes );
+			free( l->frameStats );
 			memset( l, 0, sizeof( ksFrameLog ) );
 		}
 	}
@@ -6658,6 +6682,8 @@ static void ksGpuGeometry_Create( ksGpuContext * context, ksGpuGeometry * geomet
 static void ksGpuGeometry_CreateQuad( ksGpuContext * context, ksGpuGeometry * geometry, const float offset, const float scale );
 static void ksGpuGeometry_CreateCube( ksGpuContext * context, ksGpuGeometry * geometry, const float offset, const float scale );
 static void ksGpuGeometry_CreateTorus( ksGpuContext * context, ksGpuGeometry * geometry, const int tesselation, const float offset, const float scale );
+static void ksGpuGeometry_CreateRange( ksGpuContext * context, ksGpuGeometry * geometry, const ksGpuGeometry * other,
+								const int firstIndex, const int indexCount, const int vertexOffset, const int vertexCount );
 static void ksGpuGeometry_Destroy( ksGpuContext * context, ksGpuGeometry * geometry );
 
 static void ksGpuGeometry_AddInstanceAttributes( ksGpuContext * context, ksGpuGeometry * geometry, const int numInstances, const int instanceAttribsFlags );
@@ -6673,6 +6699,9 @@ typedef struct
 	int								vertexCount;
 	int								instanceCount;
 	int 							indexCount;
+	int								firstIndex;			// first index of a geometry range in the index buffer
+	int								vertexOffset;		// offset added to the indices of a geometry range
+	int								storedVertexCount;	// number of vertices stored in the vertex buffer
 	ksGpuBuffer						vertexBuffer;
 	ksGpuBuffer						instanceBuffer;
 	ksGpuBuffer						indexBuffer;
@@ -6688,6 +6717,7 @@ static void ksGpuGeometry_Create( ksGpuContext * context, ksGpuGeometry * geomet
 	geometry->vertexAttribsFlags = attribs->attribsFlags;
 	geometry->vertexCount = attribs->vertexCount;
 	geometry->indexCount = indices->indexCount;
+	geometry->storedVertexCount = attribs->vertexCount;
 
 	if ( attribs->buffer != NULL )
 	{
@@ -6707,6 +6737,28 @@ static void ksGpuGeometry_Create( ksGpuContext * context, ksGpuGeometry * geomet
 	}
 }
 
+// Creates geometry that references a range of the indices and vertices of other geometry.
+// This allows many small meshes to be stored in a single vertex buffer and a single index buffer.
+static void ksGpuGeometry_CreateRange( ksGpuContext * context, ksGpuGeometry * geometry, const ksGpuGeometry * other,
+								const int firstIndex, const int indexCount, const int vertexOffset, const int vertexCount )
+{
+	assert( firstIndex >= 0 && ( firstIndex + indexCount ) * sizeof( ksGpuTriangleIndex ) <= other->indexBuffer.size );
+	assert( vertexOffset >= 0 && vertexOffset + vertexCount <= other->storedVertexCount );
+
+	memset( geometry, 0, sizeof( ksGpuGeometry ) );
+
+	geometry->layout = other->layout;
+	geometry->vertexAttribsFlags = other->vertexAttribsFlags;
+	geometry->vertexCount = vertexCount;
+	geometry->indexCount = indexCount;
+	geometry->firstIndex = firstIndex;
+	geometry->vertexOffset = vertexOffset;
+	geometry->storedVertexCount = other->storedVertexCount;
+
+	ksGpuBuffer_CreateReference( context, &geometry->vertexBuffer, &other->vertexBuffer );
+	ksGpuBuffer_CreateReference( context, &geometry->indexBuffer, &other->indexBuffer );
+}
+
 // The quad is centered about the origin and without offset/scale spans the [-1, 1] X-Y range.
 static void ksGpuGeometry_CreateQuad( ksGpuContext * context, ksGpuGeometry * geometry, const float offset, const float scale )
 {
@@ -8080,8 +8132,9 @@ static void ksGpuGraphicsPipelineParms_Init( ksGpuGraphicsPipelineParms * parms
 	parms->geometry = NULL;
 }
 
+// The vertex offset of a geometry range is added to the attribute offsets because glDrawElementsBaseVertex is not always available.
 static void InitVertexAttributes( const bool instance,
-								const ksGpuVertexAttribute * vertexLayout, const int numAttribs,
+								const ksGpuVertexAttribute * vertexLayout, const int numAttribs, const int firstAttrib,
 								const int storedAttribsFlags, const int usedAttribsFlags,
 								GLuint * attribLocationCount )
 {
@@ -8099,7 +8152,7 @@ static void InitVertexAttributes( const bool instance,
 				{
 					GL( glEnableVertexAttribArray( *attribLocationCount + location ) );
 					GL( glVertexAttribPointer( *attribLocationCount + location, v->attributeFormat >> 16, v->attributeFormat & 0xFFFF, GL_FALSE,
-												(GLsizei)attribStride, (void *)( offset + location * attribLocationSize ) ) );
+												(GLsizei)attribStride, (void *)( offset + firstAttrib * attribStride + location * attribLocationSize ) ) );
 					GL( glVertexAttribDivisor( *attribLocationCount + location, instance ? 1 : 0 ) );
 				}
 				*attribLocationCount += v->locationCount;
@@ -8131,14 +8184,14 @@ static bool ksGpuGraphicsPipeline_Create( ksGpuContext * context, ksGpuGraphicsP
 
 	GL( glBindBuffer( parms->geometry->vertexBuffer.target, parms->geometry->vertexBuffer.buffer ) );
 	InitVertexAttributes( false, parms->geometry->layout,
-							parms->geometry->vertexCount, parms->geometry->vertexAttribsFlags,
+							parms->geometry->storedVertexCount, parms->geometry->vertexOffset, parms->geometry->vertexAttribsFlags,
 							parms->program->vertexAttribsFlags, &attribLocationCount );
 
 	if ( parms->geometry->instanceBuffer.buffer != 0 )
 	{
 		GL( glBindBuffer( parms->geometry->instanceBuffer.target, parms->geometry->instanceBuffer.buffer ) );
 		InitVertexAttributes( true, parms->geometry->layout,
-								parms->geometry->instanceCount, parms->geometry->instanceAttribsFlags,
+								parms->geometry->instanceCount, 0, parms->geometry->instanceAttribsFlags,
 								parms->program->vertexAttribsFlags, &attribLocationCount );
 	}
 
@@ -9526,14 +9579,16 @@ static void ksGpuCommandBuffer_SubmitGraphicsCommand( ksGpuCommandBuffer * comma
 		GL( glBindVertexArray( command->pipeline->vertexArrayObject ) );
 	}
 
+	const ksGpuGeometry * geometry = command->pipeline->geometry;
 	const GLenum indexType = ( sizeof( ksGpuTriangleIndex ) == sizeof( GLuint ) ) ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT;
+	const void * indexOffset = (const void *)( geometry->firstIndex * sizeof( ksGpuTriangleIndex ) );
 	if ( command->numInstances > 1 )
 	{
-		GL( glDrawElementsInstanced( GL_TRIANGLES, command->pipeline->geometry->indexCount, indexType, NULL, command->numInstances ) );
+		GL( glDrawElementsInstanced( GL_TRIANGLES, geometry->indexCount, indexType, indexOffset, command->numInstances ) );
 	}
 	else
 	{
-		GL( glDrawElements( GL_TRIANGLES, command->pipeline->geometry->indexCount, indexType, NULL ) );
+		GL( glDrawElements( GL_TRIANGLES, geometry->indexCount, indexType, indexOffset ) );
 	}
 
 	commandBuffer->currentGraphicsState = *command;
@@ -12053,6 +12108,7 @@ typedef enum
 typedef struct
 {
 	const char *				glTF;
+	const char *				glTFCache;
 	bool						fullscreen;
 	bool						simulationPaused;
 	bool						headRotationDisabled;
@@ -12258,6 +12314,16 @@ void SceneThread_Render( ksSceneThreadData * threadData )
 		const ksNanoseconds eyeTexturesCpuTime = t1 - t0;
 		const ksNanoseconds eyeTexturesGpuTime = ksGpuTimer_GetNanoseconds( &eyeTimer[0] ) + ksGpuTimer_GetNanoseconds( &eyeTimer[1] );
 
+		// The eyes render the same draws, so the stats of the last render are those of a single eye or multi-view pass.
+		if ( threadData->sceneSettings->glTF != NULL )
+		{
+			ksGltfRenderStats renderStats;
+			ksGltfScene_GetRenderStats( &gltfScene, &renderStats );
+			ksFrameLog_SetFrameStats( "%d draws, %d pipeline binds, %d program binds, %d descriptor set changes, %d push constant updates",
+										renderStats.drawCount, renderStats.pipelineBinds, renderStats.programBinds,
+										renderStats.descriptorSetChanges, renderStats.pushConstantUpdates );
+		}
+
 		ksFrameLog_EndFrame( eyeTexturesCpuTime, eyeTexturesGpuTime, KS_GPU_TIMER_FRAMES_DELAYED );
 
 		ksMatrix4x4f projectionMatrix;
@@ -12322,7 +12388,7 @@ void SceneThread_Destroy( ksThread * sceneThread, ksSceneThreadData * sceneThrea
 
 bool RenderAsyncTimeWarp( ksStartupSettings * startupSettings )
 {
-	ksThread_SetAffinity( THREAD_AFFINITY_BIG_CORES );
+	ksThread_SetAffinity( THREAD_AFFINITY_FAST_CORE );
 	ksThread_SetRealTimePriority( 1 );
 
 	ksDriverInstance instance;
@@ -12361,6 +12427,7 @@ bool RenderAsyncTimeWarp( ksStartupSettings * startupSettings )
 	ksSceneSettings sceneSettings;
 	ksSceneSettings_Init( &window.context, &sceneSettings );
 	ksSceneSettings_SetGltf( &sceneSettings, startupSettings->glTF );
+	ksSceneSettings_SetGltfCache( &sceneSettings, startupSettings->glTFCache );
 	ksSceneSettings_SetSimulationPaused( &sceneSettings, startupSettings->simulationPaused );
 	ksSceneSettings_SetMultiView( &sceneSettings, startupSettings->useMultiView );
 	ksSceneSettings_SetDisplayResolutionLevel( &sceneSettings, startupSettings->displayResolutionLevel );
@@ -12696,6 +12763,7 @@ bool RenderScene( ksStartupSettings * startupSettings )
 	ksSceneSettings sceneSettings;
 	ksSceneSettings_Init( &window.context, &sceneSettings );
 	ksSceneSettings_SetGltf( &sceneSettings, startupSettings->glTF );
+	ksSceneSettings_SetGltfCache( &sceneSettings, startupSettings->glTFCache );
 	ksSceneSettings_SetSimulationPaused( &sceneSettings, startupSettings->simulationPaused );
 	ksSceneSettings_SetDisplayResolutionLevel( &sceneSettings, startupSettings->displayResolutionLevel );
 	ksSceneSettings_SetEyeImageResolutionLevel( &sceneSettings, startupSettings->eyeImageResolutionLevel );
@@ -12878,6 +12946,15 @@ bool RenderScene( ksStartupSettings * startupSettings )
 			const ksNanoseconds sceneCpuTime = t1 - t0;
 			const ksNanoseconds sceneGpuTime = ksGpuTimer_GetNanoseconds( &timer );
 
+			if ( startupSettings->glTF != NULL )
+			{
+				ksGltfRenderStats renderStats;
+				ksGltfScene_GetRenderStats( &gltfScene, &renderStats );
+				ksFrameLog_SetFrameStats( "%d draws, %d pipeline binds, %d program binds, %d descriptor set changes, %d push constant updates",
+											renderStats.drawCount, renderStats.pipelineBinds, renderStats.programBinds,
+											renderStats.descriptorSetChanges, renderStats.pushConstantUpdates );
+			}
+
 			ksFrameLog_EndFrame( sceneCpuTime, sceneGpuTime, KS_GPU_TIMER_FRAMES_DELAYED );
 
 			ksBarGraph_AddBar( &frameCpuTimeBarGraph, 0, sceneCpuTime * window.windowRefreshRate * 1e-9f, &colorGreen, true );
@@ -12928,6 +13005,7 @@ static int StartApplication( int argc, char * argv[] )
 		if ( arg[0] == '-' ) { arg++; }
 
 		if ( strcmp( arg, "a" ) == 0 && i + 0 < argc )	{ startupSettings.glTF = argv[++i]; }
+		else if ( strcmp( arg, "k" ) == 0 && i + 1 < argc )	{ startupSettings.glTFCache = argv[++i]; }
 		else if ( strcmp( arg, "f" ) == 0 && i + 0 < argc )	{ startupSettings.fullscreen = true; }
 		else if ( strcmp( arg, "v" ) == 0 && i + 1 < argc )	{ startupSettings.noVSyncNanoseconds = (ksNanoseconds)( atof( argv[++i] ) * 1000 * 1000 * 1000 ); }
 		else if ( strcmp( arg, "h" ) == 0 && i + 0 < argc )	{ startupSettings.headRotationDisabled = true; }
@@ -12951,6 +13029,7 @@ static int StartApplication( int argc, char * argv[] )
 				   "atw_opengl [options]\n"
 				   "options:\n"
 				   "   -a <file>   load glTF scene\n"
+				   "   -k <file>   baked glTF scene cache\n"
 				   "   -f          start fullscreen\n"
 				   "   -v <s>      start with V-Sync disabled for this many seconds\n"
 				   "   -h          start with head rotation disabled\n"
@@ -175,6 +175,7 @@ COMMAND-LINE INPUT
 The following command-line options can be used to change various settings.
 
 	-a <.json>	load glTF scene
+	-k <file>	baked glTF scene cache, written if missing or out of date
 	-f			start fullscreen
 	-v <s>		start with V-Sync disabled for this many seconds
 	-h			start with head rotation disabled
@@ -819,23 +820,28 @@ Frame logging.
 Each thread that calls ksFrameLog_Open will open its own log.
 A frame log is always opened for a specified number of frames, and will
 automatically close after the specified number of frames have been recorded.
-The CPU and GPU times for the recorded frames will be listed at the end of the log.
+The CPU and GPU times for the recorded frames will be listed at the end of the log,
+together with any stats that were set for the frame.
 
 ksFrameLog
 
 static void ksFrameLog_Open( const char * fileName, const int frameCount );
 static void ksFrameLog_Write( const char * fileName, const int lineNumber, const char * function );
 static void ksFrameLog_BeginFrame();
+static void ksFrameLog_SetFrameStats( const char * format, ... );
 static void ksFrameLog_EndFrame( const ksNanoseconds cpuTimeNanoseconds, const ksNanoseconds gpuTimeNanoseconds, const int gpuTimeFramesDelayed );
 
 ================================================================================================================================
 */
 
+#define FRAME_LOG_STATS_LENGTH		256
+
 typedef struct
 {
 	FILE *			fp;
 	ksNanoseconds *	frameCpuTimes;
 	ksNanoseconds *	frameGpuTimes;
+	char			( * frameStats )[FRAME_LOG_STATS_LENGTH];
 	int				frameCount;
 	int				frame;
 } ksFrameLog;
@@ -871,6 +877,7 @@ static void ksFrameLog_Open( const char * fileName, const int frameCount )
 			l->frameGpuTimes = (ksNanoseconds *) malloc( frameCount * sizeof( l->frameGpuTimes[0] ) );
 			memset( l->frameCpuTimes, 0, frameCount * sizeof( l->frameCpuTimes[0] ) );
 			memset( l->frameGpuTimes, 0, frameCount * sizeof( l->frameGpuTimes[0] ) );
+			l->frameStats = (char (*)[FRAME_LOG_STATS_LENGTH]) calloc( frameCount, sizeof( l->frameStats[0] ) );
 			l->frameCount = frameCount;
 			l->frame = 0;
 		}
@@ -903,6 +910,21 @@ static void ksFrameLog_BeginFrame()
 	}
 }
 
+static void ksFrameLog_SetFrameStats( const char * format, ... )
+{
+	ksFrameLog * l = ksFrameLog_Get();
+	if ( l != NULL && l->fp != NULL )
+	{
+		if ( l->frame < l->frameCount )
+		{
+			va_list args;
+			va_start( args, format );
+			vsnprintf( l->frameStats[l->frame], sizeof( l->frameStats[0] ), format, args );
+			va_end( args );
+		}
+	}
+}
+
 static void ksFrameLog_EndFrame( const ksNanoseconds cpuTimeNanoseconds, const ksNanoseconds gpuTimeNanoseconds, const int gpuTimeFramesDelayed )
 {
 	ksFrameLog * l = ksFrameLog_Get();
@@ -926,13 +948,15 @@ static void ksFrameLog_EndFrame( const ksNanoseconds cpuTimeNanoseconds, const k
 		{
 			for ( int i = 0; i < l->frameCount; i++ )
 			{
-				fprintf( l->fp, "frame %d: CPU = %1.1f ms, GPU = %1.1f ms\r\n", i, l->frameCpuTimes[i] * 1e-6f, l->frameGpuTimes[i] * 1e-6f );
+				fprintf( l->fp, "frame %d: CPU = %1.1f ms, GPU = %1.1f ms%s%s\r\n", i, l->frameCpuTimes[i] * 1e-6f, l->frameGpuTimes[i] * 1e-6f,
+							( l->frameStats[i][0] != '\0' ) ? ", " : "", l->frameStats[i] );
 			}
 
 			Print( "Closing frame log file (%d frames).\n", l->frameCount );
 			fclose( l->fp );
 			free( l->frameCpuTimes );
 			free( l->frameGpuTimes );
+			free( l->frameStats );
 			memset( l, 0, sizeof( ksFrameLog ) );
 		}
 	}
@@ -7382,6 +7406,8 @@ static void ksGpuGeometry_Create( ksGpuContext * context, ksGpuGeometry * geomet
 static void ksGpuGeometry_CreateQuad( ksGpuContext * context, ksGpuGeometry * geometry, const float offset, const float scale );
 static void ksGpuGeometry_CreateCube( ksGpuContext * context, ksGpuGeometry * geometry, const float offset, const float scale );
 static void ksGpuGeometry_CreateTorus( ksGpuContext * context, ksGpuGeometry * geometry, const int tesselation, const float offset, const float scale );
+static void ksGpuGeometry_CreateRange( ksGpuContext * context, ksGpuGeometry * geometry, const ksGpuGeometry * other,
+								const int firstIndex, const int indexCount, const int vertexOffset, const int vertexCount );
 static void ksGpuGeometry_Destroy( ksGpuContext * context, ksGpuGeometry * geometry );
 
 static void ksGpuGeometry_AddInstanceAttributes( ksGpuContext * context, ksGpuGeometry * geometry, const int numInstances, const int instanceAttribsFlags );
@@ -7397,6 +7423,9 @@ typedef struct
 	int								vertexCount;
 	int								instanceCount;
 	int 							indexCount;
+	int								firstIndex;			// first index of a geometry range in the index buffer
+	int								vertexOffset;		// offset added to the indices of a geometry range
+	int								storedVertexCount;	// number of vertices stored in the vertex buffer
 	ksGpuBuffer						vertexBuffer;
 	ksGpuBuffer						instanceBuffer;
 	ksGpuBuffer						indexBuffer;
@@ -7412,6 +7441,7 @@ static void ksGpuGeometry_Create( ksGpuContext * context, ksGpuGeometry * geomet
 	geometry->vertexAttribsFlags = attribs->attribsFlags;
 	geometry->vertexCount = attribs->vertexCount;
 	geometry->indexCount = indices->indexCount;
+	geometry->storedVertexCount = attribs->vertexCount;
 
 	if ( attribs->buffer != NULL )
 	{
@@ -7431,6 +7461,28 @@ static void ksGpuGeometry_Create( ksGpuContext * context, ksGpuGeometry * geomet
 	}
 }
 
+// Creates geometry that references a range of the indices and vertices of other geometry.
+// This allows many small meshes to be stored in a single vertex buffer and a single index buffer.
+static void ksGpuGeometry_CreateRange( ksGpuContext * context, ksGpuGeometry * geometry, const ksGpuGeometry * other,
+								const int firstIndex, const int indexCount, const int vertexOffset, const int vertexCount )
+{
+	assert( firstIndex >= 0 && ( firstIndex + indexCount ) * sizeof( ksGpuTriangleIndex ) <= other->indexBuffer.size );
+	assert( vertexOffset >= 0 && vertexOffset + vertexCount <= other->storedVertexCount );
+
+	memset( geometry, 0, sizeof( ksGpuGeometry ) );
+
+	geometry->layout = other->layout;
+	geometry->vertexAttribsFlags = other->vertexAttribsFlags;
+	geometry->vertexCount = vertexCount;
+	geometry->indexCount = indexCount;
+	geometry->firstIndex = firstIndex;
+	geometry->vertexOffset = vertexOffset;
+	geometry->storedVertexCount = other->storedVertexCount;
+
+	ksGpuBuffer_CreateReference( context, &geometry->vertexBuffer, &other->vertexBuffer );
+	ksGpuBuffer_CreateReference( context, &geometry->indexBuffer, &other->indexBuffer );
+}
+
 // The quad is centered about the origin and without offset/scale spans the [-1, 1] X-Y range.
 static void ksGpuGeometry_CreateQuad( ksGpuContext * context, ksGpuGeometry * geometry, const float offset, const float scale )
 {
@@ -8889,7 +8941,7 @@ static bool ksGpuGraphicsPipeline_Create( ksGpuContext * context, ksGpuGraphicsP
 	pipeline->vertexAttributeCount = 0;
 	pipeline->vertexBindingCount = 0;
 
-	InitVertexAttributes( false, parms->geometry->layout, parms->geometry->vertexCount,
+	InitVertexAttributes( false, parms->geometry->layout, parms->geometry->storedVertexCount,
 							parms->geometry->vertexAttribsFlags, parms->program->vertexAttribsFlags,
 							pipeline->vertexAttributes, &pipeline->vertexAttributeCount,
 							pipeline->vertexBindings, &pipeline->vertexBindingCount,
@@ -10602,8 +10654,15 @@ static void ksGpuCommandBuffer_SubmitGraphicsCommand( ksGpuCommandBuffer * comma
 
 	const ksGpuGeometry * geometry = command->pipeline->geometry;
 
-	// If the geometry has changed.
-	if ( state->pipeline == NULL || geometry != state->pipeline->geometry || command->vertexBuffer != state->vertexBuffer || command->instanceBuffer != state->instanceBuffer )
+	// If the geometry buffers or the vertex bindings have changed. Geometry ranges that are
+	// stored in the same buffers and that use the same vertex bindings do not rebind the buffers.
+	if ( state->pipeline == NULL || command->vertexBuffer != state->vertexBuffer || command->instanceBuffer != state->instanceBuffer ||
+			geometry->vertexBuffer.buffer != state->pipeline->geometry->vertexBuffer.buffer ||
+			geometry->instanceBuffer.buffer != state->pipeline->geometry->instanceBuffer.buffer ||
+			geometry->indexBuffer.buffer != state->pipeline->geometry->indexBuffer.buffer ||
+			command->pipeline->vertexBindingCount != state->pipeline->vertexBindingCount ||
+			command->pipeline->firstInstanceBinding != state->pipeline->firstInstanceBinding ||
+			memcmp( command->pipeline->vertexBindingOffsets, state->pipeline->vertexBindingOffsets, command->pipeline->vertexBindingCount * sizeof( VkDeviceSize ) ) != 0 )
 	{
 		const VkBuffer vertexBuffer = ( command->vertexBuffer != NULL ) ? command->vertexBuffer->buffer : geometry->vertexBuffer.buffer;
 		for ( int i = 0; i < command->pipeline->firstInstanceBinding; i++ )
@@ -10621,7 +10680,7 @@ static void ksGpuCommandBuffer_SubmitGraphicsCommand( ksGpuCommandBuffer * comma
 		VC( device->vkCmdBindIndexBuffer( cmdBuffer, geometry->indexBuffer.buffer, 0, indexType ) );
 	}
 
-	VC( device->vkCmdDrawIndexed( cmdBuffer, geometry->indexCount, command->numInstances, 0, 0, 0 ) );
+	VC( device->vkCmdDrawIndexed( cmdBuffer, geometry->indexCount, command->numInstances, geometry->firstIndex, geometry->vertexOffset, 0 ) );
 
 	commandBuffer->currentGraphicsState = *command;
 }
@@ -13989,6 +14048,7 @@ typedef enum
 typedef struct
 {
 	const char *				glTF;
+	const char *				glTFCache;
 	bool						fullscreen;
 	bool						simulationPaused;
 	bool						headRotationDisabled;
@@ -14221,6 +14281,16 @@ void SceneThread_Render( ksSceneThreadData * threadData )
 		const ksNanoseconds eyeTexturesCpuTime = t1 - t0;
 		const ksNanoseconds eyeTexturesGpuTime = ksGpuTimer_GetNanoseconds( &eyeTimer[0] ) + ksGpuTimer_GetNanoseconds( &eyeTimer[1] );
 
+		// The eyes render the same draws, so the stats of the last render are those of a single eye or multi-view pass.
+		if ( threadData->sceneSettings->glTF != NULL )
+		{
+			ksGltfRenderStats renderStats;
+			ksGltfScene_GetRenderStats( &gltfScene, &renderStats );
+			ksFrameLog_SetFrameStats( "%d draws, %d pipeline binds, %d program binds, %d descriptor set changes, %d push constant updates",
+										renderStats.drawCount, renderStats.pipelineBinds, renderStats.programBinds,
+										renderStats.descriptorSetChanges, renderStats.pushConstantUpdates );
+		}
+
 		ksFrameLog_EndFrame( eyeTexturesCpuTime, eyeTexturesGpuTime, KS_GPU_TIMER_FRAMES_DELAYED );
 
 		ksMatrix4x4f projectionMatrix;
@@ -14283,7 +14353,7 @@ void SceneThread_Destroy( ksThread * sceneThread, ksSceneThreadData * sceneThrea
 
 bool RenderAsyncTimeWarp( ksStartupSettings * startupSettings )
 {
-	ksThread_SetAffinity( THREAD_AFFINITY_BIG_CORES );
+	ksThread_SetAffinity( THREAD_AFFINITY_FAST_CORE );
 	ksThread_SetRealTimePriority( 1 );
 
 	ksDriverInstance instance;
@@ -14322,6 +14392,7 @@ bool RenderAsyncTimeWarp( ksStartupSettings * startupSettings )
 	ksSceneSettings sceneSettings;
 	ksSceneSettings_Init( &window.context, &sceneSettings );
 	ksSceneSettings_SetGltf( &sceneSettings, startupSettings->glTF );
+	ksSceneSettings_SetGltfCache( &sceneSettings, startupSettings->glTFCache );
 	ksSceneSettings_SetSimulationPaused( &sceneSettings, startupSettings->simulationPaused );
 	ksSceneSettings_SetMultiView( &sceneSettings, startupSettings->useMultiView );
 	ksSceneSettings_SetDisplayResolutionLevel( &sceneSettings, startupSettings->displayResolutionLevel );
@@ -14835,6 +14906,15 @@ bool RenderScene( ksStartupSettings * startupSettings )
 			const ksNanoseconds sceneCpuTime = t1 - t0;
 			const ksNanoseconds sceneGpuTime = ksGpuTimer_GetNanoseconds( &timer );
 
+			if ( startupSettings->glTF != NULL )
+			{
+				ksGltfRenderStats renderStats;
+				ksGltfScene_GetRenderStats( &gltfScene, &renderStats );
+				ksFrameLog_SetFrameStats( "%d draws, %d pipeline binds, %d program binds, %d descriptor set changes, %d push constant updates",
+											renderStats.drawCount, renderStats.pipelineBinds, renderStats.programBinds,
+											renderStats.descriptorSetChanges, renderStats.pushConstantUpdates );
+			}
+
 			ksFrameLog_EndFrame( sceneCpuTime, sceneGpuTime, KS_GPU_TIMER_FRAMES_DELAYED );
 
 			ksBarGraph_AddBar( &frameCpuTimeBarGraph, 0, sceneCpuTime * window.windowRefreshRate * 1e-9f, &colorGreen, true );
@@ -14885,6 +14965,7 @@ static int StartApplication( int argc, char * argv[] )
 		if ( arg[0] == '-' ) { arg++; }
 
 		if ( strcmp( arg, "a" ) == 0 && i + 0 < argc )	{ startupSettings.glTF = argv[++i]; }
+		else if ( strcmp( arg, "k" ) == 0 && i + 1 < argc )	{ startupSettings.glTFCache = argv[++i]; }
 		else if ( strcmp( arg, "f" ) == 0 && i + 0 < argc )	{ startupSettings.fullscreen = true; }
 		else if ( strcmp( arg, "v" ) == 0 && i + 1 < argc )	{ startupSettings.noVSyncNanoseconds = (ksNanoseconds)( atof( argv[++i] ) * 1000 * 1000 * 1000 ); }
 		else if ( strcmp( arg, "h" ) == 0 && i + 0 < argc )	{ startupSettings.headRotationDisabled = true; }
@@ -14908,6 +14989,7 @@ static int StartApplication( int argc, char * argv[] )
 				   "atw_opengl [options]\n"
 				   "options:\n"
 				   "   -a <file>   load glTF scene\n"
+				   "   -k <file>   baked glTF scene cache\n"
 				   "   -f          start fullscreen\n"
 				   "   -v <s>      start with V-Sync disabled for this many seconds\n"
 				   "   -h          start with head rotation disabled\n"
@@ -61,7 +61,11 @@ This implementation supports the following extensions:
  - KHR_glsl_layout_opengl
  - KHR_glsl_layout_vulkan
 
-This implementation only supports KTX images.
+This implementation loads both glTF 1.0 and glTF 2.0 files, either as plain
+JSON or as a binary glTF container with an embedded binary buffer.
+
+This implementation only supports KTX images. Textures with images in other
+formats, or images that fail to load, are replaced with a white texture.
 
 glTF 1.0 is not perfect.
 
@@ -169,9 +173,16 @@ This glTF implementation overcomes some of these issues.
 	- Shaders are automatically converted to a newer GLSL version and
 	  joint uniform arrays are automatically converted to joint uniform
 	  buffers.
-	- Where possible geometry buffers are shared between model surfaces
-	  but creating one graphics API buffer for all vertex attributes and
-	  one for all indices would still be much more efficient.
+	- All surfaces with the same vertex attributes are packed into a single
+	  vertex buffer, and the indices of all surfaces are packed into a single
+	  index buffer at load time. Each surface draws a range of these buffers
+	  with a first index and a vertex offset, and vertices and indices that are
+	  shared between surfaces are stored once.
+	- Objects are looked up by name through hash tables that are sized to the
+	  number of objects, such that loading scenes with many thousands of named
+	  objects does not slow down with long hash chains. The run-time interface
+	  also resolves names to handles once, such that nodes, animations and
+	  sub-trees can be updated every frame without any name lookups.
 	- Animation channels are merged per joint to avoid a separate time-line
 	  lookup per channel per joint.
 	- Animation time-lines are often shared between animations. Therefore
@@ -183,12 +194,67 @@ This glTF implementation overcomes some of these issues.
 	  the current time.
 	- Time-lines are evaluated separately so they can be shared by different
 	  animations.
+	- Animations are compressed at load time. Translations and scales are
+	  stored as 16-bit values within the range of each channel, and rotations
+	  as the three smallest quaternion components with 15 bits each. Key frames
+	  of fixed-rate time-lines that are reproduced by interpolation within a
+	  tolerance are omitted, and a bit mask with a running count per 32 key
+	  frames maps a time-line frame to the stored key frames. The two stored
+	  key frames around the current time are decoded once per channel and
+	  reused until the time-line moves past them.
 	- The bindShapeMatrix is folded into the inverseBindMatrices at load
 	  time to avoid another run-time matrix multiplication.
 	- This implementation supports culling of animated models using the
 	  KHR_skin_culling glTF extension.
 	- The nodes are sorted to allow a simple linear walk to transform
-	  nodes from local space to global space.
+	  nodes from local space to global space. The node state is stored as
+	  a structure of arrays and the local transforms are created with SIMD
+	  four nodes at a time.
+	- Nodes are marked dirty when they are animated or changed with one of the
+	  ksGltfScene_SetNode* functions. Only the transforms of dirty nodes and their
+	  descendants are recalculated, and sub-trees without dirty nodes are skipped.
+	  The joint buffer of a skin is only updated when one of its joints changed.
+	- The visible surfaces are collected in a draw list that is sorted on
+	  technique, material and geometry buffer with a counting sort on a rank
+	  per surface that is calculated at load time. Consecutive draws only set
+	  the program parameters that changed, and the number of pipeline binds,
+	  program binds, descriptor set changes and push constant updates of the
+	  last rendered view is available through ksGltfScene_GetRenderStats.
+	  Blended surfaces are drawn last in the order of the scene hierarchy.
+	- The visible sub-trees are animated and transformed concurrently on a pool
+	  of worker threads. The nodes of large sub-trees are sorted on depth at
+	  load time so the nodes of each wide depth level are transformed in parallel.
+	- The binary chunk of a binary glTF file and external buffer files are
+	  memory mapped and referenced in place instead of being copied.
+	- The buffers, images and shaders are read and decoded, and the shaders are
+	  converted, on a pool of worker threads. Only the graphics API objects are
+	  created on the calling thread.
+	- A loaded scene can be baked into a cache file with ksSceneSettings_SetGltfCache.
+	  The cache stores the run-time structures, converted shaders, KTX images and
+	  unpacked geometry with relocatable pointers. Later loads memory map the
+	  cache and only create the graphics API objects. The cache is rebuilt when
+	  the size or modification time of the glTF file or of any external buffer,
+	  image or shader file changes, or when the graphics API, the multi-view
+	  setting or the run-time structures change.
+
+glTF 2.0 is loaded into the same run-time structures as glTF 1.0.
+	- Objects are referenced by array index instead of by name. Objects without
+	  a name get a name derived from their type and index, for instance "node_3".
+	- Accessors with a byteStride, normalized integer components or sparse
+	  storage are unpacked to floats at load time. Tightly packed float
+	  accessors are referenced in place.
+	- glTF 2.0 does not store shaders. Instead materials use a built-in technique
+	  that approximates pbrMetallicRoughness with the base color factor and
+	  texture, the metallic and roughness factors and the emissive factor.
+	  Normal, occlusion, emissive and metallic-roughness textures, as well
+	  as the alphaMode, are ignored.
+	- Geometry uses 16-bit indices. Primitives with more than 65536 vertices
+	  are split into multiple surfaces. Primitives that are not triangle lists
+	  are skipped.
+	- STEP animations hold each key frame and CUBICSPLINE animations linearly
+	  interpolate the spline values. Morph target weights are ignored.
+	- The channels of an animation are split into separate animations per
+	  input accessor, such that each animation has a single time-line.
 
 
 INTERFACE
@@ -199,6 +265,7 @@ ksGltfScene
 static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * scene, ksSceneSettings * settings, ksGpuRenderPass * renderPass );
 static void ksGltfScene_Destroy( ksGpuContext * context, ksGltfScene * scene );
 
+// The nodes of a disabled animation keep their last pose until the animation is enabled again.
 static void ksGltfScene_SetSubScene( ksGltfScene * scene, const char * subSceneName );
 static void ksGltfScene_SetSubTreeVisible( ksGltfScene * scene, const char * subTreeName, const bool visible );
 static void ksGltfScene_SetAnimationEnabled( ksGltfScene * scene, const char * animationName, const bool enabled );
@@ -206,9 +273,25 @@ static void ksGltfScene_SetNodeTranslation( ksGltfScene * scene, const char * no
 static void ksGltfScene_SetNodeRotation( ksGltfScene * scene, const char * nodeName, const ksQuatf * rotation );
 static void ksGltfScene_SetNodeScale( ksGltfScene * scene, const char * nodeName, const ksVector3f * scale );
 
+// Handles are -1 if there is no object with the name, and stay valid until the scene is destroyed.
+static int ksGltfScene_GetSubSceneHandle( const ksGltfScene * scene, const char * subSceneName );
+static int ksGltfScene_GetSubTreeHandle( const ksGltfScene * scene, const char * subTreeName );
+static int ksGltfScene_GetAnimationHandle( const ksGltfScene * scene, const char * animationName );
+static int ksGltfScene_GetNodeHandle( const ksGltfScene * scene, const char * nodeName );
+
+static void ksGltfScene_SetSubSceneByHandle( ksGltfScene * scene, const int subSceneHandle );
+static void ksGltfScene_SetSubTreeVisibleByHandle( ksGltfScene * scene, const int subTreeHandle, const bool visible );
+static void ksGltfScene_SetAnimationEnabledByHandle( ksGltfScene * scene, const int animationHandle, const bool enabled );
+static void ksGltfScene_SetNodeTranslationByHandle( ksGltfScene * scene, const int nodeHandle, const ksVector3f * translation );
+static void ksGltfScene_SetNodeRotationByHandle( ksGltfScene * scene, const int nodeHandle, const ksQuatf * rotation );
+static void ksGltfScene_SetNodeScaleByHandle( ksGltfScene * scene, const int nodeHandle, const ksVector3f * scale );
+
 static void ksGltfScene_Simulate( ksGltfScene * scene, ksViewState * viewState, ksGpuWindowInput * input, const ksNanoseconds time );
 static void ksGltfScene_UpdateBuffers( ksGpuCommandBuffer * commandBuffer, ksGltfScene * scene, const ksViewState * viewState, const int eye );
-static void ksGltfScene_Render( ksGpuCommandBuffer * commandBuffer, const ksGltfScene * scene, const ksViewState * viewState );
+static void ksGltfScene_Render( ksGpuCommandBuffer * commandBuffer, ksGltfScene * scene, const ksViewState * viewState );
+
+// Returns the state changes of the last ksGltfScene_Render.
+static void ksGltfScene_GetRenderStats( const ksGltfScene * scene, ksGltfRenderStats * stats );
 
 ================================================================================================================================
 */
@@ -216,13 +299,19 @@ static void ksGltfScene_Render( ksGpuCommandBuffer * commandBuffer, const ksGltf
 #include <utils/json.h>
 #include <utils/base64.h>
 #include <utils/lexer.h>
+#include <sys/types.h>
+#include <sys/stat.h>						// for stat()
+#include <time.h>							// for time()
 
 #if GRAPHICS_API_OPENGL == 0 && GRAPHICS_API_OPENGL_ES == 0
 
+#define GL_TRIANGLES					0x0004
+
 #define GL_BYTE							0x1400
 #define GL_UNSIGNED_BYTE				0x1401
 #define GL_SHORT						0x1402
 #define GL_UNSIGNED_SHORT				0x1403
+#define GL_UNSIGNED_INT					0x1405
 
 #define GL_BOOL							0x8B56
 #define GL_BOOL_VEC2					0x8B57
@@ -719,11 +808,195 @@ static const char unitCubeFlatShadeFragmentProgramMetalSL[] =
 
 #endif
 
+/*
+glTF 2.0 does not store shaders. glTF 2.0 materials are rendered with the following glTF 1.0 style
+techniques. The pbrMetallicRoughness material model is approximated with a Blinn-Phong style model
+with a fixed light direction, where the metallic factor blends between a dielectric and a metallic
+specular color and the roughness factor controls the specular exponent.
+*/
+static const char gltf2DefaultTechniquesJson[] =
+	"{\n"
+	"	\"shaders\": {\n"
+	"		\"pbrMetallicRoughnessVertexShader\": {\n"
+	"			\"type\": 35633,\n"
+	"			\"uri\": \"data:text/plain,"
+					"precision highp float;\\n"
+					"uniform mat4 u_modelMatrix;\\n"
+					"uniform mat4 u_viewMatrix;\\n"
+					"uniform mat4 u_viewInverseMatrix;\\n"
+					"uniform mat4 u_projectionMatrix;\\n"
+					"attribute vec3 a_position;\\n"
+					"attribute vec3 a_normal;\\n"
+					"attribute vec2 a_texcoord0;\\n"
+					"varying vec3 v_normal;\\n"
+					"varying vec3 v_eye;\\n"
+					"varying vec2 v_texcoord0;\\n"
+					"void main()\\n"
+					"{\\n"
+					"vec4 position = u_modelMatrix * vec4( a_position, 1.0 );\\n"
+					"v_normal = ( u_modelMatrix * vec4( a_normal, 0.0 ) ).xyz;\\n"
+					"v_eye = u_viewInverseMatrix[3].xyz - position.xyz;\\n"
+					"v_texcoord0 = a_texcoord0;\\n"
+					"gl_Position = u_projectionMatrix * ( u_viewMatrix * position );\\n"
+					"}\\n"
+				"\"\n"
+	"		},\n"
+	"		\"pbrMetallicRoughnessSkinnedVertexShader\": {\n"
+	"			\"type\": 35633,\n"
+	"			\"uri\": \"data:text/plain,"
+					"precision highp float;\\n"
+					"uniform mat4 u_modelMatrix;\\n"
+					"uniform mat4 u_viewMatrix;\\n"
+					"uniform mat4 u_viewInverseMatrix;\\n"
+					"uniform mat4 u_projectionMatrix;\\n"
+					"uniform mat4 u_jointMatrix[64];\\n"
+					"attribute vec3 a_position;\\n"
+					"attribute vec3 a_normal;\\n"
+					"attribute vec2 a_texcoord0;\\n"
+					"attribute vec4 a_joint;\\n"
+					"attribute vec4 a_weight;\\n"
+					"varying vec3 v_normal;\\n"
+					"varying vec3 v_eye;\\n"
+					"varying vec2 v_texcoord0;\\n"
+					"void main()\\n"
+					"{\\n"
+					"mat4 skinMatrix =\\n"
+					"a_weight.x * u_jointMatrix[int( a_joint.x )] +\\n"
+					"a_weight.y * u_jointMatrix[int( a_joint.y )] +\\n"
+					"a_weight.z * u_jointMatrix[int( a_joint.z )] +\\n"
+					"a_weight.w * u_jointMatrix[int( a_joint.w )];\\n"
+					"vec4 position = u_modelMatrix * ( skinMatrix * vec4( a_position, 1.0 ) );\\n"
+					"v_normal = ( u_modelMatrix * ( skinMatrix * vec4( a_normal, 0.0 ) ) ).xyz;\\n"
+					"v_eye = u_viewInverseMatrix[3].xyz - position.xyz;\\n"
+					"v_texcoord0 = a_texcoord0;\\n"
+					"gl_Position = u_projectionMatrix * ( u_viewMatrix * position );\\n"
+					"}\\n"
+				"\"\n"
+	"		},\n"
+	"		\"pbrMetallicRoughnessFragmentShader\": {\n"
+	"			\"type\": 35632,\n"
+	"			\"uri\": \"data:text/plain,"
+					"precision mediump float;\\n"
+					"uniform vec4 u_baseColorFactor;\\n"
+					"uniform float u_metallicFactor;\\n"
+					"uniform float u_roughnessFactor;\\n"
+					"uniform vec3 u_emissiveFactor;\\n"
+					"uniform sampler2D u_baseColorTexture;\\n"
+					"varying vec3 v_normal;\\n"
+					"varying vec3 v_eye;\\n"
+					"varying vec2 v_texcoord0;\\n"
+					"void main()\\n"
+					"{\\n"
+					"vec4 baseColor = u_baseColorFactor * texture2D( u_baseColorTexture, v_texcoord0 );\\n"
+					"vec3 normal = normalize( v_normal );\\n"
+					"vec3 light = normalize( vec3( 0.5, 1.0, 0.75 ) );\\n"
+					"vec3 halfVector = normalize( light + normalize( v_eye ) );\\n"
+					"float diffuse = max( dot( normal, light ), 0.0 );\\n"
+					"float specular = pow( max( dot( normal, halfVector ), 0.0 ), mix( 256.0, 2.0, u_roughnessFactor ) ) * ( 1.0 - u_roughnessFactor );\\n"
+					"vec3 diffuseColor = baseColor.rgb * ( 1.0 - u_metallicFactor );\\n"
+					"vec3 specularColor = mix( vec3( 0.04 ), baseColor.rgb, u_metallicFactor );\\n"
+					"gl_FragColor = vec4( 0.2 * baseColor.rgb + diffuse * diffuseColor + specular * specularColor + u_emissiveFactor, baseColor.a );\\n"
+					"}\\n"
+				"\"\n"
+	"		}\n"
+	"	},\n"
+	"	\"programs\": {\n"
+	"		\"pbrMetallicRoughnessProgram\": {\n"
+	"			\"vertexShader\": \"pbrMetallicRoughnessVertexShader\",\n"
+	"			\"fragmentShader\": \"pbrMetallicRoughnessFragmentShader\"\n"
+	"		},\n"
+	"		\"pbrMetallicRoughnessSkinnedProgram\": {\n"
+	"			\"vertexShader\": \"pbrMetallicRoughnessSkinnedVertexShader\",\n"
+	"			\"fragmentShader\": \"pbrMetallicRoughnessFragmentShader\"\n"
+	"		}\n"
+	"	},\n"
+	"	\"techniques\": {\n"
+	"		\"pbrMetallicRoughness\": {\n"
+	"			\"program\": \"pbrMetallicRoughnessProgram\",\n"
+	"			\"parameters\": {\n"
+	"				\"modelMatrix\": { \"semantic\": \"MODEL\", \"type\": 35676 },\n"
+	"				\"viewMatrix\": { \"semantic\": \"VIEW\", \"type\": 35676 },\n"
+	"				\"viewInverseMatrix\": { \"semantic\": \"VIEWINVERSE\", \"type\": 35676 },\n"
+	"				\"projectionMatrix\": { \"semantic\": \"PROJECTION\", \"type\": 35676 },\n"
+	"				\"position\": { \"semantic\": \"POSITION\", \"type\": 35665 },\n"
+	"				\"normal\": { \"semantic\": \"NORMAL\", \"type\": 35665 },\n"
+	"				\"texcoord0\": { \"semantic\": \"TEXCOORD_0\", \"type\": 35664 },\n"
+	"				\"baseColorFactor\": { \"type\": 35666 },\n"
+	"				\"metallicFactor\": { \"type\": 5126 },\n"
+	"				\"roughnessFactor\": { \"type\": 5126 },\n"
+	"				\"emissiveFactor\": { \"type\": 35665 },\n"
+	"				\"baseColorTexture\": { \"type\": 35678 }\n"
+	"			},\n"
+	"			\"attributes\": {\n"
+	"				\"a_position\": \"position\",\n"
+	"				\"a_normal\": \"normal\",\n"
+	"				\"a_texcoord0\": \"texcoord0\"\n"
+	"			},\n"
+	"			\"uniforms\": {\n"
+	"				\"u_modelMatrix\": \"modelMatrix\",\n"
+	"				\"u_viewMatrix\": \"viewMatrix\",\n"
+	"				\"u_viewInverseMatrix\": \"viewInverseMatrix\",\n"
+	"				\"u_projectionMatrix\": \"projectionMatrix\",\n"
+	"				\"u_baseColorFactor\": \"baseColorFactor\",\n"
+	"				\"u_metallicFactor\": \"metallicFactor\",\n"
+	"				\"u_roughnessFactor\": \"roughnessFactor\",\n"
+	"				\"u_emissiveFactor\": \"emissiveFactor\",\n"
+	"				\"u_baseColorTexture\": \"baseColorTexture\"\n"
+	"			},\n"
+	"			\"states\": { \"enable\": [ 2929 ] }\n"
+	"		},\n"
+	"		\"pbrMetallicRoughnessSkinned\": {\n"
+	"			\"program\": \"pbrMetallicRoughnessSkinnedProgram\",\n"
+	"			\"parameters\": {\n"
+	"				\"modelMatrix\": { \"semantic\": \"MODEL\", \"type\": 35676 },\n"
+	"				\"viewMatrix\": { \"semantic\": \"VIEW\", \"type\": 35676 },\n"
+	"				\"viewInverseMatrix\": { \"semantic\": \"VIEWINVERSE\", \"type\": 35676 },\n"
+	"				\"projectionMatrix\": { \"semantic\": \"PROJECTION\", \"type\": 35676 },\n"
+	"				\"jointMatrix\": { \"semantic\": \"JOINTMATRIX\", \"type\": 35676, \"count\": 64 },\n"
+	"				\"position\": { \"semantic\": \"POSITION\", \"type\": 35665 },\n"
+	"				\"normal\": { \"semantic\": \"NORMAL\", \"type\": 35665 },\n"
+	"				\"texcoord0\": { \"semantic\": \"TEXCOORD_0\", \"type\": 35664 },\n"
+	"				\"joint\": { \"semantic\": \"JOINT\", \"type\": 35666 },\n"
+	"				\"weight\": { \"semantic\": \"WEIGHT\", \"type\": 35666 },\n"
+	"				\"baseColorFactor\": { \"type\": 35666 },\n"
+	"				\"metallicFactor\": { \"type\": 5126 },\n"
+	"				\"roughnessFactor\": { \"type\": 5126 },\n"
+	"				\"emissiveFactor\": { \"type\": 35665 },\n"
+	"				\"baseColorTexture\": { \"type\": 35678 }\n"
+	"			},\n"
+	"			\"attributes\": {\n"
+	"				\"a_position\": \"position\",\n"
+	"				\"a_normal\": \"normal\",\n"
+	"				\"a_texcoord0\": \"texcoord0\",\n"
+	"				\"a_joint\": \"joint\",\n"
+	"				\"a_weight\": \"weight\"\n"
+	"			},\n"
+	"			\"uniforms\": {\n"
+	"				\"u_modelMatrix\": \"modelMatrix\",\n"
+	"				\"u_viewMatrix\": \"viewMatrix\",\n"
+	"				\"u_viewInverseMatrix\": \"viewInverseMatrix\",\n"
+	"				\"u_projectionMatrix\": \"projectionMatrix\",\n"
+	"				\"u_jointMatrix\": \"jointMatrix\",\n"
+	"				\"u_baseColorFactor\": \"baseColorFactor\",\n"
+	"				\"u_metallicFactor\": \"metallicFactor\",\n"
+	"				\"u_roughnessFactor\": \"roughnessFactor\",\n"
+	"				\"u_emissiveFactor\": \"emissiveFactor\",\n"
+	"				\"u_baseColorTexture\": \"baseColorTexture\"\n"
+	"			},\n"
+	"			\"states\": { \"enable\": [ 2929 ] }\n"
+	"		}\n"
+	"	}\n"
+	"}\n";
+
 #define GLTF_JSON_VERSION_10			"1.0"
 #define GLTF_JSON_VERSION_101			"1.0.1"
+#define GLTF_JSON_VERSION_20			"2.0"
 #define GLTF_BINARY_MAGIC				( ( 'g' << 0 ) | ( 'l' << 8 ) | ( 'T' << 16 ) | ( 'F' << 24 ) )
-#define GLTF_BINARY_VERSION				1
+#define GLTF_BINARY_VERSION_1			1
+#define GLTF_BINARY_VERSION_2			2
 #define GLTF_BINARY_CONTENT_FORMAT		0
+#define GLTF_BINARY_CHUNK_TYPE_JSON		( ( 'J' << 0 ) | ( 'S' << 8 ) | ( 'O' << 16 ) | ( 'N' << 24 ) )
+#define GLTF_BINARY_CHUNK_TYPE_BIN		( ( 'B' << 0 ) | ( 'I' << 8 ) | ( 'N' << 16 ) )
 
 #define URI_SCHEME_APPLICATION_BINARY			"data:application/binary,"
 #define URI_SCHEME_APPLICATION_BINARY_LENGTH	24
@@ -737,12 +1010,28 @@ typedef struct ksGltfBinaryHeader
 	uint32_t					contentFormat;
 } ksGltfBinaryHeader;
 
+// glTF 2.0 binary files start with the magic, version and length followed by chunks
+typedef struct ksGltfBinaryChunkHeader
+{
+	uint32_t					chunkLength;
+	uint32_t					chunkType;
+} ksGltfBinaryChunkHeader;
+
+typedef enum
+{
+	GLTF_BUFFER_DATA_ALLOCATED,		// allocated with malloc
+	GLTF_BUFFER_DATA_MAPPED,		// memory mapped file
+	GLTF_BUFFER_DATA_BINARY_GLTF	// points into the binary glTF file
+} ksGltfBufferDataStorage;
+
 typedef struct ksGltfBuffer
 {
 	char *						name;
 	char *						type;
 	size_t						byteLength;
 	unsigned char *				bufferData;
+	size_t						bufferDataSize;	// size of the allocation or mapping
+	ksGltfBufferDataStorage		bufferDataStorage;
 } ksGltfBuffer;
 
 typedef struct ksGltfBufferView
@@ -751,9 +1040,20 @@ typedef struct ksGltfBufferView
 	const ksGltfBuffer *		buffer;
 	size_t						byteOffset;
 	size_t						byteLength;
+	size_t						byteStride;		// glTF 2.0
 	int							target;
 } ksGltfBufferView;
 
+typedef struct ksGltfSparseAccessor
+{
+	int							count;
+	const ksGltfBufferView *	indicesBufferView;
+	size_t						indicesByteOffset;
+	int							indicesComponentType;
+	const ksGltfBufferView *	valuesBufferView;
+	size_t						valuesByteOffset;
+} ksGltfSparseAccessor;
+
 typedef struct ksGltfAccessor
 {
 	char *						name;
@@ -762,11 +1062,15 @@ typedef struct ksGltfAccessor
 	size_t						byteOffset;
 	size_t						byteStride;
 	int							componentType;
+	int							componentCount;
 	int							count;
+	bool						normalized;
+	ksGltfSparseAccessor		sparse;
 	int							intMin[16];
 	int							intMax[16];
 	float						floatMin[16];
 	float						floatMax[16];
+	float *						unpackedData;	// tightly packed floats if the data cannot be used in place
 } ksGltfAccessor;
 
 typedef struct ksGltfImageVersion
@@ -967,11 +1271,27 @@ typedef struct ksGltfGeometryAccessors
 	const ksGltfAccessor *		indices;
 } ksGltfGeometryAccessors;
 
+// All surfaces with the same vertex attributes are stored in a single vertex buffer.
+// The geometry buffers share a single index buffer that is owned by the first geometry buffer.
+typedef struct ksGltfGeometryBuffer
+{
+	const ksGpuVertexAttribute *	layout;
+	int								vertexAttribsFlags;
+	int								vertexCount;
+	ksGpuGeometry					geometry;
+} ksGltfGeometryBuffer;
+
 typedef struct ksGltfSurface
 {
 	const ksGltfMaterial *		material;		// material used to render this surface
-	ksGpuGeometry				geometry;		// surface geometry
+	ksGltfGeometryBuffer *		geometryBuffer;	// vertex and index buffer that stores the surface geometry
+	int							firstIndex;		// first index of the surface in the index buffer
+	int							indexCount;
+	int							vertexOffset;	// offset of the surface vertices in the vertex buffer that is added to each index
+	int							vertexCount;
+	ksGpuGeometry				geometry;		// surface geometry as a range of the geometry buffer
 	ksGpuGraphicsPipeline		pipeline;		// rendering pipeline for this surface
+	int							drawOrder;		// rank of the surface in the sorted draw list
 	ksVector3f					mins;			// minimums of the surface geometry excluding animations
 	ksVector3f					maxs;			// maximums of the surface geometry excluding animations
 } ksGltfSurface;
@@ -981,6 +1301,7 @@ typedef struct ksGltfModel
 	char *						name;
 	ksGltfSurface *				surfaces;
 	int							surfaceCount;
+	ksBounds3fArray				surfaceBounds;	// bounds of each surface for batched culling
 	ksVector3f					mins;			// minimums of the surface geometry excluding animations
 	ksVector3f					maxs;			// maximums of the surface geometry excluding animations
 } ksGltfModel;
@@ -993,13 +1314,44 @@ typedef struct ksGltfTimeLine
 	int							sampleCount;
 } ksGltfTimeLine;
 
+typedef enum
+{
+	GLTF_ANIMATION_COMPONENT_TRANSLATION	= BIT( 0 ),
+	GLTF_ANIMATION_COMPONENT_ROTATION		= BIT( 1 ),
+	GLTF_ANIMATION_COMPONENT_SCALE			= BIT( 2 )
+} ksGltfAnimationComponentBits;
+
+// Key frames are compressed at load time. Translations and scales are quantized to 16 bits per
+// component within the range of the channel. Rotations are stored as the three smallest quaternion
+// components. Key frames of a fixed-rate time-line that are reproduced by interpolation are omitted.
+typedef struct ksGltfCompressedKeyFrames
+{
+	uint16_t *					translation;		// 3 components per stored key frame or NULL
+	uint16_t *					rotation;			// 3 components per stored key frame or NULL
+	uint16_t *					scale;				// 3 components per stored key frame or NULL
+	ksVector3f					translationBias;
+	ksVector3f					translationStep;
+	ksVector3f					scaleBias;
+	ksVector3f					scaleStep;
+	uint32_t *					keyMask;			// bit set for each stored key frame, NULL if all key frames are stored
+	int *						keyRank;			// number of stored key frames before each word of the key mask
+	uint16_t *					keyFrames;			// time-line frame of each stored key frame
+	int							keyCount;			// number of stored key frames
+	int							stepMask;			// ksGltfAnimationComponentBits of the components that hold each key frame (STEP)
+	void *						data;				// single allocation with all arrays
+	size_t						dataSize;
+} ksGltfCompressedKeyFrames;
+
 typedef struct ksGltfAnimationChannel
 {
 	char *						nodeName;
+	int							nodeIndex;		// glTF 2.0 node index or -1
 	struct ksGltfNode *			node;
-	ksQuatf *					rotation;
-	ksVector3f *				translation;
-	ksVector3f *				scale;
+	ksQuatf *					rotation;		// only valid while loading
+	ksVector3f *				translation;	// only valid while loading
+	ksVector3f *				scale;			// only valid while loading
+	int							ownedMask;		// ksGltfAnimationComponentBits of the values allocated while loading
+	ksGltfCompressedKeyFrames	keyFrames;		// compressed key frames used at run-time
 } ksGltfAnimationChannel;
 
 typedef struct ksGltfAnimation
@@ -1013,6 +1365,7 @@ typedef struct ksGltfAnimation
 typedef struct ksGltfJoint
 {
 	char *						name;
+	int							nodeIndex;		// glTF 2.0 node index or -1
 	struct ksGltfNode *			node;
 } ksGltfJoint;
 
@@ -1021,8 +1374,8 @@ typedef struct ksGltfSkin
 	char *						name;
 	struct ksGltfNode *			parentNode;
 	ksMatrix4x4f *				inverseBindMatrices;
-	ksVector3f *				jointGeometryMins;		// joint local space minimums of the geometry influenced by each joint
-	ksVector3f *				jointGeometryMaxs;		// joint local space maximums of the geometry influenced by each joint
+	ksMatrix4x4f *				defaultInverseBindMatrices;	// identity matrices if the skin does not specify inverse bind matrices
+	ksBounds3fArray				jointGeometryBounds;	// joint local space bounds of the geometry influenced by each joint
 	ksGltfJoint *				joints;					// joints of this skin
 	int							jointCount;				// number of joints
 	ksGpuBuffer					jointBuffer;			// buffer with joint matrices
@@ -1067,13 +1420,14 @@ typedef struct ksGltfNode
 	ksVector3f					scale;
 	int							subTreeNodeCount;	// this node plus the number of direct or indirect decendants
 	struct ksGltfNode **		children;
-	char **						childNames;
+	int *						childIndices;		// only valid while loading
 	int							childCount;
 	struct ksGltfNode *			parent;
 	struct ksGltfCamera *		camera;
 	struct ksGltfSkin *			skin;
 	struct ksGltfModel **		models;
 	int							modelCount;
+	ksBounds3fArray				modelBounds;		// bounds of each model for batched culling
 } ksGltfNode;
 
 typedef struct ksGltfSubTree
@@ -1100,35 +1454,108 @@ typedef struct ksGltfTimeLineFrameState
 	float						fraction;
 } ksGltfTimeLineFrameState;
 
+// The two stored key frames around the current time-line frame are decoded once and
+// interpolated until the time-line moves to a frame outside of these key frames.
+typedef struct ksGltfChannelKeyState
+{
+	int							keyFrame;			// time-line frame of the first decoded key frame
+	int							keyFrameCount;		// time-line frames from the first to the second decoded key frame or zero
+	float						rcpKeyFrameCount;
+	ksVector3f					translation[2];
+	ksQuatf						rotation[2];
+	ksVector3f					scale[2];
+} ksGltfChannelKeyState;
+
 typedef struct ksGltfSkinCullingState
 {
+	ksMatrix4x4f *				jointTransforms;	// joint transforms relative to the skeleton
+	ksBounds3fArray				jointBounds;		// skeleton space bounds of the geometry influenced by each joint
 	ksVector3f					mins;				// minimums of the complete skin geometry
 	ksVector3f					maxs;				// maximums of the complete skin geometry
 	bool						culled;				// true if the skin is culled
+	int							jointSimulateIndex;	// simulate index at which the joint transforms were calculated
+	bool						jointBufferValid;	// true if the joint buffer holds the current joint transforms
 } ksGltfSkinCullingState;
 
+typedef enum
+{
+	GLTF_TRANSFORM_TYPE_RIGID,			// rotation, uniform scale and translation
+	GLTF_TRANSFORM_TYPE_AFFINE			// rotation, non-uniform scale, skew and translation
+} ksGltfTransformType;
+
+// The node state is stored as a structure of arrays indexed by node index. The local transforms of
+// consecutive nodes are created four at a time, and because parents are sorted before their children,
+// the global transforms are composed in a linear walk. Only the transforms of nodes that changed, or
+// that have a parent that changed, are recalculated.
 typedef struct ksGltfNodeState
 {
-	struct ksGltfNodeState *	parent;
-	ksQuatf						rotation;
-	ksVector3f					translation;
-	ksVector3f					scale;
-	ksMatrix4x4f				localTransform;
-	ksMatrix4x4f				globalTransform;
+	int *						parent;						// parent node index or -1
+	ksTransformArray			transforms;					// local translation, rotation and scale
+	ksMatrix4x4f *				localTransform;
+	ksMatrix4x4f *				globalTransform;
+	ksMatrix4x4f *				globalInverseTransform;		// only updated if globalInverseRequired is set
+	ksGltfTransformType *		globalTransformType;
+	bool *						globalInverseRequired;		// set for nodes with models, cameras or skins
+	bool *						localDirty;					// set when the translation, rotation or scale changed
+	int *						globalSimulateIndex;		// simulate index at which the global transform last changed
 } ksGltfNodeState;
 
 typedef struct ksGltfSubTreeState
 {
 	bool						visible;
+	int *						levelNodes;			// node indices sorted on depth, only set for large sub-trees
+	int *						levelFirstNode;		// first level node of each depth level plus one for the end
+	int							levelCount;			// number of depth levels or zero if not split into levels
 } ksGltfSubTreeState;
 
+typedef struct
+{
+	struct ksGltfScene *		scene;
+	ksGltfSubTree *				subTree;
+} ksGltfSimulateJob;
+
+typedef struct ksGltfDraw
+{
+	const ksGltfSurface *		surface;
+	int							nodeIndex;			// node that provides the model transform
+	const ksGpuBuffer *			jointBuffer;
+} ksGltfDraw;
+
+typedef struct ksGltfRenderStats
+{
+	int							drawCount;
+	int							pipelineBinds;
+	int							programBinds;
+	int							descriptorSetChanges;	// draws that change a texture or uniform buffer
+	int							pushConstantUpdates;
+} ksGltfRenderStats;
+
+// The draws are collected in traversal order and sorted on the draw order of the surfaces.
+typedef struct ksGltfDrawList
+{
+	ksGltfDraw *				draws;
+	ksGltfDraw *				sortedDraws;
+	int *						orderOffsets;		// counting sort offset of each draw order
+	int							orderCount;			// number of draw orders with the blended surfaces sharing the last one
+	int							drawCount;
+	int							maxDraws;
+	ksGltfRenderStats			stats;
+} ksGltfDrawList;
+
 typedef struct ksGltfState
 {
 	ksGltfSubScene *			currentSubScene;
 	ksGltfTimeLineFrameState *	timeLineFrameState;
+	ksGltfChannelKeyState **	channelKeyState;	// decoded key frames of each channel of each animation
+	bool *						animationEnabled;	// false for animations disabled with ksGltfScene_SetAnimationEnabled
 	ksGltfSkinCullingState *	skinCullingState;
-	ksGltfNodeState *			nodeState;
+	ksGltfNodeState				nodeState;
+	int							simulateIndex;		// incremented by every ksGltfScene_Simulate
 	ksGltfSubTreeState *		subTreeState;
+	ksThreadPool				threadPool;			// worker threads used to simulate the scene
+	ksGltfSimulateJob *			simulateJobs;		// one job per visible sub-tree
+	bool						parallelSubTrees;	// false if sub-trees overlap
+	ksGltfDrawList *			drawList;			// updated by ksGltfScene_Render
 } ksGltfState;
 
 typedef struct ksGltfScene
@@ -1169,6 +1596,9 @@ typedef struct ksGltfScene
 	ksGltfModel *				models;
 	int *						modelNameHash;
 	int							modelCount;
+	ksGltfGeometryBuffer *		geometryBuffers;
+	int							geometryBufferCount;
+	int							geometryIndexCount;		// number of indices shared by all geometry buffers
 	ksGltfTimeLine *			timeLines;
 	int *						timeLineNameHash;
 	int							timeLineCount;
@@ -1191,6 +1621,14 @@ typedef struct ksGltfScene
 
 	ksGltfState					state;
 
+	unsigned char *				binaryFileData;		// binary glTF file referenced by buffers
+	size_t						binaryFileSize;
+	bool						binaryFileMapped;
+
+	unsigned char *				bakedData;			// baked scene referenced by all scene data
+	size_t						bakedDataSize;
+	bool						bakedDataMapped;
+
 	ksGpuBuffer					viewProjectionBuffer;
 	ksGpuBuffer					defaultJointBuffer;
 	ksGpuGeometry				unitCubeGeometry;
@@ -1198,35 +1636,58 @@ typedef struct ksGltfScene
 	ksGpuGraphicsPipeline		unitCubePipeline;
 } ksGltfScene;
 
-#define HASH_TABLE_SIZE		256
+// The hash tables are sized to the number of objects such that the chains stay short even for
+// scenes with many thousands of nodes. Each hash table is stored as a single array with the first
+// object index of each bucket, followed by the next object index in the chain and the full hash
+// of the name of each object. The full hash avoids a string compare for most objects in a chain.
+static int ksGltf_GetHashTableSize( const int count )
+{
+	int size = 16;
+	while ( size < 2 * count )
+	{
+		size <<= 1;
+	}
+	return size;
+}
+
+static int ksGltf_GetHashSize( const int count )
+{
+	return ksGltf_GetHashTableSize( count ) + 2 * count;
+}
 
 static unsigned int StringHash( const char * string )
 {
 	ksStringHash hash;
 	ksStringHash_Init( &hash );
 	ksStringHash_Update( &hash, string );
-	return ( hash & ( HASH_TABLE_SIZE - 1 ) );
+	return hash;
 }
 
 #define GLTF_HASH( type, typeCapitalized, name, nameCapitalized ) \
 	static void ksGltf_Create##typeCapitalized##nameCapitalized##Hash( ksGltfScene * scene ) \
 	{ \
-		scene->type##nameCapitalized##Hash = (int *) malloc( ( HASH_TABLE_SIZE + scene->type##Count ) * sizeof( scene->type##nameCapitalized##Hash[0] ) ); \
-		memset( scene->type##nameCapitalized##Hash, -1, ( HASH_TABLE_SIZE + scene->type##Count ) * sizeof( scene->type##nameCapitalized##Hash[0] ) ); \
+		const int tableSize = ksGltf_GetHashTableSize( scene->type##Count ); \
+		int * table = (int *) malloc( ksGltf_GetHashSize( scene->type##Count ) * sizeof( int ) ); \
+		memset( table, -1, tableSize * sizeof( int ) ); \
 		for ( int i = 0; i < scene->type##Count; i++ ) \
 		{ \
 			const unsigned int hash = StringHash( scene->type##s[i].name ); \
-			scene->type##nameCapitalized##Hash[HASH_TABLE_SIZE + i] = scene->type##nameCapitalized##Hash[hash]; \
-			scene->type##nameCapitalized##Hash[hash] = i; \
+			const int bucket = (int)( hash & ( tableSize - 1 ) ); \
+			table[tableSize + i] = table[bucket]; \
+			table[tableSize + scene->type##Count + i] = (int) hash; \
+			table[bucket] = i; \
 		} \
+		scene->type##nameCapitalized##Hash = table; \
 	} \
 	\
 	static ksGltf##typeCapitalized * ksGltf_Get##typeCapitalized##By##nameCapitalized( const ksGltfScene * scene, const char * name ) \
 	{ \
+		const int tableSize = ksGltf_GetHashTableSize( scene->type##Count ); \
+		const int * table = scene->type##nameCapitalized##Hash; \
 		const unsigned int hash = StringHash( name ); \
-		for ( int i = scene->type##nameCapitalized##Hash[hash]; i >= 0; i = scene->type##nameCapitalized##Hash[HASH_TABLE_SIZE + i] ) \
+		for ( int i = table[hash & ( tableSize - 1 )]; i >= 0; i = table[tableSize + i] ) \
 		{ \
-			if ( strcmp( scene->type##s[i].name, name ) == 0 ) \
+			if ( (unsigned int) table[tableSize + scene->type##Count + i] == hash && strcmp( scene->type##s[i].name, name ) == 0 ) \
 			{ \
 				return &scene->type##s[i]; \
 			} \
@@ -1253,1715 +1714,4407 @@ GLTF_HASH( node,		Node,		jointName,	JointName );
 GLTF_HASH( subTree,		SubTree,	name,		Name );
 GLTF_HASH( subScene,	SubScene,	name,		Name );
 
-static ksGltfAccessor * ksGltf_GetAccessorByNameAndType( const ksGltfScene * scene, const char * name, const char * type, const int componentType )
-{
-	ksGltfAccessor * accessor = ksGltf_GetAccessorByName( scene, name );
-	if ( accessor != NULL &&
-			accessor->componentType == componentType &&
-				strcmp( accessor->type, type ) == 0 )
-	{
-		return accessor;
-	}
-	return NULL;
-}
-
-static void * ksGltf_GetBufferData( const ksGltfAccessor * accessor )
-{
-	if ( accessor != NULL )
-	{
-		return accessor->bufferView->buffer->bufferData + accessor->bufferView->byteOffset + accessor->byteOffset;
+// glTF 1.0 references objects by name and glTF 2.0 references objects by array index.
+#define GLTF_REFERENCE( type, typeCapitalized ) \
+	static ksGltf##typeCapitalized * ksGltf_Get##typeCapitalized##ByReference( const ksGltfScene * scene, const ksJson * reference ) \
+	{ \
+		if ( reference == NULL ) \
+		{ \
+			return NULL; \
+		} \
+		if ( ksJson_IsNumber( reference ) ) \
+		{ \
+			const int index = ksJson_GetInt32( reference, -1 ); \
+			return ( index >= 0 && index < scene->type##Count ) ? &scene->type##s[index] : NULL; \
+		} \
+		return ksGltf_Get##typeCapitalized##ByName( scene, ksJson_GetString( reference, "" ) ); \
 	}
-	return NULL;
-}
-
-static char * ksGltf_strdup( const char * str )
-{
-	char * out = (char *)malloc( strlen( str ) + 1 );
-	strcpy( out, str );
-	return out;
-}
 
-static unsigned char * ksGltf_ReadFile( const char * fileName, size_t * outSizeInBytes )
+GLTF_REFERENCE( buffer,		Buffer );
+GLTF_REFERENCE( bufferView,	BufferView );
+GLTF_REFERENCE( accessor,	Accessor );
+GLTF_REFERENCE( image,		Image );
+GLTF_REFERENCE( sampler,	Sampler );
+GLTF_REFERENCE( texture,	Texture );
+GLTF_REFERENCE( shader,		Shader );
+GLTF_REFERENCE( program,	Program );
+GLTF_REFERENCE( technique,	Technique );
+GLTF_REFERENCE( material,	Material );
+GLTF_REFERENCE( skin,		Skin );
+GLTF_REFERENCE( model,		Model );
+GLTF_REFERENCE( camera,		Camera );
+GLTF_REFERENCE( subScene,	SubScene );
+
+// Nodes are sorted at load time so glTF 2.0 node indices are remapped to the sorted order.
+static ksGltfNode * ksGltf_GetNodeByReference( const ksGltfScene * scene, const ksJson * reference, const int * nodeIndexRemap )
 {
-	FILE * file = fopen( fileName, "rb" );
-	if ( file == NULL )
-	{
-		return NULL;
-	}
-	const size_t maxSizeInBytes = ( outSizeInBytes != NULL && *outSizeInBytes > 0 ) ? *outSizeInBytes : SIZE_MAX;
-	fseek( file, 0L, SEEK_END );
-	size_t bufferSize = (size_t) ftell( file );
-	bufferSize = MIN( bufferSize, maxSizeInBytes );
-	fseek( file, 0L, SEEK_SET );
-	unsigned char * buffer = (unsigned char *) malloc( bufferSize + 1 );
-	if ( fread( buffer, 1, bufferSize, file ) != bufferSize )
+	if ( reference == NULL )
 	{
-		fclose( file );
-		free( buffer );
 		return NULL;
 	}
-	buffer[bufferSize] = '\0';
-	fclose( file );
-	if ( outSizeInBytes != NULL )
+	if ( ksJson_IsNumber( reference ) )
 	{
-		*outSizeInBytes = bufferSize;
+		const int index = ksJson_GetInt32( reference, -1 );
+		return ( index >= 0 && index < scene->nodeCount ) ? &scene->nodes[nodeIndexRemap[index]] : NULL;
 	}
-	return buffer;
+	return ksGltf_GetNodeByName( scene, ksJson_GetString( reference, "" ) );
 }
 
-static unsigned char * ksGltf_ReadPlainText( const char * uri, size_t * outSizeInBytes )
+static ksGltfAccessor * ksGltf_GetAccessorByReferenceAndType( const ksGltfScene * scene, const ksJson * reference, const char * type )
 {
-	const size_t maxSizeInBytes = ( outSizeInBytes != NULL && *outSizeInBytes > 0 ) ? *outSizeInBytes : SIZE_MAX;
-	const size_t length = MIN( strlen( uri ), maxSizeInBytes );
-	char * out = (char *)malloc( length + 1 );
-	strncpy( out, uri, length );
-	out[length] = '\0';
-	if ( outSizeInBytes != NULL )
+	ksGltfAccessor * accessor = ksGltf_GetAccessorByReference( scene, reference );
+	if ( accessor != NULL && strcmp( accessor->type, type ) == 0 )
 	{
-		*outSizeInBytes = length;
+		return accessor;
 	}
-	return (unsigned char *)out;
+	return NULL;
 }
 
-static unsigned char * ksGltf_ReadBase64( const char * base64, size_t * outSizeInBytes )
+static void * ksGltf_GetBufferData( const ksGltfAccessor * accessor )
 {
-	const size_t maxSizeInBytes = ( outSizeInBytes != NULL && *outSizeInBytes > 0 ) ? *outSizeInBytes : SIZE_MAX;
-	size_t base64SizeInBytes = strlen( base64 );
-	size_t dataSizeInBytes = ksBase64_DecodeSizeInBytes( base64, base64SizeInBytes );
-	dataSizeInBytes = MIN( dataSizeInBytes, maxSizeInBytes );
-	unsigned char * buffer = (unsigned char *)malloc( dataSizeInBytes );
-	ksBase64_Decode( buffer, base64, base64SizeInBytes, dataSizeInBytes );
-	if ( outSizeInBytes != NULL )
+	if ( accessor != NULL && accessor->bufferView != NULL )
 	{
-		*outSizeInBytes = dataSizeInBytes;
+		return accessor->bufferView->buffer->bufferData + accessor->bufferView->byteOffset + accessor->byteOffset;
 	}
-	return buffer;
+	return NULL;
 }
 
-static unsigned char * ksGltf_ReadBinaryBuffer( const unsigned char * binaryBuffer, const char * uri, size_t * outSizeInBytes )
+static int ksGltf_GetComponentSize( const int componentType )
 {
-	const size_t maxSizeInBytes = ( outSizeInBytes != NULL && *outSizeInBytes > 0 ) ? *outSizeInBytes : SIZE_MAX;
-	char * endptr = NULL;
-	size_t byteOffset = (size_t) strtol( uri, &endptr, 16 );
-	size_t byteLength = (size_t) strtol( endptr + 1, &endptr, 16 );
-	byteLength = MIN( byteLength, maxSizeInBytes );
-	unsigned char * data = (unsigned char *) malloc( byteLength + 1 );
-	memcpy( data, binaryBuffer + byteOffset, byteLength );
-	data[byteLength] = '\0';
-	if ( outSizeInBytes != NULL )
+	switch ( componentType )
 	{
-		*outSizeInBytes = (int)byteLength;
+		case GL_BYTE:			return 1;
+		case GL_UNSIGNED_BYTE:	return 1;
+		case GL_SHORT:			return 2;
+		case GL_UNSIGNED_SHORT:	return 2;
+		case GL_UNSIGNED_INT:	return 4;
+		case GL_FLOAT:			return 4;
+		default:				return 0;
 	}
-	return data;
 }
 
-// if outSizeInBytes != NULL and *outSizeInBytes > 0 then only *outSizeInBytes bytes will be read.
-static unsigned char * ksGltf_ReadUri( const unsigned char * binaryBuffer, const char * uri, size_t * outSizeInBytes )
+static int ksGltf_GetComponentCount( const char * type )
 {
-	if ( strncmp( uri, "data:", 5 ) == 0 )
+	if ( strcmp( type, "SCALAR" ) == 0 ) { return 1; }
+	if ( strcmp( type, "VEC2" ) == 0 ) { return 2; }
+	if ( strcmp( type, "VEC3" ) == 0 ) { return 3; }
+	if ( strcmp( type, "VEC4" ) == 0 ) { return 4; }
+	if ( strcmp( type, "MAT2" ) == 0 ) { return 4; }
+	if ( strcmp( type, "MAT3" ) == 0 ) { return 9; }
+	if ( strcmp( type, "MAT4" ) == 0 ) { return 16; }
+	return 0;
+}
+
+// Buffer data is not necessarily aligned so components are copied before they are converted.
+static float ksGltf_ReadComponent( const unsigned char * data, const int componentType, const bool normalized )
+{
+	switch ( componentType )
 	{
-		// Plain text.
-		if ( strncmp( uri, "data:text/plain,", 16 ) == 0 )
+		case GL_BYTE:
 		{
-			return ksGltf_ReadPlainText( uri + 16, outSizeInBytes );
+			const int8_t value = (int8_t) data[0];
+			return normalized ? MAX( value / 127.0f, -1.0f ) : (float) value;
 		}
-		// Base64 text shader.
-		else if ( strncmp( uri, "data:text/plain;base64,", 23 ) == 0 )
+		case GL_UNSIGNED_BYTE:
 		{
-			return ksGltf_ReadBase64( uri + 23, outSizeInBytes );
+			const uint8_t value = data[0];
+			return normalized ? value / 255.0f : (float) value;
 		}
-		// Base64 binary buffer.
-		else if ( strncmp( uri, "data:application/octet-stream;base64,", 37 ) == 0 )
+		case GL_SHORT:
 		{
-			return ksGltf_ReadBase64( uri + 37, outSizeInBytes );
+			int16_t value;
+			memcpy( &value, data, sizeof( value ) );
+			return normalized ? MAX( value / 32767.0f, -1.0f ) : (float) value;
 		}
-		// Base64 JPG, PNG, BMP, GIF, KTX image.
-		else if (	strncmp( uri, "data:image/jpg;base64,", 22 ) == 0 ||
-					strncmp( uri, "data:image/png;base64,", 22 ) == 0 ||
-					strncmp( uri, "data:image/bmp;base64,", 22 ) == 0 ||
-					strncmp( uri, "data:image/gif;base64,", 22 ) == 0 ||
-					strncmp( uri, "data:image/ktx;base64,", 22 ) == 0 )
+		case GL_UNSIGNED_SHORT:
 		{
-			return ksGltf_ReadBase64( uri + 22, outSizeInBytes );
+			uint16_t value;
+			memcpy( &value, data, sizeof( value ) );
+			return normalized ? value / 65535.0f : (float) value;
 		}
-		// bufferView
-		else if ( strncmp( uri, URI_SCHEME_APPLICATION_BINARY, URI_SCHEME_APPLICATION_BINARY_LENGTH ) == 0 )
+		case GL_UNSIGNED_INT:
 		{
-			return ksGltf_ReadBinaryBuffer( binaryBuffer, uri + URI_SCHEME_APPLICATION_BINARY_LENGTH, outSizeInBytes );
+			uint32_t value;
+			memcpy( &value, data, sizeof( value ) );
+			return normalized ? (float)( value / 4294967295.0 ) : (float) value;
 		}
-	}
-	return ksGltf_ReadFile( uri, outSizeInBytes );
-}
-
-static char * ksGltf_ParseUri( const ksGltfScene * scene, const ksJson * json, const char * uriName )
-{
-	const ksJson * jsonUri = ksJson_GetMemberByName( json, uriName );
-	if ( jsonUri == NULL )
-	{
-		return ksGltf_strdup( "" );
-	}
-	const ksJson * extensions = ksJson_GetMemberByName( json, "extensions" );
-	if ( extensions != NULL )
-	{
-		const char * bufferViewName = ksJson_GetString( ksJson_GetMemberByName( ksJson_GetMemberByName( extensions, "KHR_binary_glTF" ), "bufferView" ), "" );
-		if ( bufferViewName[0] != '\0' )
+		case GL_FLOAT:
 		{
-			const ksGltfBufferView * bufferView = ksGltf_GetBufferViewByName( scene, bufferViewName );
-			if ( bufferView != NULL )
-			{
-				char * uri = (char *) malloc( URI_SCHEME_APPLICATION_BINARY_LENGTH + 10 + 1 + 10 + 1 );
-				sprintf( uri, "%s0x%X,0x%X", URI_SCHEME_APPLICATION_BINARY, (uint32_t)bufferView->byteOffset, (uint32_t)bufferView->byteLength );
-				return uri;
-			}
+			float value;
+			memcpy( &value, data, sizeof( value ) );
+			return value;
 		}
 	}
-	return ksGltf_strdup( ksJson_GetString( jsonUri, "" ) );
-}
-
-const char * ksGltf_GetImageContainerFromUri( const char * uri )
-{
-	if ( strncmp( uri, "data:image/", 11 ) == 0 )
-	{
-		if ( strncmp( uri + 11, "jpg;", 4 ) == 0 ) { return "jpg"; }
-		if ( strncmp( uri + 11, "png;", 4 ) == 0 ) { return "png"; }
-		if ( strncmp( uri + 11, "bmp;", 4 ) == 0 ) { return "bmp"; }
-		if ( strncmp( uri + 11, "gif;", 4 ) == 0 ) { return "gif"; }
-		if ( strncmp( uri + 11, "ktx;", 4 ) == 0 ) { return "ktx"; }
-	}
-	return "";
+	return 0.0f;
 }
 
-const int ksGltf_GetImageInternalFormatFromUri( const unsigned char * binaryBuffer, const char * uri )
+static uint32_t ksGltf_ReadIndex( const unsigned char * data, const int componentType )
 {
-	int glInternalFormat = GL_RGB8;
-	if ( strncmp( uri, "data:image/", 11 ) == 0 )
+	switch ( componentType )
 	{
-		if ( strncmp( uri + 11, "jpg;", 4 ) == 0 )
-		{
-			glInternalFormat = GL_RGB8;
-		}
-		else if ( strncmp( uri + 11, "png;", 4 ) == 0 )
+		case GL_UNSIGNED_BYTE:
 		{
-			size_t outSizeInBytes = 16;
-			unsigned char * data = ksGltf_ReadUri( binaryBuffer, uri, &outSizeInBytes );
-			glInternalFormat = ( data[9] == 4 || data[9] == 6 ) ? GL_RGBA8 : GL_RGB8;
-			free( data );
-		}
-		else if ( strncmp( uri + 11, "bmp;", 4 ) == 0 )
-		{
-			size_t outSizeInBytes = 32;
-			unsigned char * data = ksGltf_ReadUri( binaryBuffer, uri, &outSizeInBytes );
-			glInternalFormat = ( ( data[28] | ( data[29] << 8 ) ) == 32 ) ? GL_RGBA8 : GL_RGB8;
-			free( data );
+			return data[0];
 		}
-		else if ( strncmp( uri + 11, "gif;", 4 ) == 0 )
+		case GL_UNSIGNED_SHORT:
 		{
-			size_t outSizeInBytes = 1024;
-			unsigned char * data = ksGltf_ReadUri( binaryBuffer, uri, &outSizeInBytes );
-			const size_t colorTableSize = ( data[6 + 4] >> 7 ) * 3 * ( 1 << ( ( ( data[6 + 4] >> 4 ) & 7 ) + 1 ) );
-			if ( data[6 + 7 + colorTableSize + 0] == 0x21 && data[6 + 7 + colorTableSize + 1] == 0xF9 )
-			{
-				glInternalFormat = ( data[6 + 7 + colorTableSize + 3] >> 7 ) ? GL_RGBA8 : GL_RGB8;
-			}
-			free( data );
+			uint16_t value;
+			memcpy( &value, data, sizeof( value ) );
+			return value;
 		}
-		else if ( strncmp( uri + 11, "ktx;", 4 ) == 0 )
+		case GL_UNSIGNED_INT:
 		{
-			size_t outSizeInBytes = 48;
-			unsigned char * data = ksGltf_ReadUri( binaryBuffer, uri, &outSizeInBytes );
-			glInternalFormat = ( data[28] | ( data[29] << 8 ) || ( data[30] << 16 ) | ( data[31] << 24 ) );
-			free( data );
+			uint32_t value;
+			memcpy( &value, data, sizeof( value ) );
+			return value;
 		}
 	}
-	return glInternalFormat;
+	return 0;
 }
 
-typedef enum
+/*
+Unpack the accessor elements to tightly packed floats with dstComponentCount components per element.
+This handles interleaved elements, integer and normalized integer components and sparse accessors.
+Missing components are set to zero, except for the fourth component, which is set to one.
+*/
+static void ksGltf_UnpackAccessorFloats( float * dst, const int dstComponentCount, const ksGltfAccessor * accessor )
 {
-	GLTF_COMPRESSED_IMAGE_DXT			= BIT( 0 ),
-	GLTF_COMPRESSED_IMAGE_DXT_SRGB		= BIT( 1 ),
-	GLTF_COMPRESSED_IMAGE_ETC2			= BIT( 2 ),
-	GLTF_COMPRESSED_IMAGE_ETC2_SRGB		= BIT( 3 ),
-	GLTF_COMPRESSED_IMAGE_ASTC			= BIT( 4 ),
-	GLTF_COMPRESSED_IMAGE_ASTC_SRGB		= BIT( 5 )
-} ksGltfCompressedImageFlags;
+	const int componentSize = ksGltf_GetComponentSize( accessor->componentType );
+	const int componentCount = MIN( accessor->componentCount, dstComponentCount );
+	const size_t elementSize = componentSize * accessor->componentCount;
+	const size_t elementStride = ( accessor->byteStride != 0 ) ? accessor->byteStride : elementSize;
+	const unsigned char * src = (const unsigned char *) ksGltf_GetBufferData( accessor );
 
-static const char * ksGltf_FindImageUri( const ksGltfImage * image, const char * containers[], const ksGltfCompressedImageFlags flags )
-{
-	for ( int i = 0; i < image->versionCount; i++ )
+	if ( src != NULL && accessor->componentType == GL_FLOAT && accessor->componentCount == dstComponentCount && elementStride == elementSize )
 	{
-		bool found = false;
-		for ( int j = 0; containers[j] != NULL; j++ )
+		memcpy( dst, src, accessor->count * elementSize );
+	}
+	else
+	{
+		for ( int i = 0; i < accessor->count; i++ )
 		{
-			if ( strcmp( image->versions[i].container, containers[j] ) == 0 )
+			float * element = dst + i * dstComponentCount;
+			for ( int c = 0; c < dstComponentCount; c++ )
 			{
-				found = true;
-				break;
+				element[c] = ( c == 3 ) ? 1.0f : 0.0f;
 			}
-		}
-		if ( !found )
-		{
-			continue;
-		}
-
-		if ( ( flags & GLTF_COMPRESSED_IMAGE_DXT ) == 0 )
-		{
-			if (	( image->versions[i].glInternalFormat >= GL_COMPRESSED_RGB_S3TC_DXT1_EXT &&
-					image->versions[i].glInternalFormat <= GL_COMPRESSED_RGBA_S3TC_DXT5_EXT ) ||
-					( image->versions[i].glInternalFormat >= GL_COMPRESSED_LUMINANCE_LATC1_EXT &&
-					image->versions[i].glInternalFormat <= GL_COMPRESSED_SIGNED_LUMINANCE_ALPHA_LATC2_EXT ) )
+			if ( src != NULL )
 			{
-				continue;
+				for ( int c = 0; c < componentCount; c++ )
+				{
+					element[c] = ksGltf_ReadComponent( src + i * elementStride + c * componentSize, accessor->componentType, accessor->normalized );
+				}
 			}
 		}
+	}
 
-		if ( ( flags & GLTF_COMPRESSED_IMAGE_DXT_SRGB ) == 0 )
+	if ( accessor->sparse.count > 0 )
+	{
+		const int indexSize = ksGltf_GetComponentSize( accessor->sparse.indicesComponentType );
+		const unsigned char * indices = accessor->sparse.indicesBufferView->buffer->bufferData + accessor->sparse.indicesBufferView->byteOffset + accessor->sparse.indicesByteOffset;
+		const unsigned char * values = accessor->sparse.valuesBufferView->buffer->bufferData + accessor->sparse.valuesBufferView->byteOffset + accessor->sparse.valuesByteOffset;
+		for ( int i = 0; i < accessor->sparse.count; i++ )
 		{
-			if (	( image->versions[i].glInternalFormat >= GL_COMPRESSED_SRGB_S3TC_DXT1_EXT &&
-					image->versions[i].glInternalFormat <= GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT ) )
+			const uint32_t index = ksGltf_ReadIndex( indices + i * indexSize, accessor->sparse.indicesComponentType );
+			if ( index >= (uint32_t)accessor->count )
 			{
 				continue;
 			}
-		}
-
-		if ( ( flags & GLTF_COMPRESSED_IMAGE_ETC2 ) == 0 )
-		{
-			if (	image->versions[i].glInternalFormat == GL_COMPRESSED_RGB8_ETC2 ||
-					image->versions[i].glInternalFormat == GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2 ||
-					image->versions[i].glInternalFormat == GL_COMPRESSED_RGBA8_ETC2_EAC ||
-					image->versions[i].glInternalFormat == GL_COMPRESSED_R11_EAC ||
-					image->versions[i].glInternalFormat == GL_COMPRESSED_SIGNED_RG11_EAC )
+			float * element = dst + index * dstComponentCount;
+			for ( int c = 0; c < componentCount; c++ )
 			{
-				continue;
+				element[c] = ksGltf_ReadComponent( values + i * elementSize + c * componentSize, accessor->componentType, accessor->normalized );
 			}
 		}
+	}
+}
 
-		if ( ( flags & GLTF_COMPRESSED_IMAGE_ETC2_SRGB ) == 0 )
+// Returns false if an index does not fit in a ksGpuTriangleIndex.
+static bool ksGltf_UnpackAccessorIndices( ksGpuTriangleIndex * dst, const ksGltfAccessor * accessor )
+{
+	const int componentSize = ksGltf_GetComponentSize( accessor->componentType );
+	const size_t elementStride = ( accessor->byteStride != 0 ) ? accessor->byteStride : (size_t)componentSize;
+	const unsigned char * src = (const unsigned char *) ksGltf_GetBufferData( accessor );
+	if ( src == NULL )
+	{
+		return false;
+	}
+	if ( accessor->componentType == GL_UNSIGNED_SHORT && sizeof( ksGpuTriangleIndex ) == 2 && elementStride == 2 )
+	{
+		memcpy( dst, src, accessor->count * sizeof( dst[0] ) );
+		return true;
+	}
+	const uint32_t maxIndex = (uint32_t)( (ksGpuTriangleIndex) -1 );
+	for ( int i = 0; i < accessor->count; i++ )
+	{
+		const uint32_t index = ksGltf_ReadIndex( src + i * elementStride, accessor->componentType );
+		if ( index > maxIndex )
 		{
-			if (	image->versions[i].glInternalFormat == GL_COMPRESSED_SRGB8_ETC2 ||
-					image->versions[i].glInternalFormat == GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2 ||
-					image->versions[i].glInternalFormat == GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC )
-			{
-				continue;
-			}
-		}
-
-		if ( ( flags & GLTF_COMPRESSED_IMAGE_ASTC ) == 0 )
-		{
-			if (	image->versions[i].glInternalFormat >= GL_COMPRESSED_RGBA_ASTC_4x4_KHR &&
-					image->versions[i].glInternalFormat >= GL_COMPRESSED_RGBA_ASTC_12x12_KHR )
-			{
-				continue;
-			}
-		}
-
-		if ( ( flags & GLTF_COMPRESSED_IMAGE_ASTC ) == 0 )
-		{
-			if (	image->versions[i].glInternalFormat >= GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR &&
-					image->versions[i].glInternalFormat >= GL_COMPRESSED_SRGB8_ALPHA8_ASTC_12x12_KHR )
-			{
-				continue;
-			}
+			return false;
 		}
-
-		return image->versions[i].uri;
+		dst[i] = (ksGpuTriangleIndex) index;
 	}
-
-	return "";
+	return true;
 }
 
-static const char * ksGltf_FindShaderUri( const ksGltfShader * shader, const ksGltfShaderType type, const char * apiString, const char * maxVersionString )
+// Unpacks indices of any size for geometry that is split because it has too many vertices for a ksGpuTriangleIndex.
+static bool ksGltf_UnpackAccessorIndices32( uint32_t * dst, const ksGltfAccessor * accessor )
 {
-	const int maxVersion = atoi( maxVersionString );
-	const char * bestUri = NULL;
-	int bestVersion = 0;
-	for ( int i = 0; i < shader->shaderCount[type]; i++ )
+	const int componentSize = ksGltf_GetComponentSize( accessor->componentType );
+	const size_t elementStride = ( accessor->byteStride != 0 ) ? accessor->byteStride : (size_t)componentSize;
+	const unsigned char * src = (const unsigned char *) ksGltf_GetBufferData( accessor );
+	if ( src == NULL )
 	{
-		if ( strcmp( shader->shaders[type][i].api, apiString ) == 0 )
-		{
-			const int version = atoi( shader->shaders[type][i].version );
-			if ( version <= maxVersion && version > bestVersion )
-			{
-				bestVersion = version;
-				bestUri = shader->shaders[type][i].uri;
-			}
-		}
+		return false;
 	}
-	return bestUri;
+	for ( int i = 0; i < accessor->count; i++ )
+	{
+		dst[i] = ksGltf_ReadIndex( src + i * elementStride, accessor->componentType );
+	}
+	return true;
 }
 
-static void ksGltf_ParseIntArray( int * elements, const int count, const ksJson * arrayNode )
+/*
+Returns the accessor elements as tightly packed floats. Tightly packed and aligned float data
+is referenced in place. Otherwise the elements are unpacked once and the unpacked data is
+stored with the accessor.
+*/
+static float * ksGltf_GetAccessorFloats( ksGltfAccessor * accessor )
 {
-	int i = 0;
-	for ( ; i < ksJson_GetMemberCount( arrayNode ) && i < count; i++ )
+	if ( accessor == NULL )
 	{
-		elements[i] = ksJson_GetInt32( ksJson_GetMemberByIndex( arrayNode, i ), 0 );
+		return NULL;
 	}
-	for ( ; i < count; i++ )
+	if ( accessor->unpackedData != NULL )
 	{
-		elements[i] = 0;
+		return accessor->unpackedData;
+	}
+	unsigned char * data = (unsigned char *) ksGltf_GetBufferData( accessor );
+	const size_t elementSize = accessor->componentCount * sizeof( float );
+	if (	data != NULL &&
+			accessor->componentType == GL_FLOAT &&
+			accessor->sparse.count == 0 &&
+			( accessor->byteStride == 0 || accessor->byteStride == elementSize ) &&
+			( (uintptr_t)data & ( sizeof( float ) - 1 ) ) == 0 )
+	{
+		return (float *) data;
 	}
+	accessor->unpackedData = (float *) malloc( accessor->count * elementSize );
+	ksGltf_UnpackAccessorFloats( accessor->unpackedData, accessor->componentCount, accessor );
+	return accessor->unpackedData;
 }
 
-static void ksGltf_ParseFloatArray( float * elements, const int count, const ksJson * arrayNode )
+/*
+A CUBICSPLINE animation sampler stores an in-tangent, a value and an out-tangent per key frame.
+Only the values are used and these are linearly interpolated. The values are returned in a new
+array that the caller frees. The accessor is not changed so it can still be used by other samplers.
+*/
+static float * ksGltf_GetAccessorSplineValues( ksGltfAccessor * accessor, const int keyFrameCount )
 {
-	int i = 0;
-	for ( ; i < ksJson_GetMemberCount( arrayNode ) && i < count; i++ )
+	if ( accessor == NULL || accessor->count != 3 * keyFrameCount )
 	{
-		elements[i] = ksJson_GetFloat( ksJson_GetMemberByIndex( arrayNode, i ), 0.0f );
+		return NULL;
 	}
-	for ( ; i < count; i++ )
+	const float * elements = ksGltf_GetAccessorFloats( accessor );
+	float * values = (float *) malloc( keyFrameCount * accessor->componentCount * sizeof( float ) );
+	for ( int i = 0; i < keyFrameCount; i++ )
 	{
-		elements[i] = 0.0f;
+		memcpy( values + i * accessor->componentCount, elements + ( 3 * i + 1 ) * accessor->componentCount, accessor->componentCount * sizeof( float ) );
 	}
+	return values;
 }
 
-static void ksGltf_ParseUniformValue( ksGltfUniformValue * value, const ksJson * json, const ksGpuProgramParmType type, const ksGltfScene * scene )
+static void ksGltf_AllocBoundsArray( ksBounds3fArray * bounds, const int count )
 {
-	switch ( type )
+	float * data = (float *) malloc( 6 * count * sizeof( float ) );
+	for ( int axis = 0; axis < 3; axis++ )
 	{
-		case KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_SAMPLED:					value->texture = ksGltf_GetTextureByName( scene, ksJson_GetString( json, "" ) ); break;
-		case KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_INT:				value->intValue[0] = ksJson_GetInt32( json, 0 ); break;
-		case KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_INT_VECTOR2:		ksGltf_ParseIntArray( value->intValue, 16, json ); break;
-		case KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_INT_VECTOR3:		ksGltf_ParseIntArray( value->intValue, 16, json ); break;
-		case KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_INT_VECTOR4:		ksGltf_ParseIntArray( value->intValue, 16, json ); break;
-		case KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT:				value->floatValue[0] = ksJson_GetFloat( json, 0.0f ); break;
-		case KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_VECTOR2:		ksGltf_ParseFloatArray( value->floatValue, 2, json ); break;
-		case KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_VECTOR3:		ksGltf_ParseFloatArray( value->floatValue, 3, json ); break;
-		case KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_VECTOR4:		ksGltf_ParseFloatArray( value->floatValue, 4, json ); break;
-		case KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX2X2:	ksGltf_ParseFloatArray( value->floatValue, 2*2, json ); break;
-		case KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX2X3:	ksGltf_ParseFloatArray( value->floatValue, 2*3, json ); break;
-		case KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX2X4:	ksGltf_ParseFloatArray( value->floatValue, 2*4, json ); break;
-		case KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX3X2:	ksGltf_ParseFloatArray( value->floatValue, 3*2, json ); break;
-		case KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX3X3:	ksGltf_ParseFloatArray( value->floatValue, 3*3, json ); break;
-		case KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX3X4:	ksGltf_ParseFloatArray( value->floatValue, 3*4, json ); break;
-		case KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX4X2:	ksGltf_ParseFloatArray( value->floatValue, 4*2, json ); break;
-		case KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX4X3:	ksGltf_ParseFloatArray( value->floatValue, 4*3, json ); break;
-		case KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX4X4:	ksGltf_ParseFloatArray( value->floatValue, 4*4, json ); break;
-		default: break;
+		bounds->mins[axis] = data + ( 0 + axis ) * count;
+		bounds->maxs[axis] = data + ( 3 + axis ) * count;
 	}
 }
 
-static ksGpuTextureFilter ksGltf_GetTextureFilter( const int filter )
+static void ksGltf_FreeBoundsArray( ksBounds3fArray * bounds )
 {
-	switch ( filter )
+	free( bounds->mins[0] );
+	for ( int axis = 0; axis < 3; axis++ )
 	{
-		case GL_NEAREST:					return KS_GPU_TEXTURE_FILTER_NEAREST;
-		case GL_LINEAR:						return KS_GPU_TEXTURE_FILTER_LINEAR;
-		case GL_NEAREST_MIPMAP_NEAREST:		return KS_GPU_TEXTURE_FILTER_NEAREST;
-		case GL_LINEAR_MIPMAP_NEAREST:		return KS_GPU_TEXTURE_FILTER_NEAREST;
-		case GL_NEAREST_MIPMAP_LINEAR:		return KS_GPU_TEXTURE_FILTER_BILINEAR;
-		case GL_LINEAR_MIPMAP_LINEAR:		return KS_GPU_TEXTURE_FILTER_BILINEAR;
-		default:							return KS_GPU_TEXTURE_FILTER_BILINEAR;
+		bounds->mins[axis] = NULL;
+		bounds->maxs[axis] = NULL;
 	}
 }
 
-static ksGpuTextureWrapMode ksGltf_GetTextureWrapMode( const int wrapMode )
+static void ksGltf_AllocNodeState( ksGltfNodeState * nodeState, const int count )
 {
-	switch ( wrapMode )
+	float * data = (float *) calloc( 10 * count, sizeof( float ) );
+	for ( int i = 0; i < 3; i++ )
 	{
-		case GL_REPEAT:				return KS_GPU_TEXTURE_WRAP_MODE_REPEAT;
-		case GL_CLAMP_TO_EDGE:		return KS_GPU_TEXTURE_WRAP_MODE_CLAMP_TO_EDGE;
-		case GL_CLAMP_TO_BORDER:	return KS_GPU_TEXTURE_WRAP_MODE_CLAMP_TO_BORDER;
-		default:					return KS_GPU_TEXTURE_WRAP_MODE_REPEAT;
+		nodeState->transforms.translation[i] = data + ( 0 + i ) * count;
+		nodeState->transforms.scale[i] = data + ( 3 + i ) * count;
+	}
+	for ( int i = 0; i < 4; i++ )
+	{
+		nodeState->transforms.rotation[i] = data + ( 6 + i ) * count;
 	}
+	nodeState->parent = (int *) malloc( count * sizeof( int ) );
+	nodeState->localTransform = (ksMatrix4x4f *) malloc( count * sizeof( ksMatrix4x4f ) );
+	nodeState->globalTransform = (ksMatrix4x4f *) malloc( count * sizeof( ksMatrix4x4f ) );
+	nodeState->globalInverseTransform = (ksMatrix4x4f *) malloc( count * sizeof( ksMatrix4x4f ) );
+	nodeState->globalTransformType = (ksGltfTransformType *) malloc( count * sizeof( ksGltfTransformType ) );
+	nodeState->globalInverseRequired = (bool *) malloc( count * sizeof( bool ) );
+	nodeState->localDirty = (bool *) malloc( count * sizeof( bool ) );
+	nodeState->globalSimulateIndex = (int *) malloc( count * sizeof( int ) );
 }
 
-static ksGpuProgramStageFlags ksGltf_GetProgramStageFlag( const int stage )
+static void ksGltf_FreeNodeState( ksGltfNodeState * nodeState )
 {
-	switch ( stage )
-	{
-		case GL_VERTEX_SHADER:		return KS_GPU_PROGRAM_STAGE_FLAG_VERTEX;
-		case GL_FRAGMENT_SHADER:	return KS_GPU_PROGRAM_STAGE_FLAG_FRAGMENT;
-		default:					return KS_GPU_PROGRAM_STAGE_FLAG_VERTEX;
-	}
+	free( nodeState->transforms.translation[0] );
+	free( nodeState->parent );
+	free( nodeState->localTransform );
+	free( nodeState->globalTransform );
+	free( nodeState->globalInverseTransform );
+	free( nodeState->globalTransformType );
+	free( nodeState->globalInverseRequired );
+	free( nodeState->localDirty );
+	free( nodeState->globalSimulateIndex );
+	memset( nodeState, 0, sizeof( ksGltfNodeState ) );
 }
 
-static ksGpuFrontFace ksGltf_GetFrontFace( const int face )
+// Only the components that are not NULL are set. The node is only marked dirty, such that its transforms are
+// recalculated, if a component actually changed. A paused or constant animation therefore does not dirty the hierarchy.
+static void ksGltf_SetNodeTransform( ksGltfNodeState * nodeState, const int nodeIndex, const ksVector3f * translation, const ksQuatf * rotation, const ksVector3f * scale )
 {
-	switch ( face )
+	ksTransformArray * transforms = &nodeState->transforms;
+	bool changed = false;
+	if ( translation != NULL )
 	{
-		case GL_CCW:	return KS_GPU_FRONT_FACE_COUNTER_CLOCKWISE;
-		case GL_CW:		return KS_GPU_FRONT_FACE_CLOCKWISE;
-		default:		return KS_GPU_FRONT_FACE_COUNTER_CLOCKWISE;
+		changed |= ( transforms->translation[0][nodeIndex] != translation->x ||
+					transforms->translation[1][nodeIndex] != translation->y ||
+					transforms->translation[2][nodeIndex] != translation->z );
+		transforms->translation[0][nodeIndex] = translation->x;
+		transforms->translation[1][nodeIndex] = translation->y;
+		transforms->translation[2][nodeIndex] = translation->z;
+	}
+	if ( rotation != NULL )
+	{
+		changed |= ( transforms->rotation[0][nodeIndex] != rotation->x ||
+					transforms->rotation[1][nodeIndex] != rotation->y ||
+					transforms->rotation[2][nodeIndex] != rotation->z ||
+					transforms->rotation[3][nodeIndex] != rotation->w );
+		transforms->rotation[0][nodeIndex] = rotation->x;
+		transforms->rotation[1][nodeIndex] = rotation->y;
+		transforms->rotation[2][nodeIndex] = rotation->z;
+		transforms->rotation[3][nodeIndex] = rotation->w;
+	}
+	if ( scale != NULL )
+	{
+		changed |= ( transforms->scale[0][nodeIndex] != scale->x ||
+					transforms->scale[1][nodeIndex] != scale->y ||
+					transforms->scale[2][nodeIndex] != scale->z );
+		transforms->scale[0][nodeIndex] = scale->x;
+		transforms->scale[1][nodeIndex] = scale->y;
+		transforms->scale[2][nodeIndex] = scale->z;
+	}
+	if ( changed )
+	{
+		nodeState->localDirty[nodeIndex] = true;
 	}
 }
 
-static ksGpuCullMode ksGltf_GetCullMode( const int mode )
+static void ksGltf_SetBoundsArray( ksBounds3fArray * bounds, const int index, const ksVector3f * mins, const ksVector3f * maxs )
 {
-	switch ( mode )
-	{
-		case GL_NONE:	return KS_GPU_CULL_MODE_NONE;
-		case GL_FRONT:	return KS_GPU_CULL_MODE_FRONT;
-		case GL_BACK:	return KS_GPU_CULL_MODE_BACK;
-		default:		return KS_GPU_CULL_MODE_BACK;
-	}
+	bounds->mins[0][index] = mins->x;
+	bounds->mins[1][index] = mins->y;
+	bounds->mins[2][index] = mins->z;
+	bounds->maxs[0][index] = maxs->x;
+	bounds->maxs[1][index] = maxs->y;
+	bounds->maxs[2][index] = maxs->z;
 }
 
-static ksGpuCompareOp ksGltf_GetCompareOp( const int op )
+static bool ksGltf_IsUniformScale( const ksVector3f * scale )
 {
-	switch ( op )
+	const float epsilon = 1e-6f * fabsf( scale->x );
+	return ( fabsf( scale->y - scale->x ) <= epsilon && fabsf( scale->z - scale->x ) <= epsilon );
+}
+
+/*
+================================================================================================================================
+
+Animation compression.
+
+================================================================================================================================
+*/
+
+#if !defined( GLTF_ANIMATION_TRANSLATION_TOLERANCE )
+	#define GLTF_ANIMATION_TRANSLATION_TOLERANCE	1e-3f	// maximum translation error of an omitted key frame
+#endif
+#if !defined( GLTF_ANIMATION_ROTATION_TOLERANCE )
+	#define GLTF_ANIMATION_ROTATION_TOLERANCE		1e-3f	// maximum rotation error of an omitted key frame in radians
+#endif
+#if !defined( GLTF_ANIMATION_SCALE_TOLERANCE )
+	#define GLTF_ANIMATION_SCALE_TOLERANCE			1e-3f	// maximum scale error of an omitted key frame
+#endif
+#define GLTF_ANIMATION_MAX_OMITTED_KEY_FRAMES		64		// bounds the time spent searching for key frames to omit
+
+typedef struct
+{
+	size_t						uncompressedSize;
+	size_t						compressedSize;
+	int							keyFrameCount;
+	int							storedKeyFrameCount;
+	float						maxTranslationError;
+	float						maxRotationError;		// in radians
+	float						maxScaleError;
+} ksGltfAnimationCompressionStats;
+
+static int ksGltf_PopCount32( uint32_t value )
+{
+#if defined( __GNUC__ ) || defined( __clang__ )
+	return __builtin_popcount( value );
+#else
+	value = value - ( ( value >> 1 ) & 0x55555555 );
+	value = ( value & 0x33333333 ) + ( ( value >> 2 ) & 0x33333333 );
+	value = ( value + ( value >> 4 ) ) & 0x0F0F0F0F;
+	return (int)( ( value * 0x01010101 ) >> 24 );
+#endif
+}
+
+static void ksGltf_EncodeVector3( uint16_t * out, const ksVector3f * value, const ksVector3f * bias, const ksVector3f * step )
+{
+	out[0] = ( step->x > 0.0f ) ? (uint16_t) MIN( MAX( (int)( ( value->x - bias->x ) / step->x + 0.5f ), 0 ), 65535 ) : 0;
+	out[1] = ( step->y > 0.0f ) ? (uint16_t) MIN( MAX( (int)( ( value->y - bias->y ) / step->y + 0.5f ), 0 ), 65535 ) : 0;
+	out[2] = ( step->z > 0.0f ) ? (uint16_t) MIN( MAX( (int)( ( value->z - bias->z ) / step->z + 0.5f ), 0 ), 65535 ) : 0;
+}
+
+static void ksGltf_DecodeVector3( ksVector3f * value, const uint16_t * in, const ksVector3f * bias, const ksVector3f * step )
+{
+	value->x = bias->x + in[0] * step->x;
+	value->y = bias->y + in[1] * step->y;
+	value->z = bias->z + in[2] * step->z;
+}
+
+// The three smallest components of a normalized quaternion are in the range [-1/sqrt(2), 1/sqrt(2)]
+// and are stored with 15 bits each such that zero is exactly representable. The index of the largest
+// component is stored in the top bits of the first two values and the largest component is made
+// positive such that it can be derived from the other components.
+static void ksGltf_EncodeQuat( uint16_t * out, const ksQuatf * value )
+{
+	const float rcpLength = RcpSqrt( value->x * value->x + value->y * value->y + value->z * value->z + value->w * value->w );
+	const float c[4] = { value->x * rcpLength, value->y * rcpLength, value->z * rcpLength, value->w * rcpLength };
+	int largest = 0;
+	for ( int i = 1; i < 4; i++ )
 	{
-		case GL_NEVER:		return KS_GPU_COMPARE_OP_NEVER;
-		case GL_LESS:		return KS_GPU_COMPARE_OP_LESS;
-		case GL_EQUAL:		return KS_GPU_COMPARE_OP_EQUAL;
-		case GL_LEQUAL:		return KS_GPU_COMPARE_OP_LESS_OR_EQUAL;
-		case GL_GREATER:	return KS_GPU_COMPARE_OP_GREATER;
-		case GL_NOTEQUAL:	return KS_GPU_COMPARE_OP_NOT_EQUAL;
-		case GL_GEQUAL:		return KS_GPU_COMPARE_OP_GREATER_OR_EQUAL;
-		case GL_ALWAYS:		return KS_GPU_COMPARE_OP_ALWAYS;
-		default:			return KS_GPU_COMPARE_OP_LESS;
+		if ( fabsf( c[i] ) > fabsf( c[largest] ) )
+		{
+			largest = i;
+		}
+	}
+	const float sign = ( c[largest] < 0.0f ) ? -1.0f : 1.0f;
+	for ( int i = 0, j = 0; i < 4; i++ )
+	{
+		if ( i != largest )
+		{
+			out[j++] = (uint16_t)( 16383 + (int) roundf( MIN( MAX( sign * c[i] * 1.41421356f, -1.0f ), 1.0f ) * 16383.0f ) );
+		}
 	}
+	out[0] |= (uint16_t)( ( largest & 1 ) << 15 );
+	out[1] |= (uint16_t)( ( largest >> 1 ) << 15 );
 }
 
-static ksGpuBlendOp ksGltf_GetBlendOp( const int op )
+static void ksGltf_DecodeQuat( ksQuatf * value, const uint16_t * in )
 {
-	switch( op )
+	const float scale = 0.70710678f / 16383.0f;
+	const float a = ( ( in[0] & 0x7FFF ) - 16383 ) * scale;
+	const float b = ( ( in[1] & 0x7FFF ) - 16383 ) * scale;
+	const float c = ( in[2] - 16383 ) * scale;
+	const float d = sqrtf( MAX( 1.0f - a * a - b * b - c * c, 0.0f ) );
+	switch ( ( in[0] >> 15 ) | ( ( in[1] >> 15 ) << 1 ) )
 	{
-		case GL_FUNC_ADD:				return KS_GPU_BLEND_OP_ADD;
-		case GL_FUNC_SUBTRACT:			return KS_GPU_BLEND_OP_SUBTRACT;
-		case GL_FUNC_REVERSE_SUBTRACT:	return KS_GPU_BLEND_OP_REVERSE_SUBTRACT;
-		case GL_MIN:					return KS_GPU_BLEND_OP_MIN;
-		case GL_MAX:					return KS_GPU_BLEND_OP_MAX;
-		default:						return KS_GPU_BLEND_OP_ADD;
+		case 0: value->x = d; value->y = a; value->z = b; value->w = c; break;
+		case 1: value->x = a; value->y = d; value->z = b; value->w = c; break;
+		case 2: value->x = a; value->y = b; value->z = d; value->w = c; break;
+		default: value->x = a; value->y = b; value->z = c; value->w = d; break;
 	}
 }
 
-static ksGpuBlendFactor ksGltf_GetBlendFactor( const int factor )
+// Returns the rotation angle in radians between two orientations.
+// The angle is derived from the chord length because acos is inaccurate for small angles.
+static float ksGltf_GetRotationError( const ksQuatf * a, const ksQuatf * b )
 {
-	switch ( factor )
+	const float rcpLengthA = RcpSqrt( a->x * a->x + a->y * a->y + a->z * a->z + a->w * a->w );
+	const float rcpLengthB = RcpSqrt( b->x * b->x + b->y * b->y + b->z * b->z + b->w * b->w ) *
+								( ( a->x * b->x + a->y * b->y + a->z * b->z + a->w * b->w < 0.0f ) ? -1.0f : 1.0f );
+	const float dx = a->x * rcpLengthA - b->x * rcpLengthB;
+	const float dy = a->y * rcpLengthA - b->y * rcpLengthB;
+	const float dz = a->z * rcpLengthA - b->z * rcpLengthB;
+	const float dw = a->w * rcpLengthA - b->w * rcpLengthB;
+	return 4.0f * asinf( MIN( 0.5f * sqrtf( dx * dx + dy * dy + dz * dz + dw * dw ), 1.0f ) );
+}
+
+static float ksGltf_GetVector3Error( const ksVector3f * a, const ksVector3f * b )
+{
+	return MAX( MAX( fabsf( a->x - b->x ), fabsf( a->y - b->y ) ), fabsf( a->z - b->z ) );
+}
+
+// Returns the stored key frame at or before the given time-line frame together with the time-line
+// frames of this stored key frame and the next stored key frame.
+static int ksGltf_GetStoredKeyFrame( const ksGltfCompressedKeyFrames * keyFrames, const int frame, int * frame0, int * frame1 )
+{
+	if ( keyFrames->keyMask == NULL )
 	{
-		case GL_ZERO:						return KS_GPU_BLEND_FACTOR_ZERO;
-		case GL_ONE:						return KS_GPU_BLEND_FACTOR_ONE;
-		case GL_SRC_COLOR:					return KS_GPU_BLEND_FACTOR_SRC_COLOR;
-		case GL_ONE_MINUS_SRC_COLOR:		return KS_GPU_BLEND_FACTOR_ONE_MINUS_SRC_COLOR;
-		case GL_DST_COLOR:					return KS_GPU_BLEND_FACTOR_DST_COLOR;
-		case GL_ONE_MINUS_DST_COLOR:		return KS_GPU_BLEND_FACTOR_ONE_MINUS_DST_COLOR;
-		case GL_SRC_ALPHA:					return KS_GPU_BLEND_FACTOR_SRC_ALPHA;
-		case GL_ONE_MINUS_SRC_ALPHA:		return KS_GPU_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
-		case GL_DST_ALPHA:					return KS_GPU_BLEND_FACTOR_DST_ALPHA;
-		case GL_ONE_MINUS_DST_ALPHA:		return KS_GPU_BLEND_FACTOR_ONE_MINUS_DST_ALPHA;
-		case GL_CONSTANT_COLOR:				return KS_GPU_BLEND_FACTOR_CONSTANT_COLOR;
-		case GL_ONE_MINUS_CONSTANT_COLOR:	return KS_GPU_BLEND_FACTOR_ONE_MINUS_CONSTANT_COLOR;
-		case GL_CONSTANT_ALPHA:				return KS_GPU_BLEND_FACTOR_CONSTANT_ALPHA;
-		case GL_ONE_MINUS_CONSTANT_ALPHA:	return KS_GPU_BLEND_FACTOR_ONE_MINUS_CONSTANT_ALPHA;
-		case GL_SRC_ALPHA_SATURATE:			return KS_GPU_BLEND_FACTOR_SRC_ALPHA_SATURATE;
-		default:							return KS_GPU_BLEND_FACTOR_ZERO;
+		*frame0 = frame;
+		*frame1 = frame + 1;
+		return frame;
 	}
+	const int word = frame >> 5;
+	const int key = keyFrames->keyRank[word] + ksGltf_PopCount32( keyFrames->keyMask[word] & ( 0xFFFFFFFFu >> ( 31 - ( frame & 31 ) ) ) ) - 1;
+	*frame0 = keyFrames->keyFrames[key + 0];
+	*frame1 = keyFrames->keyFrames[key + 1];
+	return key;
 }
 
-static int ksGltf_GetVertexAttributeLocation( const ksGltfTechnique * technique, const unsigned char * nameStart, const unsigned char * nameEnd )
+// A zero key frame count makes the first sample decode the key frames.
+static void ksGltf_InitChannelKeyState( ksGltfChannelKeyState * keyState )
 {
-	for ( int i = 0; i < technique->attributeCount; i++ )
+	memset( keyState, 0, sizeof( ksGltfChannelKeyState ) );
+}
+
+// Decodes the stored key frames around the time-line frame.
+static void ksGltf_DecodeKeyFrames( ksGltfChannelKeyState * keyState, const ksGltfCompressedKeyFrames * keyFrames, const int frame )
+{
+	int frame0;
+	int frame1;
+	const int key = ksGltf_GetStoredKeyFrame( keyFrames, frame, &frame0, &frame1 );
+	keyState->keyFrame = frame0;
+	keyState->keyFrameCount = frame1 - frame0;
+	keyState->rcpKeyFrameCount = 1.0f / (float)( frame1 - frame0 );
+	for ( int i = 0; i < 2; i++ )
 	{
-		if ( ksLexer_CaseSensitiveCompareToken( nameStart, nameEnd, technique->attributes[i].name ) )
+		if ( keyFrames->translation != NULL )
 		{
-			return technique->attributes[i].location;
+			ksGltf_DecodeVector3( &keyState->translation[i], &keyFrames->translation[( key + i ) * 3], &keyFrames->translationBias, &keyFrames->translationStep );
+		}
+		if ( keyFrames->rotation != NULL )
+		{
+			ksGltf_DecodeQuat( &keyState->rotation[i], &keyFrames->rotation[( key + i ) * 3] );
+		}
+		if ( keyFrames->scale != NULL )
+		{
+			ksGltf_DecodeVector3( &keyState->scale[i], &keyFrames->scale[( key + i ) * 3], &keyFrames->scaleBias, &keyFrames->scaleStep );
 		}
 	}
-	assert( false );
-	return 0;
 }
 
-static int ksGltf_GetUniformBinding( const ksGltfTechnique * technique, const unsigned char * nameStart, const unsigned char * nameEnd )
+// Only the components of the channel that are animated are written. STEP components hold
+// the stored key frame until the next stored key frame is reached.
+static void ksGltf_SampleCompressedKeyFrames( ksGltfChannelKeyState * keyState, const ksGltfCompressedKeyFrames * keyFrames, const int frame, const float fraction,
+												ksVector3f * translation, ksQuatf * rotation, ksVector3f * scale )
 {
-	for ( int i = 0; i < technique->uniformCount; i++ )
+	if ( (unsigned int)( frame - keyState->keyFrame ) >= (unsigned int)keyState->keyFrameCount )
 	{
-		if ( ksLexer_CaseSensitiveCompareToken( nameStart, nameEnd, technique->parms[i].name ) )
+		ksGltf_DecodeKeyFrames( keyState, keyFrames, frame );
+	}
+	const float keyFraction = ( (float)( frame - keyState->keyFrame ) + fraction ) * keyState->rcpKeyFrameCount;
+	const int stepKey = ( frame + 1 == keyState->keyFrame + keyState->keyFrameCount && fraction >= 1.0f ) ? 1 : 0;
+	if ( keyFrames->translation != NULL )
+	{
+		if ( ( keyFrames->stepMask & GLTF_ANIMATION_COMPONENT_TRANSLATION ) != 0 )
 		{
-			return technique->parms[i].binding;
+			*translation = keyState->translation[stepKey];
+		}
+		else
+		{
+			ksVector3f_Lerp( translation, &keyState->translation[0], &keyState->translation[1], keyFraction );
 		}
 	}
-	assert( false );
-	return 0;
-}
-
-static void ksGltf_SetUniformStageFlag( const ksGltfTechnique * technique, const unsigned char * nameStart, const unsigned char * nameEnd, const ksGpuProgramStageFlags flag )
-{
-	for ( int i = 0; i < technique->uniformCount; i++ )
+	if ( keyFrames->rotation != NULL )
 	{
-		if ( ksLexer_CaseSensitiveCompareToken( nameStart, nameEnd, technique->parms[i].name ) )
+		if ( ( keyFrames->stepMask & GLTF_ANIMATION_COMPONENT_ROTATION ) != 0 )
 		{
-			technique->parms[i].stageFlags |= flag;
-			return;
+			*rotation = keyState->rotation[stepKey];
+		}
+		else
+		{
+			ksQuatf_FastSlerp( rotation, &keyState->rotation[0], &keyState->rotation[1], keyFraction );
+		}
+	}
+	if ( keyFrames->scale != NULL )
+	{
+		if ( ( keyFrames->stepMask & GLTF_ANIMATION_COMPONENT_SCALE ) != 0 )
+		{
+			*scale = keyState->scale[stepKey];
+		}
+		else
+		{
+			ksVector3f_Lerp( scale, &keyState->scale[0], &keyState->scale[1], keyFraction );
 		}
 	}
-	assert( false );
 }
 
-#define JOINT_UNIFORM_BUFFER_NAME							"jointUniformBuffer"
-#define VIEW_PROJECTION_UNIFORM_BUFFER_NAME					"viewProjectionUniformBuffer"
-#define VIEW_PROJECTION_MULTI_VIEW_UNIFORM_BUFFER_NAME		"viewProjectionMultiViewUniformBuffer"
+static void ksGltf_GetVector3Range( ksVector3f * bias, ksVector3f * step, const ksVector3f * values, const int count )
+{
+	ksVector3f mins = values[0];
+	ksVector3f maxs = values[0];
+	for ( int i = 1; i < count; i++ )
+	{
+		ksVector3f_Min( &mins, &mins, &values[i] );
+		ksVector3f_Max( &maxs, &maxs, &values[i] );
+	}
+	*bias = mins;
+	step->x = ( maxs.x - mins.x ) * ( 1.0f / 65535.0f );
+	step->y = ( maxs.y - mins.y ) * ( 1.0f / 65535.0f );
+	step->z = ( maxs.z - mins.z ) * ( 1.0f / 65535.0f );
+}
 
-typedef enum
+// Returns true if the key frames in between the first and last key frame are reproduced
+// within tolerance by interpolating the quantized first and last key frame, or by holding
+// the quantized first key frame for STEP components.
+static bool ksGltf_CanOmitKeyFrames( const ksGltfAnimationChannel * channel, const uint16_t * translation, const uint16_t * rotation, const uint16_t * scale,
+									const int first, const int last )
 {
-	KS_GLSL_CONVERSION_NONE							= 0,
-	KS_GLSL_CONVERSION_FLAG_JOINT_BUFFER			= BIT( 0 ),	// KHR_glsl_joint_buffer
-	KS_GLSL_CONVERSION_FLAG_VIEW_PROJECTION_BUFFER	= BIT( 1 ),	// KHR_glsl_view_projection_buffer
-	KS_GLSL_CONVERSION_FLAG_MULTI_VIEW				= BIT( 2 ),	// KHR_glsl_multi_view
-	KS_GLSL_CONVERSION_FLAG_LAYOUT_OPENGL			= BIT( 3 ),	// KHR_glsl_layout_opengl
-	KS_GLSL_CONVERSION_FLAG_LAYOUT_VULKAN			= BIT( 4 )	// KHR_glsl_layout_vulkan
-} ksGlslConversionFlags;
-
-typedef struct ksGltfInOutParm
-{
-	const unsigned char *	nameStart;
-	const unsigned char *	nameEnd;
-	size_t					nameLength;
-} ksGltfInOutParm;
-
-#if GRAPHICS_API_OPENGL == 1 || GRAPHICS_API_OPENGL_ES == 1 || GRAPHICS_API_VULKAN == 1
-
-// Convert a GLSL 1.0 ES glTF shader to a newer (at least 1.3) GLSL version primarily for uniform buffer support.
-// Assumes the GLSL 1.0 ES glTF shader does not use any extensions.
-// Currently assumes the GLSL 1.0 ES glTF shader does not use any preprocessing.
-unsigned char * ksGltf_ConvertShaderGLSL( const unsigned char * source, size_t * sourceSize, const ksGpuProgramStageFlags stage,
-											const int conversion,
-											const ksGltfTechnique * technique,
-											const char * existingSemanticUniforms[],
-											const char * newSemanticUniforms[],
-											ksGltfInOutParm inOutParms[], int * inOutParmCount )
-{
-	const bool multiview = ( conversion & KS_GLSL_CONVERSION_FLAG_MULTI_VIEW ) != 0;
-
-	// GLSL version.
-	const char * versionString =
-					"#version " GLSL_VERSION "\n";
-	const size_t versionStringLength =
-					strlen( versionString );
-
-	// Default precision.
-	const char * precisionString =
-					"precision highp float;\n"
-					"precision highp int;\n";
-	const size_t precisionStringLength =
-					strlen( precisionString );
-
-	// Per vertex extension.
-	const char * perVertexExtensionString =
-					"#extension GL_EXT_shader_io_blocks : enable\n";
-	const size_t perVertexExtensionStringLength =
-					strlen( perVertexExtensionString );
-
-	// Enhanced layouts extension.
-	const char * layoutExtensionString =
-					"#extension GL_ARB_enhanced_layouts : enable\n";
-	const size_t layoutExtensionStringLength =
-					strlen( layoutExtensionString );
-
-	// KHR_glsl_joint_buffer
-	const char * jointUniformSemanticString =
-					JOINT_UNIFORM_BUFFER_NAME;
-	const size_t jointUniformSemanticStringLength =
-					strlen( jointUniformSemanticString );
-	const char * jointUniformBufferString =
-					"uniform %s\n"
-					"{\n"
-					"	%smat4 %s[256];\n"
-					"};\n";
-	const size_t jointUniformBufferStringLength =
-					strlen( jointUniformBufferString );
-
-	// KHR_glsl_view_projection_buffer
-	const char * viewProjectionUniformSemanticString =
-					multiview ? VIEW_PROJECTION_MULTI_VIEW_UNIFORM_BUFFER_NAME : VIEW_PROJECTION_UNIFORM_BUFFER_NAME;
-	const size_t viewProjectionUniformSemanticStringLength =
-					strlen( viewProjectionUniformSemanticString );
-	const char * viewProjectionUniformBufferString =
-					"uniform %s\n"
-					"{\n"
-					"	%smat4 %s%s;\n"	// viewMatrix
-					"	%smat4 %s%s;\n"	// viewInverseMatrix
-					"	%smat4 %s%s;\n"	// projectionMatrix
-					"	%smat4 %s%s;\n"	// projectionInverseMatrix
-					"};\n";
-	const size_t viewProjectionUniformBufferStringLength =
-					strlen( viewProjectionUniformBufferString );
-
-	// KHR_glsl_multi_view
-	const char * multiviewString = 
-					"#define NUM_VIEWS 2\n"
-					"#define VIEW_ID gl_ViewID_OVR\n"
-					"#extension GL_OVR_multiview2 : require\n"
-					"layout( num_views = NUM_VIEWS ) in;\n";
-	const size_t multiviewStringLength =
-					strlen( multiviewString );
-	const char * multiviewArraySizeString =
-					multiview ? "[NUM_VIEWS]" : "";
-	const char * multiviewArrayIndexString =
-					multiview ? "[VIEW_ID]" : "";
-
-	// push constants
-	const char * pushConstantStartString =
-					"layout( std430, push_constant ) uniform pushConstants\n"
-					"{\n";
-	const size_t pushConstantStartStringLength =
-					strlen( pushConstantStartString );
-	const char * pushConstantEndString =
-					"} pc;\n";
-	const size_t pushConstantEndStringLength =
-					strlen( pushConstantEndString );
-	const char * pushConstantInstanceName =
-					( ( conversion & KS_GLSL_CONVERSION_FLAG_LAYOUT_VULKAN ) != 0 ) ? "pc." : "";
-
-	// Vertex and fragment out parameters.
-	const char * perVertexString =
-					"out gl_PerVertex { vec4 gl_Position; };\n";
-	const size_t perVertexStringLength =
-					strlen( perVertexString );
-	const char * fragColorString =
-					"out vec4 fragColor;\n";
-	const size_t fragColorStringLength =
-					strlen( fragColorString );
-
-	unsigned char * newSource = (unsigned char *) malloc( *sourceSize * 2 +
-						versionStringLength +
-						precisionStringLength +
-						perVertexExtensionStringLength +
-						layoutExtensionStringLength +
-						jointUniformSemanticStringLength +
-						jointUniformBufferStringLength +
-						viewProjectionUniformSemanticStringLength +
-						viewProjectionUniformBufferStringLength +
-						multiviewStringLength +
-						pushConstantStartStringLength +
-						pushConstantEndStringLength +
-						perVertexStringLength +
-						fragColorStringLength );
-	unsigned char * out = newSource;
-	const unsigned char * ptr = source;
-
-	int glslVersion = 100;
+	const ksGltfCompressedKeyFrames * keyFrames = &channel->keyFrames;
+	ksVector3f t0, t1, s0, s1;
+	ksQuatf r0, r1;
+	if ( translation != NULL )
+	{
+		ksGltf_DecodeVector3( &t0, &translation[first * 3], &keyFrames->translationBias, &keyFrames->translationStep );
+		ksGltf_DecodeVector3( &t1, &translation[last * 3], &keyFrames->translationBias, &keyFrames->translationStep );
+	}
+	if ( rotation != NULL )
+	{
+		ksGltf_DecodeQuat( &r0, &rotation[first * 3] );
+		ksGltf_DecodeQuat( &r1, &rotation[last * 3] );
+	}
+	if ( scale != NULL )
+	{
+		ksGltf_DecodeVector3( &s0, &scale[first * 3], &keyFrames->scaleBias, &keyFrames->scaleStep );
+		ksGltf_DecodeVector3( &s1, &scale[last * 3], &keyFrames->scaleBias, &keyFrames->scaleStep );
+	}
 
-	// Get any existing version string.
+	for ( int frame = first + 1; frame < last; frame++ )
 	{
-		const unsigned char * numberSignToken;
-		const unsigned char * endOfNumberSignToken = ksLexer_NextToken( source, source, &numberSignToken, NULL );
-		if ( ksLexer_CaseSensitiveCompareToken( numberSignToken, endOfNumberSignToken, "#" ) )
+		const float fraction = (float)( frame - first ) / (float)( last - first );
+		const float translationFraction = ( ( keyFrames->stepMask & GLTF_ANIMATION_COMPONENT_TRANSLATION ) != 0 ) ? 0.0f : fraction;
+		const float rotationFraction = ( ( keyFrames->stepMask & GLTF_ANIMATION_COMPONENT_ROTATION ) != 0 ) ? 0.0f : fraction;
+		const float scaleFraction = ( ( keyFrames->stepMask & GLTF_ANIMATION_COMPONENT_SCALE ) != 0 ) ? 0.0f : fraction;
+		if ( translation != NULL )
 		{
-			const unsigned char * versionToken;
-			const unsigned char * endOfVersionToken = ksLexer_NextToken( source, endOfNumberSignToken, &versionToken, NULL );
-			if ( ksLexer_CaseSensitiveCompareToken( versionToken, endOfVersionToken, "version" ) )
+			ksVector3f t;
+			ksVector3f_Lerp( &t, &t0, &t1, translationFraction );
+			if ( ksGltf_GetVector3Error( &t, &channel->translation[frame] ) > GLTF_ANIMATION_TRANSLATION_TOLERANCE )
 			{
-				const unsigned char * numberToken;
-				ksLexer_NextToken( source, endOfVersionToken, &numberToken, NULL );
-				glslVersion = atoi( (const char *)numberToken );
-				ptr = ksLexer_SkipUpToEndOfLine( source, endOfVersionToken );
+				return false;
+			}
+		}
+		if ( rotation != NULL )
+		{
+			ksQuatf r;
+			ksQuatf_FastSlerp( &r, &r0, &r1, rotationFraction );
+			if ( ksGltf_GetRotationError( &r, &channel->rotation[frame] ) > GLTF_ANIMATION_ROTATION_TOLERANCE )
+			{
+				return false;
+			}
+		}
+		if ( scale != NULL )
+		{
+			ksVector3f s;
+			ksVector3f_Lerp( &s, &s0, &s1, scaleFraction );
+			if ( ksGltf_GetVector3Error( &s, &channel->scale[frame] ) > GLTF_ANIMATION_SCALE_TOLERANCE )
+			{
+				return false;
 			}
 		}
 	}
+	return true;
+}
 
-	// Add a new version string.
-	out = (unsigned char *)memcpy( out, versionString, versionStringLength ) + versionStringLength;
-
-	// Add a new precision string.
-	out = (unsigned char *)memcpy( out, precisionString, precisionStringLength ) + precisionStringLength;
-
-	// Add GL_EXT_shader_io_blocks.
-	if ( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX )
+// Compresses the key frames of a channel. The uncompressed key frames are no longer referenced afterwards.
+static void ksGltf_CompressAnimationChannel( ksGltfAnimationChannel * channel, const ksGltfTimeLine * timeLine, ksGltfAnimationCompressionStats * stats )
+{
+	ksGltfCompressedKeyFrames * keyFrames = &channel->keyFrames;
+	const int sampleCount = timeLine->sampleCount;
+
+	// Quantize all key frames.
+	uint16_t * translation = NULL;
+	uint16_t * rotation = NULL;
+	uint16_t * scale = NULL;
+	if ( channel->translation != NULL )
 	{
-		out = (unsigned char *)memcpy( out, perVertexExtensionString, perVertexExtensionStringLength ) + perVertexExtensionStringLength;
+		translation = (uint16_t *) malloc( sampleCount * 3 * sizeof( uint16_t ) );
+		ksGltf_GetVector3Range( &keyFrames->translationBias, &keyFrames->translationStep, channel->translation, sampleCount );
+		for ( int frame = 0; frame < sampleCount; frame++ )
+		{
+			ksGltf_EncodeVector3( &translation[frame * 3], &channel->translation[frame], &keyFrames->translationBias, &keyFrames->translationStep );
+		}
 	}
-
-	// Add GL_ARB_enhanced_layouts.
-	if ( ( conversion & ( KS_GLSL_CONVERSION_FLAG_LAYOUT_OPENGL | KS_GLSL_CONVERSION_FLAG_LAYOUT_VULKAN ) ) != 0 )
+	if ( channel->rotation != NULL )
 	{
-		out = (unsigned char *)memcpy( out, layoutExtensionString, layoutExtensionStringLength ) + layoutExtensionStringLength;
+		rotation = (uint16_t *) malloc( sampleCount * 3 * sizeof( uint16_t ) );
+		for ( int frame = 0; frame < sampleCount; frame++ )
+		{
+			ksGltf_EncodeQuat( &rotation[frame * 3], &channel->rotation[frame] );
+		}
 	}
-
-	if ( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX )
+	if ( channel->scale != NULL )
 	{
-		// Optionally add multi-view support.
-		if ( ( conversion & KS_GLSL_CONVERSION_FLAG_MULTI_VIEW ) != 0 )
+		scale = (uint16_t *) malloc( sampleCount * 3 * sizeof( uint16_t ) );
+		ksGltf_GetVector3Range( &keyFrames->scaleBias, &keyFrames->scaleStep, channel->scale, sampleCount );
+		for ( int frame = 0; frame < sampleCount; frame++ )
 		{
-			out = (unsigned char *)memcpy( out, multiviewString, multiviewStringLength ) + multiviewStringLength;
+			ksGltf_EncodeVector3( &scale[frame * 3], &channel->scale[frame], &keyFrames->scaleBias, &keyFrames->scaleStep );
 		}
+	}
 
-		// Optionally add a joint uniform buffer.
-		if ( ( conversion & KS_GLSL_CONVERSION_FLAG_JOINT_BUFFER ) != 0 )
+	// Key frames of a fixed-rate time-line are omitted if they are reproduced by interpolating the surrounding stored key frames.
+	int * storedFrames = (int *) malloc( sampleCount * sizeof( int ) );
+	int storedCount = 0;
+	storedFrames[storedCount++] = 0;
+	if ( timeLine->rcpStep != 0.0f && sampleCount <= 65536 )
+	{
+		int first = 0;
+		for ( int last = 2; last < sampleCount; last++ )
 		{
-			if ( newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_JOINT_BUFFER] != NULL )
+			if ( last - first - 1 > GLTF_ANIMATION_MAX_OMITTED_KEY_FRAMES ||
+					!ksGltf_CanOmitKeyFrames( channel, translation, rotation, scale, first, last ) )
 			{
-				if ( ( conversion & ( KS_GLSL_CONVERSION_FLAG_LAYOUT_OPENGL | KS_GLSL_CONVERSION_FLAG_LAYOUT_VULKAN ) ) != 0 )
-				{
-					const int binding = ksGltf_GetUniformBinding( technique, (const unsigned char *)jointUniformSemanticString, NULL );
-					out += sprintf( (char *)out, "layout( std140, binding = %d ) ", binding );
-					out += sprintf( (char *)out, jointUniformBufferString, jointUniformSemanticString,
-											"layout( offset = 0 ) ", existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_JOINT_ARRAY] );
-				}
-				else
-				{
-					out += sprintf( (char *)out, jointUniformBufferString, jointUniformSemanticString,
-											"", existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_JOINT_ARRAY] );
-				}
-				ksGltf_SetUniformStageFlag( technique, (const unsigned char *)jointUniformSemanticString, NULL, stage );
+				first = last - 1;
+				storedFrames[storedCount++] = first;
 			}
 		}
+	}
+	else
+	{
+		for ( int frame = 1; frame < sampleCount - 1; frame++ )
+		{
+			storedFrames[storedCount++] = frame;
+		}
+	}
+	storedFrames[storedCount++] = sampleCount - 1;
+
+	// All arrays are stored in a single allocation.
+	const bool omitted = ( storedCount < sampleCount );
+	const int wordCount = omitted ? ( sampleCount + 31 ) / 32 : 0;
+	const int componentCount = ( ( translation != NULL ) ? 3 : 0 ) + ( ( rotation != NULL ) ? 3 : 0 ) + ( ( scale != NULL ) ? 3 : 0 );
+	keyFrames->dataSize = wordCount * ( sizeof( int ) + sizeof( uint32_t ) ) + ( ( omitted ? storedCount : 0 ) + componentCount * storedCount ) * sizeof( uint16_t );
+	keyFrames->data = malloc( keyFrames->dataSize );
+	keyFrames->keyCount = storedCount;
+
+	unsigned char * data = (unsigned char *) keyFrames->data;
+	keyFrames->keyRank = omitted ? (int *) data : NULL;
+	data += wordCount * sizeof( int );
+	keyFrames->keyMask = omitted ? (uint32_t *) data : NULL;
+	data += wordCount * sizeof( uint32_t );
+	keyFrames->keyFrames = omitted ? (uint16_t *) data : NULL;
+	data += ( omitted ? storedCount : 0 ) * sizeof( uint16_t );
+	keyFrames->translation = ( translation != NULL ) ? (uint16_t *) data : NULL;
+	data += ( ( translation != NULL ) ? 3 * storedCount : 0 ) * sizeof( uint16_t );
+	keyFrames->rotation = ( rotation != NULL ) ? (uint16_t *) data : NULL;
+	data += ( ( rotation != NULL ) ? 3 * storedCount : 0 ) * sizeof( uint16_t );
+	keyFrames->scale = ( scale != NULL ) ? (uint16_t *) data : NULL;
+
+	if ( omitted )
+	{
+		memset( keyFrames->keyMask, 0, wordCount * sizeof( uint32_t ) );
+		for ( int key = 0; key < storedCount; key++ )
+		{
+			keyFrames->keyMask[storedFrames[key] >> 5] |= 1u << ( storedFrames[key] & 31 );
+			keyFrames->keyFrames[key] = (uint16_t) storedFrames[key];
+		}
+		for ( int word = 0, rank = 0; word < wordCount; word++ )
+		{
+			keyFrames->keyRank[word] = rank;
+			rank += ksGltf_PopCount32( keyFrames->keyMask[word] );
+		}
+	}
+	for ( int key = 0; key < storedCount; key++ )
+	{
+		for ( int i = 0; i < 3; i++ )
+		{
+			if ( translation != NULL )	keyFrames->translation[key * 3 + i]	= translation[storedFrames[key] * 3 + i];
+			if ( rotation != NULL )		keyFrames->rotation[key * 3 + i]	= rotation[storedFrames[key] * 3 + i];
+			if ( scale != NULL )		keyFrames->scale[key * 3 + i]		= scale[storedFrames[key] * 3 + i];
+		}
+	}
 
-		// Optionally add a view-projection or multi-view uniform buffer.
-		if ( ( conversion & ( KS_GLSL_CONVERSION_FLAG_VIEW_PROJECTION_BUFFER | KS_GLSL_CONVERSION_FLAG_MULTI_VIEW ) ) != 0 )
+	free( storedFrames );
+	free( translation );
+	free( rotation );
+	free( scale );
+
+	// Measure the error at every key frame the way the key frames are sampled at run-time.
+	ksGltfChannelKeyState keyState;
+	ksGltf_InitChannelKeyState( &keyState );
+	for ( int frame = 0; frame < sampleCount; frame++ )
+	{
+		ksVector3f t = { 0.0f, 0.0f, 0.0f };
+		ksQuatf r = { 0.0f, 0.0f, 0.0f, 1.0f };
+		ksVector3f s = { 1.0f, 1.0f, 1.0f };
+		const int sampleFrame = MIN( frame, sampleCount - 2 );
+		ksGltf_SampleCompressedKeyFrames( &keyState, keyFrames, sampleFrame, (float)( frame - sampleFrame ), &t, &r, &s );
+		if ( channel->translation != NULL )
 		{
-			if (	newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW] != NULL ||
-					newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE] != NULL ||
-					newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION] != NULL ||
-					newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION_INVERSE] != NULL )
-			{
-				if ( ( conversion & ( KS_GLSL_CONVERSION_FLAG_LAYOUT_OPENGL | KS_GLSL_CONVERSION_FLAG_LAYOUT_VULKAN ) ) != 0 )
-				{
-					const int binding = ksGltf_GetUniformBinding( technique, (const unsigned char *)viewProjectionUniformSemanticString, NULL );
-					out += sprintf( (char *)out, "layout( std140, binding = %d ) ", binding );
-					out += sprintf( (char *)out, viewProjectionUniformBufferString, viewProjectionUniformSemanticString,
-								multiview ? "layout( offset =   0 ) " : "layout( offset =   0 ) ", newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW], multiviewArraySizeString,
-								multiview ? "layout( offset = 128 ) " : "layout( offset =  64 ) ", newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE], multiviewArraySizeString,
- 								multiview ? "layout( offset = 256 ) " : "layout( offset = 128 ) ", newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION], multiviewArraySizeString,
-								multiview ? "layout( offset = 384 ) " : "layout( offset = 192 ) ", newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION_INVERSE], multiviewArraySizeString );
-				}
-				else
-				{
-					out += sprintf( (char *)out, viewProjectionUniformBufferString, viewProjectionUniformSemanticString,
-											"", newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW], multiviewArraySizeString,
-											"", newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE], multiviewArraySizeString,
- 											"", newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION], multiviewArraySizeString,
-											"", newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION_INVERSE], multiviewArraySizeString );
-				}
-				ksGltf_SetUniformStageFlag( technique, (const unsigned char *)viewProjectionUniformSemanticString, NULL, stage );
-			}
+			stats->maxTranslationError = MAX( stats->maxTranslationError, ksGltf_GetVector3Error( &t, &channel->translation[frame] ) );
+		}
+		if ( channel->rotation != NULL )
+		{
+			stats->maxRotationError = MAX( stats->maxRotationError, ksGltf_GetRotationError( &r, &channel->rotation[frame] ) );
+		}
+		if ( channel->scale != NULL )
+		{
+			stats->maxScaleError = MAX( stats->maxScaleError, ksGltf_GetVector3Error( &s, &channel->scale[frame] ) );
+		}
+	}
 
-			// Optionally add 'MODEL' and 'MODELINVERSE' uniforms.
-			if ( ( conversion & KS_GLSL_CONVERSION_FLAG_LAYOUT_VULKAN ) == 0 )
-			{
-				if ( newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL] != NULL && existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL] == NULL )
-				{
-					if ( ( conversion & KS_GLSL_CONVERSION_FLAG_LAYOUT_OPENGL ) != 0 )
-					{
-						const int binding = ksGltf_GetUniformBinding( technique, (const unsigned char *)newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL], NULL );
-						out += sprintf( (char *)out, "layout( location = %d ) ", binding );
-					}
-					out += sprintf( (char *)out, "uniform mat4 %s;\n", newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL] );
+	stats->uncompressedSize += sampleCount * ( ( ( channel->translation != NULL ) ? sizeof( ksVector3f ) : 0 ) +
+												( ( channel->rotation != NULL ) ? sizeof( ksQuatf ) : 0 ) +
+												( ( channel->scale != NULL ) ? sizeof( ksVector3f ) : 0 ) );
+	stats->compressedSize += keyFrames->dataSize;
+	stats->keyFrameCount += sampleCount;
+	stats->storedKeyFrameCount += storedCount;
+
+	if ( ( channel->ownedMask & GLTF_ANIMATION_COMPONENT_TRANSLATION ) != 0 ) free( channel->translation );
+	if ( ( channel->ownedMask & GLTF_ANIMATION_COMPONENT_ROTATION ) != 0 ) free( channel->rotation );
+	if ( ( channel->ownedMask & GLTF_ANIMATION_COMPONENT_SCALE ) != 0 ) free( channel->scale );
+	channel->ownedMask = 0;
+	channel->translation = NULL;
+	channel->rotation = NULL;
+	channel->scale = NULL;
+}
 
-					ksGltf_SetUniformStageFlag( technique, (const unsigned char *)newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL], NULL, stage );
-				}
-				if ( newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE] != NULL && existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE] == NULL )
-				{
-					if ( ( conversion & KS_GLSL_CONVERSION_FLAG_LAYOUT_OPENGL ) != 0 )
-					{
-						const int binding = ksGltf_GetUniformBinding( technique, (const unsigned char *)newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE], NULL );
-						out += sprintf( (char *)out, "layout( location = %d ) ", binding );
-					}
-					out += sprintf( (char *)out, "uniform mat4 %s;\n", newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE] );
+#if defined( _MSC_VER )
+#define strcasecmp _stricmp
+#endif
 
-					ksGltf_SetUniformStageFlag( technique, (const unsigned char *)newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE], NULL, stage );
-				}
-			}
-		}
-	}
+static char * ksGltf_strdup( const char * str )
+{
+	char * out = (char *)malloc( strlen( str ) + 1 );
+	strcpy( out, str );
+	return out;
+}
 
-	// Optionally add a push constant block.
-	if ( ( conversion & KS_GLSL_CONVERSION_FLAG_LAYOUT_VULKAN ) != 0 )
+// glTF 1.0 objects are named by their member name and glTF 2.0 objects have an optional name.
+static char * ksGltf_ParseName( const ksJson * json, const char * typeName, const int index )
+{
+	const char * memberName = ksJson_GetMemberName( json );
+	if ( memberName[0] != '\0' )
 	{
-		out = (unsigned char *)memcpy( out, pushConstantStartString, pushConstantStartStringLength ) + pushConstantStartStringLength;
+		return ksGltf_strdup( memberName );
+	}
+	const char * name = ksJson_GetString( ksJson_GetMemberByName( json, "name" ), "" );
+	if ( name[0] != '\0' )
+	{
+		return ksGltf_strdup( name );
+	}
+	char * out = (char *)malloc( strlen( typeName ) + 1 + 10 + 1 );
+	sprintf( out, "%s_%d", typeName, index );
+	return out;
+}
 
-		int offset = 0;
-		for ( int i = 0; i < technique->uniformCount; i++ )
-		{
-			const int size = ksGpuProgramParm_GetPushConstantSize( technique->parms[i].type );
-			if ( size > 0 )
-			{
-				const char * type = ksGpuProgramParm_GetPushConstantGlslType( technique->parms[i].type );
-				out += sprintf( (char *)out, "\tlayout( offset = %3d ) %s %s;\n", offset, type, technique->parms[i].name );
-				offset += size;
-				// For now make all push constants visible to both the vertex and fragment shader so we don't have to select the ones actually used in each.
-				ksGltf_SetUniformStageFlag( technique, (const unsigned char *)technique->parms[i].name, NULL, KS_GPU_PROGRAM_STAGE_FLAG_VERTEX | KS_GPU_PROGRAM_STAGE_FLAG_FRAGMENT );
-			}
-		}
+static unsigned char * ksGltf_ReadFile( const char * fileName, size_t * outSizeInBytes )
+{
+	FILE * file = fopen( fileName, "rb" );
+	if ( file == NULL )
+	{
+		return NULL;
+	}
+	const size_t maxSizeInBytes = ( outSizeInBytes != NULL && *outSizeInBytes > 0 ) ? *outSizeInBytes : SIZE_MAX;
+	fseek( file, 0L, SEEK_END );
+	size_t bufferSize = (size_t) ftell( file );
+	bufferSize = MIN( bufferSize, maxSizeInBytes );
+	fseek( file, 0L, SEEK_SET );
+	unsigned char * buffer = (unsigned char *) malloc( bufferSize + 1 );
+	if ( fread( buffer, 1, bufferSize, file ) != bufferSize )
+	{
+		fclose( file );
+		free( buffer );
+		return NULL;
+	}
+	buffer[bufferSize] = '\0';
+	fclose( file );
+	if ( outSizeInBytes != NULL )
+	{
+		*outSizeInBytes = bufferSize;
+	}
+	return buffer;
+}
 
-		out = (unsigned char *)memcpy( out, pushConstantEndString, pushConstantEndStringLength ) + pushConstantEndStringLength;
+static unsigned char * ksGltf_ReadPlainText( const char * uri, size_t * outSizeInBytes )
+{
+	const size_t maxSizeInBytes = ( outSizeInBytes != NULL && *outSizeInBytes > 0 ) ? *outSizeInBytes : SIZE_MAX;
+	const size_t length = MIN( strlen( uri ), maxSizeInBytes );
+	char * out = (char *)malloc( length + 1 );
+	strncpy( out, uri, length );
+	out[length] = '\0';
+	if ( outSizeInBytes != NULL )
+	{
+		*outSizeInBytes = length;
 	}
+	return (unsigned char *)out;
+}
 
-	// Add vertex and fragment shader out parameters.
-	if ( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX )
+static unsigned char * ksGltf_ReadBase64( const char * base64, size_t * outSizeInBytes )
+{
+	const size_t maxSizeInBytes = ( outSizeInBytes != NULL && *outSizeInBytes > 0 ) ? *outSizeInBytes : SIZE_MAX;
+	size_t base64SizeInBytes = strlen( base64 );
+	size_t dataSizeInBytes = ksBase64_DecodeSizeInBytes( base64, base64SizeInBytes );
+	dataSizeInBytes = MIN( dataSizeInBytes, maxSizeInBytes );
+	unsigned char * buffer = (unsigned char *)malloc( dataSizeInBytes );
+	if ( maxSizeInBytes < SIZE_MAX )
 	{
-		// Add gl_PerVertex string.
-		out = (unsigned char *)memcpy( out, perVertexString, perVertexStringLength ) + perVertexStringLength;
+		// Only the header of an embedded image is needed.
+		ksBase64_Decode( buffer, base64, base64SizeInBytes, dataSizeInBytes );
 	}
-	else if ( stage == KS_GPU_PROGRAM_STAGE_FLAG_FRAGMENT )
+	else if ( !ksBase64_DecodeStrict( buffer, base64, base64SizeInBytes, dataSizeInBytes, &dataSizeInBytes ) )
 	{
-		// gl_FragColor was deprecated in GLSL 1.3 (OpenGL 3.0, OpenGL ES 3.0)
-		if ( glslVersion < 130 )
-		{
-			if ( ( conversion & ( KS_GLSL_CONVERSION_FLAG_LAYOUT_OPENGL | KS_GLSL_CONVERSION_FLAG_LAYOUT_VULKAN ) ) != 0 )
-			{
-				out += sprintf( (char *)out, "layout( location = %d ) ", 0 );
-			}
-			out = (unsigned char *)memcpy( out, fragColorString, fragColorStringLength ) + fragColorStringLength;
-		}
+		free( buffer );
+		return NULL;
 	}
+	if ( outSizeInBytes != NULL )
+	{
+		*outSizeInBytes = dataSizeInBytes;
+	}
+	return buffer;
+}
 
-	static const char tabTable[] = { "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t" };
-
-	int addSpace = 0;
-	int addTabs = 0;
-	bool newLine = true;
-	while ( ptr[0] != '\0' )
+static unsigned char * ksGltf_ReadBinaryBuffer( const unsigned char * binaryBuffer, const char * uri, size_t * outSizeInBytes )
+{
+	const size_t maxSizeInBytes = ( outSizeInBytes != NULL && *outSizeInBytes > 0 ) ? *outSizeInBytes : SIZE_MAX;
+	char * endptr = NULL;
+	size_t byteOffset = (size_t) strtol( uri, &endptr, 16 );
+	size_t byteLength = (size_t) strtol( endptr + 1, &endptr, 16 );
+	byteLength = MIN( byteLength, maxSizeInBytes );
+	unsigned char * data = (unsigned char *) malloc( byteLength + 1 );
+	memcpy( data, binaryBuffer + byteOffset, byteLength );
+	data[byteLength] = '\0';
+	if ( outSizeInBytes != NULL )
 	{
-		const unsigned char * token;
-		ksTokenInfo tokenInfo;
-		ptr = ksLexer_NextToken( source, ptr, &token, &tokenInfo );
+		*outSizeInBytes = (int)byteLength;
+	}
+	return data;
+}
 
-		if ( tokenInfo.type == KS_TOKEN_TYPE_NONE )
+// if outSizeInBytes != NULL and *outSizeInBytes > 0 then only *outSizeInBytes bytes will be read.
+static unsigned char * ksGltf_ReadUri( const unsigned char * binaryBuffer, const char * uri, size_t * outSizeInBytes )
+{
+	if ( strncmp( uri, "data:", 5 ) == 0 )
+	{
+		// Plain text.
+		if ( strncmp( uri, "data:text/plain,", 16 ) == 0 )
 		{
-			continue;
+			return ksGltf_ReadPlainText( uri + 16, outSizeInBytes );
 		}
-
-		if ( tokenInfo.type == KS_TOKEN_TYPE_PUNCTUATION )
+		// Base64 text shader.
+		else if ( strncmp( uri, "data:text/plain;base64,", 23 ) == 0 )
 		{
-			if ( ksLexer_CaseSensitiveCompareToken( token, ptr, "{" ) )
-			{
-				out = (unsigned char *)memcpy( out, "\n", 1 ) + 1;
-				out = (unsigned char *)memcpy( out, tabTable, MIN( addTabs, 16 ) ) + MIN( addTabs, 16 );
-				out = (unsigned char *)memcpy( out, "{\n", 2 ) + 2;
-				addTabs++;
-				addSpace = 0;
-				newLine = true;
-				continue;
-			}
-			if ( ksLexer_CaseSensitiveCompareToken( token, ptr, "}" ) )
-			{
-				addTabs--;
-				addSpace = 0;
-				newLine = true;
-				out = (unsigned char *)memcpy( out, tabTable, MIN( addTabs, 16 ) ) + MIN( addTabs, 16 );
-				out = (unsigned char *)memcpy( out, "}\n", 2 ) + 2;
-				continue;
-			}
-			if ( ksLexer_CaseSensitiveCompareToken( token, ptr, ";" ) )
-			{
-				out = (unsigned char *)memcpy( out, ";\n", 2 ) + 2;
-				addSpace = 0;
-				newLine = true;
-				continue;
-			}
-			if ( ksLexer_CaseSensitiveCompareToken( token, ptr, "." ) )
-			{
-				out = (unsigned char *)memcpy( out, ".", 1 ) + 1;
-				addSpace = 0;
-				newLine = false;
-				continue;
-			}
-			if ( ksLexer_CaseSensitiveCompareToken( token, ptr, "," ) )
-			{
-				out = (unsigned char *)memcpy( out, ",", 1 ) + 1;
-				addSpace = 1;
-				newLine = false;
-				continue;
-			}
-			if ( ksLexer_CaseSensitiveCompareToken( token, ptr, "[" ) )
-			{
-				out = (unsigned char *)memcpy( out, "[", 1 ) + 1;
-				addSpace = 0;
-				newLine = false;
-				continue;
-			}
-			if ( ksLexer_CaseSensitiveCompareToken( token, ptr, "]" ) )
-			{
-				out = (unsigned char *)memcpy( out, "]", 1 ) + 1;
-				addSpace = 0;
-				newLine = false;
-				continue;
-			}
+			return ksGltf_ReadBase64( uri + 23, outSizeInBytes );
 		}
-
-		// Insert tabs/spaces.
-		if ( newLine )
+		// Base64 binary buffer.
+		else if ( strncmp( uri, "data:application/octet-stream;base64,", 37 ) == 0 )
 		{
-			out = (unsigned char *)memcpy( out, tabTable, MIN( addTabs, 16 ) ) + MIN( addTabs, 16 );
+			return ksGltf_ReadBase64( uri + 37, outSizeInBytes );
 		}
-		else if ( addSpace )
+		// Base64 glTF 2.0 binary buffer.
+		else if ( strncmp( uri, "data:application/gltf-buffer;base64,", 36 ) == 0 )
 		{
-			out = (unsigned char *)memcpy( out, " ", 1 ) + 1;
+			return ksGltf_ReadBase64( uri + 36, outSizeInBytes );
 		}
-		addSpace = 1;
-		newLine = false;
+		// Base64 JPEG image.
+		else if ( strncmp( uri, "data:image/jpeg;base64,", 23 ) == 0 )
+		{
+			return ksGltf_ReadBase64( uri + 23, outSizeInBytes );
+		}
+		// Base64 JPG, PNG, BMP, GIF, KTX image.
+		else if (	strncmp( uri, "data:image/jpg;base64,", 22 ) == 0 ||
+					strncmp( uri, "data:image/png;base64,", 22 ) == 0 ||
+					strncmp( uri, "data:image/bmp;base64,", 22 ) == 0 ||
+					strncmp( uri, "data:image/gif;base64,", 22 ) == 0 ||
+					strncmp( uri, "data:image/ktx;base64,", 22 ) == 0 )
+		{
+			return ksGltf_ReadBase64( uri + 22, outSizeInBytes );
+		}
+		// bufferView
+		else if ( strncmp( uri, URI_SCHEME_APPLICATION_BINARY, URI_SCHEME_APPLICATION_BINARY_LENGTH ) == 0 )
+		{
+			return ksGltf_ReadBinaryBuffer( binaryBuffer, uri + URI_SCHEME_APPLICATION_BINARY_LENGTH, outSizeInBytes );
+		}
+	}
+	return ksGltf_ReadFile( uri, outSizeInBytes );
+}
 
-		if ( tokenInfo.type == KS_TOKEN_TYPE_NAME )
+// Images and shaders may be stored in a bufferView of the binary glTF buffer, either
+// with the glTF 1.0 KHR_binary_glTF extension or with the glTF 2.0 image bufferView.
+static char * ksGltf_ParseUri( const ksGltfScene * scene, const unsigned char * binaryBuffer, const ksJson * json, const char * uriName )
+{
+	const ksJson * bufferViewReference = ksJson_GetMemberByName( ksJson_GetMemberByName( ksJson_GetMemberByName( json, "extensions" ), "KHR_binary_glTF" ), "bufferView" );
+	if ( bufferViewReference == NULL )
+	{
+		bufferViewReference = ksJson_GetMemberByName( json, "bufferView" );
+	}
+	if ( bufferViewReference != NULL )
+	{
+		const ksGltfBufferView * bufferView = ksGltf_GetBufferViewByReference( scene, bufferViewReference );
+		if ( bufferView != NULL && bufferView->buffer->bufferDataStorage == GLTF_BUFFER_DATA_BINARY_GLTF )
 		{
-			// Strip any existing precision specifiers.
-			if ( ksLexer_CaseSensitiveCompareToken( token, ptr, "precision" ) )
+			const size_t byteOffset = ( bufferView->buffer->bufferData - binaryBuffer ) + bufferView->byteOffset;
+			char * uri = (char *) malloc( URI_SCHEME_APPLICATION_BINARY_LENGTH + 10 + 1 + 10 + 1 );
+			sprintf( uri, "%s0x%X,0x%X", URI_SCHEME_APPLICATION_BINARY, (uint32_t)byteOffset, (uint32_t)bufferView->byteLength );
+			return uri;
+		}
+	}
+	const ksJson * jsonUri = ksJson_GetMemberByName( json, uriName );
+	if ( jsonUri == NULL )
+	{
+		return ksGltf_strdup( "" );
+	}
+	return ksGltf_strdup( ksJson_GetString( jsonUri, "" ) );
+}
+
+// The image container is derived from the data URI, the glTF 2.0 mimeType or the file extension.
+const char * ksGltf_GetImageContainerFromUri( const char * uri, const char * mimeType )
+{
+	if ( strncmp( uri, "data:image/", 11 ) == 0 )
+	{
+		if ( strncmp( uri + 11, "jpg;", 4 ) == 0 ) { return "jpg"; }
+		if ( strncmp( uri + 11, "jpeg;", 5 ) == 0 ) { return "jpg"; }
+		if ( strncmp( uri + 11, "png;", 4 ) == 0 ) { return "png"; }
+		if ( strncmp( uri + 11, "bmp;", 4 ) == 0 ) { return "bmp"; }
+		if ( strncmp( uri + 11, "gif;", 4 ) == 0 ) { return "gif"; }
+		if ( strncmp( uri + 11, "ktx;", 4 ) == 0 ) { return "ktx"; }
+		return "";
+	}
+	if ( strncmp( mimeType, "image/", 6 ) == 0 )
+	{
+		if ( strcmp( mimeType + 6, "jpeg" ) == 0 ) { return "jpg"; }
+		if ( strcmp( mimeType + 6, "png" ) == 0 ) { return "png"; }
+		if ( strcmp( mimeType + 6, "bmp" ) == 0 ) { return "bmp"; }
+		if ( strcmp( mimeType + 6, "gif" ) == 0 ) { return "gif"; }
+		if ( strcmp( mimeType + 6, "ktx" ) == 0 ) { return "ktx"; }
+		return "";
+	}
+	const char * extension = strrchr( uri, '.' );
+	if ( extension != NULL && strncmp( uri, "data:", 5 ) != 0 )
+	{
+		if ( strcasecmp( extension, ".jpg" ) == 0 ) { return "jpg"; }
+		if ( strcasecmp( extension, ".jpeg" ) == 0 ) { return "jpg"; }
+		if ( strcasecmp( extension, ".png" ) == 0 ) { return "png"; }
+		if ( strcasecmp( extension, ".bmp" ) == 0 ) { return "bmp"; }
+		if ( strcasecmp( extension, ".gif" ) == 0 ) { return "gif"; }
+		if ( strcasecmp( extension, ".ktx" ) == 0 ) { return "ktx"; }
+	}
+	return "";
+}
+
+const int ksGltf_GetImageInternalFormatFromUri( const unsigned char * binaryBuffer, const char * uri, const char * container )
+{
+	int glInternalFormat = GL_RGB8;
+	if ( strcmp( container, "jpg" ) == 0 )
+	{
+		glInternalFormat = GL_RGB8;
+	}
+	else if ( strcmp( container, "png" ) == 0 )
+	{
+		size_t outSizeInBytes = 16;
+		unsigned char * data = ksGltf_ReadUri( binaryBuffer, uri, &outSizeInBytes );
+		if ( data != NULL && outSizeInBytes == 16 )
+		{
+			glInternalFormat = ( data[9] == 4 || data[9] == 6 ) ? GL_RGBA8 : GL_RGB8;
+		}
+		free( data );
+	}
+	else if ( strcmp( container, "bmp" ) == 0 )
+	{
+		size_t outSizeInBytes = 32;
+		unsigned char * data = ksGltf_ReadUri( binaryBuffer, uri, &outSizeInBytes );
+		if ( data != NULL && outSizeInBytes == 32 )
+		{
+			glInternalFormat = ( ( data[28] | ( data[29] << 8 ) ) == 32 ) ? GL_RGBA8 : GL_RGB8;
+		}
+		free( data );
+	}
+	else if ( strcmp( container, "gif" ) == 0 )
+	{
+		size_t outSizeInBytes = 1024;
+		unsigned char * data = ksGltf_ReadUri( binaryBuffer, uri, &outSizeInBytes );
+		if ( data != NULL && outSizeInBytes == 1024 )
+		{
+			const size_t colorTableSize = ( data[6 + 4] >> 7 ) * 3 * ( 1 << ( ( ( data[6 + 4] >> 4 ) & 7 ) + 1 ) );
+			if ( 6 + 7 + colorTableSize + 3 < outSizeInBytes &&
+					data[6 + 7 + colorTableSize + 0] == 0x21 && data[6 + 7 + colorTableSize + 1] == 0xF9 )
 			{
-				ptr = ksLexer_SkipUpToIncludingToken( source, ptr, ";" );
-				addSpace = 0;
-				continue;
+				glInternalFormat = ( data[6 + 7 + colorTableSize + 3] >> 7 ) ? GL_RGBA8 : GL_RGB8;
 			}
+		}
+		free( data );
+	}
+	else if ( strcmp( container, "ktx" ) == 0 )
+	{
+		size_t outSizeInBytes = 48;
+		unsigned char * data = ksGltf_ReadUri( binaryBuffer, uri, &outSizeInBytes );
+		if ( data != NULL && outSizeInBytes == 48 )
+		{
+			glInternalFormat = ( data[28] | ( data[29] << 8 ) | ( data[30] << 16 ) | ( data[31] << 24 ) );
+		}
+		free( data );
+	}
+	return glInternalFormat;
+}
 
-			// Convert the vertex and fragment shader in-out parameters.
-			if ( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX )
+typedef enum
+{
+	GLTF_COMPRESSED_IMAGE_DXT			= BIT( 0 ),
+	GLTF_COMPRESSED_IMAGE_DXT_SRGB		= BIT( 1 ),
+	GLTF_COMPRESSED_IMAGE_ETC2			= BIT( 2 ),
+	GLTF_COMPRESSED_IMAGE_ETC2_SRGB		= BIT( 3 ),
+	GLTF_COMPRESSED_IMAGE_ASTC			= BIT( 4 ),
+	GLTF_COMPRESSED_IMAGE_ASTC_SRGB		= BIT( 5 )
+} ksGltfCompressedImageFlags;
+
+static const char * ksGltf_FindImageUri( const ksGltfImage * image, const char * containers[], const ksGltfCompressedImageFlags flags )
+{
+	for ( int i = 0; i < image->versionCount; i++ )
+	{
+		bool found = false;
+		for ( int j = 0; containers[j] != NULL; j++ )
+		{
+			if ( strcmp( image->versions[i].container, containers[j] ) == 0 )
 			{
-				if ( ksLexer_CaseSensitiveCompareToken( token, ptr, "attribute" ) )
-				{
-					const unsigned char * typeStart;
-					const unsigned char * typeEnd = ksLexer_NextToken( source, ptr, &typeStart, NULL );
-					const unsigned char * nameStart;
-					const unsigned char * nameEnd = ksLexer_NextToken( source, typeEnd, &nameStart, NULL );
-					if ( ( conversion & ( KS_GLSL_CONVERSION_FLAG_LAYOUT_OPENGL | KS_GLSL_CONVERSION_FLAG_LAYOUT_VULKAN ) ) != 0 )
-					{
-						out += sprintf( (char *)out, "layout( location = %d ) ", ksGltf_GetVertexAttributeLocation( technique, nameStart, nameEnd ) );
-					}
-					out = (unsigned char *)memcpy( out, "in", 2 ) + 2;
-					out = (unsigned char *)memcpy( out, " ", 1 ) + 1;
-					out = (unsigned char *)memcpy( out, typeStart, typeEnd - typeStart ) + ( typeEnd - typeStart );
-					out = (unsigned char *)memcpy( out, " ", 1 ) + 1;
-					out = (unsigned char *)memcpy( out, nameStart, nameEnd - nameStart ) + ( nameEnd - nameStart );
-					ptr = nameEnd;
-					continue;
-				}
-				if ( ksLexer_CaseSensitiveCompareToken( token, ptr, "varying" ) )
-				{
-					const unsigned char * typeStart;
-					const unsigned char * typeEnd = ksLexer_NextToken( source, ptr, &typeStart, NULL );
-					const unsigned char * nameStart;
-					const unsigned char * nameEnd = ksLexer_NextToken( source, typeEnd, &nameStart, NULL );
-					if ( ( conversion & ( KS_GLSL_CONVERSION_FLAG_LAYOUT_OPENGL | KS_GLSL_CONVERSION_FLAG_LAYOUT_VULKAN ) ) != 0 )
-					{
-						out += sprintf( (char *)out, "layout( location = %d ) ", *inOutParmCount );
-						inOutParms[(*inOutParmCount)].nameStart = nameStart;
-						inOutParms[(*inOutParmCount)].nameEnd = nameEnd;
-						inOutParms[(*inOutParmCount)].nameLength = nameEnd - nameStart;
-						(*inOutParmCount)++;
-					}
-					out = (unsigned char *)memcpy( out, "out", 3 ) + 3;
-					out = (unsigned char *)memcpy( out, " ", 1 ) + 1;
-					out = (unsigned char *)memcpy( out, typeStart, typeEnd - typeStart ) + ( typeEnd - typeStart );
-					out = (unsigned char *)memcpy( out, " ", 1 ) + 1;
-					out = (unsigned char *)memcpy( out, nameStart, nameEnd - nameStart ) + ( nameEnd - nameStart );
-					ptr = nameEnd;
-					continue;
-				}
+				found = true;
+				break;
 			}
-			else if ( stage == KS_GPU_PROGRAM_STAGE_FLAG_FRAGMENT )
+		}
+		if ( !found )
+		{
+			continue;
+		}
+
+		if ( ( flags & GLTF_COMPRESSED_IMAGE_DXT ) == 0 )
+		{
+			if (	( image->versions[i].glInternalFormat >= GL_COMPRESSED_RGB_S3TC_DXT1_EXT &&
+					image->versions[i].glInternalFormat <= GL_COMPRESSED_RGBA_S3TC_DXT5_EXT ) ||
+					( image->versions[i].glInternalFormat >= GL_COMPRESSED_LUMINANCE_LATC1_EXT &&
+					image->versions[i].glInternalFormat <= GL_COMPRESSED_SIGNED_LUMINANCE_ALPHA_LATC2_EXT ) )
 			{
-				if ( ksLexer_CaseSensitiveCompareToken( token, ptr, "varying" ) )
-				{
-					const unsigned char * typeStart;
-					const unsigned char * typeEnd = ksLexer_NextToken( source, ptr, &typeStart, NULL );
-					const unsigned char * nameStart;
-					const unsigned char * nameEnd = ksLexer_NextToken( source, typeEnd, &nameStart, NULL );
-					if ( ( conversion & ( KS_GLSL_CONVERSION_FLAG_LAYOUT_OPENGL | KS_GLSL_CONVERSION_FLAG_LAYOUT_VULKAN ) ) != 0 )
-					{
-						const size_t nameLength = nameEnd - nameStart;
-						int location = -1;
-						for ( int i = 0; i < *inOutParmCount; i++ )
-						{
-							if ( inOutParms[i].nameLength == nameLength &&
-									strncmp( (const char *)inOutParms[i].nameStart, (const char *)nameStart, nameLength ) == 0 )
-							{
-								location = i;
-								break;
-							}
-						}
-						assert( location >= 0 );
-						out += sprintf( (char *)out, "layout( location = %d ) ", location );
-					}
-					out = (unsigned char *)memcpy( out, "in", 2 ) + 2;
-					out = (unsigned char *)memcpy( out, " ", 1 ) + 1;
-					out = (unsigned char *)memcpy( out, typeStart, typeEnd - typeStart ) + ( typeEnd - typeStart );
-					out = (unsigned char *)memcpy( out, " ", 1 ) + 1;
-					out = (unsigned char *)memcpy( out, nameStart, nameEnd - nameStart ) + ( nameEnd - nameStart );
-					ptr = nameEnd;
-					continue;
-				}
+				continue;
 			}
+		}
 
-			// Strip uniforms that are no longer used, set stage flags and optionally add layout qualifiers.
-			if ( ksLexer_CaseSensitiveCompareToken( token, ptr, "uniform" ) )
+		if ( ( flags & GLTF_COMPRESSED_IMAGE_DXT_SRGB ) == 0 )
+		{
+			if (	( image->versions[i].glInternalFormat >= GL_COMPRESSED_SRGB_S3TC_DXT1_EXT &&
+					image->versions[i].glInternalFormat <= GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT ) )
 			{
-				const unsigned char * typeStart;
-				const unsigned char * typeEnd = ksLexer_NextToken( source, ptr, &typeStart, NULL );
-				const unsigned char * nameStart;
-				const unsigned char * nameEnd = ksLexer_NextToken( source, typeEnd, &nameStart, NULL );
+				continue;
+			}
+		}
 
-				// Strip uniforms that are no longer used.
-				if ( ksLexer_CaseSensitiveCompareToken( typeStart, typeEnd, "mat3" ) )
-				{
-					if ( ( conversion & ( KS_GLSL_CONVERSION_FLAG_VIEW_PROJECTION_BUFFER | KS_GLSL_CONVERSION_FLAG_MULTI_VIEW ) ) != 0 )
-					{
-						// Strip uniforms that are replaced by the view and projection matrices from the uniform buffer.
-						if (	ksLexer_CaseSensitiveCompareToken( nameStart, nameEnd, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE_TRANSPOSE] ) ||
-								ksLexer_CaseSensitiveCompareToken( nameStart, nameEnd, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_INVERSE_TRANSPOSE] ) )
-						{
-							assert( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX );
-							ptr = ksLexer_SkipUpToIncludingToken( source, nameEnd, ";" );
-							addSpace = 0;
-							continue;
-						}
-					}
-				}
-				else if ( ksLexer_CaseSensitiveCompareToken( typeStart, typeEnd, "mat4" ) )
-				{
-					if ( ( conversion & ( KS_GLSL_CONVERSION_FLAG_VIEW_PROJECTION_BUFFER | KS_GLSL_CONVERSION_FLAG_MULTI_VIEW ) ) != 0 )
-					{
-						// Strip uniforms that are replaced by the view and projection matrices from the uniform buffer.
-						if (	ksLexer_CaseSensitiveCompareToken( nameStart, nameEnd, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW] ) ||
-								ksLexer_CaseSensitiveCompareToken( nameStart, nameEnd, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE] ) ||
-								ksLexer_CaseSensitiveCompareToken( nameStart, nameEnd, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION] ) ||
-								ksLexer_CaseSensitiveCompareToken( nameStart, nameEnd, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION_INVERSE] ) ||
-								ksLexer_CaseSensitiveCompareToken( nameStart, nameEnd, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW] ) ||
-								ksLexer_CaseSensitiveCompareToken( nameStart, nameEnd, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_INVERSE] ) ||
-								ksLexer_CaseSensitiveCompareToken( nameStart, nameEnd, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_PROJECTION] ) )
-						{
-							assert( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX );
-							ptr = ksLexer_SkipUpToIncludingToken( source, nameEnd, ";" );
-							addSpace = 0;
-							continue;
-						}
-					}
+		if ( ( flags & GLTF_COMPRESSED_IMAGE_ETC2 ) == 0 )
+		{
+			if (	image->versions[i].glInternalFormat == GL_COMPRESSED_RGB8_ETC2 ||
+					image->versions[i].glInternalFormat == GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2 ||
+					image->versions[i].glInternalFormat == GL_COMPRESSED_RGBA8_ETC2_EAC ||
+					image->versions[i].glInternalFormat == GL_COMPRESSED_R11_EAC ||
+					image->versions[i].glInternalFormat == GL_COMPRESSED_SIGNED_RG11_EAC )
+			{
+				continue;
+			}
+		}
 
-					if ( ( conversion & KS_GLSL_CONVERSION_FLAG_JOINT_BUFFER ) != 0 )
-					{
-						// Strip the joint uniform array.
-						if ( ksLexer_CaseSensitiveCompareToken( nameStart, nameEnd, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_JOINT_ARRAY] ) )
-						{
-							assert( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX );
-							ptr = ksLexer_SkipUpToIncludingToken( source, nameEnd, ";" );
-							addSpace = 0;
-							continue;
-						}
-					}
-				}
+		if ( ( flags & GLTF_COMPRESSED_IMAGE_ETC2_SRGB ) == 0 )
+		{
+			if (	image->versions[i].glInternalFormat == GL_COMPRESSED_SRGB8_ETC2 ||
+					image->versions[i].glInternalFormat == GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2 ||
+					image->versions[i].glInternalFormat == GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC )
+			{
+				continue;
+			}
+		}
 
-				ksGltf_SetUniformStageFlag( technique, nameStart, nameEnd, stage );
+		if ( ( flags & GLTF_COMPRESSED_IMAGE_ASTC ) == 0 )
+		{
+			if (	image->versions[i].glInternalFormat >= GL_COMPRESSED_RGBA_ASTC_4x4_KHR &&
+					image->versions[i].glInternalFormat >= GL_COMPRESSED_RGBA_ASTC_12x12_KHR )
+			{
+				continue;
+			}
+		}
 
-				// Optionally add layout qualifiers.
+		if ( ( flags & GLTF_COMPRESSED_IMAGE_ASTC ) == 0 )
+		{
+			if (	image->versions[i].glInternalFormat >= GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR &&
+					image->versions[i].glInternalFormat >= GL_COMPRESSED_SRGB8_ALPHA8_ASTC_12x12_KHR )
+			{
+				continue;
+			}
+		}
+
+		return image->versions[i].uri;
+	}
+
+	return "";
+}
+
+static const char * ksGltf_FindShaderUri( const ksGltfShader * shader, const ksGltfShaderType type, const char * apiString, const char * maxVersionString )
+{
+	const int maxVersion = atoi( maxVersionString );
+	const char * bestUri = NULL;
+	int bestVersion = 0;
+	for ( int i = 0; i < shader->shaderCount[type]; i++ )
+	{
+		if ( strcmp( shader->shaders[type][i].api, apiString ) == 0 )
+		{
+			const int version = atoi( shader->shaders[type][i].version );
+			if ( version <= maxVersion && version > bestVersion )
+			{
+				bestVersion = version;
+				bestUri = shader->shaders[type][i].uri;
+			}
+		}
+	}
+	return bestUri;
+}
+
+static void ksGltf_ParseIntArray( int * elements, const int count, const ksJson * arrayNode )
+{
+	int i = 0;
+	for ( ; i < ksJson_GetMemberCount( arrayNode ) && i < count; i++ )
+	{
+		elements[i] = ksJson_GetInt32( ksJson_GetMemberByIndex( arrayNode, i ), 0 );
+	}
+	for ( ; i < count; i++ )
+	{
+		elements[i] = 0;
+	}
+}
+
+static void ksGltf_ParseFloatArray( float * elements, const int count, const ksJson * arrayNode )
+{
+	int i = 0;
+	for ( ; i < ksJson_GetMemberCount( arrayNode ) && i < count; i++ )
+	{
+		elements[i] = ksJson_GetFloat( ksJson_GetMemberByIndex( arrayNode, i ), 0.0f );
+	}
+	for ( ; i < count; i++ )
+	{
+		elements[i] = 0.0f;
+	}
+}
+
+static void ksGltf_ParseUniformValue( ksGltfUniformValue * value, const ksJson * json, const ksGpuProgramParmType type, const ksGltfScene * scene )
+{
+	switch ( type )
+	{
+		case KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_SAMPLED:					value->texture = ksGltf_GetTextureByReference( scene, json ); break;
+		case KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_INT:				value->intValue[0] = ksJson_GetInt32( json, 0 ); break;
+		case KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_INT_VECTOR2:		ksGltf_ParseIntArray( value->intValue, 16, json ); break;
+		case KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_INT_VECTOR3:		ksGltf_ParseIntArray( value->intValue, 16, json ); break;
+		case KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_INT_VECTOR4:		ksGltf_ParseIntArray( value->intValue, 16, json ); break;
+		case KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT:				value->floatValue[0] = ksJson_GetFloat( json, 0.0f ); break;
+		case KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_VECTOR2:		ksGltf_ParseFloatArray( value->floatValue, 2, json ); break;
+		case KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_VECTOR3:		ksGltf_ParseFloatArray( value->floatValue, 3, json ); break;
+		case KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_VECTOR4:		ksGltf_ParseFloatArray( value->floatValue, 4, json ); break;
+		case KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX2X2:	ksGltf_ParseFloatArray( value->floatValue, 2*2, json ); break;
+		case KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX2X3:	ksGltf_ParseFloatArray( value->floatValue, 2*3, json ); break;
+		case KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX2X4:	ksGltf_ParseFloatArray( value->floatValue, 2*4, json ); break;
+		case KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX3X2:	ksGltf_ParseFloatArray( value->floatValue, 3*2, json ); break;
+		case KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX3X3:	ksGltf_ParseFloatArray( value->floatValue, 3*3, json ); break;
+		case KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX3X4:	ksGltf_ParseFloatArray( value->floatValue, 3*4, json ); break;
+		case KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX4X2:	ksGltf_ParseFloatArray( value->floatValue, 4*2, json ); break;
+		case KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX4X3:	ksGltf_ParseFloatArray( value->floatValue, 4*3, json ); break;
+		case KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX4X4:	ksGltf_ParseFloatArray( value->floatValue, 4*4, json ); break;
+		default: break;
+	}
+}
+
+static ksGpuTextureFilter ksGltf_GetTextureFilter( const int filter )
+{
+	switch ( filter )
+	{
+		case GL_NEAREST:					return KS_GPU_TEXTURE_FILTER_NEAREST;
+		case GL_LINEAR:						return KS_GPU_TEXTURE_FILTER_LINEAR;
+		case GL_NEAREST_MIPMAP_NEAREST:		return KS_GPU_TEXTURE_FILTER_NEAREST;
+		case GL_LINEAR_MIPMAP_NEAREST:		return KS_GPU_TEXTURE_FILTER_NEAREST;
+		case GL_NEAREST_MIPMAP_LINEAR:		return KS_GPU_TEXTURE_FILTER_BILINEAR;
+		case GL_LINEAR_MIPMAP_LINEAR:		return KS_GPU_TEXTURE_FILTER_BILINEAR;
+		default:							return KS_GPU_TEXTURE_FILTER_BILINEAR;
+	}
+}
+
+static ksGpuTextureWrapMode ksGltf_GetTextureWrapMode( const int wrapMode )
+{
+	switch ( wrapMode )
+	{
+		case GL_REPEAT:				return KS_GPU_TEXTURE_WRAP_MODE_REPEAT;
+		case GL_CLAMP_TO_EDGE:		return KS_GPU_TEXTURE_WRAP_MODE_CLAMP_TO_EDGE;
+		case GL_CLAMP_TO_BORDER:	return KS_GPU_TEXTURE_WRAP_MODE_CLAMP_TO_BORDER;
+		default:					return KS_GPU_TEXTURE_WRAP_MODE_REPEAT;
+	}
+}
+
+static ksGpuProgramStageFlags ksGltf_GetProgramStageFlag( const int stage )
+{
+	switch ( stage )
+	{
+		case GL_VERTEX_SHADER:		return KS_GPU_PROGRAM_STAGE_FLAG_VERTEX;
+		case GL_FRAGMENT_SHADER:	return KS_GPU_PROGRAM_STAGE_FLAG_FRAGMENT;
+		default:					return KS_GPU_PROGRAM_STAGE_FLAG_VERTEX;
+	}
+}
+
+static ksGpuFrontFace ksGltf_GetFrontFace( const int face )
+{
+	switch ( face )
+	{
+		case GL_CCW:	return KS_GPU_FRONT_FACE_COUNTER_CLOCKWISE;
+		case GL_CW:		return KS_GPU_FRONT_FACE_CLOCKWISE;
+		default:		return KS_GPU_FRONT_FACE_COUNTER_CLOCKWISE;
+	}
+}
+
+static ksGpuCullMode ksGltf_GetCullMode( const int mode )
+{
+	switch ( mode )
+	{
+		case GL_NONE:	return KS_GPU_CULL_MODE_NONE;
+		case GL_FRONT:	return KS_GPU_CULL_MODE_FRONT;
+		case GL_BACK:	return KS_GPU_CULL_MODE_BACK;
+		default:		return KS_GPU_CULL_MODE_BACK;
+	}
+}
+
+static ksGpuCompareOp ksGltf_GetCompareOp( const int op )
+{
+	switch ( op )
+	{
+		case GL_NEVER:		return KS_GPU_COMPARE_OP_NEVER;
+		case GL_LESS:		return KS_GPU_COMPARE_OP_LESS;
+		case GL_EQUAL:		return KS_GPU_COMPARE_OP_EQUAL;
+		case GL_LEQUAL:		return KS_GPU_COMPARE_OP_LESS_OR_EQUAL;
+		case GL_GREATER:	return KS_GPU_COMPARE_OP_GREATER;
+		case GL_NOTEQUAL:	return KS_GPU_COMPARE_OP_NOT_EQUAL;
+		case GL_GEQUAL:		return KS_GPU_COMPARE_OP_GREATER_OR_EQUAL;
+		case GL_ALWAYS:		return KS_GPU_COMPARE_OP_ALWAYS;
+		default:			return KS_GPU_COMPARE_OP_LESS;
+	}
+}
+
+static ksGpuBlendOp ksGltf_GetBlendOp( const int op )
+{
+	switch( op )
+	{
+		case GL_FUNC_ADD:				return KS_GPU_BLEND_OP_ADD;
+		case GL_FUNC_SUBTRACT:			return KS_GPU_BLEND_OP_SUBTRACT;
+		case GL_FUNC_REVERSE_SUBTRACT:	return KS_GPU_BLEND_OP_REVERSE_SUBTRACT;
+		case GL_MIN:					return KS_GPU_BLEND_OP_MIN;
+		case GL_MAX:					return KS_GPU_BLEND_OP_MAX;
+		default:						return KS_GPU_BLEND_OP_ADD;
+	}
+}
+
+static ksGpuBlendFactor ksGltf_GetBlendFactor( const int factor )
+{
+	switch ( factor )
+	{
+		case GL_ZERO:						return KS_GPU_BLEND_FACTOR_ZERO;
+		case GL_ONE:						return KS_GPU_BLEND_FACTOR_ONE;
+		case GL_SRC_COLOR:					return KS_GPU_BLEND_FACTOR_SRC_COLOR;
+		case GL_ONE_MINUS_SRC_COLOR:		return KS_GPU_BLEND_FACTOR_ONE_MINUS_SRC_COLOR;
+		case GL_DST_COLOR:					return KS_GPU_BLEND_FACTOR_DST_COLOR;
+		case GL_ONE_MINUS_DST_COLOR:		return KS_GPU_BLEND_FACTOR_ONE_MINUS_DST_COLOR;
+		case GL_SRC_ALPHA:					return KS_GPU_BLEND_FACTOR_SRC_ALPHA;
+		case GL_ONE_MINUS_SRC_ALPHA:		return KS_GPU_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+		case GL_DST_ALPHA:					return KS_GPU_BLEND_FACTOR_DST_ALPHA;
+		case GL_ONE_MINUS_DST_ALPHA:		return KS_GPU_BLEND_FACTOR_ONE_MINUS_DST_ALPHA;
+		case GL_CONSTANT_COLOR:				return KS_GPU_BLEND_FACTOR_CONSTANT_COLOR;
+		case GL_ONE_MINUS_CONSTANT_COLOR:	return KS_GPU_BLEND_FACTOR_ONE_MINUS_CONSTANT_COLOR;
+		case GL_CONSTANT_ALPHA:				return KS_GPU_BLEND_FACTOR_CONSTANT_ALPHA;
+		case GL_ONE_MINUS_CONSTANT_ALPHA:	return KS_GPU_BLEND_FACTOR_ONE_MINUS_CONSTANT_ALPHA;
+		case GL_SRC_ALPHA_SATURATE:			return KS_GPU_BLEND_FACTOR_SRC_ALPHA_SATURATE;
+		default:							return KS_GPU_BLEND_FACTOR_ZERO;
+	}
+}
+
+static int ksGltf_GetVertexAttributeLocation( const ksGltfTechnique * technique, const unsigned char * nameStart, const unsigned char * nameEnd )
+{
+	for ( int i = 0; i < technique->attributeCount; i++ )
+	{
+		if ( ksLexer_CaseSensitiveCompareToken( nameStart, nameEnd, technique->attributes[i].name ) )
+		{
+			return technique->attributes[i].location;
+		}
+	}
+	assert( false );
+	return 0;
+}
+
+static int ksGltf_GetUniformBinding( const ksGltfTechnique * technique, const unsigned char * nameStart, const unsigned char * nameEnd )
+{
+	for ( int i = 0; i < technique->uniformCount; i++ )
+	{
+		if ( ksLexer_CaseSensitiveCompareToken( nameStart, nameEnd, technique->parms[i].name ) )
+		{
+			return technique->parms[i].binding;
+		}
+	}
+	assert( false );
+	return 0;
+}
+
+static void ksGltf_SetUniformStageFlag( const ksGltfTechnique * technique, const unsigned char * nameStart, const unsigned char * nameEnd, const ksGpuProgramStageFlags flag )
+{
+	for ( int i = 0; i < technique->uniformCount; i++ )
+	{
+		if ( ksLexer_CaseSensitiveCompareToken( nameStart, nameEnd, technique->parms[i].name ) )
+		{
+			technique->parms[i].stageFlags |= flag;
+			return;
+		}
+	}
+	assert( false );
+}
+
+#define JOINT_UNIFORM_BUFFER_NAME							"jointUniformBuffer"
+#define VIEW_PROJECTION_UNIFORM_BUFFER_NAME					"viewProjectionUniformBuffer"
+#define VIEW_PROJECTION_MULTI_VIEW_UNIFORM_BUFFER_NAME		"viewProjectionMultiViewUniformBuffer"
+
+typedef enum
+{
+	KS_GLSL_CONVERSION_NONE							= 0,
+	KS_GLSL_CONVERSION_FLAG_JOINT_BUFFER			= BIT( 0 ),	// KHR_glsl_joint_buffer
+	KS_GLSL_CONVERSION_FLAG_VIEW_PROJECTION_BUFFER	= BIT( 1 ),	// KHR_glsl_view_projection_buffer
+	KS_GLSL_CONVERSION_FLAG_MULTI_VIEW				= BIT( 2 ),	// KHR_glsl_multi_view
+	KS_GLSL_CONVERSION_FLAG_LAYOUT_OPENGL			= BIT( 3 ),	// KHR_glsl_layout_opengl
+	KS_GLSL_CONVERSION_FLAG_LAYOUT_VULKAN			= BIT( 4 )	// KHR_glsl_layout_vulkan
+} ksGlslConversionFlags;
+
+typedef struct ksGltfInOutParm
+{
+	const unsigned char *	nameStart;
+	const unsigned char *	nameEnd;
+	size_t					nameLength;
+} ksGltfInOutParm;
+
+#if GRAPHICS_API_OPENGL == 1 || GRAPHICS_API_OPENGL_ES == 1 || GRAPHICS_API_VULKAN == 1
+
+// Convert a GLSL 1.0 ES glTF shader to a newer (at least 1.3) GLSL version primarily for uniform buffer support.
+// Assumes the GLSL 1.0 ES glTF shader does not use any extensions.
+// Currently assumes the GLSL 1.0 ES glTF shader does not use any preprocessing.
+unsigned char * ksGltf_ConvertShaderGLSL( const unsigned char * source, size_t * sourceSize, const ksGpuProgramStageFlags stage,
+											const int conversion,
+											const ksGltfTechnique * technique,
+											const char * existingSemanticUniforms[],
+											const char * newSemanticUniforms[],
+											ksGltfInOutParm inOutParms[], int * inOutParmCount )
+{
+	const bool multiview = ( conversion & KS_GLSL_CONVERSION_FLAG_MULTI_VIEW ) != 0;
+
+	// GLSL version.
+	const char * versionString =
+					"#version " GLSL_VERSION "\n";
+	const size_t versionStringLength =
+					strlen( versionString );
+
+	// Default precision.
+	const char * precisionString =
+					"precision highp float;\n"
+					"precision highp int;\n";
+	const size_t precisionStringLength =
+					strlen( precisionString );
+
+	// Per vertex extension.
+	const char * perVertexExtensionString =
+					"#extension GL_EXT_shader_io_blocks : enable\n";
+	const size_t perVertexExtensionStringLength =
+					strlen( perVertexExtensionString );
+
+	// Enhanced layouts extension.
+	const char * layoutExtensionString =
+					"#extension GL_ARB_enhanced_layouts : enable\n";
+	const size_t layoutExtensionStringLength =
+					strlen( layoutExtensionString );
+
+	// KHR_glsl_joint_buffer
+	const char * jointUniformSemanticString =
+					JOINT_UNIFORM_BUFFER_NAME;
+	const size_t jointUniformSemanticStringLength =
+					strlen( jointUniformSemanticString );
+	const char * jointUniformBufferString =
+					"uniform %s\n"
+					"{\n"
+					"	%smat4 %s[256];\n"
+					"};\n";
+	const size_t jointUniformBufferStringLength =
+					strlen( jointUniformBufferString );
+
+	// KHR_glsl_view_projection_buffer
+	const char * viewProjectionUniformSemanticString =
+					multiview ? VIEW_PROJECTION_MULTI_VIEW_UNIFORM_BUFFER_NAME : VIEW_PROJECTION_UNIFORM_BUFFER_NAME;
+	const size_t viewProjectionUniformSemanticStringLength =
+					strlen( viewProjectionUniformSemanticString );
+	const char * viewProjectionUniformBufferString =
+					"uniform %s\n"
+					"{\n"
+					"	%smat4 %s%s;\n"	// viewMatrix
+					"	%smat4 %s%s;\n"	// viewInverseMatrix
+					"	%smat4 %s%s;\n"	// projectionMatrix
+					"	%smat4 %s%s;\n"	// projectionInverseMatrix
+					"};\n";
+	const size_t viewProjectionUniformBufferStringLength =
+					strlen( viewProjectionUniformBufferString );
+
+	// KHR_glsl_multi_view
+	const char * multiviewString = 
+					"#define NUM_VIEWS 2\n"
+					"#define VIEW_ID gl_ViewID_OVR\n"
+					"#extension GL_OVR_multiview2 : require\n"
+					"layout( num_views = NUM_VIEWS ) in;\n";
+	const size_t multiviewStringLength =
+					strlen( multiviewString );
+	const char * multiviewArraySizeString =
+					multiview ? "[NUM_VIEWS]" : "";
+	const char * multiviewArrayIndexString =
+					multiview ? "[VIEW_ID]" : "";
+
+	// push constants
+	const char * pushConstantStartString =
+					"layout( std430, push_constant ) uniform pushConstants\n"
+					"{\n";
+	const size_t pushConstantStartStringLength =
+					strlen( pushConstantStartString );
+	const char * pushConstantEndString =
+					"} pc;\n";
+	const size_t pushConstantEndStringLength =
+					strlen( pushConstantEndString );
+	const char * pushConstantInstanceName =
+					( ( conversion & KS_GLSL_CONVERSION_FLAG_LAYOUT_VULKAN ) != 0 ) ? "pc." : "";
+
+	// Vertex and fragment out parameters.
+	const char * perVertexString =
+					"out gl_PerVertex { vec4 gl_Position; };\n";
+	const size_t perVertexStringLength =
+					strlen( perVertexString );
+	const char * fragColorString =
+					"out vec4 fragColor;\n";
+	const size_t fragColorStringLength =
+					strlen( fragColorString );
+
+	unsigned char * newSource = (unsigned char *) malloc( *sourceSize * 2 +
+						versionStringLength +
+						precisionStringLength +
+						perVertexExtensionStringLength +
+						layoutExtensionStringLength +
+						jointUniformSemanticStringLength +
+						jointUniformBufferStringLength +
+						viewProjectionUniformSemanticStringLength +
+						viewProjectionUniformBufferStringLength +
+						multiviewStringLength +
+						pushConstantStartStringLength +
+						pushConstantEndStringLength +
+						perVertexStringLength +
+						fragColorStringLength );
+	unsigned char * out = newSource;
+	const unsigned char * ptr = source;
+
+	int glslVersion = 100;
+
+	// Get any existing version string.
+	{
+		const unsigned char * numberSignToken;
+		const unsigned char * endOfNumberSignToken = ksLexer_NextToken( source, source, &numberSignToken, NULL );
+		if ( ksLexer_CaseSensitiveCompareToken( numberSignToken, endOfNumberSignToken, "#" ) )
+		{
+			const unsigned char * versionToken;
+			const unsigned char * endOfVersionToken = ksLexer_NextToken( source, endOfNumberSignToken, &versionToken, NULL );
+			if ( ksLexer_CaseSensitiveCompareToken( versionToken, endOfVersionToken, "version" ) )
+			{
+				const unsigned char * numberToken;
+				ksLexer_NextToken( source, endOfVersionToken, &numberToken, NULL );
+				glslVersion = atoi( (const char *)numberToken );
+				ptr = ksLexer_SkipUpToEndOfLine( source, endOfVersionToken );
+			}
+		}
+	}
+
+	// Add a new version string.
+	out = (unsigned char *)memcpy( out, versionString, versionStringLength ) + versionStringLength;
+
+	// Add a new precision string.
+	out = (unsigned char *)memcpy( out, precisionString, precisionStringLength ) + precisionStringLength;
+
+	// Add GL_EXT_shader_io_blocks.
+	if ( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX )
+	{
+		out = (unsigned char *)memcpy( out, perVertexExtensionString, perVertexExtensionStringLength ) + perVertexExtensionStringLength;
+	}
+
+	// Add GL_ARB_enhanced_layouts.
+	if ( ( conversion & ( KS_GLSL_CONVERSION_FLAG_LAYOUT_OPENGL | KS_GLSL_CONVERSION_FLAG_LAYOUT_VULKAN ) ) != 0 )
+	{
+		out = (unsigned char *)memcpy( out, layoutExtensionString, layoutExtensionStringLength ) + layoutExtensionStringLength;
+	}
+
+	if ( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX )
+	{
+		// Optionally add multi-view support.
+		if ( ( conversion & KS_GLSL_CONVERSION_FLAG_MULTI_VIEW ) != 0 )
+		{
+			out = (unsigned char *)memcpy( out, multiviewString, multiviewStringLength ) + multiviewStringLength;
+		}
+
+		// Optionally add a joint uniform buffer.
+		if ( ( conversion & KS_GLSL_CONVERSION_FLAG_JOINT_BUFFER ) != 0 )
+		{
+			if ( newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_JOINT_BUFFER] != NULL )
+			{
+				if ( ( conversion & ( KS_GLSL_CONVERSION_FLAG_LAYOUT_OPENGL | KS_GLSL_CONVERSION_FLAG_LAYOUT_VULKAN ) ) != 0 )
+				{
+					const int binding = ksGltf_GetUniformBinding( technique, (const unsigned char *)jointUniformSemanticString, NULL );
+					out += sprintf( (char *)out, "layout( std140, binding = %d ) ", binding );
+					out += sprintf( (char *)out, jointUniformBufferString, jointUniformSemanticString,
+											"layout( offset = 0 ) ", existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_JOINT_ARRAY] );
+				}
+				else
+				{
+					out += sprintf( (char *)out, jointUniformBufferString, jointUniformSemanticString,
+											"", existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_JOINT_ARRAY] );
+				}
+				ksGltf_SetUniformStageFlag( technique, (const unsigned char *)jointUniformSemanticString, NULL, stage );
+			}
+		}
+
+		// Optionally add a view-projection or multi-view uniform buffer.
+		if ( ( conversion & ( KS_GLSL_CONVERSION_FLAG_VIEW_PROJECTION_BUFFER | KS_GLSL_CONVERSION_FLAG_MULTI_VIEW ) ) != 0 )
+		{
+			if (	newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW] != NULL ||
+					newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE] != NULL ||
+					newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION] != NULL ||
+					newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION_INVERSE] != NULL )
+			{
+				if ( ( conversion & ( KS_GLSL_CONVERSION_FLAG_LAYOUT_OPENGL | KS_GLSL_CONVERSION_FLAG_LAYOUT_VULKAN ) ) != 0 )
+				{
+					const int binding = ksGltf_GetUniformBinding( technique, (const unsigned char *)viewProjectionUniformSemanticString, NULL );
+					out += sprintf( (char *)out, "layout( std140, binding = %d ) ", binding );
+					out += sprintf( (char *)out, viewProjectionUniformBufferString, viewProjectionUniformSemanticString,
+								multiview ? "layout( offset =   0 ) " : "layout( offset =   0 ) ", newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW], multiviewArraySizeString,
+								multiview ? "layout( offset = 128 ) " : "layout( offset =  64 ) ", newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE], multiviewArraySizeString,
+ 								multiview ? "layout( offset = 256 ) " : "layout( offset = 128 ) ", newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION], multiviewArraySizeString,
+								multiview ? "layout( offset = 384 ) " : "layout( offset = 192 ) ", newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION_INVERSE], multiviewArraySizeString );
+				}
+				else
+				{
+					out += sprintf( (char *)out, viewProjectionUniformBufferString, viewProjectionUniformSemanticString,
+											"", newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW], multiviewArraySizeString,
+											"", newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE], multiviewArraySizeString,
+ 											"", newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION], multiviewArraySizeString,
+											"", newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION_INVERSE], multiviewArraySizeString );
+				}
+				ksGltf_SetUniformStageFlag( technique, (const unsigned char *)viewProjectionUniformSemanticString, NULL, stage );
+			}
+
+			// Optionally add 'MODEL' and 'MODELINVERSE' uniforms.
+			if ( ( conversion & KS_GLSL_CONVERSION_FLAG_LAYOUT_VULKAN ) == 0 )
+			{
+				if ( newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL] != NULL && existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL] == NULL )
+				{
+					if ( ( conversion & KS_GLSL_CONVERSION_FLAG_LAYOUT_OPENGL ) != 0 )
+					{
+						const int binding = ksGltf_GetUniformBinding( technique, (const unsigned char *)newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL], NULL );
+						out += sprintf( (char *)out, "layout( location = %d ) ", binding );
+					}
+					out += sprintf( (char *)out, "uniform mat4 %s;\n", newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL] );
+
+					ksGltf_SetUniformStageFlag( technique, (const unsigned char *)newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL], NULL, stage );
+				}
+				if ( newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE] != NULL && existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE] == NULL )
+				{
+					if ( ( conversion & KS_GLSL_CONVERSION_FLAG_LAYOUT_OPENGL ) != 0 )
+					{
+						const int binding = ksGltf_GetUniformBinding( technique, (const unsigned char *)newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE], NULL );
+						out += sprintf( (char *)out, "layout( location = %d ) ", binding );
+					}
+					out += sprintf( (char *)out, "uniform mat4 %s;\n", newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE] );
+
+					ksGltf_SetUniformStageFlag( technique, (const unsigned char *)newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE], NULL, stage );
+				}
+			}
+		}
+	}
+
+	// Optionally add a push constant block.
+	if ( ( conversion & KS_GLSL_CONVERSION_FLAG_LAYOUT_VULKAN ) != 0 )
+	{
+		out = (unsigned char *)memcpy( out, pushConstantStartString, pushConstantStartStringLength ) + pushConstantStartStringLength;
+
+		int offset = 0;
+		for ( int i = 0; i < technique->uniformCount; i++ )
+		{
+			const int size = ksGpuProgramParm_GetPushConstantSize( technique->parms[i].type );
+			if ( size > 0 )
+			{
+				const char * type = ksGpuProgramParm_GetPushConstantGlslType( technique->parms[i].type );
+				out += sprintf( (char *)out, "\tlayout( offset = %3d ) %s %s;\n", offset, type, technique->parms[i].name );
+				offset += size;
+				// For now make all push constants visible to both the vertex and fragment shader so we don't have to select the ones actually used in each.
+				ksGltf_SetUniformStageFlag( technique, (const unsigned char *)technique->parms[i].name, NULL, KS_GPU_PROGRAM_STAGE_FLAG_VERTEX | KS_GPU_PROGRAM_STAGE_FLAG_FRAGMENT );
+			}
+		}
+
+		out = (unsigned char *)memcpy( out, pushConstantEndString, pushConstantEndStringLength ) + pushConstantEndStringLength;
+	}
+
+	// Add vertex and fragment shader out parameters.
+	if ( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX )
+	{
+		// Add gl_PerVertex string.
+		out = (unsigned char *)memcpy( out, perVertexString, perVertexStringLength ) + perVertexStringLength;
+	}
+	else if ( stage == KS_GPU_PROGRAM_STAGE_FLAG_FRAGMENT )
+	{
+		// gl_FragColor was deprecated in GLSL 1.3 (OpenGL 3.0, OpenGL ES 3.0)
+		if ( glslVersion < 130 )
+		{
+			if ( ( conversion & ( KS_GLSL_CONVERSION_FLAG_LAYOUT_OPENGL | KS_GLSL_CONVERSION_FLAG_LAYOUT_VULKAN ) ) != 0 )
+			{
+				out += sprintf( (char *)out, "layout( location = %d ) ", 0 );
+			}
+			out = (unsigned char *)memcpy( out, fragColorString, fragColorStringLength ) + fragColorStringLength;
+		}
+	}
+
+	static const char tabTable[] = { "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t" };
+
+	int addSpace = 0;
+	int addTabs = 0;
+	bool newLine = true;
+	while ( ptr[0] != '\0' )
+	{
+		const unsigned char * token;
+		ksTokenInfo tokenInfo;
+		ptr = ksLexer_NextToken( source, ptr, &token, &tokenInfo );
+
+		if ( tokenInfo.type == KS_TOKEN_TYPE_NONE )
+		{
+			continue;
+		}
+
+		if ( tokenInfo.type == KS_TOKEN_TYPE_PUNCTUATION )
+		{
+			if ( ksLexer_CaseSensitiveCompareToken( token, ptr, "{" ) )
+			{
+				out = (unsigned char *)memcpy( out, "\n", 1 ) + 1;
+				out = (unsigned char *)memcpy( out, tabTable, MIN( addTabs, 16 ) ) + MIN( addTabs, 16 );
+				out = (unsigned char *)memcpy( out, "{\n", 2 ) + 2;
+				addTabs++;
+				addSpace = 0;
+				newLine = true;
+				continue;
+			}
+			if ( ksLexer_CaseSensitiveCompareToken( token, ptr, "}" ) )
+			{
+				addTabs--;
+				addSpace = 0;
+				newLine = true;
+				out = (unsigned char *)memcpy( out, tabTable, MIN( addTabs, 16 ) ) + MIN( addTabs, 16 );
+				out = (unsigned char *)memcpy( out, "}\n", 2 ) + 2;
+				continue;
+			}
+			if ( ksLexer_CaseSensitiveCompareToken( token, ptr, ";" ) )
+			{
+				out = (unsigned char *)memcpy( out, ";\n", 2 ) + 2;
+				addSpace = 0;
+				newLine = true;
+				continue;
+			}
+			if ( ksLexer_CaseSensitiveCompareToken( token, ptr, "." ) )
+			{
+				out = (unsigned char *)memcpy( out, ".", 1 ) + 1;
+				addSpace = 0;
+				newLine = false;
+				continue;
+			}
+			if ( ksLexer_CaseSensitiveCompareToken( token, ptr, "," ) )
+			{
+				out = (unsigned char *)memcpy( out, ",", 1 ) + 1;
+				addSpace = 1;
+				newLine = false;
+				continue;
+			}
+			if ( ksLexer_CaseSensitiveCompareToken( token, ptr, "[" ) )
+			{
+				out = (unsigned char *)memcpy( out, "[", 1 ) + 1;
+				addSpace = 0;
+				newLine = false;
+				continue;
+			}
+			if ( ksLexer_CaseSensitiveCompareToken( token, ptr, "]" ) )
+			{
+				out = (unsigned char *)memcpy( out, "]", 1 ) + 1;
+				addSpace = 0;
+				newLine = false;
+				continue;
+			}
+		}
+
+		// Insert tabs/spaces.
+		if ( newLine )
+		{
+			out = (unsigned char *)memcpy( out, tabTable, MIN( addTabs, 16 ) ) + MIN( addTabs, 16 );
+		}
+		else if ( addSpace )
+		{
+			out = (unsigned char *)memcpy( out, " ", 1 ) + 1;
+		}
+		addSpace = 1;
+		newLine = false;
+
+		if ( tokenInfo.type == KS_TOKEN_TYPE_NAME )
+		{
+			// Strip any existing precision specifiers.
+			if ( ksLexer_CaseSensitiveCompareToken( token, ptr, "precision" ) )
+			{
+				ptr = ksLexer_SkipUpToIncludingToken( source, ptr, ";" );
+				addSpace = 0;
+				continue;
+			}
+
+			// Convert the vertex and fragment shader in-out parameters.
+			if ( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX )
+			{
+				if ( ksLexer_CaseSensitiveCompareToken( token, ptr, "attribute" ) )
+				{
+					const unsigned char * typeStart;
+					const unsigned char * typeEnd = ksLexer_NextToken( source, ptr, &typeStart, NULL );
+					const unsigned char * nameStart;
+					const unsigned char * nameEnd = ksLexer_NextToken( source, typeEnd, &nameStart, NULL );
+					if ( ( conversion & ( KS_GLSL_CONVERSION_FLAG_LAYOUT_OPENGL | KS_GLSL_CONVERSION_FLAG_LAYOUT_VULKAN ) ) != 0 )
+					{
+						out += sprintf( (char *)out, "layout( location = %d ) ", ksGltf_GetVertexAttributeLocation( technique, nameStart, nameEnd ) );
+					}
+					out = (unsigned char *)memcpy( out, "in", 2 ) + 2;
+					out = (unsigned char *)memcpy( out, " ", 1 ) + 1;
+					out = (unsigned char *)memcpy( out, typeStart, typeEnd - typeStart ) + ( typeEnd - typeStart );
+					out = (unsigned char *)memcpy( out, " ", 1 ) + 1;
+					out = (unsigned char *)memcpy( out, nameStart, nameEnd - nameStart ) + ( nameEnd - nameStart );
+					ptr = nameEnd;
+					continue;
+				}
+				if ( ksLexer_CaseSensitiveCompareToken( token, ptr, "varying" ) )
+				{
+					const unsigned char * typeStart;
+					const unsigned char * typeEnd = ksLexer_NextToken( source, ptr, &typeStart, NULL );
+					const unsigned char * nameStart;
+					const unsigned char * nameEnd = ksLexer_NextToken( source, typeEnd, &nameStart, NULL );
+					if ( ( conversion & ( KS_GLSL_CONVERSION_FLAG_LAYOUT_OPENGL | KS_GLSL_CONVERSION_FLAG_LAYOUT_VULKAN ) ) != 0 )
+					{
+						out += sprintf( (char *)out, "layout( location = %d ) ", *inOutParmCount );
+						inOutParms[(*inOutParmCount)].nameStart = nameStart;
+						inOutParms[(*inOutParmCount)].nameEnd = nameEnd;
+						inOutParms[(*inOutParmCount)].nameLength = nameEnd - nameStart;
+						(*inOutParmCount)++;
+					}
+					out = (unsigned char *)memcpy( out, "out", 3 ) + 3;
+					out = (unsigned char *)memcpy( out, " ", 1 ) + 1;
+					out = (unsigned char *)memcpy( out, typeStart, typeEnd - typeStart ) + ( typeEnd - typeStart );
+					out = (unsigned char *)memcpy( out, " ", 1 ) + 1;
+					out = (unsigned char *)memcpy( out, nameStart, nameEnd - nameStart ) + ( nameEnd - nameStart );
+					ptr = nameEnd;
+					continue;
+				}
+			}
+			else if ( stage == KS_GPU_PROGRAM_STAGE_FLAG_FRAGMENT )
+			{
+				if ( ksLexer_CaseSensitiveCompareToken( token, ptr, "varying" ) )
+				{
+					const unsigned char * typeStart;
+					const unsigned char * typeEnd = ksLexer_NextToken( source, ptr, &typeStart, NULL );
+					const unsigned char * nameStart;
+					const unsigned char * nameEnd = ksLexer_NextToken( source, typeEnd, &nameStart, NULL );
+					if ( ( conversion & ( KS_GLSL_CONVERSION_FLAG_LAYOUT_OPENGL | KS_GLSL_CONVERSION_FLAG_LAYOUT_VULKAN ) ) != 0 )
+					{
+						const size_t nameLength = nameEnd - nameStart;
+						int location = -1;
+						for ( int i = 0; i < *inOutParmCount; i++ )
+						{
+							if ( inOutParms[i].nameLength == nameLength &&
+									strncmp( (const char *)inOutParms[i].nameStart, (const char *)nameStart, nameLength ) == 0 )
+							{
+								location = i;
+								break;
+							}
+						}
+						assert( location >= 0 );
+						out += sprintf( (char *)out, "layout( location = %d ) ", location );
+					}
+					out = (unsigned char *)memcpy( out, "in", 2 ) + 2;
+					out = (unsigned char *)memcpy( out, " ", 1 ) + 1;
+					out = (unsigned char *)memcpy( out, typeStart, typeEnd - typeStart ) + ( typeEnd - typeStart );
+					out = (unsigned char *)memcpy( out, " ", 1 ) + 1;
+					out = (unsigned char *)memcpy( out, nameStart, nameEnd - nameStart ) + ( nameEnd - nameStart );
+					ptr = nameEnd;
+					continue;
+				}
+			}
+
+			// Strip uniforms that are no longer used, set stage flags and optionally add layout qualifiers.
+			if ( ksLexer_CaseSensitiveCompareToken( token, ptr, "uniform" ) )
+			{
+				const unsigned char * typeStart;
+				const unsigned char * typeEnd = ksLexer_NextToken( source, ptr, &typeStart, NULL );
+				const unsigned char * nameStart;
+				const unsigned char * nameEnd = ksLexer_NextToken( source, typeEnd, &nameStart, NULL );
+
+				// Strip uniforms that are no longer used.
+				if ( ksLexer_CaseSensitiveCompareToken( typeStart, typeEnd, "mat3" ) )
+				{
+					if ( ( conversion & ( KS_GLSL_CONVERSION_FLAG_VIEW_PROJECTION_BUFFER | KS_GLSL_CONVERSION_FLAG_MULTI_VIEW ) ) != 0 )
+					{
+						// Strip uniforms that are replaced by the view and projection matrices from the uniform buffer.
+						if (	ksLexer_CaseSensitiveCompareToken( nameStart, nameEnd, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE_TRANSPOSE] ) ||
+								ksLexer_CaseSensitiveCompareToken( nameStart, nameEnd, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_INVERSE_TRANSPOSE] ) )
+						{
+							assert( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX );
+							ptr = ksLexer_SkipUpToIncludingToken( source, nameEnd, ";" );
+							addSpace = 0;
+							continue;
+						}
+					}
+				}
+				else if ( ksLexer_CaseSensitiveCompareToken( typeStart, typeEnd, "mat4" ) )
+				{
+					if ( ( conversion & ( KS_GLSL_CONVERSION_FLAG_VIEW_PROJECTION_BUFFER | KS_GLSL_CONVERSION_FLAG_MULTI_VIEW ) ) != 0 )
+					{
+						// Strip uniforms that are replaced by the view and projection matrices from the uniform buffer.
+						if (	ksLexer_CaseSensitiveCompareToken( nameStart, nameEnd, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW] ) ||
+								ksLexer_CaseSensitiveCompareToken( nameStart, nameEnd, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE] ) ||
+								ksLexer_CaseSensitiveCompareToken( nameStart, nameEnd, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION] ) ||
+								ksLexer_CaseSensitiveCompareToken( nameStart, nameEnd, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION_INVERSE] ) ||
+								ksLexer_CaseSensitiveCompareToken( nameStart, nameEnd, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW] ) ||
+								ksLexer_CaseSensitiveCompareToken( nameStart, nameEnd, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_INVERSE] ) ||
+								ksLexer_CaseSensitiveCompareToken( nameStart, nameEnd, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_PROJECTION] ) )
+						{
+							assert( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX );
+							ptr = ksLexer_SkipUpToIncludingToken( source, nameEnd, ";" );
+							addSpace = 0;
+							continue;
+						}
+					}
+
+					if ( ( conversion & KS_GLSL_CONVERSION_FLAG_JOINT_BUFFER ) != 0 )
+					{
+						// Strip the joint uniform array.
+						if ( ksLexer_CaseSensitiveCompareToken( nameStart, nameEnd, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_JOINT_ARRAY] ) )
+						{
+							assert( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX );
+							ptr = ksLexer_SkipUpToIncludingToken( source, nameEnd, ";" );
+							addSpace = 0;
+							continue;
+						}
+					}
+				}
+
+				ksGltf_SetUniformStageFlag( technique, nameStart, nameEnd, stage );
+
+				// Optionally add layout qualifiers.
 				if ( ( conversion & KS_GLSL_CONVERSION_FLAG_LAYOUT_OPENGL ) != 0 )
 				{
-					out += sprintf( (char *)out, "layout( location = %d ) ", ksGltf_GetUniformBinding( technique, nameStart, nameEnd ) );
+					out += sprintf( (char *)out, "layout( location = %d ) ", ksGltf_GetUniformBinding( technique, nameStart, nameEnd ) );
+				}
+				else if ( ( conversion & KS_GLSL_CONVERSION_FLAG_LAYOUT_VULKAN ) != 0 )
+				{
+					if ( ksLexer_CaseSensitiveCompareToken( typeStart, typeEnd, "sampler2D" ) ||
+						ksLexer_CaseSensitiveCompareToken( typeStart, typeEnd, "samplerCube" ) )
+					{
+						out += sprintf( (char *)out, "layout( location = %d ) ", ksGltf_GetUniformBinding( technique, nameStart, nameEnd ) );
+					}
+					else
+					{
+						// Push constants are declared in the push constant block.
+						ptr = ksLexer_SkipUpToIncludingToken( source, nameEnd, ";" );
+						addSpace = 0;
+						continue;
+					}
+				}
+
+				out = (unsigned char *)memcpy( out, token, ptr - token ) + ( ptr - token );
+				out = (unsigned char *)memcpy( out, " ", 1 ) + 1;
+				out = (unsigned char *)memcpy( out, typeStart, typeEnd - typeStart ) + ( typeEnd - typeStart );
+				out = (unsigned char *)memcpy( out, " ", 1 ) + 1;
+				out = (unsigned char *)memcpy( out, nameStart, nameEnd - nameStart ) + ( nameEnd - nameStart );
+				ptr = nameEnd;
+				continue;
+			}
+
+			// Optionally replace uniform usage.
+			if ( ( conversion & ( KS_GLSL_CONVERSION_FLAG_VIEW_PROJECTION_BUFFER | KS_GLSL_CONVERSION_FLAG_MULTI_VIEW ) ) != 0 )
+			{
+				if ( ksLexer_CaseSensitiveCompareToken( token, ptr, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE_TRANSPOSE] ) )
+				{
+					assert( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX );
+					out += sprintf( (char *)out, "transpose( mat3( %s%s ) )",
+							pushConstantInstanceName, newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE] );
+					ksGltf_SetUniformStageFlag( technique, (const unsigned char *)newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE], NULL, stage );
+					continue;
+				}
+				if ( ksLexer_CaseSensitiveCompareToken( token, ptr, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW] ) )
+				{
+					assert( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX );
+					out += sprintf( (char *)out, "%s%s",
+							newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW], multiviewArrayIndexString );
+					continue;
+				}
+				if ( ksLexer_CaseSensitiveCompareToken( token, ptr, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE] ) )
+				{
+					assert( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX );
+					out += sprintf( (char *)out, "%s%s",
+							newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE], multiviewArrayIndexString );
+					continue;
+				}
+				if ( ksLexer_CaseSensitiveCompareToken( token, ptr, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION] ) )
+				{
+					assert( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX );
+					out += sprintf( (char *)out, "%s%s",
+							newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION], multiviewArrayIndexString );
+					continue;
+				}
+				if ( ksLexer_CaseSensitiveCompareToken( token, ptr, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION_INVERSE] ) )
+				{
+					assert( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX );
+					out += sprintf( (char *)out, "%s%s",
+							newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION_INVERSE], multiviewArrayIndexString );
+					continue;
+				}
+				if ( ksLexer_CaseSensitiveCompareToken( token, ptr, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW] ) )
+				{
+					assert( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX );
+					out += sprintf( (char *)out, "%s%s * %s%s",
+							newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW], multiviewArrayIndexString,
+							pushConstantInstanceName, newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL] );
+					ksGltf_SetUniformStageFlag( technique, (const unsigned char *)newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL], NULL, stage );
+					continue;
+				}
+				if ( ksLexer_CaseSensitiveCompareToken( token, ptr, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_INVERSE] ) )
+				{
+					assert( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX );
+					out += sprintf( (char *)out, "%s%s * %s%s",
+							newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE], multiviewArrayIndexString,
+							pushConstantInstanceName, newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE] );
+					ksGltf_SetUniformStageFlag( technique, (const unsigned char *)newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE], NULL, stage );
+					continue;
+				}
+				if ( ksLexer_CaseSensitiveCompareToken( token, ptr, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_INVERSE_TRANSPOSE] ) )
+				{
+					assert( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX );
+					out += sprintf( (char *)out, "transpose( mat3( %s%s ) ) * transpose( mat3( %s%s ) )",
+							newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE], multiviewArrayIndexString,
+							pushConstantInstanceName, newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE] );
+					ksGltf_SetUniformStageFlag( technique, (const unsigned char *)newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE], NULL, stage );
+					continue;
+				}
+				if ( ksLexer_CaseSensitiveCompareToken( token, ptr, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_PROJECTION] ) )
+				{
+					assert( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX );
+					out += sprintf( (char *)out, "%s%s * %s%s * %s%s",
+							newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION], multiviewArrayIndexString,
+							newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW], multiviewArrayIndexString,
+							pushConstantInstanceName, newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL] );
+					ksGltf_SetUniformStageFlag( technique, (const unsigned char *)newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL], NULL, stage );
+					continue;
+				}
+				if ( ksLexer_CaseSensitiveCompareToken( token, ptr, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_PROJECTION_INVERSE] ) )
+				{
+					assert( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX );
+					out += sprintf( (char *)out, "%s%s * %s%s * %s%s",
+							newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION_INVERSE], multiviewArrayIndexString,
+							newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE], multiviewArrayIndexString,
+							pushConstantInstanceName, newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE] );
+					ksGltf_SetUniformStageFlag( technique, (const unsigned char *)newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE], NULL, stage );
+					continue;
+				}
+
+				// Pre-multiplied node transform with semantic transform.
+				bool found = false;
+				for ( int i = 0; i < technique->uniformCount; i++ )
+				{
+					if ( technique->uniforms[i].nodeName != NULL && technique->uniforms[i].semantic != GLTF_UNIFORM_SEMANTIC_NONE &&
+							ksLexer_CaseSensitiveCompareToken( token, ptr, technique->parms[i].name ) )
+					{
+						assert( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX );
+						switch ( technique->uniforms[i].semantic )
+						{
+							case GLTF_UNIFORM_SEMANTIC_VIEW:
+								out += sprintf( (char *)out, "%s%s * %s%s",
+									newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW], multiviewArrayIndexString,
+									pushConstantInstanceName, technique->parms[i].name );
+								found = true;
+								break;
+							case GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE:
+								out += sprintf( (char *)out, "%s%s * %s%s",
+										newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE], multiviewArrayIndexString,
+										pushConstantInstanceName, technique->parms[i].name );
+								found = true;
+								break;
+							case GLTF_UNIFORM_SEMANTIC_PROJECTION:
+								out += sprintf( (char *)out, "%s%s * %s%s",
+										newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION], multiviewArrayIndexString,
+										pushConstantInstanceName, technique->parms[i].name );
+								found = true;
+								break;
+							case GLTF_UNIFORM_SEMANTIC_PROJECTION_INVERSE:
+								out += sprintf( (char *)out, "%s%s * %s%s",
+										newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION_INVERSE], multiviewArrayIndexString,
+										pushConstantInstanceName, technique->parms[i].name );
+								found = true;
+								break;
+							case GLTF_UNIFORM_SEMANTIC_MODEL:
+								out += sprintf( (char *)out, "%s * %s%s",
+										newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL],
+										pushConstantInstanceName, technique->parms[i].name );
+								found = true;
+								break;
+							case GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE:
+								out += sprintf( (char *)out, "%s * %s%s",
+										newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE],
+										pushConstantInstanceName, technique->parms[i].name );
+								found = true;
+								break;
+							case GLTF_UNIFORM_SEMANTIC_MODEL_VIEW:
+								out += sprintf( (char *)out, "%s%s * %s%s * %s%s",
+										newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW], multiviewArrayIndexString,
+										pushConstantInstanceName, newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL],
+										pushConstantInstanceName, technique->parms[i].name );
+								ksGltf_SetUniformStageFlag( technique, (const unsigned char *)newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL], NULL, stage );
+								found = true;
+								break;
+							case GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_INVERSE:
+								out += sprintf( (char *)out, "%s%s * %s%s * %s%s",
+										newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE], multiviewArrayIndexString,
+										pushConstantInstanceName, newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE],
+										pushConstantInstanceName, technique->parms[i].name );
+								ksGltf_SetUniformStageFlag( technique, (const unsigned char *)newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE], NULL, stage );
+								found = true;
+								break;
+							case GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_PROJECTION:
+								out += sprintf( (char *)out, "%s%s * %s%s * %s%s * %s%s",
+										newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION], multiviewArrayIndexString,
+										newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW], multiviewArrayIndexString,
+										pushConstantInstanceName, newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL],
+										pushConstantInstanceName, technique->parms[i].name );
+								ksGltf_SetUniformStageFlag( technique, (const unsigned char *)newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL], NULL, stage );
+								found = true;
+								break;
+							case GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_PROJECTION_INVERSE:
+								out += sprintf( (char *)out, "%s%s * %s%s * %s%s * %s%s",
+										newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION_INVERSE], multiviewArrayIndexString,
+										newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE], multiviewArrayIndexString,
+										pushConstantInstanceName, newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE],
+										pushConstantInstanceName, technique->parms[i].name );
+								ksGltf_SetUniformStageFlag( technique, (const unsigned char *)newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE], NULL, stage );
+								found = true;
+								break;
+							default:
+								out += sprintf( (char *)out, "%s%s", pushConstantInstanceName, technique->parms[i].name );
+								found = true;
+								break;
+						}
+						ksGltf_SetUniformStageFlag( technique, (const unsigned char *)technique->parms[i].name, NULL, stage );
+						break;
+					}
+				}
+				if ( found )
+				{
+					continue;
+				}
+			}
+
+			// Pre-append the push constant block instance name to push constants names.
+			if ( ( conversion & KS_GLSL_CONVERSION_FLAG_LAYOUT_VULKAN ) != 0 )
+			{
+				bool found = false;
+				for ( int i = 0; i < technique->uniformCount; i++ )
+				{
+					const int size = ksGpuProgramParm_GetPushConstantSize( technique->parms[i].type );
+					if ( size > 0 )
+					{
+						if ( ksLexer_CaseSensitiveCompareToken( token, ptr, technique->parms[i].name ) )
+						{
+							out += sprintf( (char *)out, "%s%s", pushConstantInstanceName, technique->parms[i].name );
+							found = true;
+							break;
+						}
+					}
+				}
+				if ( found )
+				{
+					ksGltf_SetUniformStageFlag( technique, token, ptr, stage );
+					continue;
+				}
+			}
+
+			// Replace gl_FragColor.
+			if ( stage == KS_GPU_PROGRAM_STAGE_FLAG_FRAGMENT )
+			{
+				if ( ksLexer_CaseSensitiveCompareToken( token, ptr, "gl_FragColor" ) )
+				{
+					out = (unsigned char *)memcpy( out, "fragColor", 9 ) + 9;
+					continue;
+				}
+			}
+
+			if (	ksLexer_CaseSensitiveCompareToken( token, ptr, "texture1D" ) ||
+					ksLexer_CaseSensitiveCompareToken( token, ptr, "texture2D" ) ||
+					ksLexer_CaseSensitiveCompareToken( token, ptr, "texture3D" ) ||
+					ksLexer_CaseSensitiveCompareToken( token, ptr, "textureCube" ) ||
+					ksLexer_CaseSensitiveCompareToken( token, ptr, "shadow1D" ) ||
+					ksLexer_CaseSensitiveCompareToken( token, ptr, "shadow2D" ) )
+			{
+				out = (unsigned char *)memcpy( out, "texture", 7 ) + 7;
+				continue;
+			}
+
+			if (	ksLexer_CaseSensitiveCompareToken( token, ptr, "texture1DProj" ) ||
+					ksLexer_CaseSensitiveCompareToken( token, ptr, "texture2DProj" ) ||
+					ksLexer_CaseSensitiveCompareToken( token, ptr, "texture3DProj" ) ||
+					ksLexer_CaseSensitiveCompareToken( token, ptr, "shadow1DProj" ) ||
+					ksLexer_CaseSensitiveCompareToken( token, ptr, "shadow2DProj" ) )
+			{
+				out = (unsigned char *)memcpy( out, "textureProj", 11 ) + 11;
+				continue;
+			}
+
+			if (	ksLexer_CaseSensitiveCompareToken( token, ptr, "texture1DLod" ) ||
+					ksLexer_CaseSensitiveCompareToken( token, ptr, "texture2DLod" ) ||
+					ksLexer_CaseSensitiveCompareToken( token, ptr, "texture3DLod" ) ||
+					ksLexer_CaseSensitiveCompareToken( token, ptr, "textureCubeLod" ) ||
+					ksLexer_CaseSensitiveCompareToken( token, ptr, "shadow1DLod" ) ||
+					ksLexer_CaseSensitiveCompareToken( token, ptr, "shadow2DLod" ) )
+			{
+				out = (unsigned char *)memcpy( out, "textureLod", 10 ) + 10;
+				continue;
+			}
+
+			if (	ksLexer_CaseSensitiveCompareToken( token, ptr, "texture1DProjLod" ) ||
+					ksLexer_CaseSensitiveCompareToken( token, ptr, "texture2DProjLod" ) ||
+					ksLexer_CaseSensitiveCompareToken( token, ptr, "texture3DProjLod" ) ||
+					ksLexer_CaseSensitiveCompareToken( token, ptr, "shadow1DProjLod" ) ||
+					ksLexer_CaseSensitiveCompareToken( token, ptr, "shadow2DProjLod" ) )
+			{
+				out = (unsigned char *)memcpy( out, "textureProjLod", 14 ) + 14;
+				continue;
+			}
+		}
+
+		out = (unsigned char *)memcpy( out, token, ptr - token ) + ( ptr - token );
+	}
+
+	*out++ = '\0';
+	*sourceSize = ( out - newSource );
+
+	return newSource;
+}
+
+#endif
+
+// The shaders of a technique are converted on a worker thread and the graphics program is
+// created afterwards on the thread that owns the graphics context.
+typedef struct
+{
+	ksGltfTechnique *			technique;
+	const ksGltfProgram *		program;
+	int							conversion;
+	const char *				semanticUniforms[GLTF_UNIFORM_SEMANTIC_MAX];
+	unsigned char *				vertexSource;		// converted vertex shader, NULL if not converted
+	size_t						vertexSourceSize;
+	unsigned char *				fragmentSource;		// converted fragment shader, NULL if not converted
+	size_t						fragmentSourceSize;
+} ksGltfTechniqueProgram;
+
+// Only the technique is modified, so different techniques can be converted concurrently.
+void ksGltf_ConvertTechniqueProgram( ksGltfTechniqueProgram * techniqueProgram )
+{
+	ksGltfTechnique * technique = techniqueProgram->technique;
+	const ksGltfProgram * program = techniqueProgram->program;
+	const int conversion = techniqueProgram->conversion;
+	const char ** semanticUniforms = techniqueProgram->semanticUniforms;
+
+	techniqueProgram->vertexSource = NULL;
+	techniqueProgram->fragmentSource = NULL;
+
+#if GRAPHICS_API_OPENGL == 1 || GRAPHICS_API_OPENGL_ES == 1 || GRAPHICS_API_VULKAN == 1
+	if ( conversion != KS_GLSL_CONVERSION_NONE )
+	{
+		const char * newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MAX] = { 0 };
+
+		// Update / replace technique uniforms.
+		{
+			// At most three new uniforms are added.
+			ksGpuProgramParm * newParms = (ksGpuProgramParm *) calloc( technique->uniformCount + 3, sizeof( ksGpuProgramParm ) );
+			ksGltfUniform * newUniforms = (ksGltfUniform *) calloc( technique->uniformCount + 3, sizeof( ksGltfUniform ) );
+			int newUniformCount = 0;
+
+			if ( ( conversion & KS_GLSL_CONVERSION_FLAG_JOINT_BUFFER ) != 0 )
+			{
+				// Optionally add a joint uniform buffer.
+				if ( semanticUniforms[GLTF_UNIFORM_SEMANTIC_JOINT_ARRAY] != NULL )
+				{
+					newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_JOINT_BUFFER] = JOINT_UNIFORM_BUFFER_NAME;
+
+					newParms[newUniformCount].stageFlags = 0;	// Set when converting the shader.
+					newParms[newUniformCount].type = KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM;
+					newParms[newUniformCount].access = KS_GPU_PROGRAM_PARM_ACCESS_READ_ONLY;
+					newParms[newUniformCount].index = newUniformCount;
+					newParms[newUniformCount].name = ksGltf_strdup( JOINT_UNIFORM_BUFFER_NAME );
+					newParms[newUniformCount].binding = 0;	// Set when adding layout qualitifiers.
+
+					newUniforms[newUniformCount].name = ksGltf_strdup( JOINT_UNIFORM_BUFFER_NAME );
+					newUniforms[newUniformCount].semantic = GLTF_UNIFORM_SEMANTIC_JOINT_BUFFER;
+					newUniforms[newUniformCount].type = KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM;
+					newUniforms[newUniformCount].index = newUniformCount;
+
+					newUniformCount++;
+				}
+			}
+
+			if ( ( conversion & ( KS_GLSL_CONVERSION_FLAG_VIEW_PROJECTION_BUFFER | KS_GLSL_CONVERSION_FLAG_MULTI_VIEW ) ) != 0 )
+			{
+				const bool multiview = ( conversion & KS_GLSL_CONVERSION_FLAG_MULTI_VIEW ) != 0;
+
+				// Optionally add a view-projection or multi-view uniform buffer.
+				if (	semanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW] != NULL ||
+						semanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE] != NULL ||
+						semanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION] != NULL ||
+						semanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION_INVERSE] != NULL ||
+						semanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW] != NULL ||
+						semanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_INVERSE] != NULL ||
+						semanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_INVERSE_TRANSPOSE] != NULL ||
+						semanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_PROJECTION] != NULL ||
+						semanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_PROJECTION_INVERSE] != NULL )
+				{
+					newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW]					=	semanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW] != NULL ?
+																						semanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW] : "u_viewMatrix";
+					newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE]			=	semanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE] != NULL ?
+																						semanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE] : "u_viewInverseMatrix";
+					newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION]			=	semanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION] != NULL ?
+																						semanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION] : "u_projectionMatrix";
+					newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION_INVERSE]	=	semanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION_INVERSE] != NULL ?
+																						semanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION_INVERSE] : "u_projectionInverseMatrix";
+
+					newParms[newUniformCount].stageFlags = 0;	// Set when converting the shader.
+					newParms[newUniformCount].type = KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM;
+					newParms[newUniformCount].access = KS_GPU_PROGRAM_PARM_ACCESS_READ_ONLY;
+					newParms[newUniformCount].index = newUniformCount;
+					newParms[newUniformCount].name = ksGltf_strdup( multiview ? VIEW_PROJECTION_MULTI_VIEW_UNIFORM_BUFFER_NAME : VIEW_PROJECTION_UNIFORM_BUFFER_NAME );
+					newParms[newUniformCount].binding = 0;	// Set when adding layout qualitifiers.
+
+					newUniforms[newUniformCount].name = ksGltf_strdup( multiview ? VIEW_PROJECTION_MULTI_VIEW_UNIFORM_BUFFER_NAME : VIEW_PROJECTION_UNIFORM_BUFFER_NAME );
+					newUniforms[newUniformCount].semantic = multiview ? GLTF_UNIFORM_SEMANTIC_VIEW_PROJECTION_MULTI_VIEW_BUFFER : GLTF_UNIFORM_SEMANTIC_VIEW_PROJECTION_BUFFER;
+					newUniforms[newUniformCount].type = KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM;
+					newUniforms[newUniformCount].index = newUniformCount;
+
+					newUniformCount++;
+				}
+
+				// Optionally add a model matrix uniform.
+				if (	semanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL] != NULL ||
+						semanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW] != NULL ||
+						semanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_PROJECTION] != NULL )
+				{
+					newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL]	=	semanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL] != NULL ?
+																			semanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL] : "u_modelMatrix";
+					if ( semanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL] == NULL )
+					{
+						newParms[newUniformCount].stageFlags = 0;	// Set when converting the shader.
+						newParms[newUniformCount].type = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX4X4;
+						newParms[newUniformCount].access = KS_GPU_PROGRAM_PARM_ACCESS_READ_ONLY;
+						newParms[newUniformCount].index = newUniformCount;
+						newParms[newUniformCount].name = ksGltf_strdup( newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL] );
+						newParms[newUniformCount].binding = 0;	// Set when adding layout qualitifiers.
+
+						newUniforms[newUniformCount].name = ksGltf_strdup( newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL] );
+						newUniforms[newUniformCount].semantic = GLTF_UNIFORM_SEMANTIC_MODEL;
+						newUniforms[newUniformCount].type = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX4X4;
+						newUniforms[newUniformCount].index = newUniformCount;
+
+						newUniformCount++;
+					}
+				}
+
+				// Optionally add an inverse model matrix uniform.
+				if (	semanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE] != NULL ||
+						semanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE_TRANSPOSE] != NULL ||
+						semanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_INVERSE] != NULL ||
+						semanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_INVERSE_TRANSPOSE] != NULL ||
+						semanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_PROJECTION_INVERSE] != NULL )
+				{
+					newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE]	=	semanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE] != NULL ?
+																					semanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE] : "u_modelInverseMatrix";
+					if ( semanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE] == NULL )
+					{
+						newParms[newUniformCount].stageFlags = 0;	// Set when converting the shader.
+						newParms[newUniformCount].type = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX4X4;
+						newParms[newUniformCount].access = KS_GPU_PROGRAM_PARM_ACCESS_READ_ONLY;
+						newParms[newUniformCount].index = newUniformCount;
+						newParms[newUniformCount].name = ksGltf_strdup( newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE] );
+						newParms[newUniformCount].binding = 0;	// Set when adding layout qualitifiers.
+
+						newUniforms[newUniformCount].name = ksGltf_strdup( newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE] );
+						newUniforms[newUniformCount].semantic = GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE;
+						newUniforms[newUniformCount].type = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX4X4;
+						newUniforms[newUniformCount].index = newUniformCount;
+
+						newUniformCount++;
+					}
+				}
+			}
+
+			// Maintain any uniforms that are still used after the conversion to uniform buffers.
+			for ( int uniformIndex = 0; uniformIndex < technique->uniformCount; uniformIndex++ )
+			{
+				if ( ( conversion & KS_GLSL_CONVERSION_FLAG_JOINT_BUFFER ) != 0 )
+				{
+					if ( technique->uniforms[uniformIndex].semantic == GLTF_UNIFORM_SEMANTIC_JOINT_ARRAY )
+					{
+						free( (void *)technique->parms[uniformIndex].name );
+						free( technique->uniforms[uniformIndex].name );
+						continue;
+					}
+				}
+				if ( ( conversion & ( KS_GLSL_CONVERSION_FLAG_VIEW_PROJECTION_BUFFER | KS_GLSL_CONVERSION_FLAG_MULTI_VIEW ) ) != 0 )
+				{
+					if (	technique->uniforms[uniformIndex].semantic == GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE_TRANSPOSE ||
+							technique->uniforms[uniformIndex].semantic == GLTF_UNIFORM_SEMANTIC_VIEW ||
+							technique->uniforms[uniformIndex].semantic == GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE ||
+							technique->uniforms[uniformIndex].semantic == GLTF_UNIFORM_SEMANTIC_PROJECTION ||
+							technique->uniforms[uniformIndex].semantic == GLTF_UNIFORM_SEMANTIC_PROJECTION_INVERSE ||
+							technique->uniforms[uniformIndex].semantic == GLTF_UNIFORM_SEMANTIC_MODEL_VIEW ||
+							technique->uniforms[uniformIndex].semantic == GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_INVERSE ||
+							technique->uniforms[uniformIndex].semantic == GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_INVERSE_TRANSPOSE ||
+							technique->uniforms[uniformIndex].semantic == GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_PROJECTION ||
+							technique->uniforms[uniformIndex].semantic == GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_PROJECTION_INVERSE )
+					{
+						if ( technique->uniforms[uniformIndex].nodeName == NULL )
+						{
+							free( (void *)technique->parms[uniformIndex].name );
+							free( technique->uniforms[uniformIndex].name );
+							continue;
+						}
+					}
+				}
+
+				newParms[newUniformCount].stageFlags = 0;	// Set when converting the shader.
+				newParms[newUniformCount].type = technique->parms[uniformIndex].type;
+				newParms[newUniformCount].access = technique->parms[uniformIndex].access;
+				newParms[newUniformCount].index = newUniformCount;
+				newParms[newUniformCount].name = technique->parms[uniformIndex].name;
+				newParms[newUniformCount].binding = 0;	// Set when adding layout qualitifiers.
+
+				memcpy( &newUniforms[newUniformCount], &technique->uniforms[uniformIndex], sizeof( ksGltfUniform ) );
+				newUniforms[newUniformCount].index = newUniformCount;
+
+				newUniformCount++;
+			}
+
+			if ( ( conversion & KS_GLSL_CONVERSION_FLAG_LAYOUT_OPENGL ) != 0 )
+			{
+				// Set OpenGL layout bindings / locations.
+				int numSampledTextureBindings = 0;
+				int numStorageTextureBindings = 0;
+				int numUniformBufferBindings = 0;
+				int numStorageBufferBindings = 0;
+				int numUniformLocations = 0;
+
+				for ( int uniformIndex = 0; uniformIndex < newUniformCount; uniformIndex++ )
+				{
+					if ( newParms[uniformIndex].type == KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_SAMPLED )
+					{
+						newParms[uniformIndex].binding = numSampledTextureBindings++;
+					}
+					else if ( newParms[uniformIndex].type == KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_STORAGE )
+					{
+						newParms[uniformIndex].binding = numStorageTextureBindings++;
+					}
+					else if ( newParms[uniformIndex].type == KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM )
+					{
+						newParms[uniformIndex].binding = numUniformBufferBindings++;
+					}
+					else if ( newParms[uniformIndex].type == KS_GPU_PROGRAM_PARM_TYPE_BUFFER_STORAGE )
+					{
+						newParms[uniformIndex].binding = numStorageBufferBindings++;
+					}
+					else
+					{
+						newParms[uniformIndex].binding = numUniformLocations++;
+					}
 				}
-				else if ( ( conversion & KS_GLSL_CONVERSION_FLAG_LAYOUT_VULKAN ) != 0 )
+			}
+			else if ( ( conversion & KS_GLSL_CONVERSION_FLAG_LAYOUT_VULKAN ) != 0 )
+			{
+				// Set Vulkan layout bindings / push constant offsets.
+				int numOpaqueBindings = 0;
+				int pushConstantOffset = 0;
+
+				for ( int uniformIndex = 0; uniformIndex < newUniformCount; uniformIndex++ )
 				{
-					if ( ksLexer_CaseSensitiveCompareToken( typeStart, typeEnd, "sampler2D" ) ||
-						ksLexer_CaseSensitiveCompareToken( typeStart, typeEnd, "samplerCube" ) )
+					if ( ksGpuProgramParm_IsOpaqueBinding( newParms[uniformIndex].type ) )
 					{
-						out += sprintf( (char *)out, "layout( location = %d ) ", ksGltf_GetUniformBinding( technique, nameStart, nameEnd ) );
+						newParms[uniformIndex].binding = numOpaqueBindings++;
 					}
 					else
 					{
-						// Push constants are declared in the push constant block.
-						ptr = ksLexer_SkipUpToIncludingToken( source, nameEnd, ";" );
-						addSpace = 0;
-						continue;
+						newParms[uniformIndex].binding = pushConstantOffset;
+						pushConstantOffset += ksGpuProgramParm_GetPushConstantSize( newParms[uniformIndex].type );
 					}
 				}
+			}
+
+			free( technique->parms );
+			free( technique->uniforms );
+
+			technique->parms = newParms;
+			technique->uniforms = newUniforms;
+			technique->uniformCount = newUniformCount;
+		}
+
+		ksGltfInOutParm inOutParms[16];
+		int inOutParmCount = 0;
+
+		techniqueProgram->vertexSourceSize = program->vertexSourceSize;
+		techniqueProgram->fragmentSourceSize = program->fragmentSourceSize;
+
+		techniqueProgram->vertexSource = ksGltf_ConvertShaderGLSL( program->vertexSource, &techniqueProgram->vertexSourceSize, KS_GPU_PROGRAM_STAGE_FLAG_VERTEX, conversion,
+																	technique, semanticUniforms, newSemanticUniforms, inOutParms, &inOutParmCount );
+		techniqueProgram->fragmentSource = ksGltf_ConvertShaderGLSL( program->fragmentSource, &techniqueProgram->fragmentSourceSize, KS_GPU_PROGRAM_STAGE_FLAG_FRAGMENT, conversion,
+																	technique, semanticUniforms, newSemanticUniforms, inOutParms, &inOutParmCount );
+
+		for ( int uniformIndex = 0; uniformIndex < technique->uniformCount; uniformIndex++ )
+		{
+			assert( technique->parms[uniformIndex].stageFlags != 0 );
+		}
+	}
+#else
+	UNUSED_PARM( technique );
+	UNUSED_PARM( program );
+	UNUSED_PARM( conversion );
+	UNUSED_PARM( semanticUniforms );
+#endif
+}
+
+void ksGltf_CreateTechniqueProgram( ksGpuContext * context, ksGltfTechniqueProgram * techniqueProgram )
+{
+	ksGltfTechnique * technique = techniqueProgram->technique;
+	const ksGltfProgram * program = techniqueProgram->program;
+
+	if ( techniqueProgram->vertexSource != NULL && techniqueProgram->fragmentSource != NULL )
+	{
+		ksGpuGraphicsProgram_Create( context, &technique->program,
+									techniqueProgram->vertexSource, techniqueProgram->vertexSourceSize,
+									techniqueProgram->fragmentSource, techniqueProgram->fragmentSourceSize,
+									technique->parms, technique->uniformCount,
+									technique->vertexAttributeLayout, technique->vertexAttribsFlags );
+	}
+	else
+	{
+		ksGpuGraphicsProgram_Create( context, &technique->program,
+									program->vertexSource, program->vertexSourceSize,
+									program->fragmentSource, program->fragmentSourceSize,
+									technique->parms, technique->uniformCount,
+									technique->vertexAttributeLayout, technique->vertexAttribsFlags );
+	}
+
+	free( techniqueProgram->vertexSource );
+	free( techniqueProgram->fragmentSource );
+	techniqueProgram->vertexSource = NULL;
+	techniqueProgram->fragmentSource = NULL;
+}
+
+static ksGltfUniform * ksGltf_FindUniform( const ksGltfTechnique * technique, const char * name )
+{
+	for ( int uniformIndex = 0; uniformIndex < technique->uniformCount; uniformIndex++ )
+	{
+		if ( strcmp( technique->uniforms[uniformIndex].name, name ) == 0 )
+		{
+			return &technique->uniforms[uniformIndex];
+		}
+	}
+	return NULL;
+}
+
+// Set the uniforms of the built-in pbrMetallicRoughness technique from a glTF 2.0 material.
+// The last texture of a glTF 2.0 scene is white and is used when there is no base color texture.
+static void ksGltf_ParsePbrMetallicRoughness( ksGltfMaterial * material, const ksJson * json, const ksGltfScene * scene )
+{
+	const ksJson * pbrMetallicRoughness = ksJson_GetMemberByName( json, "pbrMetallicRoughness" );
+	const ksJson * baseColorFactor = ksJson_GetMemberByName( pbrMetallicRoughness, "baseColorFactor" );
+	const ksJson * baseColorTexture = ksJson_GetMemberByName( ksJson_GetMemberByName( pbrMetallicRoughness, "baseColorTexture" ), "index" );
+
+	material->valueCount = 5;
+	material->values = (ksGltfMaterialValue *) calloc( material->valueCount, sizeof( ksGltfMaterialValue ) );
+
+	material->values[0].uniform = ksGltf_FindUniform( material->technique, "baseColorFactor" );
+	if ( baseColorFactor != NULL )
+	{
+		ksGltf_ParseFloatArray( material->values[0].value.floatValue, 4, baseColorFactor );
+	}
+	else
+	{
+		for ( int i = 0; i < 4; i++ )
+		{
+			material->values[0].value.floatValue[i] = 1.0f;
+		}
+	}
+
+	material->values[1].uniform = ksGltf_FindUniform( material->technique, "metallicFactor" );
+	material->values[1].value.floatValue[0] = ksJson_GetFloat( ksJson_GetMemberByName( pbrMetallicRoughness, "metallicFactor" ), 1.0f );
+
+	material->values[2].uniform = ksGltf_FindUniform( material->technique, "roughnessFactor" );
+	material->values[2].value.floatValue[0] = ksJson_GetFloat( ksJson_GetMemberByName( pbrMetallicRoughness, "roughnessFactor" ), 1.0f );
+
+	material->values[3].uniform = ksGltf_FindUniform( material->technique, "emissiveFactor" );
+	ksGltf_ParseFloatArray( material->values[3].value.floatValue, 3, ksJson_GetMemberByName( json, "emissiveFactor" ) );
+
+	material->values[4].uniform = ksGltf_FindUniform( material->technique, "baseColorTexture" );
+	material->values[4].value.texture = ksGltf_GetTextureByReference( scene, baseColorTexture );
+	if ( material->values[4].value.texture == NULL )
+	{
+		material->values[4].value.texture = &scene->textures[scene->textureCount - 1];
+	}
+
+	for ( int valueIndex = 0; valueIndex < material->valueCount; valueIndex++ )
+	{
+		assert( material->values[valueIndex].uniform != NULL );
+	}
+}
+
+static void ksGltf_CreateWhiteTexture( ksGpuContext * context, ksGpuTexture * texture )
+{
+	const uint32_t white = 0xFFFFFFFF;
+	ksGpuTexture_Create2D( context, texture, KS_GPU_TEXTURE_FORMAT_R8G8B8A8_UNORM, KS_GPU_SAMPLE_COUNT_1, 1, 1, 1,
+							KS_GPU_TEXTURE_USAGE_SAMPLED, &white, sizeof( white ) );
+}
+
+// Sort the nodes such that parents come before their children and every sub-tree is a contiguous sequence of nodes.
+// Note that the node graph must be acyclic and no node may be a direct or indirect descendant of more than one node.
+// The child indices are remapped to the sorted order and nodeIndexRemap maps each original node index to its sorted index.
+static void ksGltf_SortNodes( ksGltfNode * nodes, const int nodeCount, int * nodeIndexRemap )
+{
+	bool * hasParent = (bool *) calloc( nodeCount, sizeof( bool ) );
+	for ( int nodeIndex = 0; nodeIndex < nodeCount; nodeIndex++ )
+	{
+		for ( int childIndex = 0; childIndex < nodes[nodeIndex].childCount; childIndex++ )
+		{
+			hasParent[nodes[nodeIndex].childIndices[childIndex]] = true;
+		}
+	}
+
+	int * sortedOrder = (int *) malloc( nodeCount * sizeof( int ) );
+	int stackSize = 0;
+	int stackOffset = 0;
+	for ( int nodeIndex = 0; nodeIndex < nodeCount; nodeIndex++ )
+	{
+		if ( hasParent[nodeIndex] )
+		{
+			continue;
+		}
+		const int subTreeStartOffset = stackSize;
+		sortedOrder[stackSize++] = nodeIndex;
+		while( stackOffset < stackSize )
+		{
+			const ksGltfNode * node = &nodes[sortedOrder[stackOffset++]];
+			for ( int childIndex = 0; childIndex < node->childCount; childIndex++ )
+			{
+				assert( stackSize < nodeCount );
+				sortedOrder[stackSize++] = node->childIndices[childIndex];
+			}
+		}
+		for ( int updateNodeIndex = subTreeStartOffset; updateNodeIndex < stackSize; updateNodeIndex++ )
+		{
+			nodes[sortedOrder[updateNodeIndex]].subTreeNodeCount = stackSize - updateNodeIndex;
+		}
+	}
+	assert( stackSize == nodeCount );
+	free( hasParent );
+
+	ksGltfNode * sortedNodes = (ksGltfNode *) malloc( nodeCount * sizeof( ksGltfNode ) );
+	for ( int sortedIndex = 0; sortedIndex < nodeCount; sortedIndex++ )
+	{
+		sortedNodes[sortedIndex] = nodes[sortedOrder[sortedIndex]];
+		nodeIndexRemap[sortedOrder[sortedIndex]] = sortedIndex;
+	}
+	for ( int nodeIndex = 0; nodeIndex < nodeCount; nodeIndex++ )
+	{
+		for ( int childIndex = 0; childIndex < sortedNodes[nodeIndex].childCount; childIndex++ )
+		{
+			sortedNodes[nodeIndex].childIndices[childIndex] = nodeIndexRemap[sortedNodes[nodeIndex].childIndices[childIndex]];
+		}
+	}
+	memcpy( nodes, sortedNodes, nodeCount * sizeof( nodes[0] ) );
+	free( sortedNodes );
+	free( sortedOrder );
+}
+
+// The load work that does not need the graphics context is split into jobs that are claimed
+// one at a time by the worker threads and the calling thread.
+typedef void (*ksGltfJobFunction)( void * jobs, const int jobIndex );
+
+typedef struct
+{
+	ksGltfJobFunction			function;
+	void *						jobs;
+	int							jobCount;
+	ksAtomicUint32				nextJob;
+} ksGltfJobList;
+
+static void ksGltf_RunJobs( void * data )
+{
+	ksGltfJobList * jobList = (ksGltfJobList *) data;
+	for ( ; ; )
+	{
+		// Atomically add 1 to claim a job.
+		const unsigned int jobIndex = ksAtomicUint32_Increment( &jobList->nextJob ) - 1;
+		if ( jobIndex >= (unsigned int) jobList->jobCount )
+		{
+			break;
+		}
+		jobList->function( jobList->jobs, (int) jobIndex );
+	}
+}
+
+static void ksGltf_ParallelFor( ksThreadPool * pool, ksGltfJobFunction function, void * jobs, const int jobCount )
+{
+	ksGltfJobList jobList;
+	jobList.function = function;
+	jobList.jobs = jobs;
+	jobList.jobCount = jobCount;
+	jobList.nextJob = 0;
+
+	if ( pool->threadCount > 0 && jobCount > 1 )
+	{
+		ksThreadPool_Submit( pool, ksGltf_RunJobs, &jobList );
+		ksGltf_RunJobs( &jobList );
+		ksThreadPool_Join( pool );
+	}
+	else
+	{
+		ksGltf_RunJobs( &jobList );
+	}
+}
+
+// Reads a buffer, image or shader. External buffer files are memory mapped when possible.
+typedef struct
+{
+	const unsigned char *		binaryBuffer;
+	const char *				uri;				// NULL or empty if there is nothing to read
+	bool						mapFile;
+	unsigned char *				data;
+	size_t						dataSize;
+	bool						mapped;
+} ksGltfReadJob;
+
+static void ksGltf_ReadJob( void * jobs, const int jobIndex )
+{
+	ksGltfReadJob * job = &( (ksGltfReadJob *) jobs )[jobIndex];
+	if ( job->uri == NULL || job->uri[0] == '\0' )
+	{
+		return;
+	}
+	if ( job->mapFile && strncmp( job->uri, "data:", 5 ) != 0 )
+	{
+		const char * errorString = "";
+		job->data = (unsigned char *) ksJson_LoadFile( job->uri, false, &job->dataSize, &job->mapped, &errorString );
+	}
+	else
+	{
+		job->data = ksGltf_ReadUri( job->binaryBuffer, job->uri, &job->dataSize );
+	}
+}
+
+static int ksGltf_AddReadJobs( ksGltfReadJob ** jobs, int * jobCount, const int count )
+{
+	const int firstJob = *jobCount;
+	if ( count == 0 )
+	{
+		return firstJob;
+	}
+	*jobs = (ksGltfReadJob *) realloc( *jobs, ( firstJob + count ) * sizeof( ksGltfReadJob ) );
+	memset( *jobs + firstJob, 0, count * sizeof( ksGltfReadJob ) );
+	*jobCount += count;
+	return firstJob;
+}
+
+static void ksGltf_ConvertTechniqueProgramJob( void * jobs, const int jobIndex )
+{
+	ksGltf_ConvertTechniqueProgram( &( (ksGltfTechniqueProgram *) jobs )[jobIndex] );
+}
+
+// Based on a GL_MAX_UNIFORM_BLOCK_SIZE of 16384 on the ARM Mali.
+#define GLTF_MAX_JOINTS		( 16384 / (int) sizeof( ksMatrix4x4f ) )
+
+// Sub-trees with at least this many nodes are transformed one depth level at a time when there are worker threads,
+// and levels with at least twice GLTF_SIMULATE_LEVEL_JOB_NODES nodes are split into jobs. Otherwise sub-trees are
+// transformed in blocks of GLTF_SIMULATE_BLOCK_NODES nodes.
+#define GLTF_SIMULATE_LEVEL_MIN_SUB_TREE_NODES		1024
+#define GLTF_SIMULATE_LEVEL_JOB_NODES				256
+#define GLTF_SIMULATE_BLOCK_NODES					64
+
+// Sorts the nodes of a large sub-tree on depth such that all nodes of one level can be transformed in parallel.
+static void ksGltf_CreateSubTreeLevels( ksGltfScene * scene, const int subTreeIndex )
+{
+	const ksGltfSubTree * subTree = &scene->subTrees[subTreeIndex];
+	ksGltfSubTreeState * subTreeState = &scene->state.subTreeState[subTreeIndex];
+	if ( subTree->nodeCount < GLTF_SIMULATE_LEVEL_MIN_SUB_TREE_NODES )
+	{
+		return;
+	}
+
+	// The nodes of a sub-tree are consecutive in memory and the parents are sorted before their children.
+	int * depths = (int *) malloc( subTree->nodeCount * sizeof( int ) );
+	int levelCount = 0;
+	for ( int nodeIndex = 0; nodeIndex < subTree->nodeCount; nodeIndex++ )
+	{
+		const ksGltfNode * node = subTree->nodes[nodeIndex];
+		assert( node == subTree->nodes[0] + nodeIndex );
+		depths[nodeIndex] = ( nodeIndex > 0 ) ? depths[(int)( node->parent - subTree->nodes[0] )] + 1 : 0;
+		levelCount = MAX( levelCount, depths[nodeIndex] + 1 );
+	}
+
+	subTreeState->levelNodes = (int *) malloc( subTree->nodeCount * sizeof( int ) );
+	subTreeState->levelFirstNode = (int *) calloc( levelCount + 1, sizeof( int ) );
+	subTreeState->levelCount = levelCount;
+	for ( int nodeIndex = 0; nodeIndex < subTree->nodeCount; nodeIndex++ )
+	{
+		subTreeState->levelFirstNode[depths[nodeIndex] + 1]++;
+	}
+	for ( int level = 0; level < levelCount; level++ )
+	{
+		subTreeState->levelFirstNode[level + 1] += subTreeState->levelFirstNode[level];
+	}
+	int * levelNodeCount = (int *) calloc( levelCount, sizeof( int ) );
+	for ( int nodeIndex = 0; nodeIndex < subTree->nodeCount; nodeIndex++ )
+	{
+		const int level = depths[nodeIndex];
+		subTreeState->levelNodes[subTreeState->levelFirstNode[level] + levelNodeCount[level]++] = (int)( subTree->nodes[nodeIndex] - scene->nodes );
+	}
+	free( levelNodeCount );
+	free( depths );
+}
+
+static int ksGltf_CompareSurfaceDrawOrder( const void * a, const void * b )
+{
+	const ksGltfSurface * surfaceA = *(const ksGltfSurface **) a;
+	const ksGltfSurface * surfaceB = *(const ksGltfSurface **) b;
+	if ( surfaceA->material->technique != surfaceB->material->technique )
+	{
+		return ( surfaceA->material->technique < surfaceB->material->technique ) ? -1 : 1;
+	}
+	if ( surfaceA->material != surfaceB->material )
+	{
+		return ( surfaceA->material < surfaceB->material ) ? -1 : 1;
+	}
+	if ( surfaceA->geometryBuffer != surfaceB->geometryBuffer )
+	{
+		return ( surfaceA->geometryBuffer < surfaceB->geometryBuffer ) ? -1 : 1;
+	}
+	if ( surfaceA->firstIndex != surfaceB->firstIndex )
+	{
+		return ( surfaceA->firstIndex < surfaceB->firstIndex ) ? -1 : 1;
+	}
+	return ( surfaceA->vertexOffset < surfaceB->vertexOffset ) ? -1 : ( ( surfaceA->vertexOffset > surfaceB->vertexOffset ) ? 1 : 0 );
+}
+
+// Ranks the surfaces on technique, material and geometry buffer such that sorting the draws on
+// the rank of their surface groups the draws that share state. The blended surfaces share the
+// last rank to keep them in traversal order after all other surfaces.
+static void ksGltf_CreateDrawList( ksGltfScene * scene )
+{
+	int surfaceCount = 0;
+	for ( int modelIndex = 0; modelIndex < scene->modelCount; modelIndex++ )
+	{
+		surfaceCount += scene->models[modelIndex].surfaceCount;
+	}
 
-				out = (unsigned char *)memcpy( out, token, ptr - token ) + ( ptr - token );
-				out = (unsigned char *)memcpy( out, " ", 1 ) + 1;
-				out = (unsigned char *)memcpy( out, typeStart, typeEnd - typeStart ) + ( typeEnd - typeStart );
-				out = (unsigned char *)memcpy( out, " ", 1 ) + 1;
-				out = (unsigned char *)memcpy( out, nameStart, nameEnd - nameStart ) + ( nameEnd - nameStart );
-				ptr = nameEnd;
-				continue;
+	ksGltfSurface ** sortedSurfaces = (ksGltfSurface **) malloc( surfaceCount * sizeof( ksGltfSurface * ) );
+	int sortedSurfaceCount = 0;
+	for ( int modelIndex = 0; modelIndex < scene->modelCount; modelIndex++ )
+	{
+		for ( int surfaceIndex = 0; surfaceIndex < scene->models[modelIndex].surfaceCount; surfaceIndex++ )
+		{
+			ksGltfSurface * surface = &scene->models[modelIndex].surfaces[surfaceIndex];
+			if ( !surface->material->technique->rop.blendEnable )
+			{
+				sortedSurfaces[sortedSurfaceCount++] = surface;
 			}
+		}
+	}
+	qsort( sortedSurfaces, sortedSurfaceCount, sizeof( ksGltfSurface * ), ksGltf_CompareSurfaceDrawOrder );
+	for ( int modelIndex = 0; modelIndex < scene->modelCount; modelIndex++ )
+	{
+		for ( int surfaceIndex = 0; surfaceIndex < scene->models[modelIndex].surfaceCount; surfaceIndex++ )
+		{
+			scene->models[modelIndex].surfaces[surfaceIndex].drawOrder = sortedSurfaceCount;
+		}
+	}
+	for ( int sortedIndex = 0; sortedIndex < sortedSurfaceCount; sortedIndex++ )
+	{
+		sortedSurfaces[sortedIndex]->drawOrder = sortedIndex;
+	}
+	free( sortedSurfaces );
 
-			// Optionally replace uniform usage.
-			if ( ( conversion & ( KS_GLSL_CONVERSION_FLAG_VIEW_PROJECTION_BUFFER | KS_GLSL_CONVERSION_FLAG_MULTI_VIEW ) ) != 0 )
+	// The sub-trees of a sub-scene may overlap so every sub-tree is counted separately.
+	int maxDraws = 0;
+	for ( int subSceneIndex = 0; subSceneIndex < scene->subSceneCount; subSceneIndex++ )
+	{
+		const ksGltfSubScene * subScene = &scene->subScenes[subSceneIndex];
+		int drawCount = 0;
+		for ( int subTreeIndex = 0; subTreeIndex < subScene->subTreeCount; subTreeIndex++ )
+		{
+			const ksGltfSubTree * subTree = subScene->subTrees[subTreeIndex];
+			for ( int nodeIndex = 0; nodeIndex < subTree->nodeCount; nodeIndex++ )
 			{
-				if ( ksLexer_CaseSensitiveCompareToken( token, ptr, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE_TRANSPOSE] ) )
-				{
-					assert( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX );
-					out += sprintf( (char *)out, "transpose( mat3( %s%s ) )",
-							pushConstantInstanceName, newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE] );
-					ksGltf_SetUniformStageFlag( technique, (const unsigned char *)newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE], NULL, stage );
-					continue;
-				}
-				if ( ksLexer_CaseSensitiveCompareToken( token, ptr, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW] ) )
-				{
-					assert( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX );
-					out += sprintf( (char *)out, "%s%s",
-							newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW], multiviewArrayIndexString );
-					continue;
-				}
-				if ( ksLexer_CaseSensitiveCompareToken( token, ptr, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE] ) )
-				{
-					assert( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX );
-					out += sprintf( (char *)out, "%s%s",
-							newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE], multiviewArrayIndexString );
-					continue;
-				}
-				if ( ksLexer_CaseSensitiveCompareToken( token, ptr, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION] ) )
-				{
-					assert( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX );
-					out += sprintf( (char *)out, "%s%s",
-							newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION], multiviewArrayIndexString );
-					continue;
-				}
-				if ( ksLexer_CaseSensitiveCompareToken( token, ptr, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION_INVERSE] ) )
-				{
-					assert( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX );
-					out += sprintf( (char *)out, "%s%s",
-							newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION_INVERSE], multiviewArrayIndexString );
-					continue;
-				}
-				if ( ksLexer_CaseSensitiveCompareToken( token, ptr, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW] ) )
-				{
-					assert( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX );
-					out += sprintf( (char *)out, "%s%s * %s%s",
-							newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW], multiviewArrayIndexString,
-							pushConstantInstanceName, newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL] );
-					ksGltf_SetUniformStageFlag( technique, (const unsigned char *)newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL], NULL, stage );
-					continue;
-				}
-				if ( ksLexer_CaseSensitiveCompareToken( token, ptr, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_INVERSE] ) )
-				{
-					assert( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX );
-					out += sprintf( (char *)out, "%s%s * %s%s",
-							newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE], multiviewArrayIndexString,
-							pushConstantInstanceName, newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE] );
-					ksGltf_SetUniformStageFlag( technique, (const unsigned char *)newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE], NULL, stage );
-					continue;
-				}
-				if ( ksLexer_CaseSensitiveCompareToken( token, ptr, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_INVERSE_TRANSPOSE] ) )
-				{
-					assert( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX );
-					out += sprintf( (char *)out, "transpose( mat3( %s%s ) ) * transpose( mat3( %s%s ) )",
-							newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE], multiviewArrayIndexString,
-							pushConstantInstanceName, newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE] );
-					ksGltf_SetUniformStageFlag( technique, (const unsigned char *)newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE], NULL, stage );
-					continue;
-				}
-				if ( ksLexer_CaseSensitiveCompareToken( token, ptr, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_PROJECTION] ) )
-				{
-					assert( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX );
-					out += sprintf( (char *)out, "%s%s * %s%s * %s%s",
-							newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION], multiviewArrayIndexString,
-							newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW], multiviewArrayIndexString,
-							pushConstantInstanceName, newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL] );
-					ksGltf_SetUniformStageFlag( technique, (const unsigned char *)newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL], NULL, stage );
-					continue;
-				}
-				if ( ksLexer_CaseSensitiveCompareToken( token, ptr, existingSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_PROJECTION_INVERSE] ) )
+				const ksGltfNode * node = subTree->nodes[nodeIndex];
+				for ( int modelIndex = 0; modelIndex < node->modelCount; modelIndex++ )
 				{
-					assert( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX );
-					out += sprintf( (char *)out, "%s%s * %s%s * %s%s",
-							newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION_INVERSE], multiviewArrayIndexString,
-							newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE], multiviewArrayIndexString,
-							pushConstantInstanceName, newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE] );
-					ksGltf_SetUniformStageFlag( technique, (const unsigned char *)newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE], NULL, stage );
-					continue;
+					drawCount += node->models[modelIndex]->surfaceCount;
 				}
+			}
+		}
+		maxDraws = MAX( maxDraws, drawCount );
+	}
 
-				// Pre-multiplied node transform with semantic transform.
-				bool found = false;
-				for ( int i = 0; i < technique->uniformCount; i++ )
-				{
-					if ( technique->uniforms[i].nodeName != NULL && technique->uniforms[i].semantic != GLTF_UNIFORM_SEMANTIC_NONE &&
-							ksLexer_CaseSensitiveCompareToken( token, ptr, technique->parms[i].name ) )
-					{
-						assert( stage == KS_GPU_PROGRAM_STAGE_FLAG_VERTEX );
-						switch ( technique->uniforms[i].semantic )
-						{
-							case GLTF_UNIFORM_SEMANTIC_VIEW:
-								out += sprintf( (char *)out, "%s%s * %s%s",
-									newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW], multiviewArrayIndexString,
-									pushConstantInstanceName, technique->parms[i].name );
-								found = true;
-								break;
-							case GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE:
-								out += sprintf( (char *)out, "%s%s * %s%s",
-										newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE], multiviewArrayIndexString,
-										pushConstantInstanceName, technique->parms[i].name );
-								found = true;
-								break;
-							case GLTF_UNIFORM_SEMANTIC_PROJECTION:
-								out += sprintf( (char *)out, "%s%s * %s%s",
-										newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION], multiviewArrayIndexString,
-										pushConstantInstanceName, technique->parms[i].name );
-								found = true;
-								break;
-							case GLTF_UNIFORM_SEMANTIC_PROJECTION_INVERSE:
-								out += sprintf( (char *)out, "%s%s * %s%s",
-										newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION_INVERSE], multiviewArrayIndexString,
-										pushConstantInstanceName, technique->parms[i].name );
-								found = true;
-								break;
-							case GLTF_UNIFORM_SEMANTIC_MODEL:
-								out += sprintf( (char *)out, "%s * %s%s",
-										newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL],
-										pushConstantInstanceName, technique->parms[i].name );
-								found = true;
-								break;
-							case GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE:
-								out += sprintf( (char *)out, "%s * %s%s",
-										newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE],
-										pushConstantInstanceName, technique->parms[i].name );
-								found = true;
-								break;
-							case GLTF_UNIFORM_SEMANTIC_MODEL_VIEW:
-								out += sprintf( (char *)out, "%s%s * %s%s * %s%s",
-										newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW], multiviewArrayIndexString,
-										pushConstantInstanceName, newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL],
-										pushConstantInstanceName, technique->parms[i].name );
-								ksGltf_SetUniformStageFlag( technique, (const unsigned char *)newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL], NULL, stage );
-								found = true;
-								break;
-							case GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_INVERSE:
-								out += sprintf( (char *)out, "%s%s * %s%s * %s%s",
-										newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE], multiviewArrayIndexString,
-										pushConstantInstanceName, newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE],
-										pushConstantInstanceName, technique->parms[i].name );
-								ksGltf_SetUniformStageFlag( technique, (const unsigned char *)newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE], NULL, stage );
-								found = true;
-								break;
-							case GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_PROJECTION:
-								out += sprintf( (char *)out, "%s%s * %s%s * %s%s * %s%s",
-										newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION], multiviewArrayIndexString,
-										newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW], multiviewArrayIndexString,
-										pushConstantInstanceName, newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL],
-										pushConstantInstanceName, technique->parms[i].name );
-								ksGltf_SetUniformStageFlag( technique, (const unsigned char *)newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL], NULL, stage );
-								found = true;
-								break;
-							case GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_PROJECTION_INVERSE:
-								out += sprintf( (char *)out, "%s%s * %s%s * %s%s * %s%s",
-										newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION_INVERSE], multiviewArrayIndexString,
-										newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE], multiviewArrayIndexString,
-										pushConstantInstanceName, newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE],
-										pushConstantInstanceName, technique->parms[i].name );
-								ksGltf_SetUniformStageFlag( technique, (const unsigned char *)newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE], NULL, stage );
-								found = true;
-								break;
-							default:
-								out += sprintf( (char *)out, "%s%s", pushConstantInstanceName, technique->parms[i].name );
-								found = true;
-								break;
-						}
-						ksGltf_SetUniformStageFlag( technique, (const unsigned char *)technique->parms[i].name, NULL, stage );
-						break;
-					}
-				}
-				if ( found )
-				{
-					continue;
-				}
+	ksGltfDrawList * drawList = (ksGltfDrawList *) calloc( 1, sizeof( ksGltfDrawList ) );
+	drawList->draws = (ksGltfDraw *) malloc( maxDraws * sizeof( ksGltfDraw ) );
+	drawList->sortedDraws = (ksGltfDraw *) malloc( maxDraws * sizeof( ksGltfDraw ) );
+	drawList->orderCount = sortedSurfaceCount + 1;
+	drawList->orderOffsets = (int *) malloc( ( drawList->orderCount + 1 ) * sizeof( int ) );
+	drawList->drawCount = 0;
+	drawList->maxDraws = maxDraws;
+	scene->state.drawList = drawList;
+}
+
+static void ksGltf_DestroyDrawList( ksGltfScene * scene )
+{
+	free( scene->state.drawList->draws );
+	free( scene->state.drawList->sortedDraws );
+	free( scene->state.drawList->orderOffsets );
+	free( scene->state.drawList );
+	scene->state.drawList = NULL;
+}
+
+// Allocates the run-time state and creates the graphics objects that do not depend on the glTF data.
+static void ksGltf_CreateRunTimeState( ksGpuContext * context, ksGltfScene * scene, ksGpuRenderPass * renderPass )
+{
+	// Allocate run-time state memory.
+	scene->state.timeLineFrameState = (ksGltfTimeLineFrameState *) calloc( scene->timeLineCount, sizeof( ksGltfTimeLineFrameState ) );
+	scene->state.channelKeyState = (ksGltfChannelKeyState **) calloc( scene->animationCount, sizeof( ksGltfChannelKeyState * ) );
+	scene->state.animationEnabled = (bool *) malloc( scene->animationCount * sizeof( bool ) );
+	for ( int animationIndex = 0; animationIndex < scene->animationCount; animationIndex++ )
+	{
+		scene->state.animationEnabled[animationIndex] = true;
+		const int channelCount = scene->animations[animationIndex].channelCount;
+		scene->state.channelKeyState[animationIndex] = (ksGltfChannelKeyState *) malloc( channelCount * sizeof( ksGltfChannelKeyState ) );
+		for ( int channelIndex = 0; channelIndex < channelCount; channelIndex++ )
+		{
+			ksGltf_InitChannelKeyState( &scene->state.channelKeyState[animationIndex][channelIndex] );
+		}
+	}
+	scene->state.skinCullingState = (ksGltfSkinCullingState *) calloc( scene->skinCount, sizeof( ksGltfSkinCullingState ) );
+	for ( int skinIndex = 0; skinIndex < scene->skinCount; skinIndex++ )
+	{
+		ksGltfSkinCullingState * skinCullingState = &scene->state.skinCullingState[skinIndex];
+		skinCullingState->jointTransforms = (ksMatrix4x4f *) malloc( scene->skins[skinIndex].jointCount * sizeof( ksMatrix4x4f ) );
+		if ( scene->skins[skinIndex].jointGeometryBounds.mins[0] != NULL )
+		{
+			ksGltf_AllocBoundsArray( &skinCullingState->jointBounds, scene->skins[skinIndex].jointCount );
+		}
+		ksVector3f_Set( &skinCullingState->mins, FLT_MAX );
+		ksVector3f_Set( &skinCullingState->maxs, -FLT_MAX );
+		skinCullingState->culled = false;
+		skinCullingState->jointSimulateIndex = -1;
+		skinCullingState->jointBufferValid = false;
+	}
+	ksGltfNodeState * nodeState = &scene->state.nodeState;
+	ksGltf_AllocNodeState( nodeState, scene->nodeCount );
+	for ( int nodeIndex = 0; nodeIndex < scene->nodeCount; nodeIndex++ )
+	{
+		const ksGltfNode * node = &scene->nodes[nodeIndex];
+		nodeState->parent[nodeIndex] = ( node->parent != NULL ) ? (int)( node->parent - scene->nodes ) : -1;
+		ksGltf_SetNodeTransform( nodeState, nodeIndex, &node->translation, &node->rotation, &node->scale );
+		nodeState->localDirty[nodeIndex] = true;
+		ksMatrix4x4f_CreateIdentity( &nodeState->localTransform[nodeIndex] );
+		ksMatrix4x4f_CreateIdentity( &nodeState->globalTransform[nodeIndex] );
+		ksMatrix4x4f_CreateIdentity( &nodeState->globalInverseTransform[nodeIndex] );
+		nodeState->globalTransformType[nodeIndex] = GLTF_TRANSFORM_TYPE_RIGID;
+		nodeState->globalInverseRequired[nodeIndex] = ( node->modelCount > 0 || node->camera != NULL );
+		nodeState->globalSimulateIndex[nodeIndex] = 0;
+	}
+	for ( int skinIndex = 0; skinIndex < scene->skinCount; skinIndex++ )
+	{
+		nodeState->globalInverseRequired[(int)( scene->skins[skinIndex].parentNode - scene->nodes )] = true;
+	}
+	scene->state.subTreeState = (ksGltfSubTreeState *) calloc( scene->subTreeCount, sizeof( ksGltfSubTreeState ) );
+	for ( int subTreeIndex = 0; subTreeIndex < scene->subTreeCount; subTreeIndex++ )
+	{
+		scene->state.subTreeState[subTreeIndex].visible = true;
+		ksGltf_CreateSubTreeLevels( scene, subTreeIndex );
+	}
+
+	// The sub-trees are simulated in parallel unless they share nodes.
+	scene->state.simulateJobs = (ksGltfSimulateJob *) calloc( scene->subTreeCount, sizeof( ksGltfSimulateJob ) );
+	scene->state.parallelSubTrees = true;
+	for ( int i = 0; i < scene->subTreeCount; i++ )
+	{
+		const ksGltfNode * first = scene->subTrees[i].nodes[0];
+		for ( int j = i + 1; j < scene->subTreeCount; j++ )
+		{
+			const ksGltfNode * other = scene->subTrees[j].nodes[0];
+			if ( first < other + scene->subTrees[j].nodeCount && other < first + scene->subTrees[i].nodeCount )
+			{
+				scene->state.parallelSubTrees = false;
 			}
+		}
+	}
+
+	const ksCpuTopology * topology = ksCpuTopology_Get();
+	ksThreadPool_Create( &scene->state.threadPool, ( topology->physicalCoreCount > 0 ) ? topology->physicalCoreCount - 1 : 3 );
+
+	ksGltf_CreateDrawList( scene );
+
+	// Create view projection uniform buffer.
+	{
+		ksGpuBuffer_Create( context, &scene->viewProjectionBuffer, KS_GPU_BUFFER_TYPE_UNIFORM, 4 * sizeof( ksMatrix4x4f ), NULL, false );
+	}
+
+	// Create a default joint uniform buffer.
+	{
+		ksMatrix4x4f * data = malloc( GLTF_MAX_JOINTS * sizeof( ksMatrix4x4f ) );
+		for ( int jointIndex = 0; jointIndex < GLTF_MAX_JOINTS; jointIndex++ )
+		{
+			ksMatrix4x4f_CreateIdentity( &data[jointIndex] );
+		}
+		ksGpuBuffer_Create( context, &scene->defaultJointBuffer, KS_GPU_BUFFER_TYPE_UNIFORM, GLTF_MAX_JOINTS * sizeof( ksMatrix4x4f ), data, false );
+		free( data );
+	}
+
+	// Create unit cube.
+	{
+		ksGpuGeometry_CreateCube( context, &scene->unitCubeGeometry, 0.0f, 1.0f );
+		ksGpuGraphicsProgram_Create( context, &scene->unitCubeFlatShadeProgram,
+									PROGRAM( unitCubeFlatShadeVertexProgram ), sizeof( PROGRAM( unitCubeFlatShadeVertexProgram ) ),
+									PROGRAM( unitCubeFlatShadeFragmentProgram ), sizeof( PROGRAM( unitCubeFlatShadeFragmentProgram ) ),
+									unitCubeFlatShadeProgramParms, ARRAY_SIZE( unitCubeFlatShadeProgramParms ),
+									scene->unitCubeGeometry.layout, VERTEX_ATTRIBUTE_FLAG_POSITION | VERTEX_ATTRIBUTE_FLAG_NORMAL );
 
-			// Pre-append the push constant block instance name to push constants names.
-			if ( ( conversion & KS_GLSL_CONVERSION_FLAG_LAYOUT_VULKAN ) != 0 )
+		ksGpuGraphicsPipelineParms pipelineParms;
+		ksGpuGraphicsPipelineParms_Init( &pipelineParms );
+
+		pipelineParms.renderPass = renderPass;
+		pipelineParms.program = &scene->unitCubeFlatShadeProgram;
+		pipelineParms.geometry = &scene->unitCubeGeometry;
+
+		ksGpuGraphicsPipeline_Create( context, &scene->unitCubePipeline, &pipelineParms );
+	}
+}
+
+static void ksGltf_DestroyRunTimeState( ksGpuContext * context, ksGltfScene * scene )
+{
+	free( scene->state.timeLineFrameState );
+	for ( int animationIndex = 0; animationIndex < scene->animationCount; animationIndex++ )
+	{
+		free( scene->state.channelKeyState[animationIndex] );
+	}
+	free( scene->state.channelKeyState );
+	free( scene->state.animationEnabled );
+	for ( int skinIndex = 0; skinIndex < scene->skinCount; skinIndex++ )
+	{
+		free( scene->state.skinCullingState[skinIndex].jointTransforms );
+		ksGltf_FreeBoundsArray( &scene->state.skinCullingState[skinIndex].jointBounds );
+	}
+	free( scene->state.skinCullingState );
+	ksGltf_FreeNodeState( &scene->state.nodeState );
+	for ( int subTreeIndex = 0; subTreeIndex < scene->subTreeCount; subTreeIndex++ )
+	{
+		free( scene->state.subTreeState[subTreeIndex].levelNodes );
+		free( scene->state.subTreeState[subTreeIndex].levelFirstNode );
+	}
+	free( scene->state.subTreeState );
+	free( scene->state.simulateJobs );
+	ksThreadPool_Destroy( &scene->state.threadPool );
+	ksGltf_DestroyDrawList( scene );
+
+	ksGpuBuffer_Destroy( context, &scene->viewProjectionBuffer );
+	ksGpuBuffer_Destroy( context, &scene->defaultJointBuffer );
+	ksGpuGraphicsPipeline_Destroy( context, &scene->unitCubePipeline );
+	ksGpuGraphicsProgram_Destroy( context, &scene->unitCubeFlatShadeProgram );
+	ksGpuGeometry_Destroy( context, &scene->unitCubeGeometry );
+}
+
+/*
+================================================================================================================================
+
+Geometry buffers.
+
+The vertices and indices of all surfaces are unpacked while loading the models. Once all models
+are loaded, the surfaces with the same vertex attributes are packed into a single geometry buffer,
+and the indices of all surfaces are packed into a single index buffer. The vertex attributes are
+stored as separate arrays, one after the other, and each surface references a range of vertices
+and indices in these arrays. The indices of a surface are not changed. Instead, the vertex offset
+of the surface is added to each index when drawing.
+
+================================================================================================================================
+*/
+
+// The unpacked vertices and indices of a surface.
+#define GLTF_MAX_SURFACE_VERTEX_COUNT	( (int)( (ksGpuTriangleIndex) -1 ) + 1 )	// vertices addressable with a ksGpuTriangleIndex
+
+typedef struct ksGltfUnpackedGeometry
+{
+	const struct ksGltfUnpackedGeometry *	vertexSource;	// geometry with the same vertices or NULL
+	const struct ksGltfUnpackedGeometry *	indexSource;	// geometry with the same indices or NULL
+	ksDefaultVertexAttributeArrays			attribs;		// vertices if there is no vertex source
+	ksGpuTriangleIndex *					indexData;
+	int										indexCount;
+	ksGltfSurface *							surface;
+} ksGltfUnpackedGeometry;
+
+// Vertex layouts are the same if they store the same attributes in the same order, regardless of the attribute names.
+static bool ksGltf_IsSameVertexLayout( const ksGpuVertexAttribute * layoutA, const ksGpuVertexAttribute * layoutB )
+{
+	for ( int i = 0; ; i++ )
+	{
+		if ( layoutA[i].attributeFlag != layoutB[i].attributeFlag ||
+				layoutA[i].attributeSize != layoutB[i].attributeSize ||
+				layoutA[i].attributeFormat != layoutB[i].attributeFormat ||
+				layoutA[i].locationCount != layoutB[i].locationCount )
+		{
+			return false;
+		}
+		if ( layoutA[i].attributeFlag == 0 )
+		{
+			return true;
+		}
+	}
+}
+
+static ksGltfGeometryBuffer * ksGltf_FindGeometryBuffer( ksGltfScene * scene, const ksGpuVertexAttribute * layout, const int vertexAttribsFlags )
+{
+	for ( int bufferIndex = 0; bufferIndex < scene->geometryBufferCount; bufferIndex++ )
+	{
+		ksGltfGeometryBuffer * geometryBuffer = &scene->geometryBuffers[bufferIndex];
+		if ( geometryBuffer->vertexAttribsFlags == vertexAttribsFlags && ksGltf_IsSameVertexLayout( geometryBuffer->layout, layout ) )
+		{
+			return geometryBuffer;
+		}
+	}
+	return NULL;
+}
+
+// Copies vertex attribute arrays to a range of vertex attribute arrays with the same layout.
+static void ksGltf_CopyVertexAttributes( ksGpuVertexAttributeArrays * dst, const int dstFirstVertex, const ksGpuVertexAttributeArrays * src )
+{
+	assert( dst->attribsFlags == src->attribsFlags );
+	assert( dstFirstVertex + src->vertexCount <= dst->vertexCount );
+
+	unsigned char * dstBytes = (unsigned char *) dst->data;
+	const unsigned char * srcBytes = (const unsigned char *) src->data;
+	for ( int i = 0; dst->layout[i].attributeFlag != 0; i++ )
+	{
+		const ksGpuVertexAttribute * v = &dst->layout[i];
+		if ( ( v->attributeFlag & dst->attribsFlags ) != 0 )
+		{
+			memcpy( dstBytes + dstFirstVertex * v->attributeSize, srcBytes, src->vertexCount * v->attributeSize );
+			dstBytes += dst->vertexCount * v->attributeSize;
+			srcBytes += src->vertexCount * v->attributeSize;
+		}
+	}
+}
+
+// Allocates vertex attribute arrays with the attributes of the accessors and unpacks the accessors.
+static void ksGltf_UnpackGeometryAttributes( ksDefaultVertexAttributeArrays * attribs, const ksGpuVertexAttribute * layout, const ksGltfGeometryAccessors * accessors )
+{
+	const int attribsFlags = ( accessors->position != NULL		? VERTEX_ATTRIBUTE_FLAG_POSITION : 0 ) |
+							( accessors->normal != NULL			? VERTEX_ATTRIBUTE_FLAG_NORMAL : 0 ) |
+							( accessors->tangent != NULL		? VERTEX_ATTRIBUTE_FLAG_TANGENT : 0 ) |
+							( accessors->binormal != NULL		? VERTEX_ATTRIBUTE_FLAG_BINORMAL : 0 ) |
+							( accessors->color != NULL			? VERTEX_ATTRIBUTE_FLAG_COLOR : 0 ) |
+							( accessors->uv0 != NULL			? VERTEX_ATTRIBUTE_FLAG_UV0 : 0 ) |
+							( accessors->uv1 != NULL			? VERTEX_ATTRIBUTE_FLAG_UV1 : 0 ) |
+							( accessors->uv2 != NULL			? VERTEX_ATTRIBUTE_FLAG_UV2 : 0 ) |
+							( accessors->jointIndices != NULL	? VERTEX_ATTRIBUTE_FLAG_JOINT_INDICES : 0 ) |
+							( accessors->jointWeights != NULL	? VERTEX_ATTRIBUTE_FLAG_JOINT_WEIGHTS : 0 );
+
+	ksGpuVertexAttributeArrays_Alloc( &attribs->base, layout, accessors->position->count, attribsFlags );
+
+	if ( accessors->position != NULL )		ksGltf_UnpackAccessorFloats( &attribs->position->x,		3, accessors->position );
+	if ( accessors->normal != NULL )		ksGltf_UnpackAccessorFloats( &attribs->normal->x,		3, accessors->normal );
+	if ( accessors->tangent != NULL )		ksGltf_UnpackAccessorFloats( &attribs->tangent->x,		3, accessors->tangent );
+	if ( accessors->binormal != NULL )		ksGltf_UnpackAccessorFloats( &attribs->binormal->x,		3, accessors->binormal );
+	if ( accessors->color != NULL )			ksGltf_UnpackAccessorFloats( &attribs->color->x,		4, accessors->color );
+	if ( accessors->uv0 != NULL )			ksGltf_UnpackAccessorFloats( &attribs->uv0->x,			2, accessors->uv0 );
+	if ( accessors->uv1 != NULL )			ksGltf_UnpackAccessorFloats( &attribs->uv1->x,			2, accessors->uv1 );
+	if ( accessors->uv2 != NULL )			ksGltf_UnpackAccessorFloats( &attribs->uv2->x,			2, accessors->uv2 );
+	if ( accessors->jointIndices != NULL )	ksGltf_UnpackAccessorFloats( &attribs->jointIndices->x,	4, accessors->jointIndices );
+	if ( accessors->jointWeights != NULL )	ksGltf_UnpackAccessorFloats( &attribs->jointWeights->x,	4, accessors->jointWeights );
+}
+
+// Copies the given vertices of vertex attribute arrays to vertex attribute arrays with the same layout.
+static void ksGltf_GatherVertexAttributes( ksGpuVertexAttributeArrays * dst, const ksGpuVertexAttributeArrays * src, const int * vertices )
+{
+	assert( dst->attribsFlags == src->attribsFlags );
+
+	unsigned char * dstBytes = (unsigned char *) dst->data;
+	const unsigned char * srcBytes = (const unsigned char *) src->data;
+	for ( int i = 0; dst->layout[i].attributeFlag != 0; i++ )
+	{
+		const ksGpuVertexAttribute * v = &dst->layout[i];
+		if ( ( v->attributeFlag & dst->attribsFlags ) != 0 )
+		{
+			for ( int vertex = 0; vertex < dst->vertexCount; vertex++ )
 			{
-				bool found = false;
-				for ( int i = 0; i < technique->uniformCount; i++ )
-				{
-					const int size = ksGpuProgramParm_GetPushConstantSize( technique->parms[i].type );
-					if ( size > 0 )
-					{
-						if ( ksLexer_CaseSensitiveCompareToken( token, ptr, technique->parms[i].name ) )
-						{
-							out += sprintf( (char *)out, "%s%s", pushConstantInstanceName, technique->parms[i].name );
-							found = true;
-							break;
-						}
-					}
-				}
-				if ( found )
-				{
-					ksGltf_SetUniformStageFlag( technique, token, ptr, stage );
-					continue;
-				}
+				memcpy( dstBytes + vertex * v->attributeSize, srcBytes + vertices[vertex] * v->attributeSize, v->attributeSize );
 			}
+			dstBytes += dst->vertexCount * v->attributeSize;
+			srcBytes += src->vertexCount * v->attributeSize;
+		}
+	}
+}
 
-			// Replace gl_FragColor.
-			if ( stage == KS_GPU_PROGRAM_STAGE_FLAG_FRAGMENT )
+// An upper bound on the number of surfaces ksGltf_SplitGeometry creates for a triangle list. Every surface
+// except the last is only closed when the next triangle could add more vertices than fit in the surface.
+static int ksGltf_GetMaxSplitSurfaceCount( const int vertexCount, const int indexCount )
+{
+	return ( vertexCount <= GLTF_MAX_SURFACE_VERTEX_COUNT ) ? 1 : indexCount / ( GLTF_MAX_SURFACE_VERTEX_COUNT - 3 ) + 1;
+}
+
+/*
+Splits a triangle list with more vertices than a ksGpuTriangleIndex can address into surfaces
+that each reference at most GLTF_MAX_SURFACE_VERTEX_COUNT vertices. The triangles keep their order.
+The vertices of each surface are copied from the given vertex attribute arrays and the surface
+bounds are set from the copied positions. Returns the number of surfaces or zero if an index
+is out of range.
+*/
+static int ksGltf_SplitGeometry( ksGltfUnpackedGeometry * geometries, ksGltfSurface * surfaces, const int maxSurfaces,
+								const ksDefaultVertexAttributeArrays * attribs, const uint32_t * indices, const int indexCount )
+{
+	const int triangleIndexCount = indexCount - indexCount % 3;
+	for ( int i = 0; i < triangleIndexCount; i++ )
+	{
+		if ( indices[i] >= (uint32_t)attribs->base.vertexCount )
+		{
+			return 0;
+		}
+	}
+
+	int * remap = (int *) malloc( attribs->base.vertexCount * sizeof( int ) );
+	int * vertices = (int *) malloc( GLTF_MAX_SURFACE_VERTEX_COUNT * sizeof( int ) );
+	ksGpuTriangleIndex * surfaceIndices = (ksGpuTriangleIndex *) malloc( triangleIndexCount * sizeof( ksGpuTriangleIndex ) );
+	memset( remap, -1, attribs->base.vertexCount * sizeof( int ) );
+
+	int surfaceCount = 0;
+	for ( int first = 0; first < triangleIndexCount; )
+	{
+		int vertexCount = 0;
+		int count = 0;
+		for ( ; first + count < triangleIndexCount && vertexCount + 3 <= GLTF_MAX_SURFACE_VERTEX_COUNT; count += 3 )
+		{
+			for ( int i = 0; i < 3; i++ )
 			{
-				if ( ksLexer_CaseSensitiveCompareToken( token, ptr, "gl_FragColor" ) )
+				const uint32_t index = indices[first + count + i];
+				if ( remap[index] < 0 )
 				{
-					out = (unsigned char *)memcpy( out, "fragColor", 9 ) + 9;
-					continue;
+					remap[index] = vertexCount;
+					vertices[vertexCount++] = (int)index;
 				}
+				surfaceIndices[count + i] = (ksGpuTriangleIndex) remap[index];
 			}
+		}
 
-			if (	ksLexer_CaseSensitiveCompareToken( token, ptr, "texture1D" ) ||
-					ksLexer_CaseSensitiveCompareToken( token, ptr, "texture2D" ) ||
-					ksLexer_CaseSensitiveCompareToken( token, ptr, "texture3D" ) ||
-					ksLexer_CaseSensitiveCompareToken( token, ptr, "textureCube" ) ||
-					ksLexer_CaseSensitiveCompareToken( token, ptr, "shadow1D" ) ||
-					ksLexer_CaseSensitiveCompareToken( token, ptr, "shadow2D" ) )
+		assert( surfaceCount < maxSurfaces );
+		UNUSED_PARM( maxSurfaces );
+		ksGltfUnpackedGeometry * geometry = &geometries[surfaceCount];
+		ksGltfSurface * surface = &surfaces[surfaceCount];
+		geometry->surface = surface;
+		geometry->indexData = (ksGpuTriangleIndex *) malloc( count * sizeof( ksGpuTriangleIndex ) );
+		geometry->indexCount = count;
+		memcpy( geometry->indexData, surfaceIndices, count * sizeof( ksGpuTriangleIndex ) );
+		ksGpuVertexAttributeArrays_Alloc( &geometry->attribs.base, attribs->base.layout, vertexCount, attribs->base.attribsFlags );
+		ksGltf_GatherVertexAttributes( &geometry->attribs.base, &attribs->base, vertices );
+
+		ksVector3f_Set( &surface->mins, FLT_MAX );
+		ksVector3f_Set( &surface->maxs, -FLT_MAX );
+		for ( int vertex = 0; vertex < vertexCount; vertex++ )
+		{
+			remap[vertices[vertex]] = -1;
+			ksVector3f_Min( &surface->mins, &surface->mins, &geometry->attribs.position[vertex] );
+			ksVector3f_Max( &surface->maxs, &surface->maxs, &geometry->attribs.position[vertex] );
+		}
+
+		surfaceCount++;
+		first += count;
+	}
+
+	free( surfaceIndices );
+	free( vertices );
+	free( remap );
+	return surfaceCount;
+}
+
+// Packs the unpacked geometry of all surfaces into the geometry buffers. The packed vertex attribute arrays
+// of each geometry buffer and the packed indices are returned to create the graphics API buffers.
+static void ksGltf_PackGeometryBuffers( ksGltfScene * scene, ksGltfUnpackedGeometry ** unpacked, void *** packedVertexData, ksGpuTriangleIndex ** packedIndexData )
+{
+	// Find the distinct vertex layouts.
+	scene->geometryBufferCount = 0;
+	scene->geometryBuffers = NULL;
+	for ( int modelIndex = 0; modelIndex < scene->modelCount; modelIndex++ )
+	{
+		for ( int surfaceIndex = 0; surfaceIndex < scene->models[modelIndex].surfaceCount; surfaceIndex++ )
+		{
+			const ksGltfUnpackedGeometry * geometry = &unpacked[modelIndex][surfaceIndex];
+			if ( geometry->vertexSource == NULL && ksGltf_FindGeometryBuffer( scene, geometry->attribs.base.layout, geometry->attribs.base.attribsFlags ) == NULL )
 			{
-				out = (unsigned char *)memcpy( out, "texture", 7 ) + 7;
-				continue;
+				scene->geometryBuffers = (ksGltfGeometryBuffer *) realloc( scene->geometryBuffers, ( scene->geometryBufferCount + 1 ) * sizeof( ksGltfGeometryBuffer ) );
+				ksGltfGeometryBuffer * geometryBuffer = &scene->geometryBuffers[scene->geometryBufferCount++];
+				memset( geometryBuffer, 0, sizeof( ksGltfGeometryBuffer ) );
+				geometryBuffer->layout = geometry->attribs.base.layout;
+				geometryBuffer->vertexAttribsFlags = geometry->attribs.base.attribsFlags;
 			}
+		}
+	}
 
-			if (	ksLexer_CaseSensitiveCompareToken( token, ptr, "texture1DProj" ) ||
-					ksLexer_CaseSensitiveCompareToken( token, ptr, "texture2DProj" ) ||
-					ksLexer_CaseSensitiveCompareToken( token, ptr, "texture3DProj" ) ||
-					ksLexer_CaseSensitiveCompareToken( token, ptr, "shadow1DProj" ) ||
-					ksLexer_CaseSensitiveCompareToken( token, ptr, "shadow2DProj" ) )
+	// Assign a range of vertices and indices to each surface.
+	scene->geometryIndexCount = 0;
+	for ( int modelIndex = 0; modelIndex < scene->modelCount; modelIndex++ )
+	{
+		for ( int surfaceIndex = 0; surfaceIndex < scene->models[modelIndex].surfaceCount; surfaceIndex++ )
+		{
+			const ksGltfUnpackedGeometry * geometry = &unpacked[modelIndex][surfaceIndex];
+			ksGltfSurface * surface = geometry->surface;
+
+			if ( geometry->vertexSource == NULL )
 			{
-				out = (unsigned char *)memcpy( out, "textureProj", 11 ) + 11;
-				continue;
+				surface->geometryBuffer = ksGltf_FindGeometryBuffer( scene, geometry->attribs.base.layout, geometry->attribs.base.attribsFlags );
+				surface->vertexOffset = surface->geometryBuffer->vertexCount;
+				surface->vertexCount = geometry->attribs.base.vertexCount;
+				surface->geometryBuffer->vertexCount += surface->vertexCount;
+			}
+			else
+			{
+				// The vertex source is an earlier surface which already has a range of vertices.
+				surface->geometryBuffer = geometry->vertexSource->surface->geometryBuffer;
+				surface->vertexOffset = geometry->vertexSource->surface->vertexOffset;
+				surface->vertexCount = geometry->vertexSource->surface->vertexCount;
 			}
 
-			if (	ksLexer_CaseSensitiveCompareToken( token, ptr, "texture1DLod" ) ||
-					ksLexer_CaseSensitiveCompareToken( token, ptr, "texture2DLod" ) ||
-					ksLexer_CaseSensitiveCompareToken( token, ptr, "texture3DLod" ) ||
-					ksLexer_CaseSensitiveCompareToken( token, ptr, "textureCubeLod" ) ||
-					ksLexer_CaseSensitiveCompareToken( token, ptr, "shadow1DLod" ) ||
-					ksLexer_CaseSensitiveCompareToken( token, ptr, "shadow2DLod" ) )
+			if ( geometry->indexSource == NULL )
 			{
-				out = (unsigned char *)memcpy( out, "textureLod", 10 ) + 10;
-				continue;
+				surface->firstIndex = scene->geometryIndexCount;
+				scene->geometryIndexCount += geometry->indexCount;
 			}
+			else
+			{
+				surface->firstIndex = geometry->indexSource->surface->firstIndex;
+			}
+			surface->indexCount = geometry->indexCount;
+		}
+	}
 
-			if (	ksLexer_CaseSensitiveCompareToken( token, ptr, "texture1DProjLod" ) ||
-					ksLexer_CaseSensitiveCompareToken( token, ptr, "texture2DProjLod" ) ||
-					ksLexer_CaseSensitiveCompareToken( token, ptr, "texture3DProjLod" ) ||
-					ksLexer_CaseSensitiveCompareToken( token, ptr, "shadow1DProjLod" ) ||
-					ksLexer_CaseSensitiveCompareToken( token, ptr, "shadow2DProjLod" ) )
+	// Copy the vertices and indices.
+	*packedVertexData = (void **) malloc( scene->geometryBufferCount * sizeof( void * ) );
+	for ( int bufferIndex = 0; bufferIndex < scene->geometryBufferCount; bufferIndex++ )
+	{
+		const ksGltfGeometryBuffer * geometryBuffer = &scene->geometryBuffers[bufferIndex];
+		(*packedVertexData)[bufferIndex] = malloc( ksGpuVertexAttributeArrays_GetDataSize( geometryBuffer->layout, geometryBuffer->vertexCount, geometryBuffer->vertexAttribsFlags ) );
+	}
+	*packedIndexData = (ksGpuTriangleIndex *) malloc( scene->geometryIndexCount * sizeof( ksGpuTriangleIndex ) );
+
+	for ( int modelIndex = 0; modelIndex < scene->modelCount; modelIndex++ )
+	{
+		for ( int surfaceIndex = 0; surfaceIndex < scene->models[modelIndex].surfaceCount; surfaceIndex++ )
+		{
+			const ksGltfUnpackedGeometry * geometry = &unpacked[modelIndex][surfaceIndex];
+			const ksGltfSurface * surface = geometry->surface;
+			if ( geometry->vertexSource == NULL )
 			{
-				out = (unsigned char *)memcpy( out, "textureProjLod", 14 ) + 14;
-				continue;
+				const ksGltfGeometryBuffer * geometryBuffer = surface->geometryBuffer;
+				ksGpuVertexAttributeArrays attribs;
+				ksGpuVertexAttributeArrays_CreateFromBuffer( &attribs, geometryBuffer->layout, geometryBuffer->vertexCount, geometryBuffer->vertexAttribsFlags, NULL );
+				attribs.data = (*packedVertexData)[geometryBuffer - scene->geometryBuffers];
+				ksGltf_CopyVertexAttributes( &attribs, surface->vertexOffset, &geometry->attribs.base );
+			}
+			if ( geometry->indexSource == NULL )
+			{
+				memcpy( *packedIndexData + surface->firstIndex, geometry->indexData, geometry->indexCount * sizeof( ksGpuTriangleIndex ) );
 			}
 		}
+	}
+}
 
-		out = (unsigned char *)memcpy( out, token, ptr - token ) + ( ptr - token );
+// Creates the graphics API buffers of a geometry buffer from packed vertex attribute arrays.
+// The index buffer is only created for the first geometry buffer and referenced by the others.
+static void ksGltf_CreateGeometryBuffer( ksGpuContext * context, ksGltfScene * scene, ksGltfGeometryBuffer * geometryBuffer,
+											void * vertexData, ksGpuTriangleIndex * indexData )
+{
+	ksGpuVertexAttributeArrays attribs;
+	ksGpuVertexAttributeArrays_CreateFromBuffer( &attribs, geometryBuffer->layout, geometryBuffer->vertexCount, geometryBuffer->vertexAttribsFlags, NULL );
+	attribs.data = vertexData;
+	attribs.dataSize = ksGpuVertexAttributeArrays_GetDataSize( geometryBuffer->layout, geometryBuffer->vertexCount, geometryBuffer->vertexAttribsFlags );
+
+	ksGpuTriangleIndexArray indices;
+	if ( geometryBuffer == &scene->geometryBuffers[0] )
+	{
+		ksGpuTriangleIndexArray_CreateFromBuffer( &indices, scene->geometryIndexCount, NULL );
+		indices.indexArray = indexData;
+	}
+	else
+	{
+		ksGpuTriangleIndexArray_CreateFromBuffer( &indices, scene->geometryIndexCount, &scene->geometryBuffers[0].geometry.indexBuffer );
 	}
 
-	*out++ = '\0';
-	*sourceSize = ( out - newSource );
+	ksGpuGeometry_Create( context, &geometryBuffer->geometry, &attribs, &indices );
+}
+
+// Creates the graphics API objects of the surfaces once the geometry buffers are created.
+static void ksGltf_CreateSurfaceGeometry( ksGpuContext * context, ksGltfScene * scene, ksGpuRenderPass * renderPass )
+{
+	for ( int modelIndex = 0; modelIndex < scene->modelCount; modelIndex++ )
+	{
+		for ( int surfaceIndex = 0; surfaceIndex < scene->models[modelIndex].surfaceCount; surfaceIndex++ )
+		{
+			ksGltfSurface * surface = &scene->models[modelIndex].surfaces[surfaceIndex];
+
+			ksGpuGeometry_CreateRange( context, &surface->geometry, &surface->geometryBuffer->geometry,
+										surface->firstIndex, surface->indexCount, surface->vertexOffset, surface->vertexCount );
+
+			ksGpuGraphicsPipelineParms pipelineParms;
+			ksGpuGraphicsPipelineParms_Init( &pipelineParms );
+
+			pipelineParms.renderPass = renderPass;
+			pipelineParms.program = &surface->material->technique->program;
+			pipelineParms.geometry = &surface->geometry;
+			pipelineParms.rop = surface->material->technique->rop;
+
+			ksGpuGraphicsPipeline_Create( context, &surface->pipeline, &pipelineParms );
+		}
+	}
+}
+
+static void ksGltf_DestroySurfaceGeometry( ksGpuContext * context, ksGltfScene * scene )
+{
+	for ( int modelIndex = 0; modelIndex < scene->modelCount; modelIndex++ )
+	{
+		for ( int surfaceIndex = 0; surfaceIndex < scene->models[modelIndex].surfaceCount; surfaceIndex++ )
+		{
+			ksGpuGeometry_Destroy( context, &scene->models[modelIndex].surfaces[surfaceIndex].geometry );
+			ksGpuGraphicsPipeline_Destroy( context, &scene->models[modelIndex].surfaces[surfaceIndex].pipeline );
+		}
+	}
+	for ( int bufferIndex = 0; bufferIndex < scene->geometryBufferCount; bufferIndex++ )
+	{
+		ksGpuGeometry_Destroy( context, &scene->geometryBuffers[bufferIndex].geometry );
+	}
+}
+
+/*
+================================================================================================================================
+
+Baked scene cache.
+
+A loaded scene is baked into a single file that holds the run-time structures, the converted
+shaders, the KTX images and the unpacked vertices and indices. The pointers in the file are
+stored as offsets from the start of the file together with a table of the locations of these
+pointers. A baked scene is loaded by memory mapping the file, adding the address of the mapping
+to every pointer in the table, and creating the graphics API objects from the data in place.
+
+The buffers, buffer views, accessors, images, samplers, shaders and programs are only needed
+while loading, and they are not stored. The file records the name, size and modification time
+of the glTF file and of every external file that was read while loading. The file is only used
+when none of these files changed, and when it was baked for the same graphics API and multi-view
+setting, and with the same layout of the run-time structures. Checking the files only requires
+a stat() per file, so the source files are not read when the baked scene is up to date. Files
+that were modified in the second the scene was baked are never considered up to date.
+
+================================================================================================================================
+*/
+
+#define GLTF_BAKED_MAGIC		0x4B41424B		// 'KBAK'
+#define GLTF_BAKED_VERSION		5
+#define GLTF_BAKED_UNKNOWN_TIME	0xFFFFFFFFFFFFFFFFULL	// never matches the modification time of a file
+
+typedef struct
+{
+	uint32_t					magic;				// GLTF_BAKED_MAGIC
+	uint32_t					version;			// GLTF_BAKED_VERSION
+	uint32_t					layoutSignature;	// signature of the layout of the run-time structures
+	uint32_t					conversion;			// graphics API and settings that change the loaded scene
+	uint64_t					sourceFileOffset;	// offset of the ksGltfBakedSourceFile array
+	uint64_t					sourceFileCount;	// the glTF file followed by the external files it references
+	uint64_t					dataSize;			// size of the complete file
+	uint64_t					sceneOffset;		// offset of the ksGltfBakedScene
+	uint64_t					relocationOffset;	// offset of the table with the offsets of all pointers
+	uint64_t					relocationCount;
+} ksGltfBakedHeader;
+
+typedef struct
+{
+	uint64_t					nameOffset;			// offset of the zero terminated file name
+	uint64_t					size;
+	uint64_t					modifiedTime;		// seconds since the epoch or GLTF_BAKED_UNKNOWN_TIME
+} ksGltfBakedSourceFile;
+
+typedef struct
+{
+	unsigned char *				data;				// KTX file data or NULL for a white texture
+	size_t						dataSize;
+} ksGltfBakedTexture;
+
+typedef struct
+{
+	unsigned char *				vertexSource;		// vertex shader as passed to ksGpuGraphicsProgram_Create
+	size_t						vertexSourceSize;
+	unsigned char *				fragmentSource;		// fragment shader as passed to ksGpuGraphicsProgram_Create
+	size_t						fragmentSourceSize;
+} ksGltfBakedProgram;
+
+typedef struct
+{
+	ksGltfScene					scene;
+	ksGltfBakedTexture *		textures;			// one per scene texture
+	ksGltfBakedProgram *		programs;			// one per scene technique
+	void **						vertexData;			// packed vertex attribute arrays per geometry buffer
+	ksGpuTriangleIndex *		indexData;			// packed indices of all geometry buffers
+	char **						sourceFiles;		// external files that were read, only used while baking
+	int							sourceFileCount;
+} ksGltfBakedScene;
+
+// The baked scene data is recorded while loading and owns the recorded memory.
+static void ksGltf_FreeBakedScene( ksGltfBakedScene * bakedScene, const ksGltfScene * scene )
+{
+	for ( int textureIndex = 0; textureIndex < scene->textureCount && bakedScene->textures != NULL; textureIndex++ )
+	{
+		free( bakedScene->textures[textureIndex].data );
+	}
+	for ( int techniqueIndex = 0; techniqueIndex < scene->techniqueCount && bakedScene->programs != NULL; techniqueIndex++ )
+	{
+		free( bakedScene->programs[techniqueIndex].vertexSource );
+		free( bakedScene->programs[techniqueIndex].fragmentSource );
+	}
+	for ( int bufferIndex = 0; bufferIndex < scene->geometryBufferCount && bakedScene->vertexData != NULL; bufferIndex++ )
+	{
+		free( bakedScene->vertexData[bufferIndex] );
+	}
+	for ( int fileIndex = 0; fileIndex < bakedScene->sourceFileCount; fileIndex++ )
+	{
+		free( bakedScene->sourceFiles[fileIndex] );
+	}
+	free( bakedScene->textures );
+	free( bakedScene->programs );
+	free( bakedScene->vertexData );
+	free( bakedScene->indexData );
+	free( bakedScene->sourceFiles );
+	free( bakedScene );
+}
+
+// Records an external file that was read while loading. Data URIs are stored in the glTF file itself.
+static void ksGltf_AddBakedSourceFile( ksGltfBakedScene * bakedScene, const char * uri )
+{
+	if ( uri == NULL || uri[0] == '\0' || strncmp( uri, "data:", 5 ) == 0 )
+	{
+		return;
+	}
+	for ( int fileIndex = 0; fileIndex < bakedScene->sourceFileCount; fileIndex++ )
+	{
+		if ( strcmp( bakedScene->sourceFiles[fileIndex], uri ) == 0 )
+		{
+			return;
+		}
+	}
+	bakedScene->sourceFiles = (char **) realloc( bakedScene->sourceFiles, ( bakedScene->sourceFileCount + 1 ) * sizeof( char * ) );
+	bakedScene->sourceFiles[bakedScene->sourceFileCount++] = ksGltf_strdup( uri );
+}
 
-	return newSource;
+// Any change to the run-time structures changes the signature and invalidates existing files.
+static uint32_t ksGltf_GetBakedLayoutSignature()
+{
+	const size_t sizes[] =
+	{
+		sizeof( void * ),
+		sizeof( ksGltfTexture ),
+		sizeof( ksGltfUniform ),
+		sizeof( ksGltfVertexAttribute ),
+		sizeof( ksGltfTechnique ),
+		sizeof( ksGltfMaterial ),
+		sizeof( ksGltfGeometryBuffer ),
+		sizeof( ksGltfSurface ),
+		sizeof( ksGltfModel ),
+		sizeof( ksGltfTimeLine ),
+		sizeof( ksGltfCompressedKeyFrames ),
+		sizeof( ksGltfAnimationChannel ),
+		sizeof( ksGltfAnimation ),
+		sizeof( ksGltfJoint ),
+		sizeof( ksGltfSkin ),
+		sizeof( ksGltfCamera ),
+		sizeof( ksGltfNode ),
+		sizeof( ksGltfSubTree ),
+		sizeof( ksGltfSubScene ),
+		sizeof( ksGltfScene ),
+		sizeof( ksGpuProgramParm ),
+		sizeof( ksGpuVertexAttribute ),
+		sizeof( ksGltfBakedTexture ),
+		sizeof( ksGltfBakedProgram ),
+		sizeof( ksGltfBakedScene )
+	};
+	uint32_t signature = 2166136261u;
+	for ( int i = 0; i < (int) ARRAY_SIZE( sizes ); i++ )
+	{
+		signature = ( signature ^ (uint32_t) sizes[i] ) * 16777619u;
+	}
+	return signature;
 }
 
+static uint32_t ksGltf_GetBakedConversion( const ksSceneSettings * settings )
+{
+#if GRAPHICS_API_OPENGL == 1
+	const uint32_t graphicsApi = 1;
+#elif GRAPHICS_API_OPENGL_ES == 1
+	const uint32_t graphicsApi = 2;
+#elif GRAPHICS_API_VULKAN == 1
+	const uint32_t graphicsApi = 3;
+#elif GRAPHICS_API_D3D == 1
+	const uint32_t graphicsApi = 4;
+#elif GRAPHICS_API_METAL == 1
+	const uint32_t graphicsApi = 5;
 #endif
+	return graphicsApi | ( ( settings->useMultiView ? 1 : 0 ) << 8 );
+}
 
-void ksGltf_CreateTechniqueProgram( ksGpuContext * context, ksGltfTechnique * technique, const ksGltfProgram * program,
-								const int conversion, const char * semanticUniforms[] )
+static bool ksGltf_GetFileStamp( const char * fileName, uint64_t * sizeOut, uint64_t * modifiedTimeOut )
 {
-#if GRAPHICS_API_OPENGL == 1 || GRAPHICS_API_OPENGL_ES == 1 || GRAPHICS_API_VULKAN == 1
-	if ( conversion != KS_GLSL_CONVERSION_NONE )
+	struct stat st;
+	if ( stat( fileName, &st ) != 0 )
 	{
-		const char * newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MAX] = { 0 };
+		return false;
+	}
+	*sizeOut = (uint64_t) st.st_size;
+	*modifiedTimeOut = (uint64_t) st.st_mtime;
+	return true;
+}
 
-		// Update / replace technique uniforms.
+// Returns true if the baked scene was baked from the given glTF file and none of the source files changed.
+static bool ksGltf_IsBakedSceneUpToDate( const unsigned char * data, const size_t dataSize, const ksGltfBakedHeader * header, const char * glTF )
+{
+	if ( header->sourceFileCount < 1 ||
+			header->sourceFileOffset > dataSize ||
+			header->sourceFileCount > ( dataSize - header->sourceFileOffset ) / sizeof( ksGltfBakedSourceFile ) )
+	{
+		return false;
+	}
+	for ( uint64_t fileIndex = 0; fileIndex < header->sourceFileCount; fileIndex++ )
+	{
+		ksGltfBakedSourceFile sourceFile;
+		memcpy( &sourceFile, data + header->sourceFileOffset + fileIndex * sizeof( ksGltfBakedSourceFile ), sizeof( sourceFile ) );
+		if ( sourceFile.nameOffset >= dataSize || memchr( data + sourceFile.nameOffset, '\0', dataSize - sourceFile.nameOffset ) == NULL )
 		{
-			// At most three new uniforms are added.
-			ksGpuProgramParm * newParms = (ksGpuProgramParm *) calloc( technique->uniformCount + 3, sizeof( ksGpuProgramParm ) );
-			ksGltfUniform * newUniforms = (ksGltfUniform *) calloc( technique->uniformCount + 3, sizeof( ksGltfUniform ) );
-			int newUniformCount = 0;
+			return false;
+		}
+		const char * fileName = (const char *)( data + sourceFile.nameOffset );
+		if ( fileIndex == 0 && strcmp( fileName, glTF ) != 0 )
+		{
+			return false;
+		}
+		uint64_t size = 0;
+		uint64_t modifiedTime = 0;
+		if ( !ksGltf_GetFileStamp( fileName, &size, &modifiedTime ) || size != sourceFile.size || modifiedTime != sourceFile.modifiedTime )
+		{
+			return false;
+		}
+	}
+	return true;
+}
 
-			if ( ( conversion & KS_GLSL_CONVERSION_FLAG_JOINT_BUFFER ) != 0 )
-			{
-				// Optionally add a joint uniform buffer.
-				if ( semanticUniforms[GLTF_UNIFORM_SEMANTIC_JOINT_ARRAY] != NULL )
-				{
-					newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_JOINT_BUFFER] = JOINT_UNIFORM_BUFFER_NAME;
+// Memory that is copied into the baked data.
+typedef struct
+{
+	uintptr_t					source;
+	size_t						size;
+	size_t						offset;
+} ksGltfBakedBlock;
+
+// The baked data is written by copying blocks of memory. Pointers in the copied memory are
+// registered while writing and once all blocks are written the pointers are replaced with
+// the offsets of the data they point to.
+typedef struct
+{
+	unsigned char *				data;
+	size_t						dataSize;
+	size_t						dataAllocated;
+	ksGltfBakedBlock *			blocks;
+	int							blockCount;
+	int							blocksAllocated;
+	uint64_t *					pointers;			// offsets of the pointers in the data
+	int							pointerCount;
+	int							pointersAllocated;
+} ksGltfBakeWriter;
+
+static void ksGltfBakeWriter_Create( ksGltfBakeWriter * writer )
+{
+	memset( writer, 0, sizeof( ksGltfBakeWriter ) );
+}
 
-					newParms[newUniformCount].stageFlags = 0;	// Set when converting the shader.
-					newParms[newUniformCount].type = KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM;
-					newParms[newUniformCount].access = KS_GPU_PROGRAM_PARM_ACCESS_READ_ONLY;
-					newParms[newUniformCount].index = newUniformCount;
-					newParms[newUniformCount].name = ksGltf_strdup( JOINT_UNIFORM_BUFFER_NAME );
-					newParms[newUniformCount].binding = 0;	// Set when adding layout qualitifiers.
+static void ksGltfBakeWriter_Destroy( ksGltfBakeWriter * writer )
+{
+	free( writer->data );
+	free( writer->blocks );
+	free( writer->pointers );
+	memset( writer, 0, sizeof( ksGltfBakeWriter ) );
+}
 
-					newUniforms[newUniformCount].name = ksGltf_strdup( JOINT_UNIFORM_BUFFER_NAME );
-					newUniforms[newUniformCount].semantic = GLTF_UNIFORM_SEMANTIC_JOINT_BUFFER;
-					newUniforms[newUniformCount].type = KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM;
-					newUniforms[newUniformCount].index = newUniformCount;
+// Copies a block of memory, or writes zeros if the source is NULL, and returns the offset of the copy.
+static size_t ksGltfBakeWriter_Write( ksGltfBakeWriter * writer, const void * source, const size_t size )
+{
+	const size_t offset = ( writer->dataSize + 15 ) & ~(size_t)15;
+	if ( offset + size > writer->dataAllocated )
+	{
+		writer->dataAllocated = MAX( 2 * writer->dataAllocated, offset + size );
+		writer->data = (unsigned char *) realloc( writer->data, writer->dataAllocated );
+	}
+	memset( writer->data + writer->dataSize, 0, offset - writer->dataSize );
+	if ( source != NULL )
+	{
+		memcpy( writer->data + offset, source, size );
 
-					newUniformCount++;
-				}
-			}
+		if ( writer->blockCount >= writer->blocksAllocated )
+		{
+			writer->blocksAllocated = MAX( 2 * writer->blocksAllocated, 1024 );
+			writer->blocks = (ksGltfBakedBlock *) realloc( writer->blocks, writer->blocksAllocated * sizeof( ksGltfBakedBlock ) );
+		}
+		writer->blocks[writer->blockCount].source = (uintptr_t) source;
+		writer->blocks[writer->blockCount].size = size;
+		writer->blocks[writer->blockCount].offset = offset;
+		writer->blockCount++;
+	}
+	else
+	{
+		memset( writer->data + offset, 0, size );
+	}
+	writer->dataSize = offset + size;
+	return offset;
+}
 
-			if ( ( conversion & ( KS_GLSL_CONVERSION_FLAG_VIEW_PROJECTION_BUFFER | KS_GLSL_CONVERSION_FLAG_MULTI_VIEW ) ) != 0 )
-			{
-				const bool multiview = ( conversion & KS_GLSL_CONVERSION_FLAG_MULTI_VIEW ) != 0;
+static void ksGltfBakeWriter_Clear( ksGltfBakeWriter * writer, const size_t offset, const size_t size )
+{
+	memset( writer->data + offset, 0, size );
+}
 
-				// Optionally add a view-projection or multi-view uniform buffer.
-				if (	semanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW] != NULL ||
-						semanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE] != NULL ||
-						semanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION] != NULL ||
-						semanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION_INVERSE] != NULL ||
-						semanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW] != NULL ||
-						semanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_INVERSE] != NULL ||
-						semanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_INVERSE_TRANSPOSE] != NULL ||
-						semanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_PROJECTION] != NULL ||
-						semanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_PROJECTION_INVERSE] != NULL )
-				{
-					newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW]					=	semanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW] != NULL ?
-																						semanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW] : "u_viewMatrix";
-					newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE]			=	semanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE] != NULL ?
-																						semanticUniforms[GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE] : "u_viewInverseMatrix";
-					newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION]			=	semanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION] != NULL ?
-																						semanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION] : "u_projectionMatrix";
-					newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION_INVERSE]	=	semanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION_INVERSE] != NULL ?
-																						semanticUniforms[GLTF_UNIFORM_SEMANTIC_PROJECTION_INVERSE] : "u_projectionInverseMatrix";
+// Registers a pointer in the copied memory that points into another copied block.
+static void ksGltfBakeWriter_Pointer( ksGltfBakeWriter * writer, const size_t pointerOffset )
+{
+	if ( writer->pointerCount >= writer->pointersAllocated )
+	{
+		writer->pointersAllocated = MAX( 2 * writer->pointersAllocated, 1024 );
+		writer->pointers = (uint64_t *) realloc( writer->pointers, writer->pointersAllocated * sizeof( uint64_t ) );
+	}
+	writer->pointers[writer->pointerCount++] = pointerOffset;
+}
 
-					newParms[newUniformCount].stageFlags = 0;	// Set when converting the shader.
-					newParms[newUniformCount].type = KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM;
-					newParms[newUniformCount].access = KS_GPU_PROGRAM_PARM_ACCESS_READ_ONLY;
-					newParms[newUniformCount].index = newUniformCount;
-					newParms[newUniformCount].name = ksGltf_strdup( multiview ? VIEW_PROJECTION_MULTI_VIEW_UNIFORM_BUFFER_NAME : VIEW_PROJECTION_UNIFORM_BUFFER_NAME );
-					newParms[newUniformCount].binding = 0;	// Set when adding layout qualitifiers.
+static void * ksGltfBakeWriter_GetPointer( const ksGltfBakeWriter * writer, const size_t pointerOffset )
+{
+	void * pointer;
+	memcpy( &pointer, writer->data + pointerOffset, sizeof( pointer ) );
+	return pointer;
+}
 
-					newUniforms[newUniformCount].name = ksGltf_strdup( multiview ? VIEW_PROJECTION_MULTI_VIEW_UNIFORM_BUFFER_NAME : VIEW_PROJECTION_UNIFORM_BUFFER_NAME );
-					newUniforms[newUniformCount].semantic = multiview ? GLTF_UNIFORM_SEMANTIC_VIEW_PROJECTION_MULTI_VIEW_BUFFER : GLTF_UNIFORM_SEMANTIC_VIEW_PROJECTION_BUFFER;
-					newUniforms[newUniformCount].type = KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM;
-					newUniforms[newUniformCount].index = newUniformCount;
+// Copies the memory a pointer points to and registers the pointer. Returns the offset of the copy.
+static size_t ksGltfBakeWriter_Data( ksGltfBakeWriter * writer, const size_t pointerOffset, const size_t size )
+{
+	const void * source = ksGltfBakeWriter_GetPointer( writer, pointerOffset );
+	if ( source == NULL )
+	{
+		return 0;
+	}
+	ksGltfBakeWriter_Pointer( writer, pointerOffset );
+	return ksGltfBakeWriter_Write( writer, source, size );
+}
 
-					newUniformCount++;
-				}
+static void ksGltfBakeWriter_String( ksGltfBakeWriter * writer, const size_t pointerOffset )
+{
+	const char * string = (const char *) ksGltfBakeWriter_GetPointer( writer, pointerOffset );
+	if ( string != NULL )
+	{
+		ksGltfBakeWriter_Data( writer, pointerOffset, strlen( string ) + 1 );
+	}
+}
 
-				// Optionally add a model matrix uniform.
-				if (	semanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL] != NULL ||
-						semanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW] != NULL ||
-						semanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_PROJECTION] != NULL )
-				{
-					newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL]	=	semanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL] != NULL ?
-																			semanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL] : "u_modelMatrix";
-					if ( semanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL] == NULL )
-					{
-						newParms[newUniformCount].stageFlags = 0;	// Set when converting the shader.
-						newParms[newUniformCount].type = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX4X4;
-						newParms[newUniformCount].access = KS_GPU_PROGRAM_PARM_ACCESS_READ_ONLY;
-						newParms[newUniformCount].index = newUniformCount;
-						newParms[newUniformCount].name = ksGltf_strdup( newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL] );
-						newParms[newUniformCount].binding = 0;	// Set when adding layout qualitifiers.
+static void ksGltfBakeWriter_PointerArray( ksGltfBakeWriter * writer, const size_t pointerOffset, const int count )
+{
+	const size_t array = ksGltfBakeWriter_Data( writer, pointerOffset, count * sizeof( void * ) );
+	for ( int i = 0; i < count; i++ )
+	{
+		ksGltfBakeWriter_Pointer( writer, array + i * sizeof( void * ) );
+	}
+}
 
-						newUniforms[newUniformCount].name = ksGltf_strdup( newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL] );
-						newUniforms[newUniformCount].semantic = GLTF_UNIFORM_SEMANTIC_MODEL;
-						newUniforms[newUniformCount].type = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX4X4;
-						newUniforms[newUniformCount].index = newUniformCount;
+static void ksGltfBakeWriter_BoundsArray( ksGltfBakeWriter * writer, const size_t boundsOffset, const int count )
+{
+	if ( ksGltfBakeWriter_GetPointer( writer, boundsOffset + OFFSETOF_MEMBER( ksBounds3fArray, mins[0] ) ) == NULL )
+	{
+		return;
+	}
+	ksGltfBakeWriter_Data( writer, boundsOffset + OFFSETOF_MEMBER( ksBounds3fArray, mins[0] ), 6 * count * sizeof( float ) );
+	for ( int axis = 0; axis < 3; axis++ )
+	{
+		if ( axis > 0 )
+		{
+			ksGltfBakeWriter_Pointer( writer, boundsOffset + OFFSETOF_MEMBER( ksBounds3fArray, mins[axis] ) );
+		}
+		ksGltfBakeWriter_Pointer( writer, boundsOffset + OFFSETOF_MEMBER( ksBounds3fArray, maxs[axis] ) );
+	}
+}
 
-						newUniformCount++;
-					}
-				}
+static int ksGltfBakedBlock_Compare( const void * a, const void * b )
+{
+	const ksGltfBakedBlock * blockA = (const ksGltfBakedBlock *) a;
+	const ksGltfBakedBlock * blockB = (const ksGltfBakedBlock *) b;
+	if ( blockA->source != blockB->source )
+	{
+		return ( blockA->source < blockB->source ) ? -1 : 1;
+	}
+	if ( blockA->size != blockB->size )
+	{
+		return ( blockA->size < blockB->size ) ? -1 : 1;
+	}
+	return 0;
+}
 
-				// Optionally add an inverse model matrix uniform.
-				if (	semanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE] != NULL ||
-						semanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE_TRANSPOSE] != NULL ||
-						semanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_INVERSE] != NULL ||
-						semanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_INVERSE_TRANSPOSE] != NULL ||
-						semanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_PROJECTION_INVERSE] != NULL )
-				{
-					newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE]	=	semanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE] != NULL ?
-																					semanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE] : "u_modelInverseMatrix";
-					if ( semanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE] == NULL )
-					{
-						newParms[newUniformCount].stageFlags = 0;	// Set when converting the shader.
-						newParms[newUniformCount].type = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX4X4;
-						newParms[newUniformCount].access = KS_GPU_PROGRAM_PARM_ACCESS_READ_ONLY;
-						newParms[newUniformCount].index = newUniformCount;
-						newParms[newUniformCount].name = ksGltf_strdup( newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE] );
-						newParms[newUniformCount].binding = 0;	// Set when adding layout qualitifiers.
+// Replaces the registered pointers with offsets and appends the relocation table.
+// Returns false if a pointer does not point into any of the copied blocks.
+static bool ksGltfBakeWriter_Finish( ksGltfBakeWriter * writer, uint64_t * relocationOffset, uint64_t * relocationCount )
+{
+	qsort( writer->blocks, writer->blockCount, sizeof( ksGltfBakedBlock ), ksGltfBakedBlock_Compare );
 
-						newUniforms[newUniformCount].name = ksGltf_strdup( newSemanticUniforms[GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE] );
-						newUniforms[newUniformCount].semantic = GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE;
-						newUniforms[newUniformCount].type = KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX4X4;
-						newUniforms[newUniformCount].index = newUniformCount;
+	int resolvedCount = 0;
+	for ( int pointerIndex = 0; pointerIndex < writer->pointerCount; pointerIndex++ )
+	{
+		const size_t pointerOffset = (size_t) writer->pointers[pointerIndex];
+		const uintptr_t pointer = (uintptr_t) ksGltfBakeWriter_GetPointer( writer, pointerOffset );
+		if ( pointer == 0 )
+		{
+			continue;
+		}
 
-						newUniformCount++;
-					}
-				}
+		// Find the last block that starts at or before the pointer. If it starts at the pointer
+		// then it is the largest such block, otherwise search back for a block that contains it.
+		int low = 0;
+		int high = writer->blockCount;
+		while ( low < high )
+		{
+			const int mid = ( low + high ) >> 1;
+			if ( writer->blocks[mid].source <= pointer )
+			{
+				low = mid + 1;
 			}
-
-			// Maintain any uniforms that are still used after the conversion to uniform buffers.
-			for ( int uniformIndex = 0; uniformIndex < technique->uniformCount; uniformIndex++ )
+			else
 			{
-				if ( ( conversion & KS_GLSL_CONVERSION_FLAG_JOINT_BUFFER ) != 0 )
-				{
-					if ( technique->uniforms[uniformIndex].semantic == GLTF_UNIFORM_SEMANTIC_JOINT_ARRAY )
-					{
-						free( (void *)technique->parms[uniformIndex].name );
-						free( technique->uniforms[uniformIndex].name );
-						continue;
-					}
-				}
-				if ( ( conversion & ( KS_GLSL_CONVERSION_FLAG_VIEW_PROJECTION_BUFFER | KS_GLSL_CONVERSION_FLAG_MULTI_VIEW ) ) != 0 )
-				{
-					if (	technique->uniforms[uniformIndex].semantic == GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE_TRANSPOSE ||
-							technique->uniforms[uniformIndex].semantic == GLTF_UNIFORM_SEMANTIC_VIEW ||
-							technique->uniforms[uniformIndex].semantic == GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE ||
-							technique->uniforms[uniformIndex].semantic == GLTF_UNIFORM_SEMANTIC_PROJECTION ||
-							technique->uniforms[uniformIndex].semantic == GLTF_UNIFORM_SEMANTIC_PROJECTION_INVERSE ||
-							technique->uniforms[uniformIndex].semantic == GLTF_UNIFORM_SEMANTIC_MODEL_VIEW ||
-							technique->uniforms[uniformIndex].semantic == GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_INVERSE ||
-							technique->uniforms[uniformIndex].semantic == GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_INVERSE_TRANSPOSE ||
-							technique->uniforms[uniformIndex].semantic == GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_PROJECTION ||
-							technique->uniforms[uniformIndex].semantic == GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_PROJECTION_INVERSE )
-					{
-						if ( technique->uniforms[uniformIndex].nodeName == NULL )
-						{
-							free( (void *)technique->parms[uniformIndex].name );
-							free( technique->uniforms[uniformIndex].name );
-							continue;
-						}
-					}
-				}
+				high = mid;
+			}
+		}
+		int blockIndex = low - 1;
+		while ( blockIndex >= 0 )
+		{
+			const ksGltfBakedBlock * block = &writer->blocks[blockIndex];
+			if ( block->source == pointer || pointer - block->source < block->size )
+			{
+				break;
+			}
+			blockIndex--;
+		}
+		if ( blockIndex < 0 )
+		{
+			return false;
+		}
+
+		const ksGltfBakedBlock * block = &writer->blocks[blockIndex];
+		const uintptr_t offset = (uintptr_t)( block->offset + ( pointer - block->source ) );
+		memcpy( writer->data + pointerOffset, &offset, sizeof( offset ) );
+		writer->pointers[resolvedCount++] = pointerOffset;
+	}
+
+	*relocationOffset = ksGltfBakeWriter_Write( writer, NULL, resolvedCount * sizeof( uint64_t ) );
+	*relocationCount = resolvedCount;
+	memcpy( writer->data + *relocationOffset, writer->pointers, resolvedCount * sizeof( uint64_t ) );
+	return true;
+}
+
+static bool ksGltf_WriteBakedScene( const char * fileName, const ksGltfScene * scene, ksGltfBakedScene * bakedScene, const ksSceneSettings * settings )
+{
+	ksGltfBakedHeader header;
+	memset( &header, 0, sizeof( header ) );
+	header.magic = GLTF_BAKED_MAGIC;
+	header.version = GLTF_BAKED_VERSION;
+	header.layoutSignature = ksGltf_GetBakedLayoutSignature();
+	header.conversion = ksGltf_GetBakedConversion( settings );
+
+	// Only the objects that are used at run-time are stored and the graphics API objects are created when loading.
+	bakedScene->scene = *scene;
+	ksGltfScene * bakedCopy = &bakedScene->scene;
+	bakedCopy->buffers = NULL;
+	bakedCopy->bufferNameHash = NULL;
+	bakedCopy->bufferCount = 0;
+	bakedCopy->bufferViews = NULL;
+	bakedCopy->bufferViewNameHash = NULL;
+	bakedCopy->bufferViewCount = 0;
+	bakedCopy->accessors = NULL;
+	bakedCopy->accessorNameHash = NULL;
+	bakedCopy->accessorCount = 0;
+	bakedCopy->images = NULL;
+	bakedCopy->imageNameHash = NULL;
+	bakedCopy->imageCount = 0;
+	bakedCopy->samplers = NULL;
+	bakedCopy->samplerNameHash = NULL;
+	bakedCopy->samplerCount = 0;
+	bakedCopy->shaders = NULL;
+	bakedCopy->shaderNameHash = NULL;
+	bakedCopy->shaderCount = 0;
+	bakedCopy->programs = NULL;
+	bakedCopy->programNameHash = NULL;
+	bakedCopy->programCount = 0;
+	memset( &bakedCopy->state, 0, sizeof( bakedCopy->state ) );
+	bakedCopy->state.currentSubScene = scene->state.currentSubScene;
+	bakedCopy->binaryFileData = NULL;
+	bakedCopy->binaryFileSize = 0;
+	bakedCopy->binaryFileMapped = false;
+	bakedCopy->bakedData = NULL;
+	bakedCopy->bakedDataSize = 0;
+	bakedCopy->bakedDataMapped = false;
+	memset( &bakedCopy->viewProjectionBuffer, 0, sizeof( bakedCopy->viewProjectionBuffer ) );
+	memset( &bakedCopy->defaultJointBuffer, 0, sizeof( bakedCopy->defaultJointBuffer ) );
+	memset( &bakedCopy->unitCubeGeometry, 0, sizeof( bakedCopy->unitCubeGeometry ) );
+	memset( &bakedCopy->unitCubeFlatShadeProgram, 0, sizeof( bakedCopy->unitCubeFlatShadeProgram ) );
+	memset( &bakedCopy->unitCubePipeline, 0, sizeof( bakedCopy->unitCubePipeline ) );
+
+	ksGltfBakeWriter writer;
+	ksGltfBakeWriter_Create( &writer );
+
+	const size_t headerOffset = ksGltfBakeWriter_Write( &writer, NULL, sizeof( header ) );
+
+	// The glTF file and the external files are stamped with their size and modification time.
+	// A file that was modified during the current second may still be changed without changing
+	// its stamp, so such a stamp is not stored and the scene is baked again on the next load.
+	const uint64_t bakeTime = (uint64_t) time( NULL );
+	const int sourceFileCount = 1 + bakedScene->sourceFileCount;
+	header.sourceFileOffset = ksGltfBakeWriter_Write( &writer, NULL, sourceFileCount * sizeof( ksGltfBakedSourceFile ) );
+	header.sourceFileCount = sourceFileCount;
+	for ( int fileIndex = 0; fileIndex < sourceFileCount; fileIndex++ )
+	{
+		const char * fileName = ( fileIndex == 0 ) ? settings->glTF : bakedScene->sourceFiles[fileIndex - 1];
+		ksGltfBakedSourceFile sourceFile;
+		memset( &sourceFile, 0, sizeof( sourceFile ) );
+		if ( !ksGltf_GetFileStamp( fileName, &sourceFile.size, &sourceFile.modifiedTime ) )
+		{
+			Print( "Failed to bake %s because %s cannot be found\n", settings->glTF, fileName );
+			ksGltfBakeWriter_Destroy( &writer );
+			return false;
+		}
+		if ( sourceFile.modifiedTime >= bakeTime )
+		{
+			sourceFile.modifiedTime = GLTF_BAKED_UNKNOWN_TIME;
+		}
+		const size_t nameLength = strlen( fileName ) + 1;
+		sourceFile.nameOffset = ksGltfBakeWriter_Write( &writer, NULL, nameLength );
+		memcpy( writer.data + sourceFile.nameOffset, fileName, nameLength );
+		memcpy( writer.data + header.sourceFileOffset + fileIndex * sizeof( ksGltfBakedSourceFile ), &sourceFile, sizeof( sourceFile ) );
+	}
 
-				newParms[newUniformCount].stageFlags = 0;	// Set when converting the shader.
-				newParms[newUniformCount].type = technique->parms[uniformIndex].type;
-				newParms[newUniformCount].access = technique->parms[uniformIndex].access;
-				newParms[newUniformCount].index = newUniformCount;
-				newParms[newUniformCount].name = technique->parms[uniformIndex].name;
-				newParms[newUniformCount].binding = 0;	// Set when adding layout qualitifiers.
+	const size_t root = ksGltfBakeWriter_Write( &writer, bakedScene, sizeof( ksGltfBakedScene ) );
+	const size_t s = root + OFFSETOF_MEMBER( ksGltfBakedScene, scene );
+	ksGltfBakeWriter_Clear( &writer, root + OFFSETOF_MEMBER( ksGltfBakedScene, sourceFiles ), SIZEOF_MEMBER( ksGltfBakedScene, sourceFiles ) );
+	ksGltfBakeWriter_Clear( &writer, root + OFFSETOF_MEMBER( ksGltfBakedScene, sourceFileCount ), SIZEOF_MEMBER( ksGltfBakedScene, sourceFileCount ) );
 
-				memcpy( &newUniforms[newUniformCount], &technique->uniforms[uniformIndex], sizeof( ksGltfUniform ) );
-				newUniforms[newUniformCount].index = newUniformCount;
+	// The structures are written first such that the pages with pointers are together at the start of the file.
+	{
+		const size_t textures = ksGltfBakeWriter_Data( &writer, s + OFFSETOF_MEMBER( ksGltfScene, textures ), scene->textureCount * sizeof( ksGltfTexture ) );
+		ksGltfBakeWriter_Data( &writer, s + OFFSETOF_MEMBER( ksGltfScene, textureNameHash ), ksGltf_GetHashSize( scene->textureCount ) * sizeof( int ) );
+		for ( int textureIndex = 0; textureIndex < scene->textureCount; textureIndex++ )
+		{
+			const size_t texture = textures + textureIndex * sizeof( ksGltfTexture );
+			ksGltfBakeWriter_String( &writer, texture + OFFSETOF_MEMBER( ksGltfTexture, name ) );
+			ksGltfBakeWriter_Clear( &writer, texture + OFFSETOF_MEMBER( ksGltfTexture, image ), SIZEOF_MEMBER( ksGltfTexture, image ) );
+			ksGltfBakeWriter_Clear( &writer, texture + OFFSETOF_MEMBER( ksGltfTexture, sampler ), SIZEOF_MEMBER( ksGltfTexture, sampler ) );
+			ksGltfBakeWriter_Clear( &writer, texture + OFFSETOF_MEMBER( ksGltfTexture, texture ), SIZEOF_MEMBER( ksGltfTexture, texture ) );
+		}
+	}
+	{
+		const size_t techniques = ksGltfBakeWriter_Data( &writer, s + OFFSETOF_MEMBER( ksGltfScene, techniques ), scene->techniqueCount * sizeof( ksGltfTechnique ) );
+		ksGltfBakeWriter_Data( &writer, s + OFFSETOF_MEMBER( ksGltfScene, techniqueNameHash ), ksGltf_GetHashSize( scene->techniqueCount ) * sizeof( int ) );
+		for ( int techniqueIndex = 0; techniqueIndex < scene->techniqueCount; techniqueIndex++ )
+		{
+			const ksGltfTechnique * technique = &scene->techniques[techniqueIndex];
+			const size_t t = techniques + techniqueIndex * sizeof( ksGltfTechnique );
+			ksGltfBakeWriter_String( &writer, t + OFFSETOF_MEMBER( ksGltfTechnique, name ) );
+			ksGltfBakeWriter_Clear( &writer, t + OFFSETOF_MEMBER( ksGltfTechnique, program ), SIZEOF_MEMBER( ksGltfTechnique, program ) );
 
-				newUniformCount++;
+			const size_t parms = ksGltfBakeWriter_Data( &writer, t + OFFSETOF_MEMBER( ksGltfTechnique, parms ), technique->uniformCount * sizeof( ksGpuProgramParm ) );
+			const size_t uniforms = ksGltfBakeWriter_Data( &writer, t + OFFSETOF_MEMBER( ksGltfTechnique, uniforms ), technique->uniformCount * sizeof( ksGltfUniform ) );
+			for ( int uniformIndex = 0; uniformIndex < technique->uniformCount; uniformIndex++ )
+			{
+				const size_t parm = parms + uniformIndex * sizeof( ksGpuProgramParm );
+				const size_t uniform = uniforms + uniformIndex * sizeof( ksGltfUniform );
+				ksGltfBakeWriter_String( &writer, parm + OFFSETOF_MEMBER( ksGpuProgramParm, name ) );
+				ksGltfBakeWriter_String( &writer, uniform + OFFSETOF_MEMBER( ksGltfUniform, name ) );
+				ksGltfBakeWriter_String( &writer, uniform + OFFSETOF_MEMBER( ksGltfUniform, nodeName ) );
+				ksGltfBakeWriter_Pointer( &writer, uniform + OFFSETOF_MEMBER( ksGltfUniform, node ) );
+				ksGltfBakeWriter_Pointer( &writer, uniform + OFFSETOF_MEMBER( ksGltfUniform, defaultValue.texture ) );
 			}
 
-			if ( ( conversion & KS_GLSL_CONVERSION_FLAG_LAYOUT_OPENGL ) != 0 )
+			const size_t attributes = ksGltfBakeWriter_Data( &writer, t + OFFSETOF_MEMBER( ksGltfTechnique, attributes ), technique->attributeCount * sizeof( ksGltfVertexAttribute ) );
+			for ( int attributeIndex = 0; attributeIndex < technique->attributeCount; attributeIndex++ )
 			{
-				// Set OpenGL layout bindings / locations.
-				int numSampledTextureBindings = 0;
-				int numStorageTextureBindings = 0;
-				int numUniformBufferBindings = 0;
-				int numStorageBufferBindings = 0;
-				int numUniformLocations = 0;
+				ksGltfBakeWriter_String( &writer, attributes + attributeIndex * sizeof( ksGltfVertexAttribute ) + OFFSETOF_MEMBER( ksGltfVertexAttribute, name ) );
+			}
 
-				for ( int uniformIndex = 0; uniformIndex < newUniformCount; uniformIndex++ )
-				{
-					if ( newParms[uniformIndex].type == KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_SAMPLED )
-					{
-						newParms[uniformIndex].binding = numSampledTextureBindings++;
-					}
-					else if ( newParms[uniformIndex].type == KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_STORAGE )
-					{
-						newParms[uniformIndex].binding = numStorageTextureBindings++;
-					}
-					else if ( newParms[uniformIndex].type == KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM )
-					{
-						newParms[uniformIndex].binding = numUniformBufferBindings++;
-					}
-					else if ( newParms[uniformIndex].type == KS_GPU_PROGRAM_PARM_TYPE_BUFFER_STORAGE )
-					{
-						newParms[uniformIndex].binding = numStorageBufferBindings++;
-					}
-					else
-					{
-						newParms[uniformIndex].binding = numUniformLocations++;
-					}
-				}
+			// The vertex attribute layout is terminated with an attribute without flags and the names are copied with the layout.
+			int layoutCount = 0;
+			while ( technique->vertexAttributeLayout[layoutCount++].attributeFlag != 0 ) {}
+			const size_t layout = ksGltfBakeWriter_Data( &writer, t + OFFSETOF_MEMBER( ksGltfTechnique, vertexAttributeLayout ), layoutCount * sizeof( ksGpuVertexAttribute ) );
+			for ( int layoutIndex = 0; layoutIndex < layoutCount; layoutIndex++ )
+			{
+				ksGltfBakeWriter_String( &writer, layout + layoutIndex * sizeof( ksGpuVertexAttribute ) + OFFSETOF_MEMBER( ksGpuVertexAttribute, name ) );
 			}
-			else if ( ( conversion & KS_GLSL_CONVERSION_FLAG_LAYOUT_VULKAN ) != 0 )
+		}
+	}
+	{
+		const size_t materials = ksGltfBakeWriter_Data( &writer, s + OFFSETOF_MEMBER( ksGltfScene, materials ), scene->materialCount * sizeof( ksGltfMaterial ) );
+		ksGltfBakeWriter_Data( &writer, s + OFFSETOF_MEMBER( ksGltfScene, materialNameHash ), ksGltf_GetHashSize( scene->materialCount ) * sizeof( int ) );
+		for ( int materialIndex = 0; materialIndex < scene->materialCount; materialIndex++ )
+		{
+			const size_t material = materials + materialIndex * sizeof( ksGltfMaterial );
+			ksGltfBakeWriter_String( &writer, material + OFFSETOF_MEMBER( ksGltfMaterial, name ) );
+			ksGltfBakeWriter_Pointer( &writer, material + OFFSETOF_MEMBER( ksGltfMaterial, technique ) );
+			const size_t values = ksGltfBakeWriter_Data( &writer, material + OFFSETOF_MEMBER( ksGltfMaterial, values ), scene->materials[materialIndex].valueCount * sizeof( ksGltfMaterialValue ) );
+			for ( int valueIndex = 0; valueIndex < scene->materials[materialIndex].valueCount; valueIndex++ )
 			{
-				// Set Vulkan layout bindings / push constant offsets.
-				int numOpaqueBindings = 0;
-				int pushConstantOffset = 0;
-
-				for ( int uniformIndex = 0; uniformIndex < newUniformCount; uniformIndex++ )
-				{
-					if ( ksGpuProgramParm_IsOpaqueBinding( newParms[uniformIndex].type ) )
-					{
-						newParms[uniformIndex].binding = numOpaqueBindings++;
-					}
-					else
-					{
-						newParms[uniformIndex].binding = pushConstantOffset;
-						pushConstantOffset += ksGpuProgramParm_GetPushConstantSize( newParms[uniformIndex].type );
-					}
-				}
+				const size_t value = values + valueIndex * sizeof( ksGltfMaterialValue );
+				ksGltfBakeWriter_Pointer( &writer, value + OFFSETOF_MEMBER( ksGltfMaterialValue, uniform ) );
+				ksGltfBakeWriter_Pointer( &writer, value + OFFSETOF_MEMBER( ksGltfMaterialValue, value.texture ) );
+			}
+		}
+	}
+	{
+		const size_t skins = ksGltfBakeWriter_Data( &writer, s + OFFSETOF_MEMBER( ksGltfScene, skins ), scene->skinCount * sizeof( ksGltfSkin ) );
+		ksGltfBakeWriter_Data( &writer, s + OFFSETOF_MEMBER( ksGltfScene, skinNameHash ), ksGltf_GetHashSize( scene->skinCount ) * sizeof( int ) );
+		for ( int skinIndex = 0; skinIndex < scene->skinCount; skinIndex++ )
+		{
+			const ksGltfSkin * skin = &scene->skins[skinIndex];
+			const size_t k = skins + skinIndex * sizeof( ksGltfSkin );
+			ksGltfBakeWriter_String( &writer, k + OFFSETOF_MEMBER( ksGltfSkin, name ) );
+			ksGltfBakeWriter_Pointer( &writer, k + OFFSETOF_MEMBER( ksGltfSkin, parentNode ) );
+			ksGltfBakeWriter_Data( &writer, k + OFFSETOF_MEMBER( ksGltfSkin, defaultInverseBindMatrices ), MAX( skin->jointCount, 1 ) * sizeof( ksMatrix4x4f ) );
+			if ( skin->inverseBindMatrices == skin->defaultInverseBindMatrices )
+			{
+				ksGltfBakeWriter_Pointer( &writer, k + OFFSETOF_MEMBER( ksGltfSkin, inverseBindMatrices ) );
+			}
+			else
+			{
+				ksGltfBakeWriter_Data( &writer, k + OFFSETOF_MEMBER( ksGltfSkin, inverseBindMatrices ), skin->jointCount * sizeof( ksMatrix4x4f ) );
+			}
+			ksGltfBakeWriter_BoundsArray( &writer, k + OFFSETOF_MEMBER( ksGltfSkin, jointGeometryBounds ), skin->jointCount );
+			const size_t joints = ksGltfBakeWriter_Data( &writer, k + OFFSETOF_MEMBER( ksGltfSkin, joints ), skin->jointCount * sizeof( ksGltfJoint ) );
+			for ( int jointIndex = 0; jointIndex < skin->jointCount; jointIndex++ )
+			{
+				const size_t joint = joints + jointIndex * sizeof( ksGltfJoint );
+				ksGltfBakeWriter_String( &writer, joint + OFFSETOF_MEMBER( ksGltfJoint, name ) );
+				ksGltfBakeWriter_Pointer( &writer, joint + OFFSETOF_MEMBER( ksGltfJoint, node ) );
+			}
+			ksGltfBakeWriter_Clear( &writer, k + OFFSETOF_MEMBER( ksGltfSkin, jointBuffer ), SIZEOF_MEMBER( ksGltfSkin, jointBuffer ) );
+		}
+	}
+	{
+		const size_t models = ksGltfBakeWriter_Data( &writer, s + OFFSETOF_MEMBER( ksGltfScene, models ), scene->modelCount * sizeof( ksGltfModel ) );
+		ksGltfBakeWriter_Data( &writer, s + OFFSETOF_MEMBER( ksGltfScene, modelNameHash ), ksGltf_GetHashSize( scene->modelCount ) * sizeof( int ) );
+		for ( int modelIndex = 0; modelIndex < scene->modelCount; modelIndex++ )
+		{
+			const ksGltfModel * model = &scene->models[modelIndex];
+			const size_t m = models + modelIndex * sizeof( ksGltfModel );
+			ksGltfBakeWriter_String( &writer, m + OFFSETOF_MEMBER( ksGltfModel, name ) );
+			const size_t surfaces = ksGltfBakeWriter_Data( &writer, m + OFFSETOF_MEMBER( ksGltfModel, surfaces ), model->surfaceCount * sizeof( ksGltfSurface ) );
+			for ( int surfaceIndex = 0; surfaceIndex < model->surfaceCount; surfaceIndex++ )
+			{
+				const size_t surface = surfaces + surfaceIndex * sizeof( ksGltfSurface );
+				ksGltfBakeWriter_Pointer( &writer, surface + OFFSETOF_MEMBER( ksGltfSurface, material ) );
+				ksGltfBakeWriter_Pointer( &writer, surface + OFFSETOF_MEMBER( ksGltfSurface, geometryBuffer ) );
+				ksGltfBakeWriter_Clear( &writer, surface + OFFSETOF_MEMBER( ksGltfSurface, geometry ), SIZEOF_MEMBER( ksGltfSurface, geometry ) );
+				ksGltfBakeWriter_Clear( &writer, surface + OFFSETOF_MEMBER( ksGltfSurface, pipeline ), SIZEOF_MEMBER( ksGltfSurface, pipeline ) );
+			}
+			ksGltfBakeWriter_BoundsArray( &writer, m + OFFSETOF_MEMBER( ksGltfModel, surfaceBounds ), model->surfaceCount );
+		}
+	}
+	{
+		const size_t geometryBuffers = ksGltfBakeWriter_Data( &writer, s + OFFSETOF_MEMBER( ksGltfScene, geometryBuffers ), scene->geometryBufferCount * sizeof( ksGltfGeometryBuffer ) );
+		for ( int bufferIndex = 0; bufferIndex < scene->geometryBufferCount; bufferIndex++ )
+		{
+			const size_t geometryBuffer = geometryBuffers + bufferIndex * sizeof( ksGltfGeometryBuffer );
+			ksGltfBakeWriter_Pointer( &writer, geometryBuffer + OFFSETOF_MEMBER( ksGltfGeometryBuffer, layout ) );
+			ksGltfBakeWriter_Clear( &writer, geometryBuffer + OFFSETOF_MEMBER( ksGltfGeometryBuffer, geometry ), SIZEOF_MEMBER( ksGltfGeometryBuffer, geometry ) );
+		}
+	}
+	{
+		const size_t timeLines = ksGltfBakeWriter_Data( &writer, s + OFFSETOF_MEMBER( ksGltfScene, timeLines ), scene->timeLineCount * sizeof( ksGltfTimeLine ) );
+		ksGltfBakeWriter_Data( &writer, s + OFFSETOF_MEMBER( ksGltfScene, timeLineNameHash ), ksGltf_GetHashSize( scene->timeLineCount ) * sizeof( int ) );
+		for ( int timeLineIndex = 0; timeLineIndex < scene->timeLineCount; timeLineIndex++ )
+		{
+			ksGltfBakeWriter_Data( &writer, timeLines + timeLineIndex * sizeof( ksGltfTimeLine ) + OFFSETOF_MEMBER( ksGltfTimeLine, sampleTimes ),
+									scene->timeLines[timeLineIndex].sampleCount * sizeof( float ) );
+		}
+	}
+	{
+		const size_t animations = ksGltfBakeWriter_Data( &writer, s + OFFSETOF_MEMBER( ksGltfScene, animations ), scene->animationCount * sizeof( ksGltfAnimation ) );
+		ksGltfBakeWriter_Data( &writer, s + OFFSETOF_MEMBER( ksGltfScene, animationNameHash ), ksGltf_GetHashSize( scene->animationCount ) * sizeof( int ) );
+		for ( int animationIndex = 0; animationIndex < scene->animationCount; animationIndex++ )
+		{
+			const ksGltfAnimation * animation = &scene->animations[animationIndex];
+			const size_t a = animations + animationIndex * sizeof( ksGltfAnimation );
+			ksGltfBakeWriter_String( &writer, a + OFFSETOF_MEMBER( ksGltfAnimation, name ) );
+			ksGltfBakeWriter_Pointer( &writer, a + OFFSETOF_MEMBER( ksGltfAnimation, timeLine ) );
+			const size_t channels = ksGltfBakeWriter_Data( &writer, a + OFFSETOF_MEMBER( ksGltfAnimation, channels ), animation->channelCount * sizeof( ksGltfAnimationChannel ) );
+			for ( int channelIndex = 0; channelIndex < animation->channelCount; channelIndex++ )
+			{
+				const size_t channel = channels + channelIndex * sizeof( ksGltfAnimationChannel );
+				ksGltfBakeWriter_String( &writer, channel + OFFSETOF_MEMBER( ksGltfAnimationChannel, nodeName ) );
+				ksGltfBakeWriter_Pointer( &writer, channel + OFFSETOF_MEMBER( ksGltfAnimationChannel, node ) );
+				const size_t keyFrames = channel + OFFSETOF_MEMBER( ksGltfAnimationChannel, keyFrames );
+				ksGltfBakeWriter_Data( &writer, keyFrames + OFFSETOF_MEMBER( ksGltfCompressedKeyFrames, data ), animation->channels[channelIndex].keyFrames.dataSize );
+				ksGltfBakeWriter_Pointer( &writer, keyFrames + OFFSETOF_MEMBER( ksGltfCompressedKeyFrames, translation ) );
+				ksGltfBakeWriter_Pointer( &writer, keyFrames + OFFSETOF_MEMBER( ksGltfCompressedKeyFrames, rotation ) );
+				ksGltfBakeWriter_Pointer( &writer, keyFrames + OFFSETOF_MEMBER( ksGltfCompressedKeyFrames, scale ) );
+				ksGltfBakeWriter_Pointer( &writer, keyFrames + OFFSETOF_MEMBER( ksGltfCompressedKeyFrames, keyMask ) );
+				ksGltfBakeWriter_Pointer( &writer, keyFrames + OFFSETOF_MEMBER( ksGltfCompressedKeyFrames, keyRank ) );
+				ksGltfBakeWriter_Pointer( &writer, keyFrames + OFFSETOF_MEMBER( ksGltfCompressedKeyFrames, keyFrames ) );
 			}
+		}
+	}
+	{
+		const size_t cameras = ksGltfBakeWriter_Data( &writer, s + OFFSETOF_MEMBER( ksGltfScene, cameras ), scene->cameraCount * sizeof( ksGltfCamera ) );
+		ksGltfBakeWriter_Data( &writer, s + OFFSETOF_MEMBER( ksGltfScene, cameraNameHash ), ksGltf_GetHashSize( scene->cameraCount ) * sizeof( int ) );
+		for ( int cameraIndex = 0; cameraIndex < scene->cameraCount; cameraIndex++ )
+		{
+			ksGltfBakeWriter_String( &writer, cameras + cameraIndex * sizeof( ksGltfCamera ) + OFFSETOF_MEMBER( ksGltfCamera, name ) );
+		}
+	}
+	{
+		const size_t nodes = ksGltfBakeWriter_Data( &writer, s + OFFSETOF_MEMBER( ksGltfScene, nodes ), scene->nodeCount * sizeof( ksGltfNode ) );
+		ksGltfBakeWriter_Data( &writer, s + OFFSETOF_MEMBER( ksGltfScene, nodeNameHash ), ksGltf_GetHashSize( scene->nodeCount ) * sizeof( int ) );
+		ksGltfBakeWriter_Data( &writer, s + OFFSETOF_MEMBER( ksGltfScene, nodeJointNameHash ), ksGltf_GetHashSize( scene->nodeCount ) * sizeof( int ) );
+		for ( int nodeIndex = 0; nodeIndex < scene->nodeCount; nodeIndex++ )
+		{
+			const ksGltfNode * node = &scene->nodes[nodeIndex];
+			const size_t n = nodes + nodeIndex * sizeof( ksGltfNode );
+			ksGltfBakeWriter_String( &writer, n + OFFSETOF_MEMBER( ksGltfNode, name ) );
+			ksGltfBakeWriter_String( &writer, n + OFFSETOF_MEMBER( ksGltfNode, jointName ) );
+			ksGltfBakeWriter_PointerArray( &writer, n + OFFSETOF_MEMBER( ksGltfNode, children ), node->childCount );
+			ksGltfBakeWriter_Clear( &writer, n + OFFSETOF_MEMBER( ksGltfNode, childIndices ), SIZEOF_MEMBER( ksGltfNode, childIndices ) );
+			ksGltfBakeWriter_Pointer( &writer, n + OFFSETOF_MEMBER( ksGltfNode, parent ) );
+			ksGltfBakeWriter_Pointer( &writer, n + OFFSETOF_MEMBER( ksGltfNode, camera ) );
+			ksGltfBakeWriter_Pointer( &writer, n + OFFSETOF_MEMBER( ksGltfNode, skin ) );
+			ksGltfBakeWriter_PointerArray( &writer, n + OFFSETOF_MEMBER( ksGltfNode, models ), node->modelCount );
+			ksGltfBakeWriter_BoundsArray( &writer, n + OFFSETOF_MEMBER( ksGltfNode, modelBounds ), node->modelCount );
+		}
+	}
+	{
+		const size_t subTrees = ksGltfBakeWriter_Data( &writer, s + OFFSETOF_MEMBER( ksGltfScene, subTrees ), scene->subTreeCount * sizeof( ksGltfSubTree ) );
+		ksGltfBakeWriter_Data( &writer, s + OFFSETOF_MEMBER( ksGltfScene, subTreeNameHash ), ksGltf_GetHashSize( scene->subTreeCount ) * sizeof( int ) );
+		for ( int subTreeIndex = 0; subTreeIndex < scene->subTreeCount; subTreeIndex++ )
+		{
+			const ksGltfSubTree * subTree = &scene->subTrees[subTreeIndex];
+			const size_t t = subTrees + subTreeIndex * sizeof( ksGltfSubTree );
+			ksGltfBakeWriter_String( &writer, t + OFFSETOF_MEMBER( ksGltfSubTree, name ) );
+			ksGltfBakeWriter_PointerArray( &writer, t + OFFSETOF_MEMBER( ksGltfSubTree, nodes ), subTree->nodeCount );
+			ksGltfBakeWriter_PointerArray( &writer, t + OFFSETOF_MEMBER( ksGltfSubTree, timeLines ), subTree->timeLineCount );
+			ksGltfBakeWriter_PointerArray( &writer, t + OFFSETOF_MEMBER( ksGltfSubTree, animations ), subTree->animationCount );
+		}
+	}
+	{
+		const size_t subScenes = ksGltfBakeWriter_Data( &writer, s + OFFSETOF_MEMBER( ksGltfScene, subScenes ), scene->subSceneCount * sizeof( ksGltfSubScene ) );
+		ksGltfBakeWriter_Data( &writer, s + OFFSETOF_MEMBER( ksGltfScene, subSceneNameHash ), ksGltf_GetHashSize( scene->subSceneCount ) * sizeof( int ) );
+		for ( int subSceneIndex = 0; subSceneIndex < scene->subSceneCount; subSceneIndex++ )
+		{
+			const size_t subScene = subScenes + subSceneIndex * sizeof( ksGltfSubScene );
+			ksGltfBakeWriter_String( &writer, subScene + OFFSETOF_MEMBER( ksGltfSubScene, name ) );
+			ksGltfBakeWriter_PointerArray( &writer, subScene + OFFSETOF_MEMBER( ksGltfSubScene, subTrees ), scene->subScenes[subSceneIndex].subTreeCount );
+		}
+		ksGltfBakeWriter_Pointer( &writer, s + OFFSETOF_MEMBER( ksGltfScene, state.currentSubScene ) );
+	}
 
-			free( technique->parms );
-			free( technique->uniforms );
+	// The shaders, images, vertices and indices are written last.
+	{
+		const size_t textures = ksGltfBakeWriter_Data( &writer, root + OFFSETOF_MEMBER( ksGltfBakedScene, textures ), scene->textureCount * sizeof( ksGltfBakedTexture ) );
+		const size_t programs = ksGltfBakeWriter_Data( &writer, root + OFFSETOF_MEMBER( ksGltfBakedScene, programs ), scene->techniqueCount * sizeof( ksGltfBakedProgram ) );
+		const size_t vertexData = ksGltfBakeWriter_Data( &writer, root + OFFSETOF_MEMBER( ksGltfBakedScene, vertexData ), scene->geometryBufferCount * sizeof( void * ) );
+		for ( int techniqueIndex = 0; techniqueIndex < scene->techniqueCount; techniqueIndex++ )
+		{
+			const ksGltfBakedProgram * bakedProgram = &bakedScene->programs[techniqueIndex];
+			const size_t program = programs + techniqueIndex * sizeof( ksGltfBakedProgram );
+			ksGltfBakeWriter_Data( &writer, program + OFFSETOF_MEMBER( ksGltfBakedProgram, vertexSource ), bakedProgram->vertexSourceSize );
+			ksGltfBakeWriter_Data( &writer, program + OFFSETOF_MEMBER( ksGltfBakedProgram, fragmentSource ), bakedProgram->fragmentSourceSize );
+		}
+		for ( int textureIndex = 0; textureIndex < scene->textureCount; textureIndex++ )
+		{
+			ksGltfBakeWriter_Data( &writer, textures + textureIndex * sizeof( ksGltfBakedTexture ) + OFFSETOF_MEMBER( ksGltfBakedTexture, data ),
+									bakedScene->textures[textureIndex].dataSize );
+		}
+		for ( int bufferIndex = 0; bufferIndex < scene->geometryBufferCount; bufferIndex++ )
+		{
+			const ksGltfGeometryBuffer * geometryBuffer = &scene->geometryBuffers[bufferIndex];
+			ksGltfBakeWriter_Data( &writer, vertexData + bufferIndex * sizeof( void * ),
+									ksGpuVertexAttributeArrays_GetDataSize( geometryBuffer->layout, geometryBuffer->vertexCount, geometryBuffer->vertexAttribsFlags ) );
+		}
+		ksGltfBakeWriter_Data( &writer, root + OFFSETOF_MEMBER( ksGltfBakedScene, indexData ), scene->geometryIndexCount * sizeof( ksGpuTriangleIndex ) );
+	}
 
-			technique->parms = newParms;
-			technique->uniforms = newUniforms;
-			technique->uniformCount = newUniformCount;
+	if ( !ksGltfBakeWriter_Finish( &writer, &header.relocationOffset, &header.relocationCount ) )
+	{
+		Print( "Failed to bake %s because of an unresolved pointer\n", settings->glTF );
+		ksGltfBakeWriter_Destroy( &writer );
+		return false;
+	}
+
+	header.dataSize = writer.dataSize;
+	header.sceneOffset = root;
+	memcpy( writer.data + headerOffset, &header, sizeof( header ) );
+
+	// A partially written file fails the size check when it is loaded.
+	FILE * file = fopen( fileName, "wb" );
+	const bool written = ( file != NULL && fwrite( writer.data, 1, writer.dataSize, file ) == writer.dataSize );
+	if ( file != NULL )
+	{
+		fclose( file );
+	}
+	if ( !written )
+	{
+		Print( "Failed to write %s\n", fileName );
+	}
+
+	ksGltfBakeWriter_Destroy( &writer );
+	return written;
+}
+
+// Loads a baked scene and only creates the graphics API objects.
+// Returns false if there is no baked scene or if it is out of date.
+static bool ksGltf_LoadBakedScene( ksGpuContext * context, ksGltfScene * scene, const ksSceneSettings * settings, ksGpuRenderPass * renderPass )
+{
+	const ksNanoseconds t0 = GetTimeNanoseconds();
+
+	const char * errorString = "";
+	size_t dataSize = 0;
+	bool dataMapped = false;
+	unsigned char * data = (unsigned char *) ksJson_LoadFile( settings->glTFCache, false, &dataSize, &dataMapped, &errorString );
+	if ( data == NULL )
+	{
+		return false;
+	}
+
+	ksGltfBakedHeader header;
+	memset( &header, 0, sizeof( header ) );
+	memcpy( &header, data, MIN( dataSize, sizeof( header ) ) );
+
+	if ( dataSize < sizeof( header ) ||
+			header.magic != GLTF_BAKED_MAGIC ||
+			header.version != GLTF_BAKED_VERSION ||
+			header.layoutSignature != ksGltf_GetBakedLayoutSignature() ||
+			header.conversion != ksGltf_GetBakedConversion( settings ) ||
+			header.dataSize != dataSize ||
+			header.sceneOffset + sizeof( ksGltfBakedScene ) > dataSize ||
+			header.relocationOffset + header.relocationCount * sizeof( uint64_t ) > dataSize ||
+			!ksGltf_IsBakedSceneUpToDate( data, dataSize, &header, settings->glTF ) )
+	{
+		Print( "Baked scene %s is out of date\n", settings->glTFCache );
+		ksJson_UnloadFile( (char *) data, dataSize, dataMapped );
+		return false;
+	}
+
+	// Turn the offsets into pointers. Only the pages with pointers are written to and copied.
+	const uint64_t * relocations = (const uint64_t *)( data + header.relocationOffset );
+	for ( uint64_t relocationIndex = 0; relocationIndex < header.relocationCount; relocationIndex++ )
+	{
+		if ( relocations[relocationIndex] + sizeof( uintptr_t ) > header.relocationOffset )
+		{
+			Print( "Baked scene %s is corrupt\n", settings->glTFCache );
+			ksJson_UnloadFile( (char *) data, dataSize, dataMapped );
+			return false;
 		}
+		uintptr_t offset;
+		memcpy( &offset, data + relocations[relocationIndex], sizeof( offset ) );
+		offset += (uintptr_t) data;
+		memcpy( data + relocations[relocationIndex], &offset, sizeof( offset ) );
+	}
 
-		ksGltfInOutParm inOutParms[16];
-		int inOutParmCount = 0;
+	const ksGltfBakedScene * bakedScene = (const ksGltfBakedScene *)( data + header.sceneOffset );
 
-		size_t vertexSourceSize = program->vertexSourceSize;
-		size_t fragmentSourceSize = program->fragmentSourceSize;
+	*scene = bakedScene->scene;
+	scene->bakedData = data;
+	scene->bakedDataSize = dataSize;
+	scene->bakedDataMapped = dataMapped;
 
-		unsigned char * vertexSource = ksGltf_ConvertShaderGLSL( program->vertexSource, &vertexSourceSize, KS_GPU_PROGRAM_STAGE_FLAG_VERTEX, conversion,
-																	technique, semanticUniforms, newSemanticUniforms, inOutParms, &inOutParmCount );
-		unsigned char * fragmentSource = ksGltf_ConvertShaderGLSL( program->fragmentSource, &fragmentSourceSize, KS_GPU_PROGRAM_STAGE_FLAG_FRAGMENT, conversion,
-																	technique, semanticUniforms, newSemanticUniforms, inOutParms, &inOutParmCount );
+	const ksNanoseconds t1 = GetTimeNanoseconds();
 
-		for ( int uniformIndex = 0; uniformIndex < technique->uniformCount; uniformIndex++ )
+	for ( int textureIndex = 0; textureIndex < scene->textureCount; textureIndex++ )
+	{
+		ksGltfTexture * texture = &scene->textures[textureIndex];
+		const ksGltfBakedTexture * bakedTexture = &bakedScene->textures[textureIndex];
+		if ( bakedTexture->data == NULL || !ksGpuTexture_CreateFromKTX( context, &texture->texture, texture->name, bakedTexture->data, bakedTexture->dataSize ) )
 		{
-			assert( technique->parms[uniformIndex].stageFlags != 0 );
+			ksGltf_CreateWhiteTexture( context, &texture->texture );
 		}
+	}
 
+	for ( int techniqueIndex = 0; techniqueIndex < scene->techniqueCount; techniqueIndex++ )
+	{
+		ksGltfTechnique * technique = &scene->techniques[techniqueIndex];
+		const ksGltfBakedProgram * bakedProgram = &bakedScene->programs[techniqueIndex];
 		ksGpuGraphicsProgram_Create( context, &technique->program,
-									vertexSource, vertexSourceSize,
-									fragmentSource, fragmentSourceSize,
+									bakedProgram->vertexSource, bakedProgram->vertexSourceSize,
+									bakedProgram->fragmentSource, bakedProgram->fragmentSourceSize,
 									technique->parms, technique->uniformCount,
 									technique->vertexAttributeLayout, technique->vertexAttribsFlags );
+	}
 
-		free( vertexSource );
-		free( fragmentSource );
+	for ( int skinIndex = 0; skinIndex < scene->skinCount; skinIndex++ )
+	{
+		ksGpuBuffer_Create( context, &scene->skins[skinIndex].jointBuffer, KS_GPU_BUFFER_TYPE_UNIFORM, scene->skins[skinIndex].jointCount * sizeof( ksMatrix4x4f ), NULL, false );
 	}
-	else
-#else
-	UNUSED_PARM( conversion );
-	UNUSED_PARM( semanticUniforms );
-#endif
+
+	// The vertices and indices are uploaded straight from the baked data.
+	for ( int bufferIndex = 0; bufferIndex < scene->geometryBufferCount; bufferIndex++ )
 	{
-		ksGpuGraphicsProgram_Create( context, &technique->program,
-									program->vertexSource, program->vertexSourceSize,
-									program->fragmentSource, program->fragmentSourceSize,
-									technique->parms, technique->uniformCount,
-									technique->vertexAttributeLayout, technique->vertexAttribsFlags );
+		ksGltf_CreateGeometryBuffer( context, scene, &scene->geometryBuffers[bufferIndex], bakedScene->vertexData[bufferIndex], bakedScene->indexData );
 	}
+
+	ksGltf_CreateSurfaceGeometry( context, scene, renderPass );
+
+	ksGltf_CreateRunTimeState( context, scene, renderPass );
+
+	const ksNanoseconds t2 = GetTimeNanoseconds();
+
+	Print( "%1.3f seconds to map and relocate %s\n", ( t1 - t0 ) * 1e-9f, settings->glTFCache );
+	Print( "%1.3f seconds to create graphics objects\n", ( t2 - t1 ) * 1e-9f );
+	Print( "%1.3f seconds to load %s from %s\n", ( t2 - t0 ) * 1e-9f, settings->glTF, settings->glTFCache );
+
+	return true;
 }
 
-// Sort the nodes such that parents come before their children and every sub-tree is a contiguous sequence of nodes.
-// Note that the node graph must be acyclic and no node may be a direct or indirect descendant of more than one node.
-static void ksGltf_SortNodes( ksGltfNode * nodes, const int nodeCount )
+static void ksGltf_DestroyBakedScene( ksGpuContext * context, ksGltfScene * scene )
 {
-	ksGltfNode * nodeStack = (ksGltfNode *) malloc( nodeCount * sizeof( ksGltfNode ) );
-	int stackSize = 0;
-	int stackOffset = 0;
-	for ( int nodeIndex = 0; nodeIndex < nodeCount; nodeIndex++ )
+	for ( int textureIndex = 0; textureIndex < scene->textureCount; textureIndex++ )
 	{
-		bool foundParent = false;
-		for ( int nodeSearchIndex = 0; nodeSearchIndex < nodeCount; nodeSearchIndex++ )
-		{
-			for ( int childIndex = 0; childIndex < nodes[nodeSearchIndex].childCount; childIndex++ )
-			{
-				if ( strcmp( nodes[nodeSearchIndex].childNames[childIndex], nodes[nodeIndex].name ) == 0 )
-				{
-					foundParent = true;
-					break;
-				}
-			}
-		}
-		if ( !foundParent )
-		{
-			const int subTreeStartOffset = stackSize;
-			nodeStack[stackSize++] = nodes[nodeIndex];
-			while( stackOffset < stackSize )
-			{
-				const ksGltfNode * node = &nodeStack[stackOffset++];
-				for ( int childIndex = 0; childIndex < node->childCount; childIndex++ )
-				{
-					for ( int nodeSearchIndex = 0; nodeSearchIndex < nodeCount; nodeSearchIndex++ )
-					{
-						if ( strcmp( node->childNames[childIndex], nodes[nodeSearchIndex].name ) == 0 )
-						{
-							assert( stackSize < nodeCount );
-							nodeStack[stackSize++] = nodes[nodeSearchIndex];
-							break;
-						}
-					}
-				}
-			}
-			for ( int updateNodeIndex = subTreeStartOffset; updateNodeIndex < stackSize; updateNodeIndex++ )
-			{
-				nodeStack[updateNodeIndex].subTreeNodeCount = stackSize - updateNodeIndex;
-			}
-		}
+		ksGpuTexture_Destroy( context, &scene->textures[textureIndex].texture );
+	}
+	for ( int techniqueIndex = 0; techniqueIndex < scene->techniqueCount; techniqueIndex++ )
+	{
+		ksGpuGraphicsProgram_Destroy( context, &scene->techniques[techniqueIndex].program );
+	}
+	ksGltf_DestroySurfaceGeometry( context, scene );
+	for ( int skinIndex = 0; skinIndex < scene->skinCount; skinIndex++ )
+	{
+		ksGpuBuffer_Destroy( context, &scene->skins[skinIndex].jointBuffer );
 	}
-	assert( stackSize == nodeCount );
-	memcpy( nodes, nodeStack, nodeCount * sizeof( nodes[0] ) );
-	free( nodeStack );
-}
 
-#if defined( _MSC_VER )
-#define strcasecmp _stricmp
-#endif
+	ksJson_UnloadFile( (char *) scene->bakedData, scene->bakedDataSize, scene->bakedDataMapped );
+}
 
 static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * scene, ksSceneSettings * settings, ksGpuRenderPass * renderPass )
 {
@@ -2969,8 +6122,10 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 
 	memset( scene, 0, sizeof( ksGltfScene ) );
 
-	// Based on a GL_MAX_UNIFORM_BLOCK_SIZE of 16384 on the ARM Mali.
-	const int MAX_JOINTS = 16384 / sizeof( ksMatrix4x4f );
+	if ( settings->glTFCache != NULL && ksGltf_LoadBakedScene( context, scene, settings, renderPass ) )
+	{
+		return true;
+	}
 
 	ksJson * rootNode = ksJson_Create();
 
@@ -2985,68 +6140,90 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 	const size_t fileNameLength = strlen( fileName );
 	if ( fileNameLength > 4 && strcasecmp( &fileName[fileNameLength - 4], ".glb" ) == 0 )
 	{
-		FILE * binaryFile = fopen( fileName, "rb" );
-		if ( binaryFile == NULL )
+		// The binary glTF file is memory mapped when possible and the binary buffer is referenced in place.
+		const char * errorString = "";
+		size_t binaryFileSize = 0;
+		bool binaryFileMapped = false;
+		unsigned char * binaryFileData = (unsigned char *) ksJson_LoadFile( fileName, false, &binaryFileSize, &binaryFileMapped, &errorString );
+		if ( binaryFileData == NULL )
 		{
 			ksJson_Destroy( rootNode );
-			Error( "Failed to open %s", fileName );
+			Error( "Failed to open %s (%s)", fileName, errorString );
 			return false;
 		}
 
 		ksGltfBinaryHeader header;
-		if ( fread( &header, 1, sizeof( header ), binaryFile ) != sizeof( header ) )
+		memset( &header, 0, sizeof( header ) );
+		memcpy( &header, binaryFileData, MIN( binaryFileSize, sizeof( header ) ) );
+
+		const char * content = NULL;
+		size_t contentLength = 0;
+
+		if ( binaryFileSize >= sizeof( header ) && header.magic == GLTF_BINARY_MAGIC && header.length <= binaryFileSize &&
+				header.version == GLTF_BINARY_VERSION_1 && header.contentFormat == GLTF_BINARY_CONTENT_FORMAT &&
+					sizeof( header ) + header.contentLength <= header.length )
 		{
-			fclose( binaryFile );
-			ksJson_Destroy( rootNode );
-			Error( "Failed to read glTF binary header %s", fileName );
-			return false;
+			assert( ( ( sizeof( header ) + header.contentLength ) & 3 ) == 0 );
+			content = (const char *)( binaryFileData + sizeof( header ) );
+			contentLength = header.contentLength;
+			binaryBuffer = binaryFileData + sizeof( header ) + header.contentLength;
+			binaryBufferLength = header.length - header.contentLength - sizeof( header );
+		}
+		else if ( binaryFileSize >= 3 * sizeof( uint32_t ) && header.magic == GLTF_BINARY_MAGIC && header.length <= binaryFileSize &&
+					header.version == GLTF_BINARY_VERSION_2 )
+		{
+			// The first chunk is the JSON content and the optional second chunk is the binary buffer.
+			size_t chunkOffset = 3 * sizeof( uint32_t );
+			while ( chunkOffset + sizeof( ksGltfBinaryChunkHeader ) <= header.length )
+			{
+				ksGltfBinaryChunkHeader chunk;
+				memcpy( &chunk, binaryFileData + chunkOffset, sizeof( chunk ) );
+				const size_t chunkDataOffset = chunkOffset + sizeof( chunk );
+				if ( chunk.chunkLength > header.length - chunkDataOffset )
+				{
+					break;
+				}
+				if ( chunk.chunkType == GLTF_BINARY_CHUNK_TYPE_JSON && content == NULL )
+				{
+					content = (const char *)( binaryFileData + chunkDataOffset );
+					contentLength = chunk.chunkLength;
+				}
+				else if ( chunk.chunkType == GLTF_BINARY_CHUNK_TYPE_BIN && binaryBuffer == NULL )
+				{
+					binaryBuffer = binaryFileData + chunkDataOffset;
+					binaryBufferLength = chunk.chunkLength;
+				}
+				chunkOffset = chunkDataOffset + ( ( chunk.chunkLength + 3 ) & ~3 );
+			}
 		}
 
-		if ( header.magic != GLTF_BINARY_MAGIC || header.version != GLTF_BINARY_VERSION || header.contentFormat != GLTF_BINARY_CONTENT_FORMAT )
+		if ( content == NULL )
 		{
-			fclose( binaryFile );
+			ksJson_UnloadFile( (char *) binaryFileData, binaryFileSize, binaryFileMapped );
 			ksJson_Destroy( rootNode );
 			Error( "Invalid glTF binary header %s", fileName );
 			return false;
 		}
 
-		char * content = (char *) malloc( header.contentLength + 1 );
-		if ( fread( content, 1, header.contentLength, binaryFile ) != header.contentLength )
-		{
-			free( content );
-			fclose( binaryFile );
-			ksJson_Destroy( rootNode );
-			Error( "Failed to read binary glTF content %s", fileName );
-			return false;
-		}
-		content[header.contentLength] = '\0';	// make sure the buffer is zero terminated
+		// The JSON content is not zero terminated in the binary file.
+		char * json = (char *) malloc( contentLength + 1 );
+		memcpy( json, content, contentLength );
+		json[contentLength] = '\0';
 
-		const char * errorString = "";
-		if ( !ksJson_ReadFromBuffer( rootNode, content, &errorString ) )
+		if ( !ksJson_ReadFromBuffer( rootNode, json, &errorString ) )
 		{
-			free( content );
-			fclose( binaryFile );
+			free( json );
+			ksJson_UnloadFile( (char *) binaryFileData, binaryFileSize, binaryFileMapped );
 			ksJson_Destroy( rootNode );
 			Error( "Failed to load %s (%s)", fileName, errorString );
 			return false;
 		}
 
-		free( content );
+		free( json );
 
-		assert( ( ( sizeof( header ) + header.contentLength ) & 3 ) == 0 );
-
-		binaryBufferLength = header.length - header.contentLength - sizeof( header );
-		binaryBuffer = (unsigned char *) malloc( binaryBufferLength );
-		if ( fread( binaryBuffer, 1, binaryBufferLength, binaryFile ) != binaryBufferLength )
-		{
-			free( binaryBuffer );
-			fclose( binaryFile );
-			ksJson_Destroy( rootNode );
-			Error( "Failed to read binary glTF content %s", fileName );
-			return false;
-		}
-
-		fclose( binaryFile );
+		scene->binaryFileData = binaryFileData;
+		scene->binaryFileSize = binaryFileSize;
+		scene->binaryFileMapped = binaryFileMapped;
 	}
 	else
 	{
@@ -3065,12 +6242,34 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 
 	const ksJson * asset = ksJson_GetMemberByName( rootNode, "asset" );
 	const char * version = ksJson_GetString( ksJson_GetMemberByName( asset, "version" ), "1.0" );
-	if ( strcmp( version, GLTF_JSON_VERSION_10 ) != 0 && strcmp( version, GLTF_JSON_VERSION_101 ) != 0 )
+	if ( strcmp( version, GLTF_JSON_VERSION_10 ) != 0 && strcmp( version, GLTF_JSON_VERSION_101 ) != 0 && strcmp( version, GLTF_JSON_VERSION_20 ) != 0 )
 	{
-		Error( "glTF version is %s instead of %s", version, GLTF_JSON_VERSION_10 );
+		Error( "glTF version is %s instead of %s or %s", version, GLTF_JSON_VERSION_10, GLTF_JSON_VERSION_20 );
 		ksJson_Destroy( rootNode );
+		if ( scene->binaryFileData != NULL )
+		{
+			ksJson_UnloadFile( (char *) scene->binaryFileData, scene->binaryFileSize, scene->binaryFileMapped );
+			scene->binaryFileData = NULL;
+		}
 		return false;
 	}
+	const bool version2 = ( strcmp( version, GLTF_JSON_VERSION_20 ) == 0 );
+
+	// Maps the original node indices to the sorted node indices.
+	int * nodeIndexRemap = NULL;
+
+	// Buffers, images and shaders are read once all objects are allocated.
+	ksGltfReadJob * readJobs = NULL;
+	int readJobCount = 0;
+	int firstBufferReadJob = 0;
+	int firstTextureReadJob = 0;
+	int firstProgramReadJob = 0;
+
+	// Shaders are converted once they are read.
+	ksGltfTechniqueProgram * techniquePrograms = NULL;
+
+	// The data that is only needed to bake the scene is recorded while loading.
+	ksGltfBakedScene * bakedScene = ( settings->glTFCache != NULL ) ? (ksGltfBakedScene *) calloc( 1, sizeof( ksGltfBakedScene ) ) : NULL;
 
 	//
 	// glTF buffers
@@ -3081,24 +6280,32 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 		const ksJson * buffers = ksJson_GetMemberByName( rootNode, "buffers" );
 		scene->bufferCount = ksJson_GetMemberCount( buffers );
 		scene->buffers = (ksGltfBuffer *) calloc( scene->bufferCount, sizeof( ksGltfBuffer ) );
+		firstBufferReadJob = ksGltf_AddReadJobs( &readJobs, &readJobCount, scene->bufferCount );
 		for ( int bufferIndex = 0; bufferIndex < scene->bufferCount; bufferIndex++ )
 		{
 			const ksJson * buffer = ksJson_GetMemberByIndex( buffers, bufferIndex );
-			scene->buffers[bufferIndex].name = ksGltf_strdup( ksJson_GetMemberName( buffer ) );
+			scene->buffers[bufferIndex].name = ksGltf_ParseName( buffer, "buffer", bufferIndex );
 			scene->buffers[bufferIndex].byteLength = (size_t) ksJson_GetUint64( ksJson_GetMemberByName( buffer, "byteLength" ), 0 );
 			scene->buffers[bufferIndex].type = ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByName( buffer, "type" ), "" ) );
-			if ( strcmp( scene->buffers[bufferIndex].name, "binary_glTF" ) == 0 )
+			const char * uri = ksJson_GetString( ksJson_GetMemberByName( buffer, "uri" ), "" );
+			if (	( !version2 && strcmp( scene->buffers[bufferIndex].name, "binary_glTF" ) == 0 ) ||
+					( version2 && uri[0] == '\0' && binaryBuffer != NULL ) )
 			{
-				assert( scene->buffers[bufferIndex].byteLength == binaryBufferLength );
+				// The binary chunk of a glTF 2.0 binary file may be padded with up to 3 bytes.
+				assert( scene->buffers[bufferIndex].byteLength <= binaryBufferLength );
 				scene->buffers[bufferIndex].bufferData = binaryBuffer;
+				scene->buffers[bufferIndex].bufferDataSize = binaryBufferLength;
+				scene->buffers[bufferIndex].bufferDataStorage = GLTF_BUFFER_DATA_BINARY_GLTF;
 			}
 			else
 			{
-				scene->buffers[bufferIndex].bufferData = ksGltf_ReadUri( binaryBuffer, ksJson_GetString( ksJson_GetMemberByName( buffer, "uri" ), "" ), NULL );
+				// Base64 buffers are decoded and external buffer files are memory mapped when possible.
+				readJobs[firstBufferReadJob + bufferIndex].binaryBuffer = binaryBuffer;
+				readJobs[firstBufferReadJob + bufferIndex].uri = uri;
+				readJobs[firstBufferReadJob + bufferIndex].mapFile = true;
 			}
 			assert( scene->buffers[bufferIndex].name[0] != '\0' );
 			assert( scene->buffers[bufferIndex].byteLength != 0 );
-			assert( scene->buffers[bufferIndex].bufferData != NULL );
 		}
 		ksGltf_CreateBufferNameHash( scene );
 
@@ -3118,10 +6325,11 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 		for ( int bufferViewIndex = 0; bufferViewIndex < scene->bufferViewCount; bufferViewIndex++ )
 		{
 			const ksJson * view = ksJson_GetMemberByIndex( bufferViews, bufferViewIndex );
-			scene->bufferViews[bufferViewIndex].name = ksGltf_strdup( ksJson_GetMemberName( view ) );
-			scene->bufferViews[bufferViewIndex].buffer = ksGltf_GetBufferByName( scene, ksJson_GetString( ksJson_GetMemberByName( view, "buffer" ), "" ) );
+			scene->bufferViews[bufferViewIndex].name = ksGltf_ParseName( view, "bufferView", bufferViewIndex );
+			scene->bufferViews[bufferViewIndex].buffer = ksGltf_GetBufferByReference( scene, ksJson_GetMemberByName( view, "buffer" ) );
 			scene->bufferViews[bufferViewIndex].byteOffset = (size_t) ksJson_GetUint64( ksJson_GetMemberByName( view, "byteOffset" ), 0 );
 			scene->bufferViews[bufferViewIndex].byteLength = (size_t) ksJson_GetUint64( ksJson_GetMemberByName( view, "byteLength" ), 0 );
+			scene->bufferViews[bufferViewIndex].byteStride = (size_t) ksJson_GetUint64( ksJson_GetMemberByName( view, "byteStride" ), 0 );
 			scene->bufferViews[bufferViewIndex].target = ksJson_GetUint16( ksJson_GetMemberByName( view, "target" ), 0 );
 			assert( scene->bufferViews[bufferViewIndex].name[0] != '\0' );
 			assert( scene->bufferViews[bufferViewIndex].buffer != NULL );
@@ -3148,32 +6356,53 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 		for ( int accessorIndex = 0; accessorIndex < scene->accessorCount; accessorIndex++ )
 		{
 			const ksJson * access = ksJson_GetMemberByIndex( accessors, accessorIndex );
-			scene->accessors[accessorIndex].name = ksGltf_strdup( ksJson_GetMemberName( access ) );
-			scene->accessors[accessorIndex].bufferView = ksGltf_GetBufferViewByName( scene, ksJson_GetString( ksJson_GetMemberByName( access, "bufferView" ), "" ) );
+			scene->accessors[accessorIndex].name = ksGltf_ParseName( access, "accessor", accessorIndex );
+			scene->accessors[accessorIndex].bufferView = ksGltf_GetBufferViewByReference( scene, ksJson_GetMemberByName( access, "bufferView" ) );
 			scene->accessors[accessorIndex].byteOffset = (size_t) ksJson_GetUint64( ksJson_GetMemberByName( access, "byteOffset" ), 0 );
-			scene->accessors[accessorIndex].byteStride = (size_t) ksJson_GetUint64( ksJson_GetMemberByName( access, "byteStride" ), 0 );
+			if ( version2 )
+			{
+				// The glTF 2.0 byteStride is a property of the bufferView.
+				scene->accessors[accessorIndex].byteStride = ( scene->accessors[accessorIndex].bufferView != NULL ) ? scene->accessors[accessorIndex].bufferView->byteStride : 0;
+			}
+			else
+			{
+				scene->accessors[accessorIndex].byteStride = (size_t) ksJson_GetUint64( ksJson_GetMemberByName( access, "byteStride" ), 0 );
+			}
 			scene->accessors[accessorIndex].componentType = ksJson_GetUint16( ksJson_GetMemberByName( access, "componentType" ), 0 );
 			scene->accessors[accessorIndex].count = ksJson_GetInt32( ksJson_GetMemberByName( access, "count" ), 0 );
 			scene->accessors[accessorIndex].type =  ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByName( access, "type" ), "" ) );
+			scene->accessors[accessorIndex].componentCount = ksGltf_GetComponentCount( scene->accessors[accessorIndex].type );
+			scene->accessors[accessorIndex].normalized = ksJson_GetBool( ksJson_GetMemberByName( access, "normalized" ), false );
+			const ksJson * sparse = ksJson_GetMemberByName( access, "sparse" );
+			if ( sparse != NULL )
+			{
+				const ksJson * sparseIndices = ksJson_GetMemberByName( sparse, "indices" );
+				const ksJson * sparseValues = ksJson_GetMemberByName( sparse, "values" );
+				scene->accessors[accessorIndex].sparse.count = ksJson_GetInt32( ksJson_GetMemberByName( sparse, "count" ), 0 );
+				scene->accessors[accessorIndex].sparse.indicesBufferView = ksGltf_GetBufferViewByReference( scene, ksJson_GetMemberByName( sparseIndices, "bufferView" ) );
+				scene->accessors[accessorIndex].sparse.indicesByteOffset = (size_t) ksJson_GetUint64( ksJson_GetMemberByName( sparseIndices, "byteOffset" ), 0 );
+				scene->accessors[accessorIndex].sparse.indicesComponentType = ksJson_GetUint16( ksJson_GetMemberByName( sparseIndices, "componentType" ), 0 );
+				scene->accessors[accessorIndex].sparse.valuesBufferView = ksGltf_GetBufferViewByReference( scene, ksJson_GetMemberByName( sparseValues, "bufferView" ) );
+				scene->accessors[accessorIndex].sparse.valuesByteOffset = (size_t) ksJson_GetUint64( ksJson_GetMemberByName( sparseValues, "byteOffset" ), 0 );
+				assert( scene->accessors[accessorIndex].sparse.indicesBufferView != NULL );
+				assert( scene->accessors[accessorIndex].sparse.valuesBufferView != NULL );
+				if ( scene->accessors[accessorIndex].sparse.indicesBufferView == NULL || scene->accessors[accessorIndex].sparse.valuesBufferView == NULL )
+				{
+					scene->accessors[accessorIndex].sparse.count = 0;
+				}
+			}
 			const ksJson * min = ksJson_GetMemberByName( access, "min" );
 			const ksJson * max = ksJson_GetMemberByName( access, "max" );
 			if ( min != NULL && max != NULL )
 			{
-				int componentCount = 0;
-				if ( strcmp( scene->accessors[accessorIndex].type, "SCALAR" ) == 0 ) { componentCount = 1; }
-				else if ( strcmp( scene->accessors[accessorIndex].type, "VEC2" ) == 0 ) { componentCount = 2; }
-				else if ( strcmp( scene->accessors[accessorIndex].type, "VEC3" ) == 0 ) { componentCount = 3; }
-				else if ( strcmp( scene->accessors[accessorIndex].type, "VEC4" ) == 0 ) { componentCount = 4; }
-				else if ( strcmp( scene->accessors[accessorIndex].type, "MAT2" ) == 0 ) { componentCount = 4; }
-				else if ( strcmp( scene->accessors[accessorIndex].type, "MAT3" ) == 0 ) { componentCount = 9; }
-				else if ( strcmp( scene->accessors[accessorIndex].type, "MAT4" ) == 0 ) { componentCount = 16; }
-
+				const int componentCount = scene->accessors[accessorIndex].componentCount;
 				switch ( scene->accessors[accessorIndex].componentType )
 				{
 					case GL_BYTE:
 					case GL_UNSIGNED_BYTE:
 					case GL_SHORT:
 					case GL_UNSIGNED_SHORT:
+					case GL_UNSIGNED_INT:
 						ksGltf_ParseIntArray( scene->accessors[accessorIndex].intMin, componentCount, min );
 						ksGltf_ParseIntArray( scene->accessors[accessorIndex].intMax, componentCount, max );
 						break;
@@ -3183,14 +6412,17 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 						break;
 				}
 			}
+			const size_t elementSize = ksGltf_GetComponentSize( scene->accessors[accessorIndex].componentType ) * scene->accessors[accessorIndex].componentCount;
+			const size_t elementStride = ( scene->accessors[accessorIndex].byteStride != 0 ) ? scene->accessors[accessorIndex].byteStride : elementSize;
+			UNUSED_PARM( elementStride );
 			assert( scene->accessors[accessorIndex].name[0] != '\0' );
-			assert( scene->accessors[accessorIndex].bufferView != NULL );
+			assert( scene->accessors[accessorIndex].bufferView != NULL || version2 );
 			assert( scene->accessors[accessorIndex].componentType != 0 );
+			assert( scene->accessors[accessorIndex].componentCount != 0 );
 			assert( scene->accessors[accessorIndex].count != 0 );
-			assert( scene->accessors[accessorIndex].type[0] != '\0' );
-			assert( scene->accessors[accessorIndex].byteOffset +
-					scene->accessors[accessorIndex].count *
-					scene->accessors[accessorIndex].byteStride <=
+			assert( scene->accessors[accessorIndex].bufferView == NULL ||
+					scene->accessors[accessorIndex].byteOffset +
+					( scene->accessors[accessorIndex].count - 1 ) * elementStride + elementSize <=
 					scene->accessors[accessorIndex].bufferView->byteLength );
 		}
 		ksGltf_CreateAccessorNameHash( scene );
@@ -3211,8 +6443,9 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 		for ( int imageIndex = 0; imageIndex < scene->imageCount; imageIndex++ )
 		{
 			const ksJson * image = ksJson_GetMemberByIndex( images, imageIndex );
-			scene->images[imageIndex].name = ksGltf_strdup( ksJson_GetMemberName( image ) );
-			char * baseUri = ksGltf_ParseUri( scene, image, "uri" );
+			scene->images[imageIndex].name = ksGltf_ParseName( image, "image", imageIndex );
+			char * baseUri = ksGltf_ParseUri( scene, binaryBuffer, image, "uri" );
+			const char * mimeType = ksJson_GetString( ksJson_GetMemberByName( image, "mimeType" ), "" );
 
 			assert( scene->images[imageIndex].name[0] != '\0' );
 			assert( baseUri != '\0' );
@@ -3242,8 +6475,8 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 				scene->images[imageIndex].versionCount = 1;
 			}
 			const int count = scene->images[imageIndex].versionCount;
-			scene->images[imageIndex].versions[count - 1].container = ksGltf_strdup( ksGltf_GetImageContainerFromUri( baseUri ) );
-			scene->images[imageIndex].versions[count - 1].glInternalFormat = ksGltf_GetImageInternalFormatFromUri( binaryBuffer, baseUri );
+			scene->images[imageIndex].versions[count - 1].container = ksGltf_strdup( ksGltf_GetImageContainerFromUri( baseUri, mimeType ) );
+			scene->images[imageIndex].versions[count - 1].glInternalFormat = ksGltf_GetImageInternalFormatFromUri( binaryBuffer, baseUri, scene->images[imageIndex].versions[count - 1].container );
 			scene->images[imageIndex].versions[count - 1].uri = baseUri;
 		}
 		ksGltf_CreateImageNameHash( scene );
@@ -3264,7 +6497,7 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 		for ( int samplerIndex = 0; samplerIndex < scene->samplerCount; samplerIndex++ )
 		{
 			const ksJson * sampler = ksJson_GetMemberByIndex( samplers, samplerIndex );
-			scene->samplers[samplerIndex].name = ksGltf_strdup( ksJson_GetMemberName( sampler ) );
+			scene->samplers[samplerIndex].name = ksGltf_ParseName( sampler, "sampler", samplerIndex );
 			scene->samplers[samplerIndex].magFilter = ksJson_GetUint16( ksJson_GetMemberByName( sampler, "magFilter" ), GL_LINEAR );
 			scene->samplers[samplerIndex].minFilter = ksJson_GetUint16( ksJson_GetMemberByName( sampler, "minFilter" ), GL_NEAREST_MIPMAP_LINEAR );
 			scene->samplers[samplerIndex].wrapS = ksJson_GetUint16( ksJson_GetMemberByName( sampler, "wrapS" ), GL_REPEAT );
@@ -3284,18 +6517,25 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 		const ksNanoseconds startTime = GetTimeNanoseconds();
 
 		const ksJson * textures = ksJson_GetMemberByName( rootNode, "textures" );
-		scene->textureCount = ksJson_GetMemberCount( textures );
+		const int textureCount = ksJson_GetMemberCount( textures );
+		// glTF 2.0 materials without a base color texture use an additional white texture.
+		scene->textureCount = textureCount + ( version2 ? 1 : 0 );
 		scene->textures = (ksGltfTexture *) calloc( scene->textureCount, sizeof( ksGltfTexture ) );
-		for ( int textureIndex = 0; textureIndex < scene->textureCount; textureIndex++ )
+		firstTextureReadJob = ksGltf_AddReadJobs( &readJobs, &readJobCount, scene->textureCount );
+		for ( int textureIndex = 0; textureIndex < textureCount; textureIndex++ )
 		{
 			const ksJson * texture = ksJson_GetMemberByIndex( textures, textureIndex );
-			scene->textures[textureIndex].name = ksGltf_strdup( ksJson_GetMemberName( texture ) );
-			scene->textures[textureIndex].image = ksGltf_GetImageByName( scene, ksJson_GetString( ksJson_GetMemberByName( texture, "source" ), "" ) );
-			scene->textures[textureIndex].sampler = ksGltf_GetSamplerByName( scene, ksJson_GetString( ksJson_GetMemberByName( texture, "sampler" ), "" ) );
+			scene->textures[textureIndex].name = ksGltf_ParseName( texture, "texture", textureIndex );
+			scene->textures[textureIndex].image = ksGltf_GetImageByReference( scene, ksJson_GetMemberByName( texture, "source" ) );
+			scene->textures[textureIndex].sampler = ksGltf_GetSamplerByReference( scene, ksJson_GetMemberByName( texture, "sampler" ) );
 
 			assert( scene->textures[textureIndex].name[0] != '\0' );
-			assert( scene->textures[textureIndex].image != NULL );
+			assert( scene->textures[textureIndex].image != NULL || version2 );
 			//assert( scene->textures[textureIndex].sampler != NULL );
+			if ( scene->textures[textureIndex].image == NULL )
+			{
+				continue;
+			}
 
 			const char * containers[] = { "ktx", NULL };
 #if defined( OS_WINDOWS ) || defined( OS_LINUX ) || defined( OS_MACOS )
@@ -3307,11 +6547,12 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 			const char * uri = ksGltf_FindImageUri( scene->textures[textureIndex].image, containers, flags );
 			assert( uri != NULL );
 
-			// The "format", "internalFormat", "target" and "type" are automatically derived from the KTX file.
-			size_t dataSizeInBytes = 0;
-			unsigned char * data = ksGltf_ReadUri( binaryBuffer, uri, &dataSizeInBytes );
-			ksGpuTexture_CreateFromKTX( context, &scene->textures[textureIndex].texture, scene->textures[textureIndex].name, data, dataSizeInBytes );
-			free( data );
+			readJobs[firstTextureReadJob + textureIndex].binaryBuffer = binaryBuffer;
+			readJobs[firstTextureReadJob + textureIndex].uri = uri;
+		}
+		if ( version2 )
+		{
+			scene->textures[textureCount].name = ksGltf_strdup( "defaultTexture" );
 		}
 		ksGltf_CreateTextureNameHash( scene );
 
@@ -3319,6 +6560,20 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 		Print( "%1.3f seconds to load textures\n", ( endTime - startTime ) * 1e-9f );
 	}
 
+	//
+	// glTF 2.0 materials use built-in techniques.
+	//
+	ksJson * defaultTechniquesNode = NULL;
+	if ( version2 )
+	{
+		defaultTechniquesNode = ksJson_Create();
+		const char * errorString = "";
+		const bool parsed = ksJson_ReadFromBuffer( defaultTechniquesNode, gltf2DefaultTechniquesJson, &errorString );
+		assert( parsed );
+		UNUSED_PARM( parsed );
+	}
+	const ksJson * techniquesRootNode = version2 ? defaultTechniquesNode : rootNode;
+
 	//
 	// glTF shaders
 	//
@@ -3327,7 +6582,7 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 
 		const int defaultGlslShaderCount = 3;
 
-		const ksJson * shaders = ksJson_GetMemberByName( rootNode, "shaders" );
+		const ksJson * shaders = ksJson_GetMemberByName( techniquesRootNode, "shaders" );
 		scene->shaderCount = ksJson_GetMemberCount( shaders );
 		scene->shaders = (ksGltfShader *) calloc( scene->shaderCount, sizeof( ksGltfShader ) );
 		for ( int shaderIndex = 0; shaderIndex < scene->shaderCount; shaderIndex++ )
@@ -3356,7 +6611,7 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 							const ksJson * glslShader = ksJson_GetMemberByIndex( shader_versions, index );
 							scene->shaders[shaderIndex].shaders[shaderType][index].api = ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByName( glslShader, "api" ), "" ) );
 							scene->shaders[shaderIndex].shaders[shaderType][index].version = ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByName( glslShader, "version" ), "" ) );
-							scene->shaders[shaderIndex].shaders[shaderType][index].uri = ksGltf_ParseUri( scene, glslShader, "uri" );
+							scene->shaders[shaderIndex].shaders[shaderType][index].uri = ksGltf_ParseUri( scene, binaryBuffer, glslShader, "uri" );
 						}
 					}
 				}
@@ -3370,13 +6625,13 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 			const int count = scene->shaders[shaderIndex].shaderCount[GLTF_SHADER_TYPE_GLSL];
 			scene->shaders[shaderIndex].shaders[GLTF_SHADER_TYPE_GLSL][count - 3].api = ksGltf_strdup( "opengl" );
 			scene->shaders[shaderIndex].shaders[GLTF_SHADER_TYPE_GLSL][count - 3].version = ksGltf_strdup( "100" );
-			scene->shaders[shaderIndex].shaders[GLTF_SHADER_TYPE_GLSL][count - 3].uri = ksGltf_ParseUri( scene, shader, "uri" );
+			scene->shaders[shaderIndex].shaders[GLTF_SHADER_TYPE_GLSL][count - 3].uri = ksGltf_ParseUri( scene, binaryBuffer, shader, "uri" );
 			scene->shaders[shaderIndex].shaders[GLTF_SHADER_TYPE_GLSL][count - 2].api = ksGltf_strdup( "opengles" );
 			scene->shaders[shaderIndex].shaders[GLTF_SHADER_TYPE_GLSL][count - 2].version = ksGltf_strdup( "100 es" );
-			scene->shaders[shaderIndex].shaders[GLTF_SHADER_TYPE_GLSL][count - 2].uri = ksGltf_ParseUri( scene, shader, "uri" );
+			scene->shaders[shaderIndex].shaders[GLTF_SHADER_TYPE_GLSL][count - 2].uri = ksGltf_ParseUri( scene, binaryBuffer, shader, "uri" );
 			scene->shaders[shaderIndex].shaders[GLTF_SHADER_TYPE_GLSL][count - 1].api = ksGltf_strdup( "vulkan" );
 			scene->shaders[shaderIndex].shaders[GLTF_SHADER_TYPE_GLSL][count - 1].version = ksGltf_strdup( "100 es" );
-			scene->shaders[shaderIndex].shaders[GLTF_SHADER_TYPE_GLSL][count - 1].uri = ksGltf_ParseUri( scene, shader, "uri" );
+			scene->shaders[shaderIndex].shaders[GLTF_SHADER_TYPE_GLSL][count - 1].uri = ksGltf_ParseUri( scene, binaryBuffer, shader, "uri" );
 
 #if GRAPHICS_API_OPENGL == 1
 			assert( ksGltf_FindShaderUri( &scene->shaders[shaderIndex], GLTF_SHADER_TYPE_SPIRV, "opengl", SPIRV_VERSION ) != NULL ||
@@ -3405,9 +6660,10 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 	{
 		const ksNanoseconds startTime = GetTimeNanoseconds();
 
-		const ksJson * programs = ksJson_GetMemberByName( rootNode, "programs" );
+		const ksJson * programs = ksJson_GetMemberByName( techniquesRootNode, "programs" );
 		scene->programCount = ksJson_GetMemberCount( programs );
 		scene->programs = (ksGltfProgram *) calloc( scene->programCount, sizeof( ksGltfProgram ) );
+		firstProgramReadJob = ksGltf_AddReadJobs( &readJobs, &readJobCount, 2 * scene->programCount );
 		for ( int programIndex = 0; programIndex < scene->programCount; programIndex++ )
 		{
 			const ksJson * program = ksJson_GetMemberByIndex( programs, programIndex );
@@ -3453,11 +6709,10 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 			const char * vertexShaderUri = ksGltf_FindShaderUri( vertexShader, GLTF_SHADER_TYPE_METALSL, "metal", METALSL_VERSION );
 			const char * fragmentShaderUri = ksGltf_FindShaderUri( fragmentShader, GLTF_SHADER_TYPE_METALSL, "metal", METALSL_VERSION );
 #endif
-			scene->programs[programIndex].vertexSource = ksGltf_ReadUri( binaryBuffer, vertexShaderUri, &scene->programs[programIndex].vertexSourceSize );
-			scene->programs[programIndex].fragmentSource = ksGltf_ReadUri( binaryBuffer, fragmentShaderUri, &scene->programs[programIndex].fragmentSourceSize );
-
-			assert( scene->programs[programIndex].vertexSource[0] != '\0' );
-			assert( scene->programs[programIndex].fragmentSource[0] != '\0' );
+			readJobs[firstProgramReadJob + programIndex * 2 + 0].binaryBuffer = binaryBuffer;
+			readJobs[firstProgramReadJob + programIndex * 2 + 0].uri = vertexShaderUri;
+			readJobs[firstProgramReadJob + programIndex * 2 + 1].binaryBuffer = binaryBuffer;
+			readJobs[firstProgramReadJob + programIndex * 2 + 1].uri = fragmentShaderUri;
 		}
 		ksGltf_CreateProgramNameHash( scene );
 
@@ -3471,9 +6726,10 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 	{
 		const ksNanoseconds startTime = GetTimeNanoseconds();
 
-		const ksJson * techniques = ksJson_GetMemberByName( rootNode, "techniques" );
+		const ksJson * techniques = ksJson_GetMemberByName( techniquesRootNode, "techniques" );
 		scene->techniqueCount = ksJson_GetMemberCount( techniques );
 		scene->techniques = (ksGltfTechnique *) calloc( scene->techniqueCount, sizeof( ksGltfTechnique ) );
+		techniquePrograms = (ksGltfTechniqueProgram *) calloc( scene->techniqueCount, sizeof( ksGltfTechniqueProgram ) );
 		for ( int techniqueIndex = 0; techniqueIndex < scene->techniqueCount; techniqueIndex++ )
 		{
 			const ksJson * technique = ksJson_GetMemberByIndex( techniques, techniqueIndex );
@@ -3584,7 +6840,7 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 			// Parse Uniforms.
 			//
 
-			const char * semanticUniforms[GLTF_UNIFORM_SEMANTIC_MAX] = { 0 };
+			const char ** semanticUniforms = techniquePrograms[techniqueIndex].semanticUniforms;
 
 			const ksJson * uniforms = ksJson_GetMemberByName( technique, "uniforms" );
 			const int uniformCount = ksJson_GetMemberCount( uniforms );
@@ -3850,22 +7106,158 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 			ksGltfProgram * program = ksGltf_GetProgramByName( scene, ksJson_GetString( ksJson_GetMemberByName( technique, "program" ), "" ) );
 			assert( program != NULL );
 
-			ksGltf_CreateTechniqueProgram( context, &scene->techniques[techniqueIndex], program, conversion, semanticUniforms );
+			techniquePrograms[techniqueIndex].technique = &scene->techniques[techniqueIndex];
+			techniquePrograms[techniqueIndex].program = program;
+			techniquePrograms[techniqueIndex].conversion = conversion;
+		}
+		ksGltf_CreateTechniqueNameHash( scene );
+
+		const ksNanoseconds endTime = GetTimeNanoseconds();
+		Print( "%1.3f seconds to load techniques\n", ( endTime - startTime ) * 1e-9f );
+	}
+
+	//
+	// Read the buffers, images and shaders and convert the shaders on a pool of worker threads.
+	// The semantic uniforms of the techniques reference the JSON, so this is done before the
+	// default techniques are destroyed.
+	//
+	{
+		const ksNanoseconds startTime = GetTimeNanoseconds();
+
+		const ksCpuTopology * topology = ksCpuTopology_Get();
+		ksThreadPool threadPool;
+		ksThreadPool_Create( &threadPool, ( topology->physicalCoreCount > 0 ) ? topology->physicalCoreCount - 1 : 3 );
+
+		ksGltf_ParallelFor( &threadPool, ksGltf_ReadJob, readJobs, readJobCount );
+
+		for ( int jobIndex = 0; jobIndex < readJobCount && bakedScene != NULL; jobIndex++ )
+		{
+			if ( readJobs[jobIndex].data != NULL )
+			{
+				ksGltf_AddBakedSourceFile( bakedScene, readJobs[jobIndex].uri );
+			}
+		}
+
+		for ( int bufferIndex = 0; bufferIndex < scene->bufferCount; bufferIndex++ )
+		{
+			const ksGltfReadJob * job = &readJobs[firstBufferReadJob + bufferIndex];
+			if ( scene->buffers[bufferIndex].bufferDataStorage != GLTF_BUFFER_DATA_BINARY_GLTF )
+			{
+				scene->buffers[bufferIndex].bufferData = job->data;
+				scene->buffers[bufferIndex].bufferDataSize = job->dataSize;
+				scene->buffers[bufferIndex].bufferDataStorage = job->mapped ? GLTF_BUFFER_DATA_MAPPED : GLTF_BUFFER_DATA_ALLOCATED;
+			}
+			assert( scene->buffers[bufferIndex].bufferData != NULL );
+			assert( scene->buffers[bufferIndex].byteLength <= scene->buffers[bufferIndex].bufferDataSize );
+		}
+
+		for ( int programIndex = 0; programIndex < scene->programCount; programIndex++ )
+		{
+			const ksGltfReadJob * vertexJob = &readJobs[firstProgramReadJob + programIndex * 2 + 0];
+			const ksGltfReadJob * fragmentJob = &readJobs[firstProgramReadJob + programIndex * 2 + 1];
+			scene->programs[programIndex].vertexSource = vertexJob->data;
+			scene->programs[programIndex].vertexSourceSize = vertexJob->dataSize;
+			scene->programs[programIndex].fragmentSource = fragmentJob->data;
+			scene->programs[programIndex].fragmentSourceSize = fragmentJob->dataSize;
+
+			assert( scene->programs[programIndex].vertexSource[0] != '\0' );
+			assert( scene->programs[programIndex].fragmentSource[0] != '\0' );
+		}
+
+		const ksNanoseconds readEndTime = GetTimeNanoseconds();
+		Print( "%1.3f seconds to read %d buffers, images and shaders on %d threads\n", ( readEndTime - startTime ) * 1e-9f, readJobCount, threadPool.threadCount + 1 );
+
+		ksGltf_ParallelFor( &threadPool, ksGltf_ConvertTechniqueProgramJob, techniquePrograms, scene->techniqueCount );
+
+		ksThreadPool_Destroy( &threadPool );
+
+		const ksNanoseconds endTime = GetTimeNanoseconds();
+		Print( "%1.3f seconds to convert %d techniques\n", ( endTime - readEndTime ) * 1e-9f, scene->techniqueCount );
+	}
+
+	//
+	// Create the textures and the technique programs on the thread that owns the graphics context.
+	//
+	{
+		const ksNanoseconds startTime = GetTimeNanoseconds();
+
+		if ( bakedScene != NULL )
+		{
+			bakedScene->textures = (ksGltfBakedTexture *) calloc( scene->textureCount, sizeof( ksGltfBakedTexture ) );
+			bakedScene->programs = (ksGltfBakedProgram *) calloc( scene->techniqueCount, sizeof( ksGltfBakedProgram ) );
+		}
+
+		for ( int textureIndex = 0; textureIndex < scene->textureCount; textureIndex++ )
+		{
+			ksGltfTexture * texture = &scene->textures[textureIndex];
+			ksGltfReadJob * job = &readJobs[firstTextureReadJob + textureIndex];
+
+			// The "format", "internalFormat", "target" and "type" are automatically derived from the KTX file.
+			// Images in other formats are not supported and are replaced with a white texture.
+			if ( texture->image == NULL )
+			{
+				ksGltf_CreateWhiteTexture( context, &texture->texture );
+			}
+			else if ( job->data == NULL || !ksGpuTexture_CreateFromKTX( context, &texture->texture, texture->name, job->data, job->dataSize ) )
+			{
+				Print( "Using a white texture instead of image %s\n", texture->image->name );
+				ksGltf_CreateWhiteTexture( context, &texture->texture );
+			}
+			else if ( bakedScene != NULL )
+			{
+				// The baked scene takes ownership of the KTX data.
+				bakedScene->textures[textureIndex].data = job->data;
+				bakedScene->textures[textureIndex].dataSize = job->dataSize;
+				job->data = NULL;
+			}
+			free( job->data );
+			job->data = NULL;
+		}
+
+		const ksNanoseconds textureEndTime = GetTimeNanoseconds();
+		Print( "%1.3f seconds to create textures\n", ( textureEndTime - startTime ) * 1e-9f );
+
+		ksGpuLimits limits;
+		ksGpuContext_GetLimits( context, &limits );
+
+		for ( int techniqueIndex = 0; techniqueIndex < scene->techniqueCount; techniqueIndex++ )
+		{
+			if ( bakedScene != NULL )
+			{
+				// The baked scene stores the sources that are used to create the graphics program.
+				const ksGltfTechniqueProgram * techniqueProgram = &techniquePrograms[techniqueIndex];
+				const bool converted = ( techniqueProgram->vertexSource != NULL && techniqueProgram->fragmentSource != NULL );
+				const unsigned char * vertexSource = converted ? techniqueProgram->vertexSource : techniqueProgram->program->vertexSource;
+				const unsigned char * fragmentSource = converted ? techniqueProgram->fragmentSource : techniqueProgram->program->fragmentSource;
+				ksGltfBakedProgram * bakedProgram = &bakedScene->programs[techniqueIndex];
+				bakedProgram->vertexSourceSize = converted ? techniqueProgram->vertexSourceSize : techniqueProgram->program->vertexSourceSize;
+				bakedProgram->fragmentSourceSize = converted ? techniqueProgram->fragmentSourceSize : techniqueProgram->program->fragmentSourceSize;
+				bakedProgram->vertexSource = (unsigned char *) malloc( bakedProgram->vertexSourceSize );
+				bakedProgram->fragmentSource = (unsigned char *) malloc( bakedProgram->fragmentSourceSize );
+				memcpy( bakedProgram->vertexSource, vertexSource, bakedProgram->vertexSourceSize );
+				memcpy( bakedProgram->fragmentSource, fragmentSource, bakedProgram->fragmentSourceSize );
+			}
+
+			ksGltf_CreateTechniqueProgram( context, &techniquePrograms[techniqueIndex] );
 
 			size_t totalPushConstantBytes = 0;
 			for ( int uniformIndex = 0; uniformIndex < scene->techniques[techniqueIndex].uniformCount; uniformIndex++ )
 			{
 				totalPushConstantBytes += ksGpuProgramParm_GetPushConstantSize( scene->techniques[techniqueIndex].parms[uniformIndex].type );
 			}
-			ksGpuLimits limits;
-			ksGpuContext_GetLimits( context, &limits );
 			assert( totalPushConstantBytes <= limits.maxPushConstantsSize );
-
 		}
-		ksGltf_CreateTechniqueNameHash( scene );
+
+		free( techniquePrograms );
+		free( readJobs );
 
 		const ksNanoseconds endTime = GetTimeNanoseconds();
-		Print( "%1.3f seconds to load techniques\n", ( endTime - startTime ) * 1e-9f );
+		Print( "%1.3f seconds to create programs\n", ( endTime - textureEndTime ) * 1e-9f );
+	}
+
+	if ( defaultTechniquesNode != NULL )
+	{
+		ksJson_Destroy( defaultTechniquesNode );
 	}
 
 	//
@@ -3875,73 +7267,100 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 		const ksNanoseconds startTime = GetTimeNanoseconds();
 
 		const ksJson * materials = ksJson_GetMemberByName( rootNode, "materials" );
-		scene->materialCount = ksJson_GetMemberCount( materials );
-		scene->materials = (ksGltfMaterial *) calloc( scene->materialCount, sizeof( ksGltfMaterial ) );
-		for ( int materialIndex = 0; materialIndex < scene->materialCount; materialIndex++ )
+		if ( version2 )
 		{
-			const ksJson * material = ksJson_GetMemberByIndex( materials, materialIndex );
-			scene->materials[materialIndex].name = ksGltf_strdup( ksJson_GetMemberName( material ) );
-			assert( scene->materials[materialIndex].name[0] != '\0' );
-
-			const ksGltfTechnique * technique = ksGltf_GetTechniqueByName( scene, ksJson_GetString( ksJson_GetMemberByName( material, "technique" ), "" ) );
-			if ( settings->useMultiView )
+			// Every glTF 2.0 material is created without and with skinning, followed by a default material.
+			const ksGltfTechnique * pbrTechnique = ksGltf_GetTechniqueByName( scene, "pbrMetallicRoughness" );
+			const ksGltfTechnique * pbrSkinnedTechnique = ksGltf_GetTechniqueByName( scene, "pbrMetallicRoughnessSkinned" );
+			const int materialCount = ksJson_GetMemberCount( materials );
+			scene->materialCount = 2 * ( materialCount + 1 );
+			scene->materials = (ksGltfMaterial *) calloc( scene->materialCount, sizeof( ksGltfMaterial ) );
+			for ( int materialIndex = 0; materialIndex <= materialCount; materialIndex++ )
 			{
-				const ksJson * extensions = ksJson_GetMemberByName( material, "extensions" );
-				if ( extensions != NULL )
+				const ksJson * material = ( materialIndex < materialCount ) ? ksJson_GetMemberByIndex( materials, materialIndex ) : NULL;
+				char * name = ( material != NULL ) ? ksGltf_ParseName( material, "material", materialIndex ) : ksGltf_strdup( "defaultMaterial" );
+				char * skinnedName = (char *) malloc( strlen( name ) + 9 );
+				sprintf( skinnedName, "%s_skinned", name );
+
+				scene->materials[2 * materialIndex + 0].name = name;
+				scene->materials[2 * materialIndex + 0].technique = pbrTechnique;
+				ksGltf_ParsePbrMetallicRoughness( &scene->materials[2 * materialIndex + 0], material, scene );
+
+				scene->materials[2 * materialIndex + 1].name = skinnedName;
+				scene->materials[2 * materialIndex + 1].technique = pbrSkinnedTechnique;
+				ksGltf_ParsePbrMetallicRoughness( &scene->materials[2 * materialIndex + 1], material, scene );
+			}
+		}
+		else
+		{
+			scene->materialCount = ksJson_GetMemberCount( materials );
+			scene->materials = (ksGltfMaterial *) calloc( scene->materialCount, sizeof( ksGltfMaterial ) );
+			for ( int materialIndex = 0; materialIndex < scene->materialCount; materialIndex++ )
+			{
+				const ksJson * material = ksJson_GetMemberByIndex( materials, materialIndex );
+				scene->materials[materialIndex].name = ksGltf_strdup( ksJson_GetMemberName( material ) );
+				assert( scene->materials[materialIndex].name[0] != '\0' );
+
+				const ksGltfTechnique * technique = ksGltf_GetTechniqueByReference( scene, ksJson_GetMemberByName( material, "technique" ) );
+				if ( settings->useMultiView )
 				{
-					const ksJson * KHR_glsl_multi_view = ksJson_GetMemberByName( extensions, "KHR_glsl_multi_view" );
-					if ( KHR_glsl_multi_view != NULL )
+					const ksJson * extensions = ksJson_GetMemberByName( material, "extensions" );
+					if ( extensions != NULL )
 					{
-						const ksGltfTechnique * multiViewTechnique = ksGltf_GetTechniqueByName( scene, ksJson_GetString( ksJson_GetMemberByName( KHR_glsl_multi_view, "technique" ), "" ) );
-						assert( multiViewTechnique != NULL );
-						technique = multiViewTechnique;
+						const ksJson * KHR_glsl_multi_view = ksJson_GetMemberByName( extensions, "KHR_glsl_multi_view" );
+						if ( KHR_glsl_multi_view != NULL )
+						{
+							const ksGltfTechnique * multiViewTechnique = ksGltf_GetTechniqueByReference( scene, ksJson_GetMemberByName( KHR_glsl_multi_view, "technique" ) );
+							assert( multiViewTechnique != NULL );
+							technique = multiViewTechnique;
+						}
 					}
 				}
-			}
-			scene->materials[materialIndex].technique = technique;
-			assert( scene->materials[materialIndex].technique != NULL );
+				scene->materials[materialIndex].technique = technique;
+				assert( scene->materials[materialIndex].technique != NULL );
 
-			const ksJson * values = ksJson_GetMemberByName( material, "values" );
-			scene->materials[materialIndex].valueCount = ksJson_GetMemberCount( values );
-			scene->materials[materialIndex].values = (ksGltfMaterialValue *) calloc( scene->materials[materialIndex].valueCount, sizeof( ksGltfMaterialValue ) );
-			for ( int valueIndex = 0; valueIndex < scene->materials[materialIndex].valueCount; valueIndex++ )
-			{
-				const ksJson * value = ksJson_GetMemberByIndex( values, valueIndex );
-				const char * valueName = ksJson_GetMemberName( value );
-				ksGltfUniform * uniform = NULL;
-				for ( int uniformIndex = 0; uniformIndex < technique->uniformCount; uniformIndex++ )
+				const ksJson * values = ksJson_GetMemberByName( material, "values" );
+				scene->materials[materialIndex].valueCount = ksJson_GetMemberCount( values );
+				scene->materials[materialIndex].values = (ksGltfMaterialValue *) calloc( scene->materials[materialIndex].valueCount, sizeof( ksGltfMaterialValue ) );
+				for ( int valueIndex = 0; valueIndex < scene->materials[materialIndex].valueCount; valueIndex++ )
 				{
-					if ( strcmp( technique->uniforms[uniformIndex].name, valueName ) == 0 )
+					const ksJson * value = ksJson_GetMemberByIndex( values, valueIndex );
+					const char * valueName = ksJson_GetMemberName( value );
+					ksGltfUniform * uniform = NULL;
+					for ( int uniformIndex = 0; uniformIndex < technique->uniformCount; uniformIndex++ )
 					{
-						uniform = &technique->uniforms[uniformIndex];
-						break;
+						if ( strcmp( technique->uniforms[uniformIndex].name, valueName ) == 0 )
+						{
+							uniform = &technique->uniforms[uniformIndex];
+							break;
+						}
 					}
+					if ( uniform == NULL )
+					{
+						assert( false );
+						continue;
+					}
+					assert( uniform->semantic == GLTF_UNIFORM_SEMANTIC_NONE || uniform->semantic == GLTF_UNIFORM_SEMANTIC_DEFAULT_VALUE );
+					scene->materials[materialIndex].values[valueIndex].uniform = uniform;
+					ksGltf_ParseUniformValue( &scene->materials[materialIndex].values[valueIndex].value, value, uniform->type, scene );
 				}
-				if ( uniform == NULL )
-				{
-					assert( false );
-					continue;
-				}
-				assert( uniform->semantic == GLTF_UNIFORM_SEMANTIC_NONE || uniform->semantic == GLTF_UNIFORM_SEMANTIC_DEFAULT_VALUE );
-				scene->materials[materialIndex].values[valueIndex].uniform = uniform;
-				ksGltf_ParseUniformValue( &scene->materials[materialIndex].values[valueIndex].value, value, uniform->type, scene );
-			}
-			// Make sure that the material sets any uniforms that do not have a special semantic or a default value.
-			for ( int uniformIndex = 0; uniformIndex < technique->uniformCount; uniformIndex++ )
-			{
-				if ( technique->uniforms[uniformIndex].semantic == GLTF_UNIFORM_SEMANTIC_NONE )
+				// Make sure that the material sets any uniforms that do not have a special semantic or a default value.
+				for ( int uniformIndex = 0; uniformIndex < technique->uniformCount; uniformIndex++ )
 				{
-					bool found = false;
-					for ( int valueIndex = 0; valueIndex < scene->materials[materialIndex].valueCount; valueIndex++ )
+					if ( technique->uniforms[uniformIndex].semantic == GLTF_UNIFORM_SEMANTIC_NONE )
 					{
-						if ( scene->materials[materialIndex].values[valueIndex].uniform == &technique->uniforms[uniformIndex] )
+						bool found = false;
+						for ( int valueIndex = 0; valueIndex < scene->materials[materialIndex].valueCount; valueIndex++ )
 						{
-							found = true;
-							break;
+							if ( scene->materials[materialIndex].values[valueIndex].uniform == &technique->uniforms[uniformIndex] )
+							{
+								found = true;
+								break;
+							}
 						}
+						assert( found );
+						UNUSED_PARM( found );
 					}
-					assert( found );
-					UNUSED_PARM( found );
 				}
 			}
 		}
@@ -3961,60 +7380,145 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 		scene->modelCount = ksJson_GetMemberCount( models );
 		scene->models = (ksGltfModel *) calloc( scene->modelCount, sizeof( ksGltfModel ) );
 		ksGltfGeometryAccessors ** accessors = (ksGltfGeometryAccessors **) calloc( scene->modelCount, sizeof( ksGltfGeometryAccessors * ) );
+		ksGltfUnpackedGeometry ** unpacked = (ksGltfUnpackedGeometry **) calloc( scene->modelCount, sizeof( ksGltfUnpackedGeometry * ) );
 		for ( int modelIndex = 0; modelIndex < scene->modelCount; modelIndex++ )
 		{
 			const ksJson * model = ksJson_GetMemberByIndex( models, modelIndex );
-			scene->models[modelIndex].name = ksGltf_strdup( ksJson_GetMemberName( model ) );
+			scene->models[modelIndex].name = ksGltf_ParseName( model, "mesh", modelIndex );
 
 			ksVector3f_Set( &scene->models[modelIndex].mins, FLT_MAX );
 			ksVector3f_Set( &scene->models[modelIndex].maxs, -FLT_MAX );
 
 			assert( scene->models[modelIndex].name[0] != '\0' );
 
+			// glTF 2.0 renamed the color and skinning attributes.
+			const char * colorAttributeName = version2 ? "COLOR_0" : "COLOR";
+			const char * jointsAttributeName = version2 ? "JOINTS_0" : "JOINT";
+			const char * weightsAttributeName = version2 ? "WEIGHTS_0" : "WEIGHT";
+
 			const ksJson * primitives = ksJson_GetMemberByName( model, "primitives" );
-			scene->models[modelIndex].surfaceCount = ksJson_GetMemberCount( primitives );
-			scene->models[modelIndex].surfaces = (ksGltfSurface *) calloc( scene->models[modelIndex].surfaceCount, sizeof( ksGltfSurface ) );
-			accessors[modelIndex] = (ksGltfGeometryAccessors *) calloc( scene->models[modelIndex].surfaceCount, sizeof( ksGltfGeometryAccessors ) );
-			for ( int surfaceIndex = 0; surfaceIndex < scene->models[modelIndex].surfaceCount; surfaceIndex++ )
+			const int primitiveCount = ksJson_GetMemberCount( primitives );
+
+			// Primitives with more vertices than a ksGpuTriangleIndex can address are split into multiple surfaces.
+			int maxSurfaceCount = 0;
+			for ( int primitiveIndex = 0; primitiveIndex < primitiveCount; primitiveIndex++ )
 			{
+				const ksJson * primitive = ksJson_GetMemberByIndex( primitives, primitiveIndex );
+				const ksGltfAccessor * position = ksGltf_GetAccessorByReference( scene, ksJson_GetMemberByName( ksJson_GetMemberByName( primitive, "attributes" ), "POSITION" ) );
+				const ksGltfAccessor * indices = ksGltf_GetAccessorByReference( scene, ksJson_GetMemberByName( primitive, "indices" ) );
+				const int vertexCount = ( position != NULL ) ? position->count : 0;
+				maxSurfaceCount += ksGltf_GetMaxSplitSurfaceCount( vertexCount, ( indices != NULL ) ? indices->count : vertexCount );
+			}
+
+			scene->models[modelIndex].surfaceCount = 0;
+			scene->models[modelIndex].surfaces = (ksGltfSurface *) calloc( maxSurfaceCount, sizeof( ksGltfSurface ) );
+			accessors[modelIndex] = (ksGltfGeometryAccessors *) calloc( maxSurfaceCount, sizeof( ksGltfGeometryAccessors ) );
+			unpacked[modelIndex] = (ksGltfUnpackedGeometry *) calloc( maxSurfaceCount, sizeof( ksGltfUnpackedGeometry ) );
+			for ( int primitiveIndex = 0; primitiveIndex < primitiveCount; primitiveIndex++ )
+			{
+				const int surfaceIndex = scene->models[modelIndex].surfaceCount;
 				ksGltfSurface * surface = &scene->models[modelIndex].surfaces[surfaceIndex];
-				const ksJson * primitive = ksJson_GetMemberByIndex( primitives, surfaceIndex );
+				const ksJson * primitive = ksJson_GetMemberByIndex( primitives, primitiveIndex );
 				const ksJson * attributes = ksJson_GetMemberByName( primitive, "attributes" );
 
-				const char * positionAccessorName		= ksJson_GetString( ksJson_GetMemberByName( attributes, "POSITION" ), "" );
-				const char * normalAccessorName			= ksJson_GetString( ksJson_GetMemberByName( attributes, "NORMAL" ), "" );
-				const char * tangentAccessorName		= ksJson_GetString( ksJson_GetMemberByName( attributes, "TANGENT" ), "" );
-				const char * binormalAccessorName		= ksJson_GetString( ksJson_GetMemberByName( attributes, "BINORMAL" ), "" );
-				const char * colorAccessorName			= ksJson_GetString( ksJson_GetMemberByName( attributes, "COLOR" ), "" );
-				const char * uv0AccessorName			= ksJson_GetString( ksJson_GetMemberByName( attributes, "TEXCOORD_0" ), "" );
-				const char * uv1AccessorName			= ksJson_GetString( ksJson_GetMemberByName( attributes, "TEXCOORD_1" ), "" );
-				const char * uv2AccessorName			= ksJson_GetString( ksJson_GetMemberByName( attributes, "TEXCOORD_2" ), "" );
-				const char * jointIndicesAccessorName	= ksJson_GetString( ksJson_GetMemberByName( attributes, "JOINT" ), "" );
-				const char * jointWeightsAccessorName	= ksJson_GetString( ksJson_GetMemberByName( attributes, "WEIGHT" ), "" );
-				const char * indicesAccessorName		= ksJson_GetString( ksJson_GetMemberByName( primitive, "indices" ), "" );
-
-				surface->material = ksGltf_GetMaterialByName( scene, ksJson_GetString( ksJson_GetMemberByName( primitive, "material" ), "" ) );
-				assert( surface->material != NULL );
-
 				ksGltfGeometryAccessors * surfaceAccessors = &accessors[modelIndex][surfaceIndex];
-				surfaceAccessors->position		= ksGltf_GetAccessorByNameAndType( scene, positionAccessorName,		"VEC3",		GL_FLOAT );
-				surfaceAccessors->normal		= ksGltf_GetAccessorByNameAndType( scene, normalAccessorName,		"VEC3",		GL_FLOAT );
-				surfaceAccessors->tangent		= ksGltf_GetAccessorByNameAndType( scene, tangentAccessorName,		"VEC3",		GL_FLOAT );
-				surfaceAccessors->binormal		= ksGltf_GetAccessorByNameAndType( scene, binormalAccessorName,		"VEC3",		GL_FLOAT );
-				surfaceAccessors->color			= ksGltf_GetAccessorByNameAndType( scene, colorAccessorName,		"VEC4",		GL_FLOAT );
-				surfaceAccessors->uv0			= ksGltf_GetAccessorByNameAndType( scene, uv0AccessorName,			"VEC2",		GL_FLOAT );
-				surfaceAccessors->uv1			= ksGltf_GetAccessorByNameAndType( scene, uv1AccessorName,			"VEC2",		GL_FLOAT );
-				surfaceAccessors->uv2			= ksGltf_GetAccessorByNameAndType( scene, uv2AccessorName,			"VEC2",		GL_FLOAT );
-				surfaceAccessors->jointIndices	= ksGltf_GetAccessorByNameAndType( scene, jointIndicesAccessorName,	"VEC4",		GL_FLOAT );
-				surfaceAccessors->jointWeights	= ksGltf_GetAccessorByNameAndType( scene, jointWeightsAccessorName,	"VEC4",		GL_FLOAT );
-				surfaceAccessors->indices		= ksGltf_GetAccessorByNameAndType( scene, indicesAccessorName,		"SCALAR",	GL_UNSIGNED_SHORT );
-
-				if ( surfaceAccessors->position == NULL || surfaceAccessors->indices == NULL )
+				surfaceAccessors->position		= ksGltf_GetAccessorByReferenceAndType( scene, ksJson_GetMemberByName( attributes, "POSITION" ),			"VEC3" );
+				surfaceAccessors->normal		= ksGltf_GetAccessorByReferenceAndType( scene, ksJson_GetMemberByName( attributes, "NORMAL" ),			"VEC3" );
+				surfaceAccessors->tangent		= ksGltf_GetAccessorByReference( scene, ksJson_GetMemberByName( attributes, "TANGENT" ) );
+				surfaceAccessors->binormal		= ksGltf_GetAccessorByReferenceAndType( scene, ksJson_GetMemberByName( attributes, "BINORMAL" ),			"VEC3" );
+				surfaceAccessors->color			= ksGltf_GetAccessorByReference( scene, ksJson_GetMemberByName( attributes, colorAttributeName ) );
+				surfaceAccessors->uv0			= ksGltf_GetAccessorByReferenceAndType( scene, ksJson_GetMemberByName( attributes, "TEXCOORD_0" ),		"VEC2" );
+				surfaceAccessors->uv1			= ksGltf_GetAccessorByReferenceAndType( scene, ksJson_GetMemberByName( attributes, "TEXCOORD_1" ),		"VEC2" );
+				surfaceAccessors->uv2			= ksGltf_GetAccessorByReferenceAndType( scene, ksJson_GetMemberByName( attributes, "TEXCOORD_2" ),		"VEC2" );
+				surfaceAccessors->jointIndices	= ksGltf_GetAccessorByReferenceAndType( scene, ksJson_GetMemberByName( attributes, jointsAttributeName ),	"VEC4" );
+				surfaceAccessors->jointWeights	= ksGltf_GetAccessorByReferenceAndType( scene, ksJson_GetMemberByName( attributes, weightsAttributeName ),	"VEC4" );
+				surfaceAccessors->indices		= ksGltf_GetAccessorByReferenceAndType( scene, ksJson_GetMemberByName( primitive, "indices" ),			"SCALAR" );
+
+				// Only triangle lists are supported.
+				const int mode = ksJson_GetInt32( ksJson_GetMemberByName( primitive, "mode" ), GL_TRIANGLES );
+				if ( mode != GL_TRIANGLES || surfaceAccessors->position == NULL )
 				{
-					assert( false );
+					Print( "Skipping primitive %d of mesh %s\n", primitiveIndex, scene->models[modelIndex].name );
+					memset( surfaceAccessors, 0, sizeof( ksGltfGeometryAccessors ) );
+					continue;
+				}
+
+				ksGltfMaterial * material = NULL;
+				if ( version2 )
+				{
+					// Every glTF 2.0 material is loaded as a pair of materials where the second material is used for skinned primitives.
+					const ksJson * materialReference = ksJson_GetMemberByName( primitive, "material" );
+					const int materialIndex = ksJson_IsNumber( materialReference ) ? ksJson_GetInt32( materialReference, -1 ) : -1;
+					const int materialPairIndex = ( materialIndex >= 0 && 2 * materialIndex < scene->materialCount - 2 ) ? materialIndex : scene->materialCount / 2 - 1;
+					const bool skinned = ( surfaceAccessors->jointIndices != NULL && surfaceAccessors->jointWeights != NULL );
+					material = &scene->materials[2 * materialPairIndex + ( skinned ? 1 : 0 )];
+				}
+				else
+				{
+					material = ksGltf_GetMaterialByReference( scene, ksJson_GetMemberByName( primitive, "material" ) );
+				}
+				assert( material != NULL );
+
+				if ( surfaceAccessors->position->count > GLTF_MAX_SURFACE_VERTEX_COUNT )
+				{
+					const int indexCount = ( surfaceAccessors->indices != NULL ) ? surfaceAccessors->indices->count : surfaceAccessors->position->count;
+					uint32_t * indexData = (uint32_t *) malloc( indexCount * sizeof( uint32_t ) );
+					int splitCount = 0;
+					if ( surfaceAccessors->indices == NULL || ksGltf_UnpackAccessorIndices32( indexData, surfaceAccessors->indices ) )
+					{
+						for ( int i = 0; i < indexCount && surfaceAccessors->indices == NULL; i++ )
+						{
+							indexData[i] = (uint32_t) i;
+						}
+						ksDefaultVertexAttributeArrays attribs;
+						ksGltf_UnpackGeometryAttributes( &attribs, material->technique->vertexAttributeLayout, surfaceAccessors );
+						splitCount = ksGltf_SplitGeometry( &unpacked[modelIndex][surfaceIndex], surface, maxSurfaceCount - surfaceIndex, &attribs, indexData, indexCount );
+						ksGpuVertexAttributeArrays_Free( &attribs.base );
+					}
+					free( indexData );
+
+					// The split surfaces do not share vertices or indices with other surfaces.
+					memset( surfaceAccessors, 0, sizeof( ksGltfGeometryAccessors ) );
+					if ( splitCount == 0 )
+					{
+						Print( "Skipping primitive %d of mesh %s with invalid indices\n", primitiveIndex, scene->models[modelIndex].name );
+						continue;
+					}
+					Print( "Split primitive %d of mesh %s into %d surfaces\n", primitiveIndex, scene->models[modelIndex].name, splitCount );
+					for ( int i = 0; i < splitCount; i++ )
+					{
+						surface[i].material = material;
+						ksVector3f_Min( &scene->models[modelIndex].mins, &scene->models[modelIndex].mins, &surface[i].mins );
+						ksVector3f_Max( &scene->models[modelIndex].maxs, &scene->models[modelIndex].maxs, &surface[i].maxs );
+					}
+					scene->models[modelIndex].surfaceCount += splitCount;
 					continue;
 				}
 
+				const int indexCount = ( surfaceAccessors->indices != NULL ) ? surfaceAccessors->indices->count : surfaceAccessors->position->count;
+				ksGpuTriangleIndex * indexData = (ksGpuTriangleIndex *) malloc( indexCount * sizeof( ksGpuTriangleIndex ) );
+				if ( surfaceAccessors->indices != NULL )
+				{
+					if ( !ksGltf_UnpackAccessorIndices( indexData, surfaceAccessors->indices ) )
+					{
+						Print( "Skipping primitive %d of mesh %s with invalid indices\n", primitiveIndex, scene->models[modelIndex].name );
+						memset( surfaceAccessors, 0, sizeof( ksGltfGeometryAccessors ) );
+						free( indexData );
+						continue;
+					}
+				}
+				else
+				{
+					for ( int i = 0; i < indexCount; i++ )
+					{
+						indexData[i] = (ksGpuTriangleIndex) i;
+					}
+				}
+
+				scene->models[modelIndex].surfaceCount++;
+
+				surface->material = material;
+
 				surface->mins.x = surfaceAccessors->position->floatMin[0];
 				surface->mins.y = surfaceAccessors->position->floatMin[1];
 				surface->mins.z = surfaceAccessors->position->floatMin[2];
@@ -4032,10 +7536,13 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 				assert( surfaceAccessors->jointIndices	== NULL || surfaceAccessors->jointIndices->count	== surfaceAccessors->position->count );
 				assert( surfaceAccessors->jointWeights	== NULL || surfaceAccessors->jointWeights->count	== surfaceAccessors->position->count );
 
-				ksDefaultVertexAttributeArrays attribs;
-				memset( &attribs, 0, sizeof( attribs ) );
+				// The vertices and indices are packed into the geometry buffers once all models are loaded.
+				ksGltfUnpackedGeometry * geometry = &unpacked[modelIndex][surfaceIndex];
+				geometry->surface = surface;
+				geometry->indexData = indexData;
+				geometry->indexCount = indexCount;
 
-				for ( int i = 0; i <= modelIndex; i++ )
+				for ( int i = 0; i <= modelIndex && geometry->vertexSource == NULL; i++ )
 				{
 					const int surfaceCount = ( i == modelIndex ) ? surfaceIndex : scene->models[i].surfaceCount;
 					for ( int j = 0; j < surfaceCount; j++ )
@@ -4053,93 +7560,83 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 								( surfaceAccessors->jointWeights	== NULL || surfaceAccessors->jointWeights	== otherAccessors->jointWeights	)
 							)
 						{
-							ksGpuVertexAttributeArrays_CreateFromBuffer( &attribs.base,
-											scene->models[i].surfaces[j].geometry.layout,
-											scene->models[i].surfaces[j].geometry.vertexCount,
-											scene->models[i].surfaces[j].geometry.vertexAttribsFlags,
-											&scene->models[i].surfaces[j].geometry.vertexBuffer );
-							i = modelIndex;
+							geometry->vertexSource = &unpacked[i][j];
 							break;
 						}
 					}
 				}
 
-				if ( attribs.base.buffer == NULL )
+				if ( geometry->vertexSource == NULL )
 				{
-					const int attribsFlags = ( surfaceAccessors->position != NULL		? VERTEX_ATTRIBUTE_FLAG_POSITION : 0 ) |
-											( surfaceAccessors->normal != NULL			? VERTEX_ATTRIBUTE_FLAG_NORMAL : 0 ) |
-											( surfaceAccessors->tangent != NULL			? VERTEX_ATTRIBUTE_FLAG_TANGENT : 0 ) |
-											( surfaceAccessors->binormal != NULL		? VERTEX_ATTRIBUTE_FLAG_BINORMAL : 0 ) |
-											( surfaceAccessors->color != NULL			? VERTEX_ATTRIBUTE_FLAG_COLOR : 0 ) |
-											( surfaceAccessors->uv0 != NULL				? VERTEX_ATTRIBUTE_FLAG_UV0 : 0 ) |
-											( surfaceAccessors->uv1 != NULL				? VERTEX_ATTRIBUTE_FLAG_UV1 : 0 ) |
-											( surfaceAccessors->uv2 != NULL				? VERTEX_ATTRIBUTE_FLAG_UV2 : 0 ) |
-											( surfaceAccessors->jointIndices != NULL	? VERTEX_ATTRIBUTE_FLAG_JOINT_INDICES : 0 ) |
-											( surfaceAccessors->jointWeights != NULL	? VERTEX_ATTRIBUTE_FLAG_JOINT_WEIGHTS : 0 );
-
-					ksGpuVertexAttributeArrays_Alloc( &attribs.base, surface->material->technique->vertexAttributeLayout, surfaceAccessors->position->count, attribsFlags );
-
-					if ( surfaceAccessors->position != NULL )		memcpy( attribs.position,		ksGltf_GetBufferData( surfaceAccessors->position ),		surfaceAccessors->position->count		* sizeof( attribs.position[0] ) );
-					if ( surfaceAccessors->normal != NULL )			memcpy( attribs.normal,			ksGltf_GetBufferData( surfaceAccessors->normal ),		surfaceAccessors->normal->count			* sizeof( attribs.normal[0] ) );
-					if ( surfaceAccessors->tangent != NULL )		memcpy( attribs.tangent,		ksGltf_GetBufferData( surfaceAccessors->tangent ),		surfaceAccessors->tangent->count		* sizeof( attribs.tangent[0] ) );
-					if ( surfaceAccessors->binormal != NULL )		memcpy( attribs.binormal,		ksGltf_GetBufferData( surfaceAccessors->binormal ),		surfaceAccessors->binormal->count		* sizeof( attribs.binormal[0] ) );
-					if ( surfaceAccessors->color != NULL )			memcpy( attribs.color,			ksGltf_GetBufferData( surfaceAccessors->color ),		surfaceAccessors->color->count			* sizeof( attribs.color[0] ) );
-					if ( surfaceAccessors->uv0 != NULL )			memcpy( attribs.uv0,			ksGltf_GetBufferData( surfaceAccessors->uv0 ),			surfaceAccessors->uv0->count			* sizeof( attribs.uv0[0] ) );
-					if ( surfaceAccessors->uv1 != NULL )			memcpy( attribs.uv1,			ksGltf_GetBufferData( surfaceAccessors->uv1 ),			surfaceAccessors->uv1->count			* sizeof( attribs.uv1[0] ) );
-					if ( surfaceAccessors->uv2 != NULL )			memcpy( attribs.uv2,			ksGltf_GetBufferData( surfaceAccessors->uv2 ),			surfaceAccessors->uv2->count			* sizeof( attribs.uv2[0] ) );
-					if ( surfaceAccessors->jointIndices != NULL )	memcpy( attribs.jointIndices,	ksGltf_GetBufferData( surfaceAccessors->jointIndices ),	surfaceAccessors->jointIndices->count	* sizeof( attribs.jointIndices[0] ) );
-					if ( surfaceAccessors->jointWeights != NULL )	memcpy( attribs.jointWeights,	ksGltf_GetBufferData( surfaceAccessors->jointWeights ),	surfaceAccessors->jointWeights->count	* sizeof( attribs.jointWeights[0] ) );
+					ksGltf_UnpackGeometryAttributes( &geometry->attribs, surface->material->technique->vertexAttributeLayout, surfaceAccessors );
 				}
 
-				ksGpuTriangleIndexArray indices;
-				memset( &indices, 0, sizeof( indices ) );
-
-				for ( int i = 0; i <= modelIndex; i++ )
+				for ( int i = 0; i <= modelIndex && geometry->indexSource == NULL; i++ )
 				{
 					const int surfaceCount = ( i == modelIndex ) ? surfaceIndex : scene->models[i].surfaceCount;
 					for ( int j = 0; j < surfaceCount; j++ )
 					{
 						const ksGltfGeometryAccessors * otherAccessors = &accessors[i][j];
-						if ( surfaceAccessors->indices == otherAccessors->indices )
+						if ( surfaceAccessors->indices != NULL && surfaceAccessors->indices == otherAccessors->indices )
 						{
-							ksGpuTriangleIndexArray_CreateFromBuffer( &indices, surfaceAccessors->indices->count,
-																	&scene->models[i].surfaces[j].geometry.indexBuffer );
-							i = modelIndex;
+							geometry->indexSource = &unpacked[i][j];
 							break;
 						}
 					}
 				}
 
-				if ( indices.buffer == NULL )
-				{
-					ksGpuTriangleIndexArray_Alloc( &indices, surfaceAccessors->indices->count, (ksGpuTriangleIndex *)ksGltf_GetBufferData( surfaceAccessors->indices ) );
-				}
-
-				ksGpuGeometry_Create( context, &surface->geometry, &attribs.base, &indices );
-
-				ksGpuVertexAttributeArrays_Free( &attribs.base );
-				ksGpuTriangleIndexArray_Free( &indices );
+				ksVector3f_Min( &scene->models[modelIndex].mins, &scene->models[modelIndex].mins, &surface->mins );
+				ksVector3f_Max( &scene->models[modelIndex].maxs, &scene->models[modelIndex].maxs, &surface->maxs );
+			}
 
-				ksGpuGraphicsPipelineParms pipelineParms;
-				ksGpuGraphicsPipelineParms_Init( &pipelineParms );
+			ksGltf_AllocBoundsArray( &scene->models[modelIndex].surfaceBounds, scene->models[modelIndex].surfaceCount );
+			for ( int surfaceIndex = 0; surfaceIndex < scene->models[modelIndex].surfaceCount; surfaceIndex++ )
+			{
+				const ksGltfSurface * surface = &scene->models[modelIndex].surfaces[surfaceIndex];
+				ksGltf_SetBoundsArray( &scene->models[modelIndex].surfaceBounds, surfaceIndex, &surface->mins, &surface->maxs );
+			}
+		}
 
-				pipelineParms.renderPass = renderPass;
-				pipelineParms.program = &surface->material->technique->program;
-				pipelineParms.geometry = &surface->geometry;
-				pipelineParms.rop = surface->material->technique->rop;
+		// Pack the vertices and indices of all surfaces and create the graphics API buffers.
+		void ** packedVertexData = NULL;
+		ksGpuTriangleIndex * packedIndexData = NULL;
+		ksGltf_PackGeometryBuffers( scene, unpacked, &packedVertexData, &packedIndexData );
 
-				ksGpuGraphicsPipeline_Create( context, &surface->pipeline, &pipelineParms );
+		for ( int bufferIndex = 0; bufferIndex < scene->geometryBufferCount; bufferIndex++ )
+		{
+			ksGltf_CreateGeometryBuffer( context, scene, &scene->geometryBuffers[bufferIndex], packedVertexData[bufferIndex], packedIndexData );
+		}
 
-				ksVector3f_Min( &scene->models[modelIndex].mins, &scene->models[modelIndex].mins, &surface->mins );
-				ksVector3f_Max( &scene->models[modelIndex].maxs, &scene->models[modelIndex].maxs, &surface->maxs );
+		if ( bakedScene != NULL )
+		{
+			// The baked scene takes ownership of the packed vertices and indices.
+			bakedScene->vertexData = packedVertexData;
+			bakedScene->indexData = packedIndexData;
+		}
+		else
+		{
+			for ( int bufferIndex = 0; bufferIndex < scene->geometryBufferCount; bufferIndex++ )
+			{
+				free( packedVertexData[bufferIndex] );
 			}
+			free( packedVertexData );
+			free( packedIndexData );
 		}
 
-		// Free the accessors.
+		ksGltf_CreateSurfaceGeometry( context, scene, renderPass );
+
+		// Free the accessors and the unpacked geometry.
 		for ( int modelIndex = 0; modelIndex < scene->modelCount; modelIndex++ )
 		{
+			for ( int surfaceIndex = 0; surfaceIndex < scene->models[modelIndex].surfaceCount; surfaceIndex++ )
+			{
+				ksGpuVertexAttributeArrays_Free( &unpacked[modelIndex][surfaceIndex].attribs.base );
+				free( unpacked[modelIndex][surfaceIndex].indexData );
+			}
+			free( unpacked[modelIndex] );
 			free( accessors[modelIndex] );
 		}
+		free( unpacked );
 		free( accessors );
 
 		ksGltf_CreateModelNameHash( scene );
@@ -4155,158 +7652,274 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 		const ksNanoseconds startTime = GetTimeNanoseconds();
 
 		const ksJson * animations = ksJson_GetMemberByName( rootNode, "animations" );
-		scene->animationCount = ksJson_GetMemberCount( animations );
-		scene->animations = (ksGltfAnimation *) calloc( scene->animationCount, sizeof( ksGltfAnimation ) );
-		scene->timeLineCount = 0;	// May not need all because they are often shared.
-		scene->timeLines = (ksGltfTimeLine *) calloc( scene->animationCount, sizeof( ksGltfTimeLine ) );
-		for ( int animationIndex = 0; animationIndex < scene->animationCount; animationIndex++ )
+		const int jsonAnimationCount = ksJson_GetMemberCount( animations );
+
+		// A glTF 2.0 animation may sample its channels with different inputs so it is split into one animation per input.
+		int maxAnimationCount = 0;
+		for ( int jsonAnimationIndex = 0; jsonAnimationIndex < jsonAnimationCount; jsonAnimationIndex++ )
 		{
-			const ksJson * animation = ksJson_GetMemberByIndex( animations, animationIndex );
-			scene->animations[animationIndex].name = ksGltf_strdup( ksJson_GetMemberName( animation ) );
+			const ksJson * animation = ksJson_GetMemberByIndex( animations, jsonAnimationIndex );
+			maxAnimationCount += version2 ? ksJson_GetMemberCount( ksJson_GetMemberByName( animation, "samplers" ) ) : 1;
+		}
 
+		scene->animationCount = 0;
+		scene->animations = (ksGltfAnimation *) calloc( maxAnimationCount, sizeof( ksGltfAnimation ) );
+		scene->timeLineCount = 0;	// May not need all because they are often shared.
+		scene->timeLines = (ksGltfTimeLine *) calloc( maxAnimationCount, sizeof( ksGltfTimeLine ) );
+		ksGltfAccessor ** inputAccessors = (ksGltfAccessor **) malloc( MAX( maxAnimationCount, 1 ) * sizeof( ksGltfAccessor * ) );
+		for ( int jsonAnimationIndex = 0; jsonAnimationIndex < jsonAnimationCount; jsonAnimationIndex++ )
+		{
+			const ksJson * animation = ksJson_GetMemberByIndex( animations, jsonAnimationIndex );
 			const ksJson * parameters = ksJson_GetMemberByName( animation, "parameters" );
 			const ksJson * samplers = ksJson_GetMemberByName( animation, "samplers" );
+			const ksJson * channels = ksJson_GetMemberByName( animation, "channels" );
+			const int channelCount = ksJson_GetMemberCount( channels );
 
-			// This assumes there is only a single time-line per animation.
-			const char * timeAccessorName = ksJson_GetString( ksJson_GetMemberByName( parameters, "TIME" ), "" );
-			const ksGltfAccessor * timeAccessor = ksGltf_GetAccessorByNameAndType( scene, timeAccessorName, "SCALAR", GL_FLOAT );
-
-			if ( timeAccessor == NULL || timeAccessor->count <= 0 )
+			int inputAccessorCount = 0;
+			if ( version2 )
 			{
-				assert( false );
-				continue;
+				for ( int samplerIndex = 0; samplerIndex < ksJson_GetMemberCount( samplers ); samplerIndex++ )
+				{
+					const ksJson * sampler = ksJson_GetMemberByIndex( samplers, samplerIndex );
+					ksGltfAccessor * inputAccessor = ksGltf_GetAccessorByReferenceAndType( scene, ksJson_GetMemberByName( sampler, "input" ), "SCALAR" );
+					int inputIndex = 0;
+					for ( ; inputIndex < inputAccessorCount; inputIndex++ )
+					{
+						if ( inputAccessors[inputIndex] == inputAccessor )
+						{
+							break;
+						}
+					}
+					if ( inputAccessor != NULL && inputIndex == inputAccessorCount )
+					{
+						inputAccessors[inputAccessorCount++] = inputAccessor;
+					}
+				}
 			}
-
-			const int sampleCount = timeAccessor->count;
-			float * sampleTimes = (float *)ksGltf_GetBufferData( timeAccessor );
-
-			assert( sampleCount >= 2 );
-			assert( sampleTimes != NULL );
-
-			// Animation time lines are often shared so check if this one already exists.
-			for ( int timeLineIndex = 0; timeLineIndex < scene->timeLineCount; timeLineIndex++ )
+			else
 			{
-				if ( sampleCount == scene->timeLines[timeLineIndex].sampleCount &&
-						sampleTimes == scene->timeLines[timeLineIndex].sampleTimes )
+				// This assumes there is only a single time-line per glTF 1.0 animation.
+				ksGltfAccessor * inputAccessor = ksGltf_GetAccessorByReferenceAndType( scene, ksJson_GetMemberByName( parameters, "TIME" ), "SCALAR" );
+				if ( inputAccessor != NULL )
 				{
-					scene->animations[animationIndex].timeLine = &scene->timeLines[timeLineIndex];
-					break;
+					inputAccessors[inputAccessorCount++] = inputAccessor;
 				}
 			}
-			if ( scene->animations[animationIndex].timeLine == NULL )
+
+			for ( int inputIndex = 0; inputIndex < inputAccessorCount; inputIndex++ )
 			{
-				// Create a new time line.
-				ksGltfTimeLine * timeLine = &scene->timeLines[scene->timeLineCount++];
-				timeLine->sampleCount = sampleCount;
-				timeLine->sampleTimes = sampleTimes;
+				ksGltfAccessor * timeAccessor = inputAccessors[inputIndex];
+				const int sampleCount = timeAccessor->count;
+				float * sampleTimes = ksGltf_GetAccessorFloats( timeAccessor );
+
+				if ( sampleCount < 2 || sampleTimes == NULL )
+				{
+					continue;
+				}
 
-				const float step = ( timeLine->sampleTimes[timeLine->sampleCount - 1] - timeLine->sampleTimes[0] ) / timeLine->sampleCount;
-				timeLine->duration = timeLine->sampleTimes[timeLine->sampleCount - 1] - timeLine->sampleTimes[0];
-				timeLine->rcpStep = 1.0f / step;
-				for ( int keyFrameIndex = 0; keyFrameIndex < timeLine->sampleCount; keyFrameIndex++ )
+				ksGltfAnimation * newAnimation = &scene->animations[scene->animationCount];
+				newAnimation->channels = (ksGltfAnimationChannel *) calloc( channelCount, sizeof( ksGltfAnimationChannel ) );
+				newAnimation->channelCount = 0;
+				for ( int channelIndex = 0; channelIndex < channelCount; channelIndex++ )
 				{
-					const float delta = timeLine->sampleTimes[keyFrameIndex] - keyFrameIndex * step;
-					// Check if the time is more than 0.1 milliseconds from a fixed-rate time-line.
-					if ( fabs( delta ) > 1e-4f )
+					const ksJson * channel = ksJson_GetMemberByIndex( channels, channelIndex );
+					const ksJson * samplerReference = ksJson_GetMemberByName( channel, "sampler" );
+					const ksJson * sampler = ksJson_IsNumber( samplerReference ) ?
+												ksJson_GetMemberByIndex( samplers, ksJson_GetInt32( samplerReference, -1 ) ) :
+												ksJson_GetMemberByName( samplers, ksJson_GetString( samplerReference, "" ) );
+					const char * interpolation = ksJson_GetString( ksJson_GetMemberByName( sampler, "interpolation" ), "LINEAR" );
+
+					ksGltfAccessor * outputAccessor = NULL;
+					if ( version2 )
+					{
+						if ( ksGltf_GetAccessorByReference( scene, ksJson_GetMemberByName( sampler, "input" ) ) != timeAccessor )
+						{
+							continue;
+						}
+						outputAccessor = ksGltf_GetAccessorByReference( scene, ksJson_GetMemberByName( sampler, "output" ) );
+					}
+					else
 					{
-						timeLine->rcpStep = 0.0f;
-						break;
+						const char * inputName = ksJson_GetString( ksJson_GetMemberByName( sampler, "input" ), "" );
+						const char * outputName = ksJson_GetString( ksJson_GetMemberByName( sampler, "output" ), "" );
+						outputAccessor = ksGltf_GetAccessorByReference( scene, ksJson_GetMemberByName( parameters, outputName ) );
+
+						assert( strcmp( inputName, "TIME" ) == 0 );
+						assert( strcmp( interpolation, "LINEAR" ) == 0 );
+						assert( outputName[0] != '\0' );
+
+						UNUSED_PARM( inputName );
 					}
-				}
 
-				scene->animations[animationIndex].timeLine = timeLine;
-			}
+					const ksJson * target = ksJson_GetMemberByName( channel, "target" );
+					const char * nodeName = version2 ? "" : ksJson_GetString( ksJson_GetMemberByName( target, "id" ), "" );
+					const int nodeIndex = version2 ? ksJson_GetInt32( ksJson_GetMemberByName( target, "node" ), -1 ) : -1;
+					const char * pathName = ksJson_GetString( ksJson_GetMemberByName( target, "path" ), "" );
 
-			const ksJson * channels = ksJson_GetMemberByName( animation, "channels" );
-			scene->animations[animationIndex].channelCount = ksJson_GetMemberCount( channels );
-			scene->animations[animationIndex].channels = (ksGltfAnimationChannel *) calloc( scene->animations[animationIndex].channelCount, sizeof( ksGltfAnimationChannel ) );
-			int newChannelCount = 0;
-			for ( int channelIndex = 0; channelIndex < scene->animations[animationIndex].channelCount; channelIndex++ )
-			{
-				const ksJson * channel = ksJson_GetMemberByIndex( channels, channelIndex );
-				const char * samplerName = ksJson_GetString( ksJson_GetMemberByName( channel, "sampler" ), "" );
-				const ksJson * sampler = ksJson_GetMemberByName( samplers, samplerName );
-				const char * inputName = ksJson_GetString( ksJson_GetMemberByName( sampler, "input" ), "" );
-				const char * interpolation = ksJson_GetString( ksJson_GetMemberByName( sampler, "interpolation" ), "" );
-				const char * outputName = ksJson_GetString( ksJson_GetMemberByName( sampler, "output" ), "" );
-				const char * accessorName = ksJson_GetString( ksJson_GetMemberByName( parameters, outputName ), "" );
+					// CUBICSPLINE interpolation linearly interpolates the key frame values and ignores the tangents.
+					const bool spline = ( strcmp( interpolation, "CUBICSPLINE" ) == 0 );
+					const bool step = ( strcmp( interpolation, "STEP" ) == 0 );
+					float * values = NULL;
+					if ( outputAccessor != NULL && spline )
+					{
+						values = ksGltf_GetAccessorSplineValues( outputAccessor, sampleCount );
+					}
+					else if ( outputAccessor != NULL && outputAccessor->count == sampleCount )
+					{
+						values = ksGltf_GetAccessorFloats( outputAccessor );
+					}
 
-				assert( strcmp( inputName, "TIME" ) == 0 );
-				assert( strcmp( interpolation, "LINEAR" ) == 0 );
-				assert( outputName[0] != '\0' );
-				assert( accessorName[0] != '\0' );
+					ksVector3f * translation = NULL;
+					ksQuatf * rotation = NULL;
+					ksVector3f * scale = NULL;
 
-				UNUSED_PARM( inputName );
-				UNUSED_PARM( interpolation );
+					if ( strcmp( pathName, "translation" ) == 0 )
+					{
+						assert( values != NULL && outputAccessor->componentCount == 3 );
+						translation = ( values != NULL && outputAccessor->componentCount == 3 ) ? (ksVector3f *) values : NULL;
+					}
+					else if ( strcmp( pathName, "rotation" ) == 0 )
+					{
+						assert( values != NULL && outputAccessor->componentCount == 4 );
+						rotation = ( values != NULL && outputAccessor->componentCount == 4 ) ? (ksQuatf *) values : NULL;
+					}
+					else if ( strcmp( pathName, "scale" ) == 0 )
+					{
+						assert( values != NULL && outputAccessor->componentCount == 3 );
+						scale = ( values != NULL && outputAccessor->componentCount == 3 ) ? (ksVector3f *) values : NULL;
+					}
 
-				const ksJson * target = ksJson_GetMemberByName( channel, "target" );
-				const char * nodeName = ksJson_GetString( ksJson_GetMemberByName( target, "id" ), "" );
-				const char * pathName = ksJson_GetString( ksJson_GetMemberByName( target, "path" ), "" );
+					const int component =	( ( translation != NULL ) ? GLTF_ANIMATION_COMPONENT_TRANSLATION : 0 ) |
+											( ( rotation != NULL ) ? GLTF_ANIMATION_COMPONENT_ROTATION : 0 ) |
+											( ( scale != NULL ) ? GLTF_ANIMATION_COMPONENT_SCALE : 0 );
+					const int ownedMask = spline ? component : 0;
+					const int stepMask = step ? component : 0;
+					if ( spline && component == 0 )
+					{
+						free( values );
+					}
 
-				ksVector3f * translation = NULL;
-				ksQuatf * rotation = NULL;
-				ksVector3f * scale = NULL;
+					// Try to merge this channel with a previous channel for the same node.
+					for ( int k = 0; k < newAnimation->channelCount; k++ )
+					{
+						if ( version2 ? ( nodeIndex == newAnimation->channels[k].nodeIndex ) : ( strcmp( nodeName, newAnimation->channels[k].nodeName ) == 0 ) )
+						{
+							// A component that is animated twice uses the last channel.
+							ksGltfAnimationChannel * merged = &newAnimation->channels[k];
+							if ( ( merged->ownedMask & GLTF_ANIMATION_COMPONENT_TRANSLATION & component ) != 0 ) free( merged->translation );
+							if ( ( merged->ownedMask & GLTF_ANIMATION_COMPONENT_ROTATION & component ) != 0 ) free( merged->rotation );
+							if ( ( merged->ownedMask & GLTF_ANIMATION_COMPONENT_SCALE & component ) != 0 ) free( merged->scale );
+							merged->ownedMask = ( merged->ownedMask & ~component ) | ownedMask;
+							merged->keyFrames.stepMask = ( merged->keyFrames.stepMask & ~component ) | stepMask;
+							if ( translation != NULL )
+							{
+								newAnimation->channels[k].translation = translation;
+								translation = NULL;
+							}
+							if ( rotation != NULL )
+							{
+								newAnimation->channels[k].rotation = rotation;
+								rotation = NULL;
+							}
+							if ( scale != NULL )
+							{
+								newAnimation->channels[k].scale = scale;
+								scale = NULL;
+							}
+							break;
+						}
+					}
 
-				if ( strcmp( pathName, "translation" ) == 0 )
-				{
-					const ksGltfAccessor * accessor	= ksGltf_GetAccessorByNameAndType( scene, accessorName, "VEC3", GL_FLOAT );
-					assert( accessor != NULL );
-					translation = (ksVector3f *) ksGltf_GetBufferData( accessor );
+					// Only store the channel if it was not merged.
+					if ( translation != NULL || rotation != NULL || scale != NULL )
+					{
+						newAnimation->channels[newAnimation->channelCount].nodeName = ksGltf_strdup( nodeName );
+						newAnimation->channels[newAnimation->channelCount].nodeIndex = nodeIndex;
+						newAnimation->channels[newAnimation->channelCount].node = NULL; // linked up once the nodes are loaded
+						newAnimation->channels[newAnimation->channelCount].translation = translation;
+						newAnimation->channels[newAnimation->channelCount].rotation = rotation;
+						newAnimation->channels[newAnimation->channelCount].scale = scale;
+						newAnimation->channels[newAnimation->channelCount].ownedMask = ownedMask;
+						newAnimation->channels[newAnimation->channelCount].keyFrames.stepMask = stepMask;
+						newAnimation->channelCount++;
+					}
 				}
-				else if ( strcmp( pathName, "rotation" ) == 0 )
+
+				if ( newAnimation->channelCount == 0 )
 				{
-					const ksGltfAccessor * accessor	= ksGltf_GetAccessorByNameAndType( scene, accessorName, "VEC4", GL_FLOAT );
-					assert( accessor != NULL );
-					rotation = (ksQuatf *) ksGltf_GetBufferData( accessor );
+					free( newAnimation->channels );
+					memset( newAnimation, 0, sizeof( ksGltfAnimation ) );
+					continue;
 				}
-				else if ( strcmp( pathName, "scale" ) == 0 )
+
+				newAnimation->name = ksGltf_ParseName( animation, "animation", jsonAnimationIndex );
+				if ( inputAccessorCount > 1 )
 				{
-					const ksGltfAccessor * accessor	= ksGltf_GetAccessorByNameAndType( scene, accessorName, "VEC3", GL_FLOAT );
-					assert( accessor != NULL );
-					scale = (ksVector3f *) ksGltf_GetBufferData( accessor );
+					char * name = (char *) malloc( strlen( newAnimation->name ) + 1 + 10 + 1 );
+					sprintf( name, "%s_%d", newAnimation->name, inputIndex );
+					free( newAnimation->name );
+					newAnimation->name = name;
 				}
 
-				// Try to merge this channel with a previous channel for the same node.
-				for ( int k = 0; k < newChannelCount; k++ )
+				// Animation time lines are often shared so check if this one already exists.
+				for ( int timeLineIndex = 0; timeLineIndex < scene->timeLineCount; timeLineIndex++ )
 				{
-					if ( strcmp( nodeName, scene->animations[animationIndex].channels[k].nodeName ) == 0 )
+					if ( sampleCount == scene->timeLines[timeLineIndex].sampleCount &&
+							sampleTimes == scene->timeLines[timeLineIndex].sampleTimes )
 					{
-						if ( translation != NULL )
-						{
-							scene->animations[animationIndex].channels[k].translation = translation;
-							translation = NULL;
-						}
-						if ( rotation != NULL )
-						{
-							scene->animations[animationIndex].channels[k].rotation = rotation;
-							rotation = NULL;
-						}
-						if ( scale != NULL )
-						{
-							scene->animations[animationIndex].channels[k].scale = scale;
-							scale = NULL;
-						}
+						newAnimation->timeLine = &scene->timeLines[timeLineIndex];
 						break;
 					}
 				}
-
-				// Only store the channel if it was not merged.
-				if ( translation != NULL || rotation != NULL || scale != NULL )
+				if ( newAnimation->timeLine == NULL )
 				{
-					scene->animations[animationIndex].channels[newChannelCount].nodeName = ksGltf_strdup( nodeName );
-					scene->animations[animationIndex].channels[newChannelCount].node = NULL; // linked up once the nodes are loaded
-					scene->animations[animationIndex].channels[newChannelCount].translation = translation;
-					scene->animations[animationIndex].channels[newChannelCount].rotation = rotation;
-					scene->animations[animationIndex].channels[newChannelCount].scale = scale;
-					newChannelCount++;
+					// Create a new time line.
+					ksGltfTimeLine * timeLine = &scene->timeLines[scene->timeLineCount++];
+					timeLine->sampleCount = sampleCount;
+					timeLine->sampleTimes = sampleTimes;
+
+					const float step = ( timeLine->sampleTimes[timeLine->sampleCount - 1] - timeLine->sampleTimes[0] ) / ( timeLine->sampleCount - 1 );
+					timeLine->duration = timeLine->sampleTimes[timeLine->sampleCount - 1] - timeLine->sampleTimes[0];
+					timeLine->rcpStep = ( step > 0.0f ) ? 1.0f / step : 0.0f;
+					for ( int keyFrameIndex = 0; keyFrameIndex < timeLine->sampleCount; keyFrameIndex++ )
+					{
+						const float delta = timeLine->sampleTimes[keyFrameIndex] - ( timeLine->sampleTimes[0] + keyFrameIndex * step );
+						// Check if the time is more than 0.1 milliseconds from a fixed-rate time-line.
+						if ( fabs( delta ) > 1e-4f )
+						{
+							timeLine->rcpStep = 0.0f;
+							break;
+						}
+					}
+
+					newAnimation->timeLine = timeLine;
 				}
+
+				scene->animationCount++;
 			}
-			scene->animations[animationIndex].channelCount = newChannelCount;
 		}
+		free( inputAccessors );
 		ksGltf_CreateAnimationNameHash( scene );
 
+		const ksNanoseconds loadEndTime = GetTimeNanoseconds();
+
+		ksGltfAnimationCompressionStats stats;
+		memset( &stats, 0, sizeof( stats ) );
+		for ( int animationIndex = 0; animationIndex < scene->animationCount; animationIndex++ )
+		{
+			ksGltfAnimation * animation = &scene->animations[animationIndex];
+			for ( int channelIndex = 0; channelIndex < animation->channelCount; channelIndex++ )
+			{
+				ksGltf_CompressAnimationChannel( &animation->channels[channelIndex], animation->timeLine, &stats );
+			}
+		}
+
 		const ksNanoseconds endTime = GetTimeNanoseconds();
-		Print( "%1.3f seconds to load animations\n", ( endTime - startTime ) * 1e-9f );
+		Print( "%1.3f seconds to load animations\n", ( loadEndTime - startTime ) * 1e-9f );
+		Print( "%1.3f seconds to compress animations from %d kB to %d kB storing %d of %d key frames\n", ( endTime - loadEndTime ) * 1e-9f,
+				(int)( stats.uncompressedSize >> 10 ), (int)( stats.compressedSize >> 10 ), stats.storedKeyFrameCount, stats.keyFrameCount );
+		Print( "maximum animation error: translation %1.5f, rotation %1.4f degrees, scale %1.5f\n",
+				stats.maxTranslationError, stats.maxRotationError * ( 180.0f / MATH_PI ), stats.maxScaleError );
 	}
 
 	//
@@ -4321,33 +7934,59 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 		for ( int skinIndex = 0; skinIndex < scene->skinCount; skinIndex++ )
 		{
 			const ksJson * skin = ksJson_GetMemberByIndex( skins, skinIndex );
-			scene->skins[skinIndex].name = ksGltf_strdup( ksJson_GetMemberName( skin ) );
+			scene->skins[skinIndex].name = ksGltf_ParseName( skin, "skin", skinIndex );
+
+			// glTF 2.0 no longer has a bind shape matrix because it is assumed to be pre-multiplied into the inverse bind matrices.
 			ksMatrix4x4f bindShapeMatrix;
-			ksGltf_ParseFloatArray( bindShapeMatrix.m[0], 16, ksJson_GetMemberByName( skin, "bindShapeMatrix" ) );
+			const ksJson * bindShape = ksJson_GetMemberByName( skin, "bindShapeMatrix" );
+			if ( bindShape != NULL )
+			{
+				ksGltf_ParseFloatArray( bindShapeMatrix.m[0], 16, bindShape );
+			}
+			else
+			{
+				ksMatrix4x4f_CreateIdentity( &bindShapeMatrix );
+			}
+
+			// glTF 1.0 references the joint nodes by joint name and glTF 2.0 references the joint nodes by index.
+			const ksJson * joints = ksJson_GetMemberByName( skin, version2 ? "joints" : "jointNames" );
+			scene->skins[skinIndex].jointCount = ksJson_GetMemberCount( joints );
+			scene->skins[skinIndex].joints = (ksGltfJoint *) calloc( scene->skins[skinIndex].jointCount, sizeof( ksGltfJoint ) );
+			assert( scene->skins[skinIndex].jointCount <= GLTF_MAX_JOINTS );
 
-			const char * bindAccessorName = ksJson_GetString( ksJson_GetMemberByName( skin, "inverseBindMatrices" ), "" );
-			const ksGltfAccessor * bindAccess = ksGltf_GetAccessorByNameAndType( scene, bindAccessorName, "MAT4", GL_FLOAT );
-			scene->skins[skinIndex].inverseBindMatrices = ksGltf_GetBufferData( bindAccess );
+			ksGltfAccessor * bindAccess = ksGltf_GetAccessorByReferenceAndType( scene, ksJson_GetMemberByName( skin, "inverseBindMatrices" ), "MAT4" );
+			scene->skins[skinIndex].inverseBindMatrices = (ksMatrix4x4f *) ksGltf_GetAccessorFloats( bindAccess );
+			if ( scene->skins[skinIndex].inverseBindMatrices == NULL && version2 )
+			{
+				// The inverse bind matrices are optional in glTF 2.0.
+				scene->skins[skinIndex].defaultInverseBindMatrices = (ksMatrix4x4f *) malloc( MAX( scene->skins[skinIndex].jointCount, 1 ) * sizeof( ksMatrix4x4f ) );
+				for ( int jointIndex = 0; jointIndex < scene->skins[skinIndex].jointCount; jointIndex++ )
+				{
+					ksMatrix4x4f_CreateIdentity( &scene->skins[skinIndex].defaultInverseBindMatrices[jointIndex] );
+				}
+				scene->skins[skinIndex].inverseBindMatrices = scene->skins[skinIndex].defaultInverseBindMatrices;
+			}
 
 			assert( scene->skins[skinIndex].name[0] != '\0' );
 			assert( scene->skins[skinIndex].inverseBindMatrices != NULL );
+			assert( bindAccess == NULL || bindAccess->count == scene->skins[skinIndex].jointCount );
 
 			scene->skins[skinIndex].parentNode = NULL;	// linked up once the nodes are loaded
 
-			const ksJson * jointNames = ksJson_GetMemberByName( skin, "jointNames" );
-			scene->skins[skinIndex].jointCount = ksJson_GetMemberCount( jointNames );
-			scene->skins[skinIndex].joints = (ksGltfJoint *) calloc( scene->skins[skinIndex].jointCount, sizeof( ksGltfJoint ) );
-			assert( scene->skins[skinIndex].jointCount <= MAX_JOINTS );
 			for ( int jointIndex = 0; jointIndex < scene->skins[skinIndex].jointCount; jointIndex++ )
 			{
-				ksMatrix4x4f inverseBindMatrix;
-				ksMatrix4x4f_Multiply( &inverseBindMatrix, &scene->skins[skinIndex].inverseBindMatrices[jointIndex], &bindShapeMatrix );
-				scene->skins[skinIndex].inverseBindMatrices[jointIndex] = inverseBindMatrix;
+				if ( bindShape != NULL )
+				{
+					ksMatrix4x4f inverseBindMatrix;
+					ksMatrix4x4f_Multiply( &inverseBindMatrix, &scene->skins[skinIndex].inverseBindMatrices[jointIndex], &bindShapeMatrix );
+					scene->skins[skinIndex].inverseBindMatrices[jointIndex] = inverseBindMatrix;
+				}
 
-				scene->skins[skinIndex].joints[jointIndex].name = ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByIndex( jointNames, jointIndex ), "" ) );
+				const ksJson * joint = ksJson_GetMemberByIndex( joints, jointIndex );
+				scene->skins[skinIndex].joints[jointIndex].name = ksGltf_strdup( version2 ? "" : ksJson_GetString( joint, "" ) );
+				scene->skins[skinIndex].joints[jointIndex].nodeIndex = version2 ? ksJson_GetInt32( joint, -1 ) : -1;
 				scene->skins[skinIndex].joints[jointIndex].node = NULL; // linked up once the nodes are loaded
 			}
-			assert( bindAccess->count == scene->skins[skinIndex].jointCount );
 
 			ksGpuBuffer_Create( context, &scene->skins[skinIndex].jointBuffer, KS_GPU_BUFFER_TYPE_UNIFORM, scene->skins[skinIndex].jointCount * sizeof( ksMatrix4x4f ), NULL, false );
 
@@ -4357,13 +7996,21 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 				const ksJson * KHR_skin_culling = ksJson_GetMemberByName( extensions, "KHR_skin_culling" );
 				if ( KHR_skin_culling != NULL )
 				{
-					const char * minsAccessorName = ksJson_GetString( ksJson_GetMemberByName( KHR_skin_culling, "jointGeometryMins" ), "" );
-					const ksGltfAccessor * minsAccessor = ksGltf_GetAccessorByNameAndType( scene, minsAccessorName, "VEC3", GL_FLOAT );
-					scene->skins[skinIndex].jointGeometryMins = ksGltf_GetBufferData( minsAccessor );
+					ksGltfAccessor * minsAccessor = ksGltf_GetAccessorByReferenceAndType( scene, ksJson_GetMemberByName( KHR_skin_culling, "jointGeometryMins" ), "VEC3" );
+					const ksVector3f * jointGeometryMins = (const ksVector3f *) ksGltf_GetAccessorFloats( minsAccessor );
 
-					const char * maxsAccessorName = ksJson_GetString( ksJson_GetMemberByName( KHR_skin_culling, "jointGeometryMaxs" ), "" );
-					const ksGltfAccessor * maxsAccessor = ksGltf_GetAccessorByNameAndType( scene, maxsAccessorName, "VEC3", GL_FLOAT );
-					scene->skins[skinIndex].jointGeometryMaxs = ksGltf_GetBufferData( maxsAccessor );
+					ksGltfAccessor * maxsAccessor = ksGltf_GetAccessorByReferenceAndType( scene, ksJson_GetMemberByName( KHR_skin_culling, "jointGeometryMaxs" ), "VEC3" );
+					const ksVector3f * jointGeometryMaxs = (const ksVector3f *) ksGltf_GetAccessorFloats( maxsAccessor );
+
+					if ( jointGeometryMins != NULL && jointGeometryMaxs != NULL )
+					{
+						ksBounds3fArray * jointGeometryBounds = &scene->skins[skinIndex].jointGeometryBounds;
+						ksGltf_AllocBoundsArray( jointGeometryBounds, scene->skins[skinIndex].jointCount );
+						for ( int jointIndex = 0; jointIndex < scene->skins[skinIndex].jointCount; jointIndex++ )
+						{
+							ksGltf_SetBoundsArray( jointGeometryBounds, jointIndex, &jointGeometryMins[jointIndex], &jointGeometryMaxs[jointIndex] );
+						}
+					}
 				}
 			}
 		}
@@ -4386,11 +8033,12 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 		{
 			const ksJson * camera = ksJson_GetMemberByIndex( cameras, cameraIndex );
 			const char * type = ksJson_GetString( ksJson_GetMemberByName( camera, "type" ), "" );
-			scene->cameras[cameraIndex].name = ksGltf_strdup( ksJson_GetMemberName( camera ) );
+			scene->cameras[cameraIndex].name = ksGltf_ParseName( camera, "camera", cameraIndex );
 			if ( strcmp( type, "perspective" ) == 0 )
 			{
 				const ksJson * perspective = ksJson_GetMemberByName( camera, "perspective" );
-				const float aspectRatio = ksJson_GetFloat( ksJson_GetMemberByName( perspective, "aspectRatio" ), 0.0f );
+				// The aspect ratio is optional in glTF 2.0.
+				const float aspectRatio = ksJson_GetFloat( ksJson_GetMemberByName( perspective, "aspectRatio" ), 1.0f );
 				const float yfov = ksJson_GetFloat( ksJson_GetMemberByName( perspective, "yfov" ), 0.0f );
 				scene->cameras[cameraIndex].type = GLTF_CAMERA_TYPE_PERSPECTIVE;
 				scene->cameras[cameraIndex].perspective.fovDegreesX = ( 180.0f / MATH_PI ) * 2.0f * atanf( tanf( yfov * 0.5f ) * aspectRatio );
@@ -4432,7 +8080,7 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 		for ( int nodeIndex = 0; nodeIndex < scene->nodeCount; nodeIndex++ )
 		{
 			const ksJson * node = ksJson_GetMemberByIndex( nodes, nodeIndex );
-			scene->nodes[nodeIndex].name = ksGltf_strdup( ksJson_GetMemberName( node ) );
+			scene->nodes[nodeIndex].name = ksGltf_ParseName( node, "node", nodeIndex );
 			scene->nodes[nodeIndex].jointName = ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByName( node, "jointName" ), "" ) );
 			const ksJson * matrix = ksJson_GetMemberByName( node, "matrix" );
 			if ( ksJson_IsArray( matrix ) )
@@ -4445,32 +8093,67 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 			}
 			else
 			{
-				ksGltf_ParseFloatArray( &scene->nodes[nodeIndex].rotation.x, 4, ksJson_GetMemberByName( node, "rotation" ) );
-				ksGltf_ParseFloatArray( &scene->nodes[nodeIndex].scale.x, 3, ksJson_GetMemberByName( node, "scale" ) );
+				// The rotation and scale default to identity.
+				const ksJson * rotation = ksJson_GetMemberByName( node, "rotation" );
+				const ksJson * scale = ksJson_GetMemberByName( node, "scale" );
+				scene->nodes[nodeIndex].rotation.w = 1.0f;
+				ksVector3f_Set( &scene->nodes[nodeIndex].scale, 1.0f );
+				if ( rotation != NULL )
+				{
+					ksGltf_ParseFloatArray( &scene->nodes[nodeIndex].rotation.x, 4, rotation );
+				}
+				if ( scale != NULL )
+				{
+					ksGltf_ParseFloatArray( &scene->nodes[nodeIndex].scale.x, 3, scale );
+				}
 				ksGltf_ParseFloatArray( &scene->nodes[nodeIndex].translation.x, 3, ksJson_GetMemberByName( node, "translation" ) );
 			}
 
 			assert( scene->nodes[nodeIndex].name[0] != '\0' );
 
+			// glTF 1.0 child names are resolved to indices once all nodes are loaded.
 			const ksJson * children = ksJson_GetMemberByName( node, "children" );
 			scene->nodes[nodeIndex].childCount = ksJson_GetMemberCount( children );
-			scene->nodes[nodeIndex].childNames = (char **) calloc( scene->nodes[nodeIndex].childCount, sizeof( char * ) );
+			scene->nodes[nodeIndex].childIndices = (int *) calloc( scene->nodes[nodeIndex].childCount, sizeof( int ) );
 			for ( int c = 0; c < scene->nodes[nodeIndex].childCount; c++ )
 			{
-				scene->nodes[nodeIndex].childNames[c] = ksGltf_strdup( ksJson_GetString( ksJson_GetMemberByIndex( children, c ), "" ) );
+				scene->nodes[nodeIndex].childIndices[c] = ksJson_GetInt32( ksJson_GetMemberByIndex( children, c ), -1 );
 			}
-			scene->nodes[nodeIndex].camera = ksGltf_GetCameraByName( scene, ksJson_GetString( ksJson_GetMemberByName( node, "camera" ), "" ) );
-			scene->nodes[nodeIndex].skin = ksGltf_GetSkinByName( scene, ksJson_GetString( ksJson_GetMemberByName( node, "skin" ), "" ) );
-			const ksJson * meshes = ksJson_GetMemberByName( node, "meshes" );
-			scene->nodes[nodeIndex].modelCount = ksJson_GetMemberCount( meshes );
+			scene->nodes[nodeIndex].camera = ksGltf_GetCameraByReference( scene, ksJson_GetMemberByName( node, "camera" ) );
+			scene->nodes[nodeIndex].skin = ksGltf_GetSkinByReference( scene, ksJson_GetMemberByName( node, "skin" ) );
+			// A glTF 2.0 node references a single mesh.
+			const ksJson * meshes = ksJson_GetMemberByName( node, version2 ? "mesh" : "meshes" );
+			scene->nodes[nodeIndex].modelCount = version2 ? ( meshes != NULL ? 1 : 0 ) : ksJson_GetMemberCount( meshes );
 			scene->nodes[nodeIndex].models = (ksGltfModel **) calloc( scene->nodes[nodeIndex].modelCount, sizeof( ksGltfModel ** ) );
 			for ( int m = 0; m < scene->nodes[nodeIndex].modelCount; m++ )
 			{
-				scene->nodes[nodeIndex].models[m] = ksGltf_GetModelByName( scene, ksJson_GetString( ksJson_GetMemberByIndex( meshes, m ), "" ) );
+				scene->nodes[nodeIndex].models[m] = ksGltf_GetModelByReference( scene, version2 ? meshes : ksJson_GetMemberByIndex( meshes, m ) );
 				assert( scene->nodes[nodeIndex].models[m] != NULL );
 			}
+			ksGltf_AllocBoundsArray( &scene->nodes[nodeIndex].modelBounds, scene->nodes[nodeIndex].modelCount );
+			for ( int m = 0; m < scene->nodes[nodeIndex].modelCount; m++ )
+			{
+				const ksGltfModel * model = scene->nodes[nodeIndex].models[m];
+				ksGltf_SetBoundsArray( &scene->nodes[nodeIndex].modelBounds, m, &model->mins, &model->maxs );
+			}
+		}
+		if ( !version2 )
+		{
+			ksGltf_CreateNodeNameHash( scene );
+			for ( int nodeIndex = 0; nodeIndex < scene->nodeCount; nodeIndex++ )
+			{
+				const ksJson * children = ksJson_GetMemberByName( ksJson_GetMemberByIndex( nodes, nodeIndex ), "children" );
+				for ( int c = 0; c < scene->nodes[nodeIndex].childCount; c++ )
+				{
+					const ksGltfNode * child = ksGltf_GetNodeByName( scene, ksJson_GetString( ksJson_GetMemberByIndex( children, c ), "" ) );
+					assert( child != NULL );
+					scene->nodes[nodeIndex].childIndices[c] = (int)( child - scene->nodes );
+				}
+			}
+			free( scene->nodeNameHash );
 		}
-		ksGltf_SortNodes( scene->nodes, scene->nodeCount );
+		nodeIndexRemap = (int *) malloc( scene->nodeCount * sizeof( int ) );
+		ksGltf_SortNodes( scene->nodes, scene->nodeCount, nodeIndexRemap );
 		ksGltf_CreateNodeNameHash( scene );
 		ksGltf_CreateNodeJointNameHash( scene );
 
@@ -4489,7 +8172,7 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 			node->children = (ksGltfNode **) calloc( node->childCount, sizeof( ksGltfNode * ) );
 			for ( int childIndex = 0; childIndex < node->childCount; childIndex++ )
 			{
-				node->children[childIndex] = ksGltf_GetNodeByName( scene, node->childNames[childIndex] );
+				node->children[childIndex] = &scene->nodes[node->childIndices[childIndex]];
 				assert( node->children[childIndex] != NULL );
 				node->children[childIndex]->parent = node;
 			}
@@ -4513,7 +8196,9 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 			for ( int channelIndex = 0; channelIndex < scene->animations[animationIndex].channelCount; channelIndex++ )
 			{
 				ksGltfAnimationChannel * channel = &scene->animations[animationIndex].channels[channelIndex];
-				channel->node = ksGltf_GetNodeByName( scene, channel->nodeName );
+				channel->node = ( channel->nodeIndex >= 0 && channel->nodeIndex < scene->nodeCount ) ?
+									&scene->nodes[nodeIndexRemap[channel->nodeIndex]] :
+									ksGltf_GetNodeByName( scene, channel->nodeName );
 				assert( channel->node != NULL );
 			}
 		}
@@ -4522,7 +8207,10 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 		{
 			for ( int jointIndex = 0; jointIndex < scene->skins[skinIndex].jointCount; jointIndex++ )
 			{
-				scene->skins[skinIndex].joints[jointIndex].node = ksGltf_GetNodeByJointName( scene, scene->skins[skinIndex].joints[jointIndex].name );
+				ksGltfJoint * joint = &scene->skins[skinIndex].joints[jointIndex];
+				joint->node = ( joint->nodeIndex >= 0 && joint->nodeIndex < scene->nodeCount ) ?
+								&scene->nodes[nodeIndexRemap[joint->nodeIndex]] :
+								ksGltf_GetNodeByJointName( scene, joint->name );
 				assert( scene->skins[skinIndex].joints[jointIndex].node != NULL );
 			}
 			// Find the parent of the root node of the skin.
@@ -4539,7 +8227,8 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 					}
 				}
 			}
-			scene->skins[skinIndex].parentNode = root->parent;
+			// A glTF 2.0 skeleton root may not have a parent, in which case the root itself is used.
+			scene->skins[skinIndex].parentNode = ( root->parent != NULL ) ? root->parent : root;
 		}
 	}
 
@@ -4555,7 +8244,7 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 		for ( int subSceneIndex = 0; subSceneIndex < scene->subSceneCount; subSceneIndex++ )
 		{
 			const ksJson * subScene = ksJson_GetMemberByIndex( subScenes, subSceneIndex );
-			scene->subScenes[subSceneIndex].name = ksGltf_strdup( ksJson_GetMemberName( subScene ) );
+			scene->subScenes[subSceneIndex].name = ksGltf_ParseName( subScene, "scene", subSceneIndex );
 
 			const ksJson * nodes = ksJson_GetMemberByName( subScene, "nodes" );
 			scene->subScenes[subSceneIndex].subTreeCount = ksJson_GetMemberCount( nodes );
@@ -4563,12 +8252,13 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 
 			for ( int subTreeIndex = 0; subTreeIndex < scene->subScenes[subSceneIndex].subTreeCount; subTreeIndex++ )
 			{
-				const char * nodeName = ksJson_GetString( ksJson_GetMemberByIndex( nodes, subTreeIndex ), "" );
+				ksGltfNode * subTreeRootNode = ksGltf_GetNodeByReference( scene, ksJson_GetMemberByIndex( nodes, subTreeIndex ), nodeIndexRemap );
+				assert( subTreeRootNode != NULL );
 
 				scene->subScenes[subSceneIndex].subTrees[subTreeIndex] = NULL;
 				for ( int i = 0; i < scene->subTreeCount; i++ )
 				{
-					if ( strcmp( scene->subTrees[i].name, nodeName ) == 0 )
+					if ( scene->subTrees[i].nodes[0] == subTreeRootNode )
 					{
 						scene->subScenes[subSceneIndex].subTrees[subTreeIndex] = &scene->subTrees[i];
 						break;
@@ -4578,10 +8268,7 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 				if ( scene->subScenes[subSceneIndex].subTrees[subTreeIndex] == NULL )
 				{
 					ksGltfSubTree * subTree = &scene->subTrees[scene->subTreeCount++];
-					subTree->name = ksGltf_strdup( nodeName );
-
-					ksGltfNode * subTreeRootNode = ksGltf_GetNodeByName( scene, nodeName );
-					assert( subTreeRootNode != NULL );
+					subTree->name = ksGltf_strdup( subTreeRootNode->name );
 
 					subTree->nodes = (ksGltfNode **) calloc( subTreeRootNode->subTreeNodeCount, sizeof( ksGltfNode * ) );
 					subTree->nodeCount = subTreeRootNode->subTreeNodeCount;
@@ -4598,7 +8285,7 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 					{
 						bool include = false;
 						ksGltfAnimation * animation = &scene->animations[animationIndex];
-						for ( int channelIndex = 0; animation->channelCount; channelIndex++ )
+						for ( int channelIndex = 0; channelIndex < animation->channelCount; channelIndex++ )
 						{
 							if ( animation->channels[channelIndex].node >= subTreeRootNode &&
 									animation->channels[channelIndex].node < subTreeRootNode + subTreeRootNode->subTreeNodeCount )
@@ -4648,73 +8335,30 @@ static bool ksGltfScene_CreateFromFile( ksGpuContext * context, ksGltfScene * sc
 	// glTF default scene
 	//
 
-	const char * defaultSceneName = ksJson_GetString( ksJson_GetMemberByName( rootNode, "scene" ), "" );
-	scene->state.currentSubScene = ksGltf_GetSubSceneByName( scene, defaultSceneName );
+	scene->state.currentSubScene = ksGltf_GetSubSceneByReference( scene, ksJson_GetMemberByName( rootNode, "scene" ) );
+	if ( scene->state.currentSubScene == NULL && scene->subSceneCount > 0 )
+	{
+		// The default scene is optional in glTF 2.0.
+		scene->state.currentSubScene = &scene->subScenes[0];
+	}
 	assert( scene->state.currentSubScene != NULL );
 
 	ksJson_Destroy( rootNode );
 
-	// Allocate run-time state memory.
-	scene->state.timeLineFrameState = (ksGltfTimeLineFrameState *) calloc( scene->timeLineCount, sizeof( ksGltfTimeLineFrameState ) );
-	scene->state.skinCullingState = (ksGltfSkinCullingState *) calloc( scene->skinCount, sizeof( ksGltfSkinCullingState ) );
-	for ( int skinIndex = 0; skinIndex < scene->skinCount; skinIndex++ )
-	{
-		ksGltfSkinCullingState * skinCullingState = &scene->state.skinCullingState[skinIndex];
-		ksVector3f_Set( &skinCullingState->mins, FLT_MAX );
-		ksVector3f_Set( &skinCullingState->maxs, -FLT_MAX );
-		skinCullingState->culled = false;
-	}
-	scene->state.nodeState = (ksGltfNodeState *) calloc( scene->nodeCount, sizeof( ksGltfNodeState ) );
+	// The node child indices are only needed while loading.
 	for ( int nodeIndex = 0; nodeIndex < scene->nodeCount; nodeIndex++ )
 	{
-		const ksGltfNode * node = &scene->nodes[nodeIndex];
-		ksGltfNodeState * nodeState = &scene->state.nodeState[nodeIndex];
-		nodeState->parent = ( node->parent != NULL ) ? &scene->state.nodeState[(int)( node->parent - scene->nodes )] : NULL;
-		nodeState->translation = node->translation;
-		nodeState->rotation = node->rotation;
-		nodeState->scale = node->scale;
-		ksMatrix4x4f_CreateIdentity( &nodeState->localTransform );
-		ksMatrix4x4f_CreateIdentity( &nodeState->globalTransform );
-	}
-	scene->state.subTreeState = (ksGltfSubTreeState *) calloc( scene->subTreeCount, sizeof( ksGltfSubTreeState ) );
-	for ( int subTreeIndex = 0; subTreeIndex < scene->subTreeCount; subTreeIndex++ )
-	{
-		scene->state.subTreeState[subTreeIndex].visible = true;
-	}
-
-	// Create view projection uniform buffer.
-	{
-		ksGpuBuffer_Create( context, &scene->viewProjectionBuffer, KS_GPU_BUFFER_TYPE_UNIFORM, 4 * sizeof( ksMatrix4x4f ), NULL, false );
+		free( scene->nodes[nodeIndex].childIndices );
+		scene->nodes[nodeIndex].childIndices = NULL;
 	}
+	free( nodeIndexRemap );
 
-	// Create a default joint uniform buffer.
-	{
-		ksMatrix4x4f * data = malloc( MAX_JOINTS * sizeof( ksMatrix4x4f ) );
-		for ( int jointIndex = 0; jointIndex < MAX_JOINTS; jointIndex++ )
-		{
-			ksMatrix4x4f_CreateIdentity( &data[jointIndex] );
-		}
-		ksGpuBuffer_Create( context, &scene->defaultJointBuffer, KS_GPU_BUFFER_TYPE_UNIFORM, MAX_JOINTS * sizeof( ksMatrix4x4f ), data, false );
-		free( data );
-	}
+	ksGltf_CreateRunTimeState( context, scene, renderPass );
 
-	// Create unit cube.
+	if ( bakedScene != NULL )
 	{
-		ksGpuGeometry_CreateCube( context, &scene->unitCubeGeometry, 0.0f, 1.0f );
-		ksGpuGraphicsProgram_Create( context, &scene->unitCubeFlatShadeProgram,
-									PROGRAM( unitCubeFlatShadeVertexProgram ), sizeof( PROGRAM( unitCubeFlatShadeVertexProgram ) ),
-									PROGRAM( unitCubeFlatShadeFragmentProgram ), sizeof( PROGRAM( unitCubeFlatShadeFragmentProgram ) ),
-									unitCubeFlatShadeProgramParms, ARRAY_SIZE( unitCubeFlatShadeProgramParms ),
-									scene->unitCubeGeometry.layout, VERTEX_ATTRIBUTE_FLAG_POSITION | VERTEX_ATTRIBUTE_FLAG_NORMAL );
-
-		ksGpuGraphicsPipelineParms pipelineParms;
-		ksGpuGraphicsPipelineParms_Init( &pipelineParms );
-
-		pipelineParms.renderPass = renderPass;
-		pipelineParms.program = &scene->unitCubeFlatShadeProgram;
-		pipelineParms.geometry = &scene->unitCubeGeometry;
-
-		ksGpuGraphicsPipeline_Create( context, &scene->unitCubePipeline, &pipelineParms );
+		ksGltf_WriteBakedScene( settings->glTFCache, scene, bakedScene, settings );
+		ksGltf_FreeBakedScene( bakedScene, scene );
 	}
 
 	const ksNanoseconds t1 = GetTimeNanoseconds();
@@ -4728,21 +8372,34 @@ static void ksGltfScene_Destroy( ksGpuContext * context, ksGltfScene * scene )
 {
 	ksGpuContext_WaitIdle( context );
 
+	ksGltf_DestroyRunTimeState( context, scene );
+
+	// All scene data of a baked scene is stored in place in the baked data.
+	if ( scene->bakedData != NULL )
 	{
-		free( scene->state.timeLineFrameState );
-		free( scene->state.skinCullingState );
-		free( scene->state.nodeState );
-		free( scene->state.subTreeState );
+		ksGltf_DestroyBakedScene( context, scene );
+		memset( scene, 0, sizeof( ksGltfScene ) );
+		return;
 	}
+
 	{
 		for ( int bufferIndex = 0; bufferIndex < scene->bufferCount; bufferIndex++ )
 		{
 			free( scene->buffers[bufferIndex].name );
 			free( scene->buffers[bufferIndex].type );
-			free( scene->buffers[bufferIndex].bufferData );
+			switch ( scene->buffers[bufferIndex].bufferDataStorage )
+			{
+				case GLTF_BUFFER_DATA_ALLOCATED:	free( scene->buffers[bufferIndex].bufferData ); break;
+				case GLTF_BUFFER_DATA_MAPPED:		ksJson_UnloadFile( (char *) scene->buffers[bufferIndex].bufferData, scene->buffers[bufferIndex].bufferDataSize, true ); break;
+				case GLTF_BUFFER_DATA_BINARY_GLTF:	break;
+			}
 		}
 		free( scene->buffers );
 		free( scene->bufferNameHash );
+		if ( scene->binaryFileData != NULL )
+		{
+			ksJson_UnloadFile( (char *) scene->binaryFileData, scene->binaryFileSize, scene->binaryFileMapped );
+		}
 	}
 	{
 		for ( int bufferViewIndex = 0; bufferViewIndex < scene->bufferViewCount; bufferViewIndex++ )
@@ -4757,6 +8414,7 @@ static void ksGltfScene_Destroy( ksGpuContext * context, ksGltfScene * scene )
 		{
 			free( scene->accessors[accessorIndex].name );
 			free( scene->accessors[accessorIndex].type );
+			free( scene->accessors[accessorIndex].unpackedData );
 		}
 		free( scene->accessors );
 		free( scene->accessorNameHash );
@@ -4844,18 +8502,16 @@ static void ksGltfScene_Destroy( ksGpuContext * context, ksGltfScene * scene )
 		free( scene->materialNameHash );
 	}
 	{
+		ksGltf_DestroySurfaceGeometry( context, scene );
 		for ( int modelIndex = 0; modelIndex < scene->modelCount; modelIndex++ )
 		{
-			for ( int surfaceIndex = 0; surfaceIndex < scene->models[modelIndex].surfaceCount; surfaceIndex++ )
-			{
-				ksGpuGeometry_Destroy( context, &scene->models[modelIndex].surfaces[surfaceIndex].geometry );
-				ksGpuGraphicsPipeline_Destroy( context, &scene->models[modelIndex].surfaces[surfaceIndex].pipeline );
-			}
 			free( scene->models[modelIndex].name );
 			free( scene->models[modelIndex].surfaces );
+			ksGltf_FreeBoundsArray( &scene->models[modelIndex].surfaceBounds );
 		}
 		free( scene->models );
 		free( scene->modelNameHash );
+		free( scene->geometryBuffers );
 	}
 	{
 		free( scene->timeLines );
@@ -4867,6 +8523,7 @@ static void ksGltfScene_Destroy( ksGpuContext * context, ksGltfScene * scene )
 			for ( int channelIndex = 0; channelIndex < scene->animations[animationIndex].channelCount; channelIndex++ )
 			{
 				free( scene->animations[animationIndex].channels[channelIndex].nodeName );
+				free( scene->animations[animationIndex].channels[channelIndex].keyFrames.data );
 			}
 			free( scene->animations[animationIndex].name );
 			free( scene->animations[animationIndex].channels );
@@ -4883,120 +8540,390 @@ static void ksGltfScene_Destroy( ksGpuContext * context, ksGltfScene * scene )
 			}
 			free( scene->skins[skinIndex].name );
 			free( scene->skins[skinIndex].joints );
+			free( scene->skins[skinIndex].defaultInverseBindMatrices );
+			ksGltf_FreeBoundsArray( &scene->skins[skinIndex].jointGeometryBounds );
 			ksGpuBuffer_Destroy( context, &scene->skins[skinIndex].jointBuffer );
 		}
 		free( scene->skins );
 		free( scene->skinNameHash );
 	}
 	{
-		for ( int cameraIndex = 0; cameraIndex < scene->cameraCount; cameraIndex++ )
-		{
-			free( scene->cameras[cameraIndex].name );
-		}
-		free( scene->cameras );
-		free( scene->cameraNameHash );
+		for ( int cameraIndex = 0; cameraIndex < scene->cameraCount; cameraIndex++ )
+		{
+			free( scene->cameras[cameraIndex].name );
+		}
+		free( scene->cameras );
+		free( scene->cameraNameHash );
+	}
+	{
+		for ( int nodeIndex = 0; nodeIndex < scene->nodeCount; nodeIndex++ )
+		{
+			free( scene->nodes[nodeIndex].name );
+			free( scene->nodes[nodeIndex].jointName );
+			free( scene->nodes[nodeIndex].children );
+			free( scene->nodes[nodeIndex].childIndices );
+			free( scene->nodes[nodeIndex].models );
+			ksGltf_FreeBoundsArray( &scene->nodes[nodeIndex].modelBounds );
+		}
+		free( scene->nodes );
+		free( scene->nodeNameHash );
+		free( scene->nodeJointNameHash );
+	}
+	{
+		for ( int subTreeIndex = 0; subTreeIndex < scene->subTreeCount; subTreeIndex++ )
+		{
+			free( scene->subTrees[subTreeIndex].nodes );
+			free( scene->subTrees[subTreeIndex].timeLines );
+			free( scene->subTrees[subTreeIndex].animations );
+		}
+		free( scene->subTrees );
+	}
+	{
+		for ( int subSceneIndex = 0; subSceneIndex < scene->subSceneCount; subSceneIndex++ )
+		{
+			free( scene->subScenes[subSceneIndex].subTrees );
+		}
+		free( scene->subScenes );
+		free( scene->subSceneNameHash );
+	}
+
+	memset( scene, 0, sizeof( ksGltfScene ) );
+}
+
+static int ksGltfScene_GetSubSceneHandle( const ksGltfScene * scene, const char * subSceneName )
+{
+	const ksGltfSubScene * subScene = ksGltf_GetSubSceneByName( scene, subSceneName );
+	return ( subScene != NULL ) ? (int)( subScene - scene->subScenes ) : -1;
+}
+
+static int ksGltfScene_GetSubTreeHandle( const ksGltfScene * scene, const char * subTreeName )
+{
+	const ksGltfSubTree * subTree = ksGltf_GetSubTreeByName( scene, subTreeName );
+	return ( subTree != NULL ) ? (int)( subTree - scene->subTrees ) : -1;
+}
+
+static int ksGltfScene_GetAnimationHandle( const ksGltfScene * scene, const char * animationName )
+{
+	const ksGltfAnimation * animation = ksGltf_GetAnimationByName( scene, animationName );
+	return ( animation != NULL ) ? (int)( animation - scene->animations ) : -1;
+}
+
+static int ksGltfScene_GetNodeHandle( const ksGltfScene * scene, const char * nodeName )
+{
+	const ksGltfNode * node = ksGltf_GetNodeByName( scene, nodeName );
+	return ( node != NULL ) ? (int)( node - scene->nodes ) : -1;
+}
+
+static void ksGltfScene_SetSubSceneByHandle( ksGltfScene * scene, const int subSceneHandle )
+{
+	assert( subSceneHandle >= 0 && subSceneHandle < scene->subSceneCount );
+	if ( subSceneHandle >= 0 )
+	{
+		scene->state.currentSubScene = &scene->subScenes[subSceneHandle];
+	}
+}
+
+static void ksGltfScene_SetSubTreeVisibleByHandle( ksGltfScene * scene, const int subTreeHandle, const bool visible )
+{
+	assert( subTreeHandle >= 0 && subTreeHandle < scene->subTreeCount );
+	if ( subTreeHandle >= 0 )
+	{
+		scene->state.subTreeState[subTreeHandle].visible = visible;
+	}
+}
+
+static void ksGltfScene_SetAnimationEnabledByHandle( ksGltfScene * scene, const int animationHandle, const bool enabled )
+{
+	assert( animationHandle >= 0 && animationHandle < scene->animationCount );
+	if ( animationHandle >= 0 )
+	{
+		scene->state.animationEnabled[animationHandle] = enabled;
+	}
+}
+
+static void ksGltfScene_SetNodeTranslationByHandle( ksGltfScene * scene, const int nodeHandle, const ksVector3f * translation )
+{
+	assert( nodeHandle >= 0 && nodeHandle < scene->nodeCount );
+	if ( nodeHandle >= 0 )
+	{
+		ksGltf_SetNodeTransform( &scene->state.nodeState, nodeHandle, translation, NULL, NULL );
+	}
+}
+
+static void ksGltfScene_SetNodeRotationByHandle( ksGltfScene * scene, const int nodeHandle, const ksQuatf * rotation )
+{
+	assert( nodeHandle >= 0 && nodeHandle < scene->nodeCount );
+	if ( nodeHandle >= 0 )
+	{
+		ksGltf_SetNodeTransform( &scene->state.nodeState, nodeHandle, NULL, rotation, NULL );
+	}
+}
+
+static void ksGltfScene_SetNodeScaleByHandle( ksGltfScene * scene, const int nodeHandle, const ksVector3f * scale )
+{
+	assert( nodeHandle >= 0 && nodeHandle < scene->nodeCount );
+	if ( nodeHandle >= 0 )
+	{
+		ksGltf_SetNodeTransform( &scene->state.nodeState, nodeHandle, NULL, NULL, scale );
+	}
+}
+
+static void ksGltfScene_SetSubScene( ksGltfScene * scene, const char * subSceneName )
+{
+	ksGltfScene_SetSubSceneByHandle( scene, ksGltfScene_GetSubSceneHandle( scene, subSceneName ) );
+}
+
+static void ksGltfScene_SetSubTreeVisible( ksGltfScene * scene, const char * subTreeName, const bool visible )
+{
+	ksGltfScene_SetSubTreeVisibleByHandle( scene, ksGltfScene_GetSubTreeHandle( scene, subTreeName ), visible );
+}
+
+static void ksGltfScene_SetAnimationEnabled( ksGltfScene * scene, const char * animationName, const bool enabled )
+{
+	ksGltfScene_SetAnimationEnabledByHandle( scene, ksGltfScene_GetAnimationHandle( scene, animationName ), enabled );
+}
+
+static void ksGltfScene_SetNodeTranslation( ksGltfScene * scene, const char * nodeName, const ksVector3f * translation )
+{
+	ksGltfScene_SetNodeTranslationByHandle( scene, ksGltfScene_GetNodeHandle( scene, nodeName ), translation );
+}
+
+static void ksGltfScene_SetNodeRotation( ksGltfScene * scene, const char * nodeName, const ksQuatf * rotation )
+{
+	ksGltfScene_SetNodeRotationByHandle( scene, ksGltfScene_GetNodeHandle( scene, nodeName ), rotation );
+}
+
+static void ksGltfScene_SetNodeScale( ksGltfScene * scene, const char * nodeName, const ksVector3f * scale )
+{
+	ksGltfScene_SetNodeScaleByHandle( scene, ksGltfScene_GetNodeHandle( scene, nodeName ), scale );
+}
+
+static void ksGltf_UpdateTimeLineFrameState( ksGltfScene * scene, const ksGltfTimeLine * timeLine, const ksNanoseconds time )
+{
+	const float timeInSeconds = timeLine->sampleTimes[0] + fmodf( time * 1e-9f, timeLine->duration );
+	int frame = 0;
+	if ( timeLine->rcpStep != 0.0f )
+	{
+		// Use direct lookup if this is a fixed rate animation.
+		frame = MIN( (int)( ( timeInSeconds - timeLine->sampleTimes[0] ) * timeLine->rcpStep ), timeLine->sampleCount - 2 );
 	}
+	else
 	{
-		for ( int nodeIndex = 0; nodeIndex < scene->nodeCount; nodeIndex++ )
+		// Use a binary search to find the key frame.
+		for ( int sampleCount = timeLine->sampleCount; sampleCount > 1; sampleCount >>= 1 )
 		{
-			for ( int childIndex = 0; childIndex < scene->nodes[nodeIndex].childCount; childIndex++ )
+			const int mid = sampleCount >> 1;
+			if ( timeInSeconds >= timeLine->sampleTimes[frame + mid] )
 			{
-				free( scene->nodes[nodeIndex].childNames[childIndex] );
+				frame += mid;
+				sampleCount = ( sampleCount - mid ) * 2;
 			}
-			free( scene->nodes[nodeIndex].name );
-			free( scene->nodes[nodeIndex].jointName );
-			free( scene->nodes[nodeIndex].children );
-			free( scene->nodes[nodeIndex].childNames );
-			free( scene->nodes[nodeIndex].models );
 		}
-		free( scene->nodes );
-		free( scene->nodeNameHash );
-		free( scene->nodeJointNameHash );
 	}
+	const int timeLineStateIndex = (int)( timeLine - scene->timeLines );
+	scene->state.timeLineFrameState[timeLineStateIndex].frame = frame;
+	scene->state.timeLineFrameState[timeLineStateIndex].fraction = ( timeInSeconds - timeLine->sampleTimes[frame] ) / ( timeLine->sampleTimes[frame + 1] - timeLine->sampleTimes[frame] );
+}
+
+// Only the channels that target nodes of the sub-tree are applied, such that sub-trees that
+// share an animation can be animated concurrently. The other channels are applied by their own sub-tree.
+static void ksGltf_AnimateSubTree( ksGltfScene * scene, const ksGltfSubTree * subTree )
+{
+	const ksGltfNode * firstNode = subTree->nodes[0];
+	for ( int animIndex = 0; animIndex < subTree->animationCount; animIndex++ )
 	{
-		for ( int subTreeIndex = 0; subTreeIndex < scene->subTreeCount; subTreeIndex++ )
+		const ksGltfAnimation * animation = subTree->animations[animIndex];
+		const int animationIndex = (int)( animation - scene->animations );
+		if ( !scene->state.animationEnabled[animationIndex] )
 		{
-			free( scene->subTrees[subTreeIndex].nodes );
-			free( scene->subTrees[subTreeIndex].timeLines );
-			free( scene->subTrees[subTreeIndex].animations );
+			continue;
 		}
-		free( scene->subTrees );
-	}
-	{
-		for ( int subSceneIndex = 0; subSceneIndex < scene->subSceneCount; subSceneIndex++ )
+		ksGltfChannelKeyState * channelKeyState = scene->state.channelKeyState[animationIndex];
+
+		const int timeLineIndex = (int)( animation->timeLine - scene->timeLines );
+		const int frame = scene->state.timeLineFrameState[timeLineIndex].frame;
+		const float fraction = scene->state.timeLineFrameState[timeLineIndex].fraction;
+
+		for ( int channelIndex = 0; channelIndex < animation->channelCount; channelIndex++ )
 		{
-			free( scene->subScenes[subSceneIndex].subTrees );
+			const ksGltfAnimationChannel * channel = &animation->channels[channelIndex];
+			if ( channel->node < firstNode || channel->node >= firstNode + subTree->nodeCount )
+			{
+				continue;
+			}
+			ksVector3f translation;
+			ksQuatf rotation;
+			ksVector3f scale;
+			ksGltf_SampleCompressedKeyFrames( &channelKeyState[channelIndex], &channel->keyFrames, frame, fraction, &translation, &rotation, &scale );
+			ksGltf_SetNodeTransform( &scene->state.nodeState, (int)( channel->node - scene->nodes ),
+									( channel->keyFrames.translation != NULL ) ? &translation : NULL,
+									( channel->keyFrames.rotation != NULL ) ? &rotation : NULL,
+									( channel->keyFrames.scale != NULL ) ? &scale : NULL );
 		}
-		free( scene->subScenes );
-		free( scene->subSceneNameHash );
 	}
+}
 
-	ksGpuBuffer_Destroy( context, &scene->viewProjectionBuffer );
-	ksGpuBuffer_Destroy( context, &scene->defaultJointBuffer );
-	ksGpuGraphicsPipeline_Destroy( context, &scene->unitCubePipeline );
-	ksGpuGraphicsProgram_Destroy( context, &scene->unitCubeFlatShadeProgram );
-	ksGpuGeometry_Destroy( context, &scene->unitCubeGeometry );
-
-	memset( scene, 0, sizeof( ksGltfScene ) );
+static bool ksGltf_IsAnyNodeDirty( const ksGltfNodeState * nodeState, const int firstNode, const int nodeCount )
+{
+	bool dirty = false;
+	for ( int nodeIndex = firstNode; nodeIndex < firstNode + nodeCount; nodeIndex++ )
+	{
+		dirty |= nodeState->localDirty[nodeIndex];
+	}
+	return dirty;
 }
 
-static void ksGltfScene_SetSubScene( ksGltfScene * scene, const char * subSceneName )
+// Creates the local transforms of a range of consecutive nodes four at a time.
+// Blocks of nodes without any dirty nodes are skipped.
+static void ksGltf_CreateLocalTransforms( ksGltfNodeState * nodeState, const int firstNode, const int nodeCount )
 {
-	ksGltfSubScene * subScene = ksGltf_GetSubSceneByName( scene, subSceneName );
-	assert( subScene != NULL );
-	if ( subScene != NULL )
+	for ( int blockNode = firstNode; blockNode < firstNode + nodeCount; blockNode += GLTF_SIMULATE_BLOCK_NODES )
 	{
-		scene->state.currentSubScene = subScene;
+		const int blockNodeCount = MIN( firstNode + nodeCount - blockNode, GLTF_SIMULATE_BLOCK_NODES );
+		if ( !ksGltf_IsAnyNodeDirty( nodeState, blockNode, blockNodeCount ) )
+		{
+			continue;
+		}
+		ksTransformArray transforms;
+		for ( int i = 0; i < 3; i++ )
+		{
+			transforms.translation[i] = nodeState->transforms.translation[i] + blockNode;
+			transforms.scale[i] = nodeState->transforms.scale[i] + blockNode;
+		}
+		for ( int i = 0; i < 4; i++ )
+		{
+			transforms.rotation[i] = nodeState->transforms.rotation[i] + blockNode;
+		}
+		ksMatrix4x4f_CreateTranslationRotationScaleArray( &nodeState->localTransform[blockNode], &transforms, blockNodeCount );
 	}
 }
 
-static void ksGltfScene_SetSubTreeVisible( ksGltfScene * scene, const char * subTreeName, const bool visible )
+// The global transform of the parent must be up to date. The global transform is only
+// recalculated if the node is dirty or if the global transform of the parent changed.
+static void ksGltf_ComposeGlobalTransform( ksGltfNodeState * nodeState, const int nodeIndex, const int simulateIndex )
 {
-	ksGltfSubTree * subTree = ksGltf_GetSubTreeByName( scene, subTreeName );
-	assert( subTree != NULL );
-	if ( subTree != NULL )
+	const int parentIndex = nodeState->parent[nodeIndex];
+	if ( !nodeState->localDirty[nodeIndex] && ( parentIndex < 0 || nodeState->globalSimulateIndex[parentIndex] != simulateIndex ) )
+	{
+		return;
+	}
+	nodeState->localDirty[nodeIndex] = false;
+	nodeState->globalSimulateIndex[nodeIndex] = simulateIndex;
+
+	// The global transform stays rigid as long as all scales along the hierarchy are uniform.
+	const ksVector3f scale = { nodeState->transforms.scale[0][nodeIndex], nodeState->transforms.scale[1][nodeIndex], nodeState->transforms.scale[2][nodeIndex] };
+	const ksGltfTransformType localTransformType = ksGltf_IsUniformScale( &scale ) ? GLTF_TRANSFORM_TYPE_RIGID : GLTF_TRANSFORM_TYPE_AFFINE;
+
+	if ( parentIndex >= 0 )
+	{
+		assert( parentIndex < nodeIndex );
+		ksMatrix4x4f_Multiply( &nodeState->globalTransform[nodeIndex], &nodeState->globalTransform[parentIndex], &nodeState->localTransform[nodeIndex] );
+		nodeState->globalTransformType[nodeIndex] = ( nodeState->globalTransformType[parentIndex] == GLTF_TRANSFORM_TYPE_RIGID ) ? localTransformType : GLTF_TRANSFORM_TYPE_AFFINE;
+	}
+	else
+	{
+		nodeState->globalTransform[nodeIndex] = nodeState->localTransform[nodeIndex];
+		nodeState->globalTransformType[nodeIndex] = localTransformType;
+	}
+
+	if ( nodeState->globalInverseRequired[nodeIndex] )
 	{
-		scene->state.subTreeState[(int)( subTree - scene->subTrees )].visible = visible;
+		if ( nodeState->globalTransformType[nodeIndex] == GLTF_TRANSFORM_TYPE_RIGID )
+		{
+			ksMatrix4x4f_InvertRigid( &nodeState->globalInverseTransform[nodeIndex], &nodeState->globalTransform[nodeIndex] );
+		}
+		else
+		{
+			ksMatrix4x4f_InvertAffine( &nodeState->globalInverseTransform[nodeIndex], &nodeState->globalTransform[nodeIndex] );
+		}
 	}
 }
 
-static void ksGltfScene_SetAnimationEnabled( ksGltfScene * scene, const char * animationName, const bool enabled )
+static void ksGltf_SimulateSubTreeJob( void * jobs, const int jobIndex )
 {
-	ksGltfAnimation * animation = ksGltf_GetAnimationByName( scene, animationName );
-	assert( animation != NULL );
-	if ( animation != NULL )
+	const ksGltfSimulateJob * job = &( (ksGltfSimulateJob *) jobs )[jobIndex];
+	ksGltfScene * scene = job->scene;
+	const ksGltfSubTree * subTree = job->subTree;
+
+	ksGltf_AnimateSubTree( scene, subTree );
+
+	// Transform the node hierarchy into global space. The nodes of a sub-tree are consecutive and
+	// are transformed in blocks such that the local transforms are still in the cache when composed.
+	const int firstNode = (int)( subTree->nodes[0] - scene->nodes );
+	if ( !ksGltf_IsAnyNodeDirty( &scene->state.nodeState, firstNode, subTree->nodeCount ) )
 	{
-		UNUSED_PARM( enabled );
+		return;
+	}
+	for ( int blockNode = 0; blockNode < subTree->nodeCount; blockNode += GLTF_SIMULATE_BLOCK_NODES )
+	{
+		const int blockNodeCount = MIN( subTree->nodeCount - blockNode, GLTF_SIMULATE_BLOCK_NODES );
+		ksGltf_CreateLocalTransforms( &scene->state.nodeState, firstNode + blockNode, blockNodeCount );
+		for ( int nodeIndex = 0; nodeIndex < blockNodeCount; nodeIndex++ )
+		{
+			ksGltf_ComposeGlobalTransform( &scene->state.nodeState, firstNode + blockNode + nodeIndex, scene->state.simulateIndex );
+		}
 	}
 }
 
-static void ksGltfScene_SetNodeTranslation( ksGltfScene * scene, const char * nodeName, const ksVector3f * translation )
+typedef struct
+{
+	ksGltfNodeState *			nodeState;
+	const int *					nodes;				// level nodes or NULL for consecutive nodes
+	int							firstNode;
+	int							nodeCount;
+	int							simulateIndex;
+} ksGltfTransformNodesJob;
+
+static void ksGltf_CreateLocalTransformsJob( void * jobs, const int jobIndex )
+{
+	const ksGltfTransformNodesJob * job = &( (ksGltfTransformNodesJob *) jobs )[jobIndex];
+	ksGltf_CreateLocalTransforms( job->nodeState, job->firstNode, job->nodeCount );
+}
+
+static void ksGltf_ComposeGlobalTransformsJob( void * jobs, const int jobIndex )
 {
-	ksGltfNode * node = ksGltf_GetNodeByName( scene, nodeName );
-	assert( node != NULL );
-	if ( node != NULL )
+	const ksGltfTransformNodesJob * job = &( (ksGltfTransformNodesJob *) jobs )[jobIndex];
+	for ( int nodeIndex = 0; nodeIndex < job->nodeCount; nodeIndex++ )
 	{
-		scene->state.nodeState[(int)( node - scene->nodes )].translation = *translation;
+		ksGltf_ComposeGlobalTransform( job->nodeState, job->nodes[job->firstNode + nodeIndex], job->simulateIndex );
 	}
 }
 
-static void ksGltfScene_SetNodeRotation( ksGltfScene * scene, const char * nodeName, const ksQuatf * rotation )
+// Splits the nodes into jobs of at least GLTF_SIMULATE_LEVEL_JOB_NODES nodes with a multiple of four nodes per job.
+static void ksGltf_TransformNodesParallel( ksGltfScene * scene, ksGltfJobFunction function, const int * nodes, const int firstNode, const int nodeCount )
 {
-	ksGltfNode * node = ksGltf_GetNodeByName( scene, nodeName );
-	assert( node != NULL );
-	if ( node != NULL )
+	ksThreadPool * pool = &scene->state.threadPool;
+	const int jobCount = CLAMP( nodeCount / GLTF_SIMULATE_LEVEL_JOB_NODES, 1, pool->threadCount + 1 );
+
+	ksGltfTransformNodesJob jobs[MAX_WORKERS + 1];
+	for ( int jobIndex = 0; jobIndex < jobCount; jobIndex++ )
 	{
-		scene->state.nodeState[(int)( node - scene->nodes )].rotation = *rotation;
+		const int jobFirstNode = (int)( (int64_t) nodeCount * jobIndex / jobCount ) & ~3;
+		const int jobEndNode = ( jobIndex == jobCount - 1 ) ? nodeCount : (int)( (int64_t) nodeCount * ( jobIndex + 1 ) / jobCount ) & ~3;
+		jobs[jobIndex].nodeState = &scene->state.nodeState;
+		jobs[jobIndex].nodes = nodes;
+		jobs[jobIndex].firstNode = firstNode + jobFirstNode;
+		jobs[jobIndex].nodeCount = jobEndNode - jobFirstNode;
+		jobs[jobIndex].simulateIndex = scene->state.simulateIndex;
 	}
+	ksGltf_ParallelFor( pool, function, jobs, jobCount );
 }
 
-static void ksGltfScene_SetNodeScale( ksGltfScene * scene, const char * nodeName, const ksVector3f * scale )
+// The local transforms are independent. The global transforms of the nodes of one depth level only
+// depend on the nodes of the levels above.
+static void ksGltf_TransformSubTreeLevels( ksGltfScene * scene, const ksGltfSubTree * subTree, const ksGltfSubTreeState * subTreeState )
 {
-	ksGltfNode * node = ksGltf_GetNodeByName( scene, nodeName );
-	assert( node != NULL );
-	if ( node != NULL )
+	const int firstNode = (int)( subTree->nodes[0] - scene->nodes );
+	if ( !ksGltf_IsAnyNodeDirty( &scene->state.nodeState, firstNode, subTree->nodeCount ) )
+	{
+		return;
+	}
+	ksGltf_TransformNodesParallel( scene, ksGltf_CreateLocalTransformsJob, NULL, firstNode, subTree->nodeCount );
+	for ( int level = 0; level < subTreeState->levelCount; level++ )
 	{
-		scene->state.nodeState[(int)( node - scene->nodes )].scale = *scale;
+		const int firstLevelNode = subTreeState->levelFirstNode[level];
+		const int levelNodeCount = subTreeState->levelFirstNode[level + 1] - firstLevelNode;
+		ksGltf_TransformNodesParallel( scene, ksGltf_ComposeGlobalTransformsJob, subTreeState->levelNodes, firstLevelNode, levelNodeCount );
 	}
 }
 
@@ -5004,100 +8931,67 @@ static void ksGltfScene_Simulate( ksGltfScene * scene, ksViewState * viewState,
 {
 	const ksGltfNode * cameraNode = NULL;
 
-	// Go through all current sub-trees.
+	scene->state.simulateIndex++;
+
+	// Get the current frame index and frame fraction for each time line of the current sub-trees.
 	for ( int subTreeIndex = 0; subTreeIndex < scene->state.currentSubScene->subTreeCount; subTreeIndex++ )
 	{
-		ksGltfSubTree * subTree = scene->state.currentSubScene->subTrees[subTreeIndex];
+		const ksGltfSubTree * subTree = scene->state.currentSubScene->subTrees[subTreeIndex];
 		if ( !scene->state.subTreeState[(int)( subTree - scene->subTrees )].visible )
 		{
 			continue;
 		}
-
-		// Get the current frame index and frame fraction for each time line.
 		for ( int timeLineIndex = 0; timeLineIndex < subTree->timeLineCount; timeLineIndex++ )
 		{
-			ksGltfTimeLine * timeLine = subTree->timeLines[timeLineIndex];
-			const float timeInSeconds = fmodf( time * 1e-9f, timeLine->duration );
-			int frame = 0;
-			if ( timeLine->rcpStep != 0.0f )
-			{
-				// Use direct lookup if this is a fixed rate animation.
-				frame = (int)( timeInSeconds * timeLine->rcpStep );
-			}
-			else
-			{
-				// Use a binary search to find the key frame.
-				for ( int sampleCount = timeLine->sampleCount; sampleCount > 1; sampleCount >>= 1 )
-				{
-					const int mid = sampleCount >> 1;
-					if ( timeInSeconds >= timeLine->sampleTimes[frame + mid] )
-					{
-						frame += mid;
-						sampleCount = ( sampleCount - mid ) * 2;
-					}
-				}
-			}
-			assert( timeInSeconds >= timeLine->sampleTimes[frame] && timeInSeconds < timeLine->sampleTimes[frame + 1] );
-			scene->state.timeLineFrameState[timeLineIndex].frame = frame;
-			scene->state.timeLineFrameState[timeLineIndex].fraction = ( timeInSeconds - timeLine->sampleTimes[frame] ) / ( timeLine->sampleTimes[frame + 1] - timeLine->sampleTimes[frame] );
+			ksGltf_UpdateTimeLineFrameState( scene, subTree->timeLines[timeLineIndex], time );
 		}
+	}
 
-		// Apply animations to the nodes in the hierarchy.
-		for ( int animIndex = 0; animIndex < subTree->animationCount; animIndex++ )
+	// Independent sub-trees are animated and transformed concurrently. With worker threads, large sub-trees
+	// are transformed one depth level at a time with the nodes of wide levels split into jobs.
+	int jobCount = 0;
+	for ( int subTreeIndex = 0; subTreeIndex < scene->state.currentSubScene->subTreeCount; subTreeIndex++ )
+	{
+		ksGltfSubTree * subTree = scene->state.currentSubScene->subTrees[subTreeIndex];
+		const ksGltfSubTreeState * subTreeState = &scene->state.subTreeState[(int)( subTree - scene->subTrees )];
+		if ( !subTreeState->visible )
 		{
-			const ksGltfAnimation * animation = subTree->animations[animIndex];
-
-			const int timeLineIndex = (int)( animation->timeLine - scene->timeLines );
-			const int frame = scene->state.timeLineFrameState[timeLineIndex].frame;
-			const float fraction = scene->state.timeLineFrameState[timeLineIndex].fraction;
-
-			for ( int channelIndex = 0; channelIndex < animation->channelCount; channelIndex++ )
-			{
-				const ksGltfAnimationChannel * channel = &animation->channels[channelIndex];
-				ksGltfNodeState * nodeState = &scene->state.nodeState[(int)( channel->node - scene->nodes )];
-				if ( channel->translation != NULL )
-				{
-					ksVector3f_Lerp( &nodeState->translation, &channel->translation[frame], &channel->translation[frame + 1], fraction );
-				}
-				if ( channel->rotation != NULL )
-				{
-					ksQuatf_Lerp( &nodeState->rotation, &channel->rotation[frame], &channel->rotation[frame + 1], fraction );
-				}
-				if ( channel->scale != NULL )
-				{
-					ksVector3f_Lerp( &nodeState->scale, &channel->scale[frame], &channel->scale[frame + 1], fraction );
-				}
-			}
+			continue;
 		}
-
-		// Transform the node hierarchy into global space.
-		for ( int nodeIndex = 0; nodeIndex < subTree->nodeCount; nodeIndex++ )
+		scene->state.simulateJobs[jobCount].scene = scene;
+		scene->state.simulateJobs[jobCount].subTree = subTree;
+		if ( subTreeState->levelCount > 0 && scene->state.threadPool.threadCount > 0 )
 		{
-			ksGltfNodeState * nodeState = &scene->state.nodeState[(int)( subTree->nodes[nodeIndex] - scene->nodes )];
-
-			ksMatrix4x4f_CreateTranslationRotationScale( &nodeState->localTransform, &nodeState->translation, &nodeState->rotation, &nodeState->scale );
-			if ( nodeState->parent != NULL )
-			{
-				assert( nodeState->parent < nodeState );
-				ksMatrix4x4f_Multiply( &nodeState->globalTransform, &nodeState->parent->globalTransform, &nodeState->localTransform );
-			}
-			else
-			{
-				nodeState->globalTransform = nodeState->localTransform;
-			}
+			ksGltf_AnimateSubTree( scene, subTree );
+			ksGltf_TransformSubTreeLevels( scene, subTree, subTreeState );
+		}
+		else if ( !scene->state.parallelSubTrees )
+		{
+			// Sub-trees that share nodes are simulated in order.
+			ksGltf_SimulateSubTreeJob( scene->state.simulateJobs, jobCount );
+		}
+		else
+		{
+			jobCount++;
 		}
+	}
+	ksGltf_ParallelFor( &scene->state.threadPool, ksGltf_SimulateSubTreeJob, scene->state.simulateJobs, jobCount );
 
-		// Find a camera if no camera has been found yet.
-		if ( cameraNode == NULL )
+	// Find the first camera of the current sub-trees.
+	for ( int subTreeIndex = 0; subTreeIndex < scene->state.currentSubScene->subTreeCount && cameraNode == NULL; subTreeIndex++ )
+	{
+		const ksGltfSubTree * subTree = scene->state.currentSubScene->subTrees[subTreeIndex];
+		if ( !scene->state.subTreeState[(int)( subTree - scene->subTrees )].visible )
 		{
-			for ( int nodeIndex = 0; nodeIndex < subTree->nodeCount; nodeIndex++ )
+			continue;
+		}
+		for ( int nodeIndex = 0; nodeIndex < subTree->nodeCount; nodeIndex++ )
+		{
+			ksGltfNode * node = subTree->nodes[nodeIndex];
+			if ( node->camera != NULL )
 			{
-				ksGltfNode * node = subTree->nodes[nodeIndex];
-				if ( node->camera != NULL )
-				{
-					cameraNode = node;
-					break;
-				}
+				cameraNode = node;
+				break;
 			}
 		}
 	}
@@ -5107,11 +9001,10 @@ static void ksGltfScene_Simulate( ksGltfScene * scene, ksViewState * viewState,
 	{
 		GetHmdViewMatrixForTime( &viewState->displayViewMatrix, time );
 
-		ksMatrix4x4f cameraViewMatrix;
-		ksMatrix4x4f_Invert( &cameraViewMatrix, &scene->state.nodeState[(int)( cameraNode - scene->nodes )].globalTransform );
+		const ksMatrix4x4f * cameraViewMatrix = &scene->state.nodeState.globalInverseTransform[(int)( cameraNode - scene->nodes )];
 
 		ksMatrix4x4f centerViewMatrix;
-		ksMatrix4x4f_Multiply( &centerViewMatrix, &viewState->displayViewMatrix, &cameraViewMatrix );
+		ksMatrix4x4f_Multiply( &centerViewMatrix, &viewState->displayViewMatrix, cameraViewMatrix );
 
 		for ( int eye = 0; eye < NUM_EYES; eye++ )
 		{
@@ -5169,54 +9062,71 @@ static void ksGltfScene_UpdateBuffers( ksGpuCommandBuffer * commandBuffer, ksGlt
 				continue;
 			}
 
-			const ksGltfNodeState * parentNodeState = &scene->state.nodeState[(int)( skin->parentNode - scene->nodes )];
+			const ksGltfNodeState * nodeState = &scene->state.nodeState;
+			const int parentNodeIndex = (int)( skin->parentNode - scene->nodes );
 
-			// Exclude the transform of the whole skeleton because that transform will be
-			// passed down the vertex shader as the model matrix.
-			ksMatrix4x4f inverseGlobalSkeletonTransfom;
-			ksMatrix4x4f_Invert( &inverseGlobalSkeletonTransfom, &parentNodeState->globalTransform );
+			ksGltfSkinCullingState * skinCullingState = &scene->state.skinCullingState[(int)( skin - scene->skins )];
+
+			// Only recalculate the joint transforms and the skin bounds if the global transform
+			// of the skeleton or any of the joints changed since they were last calculated.
+			bool jointsChanged = ( nodeState->globalSimulateIndex[parentNodeIndex] > skinCullingState->jointSimulateIndex );
+			for ( int jointIndex = 0; jointIndex < skin->jointCount && !jointsChanged; jointIndex++ )
+			{
+				const int jointNodeIndex = (int)( skin->joints[jointIndex].node - scene->nodes );
+				jointsChanged = ( nodeState->globalSimulateIndex[jointNodeIndex] > skinCullingState->jointSimulateIndex );
+			}
 
-			// Calculate the skin bounds.
-			if ( skin->jointGeometryMins != NULL && skin->jointGeometryMaxs != NULL )
+			if ( jointsChanged )
 			{
-				ksGltfSkinCullingState * skinCullingState = &scene->state.skinCullingState[(int)( skin - scene->skins )];
+				// Exclude the transform of the whole skeleton because that transform will be
+				// passed down the vertex shader as the model matrix.
+				const ksMatrix4x4f * inverseGlobalSkeletonTransfom = &nodeState->globalInverseTransform[parentNodeIndex];
 
 				for ( int jointIndex = 0; jointIndex < skin->jointCount; jointIndex++ )
 				{
-					const ksGltfNodeState * jointNodeState = &scene->state.nodeState[(int)( skin->joints[jointIndex].node - scene->nodes )];
-
-					ksMatrix4x4f localJointTransform;
-					ksMatrix4x4f_Multiply( &localJointTransform, &inverseGlobalSkeletonTransfom, &jointNodeState->globalTransform );
+					const int jointNodeIndex = (int)( skin->joints[jointIndex].node - scene->nodes );
+					ksMatrix4x4f_Multiply( &skinCullingState->jointTransforms[jointIndex], inverseGlobalSkeletonTransfom, &nodeState->globalTransform[jointNodeIndex] );
+				}
 
-					ksVector3f jointMins;
-					ksVector3f jointMaxs;
-					ksMatrix4x4f_TransformBounds( &jointMins, &jointMaxs, &localJointTransform, &skin->jointGeometryMins[jointIndex], &skin->jointGeometryMaxs[jointIndex] );
-					ksVector3f_Min( &skinCullingState->mins, &skin->mins, &jointMins );
-					ksVector3f_Max( &skinCullingState->maxs, &skin->maxs, &jointMaxs );
+				// Calculate the skin bounds.
+				if ( skin->jointGeometryBounds.mins[0] != NULL )
+				{
+					ksMatrix4x4f_TransformBoundsArray( &skinCullingState->jointBounds, skinCullingState->jointTransforms, &skin->jointGeometryBounds, skin->jointCount );
+					ksBounds3fArray_GetBounds( &skinCullingState->mins, &skinCullingState->maxs, &skinCullingState->jointBounds, skin->jointCount );
 				}
 
+				skinCullingState->jointSimulateIndex = scene->state.simulateIndex;
+				skinCullingState->jointBufferValid = false;
+			}
+
+			if ( skin->jointGeometryBounds.mins[0] != NULL )
+			{
 				// Do not update the joint buffer if the skin bounds are culled.
 				ksMatrix4x4f modelViewProjectionCullMatrix;
-				ksMatrix4x4f_Multiply( &modelViewProjectionCullMatrix, &viewState->combinedViewProjectionMatrix, &parentNodeState->globalTransform );
+				ksMatrix4x4f_Multiply( &modelViewProjectionCullMatrix, &viewState->combinedViewProjectionMatrix, &nodeState->globalTransform[parentNodeIndex] );
 
-				skinCullingState->culled = ksMatrix4x4f_CullBounds( &modelViewProjectionCullMatrix, &skin->mins, &skin->maxs );
+				skinCullingState->culled = ksMatrix4x4f_CullBounds( &modelViewProjectionCullMatrix, &skinCullingState->mins, &skinCullingState->maxs );
 				if ( skinCullingState->culled )
 				{
 					continue;
 				}
 			}
 
+			// The joint buffer keeps its contents until it is updated again, which means
+			// it does not need to be updated for every eye or when the joints did not change.
+			if ( skinCullingState->jointBufferValid )
+			{
+				continue;
+			}
+			skinCullingState->jointBufferValid = true;
+
 			// Update the skin joint buffer.
 			ksMatrix4x4f * joints = NULL;
 			ksGpuBuffer * mappedJointBuffer = ksGpuCommandBuffer_MapBuffer( commandBuffer, &skin->jointBuffer, (void **)&joints );
 
 			for ( int jointIndex = 0; jointIndex < skin->jointCount; jointIndex++ )
 			{
-				const ksGltfNodeState * jointNodeState = &scene->state.nodeState[(int)( skin->joints[jointIndex].node - scene->nodes )];
-
-				ksMatrix4x4f localJointTransform;
-				ksMatrix4x4f_Multiply( &localJointTransform, &inverseGlobalSkeletonTransfom, &jointNodeState->globalTransform );
-				ksMatrix4x4f_Multiply( &joints[jointIndex], &localJointTransform, &skin->inverseBindMatrices[jointIndex] );
+				ksMatrix4x4f_Multiply( &joints[jointIndex], &skinCullingState->jointTransforms[jointIndex], &skin->inverseBindMatrices[jointIndex] );
 			}
 
 			ksGpuCommandBuffer_UnmapBuffer( commandBuffer, &skin->jointBuffer, mappedJointBuffer, KS_GPU_BUFFER_UNMAP_TYPE_COPY_BACK );
@@ -5250,7 +9160,137 @@ static void ksGltfScene_SetUniformValue( ksGpuGraphicsCommand * command, const k
 	}
 }
 
-static void ksGltfScene_Render( ksGpuCommandBuffer * commandBuffer, const ksGltfScene * scene, const ksViewState * viewState )
+// The technique uniforms are set again when the state they depend on changes between draws.
+typedef enum
+{
+	GLTF_UNIFORM_UPDATE_MATERIAL	= BIT( 0 ),		// default values, node transforms and scene buffers that material values may override
+	GLTF_UNIFORM_UPDATE_NODE		= BIT( 1 ),		// transforms of the node that is drawn
+	GLTF_UNIFORM_UPDATE_SKIN		= BIT( 2 )		// joint buffer of the node that is drawn
+} ksGltfUniformUpdate;
+
+static bool ksGltf_IsDescriptorParm( const ksGpuProgramParmType type )
+{
+	return	type == KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_SAMPLED ||
+			type == KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_STORAGE ||
+			type == KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM ||
+			type == KS_GPU_PROGRAM_PARM_TYPE_BUFFER_STORAGE;
+}
+
+// Sets the uniforms of the draw technique that depend on the update flags, followed by the material values.
+// Returns true if a texture or uniform buffer changed.
+static bool ksGltf_SetDrawUniforms( ksGpuGraphicsCommand * command, ksGltfRenderStats * stats, const ksGltfScene * scene,
+									const ksGltfDraw * draw, const ksVector4f * viewport, const int updateFlags )
+{
+	const ksGltfNodeState * nodeState = &scene->state.nodeState;
+	const ksGltfMaterial * material = draw->surface->material;
+	const ksGltfTechnique * technique = material->technique;
+
+	const void * previousParms[MAX_PROGRAM_PARMS];
+	memcpy( previousParms, command->parmState.parms, sizeof( previousParms ) );
+
+	for ( int uniformIndex = 0; uniformIndex < technique->uniformCount; uniformIndex++ )
+	{
+		const ksGltfUniform * uniform = &technique->uniforms[uniformIndex];
+		if ( uniform->node != NULL )
+		{
+			if ( ( updateFlags & GLTF_UNIFORM_UPDATE_MATERIAL ) != 0 )
+			{
+				const ksMatrix4x4f * matrix = &nodeState->globalTransform[(int)( uniform->node - scene->nodes )];
+				ksGpuGraphicsCommand_SetParmFloatMatrix4x4( command, uniform->index, matrix );
+			}
+			continue;
+		}
+		if ( ( updateFlags & GLTF_UNIFORM_UPDATE_MATERIAL ) != 0 )
+		{
+			switch ( uniform->semantic )
+			{
+				case GLTF_UNIFORM_SEMANTIC_DEFAULT_VALUE:						ksGltfScene_SetUniformValue( command, uniform, &uniform->defaultValue ); break;
+				case GLTF_UNIFORM_SEMANTIC_VIEW:								assert( false ); break;	// replaced by KHR_glsl_view_projection_buffer
+				case GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE:						assert( false ); break;	// replaced by KHR_glsl_view_projection_buffer
+				case GLTF_UNIFORM_SEMANTIC_PROJECTION:							assert( false ); break;	// replaced by KHR_glsl_view_projection_buffer
+				case GLTF_UNIFORM_SEMANTIC_PROJECTION_INVERSE:					assert( false ); break;	// replaced by KHR_glsl_view_projection_buffer
+				case GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE_TRANSPOSE:				assert( false ); break;	// replaced by KHR_glsl_view_projection_buffer
+				case GLTF_UNIFORM_SEMANTIC_MODEL_VIEW:							assert( false ); break;	// replaced by KHR_glsl_view_projection_buffer
+				case GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_INVERSE:					assert( false ); break;	// replaced by KHR_glsl_view_projection_buffer
+				case GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_INVERSE_TRANSPOSE:		assert( false ); break;	// replaced by KHR_glsl_view_projection_buffer
+				case GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_PROJECTION:				assert( false ); break;	// replaced by KHR_glsl_view_projection_buffer
+				case GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_PROJECTION_INVERSE:		assert( false ); break;	// replaced by KHR_glsl_view_projection_buffer
+				case GLTF_UNIFORM_SEMANTIC_VIEWPORT:							ksGpuGraphicsCommand_SetParmFloatVector4( command, uniform->index, viewport ); break;
+				case GLTF_UNIFORM_SEMANTIC_JOINT_ARRAY:							assert( false ); break;	// replaced by KHR_glsl_joint_buffer
+				case GLTF_UNIFORM_SEMANTIC_VIEW_PROJECTION_BUFFER:				ksGpuGraphicsCommand_SetParmBufferUniform( command, uniform->index, &scene->viewProjectionBuffer ); break;
+				case GLTF_UNIFORM_SEMANTIC_VIEW_PROJECTION_MULTI_VIEW_BUFFER:	ksGpuGraphicsCommand_SetParmBufferUniform( command, uniform->index, &scene->viewProjectionBuffer ); break;
+				default: break;
+			}
+		}
+		if ( ( updateFlags & GLTF_UNIFORM_UPDATE_NODE ) != 0 )
+		{
+			switch ( uniform->semantic )
+			{
+				case GLTF_UNIFORM_SEMANTIC_LOCAL:								ksGpuGraphicsCommand_SetParmFloatMatrix4x4( command, uniform->index, &nodeState->localTransform[draw->nodeIndex] ); break;
+				case GLTF_UNIFORM_SEMANTIC_MODEL:								ksGpuGraphicsCommand_SetParmFloatMatrix4x4( command, uniform->index, &nodeState->globalTransform[draw->nodeIndex] ); break;
+				case GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE:						ksGpuGraphicsCommand_SetParmFloatMatrix4x4( command, uniform->index, &nodeState->globalInverseTransform[draw->nodeIndex] ); break;
+				default: break;
+			}
+		}
+		if ( ( updateFlags & GLTF_UNIFORM_UPDATE_SKIN ) != 0 && uniform->semantic == GLTF_UNIFORM_SEMANTIC_JOINT_BUFFER )
+		{
+			ksGpuGraphicsCommand_SetParmBufferUniform( command, uniform->index, draw->jointBuffer );
+		}
+	}
+
+	if ( ( updateFlags & GLTF_UNIFORM_UPDATE_MATERIAL ) != 0 )
+	{
+		for ( int valueIndex = 0; valueIndex < material->valueCount; valueIndex++ )
+		{
+			const ksGltfMaterialValue * value = &material->values[valueIndex];
+			if ( value->uniform != NULL )
+			{
+				ksGltfScene_SetUniformValue( command, value->uniform, &value->value );
+			}
+		}
+	}
+
+	bool descriptorsChanged = false;
+	for ( int uniformIndex = 0; uniformIndex < technique->uniformCount; uniformIndex++ )
+	{
+		const ksGltfUniform * uniform = &technique->uniforms[uniformIndex];
+		if ( command->parmState.parms[uniform->index] != previousParms[uniform->index] )
+		{
+			if ( ksGltf_IsDescriptorParm( uniform->type ) )
+			{
+				descriptorsChanged = true;
+			}
+			else
+			{
+				stats->pushConstantUpdates++;
+			}
+		}
+	}
+	return descriptorsChanged;
+}
+
+// Counting sort of the draws on the draw order of their surfaces, which keeps
+// the draws of the same surface and the blended draws in traversal order.
+static void ksGltf_SortDrawList( ksGltfDrawList * drawList )
+{
+	memset( drawList->orderOffsets, 0, ( drawList->orderCount + 1 ) * sizeof( int ) );
+	for ( int drawIndex = 0; drawIndex < drawList->drawCount; drawIndex++ )
+	{
+		drawList->orderOffsets[drawList->draws[drawIndex].surface->drawOrder + 1]++;
+	}
+	for ( int order = 1; order <= drawList->orderCount; order++ )
+	{
+		drawList->orderOffsets[order] += drawList->orderOffsets[order - 1];
+	}
+	for ( int drawIndex = 0; drawIndex < drawList->drawCount; drawIndex++ )
+	{
+		const ksGltfDraw * draw = &drawList->draws[drawIndex];
+		drawList->sortedDraws[drawList->orderOffsets[draw->surface->drawOrder]++] = *draw;
+	}
+}
+
+// Submits the sorted draws with a single graphics command that only updates the state that changed.
+static void ksGltf_SubmitDrawList( ksGpuCommandBuffer * commandBuffer, const ksGltfScene * scene, ksGltfDrawList * drawList )
 {
 	ksVector4f viewport;
 	viewport.x = 0.0f;
@@ -5258,6 +9298,56 @@ static void ksGltfScene_Render( ksGpuCommandBuffer * commandBuffer, const ksGltf
 	viewport.z = 1.0f;
 	viewport.w = 1.0f;
 
+	ksGltfRenderStats * stats = &drawList->stats;
+	memset( stats, 0, sizeof( ksGltfRenderStats ) );
+
+	ksGpuGraphicsCommand command;
+	ksGpuGraphicsCommand_Init( &command );
+
+	const ksGltfDraw * previousDraw = NULL;
+	for ( int drawIndex = 0; drawIndex < drawList->drawCount; drawIndex++ )
+	{
+		const ksGltfDraw * draw = &drawList->sortedDraws[drawIndex];
+		const ksGltfMaterial * material = draw->surface->material;
+
+		int updateFlags = 0;
+		if ( previousDraw == NULL || material->technique != previousDraw->surface->material->technique )
+		{
+			// A different technique has a different program with a different parameter layout.
+			ksGpuGraphicsCommand_Init( &command );
+			stats->programBinds++;
+			updateFlags = GLTF_UNIFORM_UPDATE_MATERIAL | GLTF_UNIFORM_UPDATE_NODE | GLTF_UNIFORM_UPDATE_SKIN;
+		}
+		else
+		{
+			updateFlags |= ( material != previousDraw->surface->material ) ? GLTF_UNIFORM_UPDATE_MATERIAL : 0;
+			updateFlags |= ( draw->nodeIndex != previousDraw->nodeIndex ) ? GLTF_UNIFORM_UPDATE_NODE : 0;
+			updateFlags |= ( draw->jointBuffer != previousDraw->jointBuffer ) ? GLTF_UNIFORM_UPDATE_SKIN : 0;
+		}
+
+		if ( command.pipeline != &draw->surface->pipeline )
+		{
+			ksGpuGraphicsCommand_SetPipeline( &command, &draw->surface->pipeline );
+			stats->pipelineBinds++;
+		}
+
+		if ( updateFlags != 0 && ksGltf_SetDrawUniforms( &command, stats, scene, draw, &viewport, updateFlags ) )
+		{
+			stats->descriptorSetChanges++;
+		}
+
+		ksGpuCommandBuffer_SubmitGraphicsCommand( commandBuffer, &command );
+		stats->drawCount++;
+
+		previousDraw = draw;
+	}
+}
+
+static void ksGltfScene_Render( ksGpuCommandBuffer * commandBuffer, ksGltfScene * scene, const ksViewState * viewState )
+{
+	ksGltfDrawList * drawList = scene->state.drawList;
+	drawList->drawCount = 0;
+
 	for ( int subTreeIndex = 0; subTreeIndex < scene->state.currentSubScene->subTreeCount; subTreeIndex++ )
 	{
 		ksGltfSubTree * subTree = scene->state.currentSubScene->subTrees[subTreeIndex];
@@ -5278,10 +9368,7 @@ static void ksGltfScene_Render( ksGpuCommandBuffer * commandBuffer, const ksGltf
 			const ksGltfNode * parentNode = ( skin != NULL ) ? skin->parentNode : node;
 			const int parentNodeIndex = (int)( parentNode - scene->nodes );
 
-			ksMatrix4x4f localMatrix = scene->state.nodeState[parentNodeIndex].localTransform;
-			ksMatrix4x4f modelMatrix = scene->state.nodeState[parentNodeIndex].globalTransform;
-			ksMatrix4x4f modelInverseMatrix;
-			ksMatrix4x4f_Invert( &modelInverseMatrix, &modelMatrix );
+			const ksMatrix4x4f * modelMatrix = &scene->state.nodeState.globalTransform[parentNodeIndex];
 
 			if ( skin != NULL )
 			{
@@ -5291,7 +9378,7 @@ static void ksGltfScene_Render( ksGpuCommandBuffer * commandBuffer, const ksGltf
 				if ( showSkinBounds )
 				{
 					ksMatrix4x4f unitCubeMatrix;
-					ksMatrix4x4f_CreateOffsetScaleForBounds( &unitCubeMatrix, &modelMatrix, &skinCullingState->mins, &skinCullingState->maxs );
+					ksMatrix4x4f_CreateOffsetScaleForBounds( &unitCubeMatrix, modelMatrix, &skinCullingState->mins, &skinCullingState->maxs );
 
 					ksGpuGraphicsCommand command;
 					ksGpuGraphicsCommand_Init( &command );
@@ -5312,79 +9399,54 @@ static void ksGltfScene_Render( ksGpuCommandBuffer * commandBuffer, const ksGltf
 			const ksGpuBuffer * jointBuffer = ( skin != NULL ) ? &skin->jointBuffer : &scene->defaultJointBuffer;
 
 			ksMatrix4x4f modelViewProjectionCullMatrix;
-			ksMatrix4x4f_Multiply( &modelViewProjectionCullMatrix, &viewState->combinedViewProjectionMatrix, &modelMatrix );
+			ksMatrix4x4f_Multiply( &modelViewProjectionCullMatrix, &viewState->combinedViewProjectionMatrix, modelMatrix );
 
+			// Models and surfaces are culled 32 at a time into a visibility bit mask.
+			uint32_t modelVisibleBits = 0xFFFFFFFF;
 			for ( int modelIndex = 0; modelIndex < node->modelCount; modelIndex++ )
 			{
 				const ksGltfModel * model = node->models[modelIndex];
 
-				if ( skin == NULL && ksMatrix4x4f_CullBounds( &modelViewProjectionCullMatrix, &model->mins, &model->maxs ) )
+				if ( skin == NULL && ( modelIndex & 31 ) == 0 )
+				{
+					const int count = ( node->modelCount - modelIndex < 32 ) ? node->modelCount - modelIndex : 32;
+					ksMatrix4x4f_CullBoundsArray( &modelVisibleBits, &modelViewProjectionCullMatrix, 1, &node->modelBounds, modelIndex, count );
+				}
+				if ( ( modelVisibleBits & ( 1u << ( modelIndex & 31 ) ) ) == 0 )
 				{
 					continue;
 				}
 
+				uint32_t surfaceVisibleBits = 0xFFFFFFFF;
 				for ( int surfaceIndex = 0; surfaceIndex < model->surfaceCount; surfaceIndex++ )
 				{
 					const ksGltfSurface * surface = &model->surfaces[surfaceIndex];
 
-					if ( skin == NULL && model->surfaceCount > 1 && ksMatrix4x4f_CullBounds( &modelViewProjectionCullMatrix, &surface->mins, &surface->maxs ) )
-					{
-						continue;
-					}
-
-					ksGpuGraphicsCommand command;
-					ksGpuGraphicsCommand_Init( &command );
-					ksGpuGraphicsCommand_SetPipeline( &command, &surface->pipeline );
-
-					const ksGltfTechnique * technique = surface->material->technique;
-					for ( int uniformIndex = 0; uniformIndex < technique->uniformCount; uniformIndex++ )
+					if ( skin == NULL && model->surfaceCount > 1 && ( surfaceIndex & 31 ) == 0 )
 					{
-						const ksGltfUniform * uniform = &technique->uniforms[uniformIndex];
-						if ( uniform->node != NULL )
-						{
-							const ksMatrix4x4f * matrix = &scene->state.nodeState[(int)( uniform->node - scene->nodes )].globalTransform;
-							ksGpuGraphicsCommand_SetParmFloatMatrix4x4( &command, uniform->index, matrix );
-						}
-						else
-						{
-							switch ( uniform->semantic )
-							{
-								case GLTF_UNIFORM_SEMANTIC_DEFAULT_VALUE:						ksGltfScene_SetUniformValue( &command, uniform, &uniform->defaultValue ); break;
-								case GLTF_UNIFORM_SEMANTIC_VIEW:								assert( false ); break;	// replaced by KHR_glsl_view_projection_buffer
-								case GLTF_UNIFORM_SEMANTIC_VIEW_INVERSE:						assert( false ); break;	// replaced by KHR_glsl_view_projection_buffer
-								case GLTF_UNIFORM_SEMANTIC_PROJECTION:							assert( false ); break;	// replaced by KHR_glsl_view_projection_buffer
-								case GLTF_UNIFORM_SEMANTIC_PROJECTION_INVERSE:					assert( false ); break;	// replaced by KHR_glsl_view_projection_buffer
-								case GLTF_UNIFORM_SEMANTIC_LOCAL:								ksGpuGraphicsCommand_SetParmFloatMatrix4x4( &command, uniform->index, &localMatrix ); break;
-								case GLTF_UNIFORM_SEMANTIC_MODEL:								ksGpuGraphicsCommand_SetParmFloatMatrix4x4( &command, uniform->index, &modelMatrix ); break;
-								case GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE:						ksGpuGraphicsCommand_SetParmFloatMatrix4x4( &command, uniform->index, &modelInverseMatrix ); break;
-								case GLTF_UNIFORM_SEMANTIC_MODEL_INVERSE_TRANSPOSE:				assert( false ); break;	// replaced by KHR_glsl_view_projection_buffer
-								case GLTF_UNIFORM_SEMANTIC_MODEL_VIEW:							assert( false ); break;	// replaced by KHR_glsl_view_projection_buffer
-								case GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_INVERSE:					assert( false ); break;	// replaced by KHR_glsl_view_projection_buffer
-								case GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_INVERSE_TRANSPOSE:		assert( false ); break;	// replaced by KHR_glsl_view_projection_buffer
-								case GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_PROJECTION:				assert( false ); break;	// replaced by KHR_glsl_view_projection_buffer
-								case GLTF_UNIFORM_SEMANTIC_MODEL_VIEW_PROJECTION_INVERSE:		assert( false ); break;	// replaced by KHR_glsl_view_projection_buffer
-								case GLTF_UNIFORM_SEMANTIC_VIEWPORT:							ksGpuGraphicsCommand_SetParmFloatVector4( &command, uniform->index, &viewport ); break;
-								case GLTF_UNIFORM_SEMANTIC_JOINT_ARRAY:							assert( false ); break;	// replaced by KHR_glsl_joint_buffer
-								case GLTF_UNIFORM_SEMANTIC_JOINT_BUFFER:						ksGpuGraphicsCommand_SetParmBufferUniform( &command, uniform->index, jointBuffer ); break;
-								case GLTF_UNIFORM_SEMANTIC_VIEW_PROJECTION_BUFFER:				ksGpuGraphicsCommand_SetParmBufferUniform( &command, uniform->index, &scene->viewProjectionBuffer ); break;
-								case GLTF_UNIFORM_SEMANTIC_VIEW_PROJECTION_MULTI_VIEW_BUFFER:	ksGpuGraphicsCommand_SetParmBufferUniform( &command, uniform->index, &scene->viewProjectionBuffer ); break;
-								default: break;
-							}
-						}
+						const int count = ( model->surfaceCount - surfaceIndex < 32 ) ? model->surfaceCount - surfaceIndex : 32;
+						ksMatrix4x4f_CullBoundsArray( &surfaceVisibleBits, &modelViewProjectionCullMatrix, 1, &model->surfaceBounds, surfaceIndex, count );
 					}
-
-					for ( int valueIndex = 0; valueIndex < surface->material->valueCount; valueIndex++ )
+					if ( ( surfaceVisibleBits & ( 1u << ( surfaceIndex & 31 ) ) ) == 0 )
 					{
-						const ksGltfMaterialValue * value = &surface->material->values[valueIndex];
-						if ( value->uniform != NULL )
-						{
-							ksGltfScene_SetUniformValue( &command, value->uniform, &value->value );
-						}
+						continue;
 					}
 
-					ksGpuCommandBuffer_SubmitGraphicsCommand( commandBuffer, &command );
+					assert( drawList->drawCount < drawList->maxDraws );
+					ksGltfDraw * draw = &drawList->draws[drawList->drawCount++];
+					draw->surface = surface;
+					draw->nodeIndex = parentNodeIndex;
+					draw->jointBuffer = jointBuffer;
 				}
 			}
 		}
 	}
+
+	ksGltf_SortDrawList( drawList );
+	ksGltf_SubmitDrawList( commandBuffer, scene, drawList );
+}
+
+static void ksGltfScene_GetRenderStats( const ksGltfScene * scene, ksGltfRenderStats * stats )
+{
+	*stats = scene->state.drawList->stats;
 }
@@ -36,6 +36,7 @@ ksSceneSettings
 
 static void ksSceneSettings_Init( ksGpuContext * context, ksSceneSettings * settings );
 static void ksSceneSettings_SetGltf( ksSceneSettings * settings, const char * fileName );
+static void ksSceneSettings_SetGltfCache( ksSceneSettings * settings, const char * fileName );
 static void ksSceneSettings_ToggleSimulationPaused( ksSceneSettings * settings );
 static void ksSceneSettings_ToggleMultiView( ksSceneSettings * settings );
 static void ksSceneSettings_SetSimulationPaused( ksSceneSettings * settings, const bool set );
@@ -105,6 +106,7 @@ static const ksGpuSampleCount eyeSampleCountTable[] =
 typedef struct
 {
 	const char *	glTF;
+	const char *	glTFCache;		// baked scene cache file or NULL
 	bool			simulationPaused;
 	bool			useMultiView;
 	int				displayResolutionLevel;
@@ -121,6 +123,7 @@ typedef struct
 static void ksSceneSettings_Init( ksGpuContext * context, ksSceneSettings * settings )
 {
 	settings->glTF = NULL;
+	settings->glTFCache = NULL;
 	settings->simulationPaused = false;
 	settings->useMultiView = false;
 	settings->displayResolutionLevel = 0;
@@ -144,6 +147,7 @@ static void ksSceneSettings_Init( ksGpuContext * context, ksSceneSettings * sett
 static void CycleLevel( int * x, const int max ) { (*x) = ( (*x) + 1 ) % max; }
 
 static void ksSceneSettings_SetGltf( ksSceneSettings * settings, const char * fileName ) { settings->glTF = fileName; }
+static void ksSceneSettings_SetGltfCache( ksSceneSettings * settings, const char * fileName ) { settings->glTFCache = fileName; }
 
 static void ksSceneSettings_ToggleSimulationPaused( ksSceneSettings * settings ) { settings->simulationPaused = !settings->simulationPaused; }
 static void ksSceneSettings_ToggleMultiView( ksSceneSettings * settings ) { settings->useMultiView = !settings->useMultiView; }
@@ -0,0 +1,524 @@
+/*
+================================================================================================
+
+Description	:	Benchmarks the simulation of glTF 2.0 scenes by scene_gltf.h.
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+
+The scenes are generated with gltf_builder.h and loaded headless with gpu_stub.h.
+
+The animation benchmark uses a chain of 64 joints with 301 key frames at 30 frames per second
+on a single fixed-rate time-line. Every joint has a rotation channel, every third joint a
+translation channel and every fifth joint a scale channel. One in four of the joints moves at a
+constant speed in between every 30 key frames, such that interpolation reproduces the omitted
+key frames, and the other joints follow smooth curves. The size of the compressed key frames is
+reported against the float key frames, together with the stored key frame count, the largest
+error of the local transforms against interpolating the float key frames, and the best time
+per ksGltfScene_Simulate call of all iterations when stepping through the animation at 90 Hz.
+The time to only sample the compressed key frames is compared to interpolating the float key
+frames of the same channels.
+
+The worker benchmark uses a hierarchy of 64 branches with 64 leaves each and a tip node below
+every leaf, which is transformed one depth level at a time when there are worker threads, next
+to 16 independent chains of 64 nodes. All branches, leaves and chain nodes are animated. The
+best time per ksGltfScene_Simulate call is reported for every worker thread count from zero
+up to one less than the number of physical cores.
+
+The load benchmark generates a tree of 100k nodes with eight children per node, once as glTF
+1.0 with nodes and children referenced by name and once as glTF 2.0 with nodes and children
+referenced by index. The best load time of at most five iterations is reported, with the time
+to resolve every node name to a handle, and the time per call to set a node rotation by name
+and by handle.
+
+	bench_gltf [iterations]
+
+================================================================================================
+*/
+
+#include "gpu_stub.h"
+#include "scenes/scene_settings.h"
+#include "scenes/scene_view_state.h"
+#include "scenes/scene_gltf.h"
+#include "gltf_builder.h"
+
+static ksGpuContext context;
+static ksGpuRenderPass renderPass;
+
+static bool LoadScene( ksGltfScene * scene, const char * fileName )
+{
+	ksSceneSettings settings;
+	ksSceneSettings_Init( &context, &settings );
+	ksSceneSettings_SetGltf( &settings, fileName );
+	memset( scene, 0, sizeof( ksGltfScene ) );
+	return ksGltfScene_CreateFromFile( &context, scene, &settings, &renderPass );
+}
+
+#define ANIMATION_JOINTS		64
+#define ANIMATION_KEY_FRAMES	301
+
+typedef struct
+{
+	ksQuatf			rotation[ANIMATION_JOINTS][ANIMATION_KEY_FRAMES];
+	ksVector3f		translation[ANIMATION_JOINTS][ANIMATION_KEY_FRAMES];
+	ksVector3f		scale[ANIMATION_JOINTS][ANIMATION_KEY_FRAMES];
+} AnimationKeyFrames;
+
+static bool HasTranslation( const int joint ) { return ( joint % 3 ) == 0; }
+static bool HasScale( const int joint ) { return ( joint % 5 ) == 0; }
+
+static void CreateAnimationKeyFrames( AnimationKeyFrames * keyFrames )
+{
+	for ( int joint = 0; joint < ANIMATION_JOINTS; joint++ )
+	{
+		const bool constantSpeed = ( joint % 4 ) == 0;
+		const float axisLength = sqrtf( sinf( (float)joint ) * sinf( (float)joint ) + cosf( (float)joint ) * cosf( (float)joint ) + 0.25f );
+		const ksVector3f axis = { sinf( (float)joint ) / axisLength, cosf( (float)joint ) / axisLength, 0.5f / axisLength };
+		for ( int key = 0; key < ANIMATION_KEY_FRAMES; key++ )
+		{
+			const float time = key / 30.0f;
+			const float angle = constantSpeed ? 0.5f * ( key / 30 ) + 0.05f * ( key % 30 ) :
+									0.8f * sinf( time * ( 1.0f + 0.1f * joint ) ) + 0.3f * sinf( 3.1f * time + joint );
+			const float s = sinf( angle * 0.5f );
+			ksQuatf * rotation = &keyFrames->rotation[joint][key];
+			rotation->x = axis.x * s;
+			rotation->y = axis.y * s;
+			rotation->z = axis.z * s;
+			rotation->w = cosf( angle * 0.5f );
+
+			ksVector3f * translation = &keyFrames->translation[joint][key];
+			translation->x = 0.0f;
+			translation->y = constantSpeed ? 0.1f + 0.002f * ( key % 60 ) : 0.1f + 0.01f * sinf( 2.0f * time );
+			translation->z = 0.0f;
+
+			ksVector3f * scale = &keyFrames->scale[joint][key];
+			scale->x = 1.0f + 0.2f * sinf( time );
+			scale->y = 1.0f;
+			scale->z = 1.0f;
+		}
+	}
+}
+
+static bool WriteAnimationScene( const AnimationKeyFrames * keyFrames, const char * fileName )
+{
+	GltfBuilder builder;
+	GltfBuilder_Create( &builder );
+
+	float times[ANIMATION_KEY_FRAMES];
+	for ( int key = 0; key < ANIMATION_KEY_FRAMES; key++ )
+	{
+		times[key] = key / 30.0f;
+	}
+	const int input = GltfBuilder_AddFloats( &builder, times, ANIMATION_KEY_FRAMES, 1 );
+
+	int parent = GltfBuilder_AddNode( &builder, "root", -1, -1, NULL );
+	for ( int joint = 0; joint < ANIMATION_JOINTS; joint++ )
+	{
+		char name[32];
+		sprintf( name, "j%d", joint );
+		const int node = GltfBuilder_AddNode( &builder, name, parent, -1, NULL );
+		GltfBuilder_AddChannel( &builder, node, "rotation", input, GltfBuilder_AddFloats( &builder, &keyFrames->rotation[joint][0].x, ANIMATION_KEY_FRAMES, 4 ), "LINEAR" );
+		if ( HasTranslation( joint ) )
+		{
+			GltfBuilder_AddChannel( &builder, node, "translation", input, GltfBuilder_AddFloats( &builder, &keyFrames->translation[joint][0].x, ANIMATION_KEY_FRAMES, 3 ), "LINEAR" );
+		}
+		if ( HasScale( joint ) )
+		{
+			GltfBuilder_AddChannel( &builder, node, "scale", input, GltfBuilder_AddFloats( &builder, &keyFrames->scale[joint][0].x, ANIMATION_KEY_FRAMES, 3 ), "LINEAR" );
+		}
+		parent = node;
+	}
+
+	const bool written = GltfBuilder_WriteBinary( &builder, fileName );
+	GltfBuilder_Destroy( &builder );
+	return written;
+}
+
+static bool BenchAnimation( const int iterations )
+{
+	const char * fileName = "bench_gltf_animation.glb";
+	AnimationKeyFrames * keyFrames = (AnimationKeyFrames *) malloc( sizeof( AnimationKeyFrames ) );
+	CreateAnimationKeyFrames( keyFrames );
+	ksGltfScene scene;
+	if ( !WriteAnimationScene( keyFrames, fileName ) || !LoadScene( &scene, fileName ) )
+	{
+		printf( "failed to load %s\n", fileName );
+		free( keyFrames );
+		return false;
+	}
+	remove( fileName );
+
+	size_t floatSize = 0;
+	size_t compressedSize = 0;
+	int keyFrameCount = 0;
+	int storedKeyFrameCount = 0;
+	int channelCount = 0;
+	for ( int animationIndex = 0; animationIndex < scene.animationCount; animationIndex++ )
+	{
+		const ksGltfAnimation * animation = &scene.animations[animationIndex];
+		for ( int channelIndex = 0; channelIndex < animation->channelCount; channelIndex++ )
+		{
+			const ksGltfCompressedKeyFrames * compressed = &animation->channels[channelIndex].keyFrames;
+			floatSize += animation->timeLine->sampleCount * ( ( ( compressed->translation != NULL ) ? sizeof( ksVector3f ) : 0 ) +
+																( ( compressed->rotation != NULL ) ? sizeof( ksQuatf ) : 0 ) +
+																( ( compressed->scale != NULL ) ? sizeof( ksVector3f ) : 0 ) );
+			compressedSize += compressed->dataSize;
+			keyFrameCount += animation->timeLine->sampleCount;
+			storedKeyFrameCount += compressed->keyCount;
+			channelCount++;
+		}
+	}
+	printf( "animation: %d channels, %d time-lines, key frames %1.1f kB -> %1.1f kB, stored %d of %d key frames\n",
+			channelCount, scene.timeLineCount, floatSize / 1024.0, compressedSize / 1024.0, storedKeyFrameCount, keyFrameCount );
+
+	int jointNodes[ANIMATION_JOINTS];
+	for ( int joint = 0; joint < ANIMATION_JOINTS; joint++ )
+	{
+		char name[32];
+		sprintf( name, "j%d", joint );
+		jointNodes[joint] = ksGltfScene_GetNodeHandle( &scene, name );
+	}
+
+	// Compare the local transforms against interpolating the float key frames at the same time-line frame and fraction.
+	const int frameCount = 1000;
+	const ksTransformArray * transforms = &scene.state.nodeState.transforms;
+	ksViewState viewState;
+	memset( &viewState, 0, sizeof( viewState ) );
+	float maxTranslationError = 0.0f;
+	float maxRotationError = 0.0f;
+	float maxScaleError = 0.0f;
+	for ( int frame = 0; frame < frameCount; frame++ )
+	{
+		ksGltfScene_Simulate( &scene, &viewState, NULL, (ksNanoseconds)( frame * 1e9 / 90.0 ) );
+		const int key = scene.state.timeLineFrameState[0].frame;
+		const float fraction = scene.state.timeLineFrameState[0].fraction;
+		for ( int joint = 0; joint < ANIMATION_JOINTS; joint++ )
+		{
+			const int node = jointNodes[joint];
+			ksQuatf r;
+			ksQuatf_FastSlerp( &r, &keyFrames->rotation[joint][key], &keyFrames->rotation[joint][key + 1], fraction );
+			const ksQuatf sampledRotation = { transforms->rotation[0][node], transforms->rotation[1][node], transforms->rotation[2][node], transforms->rotation[3][node] };
+			maxRotationError = MAX( maxRotationError, ksGltf_GetRotationError( &r, &sampledRotation ) );
+			if ( HasTranslation( joint ) )
+			{
+				ksVector3f t;
+				ksVector3f_Lerp( &t, &keyFrames->translation[joint][key], &keyFrames->translation[joint][key + 1], fraction );
+				const ksVector3f sampledTranslation = { transforms->translation[0][node], transforms->translation[1][node], transforms->translation[2][node] };
+				maxTranslationError = MAX( maxTranslationError, ksGltf_GetVector3Error( &t, &sampledTranslation ) );
+			}
+			if ( HasScale( joint ) )
+			{
+				ksVector3f s;
+				ksVector3f_Lerp( &s, &keyFrames->scale[joint][key], &keyFrames->scale[joint][key + 1], fraction );
+				const ksVector3f sampledScale = { transforms->scale[0][node], transforms->scale[1][node], transforms->scale[2][node] };
+				maxScaleError = MAX( maxScaleError, ksGltf_GetVector3Error( &s, &sampledScale ) );
+			}
+		}
+	}
+	printf( "animation: max error over %d frames: translation %1.5f, rotation %1.4f degrees, scale %1.5f\n",
+			frameCount, maxTranslationError, maxRotationError * ( 180.0f / MATH_PI ), maxScaleError );
+
+	// The compressed key frames are sampled by animating the sub-tree, and the float key frames are
+	// sampled by interpolating them for every joint, both without transforming the nodes.
+	const ksGltfSubTree * subTree = scene.state.currentSubScene->subTrees[0];
+	ksNanoseconds simulateTime = 0;
+	ksNanoseconds sampleTimes[2] = { 0, 0 };
+	for ( int iteration = 0; iteration < iterations; iteration++ )
+	{
+		const ksNanoseconds t0 = GetTimeNanoseconds();
+		for ( int frame = 0; frame < frameCount; frame++ )
+		{
+			ksGltfScene_Simulate( &scene, &viewState, NULL, (ksNanoseconds)( frame * 1e9 / 90.0 ) );
+		}
+		const ksNanoseconds t1 = GetTimeNanoseconds();
+		for ( int frame = 0; frame < frameCount; frame++ )
+		{
+			ksGltf_UpdateTimeLineFrameState( &scene, &scene.timeLines[0], (ksNanoseconds)( frame * 1e9 / 90.0 ) );
+			ksGltf_AnimateSubTree( &scene, subTree );
+		}
+		const ksNanoseconds t2 = GetTimeNanoseconds();
+		for ( int frame = 0; frame < frameCount; frame++ )
+		{
+			ksGltf_UpdateTimeLineFrameState( &scene, &scene.timeLines[0], (ksNanoseconds)( frame * 1e9 / 90.0 ) );
+			const int key = scene.state.timeLineFrameState[0].frame;
+			const float fraction = scene.state.timeLineFrameState[0].fraction;
+			for ( int joint = 0; joint < ANIMATION_JOINTS; joint++ )
+			{
+				ksVector3f t;
+				ksQuatf r;
+				ksVector3f s;
+				ksVector3f_Lerp( &t, &keyFrames->translation[joint][key], &keyFrames->translation[joint][key + 1], fraction );
+				ksQuatf_FastSlerp( &r, &keyFrames->rotation[joint][key], &keyFrames->rotation[joint][key + 1], fraction );
+				ksVector3f_Lerp( &s, &keyFrames->scale[joint][key], &keyFrames->scale[joint][key + 1], fraction );
+				ksGltf_SetNodeTransform( &scene.state.nodeState, jointNodes[joint], HasTranslation( joint ) ? &t : NULL, &r, HasScale( joint ) ? &s : NULL );
+			}
+		}
+		const ksNanoseconds t3 = GetTimeNanoseconds();
+		simulateTime = ( iteration == 0 || t1 - t0 < simulateTime ) ? t1 - t0 : simulateTime;
+		sampleTimes[0] = ( iteration == 0 || t2 - t1 < sampleTimes[0] ) ? t2 - t1 : sampleTimes[0];
+		sampleTimes[1] = ( iteration == 0 || t3 - t2 < sampleTimes[1] ) ? t3 - t2 : sampleTimes[1];
+	}
+	printf( "animation: simulate %1.2f us per call, sample compressed key frames %1.2f us, sample float key frames %1.2f us\n",
+			simulateTime * 1e-3 / frameCount, sampleTimes[0] * 1e-3 / frameCount, sampleTimes[1] * 1e-3 / frameCount );
+
+	ksGltfScene_Destroy( &context, &scene );
+	free( keyFrames );
+
+	// The omitted key frames are reproduced within the tolerance, the stored key frames within the quantization.
+	return maxTranslationError <= 2.0f * GLTF_ANIMATION_TRANSLATION_TOLERANCE &&
+			maxRotationError <= 2.0f * GLTF_ANIMATION_ROTATION_TOLERANCE &&
+			maxScaleError <= 2.0f * GLTF_ANIMATION_SCALE_TOLERANCE;
+}
+
+#define WORKERS_BRANCHES		64
+#define WORKERS_LEAVES			64
+#define WORKERS_CHAINS			16
+#define WORKERS_CHAIN_NODES		64
+#define WORKERS_KEY_FRAMES		31
+
+static bool WriteWorkersScene( const char * fileName )
+{
+	GltfBuilder builder;
+	GltfBuilder_Create( &builder );
+
+	float times[WORKERS_KEY_FRAMES];
+	float rotations[4][WORKERS_KEY_FRAMES][4];
+	for ( int key = 0; key < WORKERS_KEY_FRAMES; key++ )
+	{
+		times[key] = key / 30.0f;
+		for ( int i = 0; i < 4; i++ )
+		{
+			const float angle = sinf( key * 0.2f + i ) * 0.5f;
+			rotations[i][key][0] = 0.0f;
+			rotations[i][key][1] = ( i & 1 ) ? sinf( angle * 0.5f ) : 0.0f;
+			rotations[i][key][2] = ( i & 1 ) ? 0.0f : sinf( angle * 0.5f );
+			rotations[i][key][3] = cosf( angle * 0.5f );
+		}
+	}
+	const int input = GltfBuilder_AddFloats( &builder, times, WORKERS_KEY_FRAMES, 1 );
+	int outputs[4];
+	for ( int i = 0; i < 4; i++ )
+	{
+		outputs[i] = GltfBuilder_AddFloats( &builder, &rotations[i][0][0], WORKERS_KEY_FRAMES, 4 );
+	}
+
+	const float offset[3] = { 0.0f, 0.5f, 0.0f };
+	const int root = GltfBuilder_AddNode( &builder, "root", -1, -1, NULL );
+	for ( int branch = 0; branch < WORKERS_BRANCHES; branch++ )
+	{
+		const int branchNode = GltfBuilder_AddNode( &builder, "branch", root, -1, offset );
+		GltfBuilder_AddChannel( &builder, branchNode, "rotation", input, outputs[branch % 4], "LINEAR" );
+		for ( int leaf = 0; leaf < WORKERS_LEAVES; leaf++ )
+		{
+			const int leafNode = GltfBuilder_AddNode( &builder, "leaf", branchNode, -1, offset );
+			GltfBuilder_AddChannel( &builder, leafNode, "rotation", input, outputs[leaf % 4], "LINEAR" );
+			GltfBuilder_AddNode( &builder, "tip", leafNode, -1, offset );
+		}
+	}
+	for ( int chain = 0; chain < WORKERS_CHAINS; chain++ )
+	{
+		int parent = -1;
+		for ( int i = 0; i < WORKERS_CHAIN_NODES; i++ )
+		{
+			parent = GltfBuilder_AddNode( &builder, "chain", parent, -1, offset );
+			GltfBuilder_AddChannel( &builder, parent, "rotation", input, outputs[( chain + i ) % 4], "LINEAR" );
+		}
+	}
+
+	const bool written = GltfBuilder_WriteBinary( &builder, fileName );
+	GltfBuilder_Destroy( &builder );
+	return written;
+}
+
+static bool BenchWorkers( const int iterations )
+{
+	const char * fileName = "bench_gltf_workers.glb";
+	ksGltfScene scene;
+	if ( !WriteWorkersScene( fileName ) || !LoadScene( &scene, fileName ) )
+	{
+		printf( "failed to load %s\n", fileName );
+		return false;
+	}
+	remove( fileName );
+
+	const ksCpuTopology * topology = ksCpuTopology_Get();
+	const int maxWorkers = MIN( ( topology->physicalCoreCount > 0 ) ? topology->physicalCoreCount - 1 : 3, MAX_WORKERS );
+	printf( "workers: %d nodes in %d sub-trees, %d levels in the largest sub-tree\n",
+			scene.nodeCount, scene.subTreeCount, scene.state.subTreeState[0].levelCount );
+
+	const int frameCount = 100;
+	ksViewState viewState;
+	memset( &viewState, 0, sizeof( viewState ) );
+	ksNanoseconds serialTime = 0;
+	for ( int workerCount = 0; workerCount <= maxWorkers; workerCount++ )
+	{
+		ksThreadPool_Destroy( &scene.state.threadPool );
+		ksThreadPool_Create( &scene.state.threadPool, workerCount );
+
+		ksNanoseconds simulateTime = 0;
+		for ( int iteration = 0; iteration < iterations; iteration++ )
+		{
+			const ksNanoseconds t0 = GetTimeNanoseconds();
+			for ( int frame = 0; frame < frameCount; frame++ )
+			{
+				ksGltfScene_Simulate( &scene, &viewState, NULL, (ksNanoseconds)( frame * 1e9 / 90.0 ) );
+			}
+			const ksNanoseconds t1 = GetTimeNanoseconds();
+			simulateTime = ( iteration == 0 || t1 - t0 < simulateTime ) ? t1 - t0 : simulateTime;
+		}
+		serialTime = ( workerCount == 0 ) ? simulateTime : serialTime;
+		printf( "workers: %d worker threads: simulate %1.1f us per call, %1.2fx\n",
+				workerCount, simulateTime * 1e-3 / frameCount, (double) serialTime / MAX( simulateTime, 1 ) );
+	}
+
+	ksGltfScene_Destroy( &context, &scene );
+	return true;
+}
+
+#define LOAD_NODES			100000
+#define LOAD_NODE_CHILDREN	8
+#define LOAD_MAX_ITERATIONS	5
+
+// Writes a tree of nodes where the children of node i are nodes i * LOAD_NODE_CHILDREN + 1 and up.
+static bool WriteLoadScene( const char * fileName, const bool version2 )
+{
+	ksJson * rootNode = ksJson_SetObject( ksJson_Create() );
+	ksJson_SetString( ksJson_AddObjectMember( ksJson_SetObject( ksJson_AddObjectMember( rootNode, "asset" ) ), "version" ), version2 ? "2.0" : "1.0" );
+
+	char name[32];
+	ksJson * nodes = version2 ? ksJson_SetArray( ksJson_AddObjectMember( rootNode, "nodes" ) ) : ksJson_SetObject( ksJson_AddObjectMember( rootNode, "nodes" ) );
+	for ( int nodeIndex = 0; nodeIndex < LOAD_NODES; nodeIndex++ )
+	{
+		sprintf( name, "node%d", nodeIndex );
+		ksJson * node = ksJson_SetObject( version2 ? ksJson_AddArrayElement( nodes ) : ksJson_AddObjectMember( nodes, name ) );
+		ksJson_SetString( ksJson_AddObjectMember( node, "name" ), name );
+		const int firstChild = nodeIndex * LOAD_NODE_CHILDREN + 1;
+		if ( firstChild < LOAD_NODES )
+		{
+			ksJson * children = ksJson_SetArray( ksJson_AddObjectMember( node, "children" ) );
+			for ( int child = firstChild; child < firstChild + LOAD_NODE_CHILDREN && child < LOAD_NODES; child++ )
+			{
+				if ( version2 )
+				{
+					ksJson_SetInt32( ksJson_AddArrayElement( children ), child );
+				}
+				else
+				{
+					sprintf( name, "node%d", child );
+					ksJson_SetString( ksJson_AddArrayElement( children ), name );
+				}
+			}
+		}
+	}
+
+	ksJson * scenes = version2 ? ksJson_SetArray( ksJson_AddObjectMember( rootNode, "scenes" ) ) : ksJson_SetObject( ksJson_AddObjectMember( rootNode, "scenes" ) );
+	ksJson * scene = ksJson_SetObject( version2 ? ksJson_AddArrayElement( scenes ) : ksJson_AddObjectMember( scenes, "scene" ) );
+	ksJson * sceneNodes = ksJson_SetArray( ksJson_AddObjectMember( scene, "nodes" ) );
+	if ( version2 )
+	{
+		ksJson_SetInt32( ksJson_AddObjectMember( rootNode, "scene" ), 0 );
+		ksJson_SetInt32( ksJson_AddArrayElement( sceneNodes ), 0 );
+	}
+	else
+	{
+		ksJson_SetString( ksJson_AddObjectMember( rootNode, "scene" ), "scene" );
+		ksJson_SetString( ksJson_AddArrayElement( sceneNodes ), "node0" );
+	}
+
+	const bool written = ksJson_WriteToFile( rootNode, fileName );
+	ksJson_Destroy( rootNode );
+	return written;
+}
+
+static bool BenchLoad( const int iterations )
+{
+	bool passed = true;
+	for ( int version = 1; version <= 2; version++ )
+	{
+		const char * fileName = "bench_gltf_load.gltf";
+		if ( !WriteLoadScene( fileName, version == 2 ) )
+		{
+			printf( "failed to write %s\n", fileName );
+			return false;
+		}
+
+		ksGltfScene scene;
+		const int loadIterations = CLAMP( iterations, 1, LOAD_MAX_ITERATIONS );
+		ksNanoseconds loadTime = 0;
+		for ( int iteration = 0; iteration < loadIterations; iteration++ )
+		{
+			const ksNanoseconds t0 = GetTimeNanoseconds();
+			const bool loaded = LoadScene( &scene, fileName );
+			const ksNanoseconds t1 = GetTimeNanoseconds();
+			if ( !loaded )
+			{
+				printf( "failed to load %s\n", fileName );
+				remove( fileName );
+				return false;
+			}
+			loadTime = ( iteration == 0 || t1 - t0 < loadTime ) ? t1 - t0 : loadTime;
+			if ( iteration < loadIterations - 1 )
+			{
+				ksGltfScene_Destroy( &context, &scene );
+			}
+		}
+		remove( fileName );
+
+		// Resolve every node name to a handle.
+		char ( * names )[16] = (char (*)[16]) malloc( LOAD_NODES * sizeof( names[0] ) );
+		for ( int nodeIndex = 0; nodeIndex < LOAD_NODES; nodeIndex++ )
+		{
+			sprintf( names[nodeIndex], "node%d", nodeIndex );
+		}
+		int * handles = (int *) malloc( LOAD_NODES * sizeof( int ) );
+		const ksNanoseconds t0 = GetTimeNanoseconds();
+		for ( int nodeIndex = 0; nodeIndex < LOAD_NODES; nodeIndex++ )
+		{
+			handles[nodeIndex] = ksGltfScene_GetNodeHandle( &scene, names[nodeIndex] );
+		}
+		const ksNanoseconds t1 = GetTimeNanoseconds();
+		bool resolved = ( scene.nodeCount == LOAD_NODES );
+		for ( int nodeIndex = 0; nodeIndex < LOAD_NODES && resolved; nodeIndex++ )
+		{
+			resolved = ( handles[nodeIndex] >= 0 && strcmp( scene.nodes[handles[nodeIndex]].name, names[nodeIndex] ) == 0 );
+		}
+
+		// Set the rotation of every node by name and by handle.
+		const ksQuatf rotation = { 0.0f, 0.0f, 0.0f, 1.0f };
+		const ksNanoseconds t2 = GetTimeNanoseconds();
+		for ( int nodeIndex = 0; nodeIndex < LOAD_NODES; nodeIndex++ )
+		{
+			ksGltfScene_SetNodeRotation( &scene, names[nodeIndex], &rotation );
+		}
+		const ksNanoseconds t3 = GetTimeNanoseconds();
+		for ( int nodeIndex = 0; nodeIndex < LOAD_NODES; nodeIndex++ )
+		{
+			ksGltfScene_SetNodeRotationByHandle( &scene, handles[nodeIndex], &rotation );
+		}
+		const ksNanoseconds t4 = GetTimeNanoseconds();
+
+		printf( "load: glTF %d.0 with %d nodes: load %1.3f seconds, resolve all names %1.2f ms, set rotation by name %1.1f ns, by handle %1.1f ns\n",
+				version, scene.nodeCount, loadTime * 1e-9, ( t1 - t0 ) * 1e-6, (double)( t3 - t2 ) / LOAD_NODES, (double)( t4 - t3 ) / LOAD_NODES );
+		if ( !resolved )
+		{
+			printf( "load: glTF %d.0 node handles do not match the node names\n", version );
+		}
+		passed &= resolved;
+
+		free( handles );
+		free( names );
+		ksGltfScene_Destroy( &context, &scene );
+	}
+	return passed;
+}
+
+int main( int argc, char * argv[] )
+{
+	const int iterations = ( argc > 1 ) ? atoi( argv[1] ) : 100;
+
+	bool passed = true;
+	passed &= BenchAnimation( iterations );
+	passed &= BenchWorkers( iterations );
+	passed &= BenchLoad( iterations );
+
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
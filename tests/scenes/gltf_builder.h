@@ -0,0 +1,324 @@
+/*
+================================================================================================
+
+Description	:	Builds small glTF 2.0 assets for the scene tests.
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+
+The assets are generated in code so the tests do not depend on files that are not part of the
+repository. All binary data is stored in a single buffer that is either written next to the
+JSON as a separate file or embedded in a binary glTF container.
+
+================================================================================================
+*/
+
+#if !defined( GLTF_BUILDER_H )
+#define GLTF_BUILDER_H
+
+#include <utils/json.h>
+
+#define GLTF_BUILDER_BYTE				0x1400
+#define GLTF_BUILDER_UNSIGNED_BYTE		0x1401
+#define GLTF_BUILDER_UNSIGNED_SHORT		0x1403
+#define GLTF_BUILDER_UNSIGNED_INT		0x1405
+#define GLTF_BUILDER_FLOAT				0x1406
+
+typedef struct
+{
+	ksJson *			rootNode;
+	ksJson *			bufferViews;
+	ksJson *			accessors;
+	ksJson *			meshes;
+	ksJson *			nodes;
+	ksJson *			sceneNodes;
+	ksJson *			samplers;
+	ksJson *			channels;
+	unsigned char *		data;
+	size_t				dataSize;
+} GltfBuilder;
+
+static void GltfBuilder_Create( GltfBuilder * builder )
+{
+	memset( builder, 0, sizeof( GltfBuilder ) );
+	builder->rootNode = ksJson_SetObject( ksJson_Create() );
+	ksJson_SetString( ksJson_AddObjectMember( ksJson_SetObject( ksJson_AddObjectMember( builder->rootNode, "asset" ) ), "version" ), "2.0" );
+	ksJson_SetInt32( ksJson_AddObjectMember( builder->rootNode, "scene" ), 0 );
+	ksJson * scene = ksJson_SetObject( ksJson_AddArrayElement( ksJson_SetArray( ksJson_AddObjectMember( builder->rootNode, "scenes" ) ) ) );
+	ksJson_SetString( ksJson_AddObjectMember( scene, "name" ), "scene" );
+	builder->sceneNodes = ksJson_SetArray( ksJson_AddObjectMember( scene, "nodes" ) );
+	builder->nodes = ksJson_SetArray( ksJson_AddObjectMember( builder->rootNode, "nodes" ) );
+	builder->meshes = ksJson_SetArray( ksJson_AddObjectMember( builder->rootNode, "meshes" ) );
+	builder->accessors = ksJson_SetArray( ksJson_AddObjectMember( builder->rootNode, "accessors" ) );
+	builder->bufferViews = ksJson_SetArray( ksJson_AddObjectMember( builder->rootNode, "bufferViews" ) );
+	ksJson * material = ksJson_SetObject( ksJson_AddArrayElement( ksJson_SetArray( ksJson_AddObjectMember( builder->rootNode, "materials" ) ) ) );
+	ksJson_SetString( ksJson_AddObjectMember( material, "name" ), "material" );
+	ksJson_SetObject( ksJson_AddObjectMember( material, "pbrMetallicRoughness" ) );
+}
+
+static void GltfBuilder_Destroy( GltfBuilder * builder )
+{
+	ksJson_Destroy( builder->rootNode );
+	free( builder->data );
+	memset( builder, 0, sizeof( GltfBuilder ) );
+}
+
+// Appends 4-byte aligned data to the buffer and returns the index of a new buffer view.
+static int GltfBuilder_AddBufferView( GltfBuilder * builder, const void * data, const size_t size, const int byteStride )
+{
+	const size_t offset = ( builder->dataSize + 3 ) & ~(size_t)3;
+	builder->data = (unsigned char *) realloc( builder->data, offset + size );
+	memset( builder->data + builder->dataSize, 0, offset - builder->dataSize );
+	memcpy( builder->data + offset, data, size );
+	builder->dataSize = offset + size;
+
+	ksJson * view = ksJson_SetObject( ksJson_AddArrayElement( builder->bufferViews ) );
+	ksJson_SetInt32( ksJson_AddObjectMember( view, "buffer" ), 0 );
+	ksJson_SetUint64( ksJson_AddObjectMember( view, "byteOffset" ), offset );
+	ksJson_SetUint64( ksJson_AddObjectMember( view, "byteLength" ), size );
+	if ( byteStride != 0 )
+	{
+		ksJson_SetInt32( ksJson_AddObjectMember( view, "byteStride" ), byteStride );
+	}
+	return ksJson_GetMemberCount( builder->bufferViews ) - 1;
+}
+
+static const char * GltfBuilder_GetType( const int componentCount )
+{
+	static const char * types[] = { "SCALAR", "VEC2", "VEC3", "VEC4" };
+	return ( componentCount == 16 ) ? "MAT4" : types[componentCount - 1];
+}
+
+// Returns the accessor so optional members like "normalized" and "sparse" can be added.
+static ksJson * GltfBuilder_AddAccessor( GltfBuilder * builder, const int bufferView, const size_t byteOffset,
+										const int componentType, const int count, const int componentCount )
+{
+	ksJson * accessor = ksJson_SetObject( ksJson_AddArrayElement( builder->accessors ) );
+	if ( bufferView >= 0 )
+	{
+		ksJson_SetInt32( ksJson_AddObjectMember( accessor, "bufferView" ), bufferView );
+		ksJson_SetUint64( ksJson_AddObjectMember( accessor, "byteOffset" ), byteOffset );
+	}
+	ksJson_SetInt32( ksJson_AddObjectMember( accessor, "componentType" ), componentType );
+	ksJson_SetInt32( ksJson_AddObjectMember( accessor, "count" ), count );
+	ksJson_SetString( ksJson_AddObjectMember( accessor, "type" ), GltfBuilder_GetType( componentCount ) );
+	return accessor;
+}
+
+static void GltfBuilder_SetAccessorBounds( ksJson * accessor, const float * mins, const float * maxs, const int componentCount )
+{
+	ksJson * min = ksJson_SetArray( ksJson_AddObjectMember( accessor, "min" ) );
+	ksJson * max = ksJson_SetArray( ksJson_AddObjectMember( accessor, "max" ) );
+	for ( int c = 0; c < componentCount; c++ )
+	{
+		ksJson_SetFloat( ksJson_AddArrayElement( min ), mins[c] );
+		ksJson_SetFloat( ksJson_AddArrayElement( max ), maxs[c] );
+	}
+}
+
+// Adds tightly packed floats with the bounds that are required for positions and animation inputs.
+static int GltfBuilder_AddFloats( GltfBuilder * builder, const float * data, const int count, const int componentCount )
+{
+	const int bufferView = GltfBuilder_AddBufferView( builder, data, count * componentCount * sizeof( float ), 0 );
+	ksJson * accessor = GltfBuilder_AddAccessor( builder, bufferView, 0, GLTF_BUILDER_FLOAT, count, componentCount );
+	float mins[16];
+	float maxs[16];
+	for ( int c = 0; c < componentCount; c++ )
+	{
+		mins[c] = maxs[c] = data[c];
+		for ( int i = 1; i < count; i++ )
+		{
+			mins[c] = ( data[i * componentCount + c] < mins[c] ) ? data[i * componentCount + c] : mins[c];
+			maxs[c] = ( data[i * componentCount + c] > maxs[c] ) ? data[i * componentCount + c] : maxs[c];
+		}
+	}
+	GltfBuilder_SetAccessorBounds( accessor, mins, maxs, componentCount );
+	return ksJson_GetMemberCount( builder->accessors ) - 1;
+}
+
+// Adds indices stored with the given component type.
+static int GltfBuilder_AddIndices( GltfBuilder * builder, const uint32_t * indices, const int count, const int componentType )
+{
+	const int size = ( componentType == GLTF_BUILDER_UNSIGNED_BYTE ) ? 1 : ( ( componentType == GLTF_BUILDER_UNSIGNED_SHORT ) ? 2 : 4 );
+	unsigned char * data = (unsigned char *) malloc( count * size );
+	for ( int i = 0; i < count; i++ )
+	{
+		if ( size == 1 ) data[i] = (uint8_t) indices[i];
+		if ( size == 2 ) ( (uint16_t *) data )[i] = (uint16_t) indices[i];
+		if ( size == 4 ) ( (uint32_t *) data )[i] = indices[i];
+	}
+	const int bufferView = GltfBuilder_AddBufferView( builder, data, count * size, 0 );
+	free( data );
+	GltfBuilder_AddAccessor( builder, bufferView, 0, componentType, count, 1 );
+	return ksJson_GetMemberCount( builder->accessors ) - 1;
+}
+
+// Adds a mesh with a single primitive. Attributes and indices that are -1 are not stored.
+static int GltfBuilder_AddMesh( GltfBuilder * builder, const char * name, const int mode, const int position, const int normal,
+								const int uv0, const int joints, const int weights, const int indices )
+{
+	ksJson * mesh = ksJson_SetObject( ksJson_AddArrayElement( builder->meshes ) );
+	ksJson_SetString( ksJson_AddObjectMember( mesh, "name" ), name );
+	ksJson * primitive = ksJson_SetObject( ksJson_AddArrayElement( ksJson_SetArray( ksJson_AddObjectMember( mesh, "primitives" ) ) ) );
+	ksJson * attributes = ksJson_SetObject( ksJson_AddObjectMember( primitive, "attributes" ) );
+	const char * names[] = { "POSITION", "NORMAL", "TEXCOORD_0", "JOINTS_0", "WEIGHTS_0" };
+	const int values[] = { position, normal, uv0, joints, weights };
+	for ( int i = 0; i < (int)ARRAY_SIZE( names ); i++ )
+	{
+		if ( values[i] >= 0 )
+		{
+			ksJson_SetInt32( ksJson_AddObjectMember( attributes, names[i] ), values[i] );
+		}
+	}
+	if ( indices >= 0 )
+	{
+		ksJson_SetInt32( ksJson_AddObjectMember( primitive, "indices" ), indices );
+	}
+	ksJson_SetInt32( ksJson_AddObjectMember( primitive, "mode" ), mode );
+	ksJson_SetInt32( ksJson_AddObjectMember( primitive, "material" ), 0 );
+	return ksJson_GetMemberCount( builder->meshes ) - 1;
+}
+
+// Adds a node as a child of the parent node, or as a root node of the scene if the parent is -1.
+static int GltfBuilder_AddNode( GltfBuilder * builder, const char * name, const int parent, const int mesh, const float translation[3] )
+{
+	const int nodeIndex = ksJson_GetMemberCount( builder->nodes );
+	ksJson * node = ksJson_SetObject( ksJson_AddArrayElement( builder->nodes ) );
+	ksJson_SetString( ksJson_AddObjectMember( node, "name" ), name );
+	if ( mesh >= 0 )
+	{
+		ksJson_SetInt32( ksJson_AddObjectMember( node, "mesh" ), mesh );
+	}
+	if ( translation != NULL )
+	{
+		ksJson * array = ksJson_SetArray( ksJson_AddObjectMember( node, "translation" ) );
+		for ( int c = 0; c < 3; c++ )
+		{
+			ksJson_SetFloat( ksJson_AddArrayElement( array ), translation[c] );
+		}
+	}
+	if ( parent >= 0 )
+	{
+		ksJson * parentNode = ksJson_GetMemberByIndex( builder->nodes, parent );
+		ksJson * children = ksJson_GetMemberByName( parentNode, "children" );
+		if ( children == NULL )
+		{
+			children = ksJson_SetArray( ksJson_AddObjectMember( parentNode, "children" ) );
+		}
+		ksJson_SetInt32( ksJson_AddArrayElement( children ), nodeIndex );
+	}
+	else
+	{
+		ksJson_SetInt32( ksJson_AddArrayElement( builder->sceneNodes ), nodeIndex );
+	}
+	return nodeIndex;
+}
+
+// Adds a skin with the given joint nodes and inverse bind matrices, and binds it to the skinned node.
+static int GltfBuilder_AddSkin( GltfBuilder * builder, const char * name, const int node, const int * joints, const int jointCount, const int inverseBindMatrices )
+{
+	ksJson * skins = ksJson_GetMemberByName( builder->rootNode, "skins" );
+	if ( skins == NULL )
+	{
+		skins = ksJson_SetArray( ksJson_AddObjectMember( builder->rootNode, "skins" ) );
+	}
+	const int skinIndex = ksJson_GetMemberCount( skins );
+	ksJson * skin = ksJson_SetObject( ksJson_AddArrayElement( skins ) );
+	ksJson_SetString( ksJson_AddObjectMember( skin, "name" ), name );
+	ksJson * array = ksJson_SetArray( ksJson_AddObjectMember( skin, "joints" ) );
+	for ( int i = 0; i < jointCount; i++ )
+	{
+		ksJson_SetInt32( ksJson_AddArrayElement( array ), joints[i] );
+	}
+	ksJson_SetInt32( ksJson_AddObjectMember( skin, "inverseBindMatrices" ), inverseBindMatrices );
+	ksJson_SetInt32( ksJson_AddObjectMember( ksJson_GetMemberByIndex( builder->nodes, node ), "skin" ), skinIndex );
+	return skinIndex;
+}
+
+// All channels are added to a single animation. The path is "translation", "rotation" or "scale"
+// and the interpolation is "LINEAR", "STEP" or "CUBICSPLINE".
+static void GltfBuilder_AddChannel( GltfBuilder * builder, const int node, const char * path, const int input, const int output, const char * interpolation )
+{
+	if ( builder->samplers == NULL )
+	{
+		ksJson * animation = ksJson_SetObject( ksJson_AddArrayElement( ksJson_SetArray( ksJson_AddObjectMember( builder->rootNode, "animations" ) ) ) );
+		ksJson_SetString( ksJson_AddObjectMember( animation, "name" ), "animation" );
+		builder->samplers = ksJson_SetArray( ksJson_AddObjectMember( animation, "samplers" ) );
+		builder->channels = ksJson_SetArray( ksJson_AddObjectMember( animation, "channels" ) );
+	}
+	ksJson * sampler = ksJson_SetObject( ksJson_AddArrayElement( builder->samplers ) );
+	ksJson_SetInt32( ksJson_AddObjectMember( sampler, "input" ), input );
+	ksJson_SetInt32( ksJson_AddObjectMember( sampler, "output" ), output );
+	ksJson_SetString( ksJson_AddObjectMember( sampler, "interpolation" ), interpolation );
+
+	ksJson * channel = ksJson_SetObject( ksJson_AddArrayElement( builder->channels ) );
+	ksJson_SetInt32( ksJson_AddObjectMember( channel, "sampler" ), ksJson_GetMemberCount( builder->samplers ) - 1 );
+	ksJson * target = ksJson_SetObject( ksJson_AddObjectMember( channel, "target" ) );
+	ksJson_SetInt32( ksJson_AddObjectMember( target, "node" ), node );
+	ksJson_SetString( ksJson_AddObjectMember( target, "path" ), path );
+}
+
+static void GltfBuilder_SetBuffer( GltfBuilder * builder, const char * uri )
+{
+	ksJson * buffers = ksJson_GetMemberByName( builder->rootNode, "buffers" );
+	if ( buffers == NULL )
+	{
+		buffers = ksJson_SetArray( ksJson_AddObjectMember( builder->rootNode, "buffers" ) );
+	}
+	ksJson * buffer = ksJson_SetObject( ( ksJson_GetMemberCount( buffers ) > 0 ) ? ksJson_GetMemberByIndex( buffers, 0 ) : ksJson_AddArrayElement( buffers ) );
+	ksJson_SetUint64( ksJson_AddObjectMember( buffer, "byteLength" ), builder->dataSize );
+	if ( uri != NULL )
+	{
+		ksJson_SetString( ksJson_AddObjectMember( buffer, "uri" ), uri );
+	}
+}
+
+// Writes the JSON and a separate binary file that is referenced by the file name only.
+static bool GltfBuilder_Write( GltfBuilder * builder, const char * fileName, const char * binaryFileName )
+{
+	GltfBuilder_SetBuffer( builder, binaryFileName );
+	FILE * file = fopen( binaryFileName, "wb" );
+	if ( file == NULL )
+	{
+		return false;
+	}
+	const bool written = ( fwrite( builder->data, 1, builder->dataSize, file ) == builder->dataSize );
+	fclose( file );
+	return written && ksJson_WriteToFile( builder->rootNode, fileName );
+}
+
+// Writes a binary glTF 2.0 container with the JSON chunk and the binary chunk.
+static bool GltfBuilder_WriteBinary( GltfBuilder * builder, const char * fileName )
+{
+	GltfBuilder_SetBuffer( builder, NULL );
+	char * json = NULL;
+	int jsonLength = 0;
+	if ( !ksJson_WriteToBufferEx( builder->rootNode, &json, &jsonLength, true ) )
+	{
+		return false;
+	}
+	const uint32_t jsonChunkLength = ( (uint32_t)jsonLength + 3 ) & ~3u;
+	const uint32_t binChunkLength = ( (uint32_t)builder->dataSize + 3 ) & ~3u;
+	const uint32_t header[5] = { 0x46546C67, 2, 12 + 8 + jsonChunkLength + 8 + binChunkLength, jsonChunkLength, 0x4E4F534A };
+	const uint32_t binHeader[2] = { binChunkLength, 0x004E4942 };
+	const char spaces[4] = { ' ', ' ', ' ', ' ' };
+	const char zeros[4] = { 0, 0, 0, 0 };
+
+	FILE * file = fopen( fileName, "wb" );
+	if ( file == NULL )
+	{
+		free( json );
+		return false;
+	}
+	bool written = true;
+	written &= ( fwrite( header, sizeof( header ), 1, file ) == 1 );
+	written &= ( fwrite( json, 1, jsonLength, file ) == (size_t)jsonLength );
+	written &= ( fwrite( spaces, 1, jsonChunkLength - jsonLength, file ) == jsonChunkLength - jsonLength );
+	written &= ( fwrite( binHeader, sizeof( binHeader ), 1, file ) == 1 );
+	written &= ( fwrite( builder->data, 1, builder->dataSize, file ) == builder->dataSize );
+	written &= ( fwrite( zeros, 1, binChunkLength - builder->dataSize, file ) == binChunkLength - builder->dataSize );
+	fclose( file );
+	free( json );
+	return written;
+}
+
+#endif // !GLTF_BUILDER_H
@@ -0,0 +1,1089 @@
+/*
+================================================================================================
+
+Description	:	Headless stand-in for the GPU layer of the ATW samples.
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+
+This provides the common defines and the subset of the ksGpu* interface that the scene
+headers use, so scene_gltf.h can be tested without a window or a graphics device.
+Buffers are plain heap memory that keep a copy of their data, so the tests can inspect
+the vertex and index data that would be uploaded. Programs, pipelines and textures only
+record their parameters. Submitted graphics commands are passed to an optional callback.
+
+The scene headers are compiled for the Vulkan path, because that path does not depend
+on the OpenGL headers for the glTF enumerants.
+
+================================================================================================
+*/
+
+#if !defined( KSGPU_STUB_H )
+#define KSGPU_STUB_H
+
+#if defined( __linux__ )
+	#define _GNU_SOURCE						// for pthread_setname_np and strcasecmp
+	#define OS_LINUX
+#elif defined( _WIN32 )
+	#define OS_WINDOWS
+#elif defined( __APPLE__ )
+	#define OS_APPLE
+	#define OS_APPLE_MACOS
+#endif
+
+#define GRAPHICS_API_VULKAN				1
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+#include <assert.h>
+#include <string.h>
+#include <errno.h>
+#include <ctype.h>
+
+#include <utils/sysinfo.h>
+#include <utils/nanoseconds.h>
+#include <utils/threading.h>
+#include <utils/algebra.h>
+#include <GL/gl_format.h>					// for the glTF texture formats
+
+/*
+================================
+Common defines
+================================
+*/
+
+#define UNUSED_PARM( x )				{ (void)(x); }
+#if !defined( ARRAY_SIZE )
+#define ARRAY_SIZE( a )					( sizeof( (a) ) / sizeof( (a)[0] ) )
+#endif
+#define OFFSETOF_MEMBER( type, member )	(size_t)&((type *)0)->member
+#define SIZEOF_MEMBER( type, member )	sizeof( ((type *)0)->member )
+#define BIT( x )						( 1 << (x) )
+#define ROUNDUP( x, granularity )		( ( (x) + (granularity) - 1 ) & ~( (granularity) - 1 ) )
+#define MAX( x, y )						( ( x > y ) ? ( x ) : ( y ) )
+#define MIN( x, y )						( ( x < y ) ? ( x ) : ( y ) )
+#define CLAMP( x, min, max )			( ( (x) < (min) ) ? (min) : ( ( (x) > (max) ) ? (max) : (x) ) )
+#define STRINGIFY_EXPANDED( a )			#a
+#define STRINGIFY( a )					STRINGIFY_EXPANDED(a)
+
+#define PROGRAM( name )					name##SPIRV
+
+#define SPIRV_VERSION					"99"
+#define GLSL_VERSION					"440 core"
+#define GLSL_EXTENSIONS					"#extension GL_EXT_shader_io_blocks : enable\n"	\
+										"#extension GL_ARB_enhanced_layouts : enable\n"
+
+// The scene loader reports timings with Print, which is only shown when verbose.
+static bool gpuStubVerbose = false;
+
+static void Print( const char * format, ... )
+{
+	if ( gpuStubVerbose )
+	{
+		va_list args;
+		va_start( args, format );
+		vprintf( format, args );
+		va_end( args );
+		fflush( stdout );
+	}
+}
+
+static void Error( const char * format, ... )
+{
+	va_list args;
+	va_start( args, format );
+	vprintf( format, args );
+	va_end( args );
+	printf( "\n" );
+	fflush( stdout );
+	exit( 1 );
+}
+
+static int IntegerLog2( int i )
+{
+	int r = 0;
+	int t;
+	t = ( (~( ( i >> 16 ) + ~0U ) ) >> 27 ) & 0x10; r |= t; i >>= t;
+	t = ( (~( ( i >>  8 ) + ~0U ) ) >> 28 ) & 0x08; r |= t; i >>= t;
+	t = ( (~( ( i >>  4 ) + ~0U ) ) >> 29 ) & 0x04; r |= t; i >>= t;
+	t = ( (~( ( i >>  2 ) + ~0U ) ) >> 30 ) & 0x02; r |= t; i >>= t;
+	return ( r | ( i >> 1 ) );
+}
+
+typedef uint32_t ksStringHash;
+
+static void ksStringHash_Init( ksStringHash * hash )
+{
+	*hash = 5381;
+}
+
+static void ksStringHash_Update( ksStringHash * hash, const char * string )
+{
+	ksStringHash value = *hash;
+	for ( int i = 0; string[i] != '\0'; i++ )
+	{
+		value = ( ( value << 5 ) - value ) + string[i];
+	}
+	*hash = value;
+}
+
+/*
+================================
+Context and window input
+================================
+*/
+
+typedef enum
+{
+	KS_GPU_SAMPLE_COUNT_1		= 1,
+	KS_GPU_SAMPLE_COUNT_2		= 2,
+	KS_GPU_SAMPLE_COUNT_4		= 4,
+	KS_GPU_SAMPLE_COUNT_8		= 8,
+	KS_GPU_SAMPLE_COUNT_16		= 16,
+	KS_GPU_SAMPLE_COUNT_32		= 32,
+	KS_GPU_SAMPLE_COUNT_64		= 64,
+} ksGpuSampleCount;
+
+typedef struct ksGpuLimits
+{
+	size_t					maxPushConstantsSize;
+	int						maxSamples;
+} ksGpuLimits;
+
+typedef struct
+{
+	int						unused;
+} ksGpuContext;
+
+static void ksGpuContext_WaitIdle( ksGpuContext * context )
+{
+	UNUSED_PARM( context );
+}
+
+static void ksGpuContext_GetLimits( ksGpuContext * context, ksGpuLimits * limits )
+{
+	UNUSED_PARM( context );
+	limits->maxPushConstantsSize = 256;
+	limits->maxSamples = KS_GPU_SAMPLE_COUNT_4;
+}
+
+typedef struct
+{
+	bool					keyInput[256];
+	bool					mouseInput[8];
+	int						mouseInputX[8];
+	int						mouseInputY[8];
+} ksGpuWindowInput;
+
+typedef enum
+{
+	KEY_A				= 'a',
+	KEY_B				= 'b',
+	KEY_C				= 'c',
+	KEY_D				= 'd',
+	KEY_E				= 'e',
+	KEY_F				= 'f',
+	KEY_G				= 'g',
+	KEY_H				= 'h',
+	KEY_I				= 'i',
+	KEY_J				= 'j',
+	KEY_K				= 'k',
+	KEY_L				= 'l',
+	KEY_M				= 'm',
+	KEY_N				= 'n',
+	KEY_O				= 'o',
+	KEY_P				= 'p',
+	KEY_Q				= 'q',
+	KEY_R				= 'r',
+	KEY_S				= 's',
+	KEY_T				= 't',
+	KEY_U				= 'u',
+	KEY_V				= 'v',
+	KEY_W				= 'w',
+	KEY_X				= 'x',
+	KEY_Y				= 'y',
+	KEY_Z				= 'z',
+	KEY_RETURN			= 0x0D,
+	KEY_TAB				= 0x09,
+	KEY_ESCAPE			= 0x1B,
+	KEY_SHIFT_LEFT		= 0x80,
+	KEY_CTRL_LEFT		= 0x81,
+	KEY_ALT_LEFT		= 0x82,
+	KEY_CURSOR_UP		= 0x83,
+	KEY_CURSOR_DOWN		= 0x84,
+	KEY_CURSOR_LEFT		= 0x85,
+	KEY_CURSOR_RIGHT	= 0x86
+} ksKeyboardKey;
+
+static bool ksGpuWindowInput_CheckKeyboardKey( ksGpuWindowInput * input, const ksKeyboardKey key )
+{
+	return ( input->keyInput[key] != false );
+}
+
+#define NUM_EYES				2
+
+// The head does not move, so the simulation only depends on the scene and the time.
+static void GetHmdViewMatrixForTime( ksMatrix4x4f * viewMatrix, const ksNanoseconds time )
+{
+	UNUSED_PARM( time );
+	ksMatrix4x4f_CreateIdentity( viewMatrix );
+}
+
+static bool ksGpuWindow_SupportedResolution( const int width, const int height )
+{
+	UNUSED_PARM( width );
+	UNUSED_PARM( height );
+	return true;
+}
+
+/*
+================================
+Buffers
+================================
+*/
+
+typedef enum
+{
+	KS_GPU_BUFFER_TYPE_VERTEX,
+	KS_GPU_BUFFER_TYPE_INDEX,
+	KS_GPU_BUFFER_TYPE_UNIFORM,
+	KS_GPU_BUFFER_TYPE_STORAGE
+} ksGpuBufferType;
+
+typedef struct
+{
+	ksGpuBufferType			type;
+	size_t					size;
+	unsigned char *			data;		// copy of the data that would be uploaded
+	bool					owner;
+} ksGpuBuffer;
+
+static bool ksGpuBuffer_Create( ksGpuContext * context, ksGpuBuffer * buffer, const ksGpuBufferType type,
+							const size_t dataSize, const void * data, const bool hostVisible )
+{
+	UNUSED_PARM( context );
+	UNUSED_PARM( hostVisible );
+
+	buffer->type = type;
+	buffer->size = dataSize;
+	buffer->data = (unsigned char *) calloc( dataSize + 1, 1 );
+	buffer->owner = true;
+	if ( data != NULL )
+	{
+		memcpy( buffer->data, data, dataSize );
+	}
+	return true;
+}
+
+static void ksGpuBuffer_CreateReference( ksGpuContext * context, ksGpuBuffer * buffer, const ksGpuBuffer * other )
+{
+	UNUSED_PARM( context );
+
+	*buffer = *other;
+	buffer->owner = false;
+}
+
+static void ksGpuBuffer_Destroy( ksGpuContext * context, ksGpuBuffer * buffer )
+{
+	UNUSED_PARM( context );
+
+	if ( buffer->owner )
+	{
+		free( buffer->data );
+	}
+	memset( buffer, 0, sizeof( ksGpuBuffer ) );
+}
+
+/*
+================================
+Textures
+================================
+*/
+
+typedef enum
+{
+	KS_GPU_TEXTURE_FORMAT_R8G8B8A8_UNORM	= 37
+} ksGpuTextureFormat;
+
+typedef enum
+{
+	KS_GPU_TEXTURE_USAGE_UNDEFINED			= BIT( 0 ),
+	KS_GPU_TEXTURE_USAGE_GENERAL			= BIT( 1 ),
+	KS_GPU_TEXTURE_USAGE_TRANSFER_SRC		= BIT( 2 ),
+	KS_GPU_TEXTURE_USAGE_TRANSFER_DST		= BIT( 3 ),
+	KS_GPU_TEXTURE_USAGE_SAMPLED			= BIT( 4 ),
+	KS_GPU_TEXTURE_USAGE_STORAGE			= BIT( 5 ),
+	KS_GPU_TEXTURE_USAGE_COLOR_ATTACHMENT	= BIT( 6 ),
+	KS_GPU_TEXTURE_USAGE_PRESENTATION		= BIT( 7 )
+} ksGpuTextureUsage;
+
+typedef unsigned int ksGpuTextureUsageFlags;
+
+typedef enum
+{
+	KS_GPU_TEXTURE_WRAP_MODE_REPEAT,
+	KS_GPU_TEXTURE_WRAP_MODE_CLAMP_TO_EDGE,
+	KS_GPU_TEXTURE_WRAP_MODE_CLAMP_TO_BORDER
+} ksGpuTextureWrapMode;
+
+typedef enum
+{
+	KS_GPU_TEXTURE_FILTER_NEAREST,
+	KS_GPU_TEXTURE_FILTER_LINEAR,
+	KS_GPU_TEXTURE_FILTER_BILINEAR
+} ksGpuTextureFilter;
+
+typedef struct
+{
+	int						width;
+	int						height;
+	int						mipCount;
+	ksGpuTextureWrapMode	wrapMode;
+	ksGpuTextureFilter		filter;
+	float					maxAnisotropy;
+} ksGpuTexture;
+
+static bool ksGpuTexture_Create2D( ksGpuContext * context, ksGpuTexture * texture,
+									const ksGpuTextureFormat format, const ksGpuSampleCount sampleCount,
+									const int width, const int height, const int mipCount,
+									const ksGpuTextureUsageFlags usageFlags, const void * data, const size_t dataSize )
+{
+	UNUSED_PARM( context );
+	UNUSED_PARM( format );
+	UNUSED_PARM( sampleCount );
+	UNUSED_PARM( usageFlags );
+	UNUSED_PARM( data );
+	UNUSED_PARM( dataSize );
+
+	memset( texture, 0, sizeof( ksGpuTexture ) );
+	texture->width = width;
+	texture->height = height;
+	texture->mipCount = mipCount;
+	return true;
+}
+
+// KTX files are not decoded, so the scene falls back to its default texture.
+static bool ksGpuTexture_CreateFromKTX( ksGpuContext * context, ksGpuTexture * texture, const char * fileName,
+									const unsigned char * buffer, const size_t bufferSize )
+{
+	UNUSED_PARM( context );
+	UNUSED_PARM( fileName );
+	UNUSED_PARM( buffer );
+	UNUSED_PARM( bufferSize );
+
+	memset( texture, 0, sizeof( ksGpuTexture ) );
+	return false;
+}
+
+static void ksGpuTexture_Destroy( ksGpuContext * context, ksGpuTexture * texture )
+{
+	UNUSED_PARM( context );
+
+	memset( texture, 0, sizeof( ksGpuTexture ) );
+}
+
+/*
+================================
+Vertex attributes and geometry
+================================
+*/
+
+typedef unsigned short ksGpuTriangleIndex;
+
+typedef struct
+{
+	const ksGpuBuffer *		buffer;
+	ksGpuTriangleIndex *	indexArray;
+	int						indexCount;
+} ksGpuTriangleIndexArray;
+
+typedef enum
+{
+	KS_GPU_ATTRIBUTE_FORMAT_R32_SFLOAT				= 100,
+	KS_GPU_ATTRIBUTE_FORMAT_R32G32_SFLOAT			= 103,
+	KS_GPU_ATTRIBUTE_FORMAT_R32G32B32_SFLOAT		= 106,
+	KS_GPU_ATTRIBUTE_FORMAT_R32G32B32A32_SFLOAT		= 109
+} ksGpuAttributeFormat;
+
+typedef struct
+{
+	int						attributeFlag;		// VERTEX_ATTRIBUTE_FLAG_
+	size_t					attributeOffset;	// Offset in bytes to the pointer in ksGpuVertexAttributeArrays
+	size_t					attributeSize;		// Size in bytes of a single attribute
+	ksGpuAttributeFormat	attributeFormat;	// Format of the attribute
+	int						locationCount;		// Number of attribute locations
+	const char *			name;				// Name in vertex program
+} ksGpuVertexAttribute;
+
+typedef struct
+{
+	const ksGpuBuffer *				buffer;
+	const ksGpuVertexAttribute *	layout;
+	void *							data;
+	size_t							dataSize;
+	int								vertexCount;
+	int								attribsFlags;
+} ksGpuVertexAttributeArrays;
+
+typedef enum
+{
+	VERTEX_ATTRIBUTE_FLAG_POSITION		= BIT( 0 ),		// vec3 vertexPosition
+	VERTEX_ATTRIBUTE_FLAG_NORMAL		= BIT( 1 ),		// vec3 vertexNormal
+	VERTEX_ATTRIBUTE_FLAG_TANGENT		= BIT( 2 ),		// vec3 vertexTangent
+	VERTEX_ATTRIBUTE_FLAG_BINORMAL		= BIT( 3 ),		// vec3 vertexBinormal
+	VERTEX_ATTRIBUTE_FLAG_COLOR			= BIT( 4 ),		// vec4 vertexColor
+	VERTEX_ATTRIBUTE_FLAG_UV0			= BIT( 5 ),		// vec2 vertexUv0
+	VERTEX_ATTRIBUTE_FLAG_UV1			= BIT( 6 ),		// vec2 vertexUv1
+	VERTEX_ATTRIBUTE_FLAG_UV2			= BIT( 7 ),		// vec2 vertexUv2
+	VERTEX_ATTRIBUTE_FLAG_JOINT_INDICES	= BIT( 8 ),		// vec4 jointIndices
+	VERTEX_ATTRIBUTE_FLAG_JOINT_WEIGHTS	= BIT( 9 ),		// vec4 jointWeights
+	VERTEX_ATTRIBUTE_FLAG_TRANSFORM		= BIT( 10 )		// mat4 vertexTransform (NOTE this mat4 takes up 4 attribute locations)
+} ksDefaultVertexAttributeFlags;
+
+typedef struct
+{
+	ksGpuVertexAttributeArrays	base;
+	ksVector3f *				position;
+	ksVector3f *				normal;
+	ksVector3f *				tangent;
+	ksVector3f *				binormal;
+	ksVector4f *				color;
+	ksVector2f *				uv0;
+	ksVector2f *				uv1;
+	ksVector2f *				uv2;
+	ksVector4f *				jointIndices;
+	ksVector4f *				jointWeights;
+	ksMatrix4x4f *				transform;
+} ksDefaultVertexAttributeArrays;
+
+static const ksGpuVertexAttribute DefaultVertexAttributeLayout[] =
+{
+	{ VERTEX_ATTRIBUTE_FLAG_POSITION,		OFFSETOF_MEMBER( ksDefaultVertexAttributeArrays, position ),		SIZEOF_MEMBER( ksDefaultVertexAttributeArrays, position[0] ),		KS_GPU_ATTRIBUTE_FORMAT_R32G32B32_SFLOAT,		1,	"vertexPosition" },
+	{ VERTEX_ATTRIBUTE_FLAG_NORMAL,			OFFSETOF_MEMBER( ksDefaultVertexAttributeArrays, normal ),			SIZEOF_MEMBER( ksDefaultVertexAttributeArrays, normal[0] ),			KS_GPU_ATTRIBUTE_FORMAT_R32G32B32_SFLOAT,		1,	"vertexNormal" },
+	{ VERTEX_ATTRIBUTE_FLAG_TANGENT,		OFFSETOF_MEMBER( ksDefaultVertexAttributeArrays, tangent ),			SIZEOF_MEMBER( ksDefaultVertexAttributeArrays, tangent[0] ),		KS_GPU_ATTRIBUTE_FORMAT_R32G32B32_SFLOAT,		1,	"vertexTangent" },
+	{ VERTEX_ATTRIBUTE_FLAG_BINORMAL,		OFFSETOF_MEMBER( ksDefaultVertexAttributeArrays, binormal ),		SIZEOF_MEMBER( ksDefaultVertexAttributeArrays, binormal[0] ),		KS_GPU_ATTRIBUTE_FORMAT_R32G32B32_SFLOAT,		1,	"vertexBinormal" },
+	{ VERTEX_ATTRIBUTE_FLAG_COLOR,			OFFSETOF_MEMBER( ksDefaultVertexAttributeArrays, color ),			SIZEOF_MEMBER( ksDefaultVertexAttributeArrays, color[0] ),			KS_GPU_ATTRIBUTE_FORMAT_R32G32B32A32_SFLOAT,	1,	"vertexColor" },
+	{ VERTEX_ATTRIBUTE_FLAG_UV0,			OFFSETOF_MEMBER( ksDefaultVertexAttributeArrays, uv0 ),				SIZEOF_MEMBER( ksDefaultVertexAttributeArrays, uv0[0] ),			KS_GPU_ATTRIBUTE_FORMAT_R32G32_SFLOAT,			1,	"vertexUv0" },
+	{ VERTEX_ATTRIBUTE_FLAG_UV1,			OFFSETOF_MEMBER( ksDefaultVertexAttributeArrays, uv1 ),				SIZEOF_MEMBER( ksDefaultVertexAttributeArrays, uv1[0] ),			KS_GPU_ATTRIBUTE_FORMAT_R32G32_SFLOAT,			1,	"vertexUv1" },
+	{ VERTEX_ATTRIBUTE_FLAG_UV2,			OFFSETOF_MEMBER( ksDefaultVertexAttributeArrays, uv2 ),				SIZEOF_MEMBER( ksDefaultVertexAttributeArrays, uv2[0] ),			KS_GPU_ATTRIBUTE_FORMAT_R32G32_SFLOAT,			1,	"vertexUv2" },
+	{ VERTEX_ATTRIBUTE_FLAG_JOINT_INDICES,	OFFSETOF_MEMBER( ksDefaultVertexAttributeArrays, jointIndices ),	SIZEOF_MEMBER( ksDefaultVertexAttributeArrays, jointIndices[0] ),	KS_GPU_ATTRIBUTE_FORMAT_R32G32B32A32_SFLOAT,	1,	"vertexJointIndices" },
+	{ VERTEX_ATTRIBUTE_FLAG_JOINT_WEIGHTS,	OFFSETOF_MEMBER( ksDefaultVertexAttributeArrays, jointWeights ),	SIZEOF_MEMBER( ksDefaultVertexAttributeArrays, jointWeights[0] ),	KS_GPU_ATTRIBUTE_FORMAT_R32G32B32A32_SFLOAT,	1,	"vertexJointWeights" },
+	{ VERTEX_ATTRIBUTE_FLAG_TRANSFORM,		OFFSETOF_MEMBER( ksDefaultVertexAttributeArrays, transform ),		SIZEOF_MEMBER( ksDefaultVertexAttributeArrays, transform[0] ),		KS_GPU_ATTRIBUTE_FORMAT_R32G32B32A32_SFLOAT,	4,	"vertexTransform" },
+	{ 0, 0, 0, 0, 0, "" }
+};
+
+static void ksGpuTriangleIndexArray_CreateFromBuffer( ksGpuTriangleIndexArray * indices, const int indexCount, const ksGpuBuffer * buffer )
+{
+	indices->indexCount = indexCount;
+	indices->indexArray = NULL;
+	indices->buffer = buffer;
+}
+
+static size_t ksGpuVertexAttributeArrays_GetDataSize( const ksGpuVertexAttribute * layout, const int vertexCount, const int attribsFlags )
+{
+	size_t totalSize = 0;
+	for ( int i = 0; layout[i].attributeFlag != 0; i++ )
+	{
+		const ksGpuVertexAttribute * v = &layout[i];
+		if ( ( v->attributeFlag & attribsFlags ) != 0 )
+		{
+			totalSize += v->attributeSize;
+		}
+	}
+	return vertexCount * totalSize;
+}
+
+static void ksGpuVertexAttributeArrays_Map( ksGpuVertexAttributeArrays * attribs, void * data, const size_t dataSize, const int vertexCount, const int attribsFlags )
+{
+	unsigned char * dataBytePtr = (unsigned char *) data;
+	size_t offset = 0;
+
+	for ( int i = 0; attribs->layout[i].attributeFlag != 0; i++ )
+	{
+		const ksGpuVertexAttribute * v = &attribs->layout[i];
+		void ** attribPtr = (void **) ( ((char *)attribs) + v->attributeOffset );
+		if ( ( v->attributeFlag & attribsFlags ) != 0 )
+		{
+			*attribPtr = ( dataBytePtr + offset );
+			offset += vertexCount * v->attributeSize;
+		}
+		else
+		{
+			*attribPtr = NULL;
+		}
+	}
+
+	assert( offset == dataSize );
+	UNUSED_PARM( dataSize );
+}
+
+static void ksGpuVertexAttributeArrays_CreateFromBuffer( ksGpuVertexAttributeArrays * attribs, const ksGpuVertexAttribute * layout,
+															const int vertexCount, const int attribsFlags, const ksGpuBuffer * buffer )
+{
+	attribs->buffer = buffer;
+	attribs->layout = layout;
+	attribs->data = NULL;
+	attribs->dataSize = 0;
+	attribs->vertexCount = vertexCount;
+	attribs->attribsFlags = attribsFlags;
+}
+
+static void ksGpuVertexAttributeArrays_Alloc( ksGpuVertexAttributeArrays * attribs, const ksGpuVertexAttribute * layout, const int vertexCount, const int attribsFlags )
+{
+	const size_t dataSize = ksGpuVertexAttributeArrays_GetDataSize( layout, vertexCount, attribsFlags );
+	void * data = malloc( dataSize );
+	attribs->buffer = NULL;
+	attribs->layout = layout;
+	attribs->data = data;
+	attribs->dataSize = dataSize;
+	attribs->vertexCount = vertexCount;
+	attribs->attribsFlags = attribsFlags;
+	ksGpuVertexAttributeArrays_Map( attribs, data, dataSize, vertexCount, attribsFlags );
+}
+
+static void ksGpuVertexAttributeArrays_Free( ksGpuVertexAttributeArrays * attribs )
+{
+	free( attribs->data );
+	memset( attribs, 0, sizeof( ksGpuVertexAttributeArrays ) );
+}
+
+typedef struct
+{
+	const ksGpuVertexAttribute *	layout;
+	int								vertexAttribsFlags;
+	int								instanceAttribsFlags;
+	int								vertexCount;
+	int								instanceCount;
+	int 							indexCount;
+	int								firstIndex;			// first index of a geometry range in the index buffer
+	int								vertexOffset;		// offset added to the indices of a geometry range
+	int								storedVertexCount;	// number of vertices stored in the vertex buffer
+	ksGpuBuffer						vertexBuffer;
+	ksGpuBuffer						instanceBuffer;
+	ksGpuBuffer						indexBuffer;
+} ksGpuGeometry;
+
+static void ksGpuGeometry_Create( ksGpuContext * context, ksGpuGeometry * geometry,
+								const ksGpuVertexAttributeArrays * attribs,
+								const ksGpuTriangleIndexArray * indices )
+{
+	memset( geometry, 0, sizeof( ksGpuGeometry ) );
+
+	geometry->layout = attribs->layout;
+	geometry->vertexAttribsFlags = attribs->attribsFlags;
+	geometry->vertexCount = attribs->vertexCount;
+	geometry->indexCount = indices->indexCount;
+	geometry->storedVertexCount = attribs->vertexCount;
+
+	if ( attribs->buffer != NULL )
+	{
+		ksGpuBuffer_CreateReference( context, &geometry->vertexBuffer, attribs->buffer );
+	}
+	else
+	{
+		ksGpuBuffer_Create( context, &geometry->vertexBuffer, KS_GPU_BUFFER_TYPE_VERTEX, attribs->dataSize, attribs->data, false );
+	}
+	if ( indices->buffer != NULL )
+	{
+		ksGpuBuffer_CreateReference( context, &geometry->indexBuffer, indices->buffer );
+	}
+	else
+	{
+		ksGpuBuffer_Create( context, &geometry->indexBuffer, KS_GPU_BUFFER_TYPE_INDEX, indices->indexCount * sizeof( indices->indexArray[0] ), indices->indexArray, false );
+	}
+}
+
+static void ksGpuGeometry_CreateRange( ksGpuContext * context, ksGpuGeometry * geometry, const ksGpuGeometry * other,
+								const int firstIndex, const int indexCount, const int vertexOffset, const int vertexCount )
+{
+	assert( firstIndex >= 0 && ( firstIndex + indexCount ) * sizeof( ksGpuTriangleIndex ) <= other->indexBuffer.size );
+	assert( vertexOffset >= 0 && vertexOffset + vertexCount <= other->storedVertexCount );
+
+	memset( geometry, 0, sizeof( ksGpuGeometry ) );
+
+	geometry->layout = other->layout;
+	geometry->vertexAttribsFlags = other->vertexAttribsFlags;
+	geometry->vertexCount = vertexCount;
+	geometry->indexCount = indexCount;
+	geometry->firstIndex = firstIndex;
+	geometry->vertexOffset = vertexOffset;
+	geometry->storedVertexCount = other->storedVertexCount;
+
+	ksGpuBuffer_CreateReference( context, &geometry->vertexBuffer, &other->vertexBuffer );
+	ksGpuBuffer_CreateReference( context, &geometry->indexBuffer, &other->indexBuffer );
+}
+
+// Only the bounds are drawn with the cube, so it has no vertex data here.
+static void ksGpuGeometry_CreateCube( ksGpuContext * context, ksGpuGeometry * geometry, const float offset, const float scale )
+{
+	UNUSED_PARM( context );
+	UNUSED_PARM( offset );
+	UNUSED_PARM( scale );
+
+	memset( geometry, 0, sizeof( ksGpuGeometry ) );
+}
+
+static void ksGpuGeometry_Destroy( ksGpuContext * context, ksGpuGeometry * geometry )
+{
+	ksGpuBuffer_Destroy( context, &geometry->indexBuffer );
+	ksGpuBuffer_Destroy( context, &geometry->vertexBuffer );
+	memset( geometry, 0, sizeof( ksGpuGeometry ) );
+}
+
+// Returns the element of a vertex attribute of a geometry, or NULL if the geometry does not have the attribute.
+static const void * ksGpuGeometry_GetAttribute( const ksGpuGeometry * geometry, const int attributeFlag, const int vertexIndex )
+{
+	size_t offset = 0;
+	for ( int i = 0; geometry->layout[i].attributeFlag != 0; i++ )
+	{
+		const ksGpuVertexAttribute * v = &geometry->layout[i];
+		if ( ( v->attributeFlag & geometry->vertexAttribsFlags ) == 0 )
+		{
+			continue;
+		}
+		if ( v->attributeFlag == attributeFlag )
+		{
+			assert( vertexIndex >= 0 && vertexIndex < geometry->storedVertexCount );
+			return geometry->vertexBuffer.data + offset + vertexIndex * v->attributeSize;
+		}
+		offset += geometry->storedVertexCount * v->attributeSize;
+	}
+	return NULL;
+}
+
+// Returns the vertex index of an index of a geometry, including the offset of a geometry range.
+static int ksGpuGeometry_GetVertexIndex( const ksGpuGeometry * geometry, const int index )
+{
+	assert( index >= 0 && index < geometry->indexCount );
+	const ksGpuTriangleIndex * indices = (const ksGpuTriangleIndex *) geometry->indexBuffer.data;
+	return geometry->vertexOffset + indices[geometry->firstIndex + index];
+}
+
+/*
+================================
+Render pass
+================================
+*/
+
+typedef enum
+{
+	KS_GPU_SURFACE_COLOR_FORMAT_R8G8B8A8,
+	KS_GPU_SURFACE_COLOR_FORMAT_MAX
+} ksGpuSurfaceColorFormat;
+
+typedef enum
+{
+	KS_GPU_SURFACE_DEPTH_FORMAT_NONE,
+	KS_GPU_SURFACE_DEPTH_FORMAT_D24,
+	KS_GPU_SURFACE_DEPTH_FORMAT_MAX
+} ksGpuSurfaceDepthFormat;
+
+typedef struct
+{
+	int							flags;
+	ksGpuSurfaceColorFormat		colorFormat;
+	ksGpuSurfaceDepthFormat		depthFormat;
+	ksGpuSampleCount			sampleCount;
+} ksGpuRenderPass;
+
+/*
+================================
+Programs
+================================
+*/
+
+#define MAX_PROGRAM_PARMS			16
+
+typedef enum
+{
+	KS_GPU_PROGRAM_STAGE_FLAG_VERTEX		= BIT( 0 ),
+	KS_GPU_PROGRAM_STAGE_FLAG_FRAGMENT		= BIT( 1 ),
+	KS_GPU_PROGRAM_STAGE_FLAG_COMPUTE		= BIT( 2 ),
+	KS_GPU_PROGRAM_STAGE_MAX				= 3
+} ksGpuProgramStageFlags;
+
+typedef enum
+{
+	KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_SAMPLED,				// texture plus sampler bound together		(GLSL: sampler*, isampler*, usampler*)
+	KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_STORAGE,				// not sampled, direct read-write storage	(GLSL: image*, iimage*, uimage*)
+	KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM,				// read-only uniform buffer					(GLSL: uniform)
+	KS_GPU_PROGRAM_PARM_TYPE_BUFFER_STORAGE,				// read-write storage buffer				(GLSL: buffer)
+	KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_INT,				// int										(GLSL: int)
+	KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_INT_VECTOR2,		// int[2]									(GLSL: ivec2)
+	KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_INT_VECTOR3,		// int[3]									(GLSL: ivec3)
+	KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_INT_VECTOR4,		// int[4]									(GLSL: ivec4)
+	KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT,			// float									(GLSL: float)
+	KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_VECTOR2,	// float[2]									(GLSL: vec2)
+	KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_VECTOR3,	// float[3]									(GLSL: vec3)
+	KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_VECTOR4,	// float[4]									(GLSL: vec4)
+	KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX2X2,	// float[2][2]								(GLSL: mat2x2 or mat2)
+	KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX2X3,	// float[2][3]								(GLSL: mat2x3)
+	KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX2X4,	// float[2][4]								(GLSL: mat2x4)
+	KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX3X2,	// float[3][2]								(GLSL: mat3x2)
+	KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX3X3,	// float[3][3]								(GLSL: mat3x3 or mat3)
+	KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX3X4,	// float[3][4]								(GLSL: mat3x4)
+	KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX4X2,	// float[4][2]								(GLSL: mat4x2)
+	KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX4X3,	// float[4][3]								(GLSL: mat4x3)
+	KS_GPU_PROGRAM_PARM_TYPE_PUSH_CONSTANT_FLOAT_MATRIX4X4,	// float[4][4]								(GLSL: mat4x4 or mat4)
+	KS_GPU_PROGRAM_PARM_TYPE_MAX
+} ksGpuProgramParmType;
+
+typedef enum
+{
+	KS_GPU_PROGRAM_PARM_ACCESS_READ_ONLY,
+	KS_GPU_PROGRAM_PARM_ACCESS_WRITE_ONLY,
+	KS_GPU_PROGRAM_PARM_ACCESS_READ_WRITE
+} ksGpuProgramParmAccess;
+
+typedef struct
+{
+	int							stageFlags;	// vertex, fragment and/or compute
+	ksGpuProgramParmType		type;		// texture, buffer or push constant
+	ksGpuProgramParmAccess		access;		// read and/or write
+	int							index;		// index into ksGpuProgramParmState::parms
+	const char * 				name;		// GLSL name
+	int							binding;	// Vulkan texture/buffer binding, or push constant offset
+} ksGpuProgramParm;
+
+static bool ksGpuProgramParm_IsOpaqueBinding( const ksGpuProgramParmType type )
+{
+	return	( ( type == KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_SAMPLED ) ?	true :
+			( ( type == KS_GPU_PROGRAM_PARM_TYPE_TEXTURE_STORAGE ) ?	true :
+			( ( type == KS_GPU_PROGRAM_PARM_TYPE_BUFFER_UNIFORM ) ?		true :
+			( ( type == KS_GPU_PROGRAM_PARM_TYPE_BUFFER_STORAGE ) ?		true :
+																		false ) ) ) );
+}
+
+static int ksGpuProgramParm_GetPushConstantSize( ksGpuProgramParmType type )
+{
+	static const int parmSize[KS_GPU_PROGRAM_PARM_TYPE_MAX] =
+	{
+		(unsigned int)0,
+		(unsigned int)0,
+		(unsigned int)0,
+		(unsigned int)0,
+		(unsigned int)sizeof( int ),
+		(unsigned int)sizeof( int[2] ),
+		(unsigned int)sizeof( int[3] ),
+		(unsigned int)sizeof( int[4] ),
+		(unsigned int)sizeof( float ),
+		(unsigned int)sizeof( float[2] ),
+		(unsigned int)sizeof( float[3] ),
+		(unsigned int)sizeof( float[4] ),
+		(unsigned int)sizeof( float[2][2] ),
+		(unsigned int)sizeof( float[2][3] ),
+		(unsigned int)sizeof( float[2][4] ),
+		(unsigned int)sizeof( float[3][2] ),
+		(unsigned int)sizeof( float[3][3] ),
+		(unsigned int)sizeof( float[3][4] ),
+		(unsigned int)sizeof( float[4][2] ),
+		(unsigned int)sizeof( float[4][3] ),
+		(unsigned int)sizeof( float[4][4] )
+	};
+	assert( ARRAY_SIZE( parmSize ) == KS_GPU_PROGRAM_PARM_TYPE_MAX );
+	return parmSize[type];
+}
+
+static const char * ksGpuProgramParm_GetPushConstantGlslType( const ksGpuProgramParmType type )
+{
+	static const char * glslType[KS_GPU_PROGRAM_PARM_TYPE_MAX] =
+	{
+		"",
+		"",
+		"",
+		"",
+		"int",
+		"ivec2",
+		"ivec3",
+		"ivec4",
+		"float",
+		"vec2",
+		"vec3",
+		"vec4",
+		"mat2",
+		"mat2x3",
+		"mat2x4",
+		"mat3x2",
+		"mat3",
+		"mat3x4",
+		"mat4x2",
+		"mat4x3",
+		"mat4"
+	};
+	assert( ARRAY_SIZE( glslType ) == KS_GPU_PROGRAM_PARM_TYPE_MAX );
+	return glslType[type];
+}
+
+typedef struct
+{
+	const ksGpuProgramParm *	parms;
+	int							numParms;
+	int							vertexAttribsFlags;
+} ksGpuGraphicsProgram;
+
+static bool ksGpuGraphicsProgram_Create( ksGpuContext * context, ksGpuGraphicsProgram * program,
+										const void * vertexSourceData, const size_t vertexSourceSize,
+										const void * fragmentSourceData, const size_t fragmentSourceSize,
+										const ksGpuProgramParm * parms, const int numParms,
+										const ksGpuVertexAttribute * vertexLayout, const int vertexAttribsFlags )
+{
+	UNUSED_PARM( context );
+	UNUSED_PARM( vertexSourceData );
+	UNUSED_PARM( vertexSourceSize );
+	UNUSED_PARM( fragmentSourceData );
+	UNUSED_PARM( fragmentSourceSize );
+	UNUSED_PARM( vertexLayout );
+
+	program->parms = parms;
+	program->numParms = numParms;
+	program->vertexAttribsFlags = vertexAttribsFlags;
+	return true;
+}
+
+static void ksGpuGraphicsProgram_Destroy( ksGpuContext * context, ksGpuGraphicsProgram * program )
+{
+	UNUSED_PARM( context );
+
+	memset( program, 0, sizeof( ksGpuGraphicsProgram ) );
+}
+
+/*
+================================
+Pipelines
+================================
+*/
+
+typedef enum
+{
+	KS_GPU_FRONT_FACE_COUNTER_CLOCKWISE,
+	KS_GPU_FRONT_FACE_CLOCKWISE
+} ksGpuFrontFace;
+
+typedef enum
+{
+	KS_GPU_CULL_MODE_NONE,
+	KS_GPU_CULL_MODE_FRONT,
+	KS_GPU_CULL_MODE_BACK
+} ksGpuCullMode;
+
+typedef enum
+{
+	KS_GPU_COMPARE_OP_NEVER,
+	KS_GPU_COMPARE_OP_LESS,
+	KS_GPU_COMPARE_OP_EQUAL,
+	KS_GPU_COMPARE_OP_LESS_OR_EQUAL,
+	KS_GPU_COMPARE_OP_GREATER,
+	KS_GPU_COMPARE_OP_NOT_EQUAL,
+	KS_GPU_COMPARE_OP_GREATER_OR_EQUAL,
+	KS_GPU_COMPARE_OP_ALWAYS
+} ksGpuCompareOp;
+
+typedef enum
+{
+	KS_GPU_BLEND_OP_ADD,
+	KS_GPU_BLEND_OP_SUBTRACT,
+	KS_GPU_BLEND_OP_REVERSE_SUBTRACT,
+	KS_GPU_BLEND_OP_MIN,
+	KS_GPU_BLEND_OP_MAX
+} ksGpuBlendOp;
+
+typedef enum
+{
+	KS_GPU_BLEND_FACTOR_ZERO,
+	KS_GPU_BLEND_FACTOR_ONE,
+	KS_GPU_BLEND_FACTOR_SRC_COLOR,
+	KS_GPU_BLEND_FACTOR_ONE_MINUS_SRC_COLOR,
+	KS_GPU_BLEND_FACTOR_DST_COLOR,
+	KS_GPU_BLEND_FACTOR_ONE_MINUS_DST_COLOR,
+	KS_GPU_BLEND_FACTOR_SRC_ALPHA,
+	KS_GPU_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA,
+	KS_GPU_BLEND_FACTOR_DST_ALPHA,
+	KS_GPU_BLEND_FACTOR_ONE_MINUS_DST_ALPHA,
+	KS_GPU_BLEND_FACTOR_CONSTANT_COLOR,
+	KS_GPU_BLEND_FACTOR_ONE_MINUS_CONSTANT_COLOR,
+	KS_GPU_BLEND_FACTOR_CONSTANT_ALPHA,
+	KS_GPU_BLEND_FACTOR_ONE_MINUS_CONSTANT_ALPHA,
+	KS_GPU_BLEND_FACTOR_SRC_ALPHA_SATURATE
+} ksGpuBlendFactor;
+
+typedef struct
+{
+	bool							blendEnable;
+	bool							redWriteEnable;
+	bool							blueWriteEnable;
+	bool							greenWriteEnable;
+	bool							alphaWriteEnable;
+	bool							depthTestEnable;
+	bool							depthWriteEnable;
+	ksGpuFrontFace					frontFace;
+	ksGpuCullMode					cullMode;
+	ksGpuCompareOp					depthCompare;
+	ksVector4f						blendColor;
+	ksGpuBlendOp					blendOpColor;
+	ksGpuBlendFactor				blendSrcColor;
+	ksGpuBlendFactor				blendDstColor;
+	ksGpuBlendOp					blendOpAlpha;
+	ksGpuBlendFactor				blendSrcAlpha;
+	ksGpuBlendFactor				blendDstAlpha;
+} ksGpuRasterOperations;
+
+typedef struct
+{
+	ksGpuRasterOperations			rop;
+	const ksGpuRenderPass *			renderPass;
+	const ksGpuGraphicsProgram *	program;
+	const ksGpuGeometry *			geometry;
+} ksGpuGraphicsPipelineParms;
+
+typedef struct
+{
+	ksGpuRasterOperations			rop;
+	const ksGpuGraphicsProgram *	program;
+	const ksGpuGeometry *			geometry;
+} ksGpuGraphicsPipeline;
+
+static void ksGpuGraphicsPipelineParms_Init( ksGpuGraphicsPipelineParms * parms )
+{
+	memset( parms, 0, sizeof( ksGpuGraphicsPipelineParms ) );
+	parms->rop.redWriteEnable = true;
+	parms->rop.blueWriteEnable = true;
+	parms->rop.greenWriteEnable = true;
+	parms->rop.alphaWriteEnable = false;
+	parms->rop.depthTestEnable = true;
+	parms->rop.depthWriteEnable = true;
+	parms->rop.frontFace = KS_GPU_FRONT_FACE_COUNTER_CLOCKWISE;
+	parms->rop.cullMode = KS_GPU_CULL_MODE_BACK;
+	parms->rop.depthCompare = KS_GPU_COMPARE_OP_LESS_OR_EQUAL;
+	parms->rop.blendOpColor = KS_GPU_BLEND_OP_ADD;
+	parms->rop.blendSrcColor = KS_GPU_BLEND_FACTOR_ONE;
+	parms->rop.blendDstColor = KS_GPU_BLEND_FACTOR_ZERO;
+	parms->rop.blendOpAlpha = KS_GPU_BLEND_OP_ADD;
+	parms->rop.blendSrcAlpha = KS_GPU_BLEND_FACTOR_ONE;
+	parms->rop.blendDstAlpha = KS_GPU_BLEND_FACTOR_ZERO;
+}
+
+static bool ksGpuGraphicsPipeline_Create( ksGpuContext * context, ksGpuGraphicsPipeline * pipeline, const ksGpuGraphicsPipelineParms * parms )
+{
+	UNUSED_PARM( context );
+
+	pipeline->rop = parms->rop;
+	pipeline->program = parms->program;
+	pipeline->geometry = parms->geometry;
+	return true;
+}
+
+static void ksGpuGraphicsPipeline_Destroy( ksGpuContext * context, ksGpuGraphicsPipeline * pipeline )
+{
+	UNUSED_PARM( context );
+
+	memset( pipeline, 0, sizeof( ksGpuGraphicsPipeline ) );
+}
+
+/*
+================================
+Graphics commands
+================================
+*/
+
+typedef struct
+{
+	const void *	parms[MAX_PROGRAM_PARMS];
+} ksGpuProgramParmState;
+
+typedef struct
+{
+	const ksGpuGraphicsPipeline *	pipeline;
+	ksGpuProgramParmState			parmState;
+	int								numInstances;
+} ksGpuGraphicsCommand;
+
+static void ksGpuGraphicsCommand_Init( ksGpuGraphicsCommand * command )
+{
+	memset( command, 0, sizeof( ksGpuGraphicsCommand ) );
+	command->numInstances = 1;
+}
+
+static void ksGpuGraphicsCommand_SetPipeline( ksGpuGraphicsCommand * command, const ksGpuGraphicsPipeline * pipeline )
+{
+	command->pipeline = pipeline;
+}
+
+static void ksGpuGraphicsCommand_SetParm( ksGpuGraphicsCommand * command, const int index, const void * pointer )
+{
+	assert( index >= 0 && index < MAX_PROGRAM_PARMS );
+	command->parmState.parms[index] = pointer;
+}
+
+static void ksGpuGraphicsCommand_SetParmTextureSampled( ksGpuGraphicsCommand * command, const int index, const ksGpuTexture * texture )		{ ksGpuGraphicsCommand_SetParm( command, index, texture ); }
+static void ksGpuGraphicsCommand_SetParmBufferUniform( ksGpuGraphicsCommand * command, const int index, const ksGpuBuffer * buffer )		{ ksGpuGraphicsCommand_SetParm( command, index, buffer ); }
+static void ksGpuGraphicsCommand_SetParmInt( ksGpuGraphicsCommand * command, const int index, const int * value )							{ ksGpuGraphicsCommand_SetParm( command, index, value ); }
+static void ksGpuGraphicsCommand_SetParmIntVector2( ksGpuGraphicsCommand * command, const int index, const ksVector2i * value )				{ ksGpuGraphicsCommand_SetParm( command, index, value ); }
+static void ksGpuGraphicsCommand_SetParmIntVector3( ksGpuGraphicsCommand * command, const int index, const ksVector3i * value )				{ ksGpuGraphicsCommand_SetParm( command, index, value ); }
+static void ksGpuGraphicsCommand_SetParmIntVector4( ksGpuGraphicsCommand * command, const int index, const ksVector4i * value )				{ ksGpuGraphicsCommand_SetParm( command, index, value ); }
+static void ksGpuGraphicsCommand_SetParmFloat( ksGpuGraphicsCommand * command, const int index, const float * value )						{ ksGpuGraphicsCommand_SetParm( command, index, value ); }
+static void ksGpuGraphicsCommand_SetParmFloatVector2( ksGpuGraphicsCommand * command, const int index, const ksVector2f * value )			{ ksGpuGraphicsCommand_SetParm( command, index, value ); }
+static void ksGpuGraphicsCommand_SetParmFloatVector3( ksGpuGraphicsCommand * command, const int index, const ksVector3f * value )			{ ksGpuGraphicsCommand_SetParm( command, index, value ); }
+static void ksGpuGraphicsCommand_SetParmFloatVector4( ksGpuGraphicsCommand * command, const int index, const ksVector4f * value )			{ ksGpuGraphicsCommand_SetParm( command, index, value ); }
+static void ksGpuGraphicsCommand_SetParmFloatMatrix2x2( ksGpuGraphicsCommand * command, const int index, const ksMatrix2x2f * value )		{ ksGpuGraphicsCommand_SetParm( command, index, value ); }
+static void ksGpuGraphicsCommand_SetParmFloatMatrix2x3( ksGpuGraphicsCommand * command, const int index, const ksMatrix2x3f * value )		{ ksGpuGraphicsCommand_SetParm( command, index, value ); }
+static void ksGpuGraphicsCommand_SetParmFloatMatrix2x4( ksGpuGraphicsCommand * command, const int index, const ksMatrix2x4f * value )		{ ksGpuGraphicsCommand_SetParm( command, index, value ); }
+static void ksGpuGraphicsCommand_SetParmFloatMatrix3x2( ksGpuGraphicsCommand * command, const int index, const ksMatrix3x2f * value )		{ ksGpuGraphicsCommand_SetParm( command, index, value ); }
+static void ksGpuGraphicsCommand_SetParmFloatMatrix3x3( ksGpuGraphicsCommand * command, const int index, const ksMatrix3x3f * value )		{ ksGpuGraphicsCommand_SetParm( command, index, value ); }
+static void ksGpuGraphicsCommand_SetParmFloatMatrix3x4( ksGpuGraphicsCommand * command, const int index, const ksMatrix3x4f * value )		{ ksGpuGraphicsCommand_SetParm( command, index, value ); }
+static void ksGpuGraphicsCommand_SetParmFloatMatrix4x2( ksGpuGraphicsCommand * command, const int index, const ksMatrix4x2f * value )		{ ksGpuGraphicsCommand_SetParm( command, index, value ); }
+static void ksGpuGraphicsCommand_SetParmFloatMatrix4x3( ksGpuGraphicsCommand * command, const int index, const ksMatrix4x3f * value )		{ ksGpuGraphicsCommand_SetParm( command, index, value ); }
+static void ksGpuGraphicsCommand_SetParmFloatMatrix4x4( ksGpuGraphicsCommand * command, const int index, const ksMatrix4x4f * value )		{ ksGpuGraphicsCommand_SetParm( command, index, value ); }
+
+/*
+================================
+Command buffer
+================================
+*/
+
+typedef enum
+{
+	KS_GPU_BUFFER_UNMAP_TYPE_USE_ALLOCATED,		// use the newly allocated (host visible) buffer
+	KS_GPU_BUFFER_UNMAP_TYPE_COPY_BACK			// copy back to the original buffer
+} ksGpuBufferUnmapType;
+
+typedef struct ksGpuCommandBuffer
+{
+	// Called for every submitted graphics command when not NULL.
+	void					(*submitGraphicsCommand)( struct ksGpuCommandBuffer * commandBuffer, const ksGpuGraphicsCommand * command );
+	void *					userData;
+	int						graphicsCommandCount;
+} ksGpuCommandBuffer;
+
+// Buffers are mapped in place.
+static ksGpuBuffer * ksGpuCommandBuffer_MapBuffer( ksGpuCommandBuffer * commandBuffer, ksGpuBuffer * buffer, void ** data )
+{
+	UNUSED_PARM( commandBuffer );
+
+	*data = buffer->data;
+	return buffer;
+}
+
+static void ksGpuCommandBuffer_UnmapBuffer( ksGpuCommandBuffer * commandBuffer, ksGpuBuffer * buffer, ksGpuBuffer * mappedBuffer, const ksGpuBufferUnmapType type )
+{
+	UNUSED_PARM( commandBuffer );
+	UNUSED_PARM( buffer );
+	UNUSED_PARM( mappedBuffer );
+	UNUSED_PARM( type );
+
+	assert( mappedBuffer == buffer );
+}
+
+static void ksGpuCommandBuffer_SubmitGraphicsCommand( ksGpuCommandBuffer * commandBuffer, const ksGpuGraphicsCommand * command )
+{
+	assert( command->pipeline != NULL );
+	commandBuffer->graphicsCommandCount++;
+	if ( commandBuffer->submitGraphicsCommand != NULL )
+	{
+		commandBuffer->submitGraphicsCommand( commandBuffer, command );
+	}
+}
+
+#endif // !KSGPU_STUB_H
@@ -0,0 +1,1150 @@
+/*
+================================================================================================
+
+Description	:	Verifies the loading of glTF 2.0 scenes by scene_gltf.h.
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+
+The scenes are generated with gltf_builder.h and loaded headless with gpu_stub.h. The vertex
+and index data that would be uploaded to the GPU is read back from the stub buffers and the
+triangles are compared against the source data, one index at a time.
+
+The same scene is loaded from a .gltf with a separate .bin and from a binary .glb container and
+must produce identical geometry. Primitives with more vertices than 16-bit indices can address
+must be split into surfaces without losing or reordering triangles. STEP animations must hold
+each key frame, also when key frames are omitted by the compression, and CUBICSPLINE samplers
+must not change the output accessor they share with other samplers. Disabled animations must
+hold their nodes at the last pose.
+
+A scene that is baked to a cache and loaded back from the cache must have the same nodes,
+skins, surfaces, packed vertex and index buffers and compressed key frames, and must simulate
+bit-identical poses. A truncated cache, a cache with a relocation outside the relocated data
+and a cache of source files that changed must be rejected and baked again.
+
+Simulating a scene with a large sub-tree that is transformed one depth level at a time and a
+number of small independent sub-trees must give bit-identical global transforms without worker
+threads and with worker threads.
+
+Rendering with a mock submit must draw every visible surface once, cull surfaces outside the
+view and hidden sub-trees, and report the same draws and binds as were submitted.
+
+	test_gltf
+
+================================================================================================
+*/
+
+#include "gpu_stub.h"
+#include "scenes/scene_settings.h"
+#include "scenes/scene_view_state.h"
+#include "scenes/scene_gltf.h"
+#include "gltf_builder.h"
+#include "../test.h"
+
+#if defined( OS_WINDOWS )
+	#include <sys/utime.h>
+	#define utime		_utime
+	#define utimbuf		_utimbuf
+#else
+	#include <utime.h>
+#endif
+
+static ksGpuContext context;
+static ksGpuRenderPass renderPass;
+
+static bool LoadScene( ksGltfScene * scene, const char * fileName, const char * cacheFileName )
+{
+	ksSceneSettings settings;
+	ksSceneSettings_Init( &context, &settings );
+	ksSceneSettings_SetGltf( &settings, fileName );
+	ksSceneSettings_SetGltfCache( &settings, cacheFileName );
+	memset( scene, 0, sizeof( ksGltfScene ) );
+	return ksGltfScene_CreateFromFile( &context, scene, &settings, &renderPass );
+}
+
+static const ksGltfModel * GetModel( const ksGltfScene * scene, const char * name )
+{
+	for ( int modelIndex = 0; modelIndex < scene->modelCount; modelIndex++ )
+	{
+		if ( strcmp( scene->models[modelIndex].name, name ) == 0 )
+		{
+			return &scene->models[modelIndex];
+		}
+	}
+	return NULL;
+}
+
+static const ksVector3f * GetPosition( const ksGpuGeometry * geometry, const int index )
+{
+	return (const ksVector3f *) ksGpuGeometry_GetAttribute( geometry, VERTEX_ATTRIBUTE_FLAG_POSITION, ksGpuGeometry_GetVertexIndex( geometry, index ) );
+}
+
+// Compares every attribute of every index of two surfaces.
+static bool IsSameSurfaceStream( const ksGpuGeometry * a, const ksGpuGeometry * b )
+{
+	if ( a->indexCount != b->indexCount || a->vertexAttribsFlags != b->vertexAttribsFlags )
+	{
+		return false;
+	}
+	for ( int i = 0; a->layout[i].attributeFlag != 0; i++ )
+	{
+		const ksGpuVertexAttribute * v = &a->layout[i];
+		if ( ( v->attributeFlag & a->vertexAttribsFlags ) == 0 )
+		{
+			continue;
+		}
+		for ( int index = 0; index < a->indexCount; index++ )
+		{
+			const void * elementA = ksGpuGeometry_GetAttribute( a, v->attributeFlag, ksGpuGeometry_GetVertexIndex( a, index ) );
+			const void * elementB = ksGpuGeometry_GetAttribute( b, v->attributeFlag, ksGpuGeometry_GetVertexIndex( b, index ) );
+			if ( elementB == NULL || memcmp( elementA, elementB, v->attributeSize ) != 0 )
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+static bool IsSameVector3( const ksVector3f * v, const float x, const float y, const float z, const float epsilon )
+{
+	return fabsf( v->x - x ) <= epsilon && fabsf( v->y - y ) <= epsilon && fabsf( v->z - z ) <= epsilon;
+}
+
+// A quad with interleaved positions and normals, normalized 16-bit texture coordinates and 8-bit indices,
+// and a non-indexed triangle with a sparse position accessor, in a small node hierarchy.
+static void BuildSmallScene( GltfBuilder * builder )
+{
+	const float quadVertices[4][6] =
+	{
+		{ 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f },
+		{ 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f },
+		{ 1.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f },
+		{ 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f }
+	};
+	const int interleaved = GltfBuilder_AddBufferView( builder, quadVertices, sizeof( quadVertices ), 6 * sizeof( float ) );
+	const float quadMins[3] = { 0.0f, 0.0f, 0.0f };
+	const float quadMaxs[3] = { 1.0f, 1.0f, 0.0f };
+	GltfBuilder_SetAccessorBounds( GltfBuilder_AddAccessor( builder, interleaved, 0, GLTF_BUILDER_FLOAT, 4, 3 ), quadMins, quadMaxs, 3 );
+	const int quadPosition = ksJson_GetMemberCount( builder->accessors ) - 1;
+	GltfBuilder_AddAccessor( builder, interleaved, 3 * sizeof( float ), GLTF_BUILDER_FLOAT, 4, 3 );
+	const int quadNormal = ksJson_GetMemberCount( builder->accessors ) - 1;
+	const uint16_t quadUvs[4][2] = { { 0, 0 }, { 65535, 0 }, { 65535, 65535 }, { 0, 65535 } };
+	ksJson * uvAccessor = GltfBuilder_AddAccessor( builder, GltfBuilder_AddBufferView( builder, quadUvs, sizeof( quadUvs ), 0 ), 0, GLTF_BUILDER_UNSIGNED_SHORT, 4, 2 );
+	ksJson_SetBoolean( ksJson_AddObjectMember( uvAccessor, "normalized" ), true );
+	const int quadUv = ksJson_GetMemberCount( builder->accessors ) - 1;
+	const uint32_t quadIndices[6] = { 0, 1, 2, 0, 2, 3 };
+	const int quadIndex = GltfBuilder_AddIndices( builder, quadIndices, 6, GLTF_BUILDER_UNSIGNED_BYTE );
+
+	const float triangleVertices[3][3] = { { 0.0f, 0.0f, 0.0f }, { 2.0f, 0.0f, 0.0f }, { 0.0f, 2.0f, 0.0f } };
+	const float triangleMins[3] = { 0.0f, 0.0f, 0.0f };
+	const float triangleMaxs[3] = { 2.0f, 3.0f, 0.0f };
+	const int triangleView = GltfBuilder_AddBufferView( builder, triangleVertices, sizeof( triangleVertices ), 0 );
+	GltfBuilder_SetAccessorBounds( GltfBuilder_AddAccessor( builder, triangleView, 0, GLTF_BUILDER_FLOAT, 3, 3 ), triangleMins, triangleMaxs, 3 );
+	const int trianglePosition = ksJson_GetMemberCount( builder->accessors ) - 1;
+	const uint16_t sparseIndex = 2;
+	const float sparseValue[3] = { 0.0f, 3.0f, 0.0f };
+	ksJson * sparse = ksJson_SetObject( ksJson_AddObjectMember( ksJson_GetMemberByIndex( builder->accessors, trianglePosition ), "sparse" ) );
+	ksJson_SetInt32( ksJson_AddObjectMember( sparse, "count" ), 1 );
+	ksJson * sparseIndices = ksJson_SetObject( ksJson_AddObjectMember( sparse, "indices" ) );
+	ksJson_SetInt32( ksJson_AddObjectMember( sparseIndices, "bufferView" ), GltfBuilder_AddBufferView( builder, &sparseIndex, sizeof( sparseIndex ), 0 ) );
+	ksJson_SetInt32( ksJson_AddObjectMember( sparseIndices, "componentType" ), GLTF_BUILDER_UNSIGNED_SHORT );
+	ksJson * sparseValues = ksJson_SetObject( ksJson_AddObjectMember( sparse, "values" ) );
+	ksJson_SetInt32( ksJson_AddObjectMember( sparseValues, "bufferView" ), GltfBuilder_AddBufferView( builder, sparseValue, sizeof( sparseValue ), 0 ) );
+
+	const int quadMesh = GltfBuilder_AddMesh( builder, "quad", 4, quadPosition, quadNormal, quadUv, -1, -1, quadIndex );
+	const int triangleMesh = GltfBuilder_AddMesh( builder, "triangle", 4, trianglePosition, -1, -1, -1, -1, -1 );
+	const int linesMesh = GltfBuilder_AddMesh( builder, "lines", 1, trianglePosition, -1, -1, -1, -1, -1 );
+
+	const float quadTranslation[3] = { 0.0f, 0.0f, -2.0f };
+	const int root = GltfBuilder_AddNode( builder, "root", -1, -1, NULL );
+	GltfBuilder_AddNode( builder, "quad", root, quadMesh, quadTranslation );
+	GltfBuilder_AddNode( builder, "triangle", root, triangleMesh, NULL );
+	GltfBuilder_AddNode( builder, "lines", root, linesMesh, NULL );
+}
+
+static void TestLoad()
+{
+	GltfBuilder builder;
+	GltfBuilder_Create( &builder );
+	BuildSmallScene( &builder );
+	TEST_CHECK( GltfBuilder_Write( &builder, "test_gltf.gltf", "test_gltf.bin" ) );
+	TEST_CHECK( GltfBuilder_WriteBinary( &builder, "test_gltf.glb" ) );
+	GltfBuilder_Destroy( &builder );
+
+	ksGltfScene scene;
+	if ( !TEST_CHECK( LoadScene( &scene, "test_gltf.gltf", NULL ) ) )
+	{
+		return;
+	}
+
+	TEST_CHECK( scene.nodeCount == 4 );
+	const int quadNode = ksGltfScene_GetNodeHandle( &scene, "quad" );
+	const int rootNode = ksGltfScene_GetNodeHandle( &scene, "root" );
+	TEST_CHECK( quadNode >= 0 && rootNode >= 0 );
+	if ( quadNode >= 0 && rootNode >= 0 )
+	{
+		TEST_CHECK( scene.nodes[quadNode].parent == &scene.nodes[rootNode] );
+		TEST_CHECK( scene.state.nodeState.transforms.translation[2][quadNode] == -2.0f );
+	}
+
+	// The lines primitive is skipped.
+	const ksGltfModel * quad = GetModel( &scene, "quad" );
+	const ksGltfModel * triangle = GetModel( &scene, "triangle" );
+	const ksGltfModel * lines = GetModel( &scene, "lines" );
+	if ( TEST_CHECK( quad != NULL && triangle != NULL && lines != NULL ) )
+	{
+		TEST_CHECK( lines->surfaceCount == 0 );
+		TEST_CHECK( quad->surfaceCount == 1 && triangle->surfaceCount == 1 );
+	}
+	if ( quad != NULL && quad->surfaceCount == 1 )
+	{
+		const ksGpuGeometry * geometry = &quad->surfaces[0].geometry;
+		const uint32_t expected[6] = { 0, 1, 2, 0, 2, 3 };
+		TEST_CHECK( geometry->indexCount == 6 && geometry->vertexCount == 4 );
+		for ( int i = 0; i < 6 && i < geometry->indexCount; i++ )
+		{
+			const int vertex = ksGpuGeometry_GetVertexIndex( geometry, i );
+			const ksVector3f * position = GetPosition( geometry, i );
+			const ksVector3f * normal = (const ksVector3f *) ksGpuGeometry_GetAttribute( geometry, VERTEX_ATTRIBUTE_FLAG_NORMAL, vertex );
+			const ksVector2f * uv = (const ksVector2f *) ksGpuGeometry_GetAttribute( geometry, VERTEX_ATTRIBUTE_FLAG_UV0, vertex );
+			const float x = ( expected[i] == 1 || expected[i] == 2 ) ? 1.0f : 0.0f;
+			const float y = ( expected[i] >= 2 ) ? 1.0f : 0.0f;
+			TEST_CHECK( IsSameVector3( position, x, y, 0.0f, 0.0f ) );
+			TEST_CHECK( normal != NULL && IsSameVector3( normal, 0.0f, 0.0f, 1.0f, 0.0f ) );
+			TEST_CHECK( uv != NULL && uv->x == x && uv->y == y );
+		}
+	}
+	if ( triangle != NULL && triangle->surfaceCount == 1 )
+	{
+		const ksGpuGeometry * geometry = &triangle->surfaces[0].geometry;
+		TEST_CHECK( geometry->indexCount == 3 );
+		TEST_CHECK( IsSameVector3( GetPosition( geometry, 1 ), 2.0f, 0.0f, 0.0f, 0.0f ) );
+		TEST_CHECK( IsSameVector3( GetPosition( geometry, 2 ), 0.0f, 3.0f, 0.0f, 0.0f ) );
+		TEST_CHECK( triangle->surfaces[0].maxs.y == 3.0f );
+	}
+
+	// The binary container must load the same scene.
+	ksGltfScene binaryScene;
+	if ( TEST_CHECK( LoadScene( &binaryScene, "test_gltf.glb", NULL ) ) )
+	{
+		TEST_CHECK( binaryScene.modelCount == scene.modelCount && binaryScene.nodeCount == scene.nodeCount );
+		for ( int modelIndex = 0; modelIndex < scene.modelCount && modelIndex < binaryScene.modelCount; modelIndex++ )
+		{
+			const ksGltfModel * model = &scene.models[modelIndex];
+			const ksGltfModel * binaryModel = &binaryScene.models[modelIndex];
+			TEST_CHECK( strcmp( model->name, binaryModel->name ) == 0 && model->surfaceCount == binaryModel->surfaceCount );
+			for ( int surfaceIndex = 0; surfaceIndex < model->surfaceCount && surfaceIndex < binaryModel->surfaceCount; surfaceIndex++ )
+			{
+				TEST_CHECK( IsSameSurfaceStream( &model->surfaces[surfaceIndex].geometry, &binaryModel->surfaces[surfaceIndex].geometry ) );
+			}
+		}
+		ksGltfScene_Destroy( &context, &binaryScene );
+	}
+
+	ksGltfScene_Destroy( &context, &scene );
+	remove( "test_gltf.gltf" );
+	remove( "test_gltf.bin" );
+	remove( "test_gltf.glb" );
+}
+
+// A grid with more vertices than 16-bit indices can address, once indexed and once as a triangle soup.
+static void TestSplitPrimitive()
+{
+	const int size = 300;
+	const int vertexCount = size * size;
+	const int indexCount = ( size - 1 ) * ( size - 1 ) * 6;
+	float * vertices = (float *) malloc( vertexCount * 6 * sizeof( float ) );
+	for ( int i = 0; i < vertexCount; i++ )
+	{
+		vertices[i * 6 + 0] = (float)( i % size );
+		vertices[i * 6 + 1] = (float)( i / size );
+		vertices[i * 6 + 2] = 0.0f;
+		vertices[i * 6 + 3] = (float)( i % size ) / size;
+		vertices[i * 6 + 4] = (float)( i / size ) / size;
+		vertices[i * 6 + 5] = 1.0f;
+	}
+	uint32_t * indices = (uint32_t *) malloc( indexCount * sizeof( uint32_t ) );
+	for ( int y = 0, index = 0; y < size - 1; y++ )
+	{
+		for ( int x = 0; x < size - 1; x++ )
+		{
+			const uint32_t v = y * size + x;
+			const uint32_t quad[6] = { v, v + 1, v + size + 1, v, v + size + 1, v + size };
+			memcpy( &indices[index], quad, sizeof( quad ) );
+			index += 6;
+		}
+	}
+	// The triangle soup uses the first triangles of the grid.
+	const int soupVertexCount = 70002;
+	float * soup = (float *) malloc( soupVertexCount * 3 * sizeof( float ) );
+	for ( int i = 0; i < soupVertexCount; i++ )
+	{
+		memcpy( &soup[i * 3], &vertices[indices[i] * 6], 3 * sizeof( float ) );
+	}
+
+	GltfBuilder builder;
+	GltfBuilder_Create( &builder );
+	const int interleaved = GltfBuilder_AddBufferView( &builder, vertices, vertexCount * 6 * sizeof( float ), 6 * sizeof( float ) );
+	const float mins[3] = { 0.0f, 0.0f, 0.0f };
+	const float maxs[3] = { (float)( size - 1 ), (float)( size - 1 ), 0.0f };
+	GltfBuilder_SetAccessorBounds( GltfBuilder_AddAccessor( &builder, interleaved, 0, GLTF_BUILDER_FLOAT, vertexCount, 3 ), mins, maxs, 3 );
+	const int position = ksJson_GetMemberCount( builder.accessors ) - 1;
+	GltfBuilder_AddAccessor( &builder, interleaved, 3 * sizeof( float ), GLTF_BUILDER_FLOAT, vertexCount, 3 );
+	const int normal = ksJson_GetMemberCount( builder.accessors ) - 1;
+	const int index = GltfBuilder_AddIndices( &builder, indices, indexCount, GLTF_BUILDER_UNSIGNED_INT );
+	const int soupPosition = GltfBuilder_AddFloats( &builder, soup, soupVertexCount, 3 );
+	GltfBuilder_AddNode( &builder, "grid", -1, GltfBuilder_AddMesh( &builder, "grid", 4, position, normal, -1, -1, -1, index ), NULL );
+	GltfBuilder_AddNode( &builder, "soup", -1, GltfBuilder_AddMesh( &builder, "soup", 4, soupPosition, -1, -1, -1, -1, -1 ), NULL );
+	TEST_CHECK( GltfBuilder_WriteBinary( &builder, "test_gltf_split.glb" ) );
+	GltfBuilder_Destroy( &builder );
+
+	ksGltfScene scene;
+	if ( TEST_CHECK( LoadScene( &scene, "test_gltf_split.glb", NULL ) ) )
+	{
+		const ksGltfModel * grid = GetModel( &scene, "grid" );
+		if ( TEST_CHECK( grid != NULL && grid->surfaceCount > 1 ) )
+		{
+			// The split surfaces must reproduce the triangles in order.
+			int index = 0;
+			bool same = true;
+			for ( int surfaceIndex = 0; surfaceIndex < grid->surfaceCount; surfaceIndex++ )
+			{
+				const ksGltfSurface * surface = &grid->surfaces[surfaceIndex];
+				const ksGpuGeometry * geometry = &surface->geometry;
+				TEST_CHECK( geometry->vertexCount <= 65536 );
+				TEST_CHECK( surface->mins.x >= 0.0f && surface->maxs.y <= (float)( size - 1 ) && surface->mins.y <= surface->maxs.y );
+				for ( int i = 0; i < geometry->indexCount && index < indexCount; i++, index++ )
+				{
+					const int vertex = ksGpuGeometry_GetVertexIndex( geometry, i );
+					const float * expected = &vertices[indices[index] * 6];
+					same &= ( memcmp( ksGpuGeometry_GetAttribute( geometry, VERTEX_ATTRIBUTE_FLAG_POSITION, vertex ), expected + 0, 3 * sizeof( float ) ) == 0 );
+					same &= ( memcmp( ksGpuGeometry_GetAttribute( geometry, VERTEX_ATTRIBUTE_FLAG_NORMAL, vertex ), expected + 3, 3 * sizeof( float ) ) == 0 );
+				}
+			}
+			TEST_CHECK( same );
+			TEST_CHECK( index == indexCount );
+			TEST_CHECK( IsSameVector3( &grid->mins, mins[0], mins[1], mins[2], 0.0f ) );
+			TEST_CHECK( IsSameVector3( &grid->maxs, maxs[0], maxs[1], maxs[2], 0.0f ) );
+		}
+
+		const ksGltfModel * soupModel = GetModel( &scene, "soup" );
+		if ( TEST_CHECK( soupModel != NULL && soupModel->surfaceCount > 1 ) )
+		{
+			int index = 0;
+			bool same = true;
+			for ( int surfaceIndex = 0; surfaceIndex < soupModel->surfaceCount; surfaceIndex++ )
+			{
+				const ksGpuGeometry * geometry = &soupModel->surfaces[surfaceIndex].geometry;
+				for ( int i = 0; i < geometry->indexCount && index < soupVertexCount; i++, index++ )
+				{
+					same &= ( memcmp( GetPosition( geometry, i ), &soup[index * 3], 3 * sizeof( float ) ) == 0 );
+				}
+			}
+			TEST_CHECK( same );
+			TEST_CHECK( index == soupVertexCount );
+		}
+		ksGltfScene_Destroy( &context, &scene );
+	}
+	remove( "test_gltf_split.glb" );
+
+	free( soup );
+	free( indices );
+	free( vertices );
+}
+
+static float GetNodeTranslationX( const ksGltfScene * scene, const char * nodeName )
+{
+	const int node = ksGltfScene_GetNodeHandle( scene, nodeName );
+	return ( node >= 0 ) ? scene->state.nodeState.transforms.translation[0][node] : -1.0f;
+}
+
+static void TestAnimationSamplers()
+{
+	GltfBuilder builder;
+	GltfBuilder_Create( &builder );
+
+	// A fixed-rate time-line where the value holds for runs of 10 key frames, such that the compression omits key frames.
+	const int fixedCount = 31;
+	float fixedTimes[31];
+	float fixedValues[31][3];
+	for ( int i = 0; i < fixedCount; i++ )
+	{
+		fixedTimes[i] = i / 30.0f;
+		fixedValues[i][0] = (float)( i / 10 );
+		fixedValues[i][1] = 0.0f;
+		fixedValues[i][2] = 0.0f;
+	}
+	const int fixedInput = GltfBuilder_AddFloats( &builder, fixedTimes, fixedCount, 1 );
+	const int fixedOutput = GltfBuilder_AddFloats( &builder, &fixedValues[0][0], fixedCount, 3 );
+
+	// A variable-rate time-line.
+	const float variableTimes[4] = { 0.0f, 0.25f, 0.75f, 1.0f };
+	const float variableValues[4][3] = { { 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, { 5.0f, 0.0f, 0.0f }, { 2.0f, 0.0f, 0.0f } };
+	const int variableInput = GltfBuilder_AddFloats( &builder, variableTimes, 4, 1 );
+	const int variableOutput = GltfBuilder_AddFloats( &builder, &variableValues[0][0], 4, 3 );
+
+	// Spline values with in-tangents and out-tangents that must be ignored.
+	const float splineTimes[3] = { 0.0f, 0.5f, 1.0f };
+	float splineValues[9][3];
+	for ( int i = 0; i < 9; i++ )
+	{
+		const bool value = ( i % 3 ) == 1;
+		splineValues[i][0] = value ? (float)( i / 3 ) : 99.0f;
+		splineValues[i][1] = value ? (float)( 2 * ( i / 3 ) ) : -99.0f;
+		splineValues[i][2] = 0.0f;
+	}
+	const int splineInput = GltfBuilder_AddFloats( &builder, splineTimes, 3, 1 );
+	const int splineOutput = GltfBuilder_AddFloats( &builder, &splineValues[0][0], 9, 3 );
+
+	const char * nodeNames[] = { "stepFixed", "linearFixed", "stepVariable", "splineA", "splineB" };
+	int nodes[ARRAY_SIZE( nodeNames )];
+	for ( int i = 0; i < (int)ARRAY_SIZE( nodeNames ); i++ )
+	{
+		nodes[i] = GltfBuilder_AddNode( &builder, nodeNames[i], -1, -1, NULL );
+	}
+	GltfBuilder_AddChannel( &builder, nodes[0], "translation", fixedInput, fixedOutput, "STEP" );
+	GltfBuilder_AddChannel( &builder, nodes[1], "translation", fixedInput, fixedOutput, "LINEAR" );
+	GltfBuilder_AddChannel( &builder, nodes[2], "translation", variableInput, variableOutput, "STEP" );
+	GltfBuilder_AddChannel( &builder, nodes[3], "translation", splineInput, splineOutput, "CUBICSPLINE" );
+	GltfBuilder_AddChannel( &builder, nodes[4], "translation", splineInput, splineOutput, "CUBICSPLINE" );
+	TEST_CHECK( GltfBuilder_WriteBinary( &builder, "test_gltf_animation.glb" ) );
+	GltfBuilder_Destroy( &builder );
+
+	ksGltfScene scene;
+	if ( !TEST_CHECK( LoadScene( &scene, "test_gltf_animation.glb", NULL ) ) )
+	{
+		return;
+	}
+
+	// The output accessor shared by the spline samplers is not changed.
+	TEST_CHECK( scene.accessorCount > splineOutput && scene.accessors[splineOutput].count == 9 );
+
+	ksViewState viewState;
+	memset( &viewState, 0, sizeof( viewState ) );
+
+	// Sample in the middle of every fixed-rate frame.
+	bool stepHolds = true;
+	bool linearInterpolates = true;
+	for ( int frame = 0; frame < fixedCount - 1; frame++ )
+	{
+		ksGltfScene_Simulate( &scene, &viewState, NULL, (ksNanoseconds)( ( frame + 0.5 ) / 30.0 * 1e9 ) );
+		const float step = (float)( frame / 10 );
+		const float linear = ( frame % 10 == 9 ) ? step + 0.5f : step;
+		stepHolds &= ( fabsf( GetNodeTranslationX( &scene, "stepFixed" ) - step ) < 1e-3f );
+		linearInterpolates &= ( fabsf( GetNodeTranslationX( &scene, "linearFixed" ) - linear ) < 1e-3f );
+	}
+	TEST_CHECK( stepHolds );
+	TEST_CHECK( linearInterpolates );
+
+	const double variableSampleTimes[3] = { 0.2, 0.5, 0.9 };
+	const float variableSampleValues[3] = { 0.0f, 1.0f, 5.0f };
+	for ( int i = 0; i < 3; i++ )
+	{
+		ksGltfScene_Simulate( &scene, &viewState, NULL, (ksNanoseconds)( variableSampleTimes[i] * 1e9 ) );
+		TEST_CHECK( fabsf( GetNodeTranslationX( &scene, "stepVariable" ) - variableSampleValues[i] ) < 1e-3f );
+	}
+
+	ksGltfScene_Simulate( &scene, &viewState, NULL, (ksNanoseconds)( 0.75 * 1e9 ) );
+	for ( int i = 3; i < 5; i++ )
+	{
+		const int node = ksGltfScene_GetNodeHandle( &scene, nodeNames[i] );
+		const ksVector3f t = { scene.state.nodeState.transforms.translation[0][node], scene.state.nodeState.transforms.translation[1][node], scene.state.nodeState.transforms.translation[2][node] };
+		TEST_CHECK( IsSameVector3( &t, 1.5f, 3.0f, 0.0f, 1e-3f ) );
+	}
+
+	// Disabled animations hold the nodes at their last pose until they are enabled again.
+	for ( int animationHandle = 0; animationHandle < scene.animationCount; animationHandle++ )
+	{
+		ksGltfScene_SetAnimationEnabledByHandle( &scene, animationHandle, false );
+	}
+	ksGltfScene_Simulate( &scene, &viewState, NULL, (ksNanoseconds)( 0.2 * 1e9 ) );
+	TEST_CHECK( fabsf( GetNodeTranslationX( &scene, "stepVariable" ) - 5.0f ) < 1e-3f );
+	TEST_CHECK( fabsf( GetNodeTranslationX( &scene, "splineA" ) - 1.5f ) < 1e-3f );
+	for ( int animationHandle = 0; animationHandle < scene.animationCount; animationHandle++ )
+	{
+		ksGltfScene_SetAnimationEnabledByHandle( &scene, animationHandle, true );
+	}
+	ksGltfScene_Simulate( &scene, &viewState, NULL, (ksNanoseconds)( 0.2 * 1e9 ) );
+	TEST_CHECK( fabsf( GetNodeTranslationX( &scene, "stepVariable" ) - 0.0f ) < 1e-3f );
+
+	ksGltfScene_Destroy( &context, &scene );
+	remove( "test_gltf_animation.glb" );
+}
+
+// A skinned mesh, two meshes that share their accessors, a node hierarchy with joints,
+// and LINEAR, STEP and CUBICSPLINE animations of translations, rotations and scales.
+static void BuildBakeScene( GltfBuilder * builder )
+{
+	const float quadPositions[4][3] = { { 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } };
+	const float quadNormals[4][3] = { { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, 1.0f } };
+	const uint32_t quadIndices[6] = { 0, 1, 2, 0, 2, 3 };
+	const int quadPosition = GltfBuilder_AddFloats( builder, &quadPositions[0][0], 4, 3 );
+	const int quadNormal = GltfBuilder_AddFloats( builder, &quadNormals[0][0], 4, 3 );
+	const int quadIndex = GltfBuilder_AddIndices( builder, quadIndices, 6, GLTF_BUILDER_UNSIGNED_SHORT );
+
+	const float limbPositions[6][3] = { { 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 1.0f, 1.0f, 0.0f }, { 0.0f, 2.0f, 0.0f }, { 1.0f, 2.0f, 0.0f } };
+	const uint8_t limbJoints[6][4] = { { 0, 1, 0, 0 }, { 0, 1, 0, 0 }, { 1, 2, 0, 0 }, { 1, 2, 0, 0 }, { 2, 0, 0, 0 }, { 2, 0, 0, 0 } };
+	const float limbWeights[6][4] = { { 0.75f, 0.25f, 0.0f, 0.0f }, { 0.75f, 0.25f, 0.0f, 0.0f }, { 0.5f, 0.5f, 0.0f, 0.0f }, { 0.5f, 0.5f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f, 0.0f } };
+	const uint32_t limbIndices[12] = { 0, 1, 3, 0, 3, 2, 2, 3, 5, 2, 5, 4 };
+	const int limbPosition = GltfBuilder_AddFloats( builder, &limbPositions[0][0], 6, 3 );
+	GltfBuilder_AddAccessor( builder, GltfBuilder_AddBufferView( builder, limbJoints, sizeof( limbJoints ), 0 ), 0, GLTF_BUILDER_UNSIGNED_BYTE, 6, 4 );
+	const int limbJoint = ksJson_GetMemberCount( builder->accessors ) - 1;
+	const int limbWeight = GltfBuilder_AddFloats( builder, &limbWeights[0][0], 6, 4 );
+	const int limbIndex = GltfBuilder_AddIndices( builder, limbIndices, 12, GLTF_BUILDER_UNSIGNED_BYTE );
+
+	float inverseBindMatrices[3][16];
+	for ( int joint = 0; joint < 3; joint++ )
+	{
+		ksMatrix4x4f m;
+		ksMatrix4x4f_CreateTranslation( &m, 0.0f, -(float)joint, 0.0f );
+		memcpy( inverseBindMatrices[joint], m.m, sizeof( m.m ) );
+	}
+	const int inverseBind = GltfBuilder_AddFloats( builder, &inverseBindMatrices[0][0], 3, 16 );
+
+	const int quadMeshA = GltfBuilder_AddMesh( builder, "quadA", 4, quadPosition, quadNormal, -1, -1, -1, quadIndex );
+	const int quadMeshB = GltfBuilder_AddMesh( builder, "quadB", 4, quadPosition, quadNormal, -1, -1, -1, quadIndex );
+	const int limbMesh = GltfBuilder_AddMesh( builder, "limb", 4, limbPosition, -1, -1, limbJoint, limbWeight, limbIndex );
+
+	const float up[3] = { 0.0f, 1.0f, 0.0f };
+	const float right[3] = { 2.0f, 0.0f, 0.0f };
+	const int root = GltfBuilder_AddNode( builder, "root", -1, -1, NULL );
+	const int hips = GltfBuilder_AddNode( builder, "hips", root, -1, NULL );
+	const int spine = GltfBuilder_AddNode( builder, "spine", hips, -1, up );
+	const int head = GltfBuilder_AddNode( builder, "head", spine, -1, up );
+	const int body = GltfBuilder_AddNode( builder, "body", root, limbMesh, NULL );
+	GltfBuilder_AddNode( builder, "quadA", root, quadMeshA, right );
+	GltfBuilder_AddNode( builder, "quadB", hips, quadMeshB, up );
+	const int joints[3] = { hips, spine, head };
+	GltfBuilder_AddSkin( builder, "skin", body, joints, 3, inverseBind );
+
+	// A fixed-rate time-line with smooth curves and runs that are held, such that key frames are omitted.
+	const int keyCount = 31;
+	float times[31];
+	float translations[31][3];
+	float rotations[31][4];
+	float scales[31][3];
+	for ( int i = 0; i < keyCount; i++ )
+	{
+		const float angle = 0.05f * i;
+		times[i] = i / 30.0f;
+		translations[i][0] = sinf( angle );
+		translations[i][1] = ( i < 10 ) ? 0.0f : 0.1f * i;
+		translations[i][2] = 0.0f;
+		rotations[i][0] = 0.0f;
+		rotations[i][1] = 0.0f;
+		rotations[i][2] = sinf( angle * 0.5f );
+		rotations[i][3] = cosf( angle * 0.5f );
+		scales[i][0] = scales[i][1] = scales[i][2] = 1.0f + (float)( i / 8 ) * 0.25f;
+	}
+	const int input = GltfBuilder_AddFloats( builder, times, keyCount, 1 );
+	const int translationOutput = GltfBuilder_AddFloats( builder, &translations[0][0], keyCount, 3 );
+	const int rotationOutput = GltfBuilder_AddFloats( builder, &rotations[0][0], keyCount, 4 );
+	const int scaleOutput = GltfBuilder_AddFloats( builder, &scales[0][0], keyCount, 3 );
+
+	const float splineTimes[3] = { 0.0f, 0.5f, 1.0f };
+	const float splineValues[9][3] =
+	{
+		{ 9.0f, 9.0f, 9.0f }, { 0.0f, 0.0f, 0.0f }, { 9.0f, 9.0f, 9.0f },
+		{ 9.0f, 9.0f, 9.0f }, { 1.0f, 0.0f, 2.0f }, { 9.0f, 9.0f, 9.0f },
+		{ 9.0f, 9.0f, 9.0f }, { 0.0f, 0.0f, 4.0f }, { 9.0f, 9.0f, 9.0f }
+	};
+	const int splineInput = GltfBuilder_AddFloats( builder, splineTimes, 3, 1 );
+	const int splineOutput = GltfBuilder_AddFloats( builder, &splineValues[0][0], 9, 3 );
+
+	GltfBuilder_AddChannel( builder, hips, "translation", input, translationOutput, "LINEAR" );
+	GltfBuilder_AddChannel( builder, spine, "rotation", input, rotationOutput, "LINEAR" );
+	GltfBuilder_AddChannel( builder, head, "scale", input, scaleOutput, "STEP" );
+	GltfBuilder_AddChannel( builder, root, "translation", splineInput, splineOutput, "CUBICSPLINE" );
+}
+
+#define INDEX_OF( pointer, array )		( ( (pointer) != NULL ) ? (int)( (pointer) - (array) ) : -1 )
+
+static bool IsSameKeyFrames( const ksGltfCompressedKeyFrames * a, const ksGltfCompressedKeyFrames * b )
+{
+	return a->keyCount == b->keyCount &&
+			a->stepMask == b->stepMask &&
+			a->dataSize == b->dataSize &&
+			( a->translation == NULL ) == ( b->translation == NULL ) &&
+			( a->rotation == NULL ) == ( b->rotation == NULL ) &&
+			( a->scale == NULL ) == ( b->scale == NULL ) &&
+			( a->keyMask == NULL ) == ( b->keyMask == NULL ) &&
+			memcmp( &a->translationBias, &b->translationBias, sizeof( ksVector3f ) ) == 0 &&
+			memcmp( &a->translationStep, &b->translationStep, sizeof( ksVector3f ) ) == 0 &&
+			memcmp( &a->scaleBias, &b->scaleBias, sizeof( ksVector3f ) ) == 0 &&
+			memcmp( &a->scaleStep, &b->scaleStep, sizeof( ksVector3f ) ) == 0 &&
+			memcmp( a->data, b->data, a->dataSize ) == 0;
+}
+
+// Compares the run-time data of a scene loaded from the glTF with the same scene loaded from the baked cache.
+static void CompareScenes( ksGltfScene * a, ksGltfScene * b )
+{
+	if ( !TEST_CHECK( a->nodeCount == b->nodeCount ) )
+	{
+		return;
+	}
+	bool sameNodes = true;
+	for ( int nodeIndex = 0; nodeIndex < a->nodeCount; nodeIndex++ )
+	{
+		const ksGltfNode * nodeA = &a->nodes[nodeIndex];
+		const ksGltfNode * nodeB = &b->nodes[nodeIndex];
+		sameNodes &= ( strcmp( nodeA->name, nodeB->name ) == 0 );
+		sameNodes &= ( INDEX_OF( nodeA->parent, a->nodes ) == INDEX_OF( nodeB->parent, b->nodes ) );
+		sameNodes &= ( INDEX_OF( nodeA->skin, a->skins ) == INDEX_OF( nodeB->skin, b->skins ) );
+		sameNodes &= ( nodeA->childCount == nodeB->childCount && nodeA->modelCount == nodeB->modelCount );
+		sameNodes &= ( memcmp( &nodeA->rotation, &nodeB->rotation, sizeof( ksQuatf ) ) == 0 );
+		sameNodes &= ( memcmp( &nodeA->translation, &nodeB->translation, sizeof( ksVector3f ) ) == 0 );
+		sameNodes &= ( memcmp( &nodeA->scale, &nodeB->scale, sizeof( ksVector3f ) ) == 0 );
+		for ( int modelIndex = 0; modelIndex < nodeA->modelCount && modelIndex < nodeB->modelCount; modelIndex++ )
+		{
+			sameNodes &= ( INDEX_OF( nodeA->models[modelIndex], a->models ) == INDEX_OF( nodeB->models[modelIndex], b->models ) );
+		}
+		for ( int childIndex = 0; childIndex < nodeA->childCount && childIndex < nodeB->childCount; childIndex++ )
+		{
+			sameNodes &= ( INDEX_OF( nodeA->children[childIndex], a->nodes ) == INDEX_OF( nodeB->children[childIndex], b->nodes ) );
+		}
+	}
+	TEST_CHECK( sameNodes );
+
+	if ( TEST_CHECK( a->skinCount == b->skinCount ) )
+	{
+		for ( int skinIndex = 0; skinIndex < a->skinCount; skinIndex++ )
+		{
+			const ksGltfSkin * skinA = &a->skins[skinIndex];
+			const ksGltfSkin * skinB = &b->skins[skinIndex];
+			TEST_CHECK( strcmp( skinA->name, skinB->name ) == 0 && skinA->jointCount == skinB->jointCount );
+			TEST_CHECK( INDEX_OF( skinA->parentNode, a->nodes ) == INDEX_OF( skinB->parentNode, b->nodes ) );
+			for ( int jointIndex = 0; jointIndex < skinA->jointCount && jointIndex < skinB->jointCount; jointIndex++ )
+			{
+				TEST_CHECK( INDEX_OF( skinA->joints[jointIndex].node, a->nodes ) == INDEX_OF( skinB->joints[jointIndex].node, b->nodes ) );
+			}
+			TEST_CHECK( memcmp( skinA->inverseBindMatrices, skinB->inverseBindMatrices, skinA->jointCount * sizeof( ksMatrix4x4f ) ) == 0 );
+		}
+	}
+
+	if ( TEST_CHECK( a->modelCount == b->modelCount ) )
+	{
+		for ( int modelIndex = 0; modelIndex < a->modelCount; modelIndex++ )
+		{
+			const ksGltfModel * modelA = &a->models[modelIndex];
+			const ksGltfModel * modelB = &b->models[modelIndex];
+			TEST_CHECK( strcmp( modelA->name, modelB->name ) == 0 && modelA->surfaceCount == modelB->surfaceCount );
+			TEST_CHECK( memcmp( &modelA->mins, &modelB->mins, sizeof( ksVector3f ) ) == 0 && memcmp( &modelA->maxs, &modelB->maxs, sizeof( ksVector3f ) ) == 0 );
+			for ( int surfaceIndex = 0; surfaceIndex < modelA->surfaceCount && surfaceIndex < modelB->surfaceCount; surfaceIndex++ )
+			{
+				const ksGltfSurface * surfaceA = &modelA->surfaces[surfaceIndex];
+				const ksGltfSurface * surfaceB = &modelB->surfaces[surfaceIndex];
+				TEST_CHECK( INDEX_OF( surfaceA->material, a->materials ) == INDEX_OF( surfaceB->material, b->materials ) );
+				TEST_CHECK( INDEX_OF( surfaceA->geometryBuffer, a->geometryBuffers ) == INDEX_OF( surfaceB->geometryBuffer, b->geometryBuffers ) );
+				TEST_CHECK( surfaceA->firstIndex == surfaceB->firstIndex && surfaceA->indexCount == surfaceB->indexCount );
+				TEST_CHECK( surfaceA->vertexOffset == surfaceB->vertexOffset && surfaceA->vertexCount == surfaceB->vertexCount );
+				TEST_CHECK( memcmp( &surfaceA->mins, &surfaceB->mins, sizeof( ksVector3f ) ) == 0 && memcmp( &surfaceA->maxs, &surfaceB->maxs, sizeof( ksVector3f ) ) == 0 );
+				TEST_CHECK( IsSameSurfaceStream( &surfaceA->geometry, &surfaceB->geometry ) );
+			}
+		}
+	}
+
+	// The packed buffers are uploaded from the baked data and must match the buffers packed while loading.
+	TEST_CHECK( a->geometryIndexCount == b->geometryIndexCount );
+	if ( TEST_CHECK( a->geometryBufferCount == b->geometryBufferCount ) )
+	{
+		for ( int bufferIndex = 0; bufferIndex < a->geometryBufferCount; bufferIndex++ )
+		{
+			const ksGltfGeometryBuffer * bufferA = &a->geometryBuffers[bufferIndex];
+			const ksGltfGeometryBuffer * bufferB = &b->geometryBuffers[bufferIndex];
+			TEST_CHECK( bufferA->vertexAttribsFlags == bufferB->vertexAttribsFlags && bufferA->vertexCount == bufferB->vertexCount );
+			const ksGpuBuffer * vertexA = &bufferA->geometry.vertexBuffer;
+			const ksGpuBuffer * vertexB = &bufferB->geometry.vertexBuffer;
+			const ksGpuBuffer * indexA = &bufferA->geometry.indexBuffer;
+			const ksGpuBuffer * indexB = &bufferB->geometry.indexBuffer;
+			TEST_CHECK( vertexA->size == vertexB->size && memcmp( vertexA->data, vertexB->data, vertexA->size ) == 0 );
+			TEST_CHECK( indexA->size == indexB->size && memcmp( indexA->data, indexB->data, indexA->size ) == 0 );
+		}
+	}
+
+	if ( TEST_CHECK( a->timeLineCount == b->timeLineCount ) )
+	{
+		for ( int timeLineIndex = 0; timeLineIndex < a->timeLineCount; timeLineIndex++ )
+		{
+			const ksGltfTimeLine * timeLineA = &a->timeLines[timeLineIndex];
+			const ksGltfTimeLine * timeLineB = &b->timeLines[timeLineIndex];
+			TEST_CHECK( timeLineA->sampleCount == timeLineB->sampleCount && timeLineA->duration == timeLineB->duration && timeLineA->rcpStep == timeLineB->rcpStep );
+			TEST_CHECK( memcmp( timeLineA->sampleTimes, timeLineB->sampleTimes, timeLineA->sampleCount * sizeof( float ) ) == 0 );
+		}
+	}
+	if ( TEST_CHECK( a->animationCount == b->animationCount ) )
+	{
+		for ( int animationIndex = 0; animationIndex < a->animationCount; animationIndex++ )
+		{
+			const ksGltfAnimation * animationA = &a->animations[animationIndex];
+			const ksGltfAnimation * animationB = &b->animations[animationIndex];
+			TEST_CHECK( strcmp( animationA->name, animationB->name ) == 0 );
+			TEST_CHECK( INDEX_OF( animationA->timeLine, a->timeLines ) == INDEX_OF( animationB->timeLine, b->timeLines ) );
+			if ( TEST_CHECK( animationA->channelCount == animationB->channelCount ) )
+			{
+				for ( int channelIndex = 0; channelIndex < animationA->channelCount; channelIndex++ )
+				{
+					const ksGltfAnimationChannel * channelA = &animationA->channels[channelIndex];
+					const ksGltfAnimationChannel * channelB = &animationB->channels[channelIndex];
+					TEST_CHECK( INDEX_OF( channelA->node, a->nodes ) == INDEX_OF( channelB->node, b->nodes ) );
+					TEST_CHECK( IsSameKeyFrames( &channelA->keyFrames, &channelB->keyFrames ) );
+				}
+			}
+		}
+	}
+
+	// The simulated poses must be bit-identical.
+	ksViewState viewState;
+	memset( &viewState, 0, sizeof( viewState ) );
+	bool samePoses = true;
+	for ( int frame = 0; frame < 40; frame++ )
+	{
+		const ksNanoseconds time = (ksNanoseconds)( frame * 1e9 / 37.0 );
+		ksGltfScene_Simulate( a, &viewState, NULL, time );
+		ksGltfScene_Simulate( b, &viewState, NULL, time );
+		samePoses &= ( memcmp( a->state.nodeState.globalTransform, b->state.nodeState.globalTransform, a->nodeCount * sizeof( ksMatrix4x4f ) ) == 0 );
+	}
+	TEST_CHECK( samePoses );
+}
+
+// Loads the scene once more after the cache was damaged or went stale. The cache must be rejected,
+// the scene must be loaded from the glTF instead, and the cache must be baked again.
+static void TestRejectedCache( ksGltfScene * reference, const char * fileName, const char * cacheFileName )
+{
+	ksGltfScene scene;
+	if ( TEST_CHECK( LoadScene( &scene, fileName, cacheFileName ) ) )
+	{
+		TEST_CHECK( scene.bakedData == NULL );
+		CompareScenes( reference, &scene );
+		ksGltfScene_Destroy( &context, &scene );
+	}
+	if ( TEST_CHECK( LoadScene( &scene, fileName, cacheFileName ) ) )
+	{
+		TEST_CHECK( scene.bakedData != NULL );
+		ksGltfScene_Destroy( &context, &scene );
+	}
+}
+
+static unsigned char * ReadFile( const char * fileName, size_t * size )
+{
+	FILE * file = fopen( fileName, "rb" );
+	if ( file == NULL )
+	{
+		return NULL;
+	}
+	fseek( file, 0, SEEK_END );
+	*size = (size_t) ftell( file );
+	fseek( file, 0, SEEK_SET );
+	unsigned char * data = (unsigned char *) malloc( *size );
+	if ( fread( data, 1, *size, file ) != *size )
+	{
+		free( data );
+		data = NULL;
+	}
+	fclose( file );
+	return data;
+}
+
+static bool WriteFile( const char * fileName, const void * data, const size_t size )
+{
+	FILE * file = fopen( fileName, "wb" );
+	if ( file == NULL )
+	{
+		return false;
+	}
+	const bool written = ( fwrite( data, 1, size, file ) == size );
+	fclose( file );
+	return written;
+}
+
+// Source files that were modified in the second the scene was baked never match the cache,
+// so the files are dated back before baking.
+static bool SetModifiedTime( const char * fileName, const time_t modifiedTime )
+{
+	struct utimbuf times;
+	times.actime = modifiedTime;
+	times.modtime = modifiedTime;
+	return utime( fileName, &times ) == 0;
+}
+
+static void TestBakeRoundTrip()
+{
+	const char * fileName = "test_gltf_bake.gltf";
+	const char * binaryFileName = "test_gltf_bake.bin";
+	const char * cacheFileName = "test_gltf_bake.cache";
+
+	GltfBuilder builder;
+	GltfBuilder_Create( &builder );
+	BuildBakeScene( &builder );
+	TEST_CHECK( GltfBuilder_Write( &builder, fileName, binaryFileName ) );
+	GltfBuilder_Destroy( &builder );
+
+	const time_t past = time( NULL ) - 3600;
+	TEST_CHECK( SetModifiedTime( fileName, past ) && SetModifiedTime( binaryFileName, past ) );
+	remove( cacheFileName );
+
+	// The first load reads the glTF and bakes the cache.
+	ksGltfScene scene;
+	if ( !TEST_CHECK( LoadScene( &scene, fileName, cacheFileName ) ) )
+	{
+		return;
+	}
+	TEST_CHECK( scene.bakedData == NULL );
+	// The animation is split into one animation per time-line.
+	TEST_CHECK( scene.skinCount == 1 && scene.animationCount == 2 && scene.modelCount == 3 );
+
+	ksGltfScene bakedScene;
+	if ( TEST_CHECK( LoadScene( &bakedScene, fileName, cacheFileName ) ) )
+	{
+		TEST_CHECK( bakedScene.bakedData != NULL );
+		CompareScenes( &scene, &bakedScene );
+		ksGltfScene_Destroy( &context, &bakedScene );
+	}
+
+	// A truncated cache.
+	size_t cacheSize = 0;
+	unsigned char * cache = ReadFile( cacheFileName, &cacheSize );
+	if ( TEST_CHECK( cache != NULL && cacheSize > sizeof( ksGltfBakedHeader ) ) )
+	{
+		TEST_CHECK( WriteFile( cacheFileName, cache, cacheSize - 16 ) );
+		TestRejectedCache( &scene, fileName, cacheFileName );
+	}
+	free( cache );
+
+	// A relocation that points past the relocated data. All other relocations are applied first.
+	cache = ReadFile( cacheFileName, &cacheSize );
+	if ( TEST_CHECK( cache != NULL && cacheSize > sizeof( ksGltfBakedHeader ) ) )
+	{
+		ksGltfBakedHeader header;
+		memcpy( &header, cache, sizeof( header ) );
+		if ( TEST_CHECK( header.relocationCount > 1 && header.relocationOffset + header.relocationCount * sizeof( uint64_t ) <= cacheSize ) )
+		{
+			const uint64_t badOffset = header.relocationOffset;
+			memcpy( cache + header.relocationOffset + ( header.relocationCount - 1 ) * sizeof( uint64_t ), &badOffset, sizeof( badOffset ) );
+			TEST_CHECK( WriteFile( cacheFileName, cache, cacheSize ) );
+			TestRejectedCache( &scene, fileName, cacheFileName );
+		}
+	}
+	free( cache );
+
+	// A source file that changed after baking.
+	TEST_CHECK( SetModifiedTime( binaryFileName, past - 60 ) );
+	TestRejectedCache( &scene, fileName, cacheFileName );
+	TEST_CHECK( SetModifiedTime( fileName, past - 60 ) );
+	TestRejectedCache( &scene, fileName, cacheFileName );
+
+	ksGltfScene_Destroy( &context, &scene );
+	remove( fileName );
+	remove( binaryFileName );
+	remove( cacheFileName );
+}
+
+#define HIERARCHY_BRANCHES		32
+#define HIERARCHY_LEAVES		32
+#define HIERARCHY_CHAINS		6
+#define HIERARCHY_CHAIN_NODES	8
+
+// A sub-tree large enough to be transformed one depth level at a time, with a level wide enough to be split into
+// jobs, and a number of small independent sub-trees. The branches, leaves and chains are animated with different
+// samplers and the leaves have a model such that their inverse global transforms are updated.
+static void BuildHierarchyScene( GltfBuilder * builder )
+{
+	const float quadPositions[4][3] = { { 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } };
+	const uint32_t quadIndices[6] = { 0, 1, 2, 0, 2, 3 };
+	const int position = GltfBuilder_AddFloats( builder, &quadPositions[0][0], 4, 3 );
+	const int indices = GltfBuilder_AddIndices( builder, quadIndices, 6, GLTF_BUILDER_UNSIGNED_SHORT );
+	const int mesh = GltfBuilder_AddMesh( builder, "quad", 4, position, -1, -1, -1, -1, indices );
+
+	const int keyFrameCount = 16;
+	float times[16];
+	float rotations[4][16][4];
+	float translations[4][16][3];
+	for ( int key = 0; key < keyFrameCount; key++ )
+	{
+		times[key] = key / 10.0f;
+		for ( int i = 0; i < 4; i++ )
+		{
+			const float angle = sinf( key * 0.7f + i ) * 1.3f;
+			const float axisAngle = ( i + 1 ) * 0.4f;
+			rotations[i][key][0] = sinf( angle * 0.5f ) * cosf( axisAngle );
+			rotations[i][key][1] = sinf( angle * 0.5f ) * sinf( axisAngle );
+			rotations[i][key][2] = 0.0f;
+			rotations[i][key][3] = cosf( angle * 0.5f );
+			translations[i][key][0] = 0.5f + 0.25f * cosf( key * 0.3f + i );
+			translations[i][key][1] = 0.1f * i;
+			translations[i][key][2] = 0.3f * sinf( key * 0.9f - i );
+		}
+	}
+	const int input = GltfBuilder_AddFloats( builder, times, keyFrameCount, 1 );
+	int rotationOutputs[4];
+	int translationOutputs[4];
+	for ( int i = 0; i < 4; i++ )
+	{
+		rotationOutputs[i] = GltfBuilder_AddFloats( builder, &rotations[i][0][0], keyFrameCount, 4 );
+		translationOutputs[i] = GltfBuilder_AddFloats( builder, &translations[i][0][0], keyFrameCount, 3 );
+	}
+
+	const float offset[3] = { 0.0f, 1.0f, 0.0f };
+	const int root = GltfBuilder_AddNode( builder, "root", -1, -1, NULL );
+	GltfBuilder_AddChannel( builder, root, "rotation", input, rotationOutputs[0], "LINEAR" );
+	for ( int branch = 0; branch < HIERARCHY_BRANCHES; branch++ )
+	{
+		const int branchNode = GltfBuilder_AddNode( builder, "branch", root, -1, offset );
+		GltfBuilder_AddChannel( builder, branchNode, "rotation", input, rotationOutputs[branch % 4], "LINEAR" );
+		for ( int leaf = 0; leaf < HIERARCHY_LEAVES; leaf++ )
+		{
+			const int leafNode = GltfBuilder_AddNode( builder, "leaf", branchNode, -1, offset );
+			if ( leaf % 3 == 0 )
+			{
+				GltfBuilder_AddChannel( builder, leafNode, "translation", input, translationOutputs[leaf % 4], ( leaf % 2 == 0 ) ? "LINEAR" : "STEP" );
+			}
+			GltfBuilder_AddNode( builder, "tip", leafNode, mesh, offset );
+		}
+	}
+	for ( int chain = 0; chain < HIERARCHY_CHAINS; chain++ )
+	{
+		int parent = -1;
+		for ( int i = 0; i < HIERARCHY_CHAIN_NODES; i++ )
+		{
+			parent = GltfBuilder_AddNode( builder, "chain", parent, ( i == HIERARCHY_CHAIN_NODES - 1 ) ? mesh : -1, offset );
+			GltfBuilder_AddChannel( builder, parent, "rotation", input, rotationOutputs[( chain + i ) % 4], "LINEAR" );
+		}
+	}
+}
+
+// The global transforms must not depend on the number of worker threads, or on how the nodes are split into jobs.
+static void TestSimulateDeterminism()
+{
+	GltfBuilder builder;
+	GltfBuilder_Create( &builder );
+	BuildHierarchyScene( &builder );
+	TEST_CHECK( GltfBuilder_WriteBinary( &builder, "test_gltf_hierarchy.glb" ) );
+	GltfBuilder_Destroy( &builder );
+
+	const int workerCounts[2] = { 0, 3 };
+	ksGltfScene scenes[2];
+	for ( int i = 0; i < 2; i++ )
+	{
+		if ( !TEST_CHECK( LoadScene( &scenes[i], "test_gltf_hierarchy.glb", NULL ) ) )
+		{
+			if ( i > 0 )
+			{
+				ksGltfScene_Destroy( &context, &scenes[0] );
+			}
+			remove( "test_gltf_hierarchy.glb" );
+			return;
+		}
+		ksThreadPool_Destroy( &scenes[i].state.threadPool );
+		ksThreadPool_Create( &scenes[i].state.threadPool, workerCounts[i] );
+	}
+	remove( "test_gltf_hierarchy.glb" );
+
+	// The large sub-tree is transformed one depth level at a time and its widest level is split into jobs.
+	const int expectedSubTreeCount = 1 + HIERARCHY_CHAINS;
+	const int expectedNodeCount = 1 + HIERARCHY_BRANCHES * ( 1 + 2 * HIERARCHY_LEAVES ) + HIERARCHY_CHAINS * HIERARCHY_CHAIN_NODES;
+	TEST_CHECK( scenes[1].subTreeCount == expectedSubTreeCount );
+	TEST_CHECK( scenes[1].nodeCount == expectedNodeCount );
+	TEST_CHECK( scenes[1].state.parallelSubTrees );
+	TEST_CHECK( scenes[1].state.subTreeState[0].levelCount == 4 );
+	TEST_CHECK( scenes[1].state.subTreeState[0].levelFirstNode[3] - scenes[1].state.subTreeState[0].levelFirstNode[2] >= 2 * GLTF_SIMULATE_LEVEL_JOB_NODES );
+
+	ksViewState viewState;
+	memset( &viewState, 0, sizeof( viewState ) );
+
+	const int nodeCount = scenes[0].nodeCount;
+	bool sameGlobalTransforms = true;
+	bool sameGlobalInverseTransforms = true;
+	for ( int frame = 0; frame < 40; frame++ )
+	{
+		const ksNanoseconds time = (ksNanoseconds)( frame * 1e9 / 27.0 );
+		for ( int i = 0; i < 2; i++ )
+		{
+			ksGltfScene_Simulate( &scenes[i], &viewState, NULL, time );
+		}
+		sameGlobalTransforms &= ( memcmp( scenes[0].state.nodeState.globalTransform, scenes[1].state.nodeState.globalTransform, nodeCount * sizeof( ksMatrix4x4f ) ) == 0 );
+		sameGlobalInverseTransforms &= ( memcmp( scenes[0].state.nodeState.globalInverseTransform, scenes[1].state.nodeState.globalInverseTransform, nodeCount * sizeof( ksMatrix4x4f ) ) == 0 );
+	}
+	TEST_CHECK( sameGlobalTransforms );
+	TEST_CHECK( sameGlobalInverseTransforms );
+
+	// The last chain node is rotated by all nodes above it and is not at its bind pose.
+	const int tip = nodeCount - 1;
+	TEST_CHECK( scenes[1].state.nodeState.globalTransform[tip].m[3][1] != (float) HIERARCHY_CHAIN_NODES );
+
+	for ( int i = 0; i < 2; i++ )
+	{
+		ksGltfScene_Destroy( &context, &scenes[i] );
+	}
+}
+
+#define RENDER_MAX_SUBMITS		64
+
+// Records the graphics commands submitted by ksGltfScene_Render.
+typedef struct
+{
+	const ksGltfScene *				scene;
+	int								submitCount;
+	const ksGpuGraphicsPipeline *	pipelines[RENDER_MAX_SUBMITS];
+	int								nodes[RENDER_MAX_SUBMITS];		// node of the model matrix parameter or -1
+} MockSubmits;
+
+static void MockSubmitGraphicsCommand( ksGpuCommandBuffer * commandBuffer, const ksGpuGraphicsCommand * command )
+{
+	MockSubmits * submits = (MockSubmits *) commandBuffer->userData;
+	if ( submits->submitCount >= RENDER_MAX_SUBMITS )
+	{
+		return;
+	}
+	const ksMatrix4x4f * globalTransforms = submits->scene->state.nodeState.globalTransform;
+	int node = -1;
+	for ( int i = 0; i < MAX_PROGRAM_PARMS; i++ )
+	{
+		const ksMatrix4x4f * parm = (const ksMatrix4x4f *) command->parmState.parms[i];
+		if ( parm >= globalTransforms && parm < globalTransforms + submits->scene->nodeCount )
+		{
+			node = (int)( parm - globalTransforms );
+		}
+	}
+	submits->pipelines[submits->submitCount] = command->pipeline;
+	submits->nodes[submits->submitCount] = node;
+	submits->submitCount++;
+}
+
+static void RenderMockSubmits( ksGltfScene * scene, const ksViewState * viewState, MockSubmits * submits, ksGpuCommandBuffer * commandBuffer )
+{
+	memset( submits, 0, sizeof( MockSubmits ) );
+	submits->scene = scene;
+	memset( commandBuffer, 0, sizeof( ksGpuCommandBuffer ) );
+	commandBuffer->submitGraphicsCommand = MockSubmitGraphicsCommand;
+	commandBuffer->userData = submits;
+	ksGltfScene_UpdateBuffers( commandBuffer, scene, viewState, 0 );
+	ksGltfScene_Render( commandBuffer, scene, viewState );
+}
+
+static int CountSubmittedNode( const MockSubmits * submits, const int node )
+{
+	int count = 0;
+	for ( int i = 0; i < submits->submitCount; i++ )
+	{
+		count += ( submits->nodes[i] == node ) ? 1 : 0;
+	}
+	return count;
+}
+
+// Quads with two materials in front of the view, a quad behind the view and a sub-tree with quads that can be hidden.
+static void BuildRenderScene( GltfBuilder * builder )
+{
+	const float quadPositions[4][3] = { { 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } };
+	const float quadNormals[4][3] = { { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, 1.0f } };
+	const uint32_t quadIndices[6] = { 0, 1, 2, 0, 2, 3 };
+	const int position = GltfBuilder_AddFloats( builder, &quadPositions[0][0], 4, 3 );
+	const int normal = GltfBuilder_AddFloats( builder, &quadNormals[0][0], 4, 3 );
+	const int indices = GltfBuilder_AddIndices( builder, quadIndices, 6, GLTF_BUILDER_UNSIGNED_SHORT );
+	const int meshA = GltfBuilder_AddMesh( builder, "quadA", 4, position, normal, -1, -1, -1, indices );
+	const int meshB = GltfBuilder_AddMesh( builder, "quadB", 4, position, normal, -1, -1, -1, indices );
+
+	// The second mesh uses a second material.
+	ksJson * material = ksJson_SetObject( ksJson_AddArrayElement( ksJson_GetMemberByName( builder->rootNode, "materials" ) ) );
+	ksJson_SetString( ksJson_AddObjectMember( material, "name" ), "material2" );
+	ksJson_SetObject( ksJson_AddObjectMember( material, "pbrMetallicRoughness" ) );
+	ksJson * primitiveB = ksJson_GetMemberByIndex( ksJson_GetMemberByName( ksJson_GetMemberByIndex( builder->meshes, meshB ), "primitives" ), 0 );
+	ksJson_SetInt32( ksJson_GetMemberByName( primitiveB, "material" ), 1 );
+
+	const int front = GltfBuilder_AddNode( builder, "front", -1, -1, NULL );
+	for ( int i = 0; i < 6; i++ )
+	{
+		char name[32];
+		sprintf( name, "front%d", i );
+		const float translation[3] = { -3.0f + i, 0.0f, -5.0f };
+		GltfBuilder_AddNode( builder, name, front, ( i & 1 ) ? meshB : meshA, translation );
+	}
+	const float behindTranslation[3] = { 0.0f, 0.0f, 5.0f };
+	GltfBuilder_AddNode( builder, "behind", front, meshA, behindTranslation );
+
+	const int hidden = GltfBuilder_AddNode( builder, "hidden", -1, -1, NULL );
+	const float hiddenTranslations[2][3] = { { -1.0f, 1.0f, -5.0f }, { 1.0f, 1.0f, -5.0f } };
+	GltfBuilder_AddNode( builder, "hidden0", hidden, meshA, hiddenTranslations[0] );
+	GltfBuilder_AddNode( builder, "hidden1", hidden, meshB, hiddenTranslations[1] );
+}
+
+// Renders with a mock submit and compares the submitted graphics commands against the render stats.
+static void TestRender()
+{
+	GltfBuilder builder;
+	GltfBuilder_Create( &builder );
+	BuildRenderScene( &builder );
+	TEST_CHECK( GltfBuilder_WriteBinary( &builder, "test_gltf_render.glb" ) );
+	GltfBuilder_Destroy( &builder );
+
+	ksGltfScene scene;
+	if ( !TEST_CHECK( LoadScene( &scene, "test_gltf_render.glb", NULL ) ) )
+	{
+		remove( "test_gltf_render.glb" );
+		return;
+	}
+	remove( "test_gltf_render.glb" );
+
+	// Without a camera the view is reset to the identity view looking down the negative Z axis.
+	ksViewState viewState;
+	memset( &viewState, 0, sizeof( viewState ) );
+	ksGltfScene_Simulate( &scene, &viewState, NULL, 0 );
+	ksViewState_Init( &viewState, 0.0f );
+
+	MockSubmits * submits = (MockSubmits *) malloc( sizeof( MockSubmits ) );
+	ksGpuCommandBuffer commandBuffer;
+	RenderMockSubmits( &scene, &viewState, submits, &commandBuffer );
+
+	ksGltfRenderStats stats;
+	ksGltfScene_GetRenderStats( &scene, &stats );
+	TEST_CHECK( submits->submitCount == 8 );
+	TEST_CHECK( stats.drawCount == submits->submitCount && commandBuffer.graphicsCommandCount == submits->submitCount );
+
+	// Every quad in front of the view is drawn once and the quad behind the view is culled.
+	const char * drawnNodes[] = { "front0", "front1", "front2", "front3", "front4", "front5", "hidden0", "hidden1" };
+	for ( int i = 0; i < (int)ARRAY_SIZE( drawnNodes ); i++ )
+	{
+		TEST_CHECK( CountSubmittedNode( submits, ksGltfScene_GetNodeHandle( &scene, drawnNodes[i] ) ) == 1 );
+	}
+	TEST_CHECK( CountSubmittedNode( submits, ksGltfScene_GetNodeHandle( &scene, "behind" ) ) == 0 );
+
+	// The draws are sorted such that the pipeline and the program are only bound when they change.
+	int pipelineChanges = 0;
+	int programChanges = 0;
+	for ( int i = 0; i < submits->submitCount; i++ )
+	{
+		pipelineChanges += ( i == 0 || submits->pipelines[i] != submits->pipelines[i - 1] ) ? 1 : 0;
+		programChanges += ( i == 0 || submits->pipelines[i]->program != submits->pipelines[i - 1]->program ) ? 1 : 0;
+	}
+	TEST_CHECK( pipelineChanges == 2 );
+	TEST_CHECK( stats.pipelineBinds == pipelineChanges );
+	TEST_CHECK( stats.programBinds == programChanges );
+	TEST_CHECK( stats.descriptorSetChanges <= stats.drawCount );
+
+	// A hidden sub-tree is not drawn.
+	const int hiddenSubTree = ksGltfScene_GetSubTreeHandle( &scene, "hidden" );
+	if ( TEST_CHECK( hiddenSubTree >= 0 ) )
+	{
+		ksGltfScene_SetSubTreeVisibleByHandle( &scene, hiddenSubTree, false );
+		RenderMockSubmits( &scene, &viewState, submits, &commandBuffer );
+		ksGltfScene_GetRenderStats( &scene, &stats );
+		TEST_CHECK( submits->submitCount == 6 && stats.drawCount == 6 );
+		TEST_CHECK( CountSubmittedNode( submits, ksGltfScene_GetNodeHandle( &scene, "hidden0" ) ) == 0 );
+	}
+
+	free( submits );
+	ksGltfScene_Destroy( &context, &scene );
+}
+
+int main( int argc, char * argv[] )
+{
+	UNUSED_PARM( argc );
+	UNUSED_PARM( argv );
+
+	TestLoad();
+	TestSplitPrimitive();
+	TestAnimationSamplers();
+	TestBakeRoundTrip();
+	TestSimulateDeterminism();
+	TestRender();
+
+	return Test_Report( "gltf" );
+}
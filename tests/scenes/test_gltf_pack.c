@@ -0,0 +1,269 @@
+/*
+================================================================================================
+
+Description	:	Verifies the packed vertex and index buffers of glTF 2.0 scenes by scene_gltf.h.
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+
+The scene is generated with gltf_builder.h and loaded headless with gpu_stub.h, which keeps
+the data that would be uploaded to the GPU. The surfaces with the same vertex layout are
+packed into one vertex buffer per layout and the indices of all surfaces into a single index
+buffer. After packing, and again after loading the packed buffers from the baked cache, the
+de-indexed vertex stream of every surface must equal the source vertices and indices, one
+index at a time, and surfaces with the same accessors must share their range of the buffers.
+
+	test_gltf_pack
+
+================================================================================================
+*/
+
+#include "gpu_stub.h"
+#include "scenes/scene_settings.h"
+#include "scenes/scene_view_state.h"
+#include "scenes/scene_gltf.h"
+#include "gltf_builder.h"
+#include "../test.h"
+
+#if defined( OS_WINDOWS )
+	#include <sys/utime.h>
+	#define utime		_utime
+	#define utimbuf		_utimbuf
+#else
+	#include <utime.h>
+#endif
+
+static ksGpuContext context;
+static ksGpuRenderPass renderPass;
+
+static bool LoadScene( ksGltfScene * scene, const char * fileName, const char * cacheFileName )
+{
+	ksSceneSettings settings;
+	ksSceneSettings_Init( &context, &settings );
+	ksSceneSettings_SetGltf( &settings, fileName );
+	ksSceneSettings_SetGltfCache( &settings, cacheFileName );
+	memset( scene, 0, sizeof( ksGltfScene ) );
+	return ksGltfScene_CreateFromFile( &context, scene, &settings, &renderPass );
+}
+
+static const ksGltfModel * GetModel( const ksGltfScene * scene, const char * name )
+{
+	for ( int modelIndex = 0; modelIndex < scene->modelCount; modelIndex++ )
+	{
+		if ( strcmp( scene->models[modelIndex].name, name ) == 0 )
+		{
+			return &scene->models[modelIndex];
+		}
+	}
+	return NULL;
+}
+
+// Source files that were modified in the second the scene was baked never match the cache,
+// so the files are dated back before baking.
+static bool SetModifiedTime( const char * fileName, const time_t modifiedTime )
+{
+	struct utimbuf times;
+	times.actime = modifiedTime;
+	times.modtime = modifiedTime;
+	return utime( fileName, &times ) == 0;
+}
+
+#define PACK_MAX_VERTICES		64
+#define PACK_MAX_INDICES		192
+
+// The source vertices and indices of a mesh with a single primitive.
+typedef struct
+{
+	const char *	name;
+	int				vertexCount;
+	int				indexCount;		// zero for a non-indexed primitive
+	bool			normals;
+	bool			uvs;
+	float			positions[PACK_MAX_VERTICES][3];
+	float			normals3[PACK_MAX_VERTICES][3];
+	float			uvs2[PACK_MAX_VERTICES][2];
+	uint32_t		indices[PACK_MAX_INDICES];
+} PackMesh;
+
+static void CreatePackMesh( PackMesh * mesh, const char * name, const int vertexCount, const int indexCount, const bool normals, const bool uvs, uint64_t * random )
+{
+	memset( mesh, 0, sizeof( PackMesh ) );
+	mesh->name = name;
+	mesh->vertexCount = vertexCount;
+	mesh->indexCount = indexCount;
+	mesh->normals = normals;
+	mesh->uvs = uvs;
+	for ( int i = 0; i < vertexCount; i++ )
+	{
+		for ( int c = 0; c < 3; c++ )
+		{
+			mesh->positions[i][c] = Test_RandomFloat( random, -10.0f, 10.0f );
+		}
+		// Axis aligned normals are not changed by normalization.
+		mesh->normals3[i][Test_RandomUint64( random ) % 3] = ( Test_RandomUint64( random ) & 1 ) ? 1.0f : -1.0f;
+		mesh->uvs2[i][0] = Test_RandomFloat( random, 0.0f, 1.0f );
+		mesh->uvs2[i][1] = Test_RandomFloat( random, 0.0f, 1.0f );
+	}
+	for ( int i = 0; i < indexCount; i++ )
+	{
+		mesh->indices[i] = (uint32_t)( Test_RandomUint64( random ) % vertexCount );
+	}
+}
+
+// Compares the de-indexed vertex stream of a surface against the source vertices and indices.
+static bool IsSourceSurfaceStream( const ksGpuGeometry * geometry, const PackMesh * mesh )
+{
+	const int indexCount = ( mesh->indexCount > 0 ) ? mesh->indexCount : mesh->vertexCount;
+	if ( geometry->indexCount != indexCount )
+	{
+		return false;
+	}
+	const int expectedFlags = VERTEX_ATTRIBUTE_FLAG_POSITION | ( mesh->normals ? VERTEX_ATTRIBUTE_FLAG_NORMAL : 0 ) | ( mesh->uvs ? VERTEX_ATTRIBUTE_FLAG_UV0 : 0 );
+	if ( ( geometry->vertexAttribsFlags & ( VERTEX_ATTRIBUTE_FLAG_POSITION | VERTEX_ATTRIBUTE_FLAG_NORMAL | VERTEX_ATTRIBUTE_FLAG_UV0 ) ) != expectedFlags )
+	{
+		return false;
+	}
+	for ( int index = 0; index < indexCount; index++ )
+	{
+		const int source = ( mesh->indexCount > 0 ) ? (int)mesh->indices[index] : index;
+		const int vertex = ksGpuGeometry_GetVertexIndex( geometry, index );
+		if ( memcmp( ksGpuGeometry_GetAttribute( geometry, VERTEX_ATTRIBUTE_FLAG_POSITION, vertex ), mesh->positions[source], 3 * sizeof( float ) ) != 0 )
+		{
+			return false;
+		}
+		if ( mesh->normals && memcmp( ksGpuGeometry_GetAttribute( geometry, VERTEX_ATTRIBUTE_FLAG_NORMAL, vertex ), mesh->normals3[source], 3 * sizeof( float ) ) != 0 )
+		{
+			return false;
+		}
+		if ( mesh->uvs && memcmp( ksGpuGeometry_GetAttribute( geometry, VERTEX_ATTRIBUTE_FLAG_UV0, vertex ), mesh->uvs2[source], 2 * sizeof( float ) ) != 0 )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// Checks that every surface references a range of the packed buffers with the same vertices and indices as the source.
+static void CheckPackedSurfaces( const ksGltfScene * scene, const PackMesh * meshes, const int meshCount )
+{
+	TEST_CHECK( scene->modelCount == meshCount );
+
+	// Positions with normals, positions with texture coordinates and only positions.
+	TEST_CHECK( scene->geometryBufferCount == 3 );
+	for ( int bufferIndex = 0; bufferIndex < scene->geometryBufferCount; bufferIndex++ )
+	{
+		TEST_CHECK( scene->geometryBuffers[bufferIndex].geometry.indexCount == scene->geometryIndexCount );
+	}
+
+	for ( int meshIndex = 0; meshIndex < meshCount; meshIndex++ )
+	{
+		const ksGltfModel * model = GetModel( scene, meshes[meshIndex].name );
+		if ( !TEST_CHECK( model != NULL && model->surfaceCount == 1 ) )
+		{
+			continue;
+		}
+		const ksGltfSurface * surface = &model->surfaces[0];
+		TEST_CHECK( surface->geometryBuffer >= scene->geometryBuffers && surface->geometryBuffer < scene->geometryBuffers + scene->geometryBufferCount );
+		TEST_CHECK( surface->firstIndex >= 0 && surface->firstIndex + surface->indexCount <= scene->geometryIndexCount );
+		TEST_CHECK( surface->vertexOffset >= 0 && surface->vertexOffset + surface->vertexCount <= surface->geometryBuffer->vertexCount );
+		TEST_CHECK( surface->geometry.firstIndex == surface->firstIndex && surface->geometry.vertexOffset == surface->vertexOffset );
+		TEST_CHECK( surface->geometry.vertexBuffer.data == surface->geometryBuffer->geometry.vertexBuffer.data );
+		TEST_CHECK( surface->geometry.indexBuffer.data == scene->geometryBuffers[0].geometry.indexBuffer.data );
+		TEST_CHECK( IsSourceSurfaceStream( &surface->geometry, &meshes[meshIndex] ) );
+	}
+
+	// Surfaces with the same accessors share their range of the packed buffers.
+	const ksGltfModel * a = GetModel( scene, "a" );
+	const ksGltfModel * b = GetModel( scene, "b" );
+	const ksGltfModel * sameVertices = GetModel( scene, "sameVertices" );
+	const ksGltfModel * sameGeometry = GetModel( scene, "sameGeometry" );
+	if ( a != NULL && b != NULL && sameVertices != NULL && sameGeometry != NULL &&
+			a->surfaceCount == 1 && b->surfaceCount == 1 && sameVertices->surfaceCount == 1 && sameGeometry->surfaceCount == 1 )
+	{
+		TEST_CHECK( a->surfaces[0].geometryBuffer == b->surfaces[0].geometryBuffer );
+		TEST_CHECK( a->surfaces[0].vertexOffset + a->surfaces[0].vertexCount <= b->surfaces[0].vertexOffset ||
+					b->surfaces[0].vertexOffset + b->surfaces[0].vertexCount <= a->surfaces[0].vertexOffset );
+		TEST_CHECK( sameVertices->surfaces[0].vertexOffset == a->surfaces[0].vertexOffset );
+		TEST_CHECK( sameVertices->surfaces[0].firstIndex != a->surfaces[0].firstIndex );
+		TEST_CHECK( sameGeometry->surfaces[0].vertexOffset == b->surfaces[0].vertexOffset );
+		TEST_CHECK( sameGeometry->surfaces[0].firstIndex == b->surfaces[0].firstIndex );
+	}
+}
+
+static void TestPackedGeometry()
+{
+	const char * fileName = "test_gltf_pack.gltf";
+	const char * binaryFileName = "test_gltf_pack.bin";
+	const char * cacheFileName = "test_gltf_pack.cache";
+
+	uint64_t random = 0x3A5E;
+	PackMesh * meshes = (PackMesh *) malloc( 6 * sizeof( PackMesh ) );
+	CreatePackMesh( &meshes[0], "a", 64, 192, true, false, &random );
+	CreatePackMesh( &meshes[1], "b", 24, 60, true, false, &random );
+	CreatePackMesh( &meshes[2], "uvs", 40, 90, false, true, &random );
+	CreatePackMesh( &meshes[3], "positions", 33, 0, false, false, &random );
+	CreatePackMesh( &meshes[4], "sameVertices", 64, 48, true, false, &random );
+	memcpy( meshes[4].positions, meshes[0].positions, sizeof( meshes[0].positions ) );
+	memcpy( meshes[4].normals3, meshes[0].normals3, sizeof( meshes[0].normals3 ) );
+	meshes[5] = meshes[1];
+	meshes[5].name = "sameGeometry";
+	const int meshCount = 6;
+
+	// The last two meshes share the accessors of the first two.
+	GltfBuilder builder;
+	GltfBuilder_Create( &builder );
+	int positions[4];
+	int normals[4];
+	int uvs[4];
+	int indices[4];
+	for ( int i = 0; i < 4; i++ )
+	{
+		const PackMesh * mesh = &meshes[i];
+		positions[i] = GltfBuilder_AddFloats( &builder, &mesh->positions[0][0], mesh->vertexCount, 3 );
+		normals[i] = mesh->normals ? GltfBuilder_AddFloats( &builder, &mesh->normals3[0][0], mesh->vertexCount, 3 ) : -1;
+		uvs[i] = mesh->uvs ? GltfBuilder_AddFloats( &builder, &mesh->uvs2[0][0], mesh->vertexCount, 2 ) : -1;
+		indices[i] = ( mesh->indexCount > 0 ) ? GltfBuilder_AddIndices( &builder, mesh->indices, mesh->indexCount, ( i == 1 ) ? GLTF_BUILDER_UNSIGNED_BYTE : GLTF_BUILDER_UNSIGNED_SHORT ) : -1;
+		GltfBuilder_AddNode( &builder, mesh->name, -1, GltfBuilder_AddMesh( &builder, mesh->name, 4, positions[i], normals[i], uvs[i], -1, -1, indices[i] ), NULL );
+	}
+	const int sameVerticesIndices = GltfBuilder_AddIndices( &builder, meshes[4].indices, meshes[4].indexCount, GLTF_BUILDER_UNSIGNED_SHORT );
+	GltfBuilder_AddNode( &builder, "sameVertices", -1, GltfBuilder_AddMesh( &builder, "sameVertices", 4, positions[0], normals[0], -1, -1, -1, sameVerticesIndices ), NULL );
+	GltfBuilder_AddNode( &builder, "sameGeometry", -1, GltfBuilder_AddMesh( &builder, "sameGeometry", 4, positions[1], normals[1], -1, -1, -1, indices[1] ), NULL );
+	TEST_CHECK( GltfBuilder_Write( &builder, fileName, binaryFileName ) );
+	GltfBuilder_Destroy( &builder );
+
+	const time_t past = time( NULL ) - 3600;
+	TEST_CHECK( SetModifiedTime( fileName, past ) && SetModifiedTime( binaryFileName, past ) );
+	remove( cacheFileName );
+
+	// The first load packs the geometry and bakes the packed buffers, the second load references the baked buffers.
+	ksGltfScene scene;
+	if ( TEST_CHECK( LoadScene( &scene, fileName, cacheFileName ) ) )
+	{
+		TEST_CHECK( scene.bakedData == NULL );
+		CheckPackedSurfaces( &scene, meshes, meshCount );
+
+		ksGltfScene bakedScene;
+		if ( TEST_CHECK( LoadScene( &bakedScene, fileName, cacheFileName ) ) )
+		{
+			TEST_CHECK( bakedScene.bakedData != NULL );
+			TEST_CHECK( bakedScene.geometryIndexCount == scene.geometryIndexCount );
+			CheckPackedSurfaces( &bakedScene, meshes, meshCount );
+			ksGltfScene_Destroy( &context, &bakedScene );
+		}
+		ksGltfScene_Destroy( &context, &scene );
+	}
+
+	free( meshes );
+	remove( fileName );
+	remove( binaryFileName );
+	remove( cacheFileName );
+}
+
+int main( int argc, char * argv[] )
+{
+	UNUSED_PARM( argc );
+	UNUSED_PARM( argv );
+
+	TestPackedGeometry();
+
+	return Test_Report( "gltf_pack" );
+}
@@ -0,0 +1,64 @@
+/*
+================================================================================================
+
+Description	:	Minimal checks shared by the tests.
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+
+================================================================================================
+*/
+
+#if !defined( KSTEST_H )
+#define KSTEST_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#if !defined( ARRAY_SIZE )
+	#define ARRAY_SIZE( a )		( sizeof( (a) ) / sizeof( (a)[0] ) )
+#endif
+
+static int testCheckCount = 0;
+static int testFailureCount = 0;
+
+#define TEST_CHECK( condition )		Test_Check( (condition), #condition, __FILE__, __LINE__ )
+
+static bool Test_Check( const bool condition, const char * expression, const char * file, const int line )
+{
+	testCheckCount++;
+	if ( !condition )
+	{
+		testFailureCount++;
+		printf( "%s(%d): check failed: %s\n", file, line, expression );
+	}
+	return condition;
+}
+
+// xorshift64* so the random numbers are the same on all platforms.
+static uint64_t Test_RandomUint64( uint64_t * state )
+{
+	uint64_t x = *state;
+	x ^= x >> 12;
+	x ^= x << 25;
+	x ^= x >> 27;
+	*state = x;
+	return x * 0x2545F4914F6CDD1DULL;
+}
+
+// Returns a random float in the range [min, max).
+static float Test_RandomFloat( uint64_t * state, const float min, const float max )
+{
+	return min + ( max - min ) * (float)( Test_RandomUint64( state ) >> 40 ) * ( 1.0f / (float)( 1 << 24 ) );
+}
+
+// Returns the exit code of the test program.
+static int Test_Report( const char * name )
+{
+	printf( "%s: %d checks, %d failures\n", name, testCheckCount, testFailureCount );
+	return ( testFailureCount == 0 ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+#endif // !KSTEST_H
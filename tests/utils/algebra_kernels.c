@@ -0,0 +1,143 @@
+/*
+================================================================================================
+
+Description	:	Array kernels around the vectorized functions of algebra.h.
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+
+Compiled with ALGEBRA_KERNEL_PREFIX set to Scalar together with ALGEBRA_SIMD_DISABLED, and with
+ALGEBRA_KERNEL_PREFIX set to Simd.
+
+================================================================================================
+*/
+
+#include "algebra_kernels.h"
+
+#define ALGEBRA_KERNEL_NAME2( prefix, name )	prefix##_##name
+#define ALGEBRA_KERNEL_NAME( prefix, name )		ALGEBRA_KERNEL_NAME2( prefix, name )
+#define KERNEL( name )							ALGEBRA_KERNEL_NAME( ALGEBRA_KERNEL_PREFIX, name )
+
+const char * KERNEL( GetInstructionSet )()
+{
+#if defined( ALGEBRA_SIMD_SSE )
+	return "SSE";
+#elif defined( ALGEBRA_SIMD_NEON )
+	return "NEON";
+#else
+	return "scalar";
+#endif
+}
+
+void KERNEL( Multiply )( ksMatrix4x4f * result, const ksMatrix4x4f * a, const ksMatrix4x4f * b, const int count )
+{
+	for ( int i = 0; i < count; i++ )
+	{
+		ksMatrix4x4f_Multiply( &result[i], &a[i], &b[i] );
+	}
+}
+
+void KERNEL( Invert )( ksMatrix4x4f * result, const ksMatrix4x4f * src, const int count )
+{
+	for ( int i = 0; i < count; i++ )
+	{
+		ksMatrix4x4f_Invert( &result[i], &src[i] );
+	}
+}
+
+void KERNEL( InvertHomogeneous )( ksMatrix4x4f * result, const ksMatrix4x4f * src, const int count )
+{
+	for ( int i = 0; i < count; i++ )
+	{
+		ksMatrix4x4f_InvertHomogeneous( &result[i], &src[i] );
+	}
+}
+
+void KERNEL( InvertAffine )( ksMatrix4x4f * result, const ksMatrix4x4f * src, const int count )
+{
+	for ( int i = 0; i < count; i++ )
+	{
+		ksMatrix4x4f_InvertAffine( &result[i], &src[i] );
+	}
+}
+
+void KERNEL( InvertRigid )( ksMatrix4x4f * result, const ksMatrix4x4f * src, const int count )
+{
+	for ( int i = 0; i < count; i++ )
+	{
+		ksMatrix4x4f_InvertRigid( &result[i], &src[i] );
+	}
+}
+
+void KERNEL( TransformVector3f )( ksVector3f * result, const ksMatrix4x4f * m, const ksVector3f * v, const int count )
+{
+	for ( int i = 0; i < count; i++ )
+	{
+		ksMatrix4x4f_TransformVector3f( &result[i], &m[i], &v[i] );
+	}
+}
+
+void KERNEL( TransformVector4f )( ksVector4f * result, const ksMatrix4x4f * m, const ksVector4f * v, const int count )
+{
+	for ( int i = 0; i < count; i++ )
+	{
+		ksMatrix4x4f_TransformVector4f( &result[i], &m[i], &v[i] );
+	}
+}
+
+void KERNEL( TransformBounds )( ksVector3f * resultMins, ksVector3f * resultMaxs, const ksMatrix4x4f * m,
+								const ksVector3f * mins, const ksVector3f * maxs, const int count )
+{
+	for ( int i = 0; i < count; i++ )
+	{
+		ksMatrix4x4f_TransformBounds( &resultMins[i], &resultMaxs[i], &m[i], &mins[i], &maxs[i] );
+	}
+}
+
+void KERNEL( Blend )( ksTransformArray * result, const ksTransformArray * a, const ksTransformArray * b, const float * fractions, const int count )
+{
+	ksTransformArray_Blend( result, a, b, fractions, count );
+}
+
+void KERNEL( CreateTranslationRotationScaleArray )( ksMatrix4x4f * result, const ksTransformArray * transforms, const int count )
+{
+	ksMatrix4x4f_CreateTranslationRotationScaleArray( result, transforms, count );
+}
+
+// Interpolates one node at a time with the given quaternion interpolation and creates its local matrix.
+static void AnimateSingle( ksMatrix4x4f * result, const ksTransformArray * a, const ksTransformArray * b, const float * fractions, const int count,
+							void (*interpolate)( ksQuatf * result, const ksQuatf * a, const ksQuatf * b, const float fraction ) )
+{
+	for ( int i = 0; i < count; i++ )
+	{
+		const ksVector3f ta = { a->translation[0][i], a->translation[1][i], a->translation[2][i] };
+		const ksVector3f tb = { b->translation[0][i], b->translation[1][i], b->translation[2][i] };
+		const ksVector3f sa = { a->scale[0][i], a->scale[1][i], a->scale[2][i] };
+		const ksVector3f sb = { b->scale[0][i], b->scale[1][i], b->scale[2][i] };
+		const ksQuatf qa = { a->rotation[0][i], a->rotation[1][i], a->rotation[2][i], a->rotation[3][i] };
+		const ksQuatf qb = { b->rotation[0][i], b->rotation[1][i], b->rotation[2][i], b->rotation[3][i] };
+		ksVector3f translation;
+		ksVector3f scale;
+		ksQuatf rotation;
+		ksVector3f_Lerp( &translation, &ta, &tb, fractions[i] );
+		ksVector3f_Lerp( &scale, &sa, &sb, fractions[i] );
+		interpolate( &rotation, &qa, &qb, fractions[i] );
+		ksMatrix4x4f_CreateTranslationRotationScale( &result[i], &translation, &rotation, &scale );
+	}
+}
+
+void KERNEL( AnimateLerp )( ksMatrix4x4f * result, const ksTransformArray * a, const ksTransformArray * b, const float * fractions, const int count )
+{
+	AnimateSingle( result, a, b, fractions, count, ksQuatf_Lerp );
+}
+
+void KERNEL( AnimateFastSlerp )( ksMatrix4x4f * result, const ksTransformArray * a, const ksTransformArray * b, const float * fractions, const int count )
+{
+	AnimateSingle( result, a, b, fractions, count, ksQuatf_FastSlerp );
+}
+
+void KERNEL( AnimateBatched )( ksMatrix4x4f * result, ksTransformArray * blended, const ksTransformArray * a, const ksTransformArray * b,
+								const float * fractions, const int count )
+{
+	ksTransformArray_Blend( blended, a, b, fractions, count );
+	ksMatrix4x4f_CreateTranslationRotationScaleArray( result, blended, count );
+}
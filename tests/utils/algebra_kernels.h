@@ -0,0 +1,64 @@
+/*
+================================================================================================
+
+Description	:	Array kernels around the vectorized functions of algebra.h.
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+
+The instruction set of algebra.h is chosen at compile time. algebra_kernels.c is therefore compiled
+twice, once with the SSE or NEON paths and once with ALGEBRA_SIMD_DISABLED, so the tests and the
+benchmarks can compare both paths in a single program. The kernels loop over arrays so the cost
+of the call does not hide the cost of the operation.
+
+================================================================================================
+*/
+
+#if !defined( KSALGEBRA_KERNELS_H )
+#define KSALGEBRA_KERNELS_H
+
+#include <assert.h>				// algebra.h expects the includer to provide assert()
+#include <stdlib.h>
+#include <utils/algebra.h>
+
+#define ALGEBRA_KERNEL_PROTOTYPES( prefix ) \
+	const char * prefix##_GetInstructionSet(); \
+	void prefix##_Multiply( ksMatrix4x4f * result, const ksMatrix4x4f * a, const ksMatrix4x4f * b, const int count ); \
+	void prefix##_Invert( ksMatrix4x4f * result, const ksMatrix4x4f * src, const int count ); \
+	void prefix##_InvertHomogeneous( ksMatrix4x4f * result, const ksMatrix4x4f * src, const int count ); \
+	void prefix##_InvertAffine( ksMatrix4x4f * result, const ksMatrix4x4f * src, const int count ); \
+	void prefix##_InvertRigid( ksMatrix4x4f * result, const ksMatrix4x4f * src, const int count ); \
+	void prefix##_TransformVector3f( ksVector3f * result, const ksMatrix4x4f * m, const ksVector3f * v, const int count ); \
+	void prefix##_TransformVector4f( ksVector4f * result, const ksMatrix4x4f * m, const ksVector4f * v, const int count ); \
+	void prefix##_TransformBounds( ksVector3f * resultMins, ksVector3f * resultMaxs, const ksMatrix4x4f * m, \
+									const ksVector3f * mins, const ksVector3f * maxs, const int count ); \
+	void prefix##_Blend( ksTransformArray * result, const ksTransformArray * a, const ksTransformArray * b, const float * fractions, const int count ); \
+	void prefix##_CreateTranslationRotationScaleArray( ksMatrix4x4f * result, const ksTransformArray * transforms, const int count ); \
+	void prefix##_AnimateLerp( ksMatrix4x4f * result, const ksTransformArray * a, const ksTransformArray * b, const float * fractions, const int count ); \
+	void prefix##_AnimateFastSlerp( ksMatrix4x4f * result, const ksTransformArray * a, const ksTransformArray * b, const float * fractions, const int count ); \
+	void prefix##_AnimateBatched( ksMatrix4x4f * result, ksTransformArray * blended, const ksTransformArray * a, const ksTransformArray * b, \
+									const float * fractions, const int count );
+
+ALGEBRA_KERNEL_PROTOTYPES( Scalar )
+ALGEBRA_KERNEL_PROTOTYPES( Simd )
+
+// Allocates the components of 'count' transforms in a single block.
+static void ksTransformArray_Alloc( ksTransformArray * transforms, const int count )
+{
+	float * data = (float *) malloc( 10 * count * sizeof( float ) );
+	for ( int c = 0; c < 3; c++ )
+	{
+		transforms->translation[c] = data + ( 0 + c ) * count;
+		transforms->scale[c] = data + ( 3 + c ) * count;
+	}
+	for ( int c = 0; c < 4; c++ )
+	{
+		transforms->rotation[c] = data + ( 6 + c ) * count;
+	}
+}
+
+static void ksTransformArray_Free( ksTransformArray * transforms )
+{
+	free( transforms->translation[0] );
+}
+
+#endif // !KSALGEBRA_KERNELS_H
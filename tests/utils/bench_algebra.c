@@ -0,0 +1,232 @@
+/*
+================================================================================================
+
+Description	:	Benchmarks the vectorized functions of algebra.h against the scalar code.
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+
+Each function is called over arrays of 1024 inputs that fit in the L1 cache, and the best time
+of all iterations is reported in nanoseconds per call.
+
+The animation of 1k to 100k nodes is reported in nanoseconds per node. Each node blends two keys
+and creates its local matrix, either one node at a time with a normalized lerp or a fast slerp
+of the rotation, or with the batched functions.
+
+The inverse cost per frame is reported for a skinned scene with 50 skins and 200 models. Rendering
+used to invert each global transform once per eye with the general inverse. The scene now inverts
+each transform once per frame, with the rigid inverse when the hierarchy only has uniform scale
+and the affine inverse otherwise. One in eight of the models has a non-uniform scale.
+
+	bench_algebra [iterations]
+
+================================================================================================
+*/
+
+#if defined( __linux__ )
+	#define _XOPEN_SOURCE 600
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <utils/nanoseconds.h>
+#include "algebra_kernels.h"
+
+#define BENCH_COUNT		1024
+
+typedef struct
+{
+	ksMatrix4x4f	a[BENCH_COUNT];
+	ksMatrix4x4f	b[BENCH_COUNT];
+	ksMatrix4x4f	result[BENCH_COUNT];
+	ksVector4f		v4[BENCH_COUNT];
+	ksVector4f		result4[BENCH_COUNT];
+	ksVector3f		v3[BENCH_COUNT];
+	ksVector3f		mins[BENCH_COUNT];
+	ksVector3f		maxs[BENCH_COUNT];
+	ksVector3f		resultMins[BENCH_COUNT];
+	ksVector3f		resultMaxs[BENCH_COUNT];
+} BenchData;
+
+static void Bench_Run( BenchData * data, const int function, const bool simd )
+{
+	switch ( function )
+	{
+		case 0: ( simd ? Simd_Multiply : Scalar_Multiply )( data->result, data->a, data->b, BENCH_COUNT ); break;
+		case 1: ( simd ? Simd_Invert : Scalar_Invert )( data->result, data->a, BENCH_COUNT ); break;
+		case 2: ( simd ? Simd_InvertHomogeneous : Scalar_InvertHomogeneous )( data->result, data->b, BENCH_COUNT ); break;
+		case 3: ( simd ? Simd_InvertAffine : Scalar_InvertAffine )( data->result, data->a, BENCH_COUNT ); break;
+		case 4: ( simd ? Simd_InvertRigid : Scalar_InvertRigid )( data->result, data->b, BENCH_COUNT ); break;
+		case 5: ( simd ? Simd_TransformVector3f : Scalar_TransformVector3f )( data->resultMins, data->a, data->v3, BENCH_COUNT ); break;
+		case 6: ( simd ? Simd_TransformVector4f : Scalar_TransformVector4f )( data->result4, data->a, data->v4, BENCH_COUNT ); break;
+		case 7: ( simd ? Simd_TransformBounds : Scalar_TransformBounds )( data->resultMins, data->resultMaxs, data->a, data->mins, data->maxs, BENCH_COUNT ); break;
+	}
+}
+
+static const char * functionNames[] = { "Multiply", "Invert", "InvertHomogeneous", "InvertAffine", "InvertRigid",
+										"TransformVector3f", "TransformVector4f", "TransformBounds" };
+
+int main( int argc, char * argv[] )
+{
+	const int iterations = ( argc > 1 ) ? atoi( argv[1] ) : 1000;
+
+	BenchData * data = (BenchData *) calloc( 1, sizeof( BenchData ) );
+	for ( int i = 0; i < BENCH_COUNT; i++ )
+	{
+		const float angle = i * 0.01f;
+		ksMatrix4x4f_CreateRotation( &data->b[i], angle * 30.0f, angle * 50.0f, angle * 70.0f );
+		data->b[i].m[3][0] = (float)i;
+		data->b[i].m[3][1] = 1.0f;
+		data->b[i].m[3][2] = -(float)i;
+		ksMatrix4x4f scale;
+		ksMatrix4x4f_CreateScale( &scale, 1.0f + angle, 2.0f, 0.5f + angle );
+		ksMatrix4x4f_Multiply( &data->a[i], &data->b[i], &scale );
+		data->v4[i].x = data->v3[i].x = data->mins[i].x = -(float)i;
+		data->v4[i].y = data->v3[i].y = data->mins[i].y = 1.0f;
+		data->v4[i].z = data->v3[i].z = data->mins[i].z = angle;
+		data->v4[i].w = 1.0f;
+		data->maxs[i].x = data->mins[i].x + 2.0f;
+		data->maxs[i].y = data->mins[i].y + 3.0f;
+		data->maxs[i].z = data->mins[i].z + 4.0f;
+	}
+
+	printf( "| %-18s | %8s | %8s | speedup |\n", "ns per call", Scalar_GetInstructionSet(), Simd_GetInstructionSet() );
+	for ( int function = 0; function < (int)( sizeof( functionNames ) / sizeof( functionNames[0] ) ); function++ )
+	{
+		ksNanoseconds best[2] = { 0, 0 };
+		for ( int simd = 0; simd < 2; simd++ )
+		{
+			for ( int iteration = 0; iteration < iterations; iteration++ )
+			{
+				const ksNanoseconds t0 = GetTimeNanoseconds();
+				Bench_Run( data, function, simd != 0 );
+				const ksNanoseconds t1 = GetTimeNanoseconds();
+				best[simd] = ( iteration == 0 || t1 - t0 < best[simd] ) ? t1 - t0 : best[simd];
+			}
+		}
+		printf( "| %-18s | %8.2f | %8.2f | %6.2fx |\n", functionNames[function], (double)best[0] / BENCH_COUNT,
+				(double)best[1] / BENCH_COUNT, (double)best[0] / (double)( best[1] > 0 ? best[1] : 1 ) );
+	}
+
+	free( data );
+
+	printf( "\n| %-18s | %8s | %8s | %8s | %8s |\n", "ns per node", "lerp", "fslerp", "batched", "batched" );
+	printf( "| %-18s | %8s | %8s | %8s | %8s |\n", "", Scalar_GetInstructionSet(), Scalar_GetInstructionSet(),
+			Scalar_GetInstructionSet(), Simd_GetInstructionSet() );
+	for ( int nodeCount = 1000; nodeCount <= 100000; nodeCount *= 10 )
+	{
+		ksTransformArray keys[2];
+		ksTransformArray blended;
+		ksTransformArray_Alloc( &keys[0], nodeCount );
+		ksTransformArray_Alloc( &keys[1], nodeCount );
+		ksTransformArray_Alloc( &blended, nodeCount );
+		float * fractions = (float *) malloc( nodeCount * sizeof( float ) );
+		ksMatrix4x4f * matrices = (ksMatrix4x4f *) malloc( nodeCount * sizeof( ksMatrix4x4f ) );
+		for ( int i = 0; i < nodeCount; i++ )
+		{
+			for ( int k = 0; k < 2; k++ )
+			{
+				const float angle = ( i + k * 0.5f ) * 0.01f;
+				keys[k].translation[0][i] = keys[k].scale[0][i] = 1.0f + angle;
+				keys[k].translation[1][i] = keys[k].scale[1][i] = 1.0f;
+				keys[k].translation[2][i] = keys[k].scale[2][i] = 1.0f - angle;
+				keys[k].rotation[0][i] = sinf( angle ) * 0.6f;
+				keys[k].rotation[1][i] = sinf( angle ) * 0.8f;
+				keys[k].rotation[2][i] = 0.0f;
+				keys[k].rotation[3][i] = cosf( angle );
+			}
+			fractions[i] = ( i % 100 ) * 0.01f;
+		}
+
+		ksNanoseconds best[4] = { 0, 0, 0, 0 };
+		const int nodeIterations = ( iterations * 1000 ) / nodeCount + 1;
+		for ( int path = 0; path < 4; path++ )
+		{
+			for ( int iteration = 0; iteration < nodeIterations; iteration++ )
+			{
+				const ksNanoseconds t0 = GetTimeNanoseconds();
+				switch ( path )
+				{
+					case 0: Scalar_AnimateLerp( matrices, &keys[0], &keys[1], fractions, nodeCount ); break;
+					case 1: Scalar_AnimateFastSlerp( matrices, &keys[0], &keys[1], fractions, nodeCount ); break;
+					case 2: Scalar_AnimateBatched( matrices, &blended, &keys[0], &keys[1], fractions, nodeCount ); break;
+					case 3: Simd_AnimateBatched( matrices, &blended, &keys[0], &keys[1], fractions, nodeCount ); break;
+				}
+				const ksNanoseconds t1 = GetTimeNanoseconds();
+				best[path] = ( iteration == 0 || t1 - t0 < best[path] ) ? t1 - t0 : best[path];
+			}
+		}
+		printf( "| %-18d | %8.2f | %8.2f | %8.2f | %8.2f |\n", nodeCount, (double)best[0] / nodeCount, (double)best[1] / nodeCount,
+				(double)best[2] / nodeCount, (double)best[3] / nodeCount );
+
+		ksTransformArray_Free( &keys[0] );
+		ksTransformArray_Free( &keys[1] );
+		ksTransformArray_Free( &blended );
+		free( fractions );
+		free( matrices );
+	}
+
+	// Inverse cost per frame of a skinned scene.
+	{
+		const int skinCount = 50;
+		const int modelCount = 200;
+		const int transformCount = skinCount + modelCount;
+		ksMatrix4x4f * globals = (ksMatrix4x4f *) malloc( transformCount * sizeof( ksMatrix4x4f ) );
+		ksMatrix4x4f * inverses = (ksMatrix4x4f *) malloc( transformCount * sizeof( ksMatrix4x4f ) );
+		int rigidCount = 0;
+		for ( int i = 0; i < transformCount; i++ )
+		{
+			// The rigid transforms are sorted before the affine transforms.
+			const bool rigid = ( i < skinCount || ( i % 8 ) != 0 );
+			ksMatrix4x4f * global = &globals[rigid ? rigidCount++ : transformCount - 1 - ( i - rigidCount )];
+			ksMatrix4x4f_CreateIdentity( global );
+			for ( int depth = 0; depth < 4; depth++ )
+			{
+				ksMatrix4x4f local;
+				ksMatrix4x4f rotation;
+				ksMatrix4x4f scale;
+				ksMatrix4x4f_CreateRotation( &rotation, i * 3.0f + depth * 20.0f, i * 5.0f, depth * 7.0f );
+				ksMatrix4x4f_CreateScale( &scale, 1.1f, rigid ? 1.1f : 0.5f, rigid ? 1.1f : 2.0f );
+				ksMatrix4x4f_Multiply( &local, &rotation, &scale );
+				local.m[3][0] = (float)depth;
+				local.m[3][1] = (float)i * 0.1f;
+				local.m[3][2] = -1.0f;
+				ksMatrix4x4f parent = *global;
+				ksMatrix4x4f_Multiply( global, &parent, &local );
+			}
+		}
+
+		ksNanoseconds best[4] = { 0, 0, 0, 0 };
+		for ( int path = 0; path < 4; path++ )
+		{
+			const bool simd = ( path & 1 ) != 0;
+			for ( int iteration = 0; iteration < iterations; iteration++ )
+			{
+				const ksNanoseconds t0 = GetTimeNanoseconds();
+				if ( path < 2 )
+				{
+					for ( int eye = 0; eye < 2; eye++ )
+					{
+						( simd ? Simd_Invert : Scalar_Invert )( inverses, globals, transformCount );
+					}
+				}
+				else
+				{
+					( simd ? Simd_InvertRigid : Scalar_InvertRigid )( inverses, globals, rigidCount );
+					( simd ? Simd_InvertAffine : Scalar_InvertAffine )( inverses + rigidCount, globals + rigidCount, transformCount - rigidCount );
+				}
+				const ksNanoseconds t1 = GetTimeNanoseconds();
+				best[path] = ( iteration == 0 || t1 - t0 < best[path] ) ? t1 - t0 : best[path];
+			}
+		}
+		printf( "\n| %-18s | %8s | %8s |\n", "us per frame", Scalar_GetInstructionSet(), Simd_GetInstructionSet() );
+		printf( "| %-18s | %8.2f | %8.2f |\n", "general per eye", best[0] * 1e-3, best[1] * 1e-3 );
+		printf( "| %-18s | %8.2f | %8.2f |\n", "rigid or affine", best[2] * 1e-3, best[3] * 1e-3 );
+
+		free( globals );
+		free( inverses );
+	}
+
+	return EXIT_SUCCESS;
+}
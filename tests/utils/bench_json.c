@@ -0,0 +1,231 @@
+/*
+================================================================================================
+
+Description	:	Benchmarks the DOMs and the writer of json.h.
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+
+A glTF-like document is generated and parsed into both DOMs. The parse time, the heap memory
+that is in use after parsing (which is the peak for a parse) and the destroy time are reported.
+The heap usage is only available with glibc. The write throughput is measured for the same
+document and for an array of random doubles, which is dominated by the number formatting.
+The parse time of the random doubles is compared to parsing the same numbers with strtod.
+Finally the load time of the document as a text file is compared to a binary snapshot.
+
+	bench_json [object count] [iterations]
+
+================================================================================================
+*/
+
+#if defined( __linux__ )
+	#define _XOPEN_SOURCE 600
+	#include <malloc.h>							// for mallinfo()
+#endif
+
+#include <math.h>
+#include <utils/json.h>
+#include <utils/nanoseconds.h>
+
+// Generates objects that each have a name, a few numbers and an array of numbers.
+static char * CreateDocument( const int objectCount, size_t * sizeOut )
+{
+	const size_t maxObjectSize = 256;
+	char * text = (char *) malloc( objectCount * maxObjectSize + 64 );
+	size_t length = 0;
+	length += sprintf( text + length, "{\"nodes\":[" );
+	for ( int i = 0; i < objectCount; i++ )
+	{
+		length += sprintf( text + length, "%s{\"name\":\"node%d\",\"mesh\":%d,\"scale\":%.6f,\"visible\":%s,\"translation\":[%d.5,%d.25,-%d.125]}",
+							( i > 0 ) ? "," : "", i, i % 97, 1.0 + i * 1e-5, ( i & 1 ) ? "true" : "false", i, i * 3, i * 7 );
+	}
+	length += sprintf( text + length, "]}" );
+	*sizeOut = length;
+	return text;
+}
+
+// Random doubles with a spread of magnitudes, like the accessor bounds and transforms of a scene.
+static ksJson * CreateNumbersDom( const int count )
+{
+	ksJson * rootNode = ksJson_Create();
+	ksJson * array = ksJson_SetArray( rootNode );
+	uint32_t state = 12345;
+	for ( int i = 0; i < count; i++ )
+	{
+		state = state * 1664525 + 1013904223;
+		const double mantissa = (double)( state >> 8 ) / (double)( 1 << 24 ) - 0.5;
+		ksJson_SetDouble( ksJson_AddArrayElement( array ), ldexp( mantissa, (int)( state & 31 ) - 16 ) );
+	}
+	return rootNode;
+}
+
+static size_t GetHeapInUse()
+{
+#if defined( __GLIBC__ ) && ( __GLIBC__ > 2 || ( __GLIBC__ == 2 && __GLIBC_MINOR__ >= 33 ) )
+	const struct mallinfo2 info = mallinfo2();
+	return info.uordblks + info.hblkhd;
+#elif defined( __GLIBC__ )
+	const struct mallinfo info = mallinfo();
+	return (size_t)(unsigned int)info.uordblks + (size_t)(unsigned int)info.hblkhd;
+#else
+	return 0;
+#endif
+}
+
+int main( int argc, char * argv[] )
+{
+	const int objectCount = ( argc > 1 ) ? atoi( argv[1] ) : 100000;
+	const int iterations = ( argc > 2 ) ? atoi( argv[2] ) : 10;
+
+	size_t textSize = 0;
+	char * text = CreateDocument( objectCount, &textSize );
+	printf( "document: %d objects, %1.1f MB\n", objectCount, textSize / ( 1024.0 * 1024.0 ) );
+
+	int result = EXIT_SUCCESS;
+	for ( int arena = 0; arena < 2; arena++ )
+	{
+		ksNanoseconds parseTime = 0;
+		ksNanoseconds destroyTime = 0;
+		size_t heapUsed = 0;
+		for ( int iteration = 0; iteration < iterations; iteration++ )
+		{
+			const size_t heapBefore = GetHeapInUse();
+			const ksNanoseconds t0 = GetTimeNanoseconds();
+			ksJson * rootNode = arena ? ksJson_CreateArena() : ksJson_Create();
+			const char * error = NULL;
+			if ( !ksJson_ReadFromBuffer( rootNode, text, &error ) ||
+					ksJson_GetMemberCount( ksJson_GetMemberByName( rootNode, "nodes" ) ) != objectCount )
+			{
+				printf( "failed to parse: %s\n", ( error != NULL ) ? error : "wrong member count" );
+				result = EXIT_FAILURE;
+			}
+			const ksNanoseconds t1 = GetTimeNanoseconds();
+			const size_t heapAfter = GetHeapInUse();
+			ksJson_Destroy( rootNode );
+			const ksNanoseconds t2 = GetTimeNanoseconds();
+
+			parseTime = ( iteration == 0 || t1 - t0 < parseTime ) ? t1 - t0 : parseTime;
+			destroyTime = ( iteration == 0 || t2 - t1 < destroyTime ) ? t2 - t1 : destroyTime;
+			heapUsed = ( heapAfter > heapBefore ) ? heapAfter - heapBefore : 0;
+		}
+		printf( "%-6s DOM: parse %8.3f ms, heap %8.1f MB, destroy %8.3f ms\n", arena ? "arena" : "malloc",
+				parseTime * 1e-6, heapUsed / ( 1024.0 * 1024.0 ), destroyTime * 1e-6 );
+	}
+
+	// Write throughput.
+	ksJson * documentNode = ksJson_Create();
+	ksJson_ReadFromBuffer( documentNode, text, NULL );
+	ksJson * numbersNode = CreateNumbersDom( objectCount * 8 );
+	for ( int numbers = 0; numbers < 2; numbers++ )
+	{
+		for ( int compact = 1; compact >= 0; compact-- )
+		{
+			ksNanoseconds writeTime = 0;
+			int length = 0;
+			for ( int iteration = 0; iteration < iterations; iteration++ )
+			{
+				char * buffer = NULL;
+				const ksNanoseconds t0 = GetTimeNanoseconds();
+				if ( !ksJson_WriteToBufferEx( numbers ? numbersNode : documentNode, &buffer, &length, compact != 0 ) )
+				{
+					printf( "failed to write\n" );
+					result = EXIT_FAILURE;
+				}
+				const ksNanoseconds t1 = GetTimeNanoseconds();
+				free( buffer );
+
+				writeTime = ( iteration == 0 || t1 - t0 < writeTime ) ? t1 - t0 : writeTime;
+			}
+			printf( "write %-8s %-8s: %8.3f ms, %8.1f MB/s\n", numbers ? "numbers" : "document", compact ? "compact" : "indented",
+					writeTime * 1e-6, ( length / ( 1024.0 * 1024.0 ) ) / ( writeTime * 1e-9 ) );
+		}
+	}
+
+	// Parse the random doubles, compared to parsing the same numbers with strtod.
+	char * numbersText = NULL;
+	int numbersLength = 0;
+	ksJson_WriteToBufferEx( numbersNode, &numbersText, &numbersLength, true );
+	ksNanoseconds parseTime = 0;
+	ksNanoseconds strtodTime = 0;
+	double checksum[2] = { 0.0, 0.0 };
+	for ( int iteration = 0; iteration < iterations; iteration++ )
+	{
+		const ksNanoseconds t0 = GetTimeNanoseconds();
+		ksJson * rootNode = ksJson_CreateArena();
+		if ( !ksJson_ReadFromBuffer( rootNode, numbersText, NULL ) )
+		{
+			printf( "failed to parse numbers\n" );
+			result = EXIT_FAILURE;
+		}
+		const ksNanoseconds t1 = GetTimeNanoseconds();
+		checksum[0] = 0.0;
+		for ( int i = 0; i < ksJson_GetMemberCount( rootNode ); i++ )
+		{
+			checksum[0] += ksJson_GetDouble( ksJson_GetMemberByIndex( rootNode, i ), 0.0 );
+		}
+		ksJson_Destroy( rootNode );
+
+		const ksNanoseconds t2 = GetTimeNanoseconds();
+		checksum[1] = 0.0;
+		for ( const char * ptr = numbersText + 1; ptr[-1] != ']'; ptr++ )
+		{
+			checksum[1] += strtod( ptr, (char **)&ptr );
+		}
+		const ksNanoseconds t3 = GetTimeNanoseconds();
+
+		parseTime = ( iteration == 0 || t1 - t0 < parseTime ) ? t1 - t0 : parseTime;
+		strtodTime = ( iteration == 0 || t3 - t2 < strtodTime ) ? t3 - t2 : strtodTime;
+	}
+	if ( checksum[0] != checksum[1] )
+	{
+		printf( "parsed numbers differ from strtod\n" );
+		result = EXIT_FAILURE;
+	}
+	printf( "parse numbers   : %8.3f ms, %8.1f MB/s (strtod %8.3f ms)\n", parseTime * 1e-6,
+			( numbersLength / ( 1024.0 * 1024.0 ) ) / ( parseTime * 1e-9 ), strtodTime * 1e-6 );
+	free( numbersText );
+
+	// Load the document from a text file and from a binary snapshot.
+	const char * textFileName = "bench_json.json";
+	const char * binaryFileName = "bench_json.bin";
+	if ( !ksJson_WriteToFileEx( documentNode, textFileName, true ) || !ksJson_WriteBinary( documentNode, binaryFileName ) )
+	{
+		printf( "failed to write files\n" );
+		result = EXIT_FAILURE;
+	}
+	for ( int binary = 0; binary < 2; binary++ )
+	{
+		ksNanoseconds loadTime = 0;
+		for ( int iteration = 0; iteration < iterations; iteration++ )
+		{
+			const ksNanoseconds t0 = GetTimeNanoseconds();
+			ksJson * rootNode = ksJson_CreateArena();
+			const bool loaded = binary ? ksJson_ReadBinary( rootNode, binaryFileName, NULL ) : ksJson_ReadFromFile( rootNode, textFileName, NULL );
+			if ( !loaded || ksJson_GetMemberCount( ksJson_GetMemberByName( rootNode, "nodes" ) ) != objectCount )
+			{
+				printf( "failed to load %s\n", binary ? binaryFileName : textFileName );
+				result = EXIT_FAILURE;
+			}
+			ksJson_Destroy( rootNode );
+			const ksNanoseconds t1 = GetTimeNanoseconds();
+
+			loadTime = ( iteration == 0 || t1 - t0 < loadTime ) ? t1 - t0 : loadTime;
+		}
+		FILE * file = fopen( binary ? binaryFileName : textFileName, "rb" );
+		long fileSize = 0;
+		if ( file != NULL )
+		{
+			fseek( file, 0, SEEK_END );
+			fileSize = ftell( file );
+			fclose( file );
+		}
+		printf( "load %-6s     : %8.3f ms, %8.1f MB file\n", binary ? "binary" : "text", loadTime * 1e-6, fileSize / ( 1024.0 * 1024.0 ) );
+	}
+	remove( textFileName );
+	remove( binaryFileName );
+
+	ksJson_Destroy( numbersNode );
+	ksJson_Destroy( documentNode );
+
+	free( text );
+	return result;
+}
@@ -0,0 +1,523 @@
+/*
+================================================================================================
+
+Description	:	Verifies the vectorized functions of algebra.h against the scalar code.
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+
+The vector code performs the same operations in the same order as the scalar code, so the results
+must be bit-identical. The block-wise SSE inverse is the exception. Both inverses are compared
+to an exact inverse and their error must stay below the condition number times epsilon.
+
+The affine and rigid inverses are tested on random hierarchies of translation, rotation and scale
+transforms, with and without non-uniform scale, against the exact inverse.
+
+The quaternion interpolations are compared to a double-precision slerp. The batched transforms
+must match the single transform functions.
+
+	test_algebra [random count]
+
+================================================================================================
+*/
+
+#include "algebra_kernels.h"
+#include "../test.h"
+
+static void RandomQuaternion( ksQuatf * q, uint64_t * state )
+{
+	q->x = Test_RandomFloat( state, -1.0f, 1.0f );
+	q->y = Test_RandomFloat( state, -1.0f, 1.0f );
+	q->z = Test_RandomFloat( state, -1.0f, 1.0f );
+	q->w = Test_RandomFloat( state, -1.0f, 1.0f );
+	const float length = sqrtf( q->x * q->x + q->y * q->y + q->z * q->z + q->w * q->w );
+	const float scale = ( length > 1e-3f ) ? 1.0f / length : 0.0f;
+	q->x *= scale;
+	q->y *= scale;
+	q->z *= scale;
+	q->w = ( length > 1e-3f ) ? q->w * scale : 1.0f;
+}
+
+// Creates a translation, rotation and scale transform, with a uniform scale if 'uniformScale' is set.
+static void RandomTransform( ksMatrix4x4f * m, uint64_t * state, const float minScale, const float maxScale, const bool uniformScale )
+{
+	ksVector3f translation = { Test_RandomFloat( state, -100.0f, 100.0f ), Test_RandomFloat( state, -100.0f, 100.0f ), Test_RandomFloat( state, -100.0f, 100.0f ) };
+	ksQuatf rotation;
+	RandomQuaternion( &rotation, state );
+	ksVector3f scale = { Test_RandomFloat( state, minScale, maxScale ), Test_RandomFloat( state, minScale, maxScale ), Test_RandomFloat( state, minScale, maxScale ) };
+	if ( uniformScale )
+	{
+		scale.y = scale.z = scale.x;
+	}
+	ksMatrix4x4f_CreateTranslationRotationScale( m, &translation, &rotation, &scale );
+}
+
+static void RandomMatrix( ksMatrix4x4f * m, uint64_t * state )
+{
+	for ( int i = 0; i < 16; i++ )
+	{
+		m->m[i / 4][i % 4] = Test_RandomFloat( state, -10.0f, 10.0f );
+	}
+}
+
+// Creates a view-projection or model-view-projection matrix.
+static void RandomProjection( ksMatrix4x4f * m, uint64_t * state )
+{
+	ksMatrix4x4f projection;
+	ksMatrix4x4f_CreateProjectionFov( &projection, -Test_RandomFloat( state, 30.0f, 60.0f ), Test_RandomFloat( state, 30.0f, 60.0f ),
+										Test_RandomFloat( state, 30.0f, 60.0f ), -Test_RandomFloat( state, 30.0f, 60.0f ),
+										Test_RandomFloat( state, 0.01f, 1.0f ), 0.0f );
+	ksMatrix4x4f view;
+	RandomTransform( &view, state, 1.0f, 1.0f, true );
+	ksMatrix4x4f_Multiply( m, &projection, &view );
+}
+
+// Inverts the matrix with Gauss-Jordan elimination in double precision.
+static void InvertDouble( double result[4][4], const ksMatrix4x4f * src )
+{
+	double m[4][8];
+	for ( int r = 0; r < 4; r++ )
+	{
+		for ( int c = 0; c < 4; c++ )
+		{
+			m[r][c] = src->m[r][c];
+			m[r][c + 4] = ( r == c ) ? 1.0 : 0.0;
+		}
+	}
+	for ( int c = 0; c < 4; c++ )
+	{
+		int pivot = c;
+		for ( int r = c + 1; r < 4; r++ )
+		{
+			pivot = ( fabs( m[r][c] ) > fabs( m[pivot][c] ) ) ? r : pivot;
+		}
+		for ( int k = 0; k < 8; k++ )
+		{
+			const double t = m[c][k]; m[c][k] = m[pivot][k]; m[pivot][k] = t;
+		}
+		const double rcp = 1.0 / m[c][c];
+		for ( int k = 0; k < 8; k++ )
+		{
+			m[c][k] *= rcp;
+		}
+		for ( int r = 0; r < 4; r++ )
+		{
+			if ( r != c )
+			{
+				const double f = m[r][c];
+				for ( int k = 0; k < 8; k++ )
+				{
+					m[r][k] -= f * m[c][k];
+				}
+			}
+		}
+	}
+	for ( int r = 0; r < 4; r++ )
+	{
+		for ( int c = 0; c < 4; c++ )
+		{
+			result[r][c] = m[r][c + 4];
+		}
+	}
+}
+
+// Returns the largest difference to the exact inverse in units of the condition number times epsilon.
+// A stable float inverse stays well below one, even for the badly scaled view-projection matrices.
+static double InverseError( const ksMatrix4x4f * inverse, const ksMatrix4x4f * src, const double exact[4][4] )
+{
+	double srcMaxAbs = 0.0;
+	double exactMaxAbs = 0.0;
+	double maxError = 0.0;
+	for ( int i = 0; i < 16; i++ )
+	{
+		srcMaxAbs = fmax( srcMaxAbs, fabs( src->m[i / 4][i % 4] ) );
+		exactMaxAbs = fmax( exactMaxAbs, fabs( exact[i / 4][i % 4] ) );
+		maxError = fmax( maxError, fabs( inverse->m[i / 4][i % 4] - exact[i / 4][i % 4] ) );
+	}
+	return maxError / ( exactMaxAbs * srcMaxAbs * exactMaxAbs * FLT_EPSILON );
+}
+
+static void TestMultiplyAndTransform( const int count )
+{
+	uint64_t state = 1;
+	ksMatrix4x4f * a = (ksMatrix4x4f *) malloc( count * sizeof( ksMatrix4x4f ) );
+	ksMatrix4x4f * b = (ksMatrix4x4f *) malloc( count * sizeof( ksMatrix4x4f ) );
+	ksMatrix4x4f * result[2] = { (ksMatrix4x4f *) malloc( count * sizeof( ksMatrix4x4f ) ), (ksMatrix4x4f *) malloc( count * sizeof( ksMatrix4x4f ) ) };
+	ksVector4f * v = (ksVector4f *) malloc( count * sizeof( ksVector4f ) );
+	ksVector4f * v4[2] = { (ksVector4f *) malloc( count * sizeof( ksVector4f ) ), (ksVector4f *) malloc( count * sizeof( ksVector4f ) ) };
+	ksVector3f * mins = (ksVector3f *) malloc( count * sizeof( ksVector3f ) );
+	ksVector3f * maxs = (ksVector3f *) malloc( count * sizeof( ksVector3f ) );
+	ksVector3f * v3[2] = { (ksVector3f *) malloc( count * sizeof( ksVector3f ) ), (ksVector3f *) malloc( count * sizeof( ksVector3f ) ) };
+	ksVector3f * resultMaxs[2] = { (ksVector3f *) malloc( count * sizeof( ksVector3f ) ), (ksVector3f *) malloc( count * sizeof( ksVector3f ) ) };
+
+	for ( int i = 0; i < count; i++ )
+	{
+		switch ( i % 3 )
+		{
+			case 0: RandomMatrix( &a[i], &state ); RandomTransform( &b[i], &state, 0.1f, 10.0f, false ); break;
+			case 1: RandomProjection( &a[i], &state ); RandomTransform( &b[i], &state, 0.1f, 10.0f, false ); break;
+			default: RandomTransform( &a[i], &state, 0.1f, 10.0f, false ); RandomTransform( &b[i], &state, 0.1f, 10.0f, true ); break;
+		}
+		v[i].x = Test_RandomFloat( &state, -100.0f, 100.0f );
+		v[i].y = Test_RandomFloat( &state, -100.0f, 100.0f );
+		v[i].z = Test_RandomFloat( &state, -100.0f, 100.0f );
+		v[i].w = Test_RandomFloat( &state, -1.0f, 1.0f );
+		mins[i].x = Test_RandomFloat( &state, -100.0f, 0.0f );
+		mins[i].y = Test_RandomFloat( &state, -100.0f, 0.0f );
+		mins[i].z = Test_RandomFloat( &state, -100.0f, 0.0f );
+		maxs[i].x = mins[i].x + Test_RandomFloat( &state, 0.0f, 100.0f );
+		maxs[i].y = mins[i].y + Test_RandomFloat( &state, 0.0f, 100.0f );
+		maxs[i].z = mins[i].z + Test_RandomFloat( &state, 0.0f, 100.0f );
+	}
+
+	Scalar_Multiply( result[0], a, b, count );
+	Simd_Multiply( result[1], a, b, count );
+	TEST_CHECK( memcmp( result[0], result[1], count * sizeof( ksMatrix4x4f ) ) == 0 );
+
+	Scalar_TransformVector4f( v4[0], a, v, count );
+	Simd_TransformVector4f( v4[1], a, v, count );
+	TEST_CHECK( memcmp( v4[0], v4[1], count * sizeof( ksVector4f ) ) == 0 );
+
+	// Use the x, y and z of the 4D vectors as 3D vectors.
+	for ( int i = 0; i < count; i++ )
+	{
+		v3[0][i].x = v[i].x;
+		v3[0][i].y = v[i].y;
+		v3[0][i].z = v[i].z;
+	}
+	memcpy( v3[1], v3[0], count * sizeof( ksVector3f ) );
+	Scalar_TransformVector3f( resultMaxs[0], a, v3[0], count );
+	Simd_TransformVector3f( resultMaxs[1], a, v3[1], count );
+	TEST_CHECK( memcmp( resultMaxs[0], resultMaxs[1], count * sizeof( ksVector3f ) ) == 0 );
+
+	Scalar_TransformBounds( v3[0], resultMaxs[0], b, mins, maxs, count );
+	Simd_TransformBounds( v3[1], resultMaxs[1], b, mins, maxs, count );
+	TEST_CHECK( memcmp( v3[0], v3[1], count * sizeof( ksVector3f ) ) == 0 );
+	TEST_CHECK( memcmp( resultMaxs[0], resultMaxs[1], count * sizeof( ksVector3f ) ) == 0 );
+
+	free( a );
+	free( b );
+	free( v );
+	free( mins );
+	free( maxs );
+	for ( int i = 0; i < 2; i++ )
+	{
+		free( result[i] );
+		free( v4[i] );
+		free( v3[i] );
+		free( resultMaxs[i] );
+	}
+}
+
+static void TestInvert( const int count )
+{
+	uint64_t state = 2;
+	ksMatrix4x4f * src = (ksMatrix4x4f *) calloc( count, sizeof( ksMatrix4x4f ) );
+	ksMatrix4x4f * result[2] = { (ksMatrix4x4f *) malloc( count * sizeof( ksMatrix4x4f ) ), (ksMatrix4x4f *) malloc( count * sizeof( ksMatrix4x4f ) ) };
+
+	// Rotation and translation only.
+	for ( int i = 0; i < count; i++ )
+	{
+		RandomTransform( &src[i], &state, 1.0f, 1.0f, true );
+	}
+	Scalar_InvertHomogeneous( result[0], src, count );
+	Simd_InvertHomogeneous( result[1], src, count );
+	TEST_CHECK( memcmp( result[0], result[1], count * sizeof( ksMatrix4x4f ) ) == 0 );
+
+	// Transforms and view-projection matrices.
+	for ( int i = 0; i < count; i++ )
+	{
+		if ( ( i & 1 ) == 0 )
+		{
+			RandomTransform( &src[i], &state, 0.1f, 10.0f, false );
+		}
+		else
+		{
+			RandomProjection( &src[i], &state );
+		}
+	}
+	Scalar_Invert( result[0], src, count );
+	Simd_Invert( result[1], src, count );
+
+	// Both inverses are compared to the exact inverse of the float matrix.
+	double maxError[2] = { 0.0, 0.0 };
+	for ( int i = 0; i < count; i++ )
+	{
+		double exact[4][4];
+		InvertDouble( exact, &src[i] );
+		maxError[0] = fmax( maxError[0], InverseError( &result[0][i], &src[i], exact ) );
+		maxError[1] = fmax( maxError[1], InverseError( &result[1][i], &src[i], exact ) );
+	}
+	printf( "invert: max error relative to condition * epsilon, scalar %1.3f, %s %1.3f\n", maxError[0], Simd_GetInstructionSet(), maxError[1] );
+	TEST_CHECK( maxError[0] < 1.0 );
+	TEST_CHECK( maxError[1] < 1.0 );
+
+	free( src );
+	free( result[0] );
+	free( result[1] );
+}
+
+// Creates the global transform of a node at the given depth of a hierarchy of random transforms.
+static void RandomHierarchy( ksMatrix4x4f * m, uint64_t * state, const int depth, const bool uniformScale )
+{
+	ksMatrix4x4f_CreateIdentity( m );
+	for ( int i = 0; i < depth; i++ )
+	{
+		ksMatrix4x4f local;
+		RandomTransform( &local, state, 0.25f, 4.0f, uniformScale );
+		ksMatrix4x4f parent = *m;
+		ksMatrix4x4f_Multiply( m, &parent, &local );
+	}
+}
+
+static void TestInvertAffineAndRigid( const int count )
+{
+	uint64_t state = 5;
+	ksMatrix4x4f * src[2] = { (ksMatrix4x4f *) calloc( count, sizeof( ksMatrix4x4f ) ), (ksMatrix4x4f *) calloc( count, sizeof( ksMatrix4x4f ) ) };
+	ksMatrix4x4f * result = (ksMatrix4x4f *) malloc( count * sizeof( ksMatrix4x4f ) );
+	for ( int i = 0; i < count; i++ )
+	{
+		RandomHierarchy( &src[0][i], &state, 1 + i % 5, true );
+		RandomHierarchy( &src[1][i], &state, 1 + i % 5, false );
+	}
+
+	// The rigid inverse only handles uniform scale, the affine inverse handles both.
+	// index: 0 = general, 1 = affine, 2 = rigid, 3 = scalar affine, 4 = scalar rigid
+	double maxError[2][5] = { { 0.0 } };
+	int bottomRowErrors = 0;
+	for ( int uniform = 0; uniform < 2; uniform++ )
+	{
+		const ksMatrix4x4f * matrices = src[uniform == 0];
+		for ( int function = 0; function < 5; function++ )
+		{
+			if ( uniform == 0 && ( function == 2 || function == 4 ) )
+			{
+				continue;
+			}
+			switch ( function )
+			{
+				case 0: Simd_Invert( result, matrices, count ); break;
+				case 1: Simd_InvertAffine( result, matrices, count ); break;
+				case 2: Simd_InvertRigid( result, matrices, count ); break;
+				case 3: Scalar_InvertAffine( result, matrices, count ); break;
+				case 4: Scalar_InvertRigid( result, matrices, count ); break;
+			}
+			for ( int i = 0; i < count; i++ )
+			{
+				double exact[4][4];
+				InvertDouble( exact, &matrices[i] );
+				maxError[uniform][function] = fmax( maxError[uniform][function], InverseError( &result[i], &matrices[i], exact ) );
+				bottomRowErrors += ( function != 0 && ( result[i].m[0][3] != 0.0f || result[i].m[1][3] != 0.0f ||
+										result[i].m[2][3] != 0.0f || result[i].m[3][3] != 1.0f ) );
+			}
+		}
+	}
+	printf( "invert affine: max error relative to condition * epsilon\n" );
+	printf( "    uniform scale:     general %1.3f, affine %1.3f, rigid %1.3f, scalar affine %1.3f, scalar rigid %1.3f\n",
+			maxError[1][0], maxError[1][1], maxError[1][2], maxError[1][3], maxError[1][4] );
+	printf( "    non-uniform scale: general %1.3f, affine %1.3f, scalar affine %1.3f\n",
+			maxError[0][0], maxError[0][1], maxError[0][3] );
+	for ( int uniform = 0; uniform < 2; uniform++ )
+	{
+		for ( int function = 0; function < 5; function++ )
+		{
+			TEST_CHECK( maxError[uniform][function] < 1.0 );
+		}
+	}
+	TEST_CHECK( bottomRowErrors == 0 );
+
+	free( src[0] );
+	free( src[1] );
+	free( result );
+}
+
+// Spherical linear interpolation in double precision along the shortest arc.
+static void SlerpDouble( double result[4], const ksQuatf * a, const ksQuatf * b, const double fraction )
+{
+	const double qa[4] = { a->x, a->y, a->z, a->w };
+	double qb[4] = { b->x, b->y, b->z, b->w };
+	double s = qa[0] * qb[0] + qa[1] * qb[1] + qa[2] * qb[2] + qa[3] * qb[3];
+	if ( s < 0.0 )
+	{
+		s = -s;
+		for ( int c = 0; c < 4; c++ )
+		{
+			qb[c] = -qb[c];
+		}
+	}
+	const double angle = acos( fmin( s, 1.0 ) );
+	const double sinAngle = sin( angle );
+	const double fa = ( sinAngle > 1e-12 ) ? sin( ( 1.0 - fraction ) * angle ) / sinAngle : 1.0 - fraction;
+	const double fb = ( sinAngle > 1e-12 ) ? sin( fraction * angle ) / sinAngle : fraction;
+	double length = 0.0;
+	for ( int c = 0; c < 4; c++ )
+	{
+		result[c] = qa[c] * fa + qb[c] * fb;
+		length += result[c] * result[c];
+	}
+	for ( int c = 0; c < 4; c++ )
+	{
+		result[c] /= sqrt( length );
+	}
+}
+
+// Returns the angle in radians of the rotation between the two unit quaternions.
+static double RotationError( const ksQuatf * q, const double exact[4] )
+{
+	const double s = fabs( q->x * exact[0] + q->y * exact[1] + q->z * exact[2] + q->w * exact[3] );
+	const double length = sqrt( (double)q->x * q->x + (double)q->y * q->y + (double)q->z * q->z + (double)q->w * q->w );
+	// Use the sine for small angles because the arc cosine of values close to one is poorly conditioned.
+	const double cosHalfAngle = fmin( s / length, 1.0 );
+	return 2.0 * asin( sqrt( fmax( 1.0 - cosHalfAngle * cosHalfAngle, 0.0 ) ) );
+}
+
+// Random pairs of rotations, where a quarter is nearly parallel and a quarter is on opposite hemispheres.
+static void RandomQuaternionPair( ksQuatf * a, ksQuatf * b, uint64_t * state, const int i )
+{
+	RandomQuaternion( a, state );
+	RandomQuaternion( b, state );
+	if ( ( i & 3 ) == 0 )
+	{
+		const float t = Test_RandomFloat( state, 0.0f, 1e-3f );
+		ksQuatf_Lerp( b, a, b, t );
+	}
+	else if ( ( i & 3 ) == 1 )
+	{
+		const bool sameHemisphere = ( a->x * b->x + a->y * b->y + a->z * b->z + a->w * b->w ) >= 0.0f;
+		b->x = sameHemisphere ? -b->x : b->x;
+		b->y = sameHemisphere ? -b->y : b->y;
+		b->z = sameHemisphere ? -b->z : b->z;
+		b->w = sameHemisphere ? -b->w : b->w;
+	}
+}
+
+static void TestSlerp( const int count )
+{
+	uint64_t state = 3;
+	double maxError[3] = { 0.0, 0.0, 0.0 };
+	int endPointErrors = 0;
+	for ( int i = 0; i < count; i++ )
+	{
+		ksQuatf a;
+		ksQuatf b;
+		RandomQuaternionPair( &a, &b, &state, i );
+		const float fraction = Test_RandomFloat( &state, 0.0f, 1.0f );
+		double exact[4];
+		SlerpDouble( exact, &a, &b, fraction );
+
+		ksQuatf q[3];
+		ksQuatf_Slerp( &q[0], &a, &b, fraction );
+		ksQuatf_FastSlerp( &q[1], &a, &b, fraction );
+		ksQuatf_Lerp( &q[2], &a, &b, fraction );
+		for ( int k = 0; k < 3; k++ )
+		{
+			maxError[k] = fmax( maxError[k], RotationError( &q[k], exact ) );
+		}
+
+		// The end points are the input rotations.
+		double exactA[4];
+		double exactB[4];
+		SlerpDouble( exactA, &a, &b, 0.0 );
+		SlerpDouble( exactB, &a, &b, 1.0 );
+		ksQuatf_Slerp( &q[0], &a, &b, 0.0f );
+		ksQuatf_Slerp( &q[1], &a, &b, 1.0f );
+		endPointErrors += ( RotationError( &q[0], exactA ) > 1e-6 || RotationError( &q[1], exactB ) > 1e-6 );
+	}
+	printf( "slerp: max rotation error Slerp %1.2e rad, FastSlerp %1.2e rad, Lerp %1.2e rad\n", maxError[0], maxError[1], maxError[2] );
+	TEST_CHECK( maxError[0] < 1e-6 );
+	TEST_CHECK( maxError[1] < 1e-3 );
+	TEST_CHECK( endPointErrors == 0 );
+}
+
+// The count is not a multiple of four so the scalar tail of the batched functions is used as well.
+static void TestBatchedTransforms( const int count )
+{
+	uint64_t state = 4;
+	ksTransformArray a;
+	ksTransformArray b;
+	ksTransformArray blended[2];
+	ksTransformArray_Alloc( &a, count );
+	ksTransformArray_Alloc( &b, count );
+	ksTransformArray_Alloc( &blended[0], count );
+	ksTransformArray_Alloc( &blended[1], count );
+	float * fractions = (float *) calloc( count, sizeof( float ) );
+	ksMatrix4x4f * matrices[3] = { (ksMatrix4x4f *) malloc( count * sizeof( ksMatrix4x4f ) ),
+									(ksMatrix4x4f *) malloc( count * sizeof( ksMatrix4x4f ) ),
+									(ksMatrix4x4f *) malloc( count * sizeof( ksMatrix4x4f ) ) };
+	for ( int i = 0; i < count; i++ )
+	{
+		ksQuatf qa;
+		ksQuatf qb;
+		RandomQuaternionPair( &qa, &qb, &state, i );
+		const float qaValues[4] = { qa.x, qa.y, qa.z, qa.w };
+		const float qbValues[4] = { qb.x, qb.y, qb.z, qb.w };
+		for ( int c = 0; c < 4; c++ )
+		{
+			a.rotation[c][i] = qaValues[c];
+			b.rotation[c][i] = qbValues[c];
+		}
+		for ( int c = 0; c < 3; c++ )
+		{
+			a.translation[c][i] = Test_RandomFloat( &state, -100.0f, 100.0f );
+			b.translation[c][i] = Test_RandomFloat( &state, -100.0f, 100.0f );
+			a.scale[c][i] = Test_RandomFloat( &state, 0.1f, 10.0f );
+			b.scale[c][i] = Test_RandomFloat( &state, 0.1f, 10.0f );
+		}
+		fractions[i] = Test_RandomFloat( &state, 0.0f, 1.0f );
+	}
+
+	Scalar_Blend( &blended[0], &a, &b, fractions, count );
+	Simd_Blend( &blended[1], &a, &b, fractions, count );
+	TEST_CHECK( memcmp( blended[0].translation[0], blended[1].translation[0], 10 * count * sizeof( float ) ) == 0 );
+
+	double maxError = 0.0;
+	for ( int i = 0; i < count; i++ )
+	{
+		const ksQuatf qa = { a.rotation[0][i], a.rotation[1][i], a.rotation[2][i], a.rotation[3][i] };
+		const ksQuatf qb = { b.rotation[0][i], b.rotation[1][i], b.rotation[2][i], b.rotation[3][i] };
+		const ksQuatf q = { blended[1].rotation[0][i], blended[1].rotation[1][i], blended[1].rotation[2][i], blended[1].rotation[3][i] };
+		double exact[4];
+		SlerpDouble( exact, &qa, &qb, fractions[i] );
+		maxError = fmax( maxError, RotationError( &q, exact ) );
+	}
+	TEST_CHECK( maxError < 1e-3 );
+
+	Scalar_CreateTranslationRotationScaleArray( matrices[0], &blended[1], count );
+	Simd_CreateTranslationRotationScaleArray( matrices[1], &blended[1], count );
+	Scalar_AnimateFastSlerp( matrices[2], &a, &b, fractions, count );
+	TEST_CHECK( memcmp( matrices[0], matrices[1], count * sizeof( ksMatrix4x4f ) ) == 0 );
+
+	// The batched path gives the same matrices as creating them one at a time, apart from the sign of zero.
+	int mismatches = 0;
+	for ( int i = 0; i < count; i++ )
+	{
+		for ( int j = 0; j < 16; j++ )
+		{
+			mismatches += ( matrices[1][i].m[j / 4][j % 4] != matrices[2][i].m[j / 4][j % 4] );
+		}
+	}
+	TEST_CHECK( mismatches == 0 );
+
+	ksTransformArray_Free( &a );
+	ksTransformArray_Free( &b );
+	ksTransformArray_Free( &blended[0] );
+	ksTransformArray_Free( &blended[1] );
+	free( fractions );
+	for ( int i = 0; i < 3; i++ )
+	{
+		free( matrices[i] );
+	}
+}
+
+int main( int argc, char * argv[] )
+{
+	const int count = ( argc > 1 ) ? atoi( argv[1] ) : 100000;
+
+	printf( "algebra: comparing %s against %s\n", Simd_GetInstructionSet(), Scalar_GetInstructionSet() );
+	TestMultiplyAndTransform( count );
+	TestInvert( count );
+	TestInvertAffineAndRigid( count );
+	TestSlerp( count );
+	TestBatchedTransforms( count + 3 );
+
+	return Test_Report( "algebra" );
+}
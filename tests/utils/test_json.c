@@ -0,0 +1,563 @@
+/*
+================================================================================================
+
+Description	:	Verifies the reading and writing of json.h.
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+
+Floating-point values must be written such that they are read back as exactly the same double.
+This is verified as a property over random bit patterns and a set of edge cases.
+
+Parsed floating-point numbers must be correctly rounded. They are compared against strtod for
+random decimal strings with up to 30 digits, the exact halfway points between doubles and the
+strings right above and below them, and a set of known hard cases.
+
+	test_json [random count] [temporary file]
+
+================================================================================================
+*/
+
+#if defined( __linux__ )
+	#define _XOPEN_SOURCE 600
+#endif
+
+#include <math.h>
+#include <float.h>
+#include <utils/json.h>
+#include "../test.h"
+
+static double Random_Double( uint64_t * state )
+{
+	for ( ; ; )
+	{
+		const uint64_t bits = Test_RandomUint64( state );
+		if ( ( bits & 0x7FF0000000000000ULL ) != 0x7FF0000000000000ULL )
+		{
+			double value;
+			memcpy( &value, &bits, sizeof( value ) );
+			return value;
+		}
+	}
+}
+
+static bool SameBits( const double a, const double b )
+{
+	return memcmp( &a, &b, sizeof( double ) ) == 0;
+}
+
+static const double edgeDoubles[] =
+{
+	0.0, -0.0, 1.0, -1.0, 0.1, 0.2, 0.3, 1.0 / 3.0, 2.0 / 3.0,
+	1e21, 1e22, 1e23, 123456789012345678901234.0, 9007199254740992.0, 9007199254740993.0,
+	1e-5, 1e-6, 1e-7, 5e-324, 1e-323, 2.2250738585072009e-308, 2.2250738585072014e-308,
+	DBL_MIN, DBL_MAX, -DBL_MAX, DBL_EPSILON, 1.0 + DBL_EPSILON, 1.0 - DBL_EPSILON / 2,
+	FLT_MIN, FLT_MAX, FLT_EPSILON, 3.14159265358979323846, 2.718281828459045,
+	4.35, 0.000001, 123e-20, 5e-310, 1.7976931348623157e308, 4.9406564584124654e-324,
+};
+
+// Formats each value on its own and verifies that strtod reads back the same bits.
+static void TestFormatDouble( const int randomCount )
+{
+	uint64_t state = 0x9E3779B97F4A7C15ULL;
+	int mismatches = 0;
+	for ( int i = 0; i < randomCount + (int)ARRAY_SIZE( edgeDoubles ); i++ )
+	{
+		const double value = ( i < (int)ARRAY_SIZE( edgeDoubles ) ) ? edgeDoubles[i] : Random_Double( &state );
+
+		char text[JSON_MAX_DOUBLE_LENGTH + 1];
+		const int length = ksJson_FormatDouble( text, value );
+		text[length] = '\0';
+
+		// The text must have a fraction or exponent to be read back as floating-point.
+		if ( length <= 0 || length > JSON_MAX_DOUBLE_LENGTH ||
+				strpbrk( text, ".e" ) == NULL ||
+					!SameBits( strtod( text, NULL ), value ) )
+		{
+			if ( mismatches++ < 8 )
+			{
+				printf( "    %.17g written as '%s'\n", value, text );
+			}
+		}
+	}
+	TEST_CHECK( mismatches == 0 );
+}
+
+// Writes an array of doubles in both compact and indented form and reads them back.
+static void TestDoubleRoundTrip( const int randomCount )
+{
+	const int count = randomCount + (int)ARRAY_SIZE( edgeDoubles );
+	double * values = (double *) malloc( count * sizeof( double ) );
+	uint64_t state = 0x2545F4914F6CDD1DULL;
+	for ( int i = 0; i < count; i++ )
+	{
+		values[i] = ( i < (int)ARRAY_SIZE( edgeDoubles ) ) ? edgeDoubles[i] : Random_Double( &state );
+	}
+
+	ksJson * rootNode = ksJson_Create();
+	ksJson * array = ksJson_SetArray( ksJson_AddObjectMember( ksJson_SetObject( rootNode ), "values" ) );
+	for ( int i = 0; i < count; i++ )
+	{
+		ksJson_SetDouble( ksJson_AddArrayElement( array ), values[i] );
+	}
+
+	for ( int compact = 0; compact < 2; compact++ )
+	{
+		char * buffer = NULL;
+		int length = 0;
+		if ( !TEST_CHECK( ksJson_WriteToBufferEx( rootNode, &buffer, &length, compact != 0 ) ) )
+		{
+			continue;
+		}
+		TEST_CHECK( length == (int)strlen( buffer ) );
+
+		ksJson * readNode = ksJson_Create();
+		const char * error = NULL;
+		if ( TEST_CHECK( ksJson_ReadFromBuffer( readNode, buffer, &error ) ) )
+		{
+			const ksJson * readArray = ksJson_GetMemberByName( readNode, "values" );
+			TEST_CHECK( ksJson_GetMemberCount( readArray ) == count );
+			int mismatches = 0;
+			for ( int i = 0; i < count && i < ksJson_GetMemberCount( readArray ); i++ )
+			{
+				const ksJson * element = ksJson_GetMemberByIndex( readArray, i );
+				const double value = ksJson_GetDouble( element, 0.0 );
+				if ( !ksJson_IsFloatingPoint( element ) || !SameBits( value, values[i] ) )
+				{
+					if ( mismatches++ < 8 )
+					{
+						printf( "    %.17g read back as %.17g\n", values[i], value );
+					}
+				}
+			}
+			TEST_CHECK( mismatches == 0 );
+		}
+		ksJson_Destroy( readNode );
+		free( buffer );
+	}
+
+	ksJson_Destroy( rootNode );
+	free( values );
+}
+
+// Floats are stored as doubles and must come back as the same float.
+static void TestFloatRoundTrip( const int randomCount )
+{
+	ksJson * rootNode = ksJson_Create();
+	ksJson * array = ksJson_SetArray( rootNode );
+	uint64_t state = 0x3C6EF372FE94F82BULL;
+	float * values = (float *) malloc( randomCount * sizeof( float ) );
+	for ( int i = 0; i < randomCount; i++ )
+	{
+		uint32_t bits;
+		do
+		{
+			bits = (uint32_t)( Test_RandomUint64( &state ) >> 32 );
+		} while ( ( bits & 0x7F800000 ) == 0x7F800000 );
+		memcpy( &values[i], &bits, sizeof( float ) );
+		ksJson_SetFloat( ksJson_AddArrayElement( array ), values[i] );
+	}
+
+	char * buffer = NULL;
+	int length = 0;
+	ksJson * readNode = ksJson_Create();
+	if ( TEST_CHECK( ksJson_WriteToBufferEx( rootNode, &buffer, &length, true ) ) &&
+			TEST_CHECK( ksJson_ReadFromBuffer( readNode, buffer, NULL ) ) &&
+				TEST_CHECK( ksJson_GetMemberCount( readNode ) == randomCount ) )
+	{
+		int mismatches = 0;
+		for ( int i = 0; i < randomCount; i++ )
+		{
+			const float value = ksJson_GetFloat( ksJson_GetMemberByIndex( readNode, i ), 0.0f );
+			mismatches += ( memcmp( &value, &values[i], sizeof( float ) ) != 0 );
+		}
+		TEST_CHECK( mismatches == 0 );
+	}
+	ksJson_Destroy( readNode );
+	ksJson_Destroy( rootNode );
+	free( buffer );
+	free( values );
+}
+
+static const char * hardNumbers[] =
+{
+	"0.0", "-0.0", "0.1", "0.3", "1e23", "8.98846567431158e307", "7.2057594037927933e16",
+	"9007199254740993.0", "9007199254740993.00000000000000000001", "123456789012345678901234567890.0",
+	"2.2250738585072011e-308", "2.2250738585072012e-308", "2.2250738585072014e-308",
+	"4.9e-324", "2.4703282292062327e-324", "2.4703282292062328e-324", "1e-400", "-1e-400",
+	"1.7976931348623157e308", "1.7976931348623158e308", "1.7976931348623159e308", "1e400", "-1e400",
+	"1.00000000000000011102230246251565404236316680908203125",
+	"1.00000000000000011102230246251565404236316680908203124",
+	"1.00000000000000011102230246251565404236316680908203126",
+	"0.00000000000000000000000000000000000000000000000000000000000000001e65",
+	"100000000000000000000000000000000000000000000000000000000000000000e-65",
+	"1E+2", "1e-2", "0.000001", "1e99999999", "-1e-99999999",
+};
+
+// Parses the text as a number and compares the double against the C library.
+static bool MatchesStrtod( const char * text )
+{
+	JsonType_t type = JSON_NONE;
+	int64_t valueInt64 = 0;
+	uint64_t valueUint64 = 0;
+	double value = 0.0;
+	const char * end = ksJson_ParseNumber( &type, &valueInt64, &valueUint64, &value, text, NULL );
+
+	// JSON does not support infinity, so values out of range are clamped.
+	double expected = strtod( text, NULL );
+	expected = ( expected > DBL_MAX ) ? DBL_MAX : ( ( expected < -DBL_MAX ) ? -DBL_MAX : expected );
+
+	// A number without fraction and with a zero exponent, like 1e0, is stored as an integer.
+	value = ( type == JSON_INT ) ? (double)valueInt64 : ( ( type == JSON_UINT ) ? (double)valueUint64 : value );
+
+	if ( end != text + strlen( text ) || !SameBits( value, expected ) )
+	{
+		printf( "    '%s' parsed as %.17g instead of %.17g\n", text, value, expected );
+		return false;
+	}
+	return true;
+}
+
+static void TestParseNumbers( const int randomCount )
+{
+	int mismatches = 0;
+	for ( int i = 0; i < (int)ARRAY_SIZE( hardNumbers ); i++ )
+	{
+		mismatches += !MatchesStrtod( hardNumbers[i] );
+	}
+
+	uint64_t state = 0xBB67AE8584CAA73BULL;
+	for ( int i = 0; i < randomCount && mismatches < 8; i++ )
+	{
+		char text[64];
+		const uint64_t r = Test_RandomUint64( &state );
+		if ( ( r & 1 ) != 0 )
+		{
+			// A random double with a random number of significant digits.
+			snprintf( text, sizeof( text ), "%.*e", (int)( ( r >> 1 ) % 17 ), Random_Double( &state ) );
+		}
+		else
+		{
+			// Random digits with a random decimal point and exponent.
+			const int digitCount = 1 + (int)( ( r >> 1 ) % 30 );
+			const int pointPosition = 1 + (int)( ( r >> 8 ) % digitCount );
+			int length = 0;
+			for ( int d = 0; d < digitCount; d++ )
+			{
+				text[length++] = (char)( '0' + Test_RandomUint64( &state ) % 10 );
+				if ( d + 1 == pointPosition )
+				{
+					text[length++] = '.';
+				}
+			}
+			if ( text[length - 1] == '.' )
+			{
+				text[length++] = '0';
+			}
+			snprintf( text + length, sizeof( text ) - length, "e%d", (int)( ( r >> 16 ) % 660 ) - 340 );
+		}
+		mismatches += !MatchesStrtod( text );
+	}
+
+#if LDBL_MANT_DIG >= 64
+	// The exact halfway point between two doubles fits in a long double, and printf writes it exactly.
+	// Halfway points round to even, appending a digit rounds up, and truncating the digits rounds down.
+	for ( int i = 0; i < randomCount / 64 && mismatches < 8; i++ )
+	{
+		const double value = fabs( Random_Double( &state ) );
+		const double next = nextafter( value, HUGE_VAL );
+		const long double halfway = ( (long double)value + (long double)next ) / 2;
+		char text[1100];
+		const int length = snprintf( text, sizeof( text ) - 2, "%.800Le", halfway );
+		char * exponent = strchr( text, 'e' );
+		char * last = exponent - 1;
+		while ( last[0] == '0' )
+		{
+			last--;
+		}
+		memmove( last + 1, exponent, text + length + 1 - exponent );
+		mismatches += !MatchesStrtod( text );
+
+		// Just above halfway.
+		exponent = strchr( text, 'e' );
+		memmove( exponent + 1, exponent, strlen( exponent ) + 1 );
+		exponent[0] = '1';
+		mismatches += !MatchesStrtod( text );
+
+		// Just below halfway.
+		const int digits = (int)( exponent - text );
+		if ( digits > 22 )
+		{
+			memmove( text + 22, exponent + 1, strlen( exponent + 1 ) + 1 );
+			mismatches += !MatchesStrtod( text );
+		}
+	}
+#endif
+
+	TEST_CHECK( mismatches == 0 );
+}
+
+// Adds a random value with random nesting, repeated strings and all value types.
+static void AddRandomValue( ksJson * node, uint64_t * state, const int depth )
+{
+	static const char * names[] = { "", "name", "mesh", "children", "translation", "\xC3\xA9t\xC3\xA9", "a\"b" };
+	const uint64_t r = Test_RandomUint64( state );
+	const int type = ( depth >= 6 ) ? (int)( r % 6 ) : (int)( r % 8 );
+	switch ( type )
+	{
+		case 0: ksJson_SetNull( node ); break;
+		case 1: ksJson_SetBoolean( node, ( r >> 8 ) & 1 ); break;
+		case 2: ksJson_SetInt64( node, (int64_t)( r >> 16 ) - ( 1LL << 47 ) ); break;
+		case 3: ksJson_SetUint64( node, r ); break;
+		case 4: ksJson_SetDouble( node, Random_Double( state ) ); break;
+		case 5: ksJson_SetString( node, names[( r >> 8 ) % ARRAY_SIZE( names )] ); break;
+		case 6:
+		{
+			ksJson_SetObject( node );
+			const int count = (int)( ( r >> 8 ) % 6 );
+			for ( int i = 0; i < count; i++ )
+			{
+				char name[32];
+				snprintf( name, sizeof( name ), "%s%d", names[( r >> ( 16 + i * 3 ) ) % ARRAY_SIZE( names )], i );
+				AddRandomValue( ksJson_AddObjectMember( node, name ), state, depth + 1 );
+			}
+			break;
+		}
+		default:
+		{
+			ksJson_SetArray( node );
+			const int count = (int)( ( r >> 8 ) % 6 );
+			for ( int i = 0; i < count; i++ )
+			{
+				AddRandomValue( ksJson_AddArrayElement( node ), state, depth + 1 );
+			}
+			break;
+		}
+	}
+}
+
+// Reads the text, writes a binary snapshot, reads the snapshot and compares the text written from both DOMs.
+static bool BinaryRoundTrip( const char * text, const char * fileName, const bool arena )
+{
+	ksJson * textNode = ksJson_Create();
+	ksJson * binaryNode = arena ? ksJson_CreateArena() : ksJson_Create();
+	char * textOut = NULL;
+	char * binaryOut = NULL;
+	int textLength = 0;
+	int binaryLength = 0;
+	const char * error = NULL;
+	const bool result =
+		TEST_CHECK( ksJson_ReadFromBuffer( textNode, text, NULL ) ) &&
+		TEST_CHECK( ksJson_WriteBinary( textNode, fileName ) ) &&
+		TEST_CHECK( ksJson_ReadBinary( binaryNode, fileName, &error ) && error == NULL ) &&
+		TEST_CHECK( ksJson_WriteToBufferEx( textNode, &textOut, &textLength, true ) ) &&
+		TEST_CHECK( ksJson_WriteToBufferEx( binaryNode, &binaryOut, &binaryLength, true ) ) &&
+		TEST_CHECK( textLength == binaryLength && memcmp( textOut, binaryOut, textLength ) == 0 );
+	if ( !result && error != NULL )
+	{
+		printf( "    %s\n", error );
+	}
+	free( textOut );
+	free( binaryOut );
+	ksJson_Destroy( binaryNode );
+	ksJson_Destroy( textNode );
+	return result;
+}
+
+// Expects reading the file as a binary snapshot to fail without leaving a half loaded DOM.
+static void ExpectBinaryReadFailure( const char * fileName, const char * data, const size_t size )
+{
+	FILE * file = fopen( fileName, "wb" );
+	if ( !TEST_CHECK( file != NULL ) )
+	{
+		return;
+	}
+	if ( size > 0 )
+	{
+		fwrite( data, 1, size, file );
+	}
+	fclose( file );
+
+	ksJson * rootNode = ksJson_Create();
+	const char * error = NULL;
+	TEST_CHECK( !ksJson_ReadBinary( rootNode, fileName, &error ) );
+	TEST_CHECK( error != NULL );
+	TEST_CHECK( ksJson_GetMemberCount( rootNode ) == 0 );
+	ksJson_Destroy( rootNode );
+}
+
+static char * LoadTestFile( const char * fileName, size_t * sizeOut )
+{
+	FILE * file = fopen( fileName, "rb" );
+	if ( file == NULL )
+	{
+		return NULL;
+	}
+	fseek( file, 0, SEEK_END );
+	const size_t size = (size_t)ftell( file );
+	fseek( file, 0, SEEK_SET );
+	char * data = (char *) malloc( size );
+	*sizeOut = fread( data, 1, size, file );
+	fclose( file );
+	return data;
+}
+
+static void TestBinaryRoundTrip( const char * fileName )
+{
+	// Documents without strings or names have an empty string pool.
+	static const char * documents[] =
+	{
+		"null", "true", "42", "-1.5", "\"\"", "\"text\"", "[]", "{}", "[1,2.5,[],{},[[null]]]",
+		"{\"\":\"\",\"a\":{\"a\":\"a\"},\"b\":[\"a\",\"b\",\"a\"]}",
+	};
+	for ( int i = 0; i < (int)ARRAY_SIZE( documents ); i++ )
+	{
+		if ( !BinaryRoundTrip( documents[i], fileName, ( i & 1 ) != 0 ) )
+		{
+			printf( "    '%s'\n", documents[i] );
+		}
+	}
+
+	uint64_t state = 0x510E527FADE682D1ULL;
+	for ( int i = 0; i < 200; i++ )
+	{
+		ksJson * rootNode = ksJson_Create();
+		AddRandomValue( ksJson_SetArray( rootNode ), &state, 0 );
+		for ( int j = 0; j < 8; j++ )
+		{
+			AddRandomValue( ksJson_AddArrayElement( rootNode ), &state, 0 );
+		}
+		char * text = NULL;
+		int length = 0;
+		ksJson_WriteToBufferEx( rootNode, &text, &length, ( i & 1 ) != 0 );
+		if ( !BinaryRoundTrip( text, fileName, ( i & 2 ) != 0 ) )
+		{
+			free( text );
+			ksJson_Destroy( rootNode );
+			break;
+		}
+		free( text );
+		ksJson_Destroy( rootNode );
+	}
+
+	// The loaded DOM can be queried and changed but not extended.
+	ksJson * rootNode = ksJson_Create();
+	ksJson_ReadFromBuffer( rootNode, "{\"nodes\":[{\"name\":\"a\"},{\"name\":\"b\"}],\"scene\":1}", NULL );
+	ksJson_WriteBinary( rootNode, fileName );
+	ksJson_Destroy( rootNode );
+	rootNode = ksJson_Create();
+	if ( TEST_CHECK( ksJson_ReadBinary( rootNode, fileName, NULL ) ) )
+	{
+		const ksJson * nodes = ksJson_GetMemberByName( rootNode, "nodes" );
+		TEST_CHECK( strcmp( ksJson_GetString( ksJson_GetMemberByName( ksJson_GetMemberByIndex( nodes, 1 ), "name" ), "" ), "b" ) == 0 );
+		TEST_CHECK( ksJson_GetInt32( ksJson_GetMemberByName( rootNode, "scene" ), 0 ) == 1 );
+		TEST_CHECK( ksJson_SetInt32( ksJson_GetMemberByName( rootNode, "scene" ), 2 ) != NULL );
+		TEST_CHECK( ksJson_GetInt32( ksJson_GetMemberByName( rootNode, "scene" ), 0 ) == 2 );
+		TEST_CHECK( ksJson_AddObjectMember( rootNode, "extra" ) == NULL );
+	}
+	ksJson_Destroy( rootNode );
+
+	// Corrupt snapshots.
+	size_t size = 0;
+	char * data = LoadTestFile( fileName, &size );
+	if ( TEST_CHECK( data != NULL && size > sizeof( ksJsonBinaryHeader ) + sizeof( ksJson ) ) )
+	{
+		char junk[256];
+		for ( int i = 0; i < (int)sizeof( junk ); i++ )
+		{
+			junk[i] = (char)Test_RandomUint64( &state );
+		}
+		ExpectBinaryReadFailure( fileName, junk, sizeof( junk ) );
+		ExpectBinaryReadFailure( fileName, "{\"nodes\":[]}", 12 );
+		ExpectBinaryReadFailure( fileName, "", 0 );
+		ExpectBinaryReadFailure( fileName, data, sizeof( ksJsonBinaryHeader ) - 1 );
+		ExpectBinaryReadFailure( fileName, data, size - 1 );
+
+		// The root object must point at members that follow it.
+		char * corrupt = (char *) malloc( size );
+		memcpy( corrupt, data, size );
+		ksJson * root = (ksJson *)( corrupt + sizeof( ksJsonBinaryHeader ) );
+		root->valueUint64 = sizeof( ksJsonBinaryHeader );
+		ExpectBinaryReadFailure( fileName, corrupt, size );
+		root->valueUint64 = size;
+		ExpectBinaryReadFailure( fileName, corrupt, size );
+
+		// String offsets must point into the string pool.
+		memcpy( corrupt, data, size );
+		( (ksJson *)( corrupt + sizeof( ksJsonBinaryHeader ) ) )[1].pad = sizeof( ksJsonBinaryHeader );
+		ExpectBinaryReadFailure( fileName, corrupt, size );
+		free( corrupt );
+	}
+	free( data );
+
+	remove( fileName );
+}
+
+// JSON has no infinity or NaN.
+static void TestNonFinite()
+{
+	char text[JSON_MAX_DOUBLE_LENGTH + 1];
+	text[ksJson_FormatDouble( text, HUGE_VAL )] = '\0';
+	TEST_CHECK( strtod( text, NULL ) == DBL_MAX );
+	text[ksJson_FormatDouble( text, -HUGE_VAL )] = '\0';
+	TEST_CHECK( strtod( text, NULL ) == -DBL_MAX );
+	text[ksJson_FormatDouble( text, NAN )] = '\0';
+	TEST_CHECK( strcmp( text, "0.0" ) == 0 );
+}
+
+// Integers at the limits of their types and strings that need escaping.
+static void TestIntegersAndStrings()
+{
+	static const char * strings[] =
+	{
+		"", "plain", "quote \" backslash \\ slash /", "\b\f\n\r\t", "\x01\x1F\x7F",
+		"UTF8 \xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80",
+	};
+
+	ksJson * rootNode = ksJson_SetObject( ksJson_Create() );
+	ksJson_SetInt64( ksJson_AddObjectMember( rootNode, "int64min" ), INT64_MIN );
+	ksJson_SetInt64( ksJson_AddObjectMember( rootNode, "int64max" ), INT64_MAX );
+	ksJson_SetUint64( ksJson_AddObjectMember( rootNode, "uint64max" ), UINT64_MAX );
+	ksJson_SetInt32( ksJson_AddObjectMember( rootNode, "zero" ), 0 );
+	ksJson * array = ksJson_SetArray( ksJson_AddObjectMember( rootNode, "strings" ) );
+	for ( int i = 0; i < (int)ARRAY_SIZE( strings ); i++ )
+	{
+		ksJson_SetString( ksJson_AddArrayElement( array ), strings[i] );
+	}
+
+	char * buffer = NULL;
+	int length = 0;
+	ksJson * readNode = ksJson_Create();
+	if ( TEST_CHECK( ksJson_WriteToBufferEx( rootNode, &buffer, &length, true ) ) &&
+			TEST_CHECK( ksJson_ReadFromBuffer( readNode, buffer, NULL ) ) )
+	{
+		TEST_CHECK( ksJson_GetInt64( ksJson_GetMemberByName( readNode, "int64min" ), 0 ) == INT64_MIN );
+		TEST_CHECK( ksJson_GetInt64( ksJson_GetMemberByName( readNode, "int64max" ), 0 ) == INT64_MAX );
+		TEST_CHECK( ksJson_GetUint64( ksJson_GetMemberByName( readNode, "uint64max" ), 0 ) == UINT64_MAX );
+		TEST_CHECK( ksJson_IsInteger( ksJson_GetMemberByName( readNode, "zero" ) ) );
+		const ksJson * readArray = ksJson_GetMemberByName( readNode, "strings" );
+		TEST_CHECK( ksJson_GetMemberCount( readArray ) == (int)ARRAY_SIZE( strings ) );
+		for ( int i = 0; i < (int)ARRAY_SIZE( strings ); i++ )
+		{
+			TEST_CHECK( strcmp( ksJson_GetString( ksJson_GetMemberByIndex( readArray, i ), "<missing>" ), strings[i] ) == 0 );
+		}
+	}
+	ksJson_Destroy( readNode );
+	ksJson_Destroy( rootNode );
+	free( buffer );
+}
+
+int main( int argc, char * argv[] )
+{
+	const int randomCount = ( argc > 1 ) ? atoi( argv[1] ) : 1000000;
+	const char * fileName = ( argc > 2 ) ? argv[2] : "test_json.bin";
+
+	TestFormatDouble( randomCount );
+	TestDoubleRoundTrip( randomCount );
+	TestFloatRoundTrip( randomCount / 4 );
+	TestNonFinite();
+	TestParseNumbers( randomCount );
+	TestIntegersAndStrings();
+	TestBinaryRoundTrip( fileName );
+
+	return Test_Report( "json" );
+}
@@ -0,0 +1,103 @@
+/*
+================================================================================================
+
+Description	:	Verifies the CPU topology detection of sysinfo.h against a fixture sysfs tree.
+Language	:	C99
+Format		:	Real tabs with the tab size equal to 4 spaces.
+
+The fixture in utils/sysfs describes a heterogeneous CPU with eight logical cores:
+
+	cpu0-3		two big physical cores with two hardware threads each (SMT),
+				a private L2 per physical core, 4 GHz, NUMA node 0
+	cpu4-7		four little cores without SMT that share an L2, 3 GHz, NUMA node 1
+
+All cores share the L3 cache. The little cores only expose the older thread_siblings_list.
+
+================================================================================================
+*/
+
+#include <utils/sysinfo.h>
+#include "../test.h"
+
+static void TestFixture( const char * sysfsPath )
+{
+	ksCpuTopology topology;
+	if ( !TEST_CHECK( ksCpuTopology_CreateFromPath( &topology, sysfsPath ) ) )
+	{
+		return;
+	}
+
+	TEST_CHECK( topology.presentMask == 0xFF );
+	TEST_CHECK( topology.onlineMask == 0xFF );
+	TEST_CHECK( topology.isolatedMask == 0 );
+	TEST_CHECK( topology.logicalCoreCount == 8 );
+
+	// SMT
+	TEST_CHECK( topology.physicalCoreCount == 6 );
+	TEST_CHECK( topology.cores[0].physicalCore == topology.cores[1].physicalCore );
+	TEST_CHECK( topology.cores[2].physicalCore == topology.cores[3].physicalCore );
+	TEST_CHECK( topology.cores[1].physicalCore != topology.cores[2].physicalCore );
+	TEST_CHECK( topology.physicalCoreMasks[topology.cores[2].physicalCore] == 0x0C );
+	for ( int cpu = 4; cpu < 8; cpu++ )
+	{
+		TEST_CHECK( topology.physicalCoreMasks[topology.cores[cpu].physicalCore] == CPU_CORE_MASK( cpu ) );
+	}
+
+	// Caches, the instruction caches are ignored.
+	TEST_CHECK( topology.l2GroupCount == 3 );
+	TEST_CHECK( topology.l2GroupMasks[topology.cores[0].l2Group] == 0x03 );
+	TEST_CHECK( topology.l2GroupMasks[topology.cores[3].l2Group] == 0x0C );
+	TEST_CHECK( topology.l2GroupMasks[topology.cores[5].l2Group] == 0xF0 );
+	TEST_CHECK( topology.l3GroupCount == 1 );
+	TEST_CHECK( topology.l3GroupMasks[0] == 0xFF );
+
+	// NUMA
+	TEST_CHECK( topology.numaNodeCount == 2 );
+	TEST_CHECK( topology.numaNodeMasks[0] == 0x0F );
+	TEST_CHECK( topology.numaNodeMasks[1] == 0xF0 );
+	TEST_CHECK( topology.cores[3].numaNode == 0 );
+	TEST_CHECK( topology.cores[4].numaNode == 1 );
+
+	// big.LITTLE, the capacity is derived from the maximum frequency.
+	TEST_CHECK( topology.cores[0].maxFrequency == 4000000 );
+	TEST_CHECK( topology.cores[7].maxFrequency == 3000000 );
+	TEST_CHECK( topology.cores[0].capacity == 1024 );
+	TEST_CHECK( topology.cores[7].capacity == 768 );
+	TEST_CHECK( ksCpuTopology_GetBigCoreMask( &topology ) == 0x0F );
+
+	// The fast core is the first thread of the last big physical core, which is used by the workers last.
+	TEST_CHECK( ksCpuTopology_GetFastCore( &topology ) == 2 );
+	TEST_CHECK( ksCpuTopology_GetPhysicalCoreMask( &topology, 0 ) == 0x03 );
+	TEST_CHECK( ksCpuTopology_GetPhysicalCoreMask( &topology, 1 ) == 0x10 );
+	TEST_CHECK( ksCpuTopology_GetPhysicalCoreMask( &topology, 4 ) == 0x80 );
+	TEST_CHECK( ksCpuTopology_GetPhysicalCoreMask( &topology, 5 ) == 0x0C );
+	TEST_CHECK( ksCpuTopology_GetPhysicalCoreMask( &topology, 6 ) == 0x03 );
+}
+
+static void TestMissingTree()
+{
+	ksCpuTopology topology;
+	TEST_CHECK( !ksCpuTopology_CreateFromPath( &topology, "does/not/exist" ) );
+	TEST_CHECK( topology.logicalCoreCount == 0 );
+	TEST_CHECK( topology.fastCore == -1 );
+
+	// A path that does not fit fails instead of reading a truncated path.
+	char longPath[2048];
+	memset( longPath, 'a', sizeof( longPath ) - 1 );
+	longPath[sizeof( longPath ) - 1] = '\0';
+	TEST_CHECK( !ksCpuTopology_CreateFromPath( &topology, longPath ) );
+}
+
+int main( int argc, char * argv[] )
+{
+	if ( argc < 2 )
+	{
+		printf( "usage: test_sysinfo <fixture sysfs path>\n" );
+		return EXIT_FAILURE;
+	}
+
+	TestFixture( argv[1] );
+	TestMissingTree();
+
+	return Test_Report( "sysinfo" );
+}